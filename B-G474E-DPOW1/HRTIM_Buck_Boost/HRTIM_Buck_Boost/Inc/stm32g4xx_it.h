@@ -57,6 +57,9 @@ void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
 void HRTIM1_TIMC_IRQHandler(void);
+void ADC1_2_IRQHandler(void);
+void DMA1_Channel1_IRQHandler(void);
+void USART3_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
@@ -1,31 +1,116 @@
 #include "app.h"
 #include "b_g474e_dpow1.h"
 #include "measurements.h"
+#include "fault_mgr.h"
+#include "retarget.h"
+#include "usb_stream.h"
+#include "com_gcom.h"
+#include "scheduler.h"
+#include "encoders.h"
+#include "hw_math.h"
 #include "main.h"
+#include "stm32g4xx_ll_usart.h"
 #include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
 
-static Meas_Voltages_ADC1_t g_voltages;
+static Meas_Values_t g_values;
+
+/* Telemetry and command responses share the printf ring, whole frames or nothing */
+static const GCOM_Transport_t s_uartTransport = { RetargetWrite };
 
-#define DE_ENERGIZING_THRESHOLD   ((uint16_t)2500)
-#define OVER_VOLTAGE_PROTECTION   ((uint16_t)5000)
 #define VDDA                      ((uint16_t)3300)
+#define APP_LED_BLINK_DIV         5u      /* UI passes per LED toggle */
+#define APP_VOUT_MAX_mV           12000u
+#define APP_MOTOR_RPM_MAX         (MCTRL_SPEED_FS_CPS * 60u / ENC_COUNTS_PER_REV)
+
+/* Telemetry channel decimation stays fixed, the record rate is a parameter */
+static const uint8_t s_streamChDiv[MEAS_NUM_CH] = STREAM_DEFAULT_CH_DIV;
+
+#define APP_PARAM(id, field, type, min, max) \
+    { (uint8_t)(id), (uint8_t)(type), (uint16_t)offsetof(APP_Params_t, field), (min), (max) }
+
+static const GCOM_ParamDesc_t s_paramTable[] = {
+    APP_PARAM(APP_PARAM_VOUT_BUCK_mV,   voutBuck_mV,    GCOM_PT_U16,  500u,  APP_VOUT_MAX_mV),
+    APP_PARAM(APP_PARAM_VOUT_BOOST_mV,  voutBoost_mV,   GCOM_PT_U16,  500u,  APP_VOUT_MAX_mV),
+    APP_PARAM(APP_PARAM_SLEW_mV_PER_MS, slew_mV_per_ms, GCOM_PT_U16,  1u,    1000u),
+    APP_PARAM(APP_PARAM_DE_ENERGIZE_mV, deEnergize_mV,  GCOM_PT_U16,  0u,    5000u),
+    APP_PARAM(APP_PARAM_OVP_mV,         ovp_mV,         GCOM_PT_U16,  2000u, 15000u),
+    APP_PARAM(APP_PARAM_OCP_PIN_mV,     ocpPin_mV,      GCOM_PT_U16,  600u,  3300u),
+    APP_PARAM(APP_PARAM_UVLO_mV,        uvlo_mV,        GCOM_PT_U16,  0u,    20000u),
+    APP_PARAM(APP_PARAM_STREAM_DIV,     streamDiv,      GCOM_PT_U16,  1u,    0xFFFFu),
+    APP_PARAM(APP_PARAM_STREAM_ON,      streamOn,       GCOM_PT_BOOL, 0u,    1u),
+    APP_PARAM(APP_PARAM_MOTOR_RPM,      motorRpm,       GCOM_PT_U16,  0u,    APP_MOTOR_RPM_MAX),
+    APP_PARAM(APP_PARAM_MOTOR_ACCEL,    motorAccel_rpm_per_s, GCOM_PT_U16, 1u, 0xFFFFu),
+    APP_PARAM(APP_PARAM_MOTOR_ILIM_PIN_mV, motorIlimPin_mV, GCOM_PT_U16, 0u, 3300u),
+    APP_PARAM(APP_PARAM_MOTOR_VMAX_mV,  motorVmax_mV,   GCOM_PT_U16,  0u,    APP_VOUT_MAX_mV),
+};
+
+static const APP_Params_t s_paramDefaults = {
+    .voutBuck_mV    = APP_VOUT_BUCK_mV,
+    .voutBoost_mV   = APP_VOUT_BOOST_mV,
+    .slew_mV_per_ms = VCTRL_SLEW_mV_PER_MS,
+    .deEnergize_mV  = APP_DE_ENERGIZE_mV,
+    .ovp_mV         = FAULT_OVP_mV,
+    .ocpPin_mV      = FAULT_OCP_PIN_mV,
+    .uvlo_mV        = FAULT_UVLO_mV,
+    .streamDiv      = STREAM_DEFAULT_RECORD_DIV,
+    .streamOn       = APP_TELEMETRY_AT_BOOT,
+    .motorRpm             = APP_MOTOR_RPM,
+    .motorAccel_rpm_per_s = MCTRL_ACCEL_RPM_PER_S,
+    .motorIlimPin_mV      = APP_MOTOR_ILIM_PIN_mV,
+    .motorVmax_mV         = APP_MOTOR_VMAX_mV,
+};
+
+static bool          APP_ParamsValidate(const void *block);
+static void          APP_ParamsApply(const void *block);
+static bool          APP_ParamsSave(const void *record, uint32_t len);
+static bool          APP_ParamsLoad(void *record, uint32_t len);
+static GCOM_Status_t APP_Command(uint8_t cmd, const uint8_t *args, uint32_t len);
+
+static const GCOM_Config_t s_gcomCfg = {
+    .params        = s_paramTable,
+    .numParams_u32 = sizeof(s_paramTable) / sizeof(s_paramTable[0]),
+    .blockSize_u32 = sizeof(APP_Params_t),
+    .defaults      = &s_paramDefaults,
+    .validate      = APP_ParamsValidate,
+    .apply         = APP_ParamsApply,
+    .save          = APP_ParamsSave,
+    .load          = APP_ParamsLoad,
+    .command       = APP_Command,
+};
 
 
 extern ADC_HandleTypeDef   hadc1;
-//extern ADC_HandleTypeDef   hadc2;
 extern HRTIM_HandleTypeDef hhrtim1;
 extern UART_HandleTypeDef  huart3;
-extern uint16_t adc2_buf[ADC2_BUF_SIZE];
 
 
-AppMode_t appMode = APP_MODE_DE_ENERGIZE;
+_Atomic AppMode_t appMode = APP_MODE_DE_ENERGIZE;
+VCTRL_t   appVctrl;
+MCTRL_t   appMctrl;
 static AppMode_t prevAppMode = (AppMode_t)(-1);
 
+static void APP_FaultTrip(void);
 static void APP_UpdateFaultState(void);
 static void APP_ReadVoltages(void);
+static void APP_ServeCommands(void);
 static void APP_HandleStateMachine(void);
+static void APP_LogStatus(void);
 static void APP_LogStateIfChanged(void);
+static bool APP_RequestMode(AppMode_t mode);
+static void APP_StreamConfig(const APP_Params_t *p, STREAM_Config_t *cfg);
+static uint32_t APP_Cycles(void);
+static void APP_PrintMathBench(void);
 
+/* Budgets flag a run that took longer than expected, not a missed deadline */
+static const SCHED_TaskDesc_t s_tasks[APP_NUM_TASKS] = {
+    [APP_TASK_PROTECTION] = { "protect", APP_UpdateFaultState,   1u,    200u },
+    [APP_TASK_TELEMETRY]  = { "telem",   APP_ServeCommands,      10u,   500u },
+    [APP_TASK_UI]         = { "ui",      APP_HandleStateMachine, 100u,  500u },
+    [APP_TASK_LOG]        = { "log",     APP_LogStatus,          1000u, 0u   },
+};
 
 
 void APP_Init(void)
@@ -37,12 +122,58 @@ void APP_Init(void)
     BSP_LED_Init(LED5);
 
     BSP_JOY_Init(JOY1, JOY_MODE_GPIO, JOY_ALL);
-    //HAL_StatusTypeDef result = HAL_ADC_Start_DMA(&hadc2, (uint32_t*)adc2_buf, ADC2_BUF_SIZE);
-    //printf("HAL_ADC_Start_DMA returns : %02X \r\n", result);
+
+    /* CORDIC against the software path, before the ADC2 interrupt shares the CORDIC */
+    HMATH_Init();
+    APP_PrintMathBench();
+
+    /* Input current at ~708 kSa/s on ADC2, reduced per DMA half buffer */
+    if (!MEAS_CurrentStart())
+        printf("MEAS_CurrentStart failed\r\n");
 
     HAL_ADCEx_Calibration_Start(&hadc1, ADC_SINGLE_ENDED);
     HAL_ADCEx_InjectedStart(&hadc1);
 
+    /* Cycle counter for the control ISR timing */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Output voltage loop, runs in HRTIM1_TIMC_IRQHandler */
+    VCTRL_Init(&appVctrl, BUCK_PWM_PERIOD);
+
+    /* Motor speed/current loop, same ISR and compares in APP_MODE_MOTOR */
+    MCTRL_Init(&appMctrl, &appVctrl);
+
+    /* One injected sequence every MEAS_ADC_TRIG_POSTSCALER + 1 PWM periods, captured by the JEOS ISR */
+    HAL_HRTIM_ADCPostScalerConfig(&hhrtim1, HRTIM_ADCTRIGGER_2, MEAS_ADC_TRIG_POSTSCALER);
+    MEAS_Init(&hadc1);
+    printf("MEAS_Convert: %lu cycles for %u channels\r\n", MEAS_BenchConvert(), (unsigned)MEAS_NUM_CH);
+
+    /* Per-sample OVP/OCP/UVLO from the JEOS ISR, thresholds use the calibration loaded above */
+    FAULT_Init(APP_FaultTrip);
+
+    /* Binary telemetry from the JEOS ISR, interleaved with the text on USART3 */
+    STREAM_Init(&s_uartTransport);
+
+    /* Parameters from flash (or defaults), applied to VCTRL/FAULT/STREAM before the
+     * control ISR runs; masked because the ADC ISR already uses the fault thresholds */
+    __disable_irq();
+    const bool paramsLoaded = GCOM_Init(&s_gcomCfg, &s_uartTransport);
+    __enable_irq();
+    STREAM_Config_t streamCfg;
+    APP_StreamConfig((const APP_Params_t *)GCOM_ActiveParams(), &streamCfg);
+    printf("Params: %s, telemetry %lu B/s of %lu B/s link\r\n",
+    		paramsLoaded ? "loaded from flash" : "defaults",
+			STREAM_BytesPerSecond(&streamCfg),
+			STREAM_LinkBytesPerSecond(huart3.Init.BaudRate));
+
+    /* Quadrature encoder on TIM3 (PC6/PC7), sampled by the HRTIM control tick */
+    ENC_Init();
+
+    /* Commands on USART3 RX, parsed by GCOM_Task() in the main loop */
+    LL_USART_EnableIT_RXNE_RXFNE(USART3);
+
     /* Startup: de-energize output cap */
     appMode = APP_MODE_DE_ENERGIZE;
 
@@ -55,71 +186,226 @@ void APP_Init(void)
 
     HAL_GPIO_WritePin(BUCKBOOST_USBPD_EN_GPIO_Port, BUCKBOOST_USBPD_EN_Pin, GPIO_PIN_SET);
 
-    MEAS_Init(&hadc1);  // pass ADC handle
-
+    /* Main loop tasks, timed with the DWT cycle counter enabled above */
+    SCHED_Init(s_tasks, APP_NUM_TASKS, APP_Cycles, SystemCoreClock / 1000000u, HAL_GetTick());
 }
 
 void APP_Task(void)
 {
-    APP_UpdateFaultState();
-    APP_ReadVoltages();
-    APP_LogStateIfChanged();
-    APP_HandleStateMachine();
-
-    HAL_Delay(1000);      // main loop period
+    /* One ready task per call, highest priority first */
+    (void)SCHED_Run(HAL_GetTick());
 }
 
 /* ----------------- static helpers ------------------- */
 
+/* Trip callback of fault_mgr, runs in the ADC interrupt */
+static void APP_FaultTrip(void)
+{
+    LL_HRTIM_DisableOutput(HRTIM1,
+        LL_HRTIM_OUTPUT_TC1 | LL_HRTIM_OUTPUT_TC2 |
+        LL_HRTIM_OUTPUT_TD1 | LL_HRTIM_OUTPUT_TD2);
+    appMode = APP_MODE_FAULT;
+    SCHED_SetEvent(APP_TASK_PROTECTION);
+}
+
+static uint32_t APP_Cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static void APP_PrintMathBench(void)
+{
+    HMATH_BenchItem_t bench[HMATH_BENCH_NUM];
+
+    if (!HMATH_HasHw())
+    {
+        printf("HMATH: software only\r\n");
+        return;
+    }
+    HMATH_Bench(bench);
+    for (uint32_t i = 0u; i < HMATH_BENCH_NUM; i++)
+    {
+        printf("HMATH %s: hw %lu sw %lu cycles, mismatches %lu (max %lu LSB)\r\n",
+        		HMATH_BenchName((HMATH_BenchId_t)i),
+				bench[i].hwCycles_u32, bench[i].swCycles_u32,
+				bench[i].mismatches_u32, bench[i].maxDiff_u32);
+    }
+}
+
 static void APP_UpdateFaultState(void)
 {
+    static uint32_t loggedCount = 0u;
+    const uint32_t now = HAL_GetTick();
+
+    /* Hardware fault input: outputs are already off, latch it like the others */
     if (LL_HRTIM_IsActiveFlag_FLT2(HRTIM1))
+        FAULT_Report(FAULT_CAUSE_HW_FLT, 0u, now);
+
+    /* Print fault log entries added since the last pass */
+    const uint32_t logCount = FAULT_GetLogCount();
+    if (logCount != loggedCount)
     {
-        if (appMode != APP_MODE_FAULT)
-            printf("FAULT detected (FLT2 active)\r\n");
+        FAULT_LogEntry_t entries[FAULT_LOG_LEN - 1u];
+        const uint32_t n = FAULT_ReadLog(entries, logCount - loggedCount);
+        for (uint32_t i = 0u; i < n; i++)
+        {
+            printf("FAULT @%lu ms: cause 0x%02X value %u retry %u\r\n",
+            		entries[i].time_ms, entries[i].cause_u8, entries[i].value_u16, entries[i].retry_u8);
+        }
+        loggedCount = logCount;
+    }
 
-        appMode = APP_MODE_FAULT;
+    /* Restart only once fault_mgr has seen the conditions clear and the back-off expire */
+    if (FAULT_Task(now))
+    {
+        const FAULT_Stats_t *faultStats = FAULT_GetStats();
+        printf("FAULT released: restart %lu (reaction max %lu cycles = %lu us)\r\n",
+        		faultStats->restarts_u32, faultStats->maxReactCycles_u32,
+				faultStats->maxReactCycles_u32 / (SystemCoreClock / 1000000u));
+        LL_HRTIM_ClearFlag_FLT2(HRTIM1);
+        appMode = APP_MODE_DE_ENERGIZE;
+        LL_HRTIM_EnableOutput(HRTIM1,
+            LL_HRTIM_OUTPUT_TC1 | LL_HRTIM_OUTPUT_TC2 |
+            LL_HRTIM_OUTPUT_TD1 | LL_HRTIM_OUTPUT_TD2);
     }
 }
 
+/* Snapshot used by the state machine, printed by APP_LogStatus() */
 static void APP_ReadVoltages(void)
 {
-    MEAS_ReadVoltages(&g_voltages);
+    MEAS_ReadVoltages(&g_values);
+}
+
+static void APP_ServeCommands(void)
+{
+    APP_ReadVoltages();
+
+    /* One request per pass: come back right away while requests keep arriving */
+    if (GCOM_Task() != 0u)
+        SCHED_SetEvent(APP_TASK_TELEMETRY);
+}
+
+static void APP_LogStatus(void)
+{
+    static const char *const measNames[MEAS_NUM_CH] = { "I_IN_SENSE", "V_IN", "I_IN_AVG", "Vout" };
+    Meas_Frame_t frame;
+    const Meas_Stats_t *measStats = MEAS_GetStats();
+
+    printf("APP_MODE: %d\r\n", (int)appMode);
+    if (FAULT_GetState() == FAULT_STATE_LOCKOUT)
+    {
+        printf("FAULT lockout (causes 0x%02lX), press SEL to re-arm\r\n", FAULT_GetCauses());
+    }
+
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        printf("Raw values: %s = %u %u %u\r\n",
+        		measNames[ch],
+				g_values.raw_u16[ch],
+				g_values.pin_mV_u16[ch],
+				g_values.scaled_mV_u16[ch]
+				);
+    }
 
-    printf("Raw values: I_IN_SENSE = %lu %lu %lu\r\n",
-    		g_voltages.BUCKBOOST_I_IN_SENSE_RAW,
-			g_voltages.BUCKBOOST_I_IN_SENSE_mV,
-			g_voltages.BUCKBOOST_I_IN_SENSE_SCALED
+    if (MEAS_GetFrame(&frame))
+    {
+        printf("Meas: seq = %lu Vout min/avg/max = %u/%u/%u (retries %lu, fails %lu)\r\n",
+        		frame.seq_u32,
+				frame.min_u16[MEAS_CH_VOUT],
+				frame.avg_u16[MEAS_CH_VOUT],
+				frame.max_u16[MEAS_CH_VOUT],
+				measStats->retries_u32,
+				measStats->readFails_u32
+				);
+    }
+
+    Meas_CurrentBlock_t curBlock;
+    if (MEAS_GetCurrentBlock(&curBlock))
+    {
+        const Meas_CurrentStats_t *curStats = MEAS_GetCurrentStats();
+        printf("I_IN (ADC2): mean = %u rms = %u ripple = %u min/max = %u/%u blocks = %lu late = %lu ovr = %lu cycles = %lu (max %lu)\r\n",
+        		curBlock.mean_u16, curBlock.rms_u16, curBlock.acRms_u16,
+				curBlock.min_u16, curBlock.max_u16,
+				curStats->blocks_u32, curStats->late_u32, curStats->overruns_u32,
+				curStats->lastCycles_u32, curStats->maxCycles_u32
+				);
+    }
+
+    printf("Ctrl: region = %s m = %ld/16384 iter = %lu sat = %lu cycles = %lu (max %lu)\r\n",
+    		(appVctrl.region == VCTRL_REGION_BUCK) ? "BUCK" : "BUCK-BOOST",
+			(long)appVctrl.m_s16,
+			appVctrl.stats.iterations_u32,
+			appVctrl.stats.saturated_u32,
+			appVctrl.stats.lastCycles_u32,
+			appVctrl.stats.maxCycles_u32
 			);
 
-    printf("Raw values: V_IN = %lu %lu %lu\r\n",
-    		g_voltages.BUCKBOOST_VIN_RAW,
-			g_voltages.BUCKBOOST_VIN_mV,
-			g_voltages.BUCKBOOST_VIN_SCALED
+    printf("Motor: ref = %ld rpm iRef = %d iMeas = %ld m = %ld/16384 vsat = %lu ilim = %lu held = %lu cycles = %lu (max %lu, over budget %lu)\r\n",
+    		(long)(ENC_RPM_Q8(appMctrl.speedRefQ8_s32) / 256),
+			appMctrl.iRef_s16,
+			(long)(appMctrl.iFiltQ_s32 >> MCTRL_I_FILT_SHIFT),
+			(long)appMctrl.m_s16,
+			appMctrl.stats.voltageSat_u32,
+			appMctrl.stats.currentLimited_u32,
+			appMctrl.stats.speedHeld_u32,
+			appMctrl.stats.lastCycles_u32,
+			appMctrl.stats.maxCycles_u32,
+			appMctrl.stats.overBudget_u32
 			);
 
-    printf("Raw values: I_IN_AVG = %lu %lu %lu\r\n",
-    		g_voltages.BUCKBOOST_I_IN_AVG_RAW,
-			g_voltages.BUCKBOOST_I_IN_AVG_mV,
-			g_voltages.BUCKBOOST_I_IN_AVG_SCALED
+    const RetargetStats_t *logStats = RetargetGetStats();
+    printf("Log: written = %lu dropped = %lu bytes in %lu writes, ring max %lu/%u\r\n",
+    		logStats->writtenBytes_u32,
+			logStats->droppedBytes_u32,
+			logStats->droppedWrites_u32,
+			logStats->highWater_u32,
+			(unsigned)RETARGET_TX_BUF_SIZE
 			);
 
-    printf("Raw values: Vout = %lu %lu %lu\r\n",
-    		g_voltages.BUCKBOOST_VOUT_RAW,
-			g_voltages.BUCKBOOST_VOUT_mV,
-			g_voltages.BUCKBOOST_VOUT_SCALED
+    const HMATH_Stats_t *mathStats = HMATH_GetStats();
+    printf("Math: cordic busy = %lu\r\n", mathStats->cordicBusy_u32);
+
+    const STREAM_Stats_t *streamStats = STREAM_GetStats();
+    printf("Telemetry: %s records = %lu dropped = %lu bytes = %lu\r\n",
+    		STREAM_IsEnabled() ? "on" : "off",
+			streamStats->records_u32,
+			streamStats->dropped_u32,
+			streamStats->bytes_u32
 			);
+
+    ENC_Snapshot_t enc;
+    if (ENC_GetSnapshot(&enc))
+    {
+        const ENC_Stats_t *encStats = ENC_GetStats();
+        printf("Encoder: pos = %ld speed = %ld rpm (%s) edge age = %lu us, update %lu cycles (max %lu) rereads = %lu\r\n",
+        		(long)enc.pos_s32,
+				(long)(ENC_RPM_Q8(enc.speed_cps_q8) / 256),
+				enc.speedValid ? "measured" : "bound",
+				(enc.edgeAge_u32 == UINT32_MAX) ? 0u : enc.edgeAge_u32 / (ENC_TIME_HZ / 1000000u),
+				encStats->lastCycles_u32, encStats->maxCycles_u32, encStats->rereads_u32
+				);
+    }
+
+    for (uint32_t t = 0u; t < APP_NUM_TASKS; t++)
+    {
+        const SCHED_TaskStats_t *ts = SCHED_GetStats(t);
+        printf("Task %s: runs = %lu events = %lu cycles = %lu (max %lu) overruns = %lu missed = %lu late max %lu ms\r\n",
+        		s_tasks[t].name, ts->runs_u32, ts->events_u32, ts->lastCycles_u32, ts->maxCycles_u32,
+				ts->overruns_u32, ts->missed_u32, ts->maxLate_ms);
+    }
+    SCHED_ResetMax();
 }
 
 
 static void APP_LogStateIfChanged(void)
 {
-    if (appMode == prevAppMode)
+    const AppMode_t mode = appMode;
+    if (mode == prevAppMode)
         return;
 
-    prevAppMode = appMode;
+    prevAppMode = mode;
 
-    switch (appMode)
+    switch (mode)
     {
         case APP_MODE_BUCK:
             printf("State: BUCK\r\n");
@@ -133,86 +419,116 @@ static void APP_LogStateIfChanged(void)
         case APP_MODE_FAULT:
             printf("State: FAULT\r\n");
             break;
+        case APP_MODE_MOTOR:
+            printf("State: MOTOR\r\n");
+            break;
         default:
             printf("State: UNKNOWN\r\n");
             break;
     }
 }
 
+/* 10 Hz: the sampling interval debounces the joystick, actions fire on a new direction */
 static void APP_HandleStateMachine(void)
 {
+    static int32_t prevJoyState = JOY_NONE;
+    static uint32_t blinkCnt = 0u;
     int32_t joyState = BSP_JOY_GetState(JOY1);
 
-    // Print decoded joystick state
-    switch (joyState) {
-        case JOY_SEL:   printf("JOY: SELECT\r\n"); break;
-        case JOY_UP:    printf("JOY: UP\r\n"); break;
-        case JOY_DOWN:  printf("JOY: DOWN\r\n"); break;
-        case JOY_LEFT:  printf("JOY: LEFT\r\n"); break;
-        case JOY_RIGHT: printf("JOY: RIGHT\r\n"); break;
-        case JOY_NONE:  printf("JOY: NONE\r\n"); break;
-        default:        printf("JOY: Unknown (0x%02lX)\r\n", joyState); break;
+    if (joyState == prevJoyState)
+    {
+        joyState = JOY_NONE;    // held: already handled
+    }
+    else
+    {
+        prevJoyState = joyState;
+
+        // Print decoded joystick state
+        switch (joyState) {
+            case JOY_SEL:   printf("JOY: SELECT\r\n"); break;
+            case JOY_UP:    printf("JOY: UP\r\n"); break;
+            case JOY_DOWN:  printf("JOY: DOWN\r\n"); break;
+            case JOY_LEFT:  printf("JOY: LEFT\r\n"); break;
+            case JOY_RIGHT: printf("JOY: RIGHT\r\n"); break;
+            case JOY_NONE:  break;
+            default:        printf("JOY: Unknown (0x%02lX)\r\n", joyState); break;
+        }
+    }
+
+    // Power stage modes only while no fault is latched
+    if ((FAULT_GetState() != FAULT_STATE_OK) &&
+        ((joyState == JOY_LEFT) || (joyState == JOY_RIGHT) || (joyState == JOY_DOWN)))
+    {
+        printf("JOY ignored, fault latched\r\n");
+        joyState = JOY_NONE;
     }
 
     // Reassign appMode based on direction
     switch (joyState) {
         case JOY_LEFT:
-            appMode = APP_MODE_BUCK;
+            (void)APP_RequestMode(APP_MODE_BUCK);
             printf("JOY LEFT → BUCK\r\n");
             break;
         case JOY_RIGHT:
-            appMode = APP_MODE_BOOST;
+            (void)APP_RequestMode(APP_MODE_BOOST);
             printf("JOY RIGHT → BOOST\r\n");
             break;
         case JOY_DOWN:
-            appMode = APP_MODE_DE_ENERGIZE;
+            (void)APP_RequestMode(APP_MODE_DE_ENERGIZE);
             printf("JOY DOWN → DE_ENERGIZE\r\n");
             break;
         case JOY_UP:
-            appMode = APP_MODE_FAULT;
+            FAULT_Report(FAULT_CAUSE_MANUAL, 0u, HAL_GetTick());
             printf("JOY UP → FAULT\r\n");
             break;
+        case JOY_SEL:
+            FAULT_ClearLockout(HAL_GetTick());
+            break;
         default:
-            break;  // do nothing on SEL or NONE
+            break;  // do nothing on NONE
     }
 
-    // Optional: debounce SELECT if used elsewhere
-    if (joyState == JOY_SEL) {
-        while (BSP_JOY_GetState(JOY1) == JOY_SEL) {
-            HAL_Delay(20);
-        }
-    }
+    APP_LogStateIfChanged();
 
-    printf("APP_MODE: %d\r\n", appMode);
+    // LEDs blink at APP_LED_BLINK_DIV UI passes per toggle
+    const bool blink = (++blinkCnt >= APP_LED_BLINK_DIV);
+    if (blink)
+        blinkCnt = 0u;
 
     // Act based on current appMode (LEDs, protection, etc.)
     switch (appMode)
     {
         case APP_MODE_BUCK:
-            BSP_LED_Toggle(LED4);
+            if (blink) BSP_LED_Toggle(LED4);
             BSP_LED_Off(LED3);
             break;
 
         case APP_MODE_BOOST:
-            BSP_LED_Toggle(LED3);
+            if (blink) BSP_LED_Toggle(LED3);
             BSP_LED_Off(LED4);
             break;
 
         case APP_MODE_DE_ENERGIZE:
-            if (g_voltages.BUCKBOOST_VOUT_SCALED < DE_ENERGIZING_THRESHOLD) {
+            if (g_values.scaled_mV_u16[MEAS_CH_VOUT] <
+                ((const APP_Params_t *)GCOM_ActiveParams())->deEnergize_mV) {
                 printf("Vout below threshold → BUCK\r\n");
-                appMode = APP_MODE_BUCK;
+                (void)APP_RequestMode(APP_MODE_BUCK);
             }
             BSP_LED_Off(LED3);
             BSP_LED_Off(LED5);
             break;
 
+        case APP_MODE_MOTOR:
+            if (blink)
+            {
+                BSP_LED_Toggle(LED4);
+                BSP_LED_Toggle(LED3);
+            }
+            break;
+
         case APP_MODE_FAULT:
-            LL_HRTIM_ClearFlag_FLT2(HRTIM1);
-            LL_HRTIM_EnableOutput(HRTIM1,
-                LL_HRTIM_OUTPUT_TC1 | LL_HRTIM_OUTPUT_TC2 |
-                LL_HRTIM_OUTPUT_TD1 | LL_HRTIM_OUTPUT_TD2);
-            BSP_LED_Toggle(LED5);
+            /* Outputs stay off, APP_UpdateFaultState() restarts via fault_mgr */
+            if (blink) BSP_LED_Toggle(LED5);
             BSP_LED_Off(LED4);
             BSP_LED_Off(LED3);
             break;
@@ -225,4 +541,146 @@ static void APP_HandleStateMachine(void)
     }
 }
 
+/* Mode change from the joystick or a COMMAND; the target follows the applied parameters */
+static bool APP_RequestMode(AppMode_t mode)
+{
+    if ((FAULT_GetState() != FAULT_STATE_OK) || (mode == APP_MODE_FAULT))
+        return false;
+
+    const APP_Params_t *p = (const APP_Params_t *)GCOM_ActiveParams();
 
+    /* Mode first: an apply in between picks the target of the new mode as well.
+     * Compare and swap: a fault trip after the state check above is never overwritten. */
+    AppMode_t cur = atomic_load(&appMode);
+    do
+    {
+        if (cur == APP_MODE_FAULT)
+            return false;
+    } while (!atomic_compare_exchange_weak(&appMode, &cur, mode));
+    VCTRL_SetTarget_mV(&appVctrl, (mode == APP_MODE_BOOST) ? p->voutBoost_mV : p->voutBuck_mV);
+    return true;
+}
+
+static void APP_StreamConfig(const APP_Params_t *p, STREAM_Config_t *cfg)
+{
+    cfg->recordDiv_u16 = p->streamDiv;
+    memcpy(cfg->chDiv_u8, s_streamChDiv, sizeof(cfg->chDiv_u8));
+}
+
+/* ----------------- parameter hooks ------------------- */
+
+/* Main loop: cross checks over the whole block before it is handed over */
+static bool APP_ParamsValidate(const void *block)
+{
+    const APP_Params_t *p = (const APP_Params_t *)block;
+    STREAM_Config_t streamCfg;
+
+    /* A target at or above the OVP release level would trip and never restart */
+    const uint32_t ovpRelease_mV = p->ovp_mV - (FAULT_OVP_mV - FAULT_OVP_RELEASE_mV);
+    if ((p->voutBuck_mV >= ovpRelease_mV) || (p->voutBoost_mV >= ovpRelease_mV) || (p->motorVmax_mV >= ovpRelease_mV))
+        return false;
+
+    /* The motor current limit has to act before the OCP trip */
+    if (p->motorIlimPin_mV >= (p->ocpPin_mV - (FAULT_OCP_PIN_mV - FAULT_OCP_RELEASE_PIN_mV)))
+        return false;
+
+    APP_StreamConfig(p, &streamCfg);
+    return ((uint64_t)STREAM_BytesPerSecond(&streamCfg) * 100u <=
+            (uint64_t)STREAM_LinkBytesPerSecond(huart3.Init.BaudRate) * STREAM_LINK_BUDGET_PCT);
+}
+
+/* HRTIM1_TIMC_IRQHandler at a PWM period boundary (and once from GCOM_Init) */
+static void APP_ParamsApply(const void *block)
+{
+    const APP_Params_t *p = (const APP_Params_t *)block;
+    STREAM_Config_t streamCfg;
+
+    VCTRL_SetSlew_mV_per_ms(&appVctrl, p->slew_mV_per_ms);
+    VCTRL_SetTarget_mV(&appVctrl, (appMode == APP_MODE_BOOST) ? p->voutBoost_mV : p->voutBuck_mV);
+
+    /* The ADC ISR (FAULT_CheckSample, STREAM_Tick) cannot preempt this one */
+    FAULT_SetThresholds(p->ovp_mV, p->ocpPin_mV, p->uvlo_mV);
+
+    /* Motor limits in ADC codes, through the same calibration as the fault thresholds */
+    const uint16_t iZero = MEAS_PinToCode(MEAS_CH_I_IN_SENSE, 0u);
+    MCTRL_SetCurrentOffset(&appMctrl, iZero);
+    MCTRL_SetLimits(&appMctrl,
+                    (uint16_t)(MEAS_PinToCode(MEAS_CH_I_IN_SENSE, p->motorIlimPin_mV) - iZero),
+                    MEAS_ScaledToCode(MEAS_CH_VOUT, p->motorVmax_mV));
+    MCTRL_SetAccel_rpm_per_s(&appMctrl, p->motorAccel_rpm_per_s);
+    MCTRL_SetSpeed_rpm(&appMctrl, p->motorRpm);
+
+    APP_StreamConfig(p, &streamCfg);
+    (void)STREAM_Configure(&streamCfg, huart3.Init.BaudRate);      /* budget checked by validate */
+    STREAM_Enable(p->streamOn != 0u);
+}
+
+/* Params page sits below the calibration page; erasable alone only with 2K pages (DBANK = 1) */
+static bool APP_ParamsSave(const void *record, uint32_t len)
+{
+    const uint8_t *src = (const uint8_t *)record;
+    bool ok = true;
+
+    if ((READ_BIT(FLASH->OPTR, FLASH_OPTR_DBANK) == 0u) || (len > FLASH_PAGE_SIZE))
+        return false;
+
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_PAGES,
+        .Banks     = FLASH_BANK_2,
+        .Page      = (APP_PARAMS_FLASH_ADDR - (FLASH_BASE + FLASH_BANK_SIZE)) / FLASH_PAGE_SIZE,
+        .NbPages   = 1u
+    };
+    uint32_t pageError = 0u;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+    if (HAL_FLASHEx_Erase(&erase, &pageError) != HAL_OK)
+        ok = false;
+
+    for (uint32_t off = 0u; ok && (off < len); off += 8u)
+    {
+        uint8_t chunk[8];
+        const uint32_t n = ((len - off) < 8u) ? (len - off) : 8u;
+        uint64_t dword;
+
+        memset(chunk, 0xFF, sizeof(chunk));
+        memcpy(chunk, &src[off], n);
+        memcpy(&dword, chunk, sizeof(dword));
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, APP_PARAMS_FLASH_ADDR + off, dword) != HAL_OK)
+            ok = false;
+    }
+
+    HAL_FLASH_Lock();
+    return ok;
+}
+
+static bool APP_ParamsLoad(void *record, uint32_t len)
+{
+    memcpy(record, (const void *)APP_PARAMS_FLASH_ADDR, len);
+    return true;
+}
+
+static GCOM_Status_t APP_Command(uint8_t cmd, const uint8_t *args, uint32_t len)
+{
+    switch (cmd)
+    {
+        case APP_CMD_SET_MODE:
+            if ((len != 1u) ||
+                ((args[0] != APP_MODE_BUCK) && (args[0] != APP_MODE_BOOST) &&
+                 (args[0] != APP_MODE_DE_ENERGIZE) && (args[0] != APP_MODE_MOTOR)))
+                return GCOM_ERR_RANGE;
+            return APP_RequestMode((AppMode_t)args[0]) ? GCOM_OK : GCOM_ERR_REJECTED;
+
+        case APP_CMD_MANUAL_FAULT:
+            FAULT_Report(FAULT_CAUSE_MANUAL, 0u, HAL_GetTick());
+            return GCOM_OK;
+
+        case APP_CMD_CLEAR_LOCKOUT:
+            FAULT_ClearLockout(HAL_GetTick());
+            return GCOM_OK;
+
+        default:
+            return GCOM_ERR_TYPE;
+    }
+}
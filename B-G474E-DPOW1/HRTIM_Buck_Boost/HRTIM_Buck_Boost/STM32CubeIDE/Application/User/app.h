@@ -5,15 +5,91 @@
 #define APP_H
 
 #include "main.h"        // for handles, enums
+#include "voltage_ctrl.h"
+#include "motor_control.h"
+
+/* Output set-points selected with the joystick (one closed loop covers both) */
+#define APP_VOUT_BUCK_mV     3000u
+#define APP_VOUT_BOOST_mV    8000u
+
+/* Start the binary telemetry stream (usb_stream.h) at boot; 0 keeps USART3 text only */
+#define APP_TELEMETRY_AT_BOOT   1u
+
+/* DC motor on the output (motor_control.h): speed set-point, ramp and limits */
+#define APP_MOTOR_RPM           1000u
+#define APP_MOTOR_ILIM_PIN_mV   2000u     /* I_IN_SENSE at the ADC pin, below OCP */
+#define APP_MOTOR_VMAX_mV       8000u
+
+/* Leave DE_ENERGIZE for BUCK below this output voltage */
+#define APP_DE_ENERGIZE_mV   2500u
+
+/* Runtime parameters (com_gcom.h), stored in the flash page below the calibration */
+#define APP_PARAMS_FLASH_ADDR   0x0807F000u
+
+/* Main loop tasks (scheduler.h), in priority order; the control loop stays in the HRTIM ISR */
+typedef enum
+{
+    APP_TASK_PROTECTION = 0,    /* 1 kHz  : fault_mgr recovery, fault log     */
+    APP_TASK_TELEMETRY,         /* 100 Hz : measurement snapshot, commands    */
+    APP_TASK_UI,                /* 10 Hz  : joystick, mode state machine, LEDs */
+    APP_TASK_LOG,               /* 1 Hz   : status text                       */
+    APP_NUM_TASKS
+} APP_TaskId_t;
+
+typedef enum
+{
+    APP_PARAM_VOUT_BUCK_mV = 1,
+    APP_PARAM_VOUT_BOOST_mV,
+    APP_PARAM_SLEW_mV_PER_MS,
+    APP_PARAM_DE_ENERGIZE_mV,
+    APP_PARAM_OVP_mV,
+    APP_PARAM_OCP_PIN_mV,
+    APP_PARAM_UVLO_mV,
+    APP_PARAM_STREAM_DIV,
+    APP_PARAM_STREAM_ON,
+    APP_PARAM_MOTOR_RPM,
+    APP_PARAM_MOTOR_ACCEL,
+    APP_PARAM_MOTOR_ILIM_PIN_mV,
+    APP_PARAM_MOTOR_VMAX_mV
+} APP_ParamId_t;
+
+typedef struct
+{
+    uint16_t voutBuck_mV;
+    uint16_t voutBoost_mV;
+    uint16_t slew_mV_per_ms;
+    uint16_t deEnergize_mV;
+    uint16_t ovp_mV;
+    uint16_t ocpPin_mV;
+    uint16_t uvlo_mV;
+    uint16_t streamDiv;         /* ADC sequences per telemetry record */
+    uint8_t  streamOn;
+    uint16_t motorRpm;
+    uint16_t motorAccel_rpm_per_s;
+    uint16_t motorIlimPin_mV;
+    uint16_t motorVmax_mV;
+} APP_Params_t;
+
+/* COMMAND frame codes */
+typedef enum
+{
+    APP_CMD_SET_MODE = 1,       /* arg: AppMode_t BUCK, BOOST, DE_ENERGIZE or MOTOR */
+    APP_CMD_MANUAL_FAULT,
+    APP_CMD_CLEAR_LOCKOUT
+} APP_Command_t;
 
 typedef enum {
     APP_MODE_BUCK,
     APP_MODE_BOOST,
     APP_MODE_DE_ENERGIZE,
-    APP_MODE_FAULT
+    APP_MODE_FAULT,
+    APP_MODE_MOTOR              /* speed control of a DC motor on the output */
 } AppMode_t;
 
-extern AppMode_t appMode;
+/* Written by the main loop and the fault trip (ADC interrupt), read by the HRTIM tick */
+extern _Atomic AppMode_t appMode;
+extern VCTRL_t   appVctrl;
+extern MCTRL_t   appMctrl;
 
 void APP_Init(void);
 void APP_Task(void);
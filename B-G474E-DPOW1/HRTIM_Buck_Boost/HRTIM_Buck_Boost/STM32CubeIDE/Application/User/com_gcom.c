@@ -5,4 +5,511 @@
  *      Author: HEIR
  */
 
+#include "com_gcom.h"
+#include <stddef.h>
+#include <string.h>
 
+/* CRC-16/CCITT, 4 bit table: two lookups per byte, 32 bytes of flash */
+static const uint16_t s_crcNibble[16] = {
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu
+};
+
+uint16_t GCOM_Crc16(uint16_t crc, const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0u; i < len; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ s_crcNibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ s_crcNibble[(crc >> 12) ^ (data[i] & 0x0Fu)]);
+    }
+    return crc;
+}
+
+uint32_t GCOM_Encode(uint8_t type, const uint8_t *payload, uint32_t len, uint8_t *out)
+{
+    if (len > GCOM_MAX_PAYLOAD)
+        return 0u;
+
+    out[0] = GCOM_SOF0;
+    out[1] = GCOM_SOF1;
+    out[2] = type;
+    out[3] = (uint8_t)len;
+    if (len > 0u)
+        memcpy(&out[4], payload, len);
+
+    const uint16_t crc = GCOM_Crc16(0xFFFFu, &out[2], len + 2u);
+    out[4u + len] = (uint8_t)crc;
+    out[5u + len] = (uint8_t)(crc >> 8);
+    return len + GCOM_OVERHEAD;
+}
+
+bool GCOM_Send(const GCOM_Transport_t *tr, uint8_t type, const uint8_t *payload, uint32_t len)
+{
+    uint8_t frame[GCOM_MAX_FRAME];
+    const uint32_t n = GCOM_Encode(type, payload, len, frame);
+
+    if ((n == 0u) || (tr == NULL) || (tr->write == NULL))
+        return false;
+    return tr->write(frame, n);
+}
+
+void GCOM_DecoderInit(GCOM_Decoder_t *dec)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->state = GCOM_RX_SYNC0;
+}
+
+bool GCOM_DecodeByte(GCOM_Decoder_t *dec, uint8_t byte)
+{
+    switch (dec->state)
+    {
+    case GCOM_RX_SYNC0:
+        if (byte == GCOM_SOF0)
+            dec->state = GCOM_RX_SYNC1;
+        break;
+
+    case GCOM_RX_SYNC1:
+        /* A5 A5 5A: stay aligned on the second A5 */
+        if (byte == GCOM_SOF1)
+            dec->state = GCOM_RX_TYPE;
+        else if (byte != GCOM_SOF0)
+            dec->state = GCOM_RX_SYNC0;
+        break;
+
+    case GCOM_RX_TYPE:
+        dec->type_u8 = byte;
+        dec->crc_u16 = GCOM_Crc16(0xFFFFu, &byte, 1u);
+        dec->state = GCOM_RX_LEN;
+        break;
+
+    case GCOM_RX_LEN:
+        if (byte > GCOM_MAX_PAYLOAD)
+        {
+            dec->state = GCOM_RX_SYNC0;
+            break;
+        }
+        dec->len_u8 = byte;
+        dec->idx_u8 = 0u;
+        dec->crc_u16 = GCOM_Crc16(dec->crc_u16, &byte, 1u);
+        dec->state = (byte > 0u) ? GCOM_RX_PAYLOAD : GCOM_RX_CRC_LO;
+        break;
+
+    case GCOM_RX_PAYLOAD:
+        dec->payload[dec->idx_u8++] = byte;
+        dec->crc_u16 = GCOM_Crc16(dec->crc_u16, &byte, 1u);
+        if (dec->idx_u8 >= dec->len_u8)
+            dec->state = GCOM_RX_CRC_LO;
+        break;
+
+    case GCOM_RX_CRC_LO:
+        dec->rxCrc_u16 = byte;
+        dec->state = GCOM_RX_CRC_HI;
+        break;
+
+    case GCOM_RX_CRC_HI:
+        dec->rxCrc_u16 |= (uint16_t)((uint16_t)byte << 8);
+        dec->state = GCOM_RX_SYNC0;
+        if (dec->rxCrc_u16 == dec->crc_u16)
+        {
+            dec->frames_u32++;
+            return true;
+        }
+        dec->crcErrors_u32++;
+        break;
+
+    default:
+        dec->state = GCOM_RX_SYNC0;
+        break;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Command interface                                                         */
+/* ------------------------------------------------------------------------- */
+
+/* Orders the block copy against the sequence counters (dmb on the M4) */
+#define GCOM_DMB()          __sync_synchronize()
+#define GCOM_RX_MASK        (GCOM_RX_BUF_SIZE - 1u)
+#define GCOM_READ_RETRIES   4u
+
+#if (GCOM_RX_BUF_SIZE & GCOM_RX_MASK) != 0
+#error "GCOM_RX_BUF_SIZE must be a power of 2"
+#endif
+
+typedef union
+{
+    uint8_t  bytes[GCOM_PARAM_BLOCK_MAX];
+    uint32_t align_u32;
+} GCOM_Block_t;
+
+typedef struct
+{
+    uint32_t     magic_u32;
+    uint16_t     size_u16;
+    uint16_t     crc_u16;
+    GCOM_Block_t block;
+} GCOM_StoreRecord_t;
+
+static const GCOM_Config_t    *s_cfg = NULL;
+static const GCOM_Transport_t *s_tr  = NULL;
+
+/* --- RX queue: head written by the UART interrupt, tail by GCOM_Task() --- */
+static uint8_t           s_rxBuf[GCOM_RX_BUF_SIZE];
+static volatile uint32_t s_rxHead;
+static volatile uint32_t s_rxTail;
+static GCOM_Decoder_t    s_dec;
+
+/* --- Parameter handoff: pending written by the main loop, active by the control ISR --- */
+static GCOM_Block_t      s_active;
+static GCOM_Block_t      s_pending;
+static volatile uint32_t s_pendSeq;
+static volatile uint32_t s_applySeq;
+
+static GCOM_Stats_t      s_stats;
+
+static const GCOM_ParamDesc_t *GCOM_FindParam(uint8_t id)
+{
+    for (uint32_t i = 0u; i < s_cfg->numParams_u32; i++)
+    {
+        if (s_cfg->params[i].id_u8 == id)
+            return &s_cfg->params[i];
+    }
+    return NULL;
+}
+
+static uint32_t GCOM_ParamSize(const GCOM_ParamDesc_t *p)
+{
+    return p->type_u8 & 0x0Fu;
+}
+
+/* Little endian wire value <-> native field of the block */
+static uint32_t GCOM_GetField(const GCOM_Block_t *b, const GCOM_ParamDesc_t *p)
+{
+    const uint8_t *f = &b->bytes[p->offset_u16];
+    switch (GCOM_ParamSize(p))
+    {
+    case 1u:  return *f;
+    case 2u:  { uint16_t v; memcpy(&v, f, 2u); return v; }
+    default:  { uint32_t v; memcpy(&v, f, 4u); return v; }
+    }
+}
+
+static void GCOM_PutField(GCOM_Block_t *b, const GCOM_ParamDesc_t *p, uint32_t v)
+{
+    uint8_t *f = &b->bytes[p->offset_u16];
+    switch (GCOM_ParamSize(p))
+    {
+    case 1u:  *f = (uint8_t)v; break;
+    case 2u:  { const uint16_t v16 = (uint16_t)v; memcpy(f, &v16, 2u); break; }
+    default:  memcpy(f, &v, 4u); break;
+    }
+}
+
+static uint32_t GCOM_ReadLE(const uint8_t *p, uint32_t n)
+{
+    uint32_t v = 0u;
+    for (uint32_t i = 0u; i < n; i++)
+        v |= (uint32_t)p[i] << (8u * i);
+    return v;
+}
+
+static bool GCOM_BlockInRange(const GCOM_Block_t *b)
+{
+    for (uint32_t i = 0u; i < s_cfg->numParams_u32; i++)
+    {
+        const uint32_t v = GCOM_GetField(b, &s_cfg->params[i]);
+        if ((v < s_cfg->params[i].min_u32) || (v > s_cfg->params[i].max_u32))
+            return false;
+    }
+    return true;
+}
+
+static bool GCOM_BlockValid(const GCOM_Block_t *b)
+{
+    return GCOM_BlockInRange(b) && ((s_cfg->validate == NULL) || s_cfg->validate(b->bytes));
+}
+
+/* Hand a complete block to the control interrupt */
+static GCOM_Status_t GCOM_Publish(const GCOM_Block_t *b)
+{
+    if (GCOM_IsApplyPending())
+        return GCOM_ERR_BUSY;
+
+    memcpy(s_pending.bytes, b->bytes, s_cfg->blockSize_u32);
+    GCOM_DMB();
+    s_pendSeq = s_applySeq + 1u;
+    return GCOM_OK;
+}
+
+static void GCOM_Respond(uint8_t reqType, const uint8_t *payload, uint32_t len)
+{
+    (void)GCOM_Send(s_tr, (uint8_t)(reqType | GCOM_TYPE_RESP), payload, len);
+}
+
+static void GCOM_RespondStatus(uint8_t reqType, GCOM_Status_t st)
+{
+    const uint8_t status = (uint8_t)st;
+    GCOM_Respond(reqType, &status, 1u);
+}
+
+bool GCOM_Init(const GCOM_Config_t *cfg, const GCOM_Transport_t *tr)
+{
+    if ((cfg == NULL) || (cfg->blockSize_u32 > GCOM_PARAM_BLOCK_MAX) || (cfg->apply == NULL))
+        return false;
+
+    s_cfg = cfg;
+    s_tr  = tr;
+    s_rxHead = s_rxTail = 0u;
+    GCOM_DecoderInit(&s_dec);
+    memset(&s_stats, 0, sizeof(s_stats));
+
+    /* Stored block if intact and still valid for this firmware, else defaults */
+    bool loaded = false;
+    if (cfg->load != NULL)
+    {
+        GCOM_StoreRecord_t rec;
+        if (cfg->load(&rec, sizeof(rec)) &&
+            (rec.magic_u32 == GCOM_STORE_MAGIC) &&
+            (rec.size_u16 == cfg->blockSize_u32) &&
+            (rec.crc_u16 == GCOM_Crc16(0xFFFFu, rec.block.bytes, cfg->blockSize_u32)) &&
+            GCOM_BlockValid(&rec.block))
+        {
+            memcpy(s_active.bytes, rec.block.bytes, cfg->blockSize_u32);
+            loaded = true;
+        }
+    }
+    if (!loaded)
+        memcpy(s_active.bytes, cfg->defaults, cfg->blockSize_u32);
+
+    /* Control interrupt not using the block yet: apply directly */
+    memcpy(s_pending.bytes, s_active.bytes, cfg->blockSize_u32);
+    s_pendSeq = s_applySeq = 0u;
+    cfg->apply(s_active.bytes);
+    return loaded;
+}
+
+void GCOM_RxPush(uint8_t byte)
+{
+    const uint32_t head = s_rxHead;
+    if ((head - s_rxTail) >= GCOM_RX_BUF_SIZE)
+    {
+        s_stats.rxOverruns_u32++;
+        return;
+    }
+    s_rxBuf[head & GCOM_RX_MASK] = byte;
+    s_rxHead = head + 1u;
+}
+
+void GCOM_ApplyPending(void)
+{
+    const uint32_t seq = s_pendSeq;
+    if ((s_cfg == NULL) || (seq == s_applySeq))
+        return;
+
+    memcpy(s_active.bytes, s_pending.bytes, s_cfg->blockSize_u32);
+    s_cfg->apply(s_active.bytes);
+    s_stats.applied_u32++;
+    GCOM_DMB();
+    s_applySeq = seq;
+}
+
+bool GCOM_IsApplyPending(void)
+{
+    return s_pendSeq != s_applySeq;
+}
+
+void GCOM_ReadParams(void *dst)
+{
+    /* The block only changes when s_applySeq does; retry if the ISR swapped it meanwhile */
+    for (uint32_t i = 0u; i < GCOM_READ_RETRIES; i++)
+    {
+        const uint32_t seq = s_applySeq;
+        GCOM_DMB();
+        memcpy(dst, s_active.bytes, s_cfg->blockSize_u32);
+        GCOM_DMB();
+        if (seq == s_applySeq)
+            return;
+    }
+}
+
+const void *GCOM_ActiveParams(void)
+{
+    return s_active.bytes;
+}
+
+GCOM_Status_t GCOM_SetParams(const uint8_t *entries, uint32_t len, uint32_t *badIndex)
+{
+    GCOM_Block_t cand;
+    uint32_t idx = 0u;
+
+    *badIndex = 0u;
+    if (GCOM_IsApplyPending())
+        return GCOM_ERR_BUSY;
+
+    /* Start from the applied block, nothing is pending at this point */
+    memcpy(cand.bytes, s_active.bytes, s_cfg->blockSize_u32);
+
+    for (uint32_t pos = 0u; pos < len; idx++)
+    {
+        *badIndex = idx;
+        const GCOM_ParamDesc_t *p = GCOM_FindParam(entries[pos]);
+        if (p == NULL)
+            return GCOM_ERR_PARAM;
+        const uint32_t size = GCOM_ParamSize(p);
+        if ((pos + 1u + size) > len)
+            return GCOM_ERR_LEN;
+        const uint32_t v = GCOM_ReadLE(&entries[pos + 1u], size);
+        if ((v < p->min_u32) || (v > p->max_u32))
+            return GCOM_ERR_RANGE;
+        GCOM_PutField(&cand, p, v);
+        pos += 1u + size;
+    }
+    *badIndex = idx;
+
+    if ((s_cfg->validate != NULL) && !s_cfg->validate(cand.bytes))
+        return GCOM_ERR_INVALID;
+
+    return GCOM_Publish(&cand);
+}
+
+GCOM_Status_t GCOM_SaveParams(void)
+{
+    if (s_cfg->save == NULL)
+        return GCOM_ERR_STORAGE;
+
+    GCOM_StoreRecord_t rec;
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.magic_u32 = GCOM_STORE_MAGIC;
+    rec.size_u16  = (uint16_t)s_cfg->blockSize_u32;
+    GCOM_ReadParams(rec.block.bytes);
+    rec.crc_u16   = GCOM_Crc16(0xFFFFu, rec.block.bytes, s_cfg->blockSize_u32);
+
+    return s_cfg->save(&rec, sizeof(rec)) ? GCOM_OK : GCOM_ERR_STORAGE;
+}
+
+static void GCOM_HandleGet(const uint8_t *req, uint32_t len)
+{
+    GCOM_Block_t cur;
+    uint8_t resp[GCOM_MAX_PAYLOAD];
+    uint32_t n = 1u;
+    const uint32_t count = (len == 0u) ? s_cfg->numParams_u32 : len;
+
+    GCOM_ReadParams(cur.bytes);
+    resp[0] = GCOM_OK;
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        const GCOM_ParamDesc_t *p = (len == 0u) ? &s_cfg->params[i] : GCOM_FindParam(req[i]);
+        if (p == NULL)
+        {
+            resp[0] = GCOM_ERR_PARAM;
+            n = 1u;
+            break;
+        }
+        const uint32_t size = GCOM_ParamSize(p);
+        if ((n + 1u + size) > sizeof(resp))
+        {
+            resp[0] = GCOM_ERR_LEN;
+            n = 1u;
+            break;
+        }
+        const uint32_t v = GCOM_GetField(&cur, p);
+        resp[n++] = p->id_u8;
+        for (uint32_t b = 0u; b < size; b++)
+            resp[n++] = (uint8_t)(v >> (8u * b));
+    }
+    GCOM_Respond(GCOM_TYPE_PARAM_GET, resp, n);
+    if (resp[0] != GCOM_OK)
+        s_stats.errors_u32++;
+}
+
+static void GCOM_HandleFrame(uint8_t type, const uint8_t *payload, uint32_t len)
+{
+    GCOM_Status_t st;
+    uint32_t badIndex = 0u;
+
+    /* Own responses and telemetry echoed back are not requests */
+    if (((type & GCOM_TYPE_RESP) != 0u) || (type == GCOM_TYPE_TELEMETRY))
+        return;
+
+    s_stats.requests_u32++;
+    switch (type)
+    {
+    case GCOM_TYPE_PARAM_GET:
+        GCOM_HandleGet(payload, len);
+        return;
+
+    case GCOM_TYPE_PARAM_SET:
+    {
+        st = GCOM_SetParams(payload, len, &badIndex);
+        const uint8_t resp[2] = { (uint8_t)st, (uint8_t)badIndex };
+        GCOM_Respond(type, resp, sizeof(resp));
+        break;
+    }
+
+    case GCOM_TYPE_PARAM_SAVE:
+        st = GCOM_IsApplyPending() ? GCOM_ERR_BUSY : GCOM_SaveParams();
+        GCOM_RespondStatus(type, st);
+        break;
+
+    case GCOM_TYPE_PARAM_DEFAULTS:
+    {
+        GCOM_Block_t def;
+        memcpy(def.bytes, s_cfg->defaults, s_cfg->blockSize_u32);
+        st = GCOM_Publish(&def);
+        GCOM_RespondStatus(type, st);
+        break;
+    }
+
+    case GCOM_TYPE_COMMAND:
+        if ((len == 0u) || (s_cfg->command == NULL))
+            st = (len == 0u) ? GCOM_ERR_LEN : GCOM_ERR_TYPE;
+        else
+            st = s_cfg->command(payload[0], &payload[1], len - 1u);
+        GCOM_RespondStatus(type, st);
+        break;
+
+    default:
+        st = GCOM_ERR_TYPE;
+        GCOM_RespondStatus(type, st);
+        break;
+    }
+
+    if (st != GCOM_OK)
+        s_stats.errors_u32++;
+}
+
+uint32_t GCOM_Task(void)
+{
+    if (s_cfg == NULL)
+        return 0u;
+
+    /* Bounded: at most GCOM_RX_BUDGET bytes and one request per call */
+    uint32_t tail = s_rxTail;
+    const uint32_t head = s_rxHead;
+    uint32_t used = 0u;
+    uint32_t handled = 0u;
+
+    while ((tail != head) && (used < GCOM_RX_BUDGET))
+    {
+        const uint8_t byte = s_rxBuf[tail & GCOM_RX_MASK];
+        tail++;
+        used++;
+        if (GCOM_DecodeByte(&s_dec, byte))
+        {
+            GCOM_HandleFrame(s_dec.type_u8, s_dec.payload, s_dec.len_u8);
+            handled++;
+            break;
+        }
+    }
+    s_rxTail = tail;
+
+    if (used > s_stats.maxTaskBytes_u32)
+        s_stats.maxTaskBytes_u32 = used;
+    return handled;
+}
+
+const GCOM_Stats_t *GCOM_GetStats(void)
+{
+    return &s_stats;
+}
@@ -3,11 +3,187 @@
  *
  *  Created on: Jan 17, 2026
  *      Author: HEIR
+ *
+ *  Binary framing on the debug UART, shared with the printf text.
+ *
+ *      | 0xA5 | 0x5A | type | len | payload[len] | crc16 lo | crc16 hi |
+ *
+ *  The CRC-16/CCITT (poly 0x1021, init 0xFFFF) covers type, len and payload.
+ *  The decoder hunts for the sync bytes, so text between frames is skipped and
+ *  a corrupted frame costs at most the bytes up to the next sync. Payload fields
+ *  are little endian.
+ *
+ *  Frames leave through a GCOM_Transport_t; on target that is RetargetWrite(),
+ *  on the host any byte sink. A frame is handed over in one call, so a transport
+ *  with whole-write drop policy never emits half a frame.
+ *
+ *  Command interface
+ *  -----------------
+ *  Received bytes are queued by GCOM_RxPush() (UART RX interrupt) and parsed by
+ *  GCOM_Task() in the main loop, at most GCOM_RX_BUDGET bytes and one request per
+ *  call. Each request gets one response frame of type (request | GCOM_TYPE_RESP),
+ *  payload[0] = GCOM_Status_t.
+ *
+ *      PARAM_GET  [id ...]            -> [status] [id value] ...   (no ids: all)
+ *      PARAM_SET  [id value] ...      -> [status] [index of the rejected entry]
+ *      PARAM_SAVE                     -> [status]
+ *      PARAM_DEFAULTS                 -> [status]
+ *      COMMAND    [cmd] [args]        -> [status]   (handled by the application)
+ *
+ *  Values are little endian with the size of their GCOM_ParamType_t. The
+ *  parameters live in one block described by the application's GCOM_ParamDesc_t
+ *  table. A SET is all or nothing: the entries are range checked, the whole
+ *  resulting block goes through the validate hook (cross checks such as target
+ *  below OVP), then it is handed to the control interrupt, which calls
+ *  GCOM_ApplyPending() at a PWM period boundary. The interrupt swaps the complete
+ *  block and calls the apply hook, so the control code never sees half an update.
+ *  A new SET is answered BUSY until the previous one was applied.
+ *
+ *  SAVE writes the active block with magic, size and CRC through the storage
+ *  hook; GCOM_Init() loads it back, falling back to the defaults when the record
+ *  is missing or invalid.
  */
 
 #ifndef APPLICATION_USER_COM_GCOM_H_
 #define APPLICATION_USER_COM_GCOM_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GCOM_SOF0               0xA5u
+#define GCOM_SOF1               0x5Au
+#define GCOM_MAX_PAYLOAD        64u
+#define GCOM_OVERHEAD           6u      /* sync, type, len, crc */
+#define GCOM_MAX_FRAME          (GCOM_MAX_PAYLOAD + GCOM_OVERHEAD)
+
+/* Frame types */
+#define GCOM_TYPE_TELEMETRY     0x01u
+#define GCOM_TYPE_PARAM_GET     0x10u
+#define GCOM_TYPE_PARAM_SET     0x11u
+#define GCOM_TYPE_PARAM_SAVE    0x12u
+#define GCOM_TYPE_PARAM_DEFAULTS 0x13u
+#define GCOM_TYPE_COMMAND       0x14u
+#define GCOM_TYPE_RESP          0x80u   /* or-ed into the request type */
+
+#define GCOM_RX_BUF_SIZE        256u    /* power of 2 */
+#define GCOM_RX_BUDGET          64u     /* bytes parsed per GCOM_Task() */
+#define GCOM_PARAM_BLOCK_MAX    64u     /* bytes of parameter storage */
+#define GCOM_STORE_MAGIC        0x52415047u     /* "GPAR" */
+
+typedef enum
+{
+    GCOM_OK = 0,
+    GCOM_ERR_TYPE,          /* unknown request                  */
+    GCOM_ERR_LEN,           /* payload does not match the table */
+    GCOM_ERR_PARAM,         /* unknown parameter id             */
+    GCOM_ERR_RANGE,         /* value outside min/max            */
+    GCOM_ERR_INVALID,       /* rejected by the validate hook    */
+    GCOM_ERR_BUSY,          /* previous SET not applied yet     */
+    GCOM_ERR_STORAGE,
+    GCOM_ERR_REJECTED       /* COMMAND refused by the application */
+} GCOM_Status_t;
+
+/* Low nibble: size in bytes */
+typedef enum
+{
+    GCOM_PT_U8   = 0x01u,
+    GCOM_PT_U16  = 0x02u,
+    GCOM_PT_U32  = 0x04u,
+    GCOM_PT_BOOL = 0x11u
+} GCOM_ParamType_t;
+
+typedef struct
+{
+    uint8_t  id_u8;
+    uint8_t  type_u8;           /* GCOM_ParamType_t                 */
+    uint16_t offset_u16;        /* offsetof() in the parameter block */
+    uint32_t min_u32;
+    uint32_t max_u32;
+} GCOM_ParamDesc_t;
+
+typedef struct
+{
+    /* Queue len bytes, false if dropped. May be called from interrupts. */
+    bool (*write)(const void *data, uint32_t len);
+} GCOM_Transport_t;
+
+typedef struct
+{
+    const GCOM_ParamDesc_t *params;
+    uint32_t    numParams_u32;
+    uint32_t    blockSize_u32;      /* <= GCOM_PARAM_BLOCK_MAX */
+    const void *defaults;
+    /* Whole-block checks, main loop; NULL = ranges only */
+    bool    (*validate)(const void *block);
+    /* Takes over a new block, control interrupt at the PWM boundary (and once in GCOM_Init) */
+    void    (*apply)(const void *block);
+    /* Persistent record, main loop; NULL = no persistence */
+    bool    (*save)(const void *record, uint32_t len);
+    bool    (*load)(void *record, uint32_t len);
+    /* COMMAND requests; NULL = none */
+    GCOM_Status_t (*command)(uint8_t cmd, const uint8_t *args, uint32_t len);
+} GCOM_Config_t;
+
+typedef struct
+{
+    uint32_t requests_u32;
+    uint32_t errors_u32;
+    uint32_t applied_u32;
+    uint32_t rxOverruns_u32;
+    uint32_t maxTaskBytes_u32;
+} GCOM_Stats_t;
+
+typedef enum
+{
+    GCOM_RX_SYNC0 = 0,
+    GCOM_RX_SYNC1,
+    GCOM_RX_TYPE,
+    GCOM_RX_LEN,
+    GCOM_RX_PAYLOAD,
+    GCOM_RX_CRC_LO,
+    GCOM_RX_CRC_HI
+} GCOM_RxState_t;
+
+typedef struct
+{
+    GCOM_RxState_t state;
+    uint8_t  type_u8;
+    uint8_t  len_u8;
+    uint8_t  idx_u8;
+    uint16_t crc_u16;
+    uint16_t rxCrc_u16;
+    uint8_t  payload[GCOM_MAX_PAYLOAD];
+    uint32_t frames_u32;
+    uint32_t crcErrors_u32;
+} GCOM_Decoder_t;
+
+uint16_t GCOM_Crc16(uint16_t crc, const uint8_t *data, uint32_t len);
+
+/* Build a frame into out[GCOM_MAX_FRAME]; returns its size, 0 if len is too long */
+uint32_t GCOM_Encode(uint8_t type, const uint8_t *payload, uint32_t len, uint8_t *out);
+
+/* Encode and hand over to the transport in one write */
+bool     GCOM_Send(const GCOM_Transport_t *tr, uint8_t type, const uint8_t *payload, uint32_t len);
+
+void     GCOM_DecoderInit(GCOM_Decoder_t *dec);
+/* Feed one received byte; true when a frame with valid CRC is in dec->payload */
+bool     GCOM_DecodeByte(GCOM_Decoder_t *dec, uint8_t byte);
+
+/* Command interface: init loads the stored block (or defaults) and applies it */
+bool     GCOM_Init(const GCOM_Config_t *cfg, const GCOM_Transport_t *tr);
+void     GCOM_RxPush(uint8_t byte);                 /* UART RX interrupt */
+uint32_t GCOM_Task(void);                           /* main loop, returns requests handled */
+void     GCOM_ApplyPending(void);                   /* control interrupt, PWM boundary */
+
+/* Main loop side of the handoff, also used by GCOM_Task() */
+GCOM_Status_t GCOM_SetParams(const uint8_t *entries, uint32_t len, uint32_t *badIndex);
+GCOM_Status_t GCOM_SaveParams(void);
+bool     GCOM_IsApplyPending(void);
+/* Consistent copy of the applied block */
+void     GCOM_ReadParams(void *dst);
+/* Applied block; single fields may be read directly */
+const void *GCOM_ActiveParams(void);
 
+const GCOM_Stats_t *GCOM_GetStats(void);
 
 #endif /* APPLICATION_USER_COM_GCOM_H_ */
@@ -0,0 +1,95 @@
+/*
+ * compensator.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ */
+
+#include "compensator.h"
+
+#include <string.h>
+
+void COMP_InitPI(COMP_t *c, int16_t kp_s16, int16_t ki_s16, uint8_t postShift_u8, int16_t uMin_s16, int16_t uMax_s16)
+{
+    /* y[n] = y[n-1] + (kp + ki) x[n] - kp x[n-1]; a1 = 1.0 needs R >= 1 */
+    const int32_t b0 = (int32_t)kp_s16 + ki_s16;
+
+    memset(c, 0, sizeof(*c));
+    c->order_u8     = 1U;
+    c->postShift_u8 = (postShift_u8 == 0U) ? 1U : postShift_u8;
+    c->b_s16[0]     = (int16_t)((b0 > INT16_MAX) ? INT16_MAX : b0);
+    c->b_s16[1]     = (int16_t)(-kp_s16);
+    c->a_s16[0]     = (int16_t)(0x8000 >> c->postShift_u8);
+    c->uMin_s16     = uMin_s16;
+    c->uMax_s16     = uMax_s16;
+}
+
+bool COMP_InitNpNz(COMP_t *c, const COMP_Coeffs_t *coeffs, int16_t uMin_s16, int16_t uMax_s16)
+{
+    /* The history shifts in COMP_Step()/COMP_Track() need at least one tap */
+    if ((coeffs->order_u8 == 0U) || (coeffs->order_u8 > COMP_MAX_ORDER) || (coeffs->postShift_u8 > 7U))
+        return false;
+
+    memset(c, 0, sizeof(*c));
+    c->order_u8     = coeffs->order_u8;
+    c->postShift_u8 = coeffs->postShift_u8;
+    memcpy(c->b_s16, coeffs->b_s16, sizeof(c->b_s16));
+    memcpy(c->a_s16, coeffs->a_s16, sizeof(c->a_s16));
+    c->uMin_s16     = uMin_s16;
+    c->uMax_s16     = uMax_s16;
+    return true;
+}
+
+void COMP_Reset(COMP_t *c, int16_t u0_s16)
+{
+    for (uint32_t k = 0U; k < COMP_MAX_ORDER; k++)
+    {
+        c->x_s16[k] = 0;
+        c->y_s16[k] = u0_s16;
+    }
+}
+
+int16_t COMP_Step(COMP_t *c, int16_t e_s16)
+{
+    const uint32_t n = c->order_u8;
+
+    /* Q2.30 products, at most 7 of them: no overflow in 64 bit */
+    int64_t acc = (int64_t)c->b_s16[0] * e_s16;
+    for (uint32_t k = 0U; k < n; k++)
+    {
+        acc += (int32_t)c->b_s16[k + 1U] * c->x_s16[k];
+        acc += (int32_t)c->a_s16[k] * c->y_s16[k];
+    }
+
+    /* Back to Q1.15 with the post-shift, then clamp (anti-windup: clamped value is stored) */
+    int32_t u = (int32_t)(acc >> (15U - c->postShift_u8));
+    if (u > c->uMax_s16)
+    {
+        u = c->uMax_s16;
+    }
+    else if (u < c->uMin_s16)
+    {
+        u = c->uMin_s16;
+    }
+
+    for (uint32_t k = n - 1U; k > 0U; k--)
+    {
+        c->x_s16[k] = c->x_s16[k - 1U];
+        c->y_s16[k] = c->y_s16[k - 1U];
+    }
+    c->x_s16[0] = e_s16;
+    c->y_s16[0] = (int16_t)u;
+
+    return (int16_t)u;
+}
+
+void COMP_Track(COMP_t *c, int16_t e_s16, int16_t u_s16)
+{
+    for (uint32_t k = c->order_u8 - 1U; k > 0U; k--)
+    {
+        c->x_s16[k] = c->x_s16[k - 1U];
+        c->y_s16[k] = c->y_s16[k - 1U];
+    }
+    c->x_s16[0] = e_s16;
+    c->y_s16[0] = (u_s16 > c->uMax_s16) ? c->uMax_s16 : ((u_s16 < c->uMin_s16) ? c->uMin_s16 : u_s16);
+}
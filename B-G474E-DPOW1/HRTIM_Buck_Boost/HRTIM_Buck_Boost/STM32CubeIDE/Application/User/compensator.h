@@ -0,0 +1,73 @@
+/*
+ * compensator.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Fixed-point discrete compensators for the power stage: PI, 2p2z and 3p3z.
+ *
+ *  All three are one IIR form, in the number format of the G4 FMAC IIR:
+ *
+ *      acc  = b0*x[n] + b1*x[n-1] + ... + bN*x[n-N] + a1*y[n-1] + ... + aN*y[n-N]
+ *      y[n] = sat(acc * 2^R)   with Q1.15 coefficients, Q1.15 input and output
+ *
+ *  The coefficients are the real ones scaled by 2^-R (R = postShift_u8), so gains up
+ *  to 2^R are representable. Note the sign of the a-coefficients: y[n] = ... + a*y,
+ *  the FMAC convention, not the "1 + a1 z^-1" denominator of most design tools.
+ *
+ *  A PI is the 1p1z case: y[n] = y[n-1] + (kp + ki)*x[n] - kp*x[n-1].
+ *
+ *  Anti-windup: the output is clamped to [uMin, uMax] and the clamped value is
+ *  what enters the y history, so an integrating compensator stops integrating at
+ *  the limit and leaves it as soon as the error changes sign.
+ *
+ *  No hardware access, the same code runs in the HRTIM ISR and on a host.
+ */
+
+#ifndef APPLICATION_USER_COMPENSATOR_H_
+#define APPLICATION_USER_COMPENSATOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define COMP_MAX_ORDER      3U
+
+typedef struct
+{
+    uint8_t  order_u8;                      /* 1 = PI, 2 = 2p2z, 3 = 3p3z        */
+    uint8_t  postShift_u8;                  /* R, 0..7 like the FMAC             */
+    int16_t  b_s16[COMP_MAX_ORDER + 1U];    /* b0..bN, Q1.15 * 2^-R              */
+    int16_t  a_s16[COMP_MAX_ORDER];         /* a1..aN, Q1.15 * 2^-R (FMAC sign)  */
+    int16_t  uMin_s16;                      /* output clamp, Q1.15               */
+    int16_t  uMax_s16;
+    int16_t  x_s16[COMP_MAX_ORDER];         /* x[n-1] .. x[n-N]                  */
+    int16_t  y_s16[COMP_MAX_ORDER];         /* y[n-1] .. y[n-N] (clamped)        */
+} COMP_t;
+
+/* Coefficient set of a 2p2z/3p3z, real values scaled by 2^-postShift (see above) */
+typedef struct
+{
+    uint8_t  order_u8;
+    uint8_t  postShift_u8;
+    int16_t  b_s16[COMP_MAX_ORDER + 1U];
+    int16_t  a_s16[COMP_MAX_ORDER];
+} COMP_Coeffs_t;
+
+/* PI with kp, ki in Q1.15 * 2^-postShift (ki per sample) */
+void    COMP_InitPI(COMP_t *c, int16_t kp_s16, int16_t ki_s16, uint8_t postShift_u8, int16_t uMin_s16, int16_t uMax_s16);
+
+/* 2p2z / 3p3z from a coefficient set. False, c untouched, for an order outside
+ * 1..COMP_MAX_ORDER or a post-shift above 7. */
+bool    COMP_InitNpNz(COMP_t *c, const COMP_Coeffs_t *coeffs, int16_t uMin_s16, int16_t uMax_s16);
+
+/* Bumpless (re)start: the output holds u0 until the error moves it */
+void    COMP_Reset(COMP_t *c, int16_t u0_s16);
+
+/* One control step: error in Q1.15, returns the clamped output in Q1.15 */
+int16_t COMP_Step(COMP_t *c, int16_t e_s16);
+
+/* A step whose output is imposed from outside (tracking anti-windup): the histories
+ * take e and the clamped u, so the next COMP_Step() continues from u without a jump */
+void    COMP_Track(COMP_t *c, int16_t e_s16, int16_t u_s16);
+
+#endif /* APPLICATION_USER_COMPENSATOR_H_ */
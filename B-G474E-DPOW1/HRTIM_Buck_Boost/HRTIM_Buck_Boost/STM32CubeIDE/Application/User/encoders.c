@@ -5,4 +5,230 @@
  *      Author: HEIR
  */
 
+#include "encoders.h"
+#include "main.h"
+#include <string.h>
 
+#define ENC_SPEED_SCALE     ((float)ENC_TIME_HZ * 256.0f)      /* counts/tick -> counts/s Q8 */
+#define ENC_SPEED_LIMIT     2.0e9f      /* Q8 range, ~7.8 Mcounts/s */
+#define ENC_READ_RETRIES    3u
+
+static ENC_t          s_enc;
+static ENC_Snapshot_t s_snaps[2];
+static volatile uint32_t s_pubSeq = 0u;
+static ENC_Stats_t    s_stats;
+
+void ENC_Reset(ENC_t *e, const ENC_Raw_t *raw)
+{
+    memset(e, 0, sizeof(*e));
+    e->lastCnt_u16 = raw->cnt_u16;
+    e->lastNow_u16 = raw->now_u16;
+    e->snap.edgeAge_u32 = UINT32_MAX;
+}
+
+bool ENC_Process(ENC_t *e, const ENC_Raw_t *raw)
+{
+    bool closed = false;
+
+    /* 16 -> 32 bit: the wrapped difference is the movement since the last read */
+    const int32_t delta = (int16_t)(uint16_t)(raw->cnt_u16 - e->lastCnt_u16);
+    e->lastCnt_u16 = raw->cnt_u16;
+    e->pos_s32 += delta;
+
+    e->time_u32 += (uint16_t)(raw->now_u16 - e->lastNow_u16);
+    e->lastNow_u16 = raw->now_u16;
+
+    /* A count change is an edge even if its capture flag was consumed by a re-read */
+    if (raw->newEdge || (delta != 0))
+    {
+        const uint32_t edge = e->time_u32 - (uint16_t)(raw->now_u16 - raw->edge_u16);
+        e->lastEdge_u32 = edge;
+        e->haveEdge = true;
+
+        if (!e->winOpen)
+        {
+            e->winTime_u32 = edge;
+            e->winPos_s32  = e->pos_s32;
+            e->winOpen     = true;
+        }
+        else
+        {
+            const uint32_t dt = edge - e->winTime_u32;
+            const int8_t   dir = (delta > 0) ? 1 : ((delta < 0) ? -1 : 0);
+
+            if ((dir != 0) && (e->dir_s8 != 0) && (dir != e->dir_s8))
+            {
+                /* Reversal: the net count would average across it, restart at this edge */
+                e->winTime_u32 = edge;
+                e->winPos_s32  = e->pos_s32;
+                e->measValid   = false;
+                e->measured_cps_q8 = 0;
+            }
+            else if (dt >= ENC_MIN_WINDOW_TICKS)
+            {
+                const int32_t dn = e->pos_s32 - e->winPos_s32;
+                float cps = (float)dn * ENC_SPEED_SCALE / (float)dt;
+                if (cps > ENC_SPEED_LIMIT)  cps = ENC_SPEED_LIMIT;
+                if (cps < -ENC_SPEED_LIMIT) cps = -ENC_SPEED_LIMIT;
+                e->measured_cps_q8 = (int32_t)cps;
+                e->measValid   = true;
+                e->winTime_u32 = edge;
+                e->winPos_s32  = e->pos_s32;
+                closed = true;
+            }
+        }
+        if (delta != 0)
+            e->dir_s8 = (delta > 0) ? 1 : -1;
+    }
+
+    int32_t  speed = 0;
+    bool     valid = false;
+    uint32_t age   = UINT32_MAX;
+
+    if (e->haveEdge)
+    {
+        age = e->time_u32 - e->lastEdge_u32;
+        if (age >= ENC_STANDSTILL_TICKS)
+        {
+            /* Stopped: next window starts at the next edge */
+            e->haveEdge  = false;
+            e->winOpen   = false;
+            e->measValid = false;
+            e->measured_cps_q8 = 0;
+        }
+        else if (e->measValid)
+        {
+            speed = e->measured_cps_q8;
+            valid = true;
+
+            /* No edge for longer than the measured period: at most one count over that time */
+            if (age > 0u)
+            {
+                const float bound = ENC_SPEED_SCALE / (float)age;
+                const float mag   = (speed < 0) ? -(float)speed : (float)speed;
+                if (mag > bound)
+                {
+                    speed = (speed < 0) ? -(int32_t)bound : (int32_t)bound;
+                    valid = false;
+                }
+            }
+        }
+    }
+
+    e->snap.seq_u32++;
+    e->snap.pos_s32      = e->pos_s32;
+    e->snap.delta_s32    = delta;
+    e->snap.speed_cps_q8 = speed;
+    e->snap.edgeAge_u32  = age;
+    e->snap.speedValid   = valid;
+    return closed;
+}
+
+void ENC_Init(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    __HAL_RCC_TIM4_CLK_ENABLE();
+
+    /* PC6 = TIM3_CH1 (A), PC7 = TIM3_CH2 (B) */
+    gpio.Pin       = GPIO_PIN_6 | GPIO_PIN_7;
+    gpio.Mode      = GPIO_MODE_AF_PP;
+    gpio.Pull      = GPIO_PULLUP;
+    gpio.Speed     = GPIO_SPEED_FREQ_LOW;
+    gpio.Alternate = GPIO_AF2_TIM3;
+    HAL_GPIO_Init(GPIOC, &gpio);
+
+    /* TIM3: encoder mode 3 (x4), TI1/TI2 filtered, TRGO = encoder clock */
+    ENC_TIM->CR1   = 0u;
+    ENC_TIM->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC2S_0 |
+                     (ENC_INPUT_FILTER << TIM_CCMR1_IC1F_Pos) | (ENC_INPUT_FILTER << TIM_CCMR1_IC2F_Pos);
+    ENC_TIM->CCER  = 0u;
+    ENC_TIM->SMCR  = TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1;
+    ENC_TIM->CR2   = TIM_CR2_MMS_3;
+    ENC_TIM->ARR   = 0xFFFFu;
+    ENC_TIM->CNT   = 0u;
+
+    /* TIM4: free running at ENC_TIME_HZ, CH1 captures TRC = ITR2 = TIM3 TRGO */
+    ENC_TIME_TIM->CR1   = 0u;
+    ENC_TIME_TIM->PSC   = (SystemCoreClock / ENC_TIME_HZ) - 1u;
+    ENC_TIME_TIM->ARR   = 0xFFFFu;
+    ENC_TIME_TIM->SMCR  = TIM_SMCR_TS_1;
+    ENC_TIME_TIM->CCMR1 = TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC1S_1;
+    ENC_TIME_TIM->CCER  = TIM_CCER_CC1E;
+    ENC_TIME_TIM->EGR   = TIM_EGR_UG;           /* load PSC */
+    ENC_TIME_TIM->SR    = 0u;
+
+    ENC_TIME_TIM->CR1 |= TIM_CR1_CEN;
+    ENC_TIM->CR1      |= TIM_CR1_CEN;
+
+    ENC_Raw_t raw = { (uint16_t)ENC_TIM->CNT, (uint16_t)ENC_TIME_TIM->CNT, 0u, false };
+    ENC_Reset(&s_enc, &raw);
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+/* Count, time and last edge time belonging together: re-read if an edge came in between */
+static void ENC_ReadRaw(ENC_Raw_t *raw)
+{
+    uint16_t cnt = (uint16_t)ENC_TIM->CNT;
+
+    raw->newEdge = false;
+    for (uint32_t i = 0u; i < ENC_READ_RETRIES; i++)
+    {
+        raw->newEdge |= ((ENC_TIME_TIM->SR & TIM_SR_CC1IF) != 0u);
+        raw->edge_u16 = (uint16_t)ENC_TIME_TIM->CCR1;       /* clears CC1IF */
+        raw->now_u16  = (uint16_t)ENC_TIME_TIM->CNT;
+        const uint16_t again = (uint16_t)ENC_TIM->CNT;
+        if (again == cnt)
+            break;
+        cnt = again;
+        s_stats.rereads_u32++;
+    }
+    raw->cnt_u16 = cnt;
+}
+
+const ENC_Snapshot_t *ENC_Update(void)
+{
+    const uint32_t start = DWT->CYCCNT;
+    ENC_Raw_t raw;
+
+    ENC_ReadRaw(&raw);
+    if (ENC_Process(&s_enc, &raw))
+        s_stats.windows_u32++;
+
+    /* Publish into the slot readers are not using */
+    const uint32_t seq = s_pubSeq + 1u;
+    s_snaps[seq & 1u] = s_enc.snap;
+    __DMB();
+    s_pubSeq = seq;
+
+    const uint32_t cycles = DWT->CYCCNT - start;
+    s_stats.updates_u32++;
+    s_stats.lastCycles_u32 = cycles;
+    if (cycles > s_stats.maxCycles_u32)
+        s_stats.maxCycles_u32 = cycles;
+    return &s_enc.snap;
+}
+
+bool ENC_GetSnapshot(ENC_Snapshot_t *snap)
+{
+    for (uint32_t i = 0u; i < ENC_READ_RETRIES; i++)
+    {
+        const uint32_t seq = s_pubSeq;
+        if (seq == 0u)
+            return false;
+        __DMB();
+        *snap = s_snaps[seq & 1u];
+        __DMB();
+        /* Slot reused only after two more publications */
+        if ((s_pubSeq - seq) < 2u)
+            return true;
+    }
+    return false;
+}
+
+const ENC_Stats_t *ENC_GetStats(void)
+{
+    return &s_stats;
+}
@@ -3,11 +3,120 @@
  *
  *  Created on: Jan 17, 2026
  *      Author: HEIR
+ *
+ *  Incremental quadrature encoder: position and M/T speed.
+ *
+ *  ENC_TIM (TIM3) counts A/B edges in encoder mode x4 on PC6/PC7. Its TRGO is the
+ *  encoder clock (MMS = 1000, one pulse per counted edge, either direction),
+ *  which ENC_TIME_TIM (TIM4, ITR2 = TIM3 TRGO) captures into CCR1 through TRC.
+ *  Every ENC_Update() therefore sees the 16-bit count, the free running time and
+ *  the time of the most recent edge, without an interrupt per edge.
+ *
+ *  Position: the signed 16-bit count difference since the previous update is
+ *  added to a 32-bit position, correct while fewer than 32768 counts pass per
+ *  update (256 Mcounts/s at the 7.8 kHz HRTIM tick).
+ *
+ *  Speed, M/T method: counts M over a window that starts and ends on an edge,
+ *  divided by the time T between those two edges. A window closes at the first
+ *  edge at least ENC_MIN_WINDOW_TICKS after its start, so at high speed it spans
+ *  many counts in about one window time (count error 0, time error 1 tick), and at
+ *  low speed it spans one count over several updates (exact edge to edge
+ *  interval, so the encoder's own quadrature phase and duty errors show up
+ *  directly). Between edges the magnitude is limited to one count over the time
+ *  since the last edge, so a stopping shaft decays to 0 instead of holding its
+ *  last value; after ENC_STANDSTILL_TICKS without an edge the speed is 0 and the
+ *  next window starts at the next edge. A reversal restarts the window at the
+ *  reversing edge, with speed 0 until the new window closes, so dithering around
+ *  one count reads as 0 rather than as noise.
+ *
+ *  ENC_Update() runs in HRTIM1_TIMC_IRQHandler, the control tick; its result is
+ *  the snapshot for that control cycle. Other contexts read the last one with
+ *  ENC_GetSnapshot() (double buffer, same scheme as the measurement frames).
+ *  The estimator itself, ENC_Process(), has no hardware access and builds on the host.
  */
 
 #ifndef APPLICATION_USER_ENCODERS_H_
 #define APPLICATION_USER_ENCODERS_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef ENC_TIM
+#define ENC_TIM                 TIM3        /* position, encoder mode x4     */
+#endif
+#ifndef ENC_TIME_TIM
+#define ENC_TIME_TIM            TIM4        /* edge timestamps, CH1 on TRC   */
+#endif
+
+#define ENC_COUNTS_PER_REV      4096u       /* 1024 lines x4                 */
+#define ENC_TIME_HZ             10000000u   /* TIM4 tick, APB1 timer clock / 17 */
+#define ENC_INPUT_FILTER        3u          /* fCK_INT, N = 8: ~47 ns glitches */
+
+#define ENC_MIN_WINDOW_TICKS    (ENC_TIME_HZ / 10000u)      /* 100 us          */
+#define ENC_STANDSTILL_TICKS    (ENC_TIME_HZ / 5u)          /* 200 ms, < 0.3 rpm */
+
+/* counts/s Q8 -> rpm Q8 */
+#define ENC_RPM_Q8(cps_q8)      ((int32_t)(((int64_t)(cps_q8) * 60) / (int32_t)ENC_COUNTS_PER_REV))
+
+typedef struct
+{
+    uint32_t seq_u32;               /* updates since ENC_Init()               */
+    int32_t  pos_s32;               /* counts, 32-bit extended                */
+    int32_t  delta_s32;             /* counts since the previous update       */
+    int32_t  speed_cps_q8;          /* counts/s, Q8                           */
+    uint32_t edgeAge_u32;           /* ENC_TIME_HZ ticks since the last edge  */
+    bool     speedValid;            /* from a closed window (false: bound or standstill) */
+} ENC_Snapshot_t;
+
+/* Estimator state, one per encoder */
+typedef struct
+{
+    uint16_t lastCnt_u16;
+    uint16_t lastNow_u16;
+    uint32_t time_u32;              /* extended ENC_TIME_HZ time              */
+    int32_t  pos_s32;
+    uint32_t lastEdge_u32;          /* time of the newest edge                */
+    bool     haveEdge;
+    uint32_t winTime_u32;           /* window start: edge time and position  */
+    int32_t  winPos_s32;
+    bool     winOpen;
+    bool     measValid;
+    int8_t   dir_s8;                /* direction of the last counted edge     */
+    int32_t  measured_cps_q8;       /* last closed window                     */
+    ENC_Snapshot_t snap;
+} ENC_t;
+
+/* One hardware read: counter, time now and time of the last edge */
+typedef struct
+{
+    uint16_t cnt_u16;
+    uint16_t now_u16;
+    uint16_t edge_u16;
+    bool     newEdge;               /* capture flag since the previous read   */
+} ENC_Raw_t;
+
+typedef struct
+{
+    uint32_t updates_u32;
+    uint32_t windows_u32;
+    uint32_t rereads_u32;           /* count changed during the read          */
+    uint32_t lastCycles_u32;
+    uint32_t maxCycles_u32;
+} ENC_Stats_t;
+
+/* TIM3/TIM4 and PC6/PC7 by register (TIM HAL not in this project) */
+void ENC_Init(void);
+
+/* Control tick: read the timers, update and publish; returns this cycle's snapshot */
+const ENC_Snapshot_t *ENC_Update(void);
+
+/* Any context: consistent copy of the last published snapshot, false if none yet */
+bool ENC_GetSnapshot(ENC_Snapshot_t *snap);
+
+const ENC_Stats_t *ENC_GetStats(void);
 
+/* Estimator, no hardware */
+void ENC_Reset(ENC_t *e, const ENC_Raw_t *raw);
+bool ENC_Process(ENC_t *e, const ENC_Raw_t *raw);      /* true when a window closed */
 
 #endif /* APPLICATION_USER_ENCODERS_H_ */
@@ -5,4 +5,274 @@
  *      Author: HEIR
  */
 
+#include "fault_mgr.h"
+#include "main.h"
 
+static FAULT_TripFn_t         s_tripFn = NULL;
+static volatile FAULT_State_t s_state = FAULT_STATE_OK;
+static volatile uint32_t      s_causes = 0u;        /* latched since the last restart          */
+static volatile uint32_t      s_activeMask = 0u;    /* outside the release thresholds right now */
+static uint32_t               s_tripTime_ms = 0u;
+static uint32_t               s_restartTime_ms = 0u;
+static uint8_t                s_retries_u8 = 0u;
+
+/* Thresholds in ADC codes, from MEAS_*ToCode() at init */
+static uint16_t s_ovpCode_u16, s_ovpReleaseCode_u16;
+static uint16_t s_ocpCode_u16, s_ocpReleaseCode_u16;
+static uint16_t s_uvloCode_u16, s_uvloReleaseCode_u16;
+static uint8_t  s_ovpCount_u8, s_ocpCount_u8, s_uvloCount_u8;
+
+/* Log ring: entry (n % LEN) is event n, s_logHead = events written */
+static FAULT_LogEntry_t  s_log[FAULT_LOG_LEN];
+static volatile uint32_t s_logHead = 0u;
+
+static FAULT_Stats_t s_stats;
+
+/* ISR context or interrupts masked */
+static void FAULT_LogAppend(uint32_t cause, uint16_t value_u16, uint32_t now_ms)
+{
+    const uint32_t head = s_logHead;
+    FAULT_LogEntry_t *e = &s_log[head & (FAULT_LOG_LEN - 1u)];
+
+    e->time_ms   = now_ms;
+    e->cause_u8  = (uint8_t)cause;
+    e->retry_u8  = s_retries_u8;
+    e->value_u16 = value_u16;
+    __DMB();
+    s_logHead = head + 1u;
+}
+
+/* ISR context or interrupts masked. Returns true if this call switched the stage off. */
+static bool FAULT_Latch(uint32_t cause, uint16_t value_u16, uint32_t now_ms)
+{
+    const uint32_t newCauses = cause & ~s_causes;
+    bool tripped = false;
+
+    if (s_state == FAULT_STATE_OK)
+    {
+        if (s_tripFn != NULL)
+        {
+            s_tripFn();
+        }
+        s_state       = FAULT_STATE_TRIPPED;
+        s_tripTime_ms = now_ms;
+        s_stats.trips_u32++;
+        tripped = true;
+    }
+    s_causes |= cause;
+    if (newCauses != 0u)
+    {
+        FAULT_LogAppend(newCauses, value_u16, now_ms);
+    }
+    return tripped;
+}
+
+void FAULT_Init(FAULT_TripFn_t tripFn)
+{
+    s_tripFn = NULL;        /* samples are ignored until the thresholds are set */
+    __DMB();
+
+    FAULT_SetThresholds(FAULT_OVP_mV, FAULT_OCP_PIN_mV, FAULT_UVLO_mV);
+
+    s_ovpCount_u8 = s_ocpCount_u8 = s_uvloCount_u8 = 0u;
+    s_state       = FAULT_STATE_OK;
+    s_causes      = 0u;
+    s_activeMask  = 0u;
+    s_retries_u8  = 0u;
+    s_logHead     = 0u;
+    s_stats       = (FAULT_Stats_t){ 0 };
+    __DMB();
+    s_tripFn      = tripFn;
+}
+
+void FAULT_SetThresholds(uint32_t ovp_mV, uint32_t ocpPin_mV, uint32_t uvlo_mV)
+{
+    s_ovpCode_u16         = MEAS_ScaledToCode(MEAS_CH_VOUT, ovp_mV);
+    s_ovpReleaseCode_u16  = MEAS_ScaledToCode(MEAS_CH_VOUT, ovp_mV - (FAULT_OVP_mV - FAULT_OVP_RELEASE_mV));
+    s_ocpCode_u16         = MEAS_PinToCode(MEAS_CH_I_IN_SENSE, ocpPin_mV);
+    s_ocpReleaseCode_u16  = MEAS_PinToCode(MEAS_CH_I_IN_SENSE, ocpPin_mV - (FAULT_OCP_PIN_mV - FAULT_OCP_RELEASE_PIN_mV));
+    s_uvloCode_u16        = MEAS_ScaledToCode(MEAS_CH_VIN, uvlo_mV);
+    s_uvloReleaseCode_u16 = MEAS_ScaledToCode(MEAS_CH_VIN, uvlo_mV + (FAULT_UVLO_RELEASE_mV - FAULT_UVLO_mV));
+}
+
+void FAULT_CheckSample(const uint16_t raw_u16[MEAS_NUM_CH], uint32_t now_ms, uint32_t entryCycles_u32)
+{
+    uint32_t trip = 0u;
+    uint32_t active = s_activeMask;
+    const uint32_t latched = s_causes;
+    uint16_t value_u16 = 0u;
+
+    if (s_tripFn == NULL)
+        return;
+
+    const uint16_t vout = raw_u16[MEAS_CH_VOUT];
+    if (vout > s_ovpCode_u16)
+    {
+        active |= FAULT_CAUSE_OVP;
+        if (s_ovpCount_u8 < FAULT_OVP_SAMPLES) s_ovpCount_u8++;
+        if (s_ovpCount_u8 >= FAULT_OVP_SAMPLES) { trip |= FAULT_CAUSE_OVP; if ((latched & FAULT_CAUSE_OVP) == 0u) value_u16 = vout; }
+    }
+    else
+    {
+        s_ovpCount_u8 = 0u;
+        if (vout < s_ovpReleaseCode_u16) active &= ~FAULT_CAUSE_OVP;
+    }
+
+    const uint16_t iin = raw_u16[MEAS_CH_I_IN_SENSE];
+    if (iin > s_ocpCode_u16)
+    {
+        active |= FAULT_CAUSE_OCP;
+        if (s_ocpCount_u8 < FAULT_OCP_SAMPLES) s_ocpCount_u8++;
+        if (s_ocpCount_u8 >= FAULT_OCP_SAMPLES) { trip |= FAULT_CAUSE_OCP; if ((latched & FAULT_CAUSE_OCP) == 0u) value_u16 = iin; }
+    }
+    else
+    {
+        s_ocpCount_u8 = 0u;
+        if (iin < s_ocpReleaseCode_u16) active &= ~FAULT_CAUSE_OCP;
+    }
+
+    const uint16_t vin = raw_u16[MEAS_CH_VIN];
+    if (vin < s_uvloCode_u16)
+    {
+        active |= FAULT_CAUSE_UVLO;
+        if (s_uvloCount_u8 < FAULT_UVLO_SAMPLES) s_uvloCount_u8++;
+        if (s_uvloCount_u8 >= FAULT_UVLO_SAMPLES) { trip |= FAULT_CAUSE_UVLO; if ((latched & FAULT_CAUSE_UVLO) == 0u) value_u16 = vin; }
+    }
+    else
+    {
+        s_uvloCount_u8 = 0u;
+        if (vin > s_uvloReleaseCode_u16) active &= ~FAULT_CAUSE_UVLO;
+    }
+
+    s_activeMask = active;
+
+    if ((trip != 0u) && FAULT_Latch(trip, value_u16, now_ms))
+    {
+        const uint32_t cycles = DWT->CYCCNT - entryCycles_u32;
+        s_stats.lastReactCycles_u32 = cycles;
+        if (cycles > s_stats.maxReactCycles_u32)
+        {
+            s_stats.maxReactCycles_u32 = cycles;
+        }
+    }
+}
+
+void FAULT_Report(uint32_t cause, uint16_t value_u16, uint32_t now_ms)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    (void)FAULT_Latch(cause, value_u16, now_ms);
+    __set_PRIMASK(primask);
+}
+
+bool FAULT_Task(uint32_t now_ms)
+{
+    bool restart = false;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    switch (s_state)
+    {
+    case FAULT_STATE_OK:
+        if ((s_retries_u8 != 0u) && ((now_ms - s_restartTime_ms) >= FAULT_RETRY_RESET_ms))
+        {
+            s_retries_u8 = 0u;
+        }
+        break;
+
+    case FAULT_STATE_TRIPPED:
+    {
+        /* UVLO is the supply, not the stage: it neither counts nor locks out */
+        const bool counted = (s_causes & ~FAULT_CAUSE_UVLO) != 0u;
+
+        if (counted && (s_retries_u8 >= FAULT_MAX_RETRIES))
+        {
+            s_state = FAULT_STATE_LOCKOUT;
+            FAULT_LogAppend(FAULT_CAUSE_LOCKOUT, 0u, now_ms);
+        }
+        else if (s_activeMask == 0u)
+        {
+            const uint32_t backoff_ms = counted ? (FAULT_BACKOFF_BASE_ms << s_retries_u8) : FAULT_UVLO_RESTART_ms;
+            if ((now_ms - s_tripTime_ms) >= backoff_ms)
+            {
+                if (counted)
+                {
+                    s_retries_u8++;
+                }
+                s_state          = FAULT_STATE_OK;
+                s_causes         = 0u;
+                s_restartTime_ms = now_ms;
+                s_stats.restarts_u32++;
+                restart = true;
+            }
+        }
+        break;
+    }
+
+    case FAULT_STATE_LOCKOUT:
+    default:
+        break;
+    }
+
+    __set_PRIMASK(primask);
+    return restart;
+}
+
+void FAULT_ClearLockout(uint32_t now_ms)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (s_state == FAULT_STATE_LOCKOUT)
+    {
+        /* Back to the first back-off step, FAULT_Task() restarts once released */
+        s_state       = FAULT_STATE_TRIPPED;
+        s_retries_u8  = 0u;
+        s_tripTime_ms = now_ms;
+    }
+    __set_PRIMASK(primask);
+}
+
+FAULT_State_t FAULT_GetState(void)
+{
+    return s_state;
+}
+
+uint32_t FAULT_GetCauses(void)
+{
+    return s_causes;
+}
+
+uint32_t FAULT_GetLogCount(void)
+{
+    return s_logHead;
+}
+
+uint32_t FAULT_ReadLog(FAULT_LogEntry_t *dst, uint32_t n)
+{
+    if (dst == NULL)
+        return 0u;
+    if (n > (FAULT_LOG_LEN - 1u))
+        n = FAULT_LOG_LEN - 1u;
+
+    /* Newest n entries, oldest first; retried if the ISR logged over them meanwhile */
+    for (uint32_t attempt = 0u; attempt < 4u; attempt++)
+    {
+        const uint32_t head = s_logHead;
+        const uint32_t cnt  = (head < n) ? head : n;
+        __DMB();
+        for (uint32_t i = 0u; i < cnt; i++)
+        {
+            dst[i] = s_log[(head - cnt + i) & (FAULT_LOG_LEN - 1u)];
+        }
+        __DMB();
+        if ((s_logHead - head) <= (FAULT_LOG_LEN - 1u - cnt))
+            return cnt;
+    }
+    return 0u;
+}
+
+const FAULT_Stats_t *FAULT_GetStats(void)
+{
+    return &s_stats;
+}
@@ -3,11 +3,104 @@
  *
  *  Created on: Jan 17, 2026
  *      Author: HEIR
+ *
+ *  Power stage protection.
+ *
+ *  FAULT_CheckSample() runs in the ADC1 JEOS interrupt on every injected sequence
+ *  (31.25 kHz) and compares the raw codes against thresholds converted once at
+ *  init, so the path from end of conversion to disabled outputs is a few compares
+ *  and one register write. Its cost is measured with DWT and kept in the stats.
+ *
+ *      OVP  : Vout above FAULT_OVP_mV for FAULT_OVP_SAMPLES sequences
+ *      OCP  : input current sense pin above FAULT_OCP_PIN_mV for FAULT_OCP_SAMPLES
+ *      UVLO : Vin below FAULT_UVLO_mV for FAULT_UVLO_SAMPLES
+ *
+ *  Other sources (HRTIM FLT2, manual) use FAULT_Report(). A trip calls the trip
+ *  callback once and latches the causes with a timestamp in the fault log.
+ *
+ *  FAULT_Task() (main loop) decides the restart: all conditions back inside the
+ *  release thresholds and the back-off elapsed. OVP/OCP/HW/manual trips retry
+ *  with a doubling back-off, after FAULT_MAX_RETRIES the stage stays locked out
+ *  until FAULT_ClearLockout(). UVLO alone is not a stage failure and restarts after
+ *  a fixed delay without counting. A clean run of FAULT_RETRY_RESET_MS forgets
+ *  previous retries.
  */
 
 #ifndef APPLICATION_USER_FAULT_MGR_H_
 #define APPLICATION_USER_FAULT_MGR_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "measurements.h"
+
+/* --- Trip / release thresholds --- */
+#define FAULT_OVP_mV              10000u    /* Vout, boost target is 8 V     */
+#define FAULT_OVP_RELEASE_mV      9000u
+#define FAULT_OCP_PIN_mV          3000u     /* I_IN_SENSE at the ADC pin     */
+#define FAULT_OCP_RELEASE_PIN_mV  2500u
+#define FAULT_UVLO_mV             4000u     /* Vin                           */
+#define FAULT_UVLO_RELEASE_mV     4500u
+
+/* --- Consecutive sequences (32 us each) before a trip --- */
+#define FAULT_OVP_SAMPLES         2u
+#define FAULT_OCP_SAMPLES         1u
+#define FAULT_UVLO_SAMPLES        8u
+
+/* --- Restart policy --- */
+#define FAULT_BACKOFF_BASE_ms     500u      /* doubles with every retry      */
+#define FAULT_MAX_RETRIES         4u
+#define FAULT_RETRY_RESET_ms      10000u
+#define FAULT_UVLO_RESTART_ms     200u
+
+#define FAULT_LOG_LEN             16u       /* power of 2 */
+
+/* Causes, combined as a bit mask */
+#define FAULT_CAUSE_OVP           (1u << 0)
+#define FAULT_CAUSE_OCP           (1u << 1)
+#define FAULT_CAUSE_UVLO          (1u << 2)
+#define FAULT_CAUSE_HW_FLT        (1u << 3)
+#define FAULT_CAUSE_MANUAL        (1u << 4)
+#define FAULT_CAUSE_LOCKOUT       (1u << 7)     /* log only: retries exhausted */
+
+typedef enum
+{
+    FAULT_STATE_OK = 0,
+    FAULT_STATE_TRIPPED,        /* outputs off, waiting for release + back-off */
+    FAULT_STATE_LOCKOUT         /* outputs off until FAULT_ClearLockout()      */
+} FAULT_State_t;
+
+typedef struct
+{
+    uint32_t time_ms;
+    uint8_t  cause_u8;          /* new cause bits of this event      */
+    uint8_t  retry_u8;          /* retries used when it happened     */
+    uint16_t value_u16;         /* ADC code of a newly latched cause (0 if none) */
+} FAULT_LogEntry_t;
+
+typedef struct
+{
+    uint32_t trips_u32;
+    uint32_t restarts_u32;
+    uint32_t lastReactCycles_u32;   /* JEOS ISR entry -> trip callback returned */
+    uint32_t maxReactCycles_u32;
+} FAULT_Stats_t;
+
+/* Disables the power stage; called from interrupt context */
+typedef void (*FAULT_TripFn_t)(void);
+
+void          FAULT_Init(FAULT_TripFn_t tripFn);
+/* New trip levels, release levels keep the default hysteresis. Call with the
+ * ADC interrupt unable to preempt (control ISR or masked). */
+void          FAULT_SetThresholds(uint32_t ovp_mV, uint32_t ocpPin_mV, uint32_t uvlo_mV);
+void          FAULT_CheckSample(const uint16_t raw_u16[MEAS_NUM_CH], uint32_t now_ms, uint32_t entryCycles_u32);
+void          FAULT_Report(uint32_t cause, uint16_t value_u16, uint32_t now_ms);
+bool          FAULT_Task(uint32_t now_ms);
+void          FAULT_ClearLockout(uint32_t now_ms);
 
+FAULT_State_t FAULT_GetState(void);
+uint32_t      FAULT_GetCauses(void);
+uint32_t      FAULT_GetLogCount(void);
+uint32_t      FAULT_ReadLog(FAULT_LogEntry_t *dst, uint32_t n);
+const FAULT_Stats_t *FAULT_GetStats(void);
 
 #endif /* APPLICATION_USER_FAULT_MGR_H_ */
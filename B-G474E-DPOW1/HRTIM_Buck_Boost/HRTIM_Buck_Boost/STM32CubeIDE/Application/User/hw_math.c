@@ -0,0 +1,234 @@
+/*
+ * hw_math.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ */
+
+#include "hw_math.h"
+#include <string.h>
+#include <stdatomic.h>
+
+#ifndef HMATH_FORCE_SW
+#include "main.h"
+#endif
+
+#if !defined(HMATH_FORCE_SW) && defined(CORDIC)
+#define HMATH_HW                1
+#else
+#define HMATH_HW                0
+#endif
+
+static HMATH_Stats_t s_stats;
+
+/* ---------------------------------------------------------------------------
+ * Software path
+ * ------------------------------------------------------------------------- */
+
+uint32_t HMATH_SwSqrt32(uint32_t x)
+{
+    uint32_t r   = 0u;
+    uint32_t rem = x;
+    uint32_t bit = 1uL << 30;
+
+    while (bit > rem)
+        bit >>= 2;
+    while (bit != 0u)
+    {
+        if (rem >= r + bit)
+        {
+            rem -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+        {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    /* r = floor(sqrt(x)), rem = x - r^2: sqrt(x) >= r + 0.5 once x > r^2 + r */
+    return (rem > r) ? (r + 1u) : r;
+}
+
+/* c = round(sqrt(x)) iff c^2 - c < x <= c^2 + c */
+uint32_t HMATH_SqrtRound(uint32_t x, uint32_t c)
+{
+    uint64_t r = c;
+
+    while (((r * r) + r) < x)
+        r++;
+    while ((r > 0u) && (((r * r) - r) >= x))
+        r--;
+    return (uint32_t)r;
+}
+
+/* ---------------------------------------------------------------------------
+ * Accelerators
+ * ------------------------------------------------------------------------- */
+
+#if HMATH_HW
+
+/* CORDIC square root, 32-bit argument and result */
+#define HMATH_CORDIC_SQRT       (9u << CORDIC_CSR_FUNC_Pos)
+#define HMATH_CORDIC_PREC_Q31   (6u << CORDIC_CSR_PRECISION_Pos)
+
+static atomic_flag s_cordicBusy = ATOMIC_FLAG_INIT;
+
+static bool HMATH_Claim(atomic_flag *unit)
+{
+    return !atomic_flag_test_and_set_explicit(unit, memory_order_acquire);
+}
+
+static void HMATH_Release(atomic_flag *unit)
+{
+    atomic_flag_clear_explicit(unit, memory_order_release);
+}
+
+void HMATH_Init(void)
+{
+    __HAL_RCC_CORDIC_CLK_ENABLE();
+
+    /* Cycle counter for HMATH_Bench() */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+bool HMATH_HasHw(void)
+{
+    return true;
+}
+
+/* Caller owns the CORDIC. Zero overhead mode: reading RDATA waits for the result. */
+static uint32_t HMATH_HwSqrt32(uint32_t x)
+{
+    if (x == 0u)
+        return 0u;
+
+    /* Even normalisation to v = x << s in [2^30, 2^32), q = v / 2^32 in [0.25, 1):
+     * scale 0 takes q < 0.75, scale 1 takes q / 2 and returns sqrt(q) / 2 */
+    const uint32_t s = (uint32_t)__CLZ(x) & ~1u;
+    const uint32_t v = x << s;
+    uint32_t shift = 15u + (s >> 1);
+    uint32_t csr   = HMATH_CORDIC_SQRT | HMATH_CORDIC_PREC_Q31;
+    uint32_t arg   = v >> 1;
+
+    if (v >= 0xC0000000u)
+    {
+        csr  |= 1u << CORDIC_CSR_SCALE_Pos;
+        arg   = v >> 2;
+        shift = shift - 1u;
+    }
+    CORDIC->CSR   = csr;
+    CORDIC->WDATA = arg;
+    const uint32_t res = CORDIC->RDATA;
+
+    /* The estimate is within an LSB or two; the correction makes it exact */
+    return HMATH_SqrtRound(x, (uint32_t)((res + (1uL << (shift - 1u))) >> shift));
+}
+
+uint32_t HMATH_Sqrt32(uint32_t x)
+{
+    if (!HMATH_Claim(&s_cordicBusy))
+    {
+        s_stats.cordicBusy_u32++;
+        return HMATH_SwSqrt32(x);
+    }
+    const uint32_t r = HMATH_HwSqrt32(x);
+    HMATH_Release(&s_cordicBusy);
+    return r;
+}
+
+/* --- Benchmark: same inputs through both paths --- */
+
+#define HMATH_BENCH_N           256u
+
+static uint32_t s_benchSeed_u32;
+
+static uint32_t HMATH_BenchRand(void)
+{
+    s_benchSeed_u32 = (s_benchSeed_u32 * 1664525u) + 1013904223u;
+    return s_benchSeed_u32;
+}
+
+static void HMATH_BenchDiff(HMATH_BenchItem_t *r, uint32_t a, uint32_t b)
+{
+    const uint32_t d = (a > b) ? (a - b) : (b - a);
+    if (d != 0u)
+    {
+        r->mismatches_u32++;
+        if (d > r->maxDiff_u32)
+            r->maxDiff_u32 = d;
+    }
+}
+
+void HMATH_Bench(HMATH_BenchItem_t res[HMATH_BENCH_NUM])
+{
+    static uint32_t u[HMATH_BENCH_N], uHw[HMATH_BENCH_N], uSw[HMATH_BENCH_N];
+    uint32_t t0, t1, t2;
+
+    memset(res, 0, HMATH_BENCH_NUM * sizeof(HMATH_BenchItem_t));
+    s_benchSeed_u32 = 12345u;
+    if (!HMATH_Claim(&s_cordicBusy))
+        return;
+
+    /* sqrt over the whole range, both ends included */
+    for (uint32_t i = 0u; i < HMATH_BENCH_N; i++)
+        u[i] = HMATH_BenchRand() >> (i & 31u);
+    u[0] = 0u;
+    u[1] = UINT32_MAX;
+    t0 = DWT->CYCCNT;
+    for (uint32_t i = 0u; i < HMATH_BENCH_N; i++)
+        uHw[i] = HMATH_HwSqrt32(u[i]);
+    t1 = DWT->CYCCNT;
+    for (uint32_t i = 0u; i < HMATH_BENCH_N; i++)
+        uSw[i] = HMATH_SwSqrt32(u[i]);
+    t2 = DWT->CYCCNT;
+    res[HMATH_BENCH_SQRT].hwCycles_u32 = (t1 - t0) / HMATH_BENCH_N;
+    res[HMATH_BENCH_SQRT].swCycles_u32 = (t2 - t1) / HMATH_BENCH_N;
+    for (uint32_t i = 0u; i < HMATH_BENCH_N; i++)
+        HMATH_BenchDiff(&res[HMATH_BENCH_SQRT], uHw[i], uSw[i]);
+
+    HMATH_Release(&s_cordicBusy);
+}
+
+#else /* software only */
+
+void HMATH_Init(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+bool HMATH_HasHw(void)
+{
+    return false;
+}
+
+uint32_t HMATH_Sqrt32(uint32_t x)
+{
+    return HMATH_SwSqrt32(x);
+}
+
+/* Nothing to compare against */
+void HMATH_Bench(HMATH_BenchItem_t res[HMATH_BENCH_NUM])
+{
+    memset(res, 0, HMATH_BENCH_NUM * sizeof(HMATH_BenchItem_t));
+}
+
+#endif /* HMATH_HW */
+
+static const char *const s_benchNames[HMATH_BENCH_NUM] = {
+    [HMATH_BENCH_SQRT] = "sqrt",
+};
+
+const char *HMATH_BenchName(HMATH_BenchId_t id)
+{
+    return (id < HMATH_BENCH_NUM) ? s_benchNames[id] : "?";
+}
+
+const HMATH_Stats_t *HMATH_GetStats(void)
+{
+    return &s_stats;
+}
@@ -0,0 +1,83 @@
+/*
+ * hw_math.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Rounded integer square root on the G4 CORDIC, with a software path that gives
+ *  identical results. Its one user is the current telemetry (measurements.c), which
+ *  takes it of the integer mean squares of each ADC2 block; the control loops do not
+ *  go through here (see below).
+ *
+ *  HMATH_Sqrt32() uses the CORDIC when this part has it and nobody else is using
+ *  it, otherwise HMATH_SwSqrt32(). The unit is claimed with a test-and-set, not by
+ *  masking interrupts: an ISR that preempts a main loop call simply computes its
+ *  own in software. Build with HMATH_FORCE_SW (host, parts without CORDIC) and only
+ *  the software path exists.
+ *
+ *  Both paths are bit identical: the CORDIC estimate goes through HMATH_SqrtRound(),
+ *  which corrects any estimate to the exact rounded root, the value the software
+ *  computes. HMATH_Bench() runs both on the target over the same inputs, counts
+ *  every difference and times them with the DWT cycle counter.
+ *
+ *  What stays out of this layer, and why:
+ *      compensators   : COMP_Step() clamps the output to [uMin, uMax] and feeds that
+ *                       back (anti-windup), which the FMAC (clipping at +-1) cannot.
+ *      motor current  : one sample per 128 us tick through a one-pole low-pass
+ *                       (motor_control.c): loading the FMAC takes longer than the
+ *                       filter, and its 16 bit feedback would drop the 3 fraction
+ *                       bits the filter keeps.
+ *      encoder speed  : counts over time is a division, which neither unit does.
+ *  The application has no angle to compute (brushed DC motor, no commutation) and
+ *  no block filter, so the layer has no sine/cosine, atan2 or FMAC filter either.
+ */
+
+#ifndef APPLICATION_USER_HW_MATH_H_
+#define APPLICATION_USER_HW_MATH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+    uint32_t hwCycles_u32;          /* per call                                */
+    uint32_t swCycles_u32;
+    uint32_t mismatches_u32;        /* results that differ between the paths   */
+    uint32_t maxDiff_u32;           /* largest difference, LSB                 */
+} HMATH_BenchItem_t;
+
+typedef enum
+{
+    HMATH_BENCH_SQRT = 0,
+    HMATH_BENCH_NUM
+} HMATH_BenchId_t;
+
+typedef struct
+{
+    uint32_t cordicBusy_u32;        /* calls done in software, CORDIC in use   */
+} HMATH_Stats_t;
+
+/* Clock and cycle counter; no-op in a software build */
+void     HMATH_Init(void);
+
+/* True when HMATH_Sqrt32() can use the CORDIC */
+bool     HMATH_HasHw(void);
+
+/* round(sqrt(x)), 0..65536 */
+uint32_t HMATH_Sqrt32(uint32_t x);
+
+/* Software path, no hardware access: same results as above */
+uint32_t HMATH_SwSqrt32(uint32_t x);
+
+/* round(sqrt(x)) from any estimate c, in |c - round(sqrt(x))| + 1 steps; the exact
+ * rounding both paths end in */
+uint32_t HMATH_SqrtRound(uint32_t x, uint32_t c);
+
+/* Target: both paths over the same inputs, DWT cycles and differences. Call before
+ * anything else uses the CORDIC (it claims it like any caller). */
+void     HMATH_Bench(HMATH_BenchItem_t res[HMATH_BENCH_NUM]);
+const char *HMATH_BenchName(HMATH_BenchId_t id);
+
+const HMATH_Stats_t *HMATH_GetStats(void);
+
+#endif /* APPLICATION_USER_HW_MATH_H_ */
@@ -3,10 +3,13 @@
  */
 #include "measurements.h"
 #include <stdio.h>
+#include <stddef.h>
 #include "main.h"
-#include <stdio.h>
+#include "stm32g4xx_ll_adc.h"
+#include "lockfree.h"
+#include "hw_math.h"
 
-uint16_t adc2_buf[ADC2_BUF_SIZE];
+uint16_t adc2_buf[ADC2_BUF_SIZE] __attribute__((aligned(4)));     /* read as pairs */
 
 /* --- ADC reference and resolution --- */
 #define MEAS_VDDA_mV           3300u      /* ADC reference in mV           */
@@ -21,55 +24,503 @@ uint16_t adc2_buf[ADC2_BUF_SIZE];
 #define MEAS_VOUT_SCALE_NUM    503u
 #define MEAS_VOUT_SCALE_DEN    100u
 
+/* --- Q16 gains, rounded at compile time --- */
+#define MEAS_Q16(num, den)     ((uint32_t)((((uint64_t)(num) << 16) + ((uint64_t)(den) / 2u)) / (uint64_t)(den)))
+#define MEAS_GAIN_PIN_Q16      MEAS_Q16(MEAS_VDDA_mV, MEAS_ADC_FS_COUNTS)
+#define MEAS_GAIN_VIN_Q16      MEAS_Q16((uint64_t)MEAS_VDDA_mV * MEAS_VIN_SCALE_NUM, (uint64_t)MEAS_ADC_FS_COUNTS * MEAS_VIN_SCALE_DEN)
+#define MEAS_GAIN_VOUT_Q16     MEAS_Q16((uint64_t)MEAS_VDDA_mV * MEAS_VOUT_SCALE_NUM, (uint64_t)MEAS_ADC_FS_COUNTS * MEAS_VOUT_SCALE_DEN)
+
+/* Divider gain per rank; the current sense channels keep the Vin factor as before */
+static const uint32_t s_nominalScaled_q16[MEAS_NUM_CH] = {
+    [MEAS_CH_I_IN_SENSE] = MEAS_GAIN_VIN_Q16,
+    [MEAS_CH_VIN]        = MEAS_GAIN_VIN_Q16,
+    [MEAS_CH_I_IN_AVG]   = MEAS_GAIN_VIN_Q16,
+    [MEAS_CH_VOUT]       = MEAS_GAIN_VOUT_Q16,
+};
+
+/* Calibrated gains/offsets used by MEAS_Convert(), written only by MEAS_CalibApply() */
+static uint32_t s_gainPin_q16[MEAS_NUM_CH];
+static uint32_t s_gainScaled_q16[MEAS_NUM_CH];
+static int32_t  s_offset_s32[MEAS_NUM_CH];
+
 static ADC_HandleTypeDef *s_hadc = NULL;
 
+/* --- Published frame: double buffered seqlock, readable from any context --- */
+static Meas_Frame_t      s_frames[2];
+static LF_Snap_t         s_frameSnap = LF_SNAP_INIT(s_frames, sizeof(Meas_Frame_t));
+
+/* --- Window statistics, owned by the ISR --- */
+static uint32_t s_winSum_u32[MEAS_NUM_CH];
+static uint16_t s_winMin_u16[MEAS_NUM_CH];
+static uint16_t s_winMax_u16[MEAS_NUM_CH];
+static uint32_t s_winCount_u32 = 0u;
+static uint32_t s_windows_u32 = 0u;
+static uint16_t s_lastMin_u16[MEAS_NUM_CH];
+static uint16_t s_lastMax_u16[MEAS_NUM_CH];
+static uint16_t s_lastAvg_u16[MEAS_NUM_CH];
+
+/* --- Decimated history: entry (n % LEN) is window n, s_histHead = windows written --- */
+static uint16_t          s_history_u16[MEAS_NUM_CH][MEAS_HISTORY_LEN];
+static volatile uint32_t s_histHead = 0u;
+
+static Meas_Stats_t s_stats;
+
+static void MEAS_WindowReset(void)
+{
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        s_winSum_u32[ch] = 0u;
+        s_winMin_u16[ch] = 0xFFFFu;
+        s_winMax_u16[ch] = 0u;
+    }
+    s_winCount_u32 = 0u;
+}
+
 void MEAS_Init(ADC_HandleTypeDef *hadc)
 {
     s_hadc = hadc;
+    MEAS_WindowReset();
+    MEAS_CalibLoad();
+
+    if ((s_hadc != NULL) && (s_hadc->Instance == ADC1))
+    {
+        /* Below the HRTIM control ISR (priority 0): control may preempt the capture */
+        HAL_NVIC_SetPriority(ADC1_2_IRQn, 1, 0);
+        HAL_NVIC_EnableIRQ(ADC1_2_IRQn);
+        LL_ADC_ClearFlag_JEOS(ADC1);
+        LL_ADC_EnableIT_JEOS(ADC1);
+    }
+}
+
+bool MEAS_InjectedIRQHandler(uint16_t raw_u16[MEAS_NUM_CH])
+{
+    if (!LL_ADC_IsActiveFlag_JEOS(ADC1))
+        return false;
+    LL_ADC_ClearFlag_JEOS(ADC1);
+
+    raw_u16[MEAS_CH_I_IN_SENSE] = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_1);
+    raw_u16[MEAS_CH_VIN]        = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_2);
+    raw_u16[MEAS_CH_I_IN_AVG]   = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_3);
+    raw_u16[MEAS_CH_VOUT]       = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_4);
+    MEAS_Capture(raw_u16);
+    return true;
+}
+
+void MEAS_Capture(const uint16_t raw_u16[MEAS_NUM_CH])
+{
+    /* Window statistics */
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        const uint16_t x = raw_u16[ch];
+        s_winSum_u32[ch] += x;
+        if (x < s_winMin_u16[ch]) s_winMin_u16[ch] = x;
+        if (x > s_winMax_u16[ch]) s_winMax_u16[ch] = x;
+    }
+
+    if (++s_winCount_u32 == MEAS_DECIM)
+    {
+        const uint32_t head = s_histHead;
+        for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+        {
+            s_lastMin_u16[ch] = s_winMin_u16[ch];
+            s_lastMax_u16[ch] = s_winMax_u16[ch];
+            s_lastAvg_u16[ch] = (uint16_t)((s_winSum_u32[ch] + (MEAS_DECIM / 2u)) >> MEAS_DECIM_SHIFT);
+            s_history_u16[ch][head & (MEAS_HISTORY_LEN - 1u)] = s_lastAvg_u16[ch];
+        }
+        __DMB();
+        s_histHead = head + 1u;
+        s_windows_u32++;
+        MEAS_WindowReset();
+    }
+
+    /* Fill the slot nobody reads, then make it current */
+    Meas_Frame_t *f = LF_SnapWriteSlot(&s_frameSnap);
+    f->seq_u32    = LF_SnapCount(&s_frameSnap) + 1u;
+    f->window_u32 = s_windows_u32;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        f->raw_u16[ch] = raw_u16[ch];
+        f->min_u16[ch] = s_lastMin_u16[ch];
+        f->max_u16[ch] = s_lastMax_u16[ch];
+        f->avg_u16[ch] = s_lastAvg_u16[ch];
+    }
+    (void)LF_SnapPublish(&s_frameSnap);
+    s_stats.sequences_u32++;
+}
+
+bool MEAS_GetFrame(Meas_Frame_t *frame)
+{
+    if (LF_SnapCount(&s_frameSnap) == 0u)
+        return false;
+    if (LF_SnapRead(&s_frameSnap, frame, MEAS_READ_RETRIES, &s_stats.retries_u32))
+        return true;
+    s_stats.readFails_u32++;
+    return false;
+}
+
+uint32_t MEAS_GetHistory(Meas_Channel_t ch, uint16_t *dst_u16, uint32_t n)
+{
+    if ((ch >= MEAS_NUM_CH) || (dst_u16 == NULL))
+        return 0u;
+    if (n > (MEAS_HISTORY_LEN - 1u))
+        n = MEAS_HISTORY_LEN - 1u;     /* entry at head may be mid-write by a preempted ISR */
+
+    for (uint32_t attempt = 0u; attempt < MEAS_READ_RETRIES; attempt++)
+    {
+        const uint32_t head = s_histHead;
+        const uint32_t cnt  = (head < n) ? head : n;
+        __DMB();
+        for (uint32_t i = 0u; i < cnt; i++)
+        {
+            dst_u16[i] = s_history_u16[ch][(head - cnt + i) & (MEAS_HISTORY_LEN - 1u)];
+        }
+        __DMB();
+        /* The oldest copied entry is overwritten by window (head - cnt + LEN) */
+        if ((s_histHead - head) <= (MEAS_HISTORY_LEN - 1u - cnt))
+            return cnt;
+        s_stats.retries_u32++;
+    }
+    s_stats.readFails_u32++;
+    return 0u;
 }
 
-void MEAS_ReadVoltages(Meas_Voltages_ADC1_t *adc1_meas)
+const Meas_Stats_t *MEAS_GetStats(void)
 {
-    uint32_t tmp;
+    return &s_stats;
+}
 
-    if (s_hadc == NULL || adc1_meas == NULL)
+uint32_t MEAS_CalibChecksum(const Meas_Calib_t *cal)
+{
+    const uint32_t *w = (const uint32_t *)cal;
+    uint32_t sum = 0u;
+
+    for (uint32_t i = 0u; i < (offsetof(Meas_Calib_t, checksum_u32) / sizeof(uint32_t)); i++)
+    {
+        sum += w[i];
+    }
+    return ~sum;
+}
+
+bool MEAS_CalibApply(const Meas_Calib_t *cal)
+{
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        if ((cal->offset_s16[ch] > MEAS_CALIB_OFFSET_MAX) || (cal->offset_s16[ch] < -MEAS_CALIB_OFFSET_MAX) ||
+            (cal->gain_u16[ch] == 0u))
+            return false;
+    }
+
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        s_offset_s32[ch]     = cal->offset_s16[ch];
+        s_gainPin_q16[ch]    = (uint32_t)(((uint64_t)MEAS_GAIN_PIN_Q16 * cal->gain_u16[ch] + 0x4000u) >> 15);
+        s_gainScaled_q16[ch] = (uint32_t)(((uint64_t)s_nominalScaled_q16[ch] * cal->gain_u16[ch] + 0x4000u) >> 15);
+    }
+    return true;
+}
+
+void MEAS_CalibLoad(void)
+{
+    const Meas_Calib_t *flashCal = (const Meas_Calib_t *)MEAS_CALIB_FLASH_ADDR;
+
+    if ((flashCal->magic_u32 == MEAS_CALIB_MAGIC) &&
+        (flashCal->checksum_u32 == MEAS_CalibChecksum(flashCal)) &&
+        MEAS_CalibApply(flashCal))
+    {
+        printf("MEAS: calibration loaded from flash\r\n");
         return;
+    }
+
+    Meas_Calib_t nominal = { .magic_u32 = MEAS_CALIB_MAGIC };
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        nominal.gain_u16[ch] = MEAS_CALIB_GAIN_ONE;
+    }
+    (void)MEAS_CalibApply(&nominal);
+    printf("MEAS: no valid calibration, using nominal gains\r\n");
+}
 
-    /* ----- BUCKBOOST_I_IN_SENSE on injected rank 1 ----- */
-    adc1_meas->BUCKBOOST_I_IN_SENSE_RAW = HAL_ADCEx_InjectedGetValue(s_hadc, ADC_INJECTED_RANK_1);
-    adc1_meas->BUCKBOOST_I_IN_SENSE_mV = (adc1_meas->BUCKBOOST_I_IN_SENSE_RAW * MEAS_VDDA_mV) / MEAS_ADC_FS_COUNTS;
-    adc1_meas->BUCKBOOST_I_IN_SENSE_SCALED = (adc1_meas->BUCKBOOST_I_IN_SENSE_mV * MEAS_VIN_SCALE_NUM) / MEAS_VIN_SCALE_DEN;
+void MEAS_Convert(const uint16_t raw_u16[MEAS_NUM_CH], Meas_Values_t *v)
+{
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        int32_t x = (int32_t)raw_u16[ch] - s_offset_s32[ch];
+        if (x < 0)
+            x = 0;
+        /* (4095 + 256) * 2 * gain fits in 32 bit for every channel */
+        v->raw_u16[ch]       = raw_u16[ch];
+        v->pin_mV_u16[ch]    = (uint16_t)(((uint32_t)x * s_gainPin_q16[ch] + 0x8000u) >> 16);
+        v->scaled_mV_u16[ch] = (uint16_t)(((uint32_t)x * s_gainScaled_q16[ch] + 0x8000u) >> 16);
+    }
+}
 
-    adc1_meas->BUCKBOOST_VIN_RAW = HAL_ADCEx_InjectedGetValue(s_hadc, ADC_INJECTED_RANK_2);
-    adc1_meas->BUCKBOOST_VIN_mV = (adc1_meas->BUCKBOOST_VIN_RAW * MEAS_VDDA_mV) / MEAS_ADC_FS_COUNTS;
-    adc1_meas->BUCKBOOST_VIN_SCALED = (adc1_meas->BUCKBOOST_VIN_mV * MEAS_VIN_SCALE_NUM) / MEAS_VIN_SCALE_DEN;
+static uint16_t MEAS_ToCode(Meas_Channel_t ch, uint32_t mV, uint32_t gain_q16)
+{
+    if ((ch >= MEAS_NUM_CH) || (gain_q16 == 0u))
+        return 0u;
 
-    adc1_meas->BUCKBOOST_I_IN_AVG_RAW = HAL_ADCEx_InjectedGetValue(s_hadc, ADC_INJECTED_RANK_3);
-    adc1_meas->BUCKBOOST_I_IN_AVG_mV = (adc1_meas->BUCKBOOST_I_IN_AVG_RAW * MEAS_VDDA_mV) / MEAS_ADC_FS_COUNTS;
-    adc1_meas->BUCKBOOST_I_IN_AVG_SCALED = (adc1_meas->BUCKBOOST_I_IN_AVG_mV * MEAS_VIN_SCALE_NUM) / MEAS_VIN_SCALE_DEN;
+    int32_t code = (int32_t)((((uint64_t)mV << 16) + (gain_q16 / 2u)) / gain_q16) + s_offset_s32[ch];
+    if (code < 0)
+        code = 0;
+    if (code > (int32_t)MEAS_ADC_FS_COUNTS)
+        code = (int32_t)MEAS_ADC_FS_COUNTS;
+    return (uint16_t)code;
+}
 
-    adc1_meas->BUCKBOOST_VOUT_RAW = HAL_ADCEx_InjectedGetValue(s_hadc, ADC_INJECTED_RANK_4);
-    adc1_meas->BUCKBOOST_VOUT_mV = (adc1_meas->BUCKBOOST_VOUT_RAW * MEAS_VDDA_mV) / MEAS_ADC_FS_COUNTS;
-    adc1_meas->BUCKBOOST_VOUT_SCALED = (adc1_meas->BUCKBOOST_VOUT_mV * MEAS_VOUT_SCALE_NUM) / MEAS_VOUT_SCALE_DEN;
+uint16_t MEAS_PinToCode(Meas_Channel_t ch, uint32_t pin_mV)
+{
+    return MEAS_ToCode(ch, pin_mV, (ch < MEAS_NUM_CH) ? s_gainPin_q16[ch] : 0u);
+}
 
+uint16_t MEAS_ScaledToCode(Meas_Channel_t ch, uint32_t scaled_mV)
+{
+    return MEAS_ToCode(ch, scaled_mV, (ch < MEAS_NUM_CH) ? s_gainScaled_q16[ch] : 0u);
 }
 
+uint32_t MEAS_BenchConvert(void)
+{
+    const uint16_t raw_u16[MEAS_NUM_CH] = { 1234u, 2345u, 3456u, 4095u };
+    Meas_Values_t v;
+    const uint32_t rounds = 64u;
+
+    const uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0u; i < rounds; i++)
+    {
+        MEAS_Convert(raw_u16, &v);
+        __asm volatile ("" : : "r" (&v) : "memory");     /* keep the stores */
+    }
+    return (DWT->CYCCNT - start) / rounds;
+}
+
+void MEAS_ReadVoltages(Meas_Values_t *v)
+{
+    Meas_Frame_t frame;
+
+    if (v == NULL || !MEAS_GetFrame(&frame))
+        return;
+
+    MEAS_Convert(frame.avg_u16, v);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * ADC2 input current path
+ * ------------------------------------------------------------------------- */
+
+static ADC_HandleTypeDef s_hadc2;
+static DMA_HandleTypeDef s_hdmaAdc2;
+
+/* Block results: triple buffer, the DMA ISR never waits and the main loop never retries */
+static Meas_CurrentBlock_t   s_curBlocks[3];
+static LF_Triple_t           s_curTriple = LF_TRIPLE_INIT(s_curBlocks, sizeof(Meas_CurrentBlock_t));
+static uint32_t              s_curSeq_u32 = 0u;         /* blocks published, ISR only */
+static Meas_CurrentStats_t   s_curStats;
+
+bool MEAS_CurrentStart(void)
+{
+    ADC_ChannelConfTypeDef sConfig = {0};
+
+    /* ADC12 clock and PA0 analog mode are already set up by the ADC1 MSP */
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    s_hdmaAdc2.Instance                 = DMA1_Channel1;
+    s_hdmaAdc2.Init.Request             = DMA_REQUEST_ADC2;
+    s_hdmaAdc2.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    s_hdmaAdc2.Init.PeriphInc           = DMA_PINC_DISABLE;
+    s_hdmaAdc2.Init.MemInc              = DMA_MINC_ENABLE;
+    s_hdmaAdc2.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    s_hdmaAdc2.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    s_hdmaAdc2.Init.Mode                = DMA_CIRCULAR;
+    s_hdmaAdc2.Init.Priority            = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&s_hdmaAdc2) != HAL_OK)
+        return false;
+
+    s_hadc2.Instance                   = ADC2;
+    s_hadc2.Init.ClockPrescaler        = ADC_CLOCK_SYNC_PCLK_DIV4;
+    s_hadc2.Init.Resolution            = ADC_RESOLUTION_12B;
+    s_hadc2.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    s_hadc2.Init.GainCompensation      = 0;
+    s_hadc2.Init.ScanConvMode          = ADC_SCAN_DISABLE;
+    s_hadc2.Init.EOCSelection          = ADC_EOC_SINGLE_CONV;
+    s_hadc2.Init.LowPowerAutoWait      = DISABLE;
+    s_hadc2.Init.ContinuousConvMode    = ENABLE;
+    s_hadc2.Init.NbrOfConversion       = 1;
+    s_hadc2.Init.DiscontinuousConvMode = DISABLE;
+    s_hadc2.Init.ExternalTrigConv      = ADC_SOFTWARE_START;
+    s_hadc2.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    s_hadc2.Init.DMAContinuousRequests = ENABLE;
+    s_hadc2.Init.Overrun               = ADC_OVR_DATA_OVERWRITTEN;
+    s_hadc2.Init.OversamplingMode      = DISABLE;
+    if (HAL_ADC_Init(&s_hadc2) != HAL_OK)
+        return false;
+    __HAL_LINKDMA(&s_hadc2, DMA_Handle, s_hdmaAdc2);
+
+    sConfig.Channel      = ADC_CHANNEL_1;
+    sConfig.Rank         = ADC_REGULAR_RANK_1;
+    sConfig.SamplingTime = ADC_SAMPLETIME_47CYCLES_5;
+    sConfig.SingleDiff   = ADC_SINGLE_ENDED;
+    sConfig.OffsetNumber = ADC_OFFSET_NONE;
+    sConfig.Offset       = 0;
+    if (HAL_ADC_ConfigChannel(&s_hadc2, &sConfig) != HAL_OK)
+        return false;
+
+    if (HAL_ADCEx_Calibration_Start(&s_hadc2, ADC_SINGLE_ENDED) != HAL_OK)
+        return false;
+
+    /* Below the JEOS capture: a half buffer lasts 0.72 ms */
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+    return HAL_ADC_Start_DMA(&s_hadc2, (uint32_t *)adc2_buf, ADC2_BUF_SIZE) == HAL_OK;
+}
+
+void MEAS_CurrentDmaIRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&s_hdmaAdc2);
+}
+
+void MEAS_CurrentAdcIRQHandler(void)
+{
+    /* HAL_ADC_Start_DMA enables OVR; data is overwritten anyway, only count it */
+    if (LL_ADC_IsActiveFlag_OVR(ADC2))
+    {
+        LL_ADC_ClearFlag_OVR(ADC2);
+        s_curStats.overruns_u32++;
+    }
+}
+
+void MEAS_ProcessCurrentBlock(const uint16_t *samples_u16, uint32_t n)
+{
+    const uint32_t start = DWT->CYCCNT;
+    const uint32_t seq = ++s_curSeq_u32;
+    Meas_CurrentBlock_t *blk = LF_TripleWriteBuf(&s_curTriple);
+
+    uint32_t sum = 0u;
+    uint64_t sumSq = 0u;
+    uint32_t tracePoints = n / MEAS_I_DECIM;
+    if (tracePoints > MEAS_I_TRACE_LEN)
+        tracePoints = MEAS_I_TRACE_LEN;
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    /* Two samples per word: SMLAD sums the halves, SMLALD the squares,
+     * USUB16 + SEL keep a per-lane max / min */
+    const uint32_t *p = (const uint32_t *)samples_u16;
+    uint32_t vmax = 0u;
+    uint32_t vmin = 0xFFFFFFFFu;
+
+    for (uint32_t t = 0u; t < tracePoints; t++)
+    {
+        uint32_t part = 0u;
+        for (uint32_t k = 0u; k < (MEAS_I_DECIM / 2u); k++)
+        {
+            const uint32_t v = *p++;
+            part  = __SMLAD(v, 0x00010001u, part);
+            sumSq = __SMLALD(v, v, sumSq);
+            (void)__USUB16(v, vmax);
+            vmax  = __SEL(v, vmax);
+            (void)__USUB16(vmin, v);
+            vmin  = __SEL(v, vmin);
+        }
+        blk->trace_u16[t] = (uint16_t)((part + (MEAS_I_DECIM / 2u)) / MEAS_I_DECIM);
+        sum += part;
+    }
+    const uint16_t maxLo = (uint16_t)vmax, maxHi = (uint16_t)(vmax >> 16);
+    const uint16_t minLo = (uint16_t)vmin, minHi = (uint16_t)(vmin >> 16);
+    blk->max_u16 = (maxLo > maxHi) ? maxLo : maxHi;
+    blk->min_u16 = (minLo < minHi) ? minLo : minHi;
+#else
+    uint16_t vmax = 0u;
+    uint16_t vmin = 0xFFFFu;
+
+    for (uint32_t t = 0u; t < tracePoints; t++)
+    {
+        uint32_t part = 0u;
+        for (uint32_t k = 0u; k < MEAS_I_DECIM; k++)
+        {
+            const uint16_t v = *samples_u16++;
+            part  += v;
+            sumSq += (uint32_t)v * v;
+            if (v > vmax) vmax = v;
+            if (v < vmin) vmin = v;
+        }
+        blk->trace_u16[t] = (uint16_t)((part + (MEAS_I_DECIM / 2u)) / MEAS_I_DECIM);
+        sum += part;
+    }
+    blk->max_u16 = vmax;
+    blk->min_u16 = vmin;
+#endif
+
+    const uint32_t used = tracePoints * MEAS_I_DECIM;
+    if (used > 0u)
+    {
+        /* Variance as (n * sumSq - sum^2) / n^2 in 64-bit integers: no cancellation
+         * when a small ripple sits on a large DC level */
+        const uint64_t acNum = ((uint64_t)used * sumSq) - ((uint64_t)sum * sum);
+        const uint64_t n2    = (uint64_t)used * used;
+        blk->mean_u16  = (uint16_t)((sum + (used / 2u)) / used);
+        /* Rounded mean squares (< 2^32 for 16-bit samples), then rounded integer roots:
+         * CORDIC when it is free, the same result in software */
+        blk->rms_u16   = (uint16_t)HMATH_Sqrt32((uint32_t)((sumSq + (used / 2u)) / used));
+        blk->acRms_u16 = (uint16_t)HMATH_Sqrt32((uint32_t)((acNum + (n2 / 2u)) / n2));
+    }
+    blk->block_u32 = seq;
+
+    LF_TriplePublish(&s_curTriple);
+
+    const uint32_t cycles = DWT->CYCCNT - start;
+    s_curStats.blocks_u32++;
+    s_curStats.lastCycles_u32 = cycles;
+    if (cycles > s_curStats.maxCycles_u32)
+    {
+        s_curStats.maxCycles_u32 = cycles;
+    }
+}
+
+bool MEAS_GetCurrentBlock(Meas_CurrentBlock_t *blk)
+{
+    const Meas_CurrentBlock_t *latest = LF_TripleRead(&s_curTriple, NULL);
+    if (latest == NULL)
+        return false;
+    *blk = *latest;
+    return true;
+}
+
+const Meas_CurrentStats_t *MEAS_GetCurrentStats(void)
+{
+    return &s_curStats;
+}
+
+void ProcessCurrentSamples_FirstHalf(void)
+{
+    MEAS_ProcessCurrentBlock(&adc2_buf[0], ADC2_HALF_SIZE);
+}
+
+void ProcessCurrentSamples_SecondHalf(void)
+{
+    MEAS_ProcessCurrentBlock(&adc2_buf[ADC2_HALF_SIZE], ADC2_HALF_SIZE);
+}
 
 void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc)
 {
   if (hadc->Instance == ADC2) {
-    // process first half of adc2_buf[]
-	  printf("Half DMA done\r\n");
-	  HAL_GPIO_TogglePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin);
+    HAL_GPIO_WritePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin, GPIO_PIN_SET);
+    ProcessCurrentSamples_FirstHalf();
+    /* Remaining count > half: the DMA wrapped into the first half meanwhile */
+    if (__HAL_DMA_GET_COUNTER(hadc->DMA_Handle) > ADC2_HALF_SIZE)
+      s_curStats.late_u32++;
+    HAL_GPIO_WritePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin, GPIO_PIN_RESET);
   }
-  HAL_GPIO_TogglePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin);
 }
 
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
 {
   if (hadc->Instance == ADC2) {
-    // process second half of adc2_buf[]
-	  printf("Full DMA done\r\n");
-	  HAL_GPIO_TogglePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin);
+    HAL_GPIO_WritePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin, GPIO_PIN_SET);
+    ProcessCurrentSamples_SecondHalf();
+    /* Remaining count <= half: the DMA is already writing the second half again */
+    if (__HAL_DMA_GET_COUNTER(hadc->DMA_Handle) <= ADC2_HALF_SIZE)
+      s_curStats.late_u32++;
+    HAL_GPIO_WritePin(DBG1_PB0_GPIO_Port, DBG1_PB0_Pin, GPIO_PIN_RESET);
   }
 }
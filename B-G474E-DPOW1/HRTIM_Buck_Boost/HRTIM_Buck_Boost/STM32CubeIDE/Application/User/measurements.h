@@ -6,6 +6,7 @@
 
 #include "stm32g4xx_hal.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 
 #pragma once
@@ -16,31 +17,180 @@ extern uint16_t adc2_buf[ADC2_BUF_SIZE];
 void ProcessCurrentSamples_FirstHalf(void);
 void ProcessCurrentSamples_SecondHalf(void);
 
+/* ---------------------------------------------------------------------------
+ * High-rate input current sampling on ADC2
+ *
+ * ADC2 converts the input current sense (PA0 = ADC12_IN1, the pin of ADC1
+ * injected rank 1) continuously into adc2_buf with circular DMA. Each DMA half /
+ * full interrupt reduces the finished half to mean, RMS, ripple RMS, min/max and
+ * a decimated trace (one pass, dual 16-bit SIMD on the M4) and publishes the
+ * result through a double buffer like the injected frames below.
+ * ------------------------------------------------------------------------- */
+
+#define ADC2_HALF_SIZE             (ADC2_BUF_SIZE / 2u)
+#define MEAS_I_SAMPLE_RATE_HZ      708333u      /* 42.5 MHz / (47.5 + 12.5) ADC clocks */
+#define MEAS_I_DECIM               16u          /* samples per trace point            */
+#define MEAS_I_TRACE_LEN           (ADC2_HALF_SIZE / MEAS_I_DECIM)
 
 typedef struct
 {
-    uint32_t BUCKBOOST_I_IN_SENSE_RAW;
-    uint32_t BUCKBOOST_I_IN_SENSE_SCALED;
-    uint32_t BUCKBOOST_I_IN_SENSE_mV;
+    uint32_t block_u32;                     /* half buffers processed             */
+    uint16_t mean_u16;                      /* ADC codes                          */
+    uint16_t rms_u16;                       /* RMS including DC                   */
+    uint16_t acRms_u16;                     /* ripple RMS, mean removed           */
+    uint16_t min_u16;
+    uint16_t max_u16;
+    uint16_t trace_u16[MEAS_I_TRACE_LEN];   /* averages of MEAS_I_DECIM samples   */
+} Meas_CurrentBlock_t;
+
+typedef struct
+{
+    uint32_t blocks_u32;
+    uint32_t late_u32;                      /* DMA already back in the half being processed */
+    uint32_t overruns_u32;                  /* ADC2 OVR flags                      */
+    uint32_t lastCycles_u32;                /* processing of one half              */
+    uint32_t maxCycles_u32;
+} Meas_CurrentStats_t;
+
+/* Configure ADC2 + DMA1 channel 1 and start the circular conversion */
+bool MEAS_CurrentStart(void);
+
+/* DMA1_Channel1_IRQHandler / ADC1_2_IRQHandler parts of the ADC2 path */
+void MEAS_CurrentDmaIRQHandler(void);
+void MEAS_CurrentAdcIRQHandler(void);
+
+/* Reduce n samples (even, 4-byte aligned) and publish the result */
+void MEAS_ProcessCurrentBlock(const uint16_t *samples_u16, uint32_t n);
+
+/* Consistent copy of the latest block result, false if none yet.
+ * Main loop only: the triple buffer has a single reader. */
+bool MEAS_GetCurrentBlock(Meas_CurrentBlock_t *blk);
+const Meas_CurrentStats_t *MEAS_GetCurrentStats(void);
+
+
+
+/* ---------------------------------------------------------------------------
+ * PWM-rate capture of the ADC1 injected sequence
+ *
+ * HRTIM TRG2 (timer C CMP2) starts the 4-rank injected sequence; the JEOS
+ * interrupt stores every sequence and publishes it through a double buffer:
+ * the ISR fills the slot the readers are not using, then bumps the sequence
+ * counter. A reader (main loop or a higher priority ISR) copies the current
+ * slot and retries if the writer published twice meanwhile, so nobody waits
+ * and a torn frame is never returned.
+ *
+ * Each published frame holds the latest sample plus min/max/average of the last
+ * completed window of MEAS_DECIM sequences; window averages are also kept in a
+ * per-channel history ring for trends/plots.
+ * ------------------------------------------------------------------------- */
+
+/* Injected ranks, in conversion order */
+typedef enum
+{
+    MEAS_CH_I_IN_SENSE = 0,
+    MEAS_CH_VIN,
+    MEAS_CH_I_IN_AVG,
+    MEAS_CH_VOUT,
+    MEAS_NUM_CH
+} Meas_Channel_t;
 
-    uint32_t BUCKBOOST_VIN_RAW;
-    uint32_t BUCKBOOST_VIN_mV;
-    uint32_t BUCKBOOST_VIN_SCALED;
+/* ---------------------------------------------------------------------------
+ * Conversion: out_mV = ((raw - offset) * gain_q16 + 0.5) >> 16
+ *
+ * The nominal Q16 gains (VDDA / FS, times the divider ratio) are computed at
+ * compile time; a per-channel calibration (offset in codes, Q15 gain trim) is
+ * folded into them once at load time, so a conversion is a subtract, a clamp
+ * and one multiply-shift per value.
+ * ------------------------------------------------------------------------- */
 
-    uint32_t BUCKBOOST_I_IN_AVG_RAW;
-    uint32_t BUCKBOOST_I_IN_AVG_mV;
-    uint32_t BUCKBOOST_I_IN_AVG_SCALED;
+/* Converted values, one array per quantity, indexed by Meas_Channel_t */
+typedef struct
+{
+    uint16_t raw_u16[MEAS_NUM_CH];          /* ADC codes                         */
+    uint16_t pin_mV_u16[MEAS_NUM_CH];       /* voltage at the ADC pin            */
+    uint16_t scaled_mV_u16[MEAS_NUM_CH];    /* in front of the divider           */
+} Meas_Values_t;
+
+/* Calibration record in the last flash page (2 KB page, single/dual bank alike).
+ * Erased or invalid flash falls back to offset 0 / gain 1.0. */
+#define MEAS_CALIB_FLASH_ADDR      0x0807F800u
+#define MEAS_CALIB_MAGIC           0x4C41434Du     /* "MCAL" */
+#define MEAS_CALIB_GAIN_ONE        0x8000u
+#define MEAS_CALIB_OFFSET_MAX      256
 
-    uint32_t BUCKBOOST_VOUT_RAW;
-    uint32_t BUCKBOOST_VOUT_mV;
-    uint32_t BUCKBOOST_VOUT_SCALED;
-} Meas_Voltages_ADC1_t;
+typedef struct
+{
+    uint32_t magic_u32;
+    int16_t  offset_s16[MEAS_NUM_CH];       /* ADC codes subtracted before scaling  */
+    uint16_t gain_u16[MEAS_NUM_CH];         /* Q15 trim, MEAS_CALIB_GAIN_ONE = 1.0  */
+    uint32_t checksum_u32;                  /* ~sum of the preceding words          */
+} Meas_Calib_t;
 
-/* must be called once with the ADC handle */
+/* 4 ranks x (247.5 + 12.5) ADC clocks at 42.5 MHz = 24.5 us per sequence, so the
+ * trigger is post-scaled to every 8th PWM period (250 kHz / 8 = 31.25 kHz):
+ * deterministic sampling instead of silently dropped triggers. */
+#define MEAS_ADC_TRIG_POSTSCALER   7u
+#define MEAS_SAMPLE_RATE_HZ        31250u
+
+#define MEAS_DECIM_SHIFT           5u
+#define MEAS_DECIM                 (1u << MEAS_DECIM_SHIFT)   /* sequences per window (~1 ms) */
+#define MEAS_HISTORY_LEN           128u                       /* windows kept, power of 2     */
+#define MEAS_READ_RETRIES          4u
+
+typedef struct
+{
+    uint32_t seq_u32;                   /* sequence number of raw[]           */
+    uint32_t window_u32;                /* number of the window in min/max/avg */
+    uint16_t raw_u16[MEAS_NUM_CH];      /* latest injected sequence           */
+    uint16_t min_u16[MEAS_NUM_CH];      /* last completed window              */
+    uint16_t max_u16[MEAS_NUM_CH];
+    uint16_t avg_u16[MEAS_NUM_CH];
+} Meas_Frame_t;
+
+typedef struct
+{
+    uint32_t sequences_u32;             /* JEOS interrupts handled                 */
+    uint32_t retries_u32;               /* reads repeated after a concurrent publish */
+    uint32_t readFails_u32;             /* reads that gave up after MEAS_READ_RETRIES */
+} Meas_Stats_t;
+
+/* must be called once with the ADC handle (enables the JEOS interrupt) */
 void MEAS_Init(ADC_HandleTypeDef *hadc);
 
-/* read Vin / Vout in millivolts using injected channels 1 and 2 */
-void MEAS_ReadVoltages(Meas_Voltages_ADC1_t *v);
+/* JEOS handler, called from ADC1_2_IRQHandler. Returns true and the sequence in
+ * raw_u16 when one was captured, so per-sample consumers (fault_mgr) can follow. */
+bool MEAS_InjectedIRQHandler(uint16_t raw_u16[MEAS_NUM_CH]);
+
+/* Store one sequence and publish it (hardware independent part of the ISR) */
+void MEAS_Capture(const uint16_t raw_u16[MEAS_NUM_CH]);
+
+/* Consistent copy of the latest frame, false if no frame yet or the reader kept losing */
+bool MEAS_GetFrame(Meas_Frame_t *frame);
+
+/* Latest n (< MEAS_HISTORY_LEN) window averages of one channel, oldest first.
+ * Returns the number of entries copied (fewer while the history fills). */
+uint32_t MEAS_GetHistory(Meas_Channel_t ch, uint16_t *dst_u16, uint32_t n);
+
+const Meas_Stats_t *MEAS_GetStats(void);
+
+/* Load the calibration from flash (defaults if missing) / apply one from RAM.
+ * MEAS_CalibApply() returns false and keeps the old gains if a value is out of range. */
+void MEAS_CalibLoad(void);
+bool MEAS_CalibApply(const Meas_Calib_t *cal);
+uint32_t MEAS_CalibChecksum(const Meas_Calib_t *cal);
+
+/* Convert one injected sequence with the calibrated gains (ISR safe, no division) */
+void MEAS_Convert(const uint16_t raw_u16[MEAS_NUM_CH], Meas_Values_t *v);
+
+/* Inverse of MEAS_Convert() for thresholds: ADC code for a pin / scaled voltage */
+uint16_t MEAS_PinToCode(Meas_Channel_t ch, uint32_t pin_mV);
+uint16_t MEAS_ScaledToCode(Meas_Channel_t ch, uint32_t scaled_mV);
+
+/* Cycles per MEAS_Convert() call, measured with the DWT cycle counter */
+uint32_t MEAS_BenchConvert(void);
+
+/* Vin / Vout / currents in millivolts from the last window averages */
+void MEAS_ReadVoltages(Meas_Values_t *v);
 
 #endif /* MEASUREMENTS_H */
 
@@ -5,4 +5,203 @@
  *      Author: HEIR
  */
 
+#include "motor_control.h"
+#include "encoders.h"
 
+/* Gains tuned on the host model, host/tests/test_motor_control.c (Vin 7..12 V, 22 uH /
+ * 100 uF stage with 20..100 mohm ESR, motor 2 ohm, 1 mH, 0.02 V s/rad, 2e-5 kg m^2;
+ * I_IN_SENSE 0.5 V/A): current step 10-90 % in about 4 ms, speed step 10-90 % in about
+ * 9 ms (~25 Hz crossover) with < 4 % overshoot. The motor shields the output LC from
+ * any damping: faster current gains ring it at low ESR and Vin, and the reference slew
+ * keeps the ringing of a current step below OCP. Another motor or current sense gain
+ * needs them rescaled: kp_i with L / gain, kp_w with J / (Kt * gain). Gains in
+ * Q1.15 * 2^-shift. */
+#define MCTRL_I_PI_SHIFT        2u
+#define MCTRL_I_PI_KP           ((int16_t)(0.40 * 32768 / 4))
+#define MCTRL_I_PI_KI           ((int16_t)(0.05 * 32768 / 4))
+#define MCTRL_W_PI_SHIFT        6u
+#define MCTRL_W_PI_KP           ((int16_t)(20.0 * 32768 / 64))
+#define MCTRL_W_PI_KI           ((int16_t)(0.15 * 32768 / 64))
+#define MCTRL_I_SLEW            2048                                /* current reference step per tick, 0.4 A */
+
+/* Vin code -> Vout code (different dividers) */
+#define MCTRL_VIN_TO_VOUT_NUM   ((uint32_t)VCTRL_VIN_SCALE_NUM * VCTRL_VOUT_SCALE_DEN)
+#define MCTRL_VIN_TO_VOUT_DEN   ((uint32_t)VCTRL_VOUT_SCALE_NUM * VCTRL_VIN_SCALE_DEN)
+
+static uint64_t MCTRL_RpmToCpsQ8(uint32_t rpm)
+{
+    return ((uint64_t)rpm * ENC_COUNTS_PER_REV * 256u) / 60u;
+}
+
+static int16_t MCTRL_Sat16(int32_t v)
+{
+    if (v > INT16_MAX) return INT16_MAX;
+    if (v < INT16_MIN) return INT16_MIN;
+    return (int16_t)v;
+}
+
+void MCTRL_Init(MCTRL_t *mc, const VCTRL_t *stage)
+{
+    mc->stage = stage;
+    COMP_InitPI(&mc->currentPi, MCTRL_I_PI_KP, MCTRL_I_PI_KI, MCTRL_I_PI_SHIFT, 0, 0);
+    COMP_InitPI(&mc->speedPi, MCTRL_W_PI_KP, MCTRL_W_PI_KI, MCTRL_W_PI_SHIFT, 0, 0);
+
+    mc->speedRefQ8_s32    = 0;
+    mc->speedTargetQ8_s32 = 0;
+    mc->iOffset_u16       = 0u;
+    mc->iRef_s16          = 0;
+    mc->iCmd_s16          = 0;
+    mc->iFiltQ_s32        = 0;
+    mc->vCmd_s16          = 0;
+    mc->m_s16             = VCTRL_M_MIN;
+    mc->vSat_s8           = 0;
+    mc->div_u8            = 0u;
+    mc->stats             = (MCTRL_Stats_t){ 0 };
+    MCTRL_SetLimits(mc, 0u, 0u);
+    MCTRL_SetAccel_rpm_per_s(mc, MCTRL_ACCEL_RPM_PER_S);
+}
+
+void MCTRL_SetLimits(MCTRL_t *mc, uint16_t iLimitCode_u16, uint16_t vMaxCode_u16)
+{
+    mc->iLimit_s16 = MCTRL_Sat16((int32_t)iLimitCode_u16 << 3);
+    mc->vMax_s16   = MCTRL_Sat16((int32_t)vMaxCode_u16 << 3);
+    mc->speedPi.uMax_s16 = mc->iLimit_s16;
+
+    /* Speed error at which kp_w alone reaches the limit, as a reference lead */
+    mc->rampLeadQ8_s32 = (((int32_t)mc->iLimit_s16 << (15u - MCTRL_W_PI_SHIFT)) / MCTRL_W_PI_KP) << MCTRL_SPEED_SHIFT;
+}
+
+void MCTRL_SetSpeed_rpm(MCTRL_t *mc, uint32_t rpm)
+{
+    const uint64_t max = (uint64_t)(MCTRL_SPEED_FS_CPS - 1u) << 8;
+    const uint64_t target = MCTRL_RpmToCpsQ8(rpm);
+    mc->speedTargetQ8_s32 = (int32_t)((target > max) ? max : target);
+}
+
+void MCTRL_SetAccel_rpm_per_s(MCTRL_t *mc, uint32_t rpm_per_s)
+{
+    /* At most full scale per speed step (a step), so the ramp cannot overflow */
+    const uint64_t max = (uint64_t)MCTRL_SPEED_FS_CPS << 8;
+    const uint64_t step = MCTRL_RpmToCpsQ8(rpm_per_s) / (VCTRL_FS_HZ / MCTRL_SPEED_DIV);
+    mc->accelQ8_s32 = (step > max) ? (int32_t)max : ((step > 0u) ? (int32_t)step : 1);
+}
+
+void MCTRL_SetCurrentOffset(MCTRL_t *mc, uint16_t iOffsetCode_u16)
+{
+    mc->iOffset_u16 = iOffsetCode_u16;
+}
+
+void MCTRL_Start(MCTRL_t *mc, const MCTRL_Input_t *in)
+{
+    int32_t i = ((int32_t)in->iCode_u16 - (int32_t)mc->iOffset_u16) << 3;
+    if (i < 0) i = 0;
+    if (i > mc->iLimit_s16) i = mc->iLimit_s16;
+
+    /* Speed ramp from the shaft, current PI holding the present output voltage */
+    mc->speedRefQ8_s32 = (in->speed_cps_q8 > 0) ? in->speed_cps_q8 : 0;
+    mc->iRef_s16       = (int16_t)i;
+    mc->iCmd_s16       = (int16_t)i;
+    mc->iFiltQ_s32     = i << MCTRL_I_FILT_SHIFT;
+    mc->vCmd_s16       = MCTRL_Sat16((int32_t)in->voutCode_u16 << 3);
+    mc->vSat_s8        = 0;
+    mc->div_u8         = 0u;
+    COMP_Reset(&mc->speedPi, mc->iRef_s16);
+    COMP_Reset(&mc->currentPi, mc->vCmd_s16);
+}
+
+static void MCTRL_SpeedStep(MCTRL_t *mc, int32_t speed_cps_q8)
+{
+    /* Acceleration ramp; waits while it already leads the shaft by what drives the speed
+     * PI to the current limit: more lead does not accelerate, it only winds up */
+    if (mc->speedRefQ8_s32 < mc->speedTargetQ8_s32)
+    {
+        if ((mc->speedRefQ8_s32 - speed_cps_q8) < mc->rampLeadQ8_s32)
+        {
+            mc->speedRefQ8_s32 += mc->accelQ8_s32;
+            if (mc->speedRefQ8_s32 > mc->speedTargetQ8_s32) mc->speedRefQ8_s32 = mc->speedTargetQ8_s32;
+        }
+    }
+    else if (mc->speedRefQ8_s32 > mc->speedTargetQ8_s32)
+    {
+        mc->speedRefQ8_s32 -= mc->accelQ8_s32;
+        if (mc->speedRefQ8_s32 < mc->speedTargetQ8_s32) mc->speedRefQ8_s32 = mc->speedTargetQ8_s32;
+    }
+
+    const int16_t e = MCTRL_Sat16((mc->speedRefQ8_s32 - speed_cps_q8) >> MCTRL_SPEED_SHIFT);
+
+    /* Inner loop at a voltage clamp: more current in that direction is not available.
+     * The PI tracks the current actually delivered, so it resumes from there, without
+     * a proportional kick from a stale error, once the clamp lets go */
+    if (((mc->vSat_s8 > 0) && (e > 0)) || ((mc->vSat_s8 < 0) && (e < 0)))
+    {
+        COMP_Track(&mc->speedPi, e, MCTRL_Sat16(mc->iFiltQ_s32 >> MCTRL_I_FILT_SHIFT));
+        mc->iRef_s16 = mc->speedPi.y_s16[0];
+        mc->stats.speedHeld_u32++;
+        return;
+    }
+
+    mc->iRef_s16 = COMP_Step(&mc->speedPi, e);
+    mc->stats.speedSteps_u32++;
+    if (mc->iRef_s16 >= mc->iLimit_s16)
+    {
+        mc->stats.currentLimited_u32++;
+    }
+}
+
+VCTRL_Duty_t MCTRL_Step(MCTRL_t *mc, const MCTRL_Input_t *in)
+{
+    if (++mc->div_u8 >= MCTRL_SPEED_DIV)
+    {
+        mc->div_u8 = 0u;
+        MCTRL_SpeedStep(mc, in->speed_cps_q8);
+    }
+
+    /* Voltage range of the stage at this Vin, in Vout codes << 3 */
+    const uint32_t vin = ((uint32_t)in->vinCode_u16 * MCTRL_VIN_TO_VOUT_NUM) / MCTRL_VIN_TO_VOUT_DEN;
+    int32_t vHigh = (int32_t)((vin * (uint32_t)VCTRL_M_MAX) >> 11);
+    int32_t vLow  = (int32_t)((vin * (uint32_t)VCTRL_M_MIN) >> 11);
+    if (vHigh > mc->vMax_s16) vHigh = mc->vMax_s16;
+    if (vLow > vHigh) vLow = vHigh;
+    mc->currentPi.uMax_s16 = (int16_t)vHigh;
+    mc->currentPi.uMin_s16 = (int16_t)vLow;
+
+    /* Current, low-passed against the output LC ringing that the inductor current carries */
+    const int32_t i = ((int32_t)in->iCode_u16 - (int32_t)mc->iOffset_u16) << 3;
+    mc->iFiltQ_s32 += i - (mc->iFiltQ_s32 >> MCTRL_I_FILT_SHIFT);
+    int32_t di = (int32_t)mc->iRef_s16 - mc->iCmd_s16;
+    if (di > MCTRL_I_SLEW) di = MCTRL_I_SLEW;
+    if (di < -MCTRL_I_SLEW) di = -MCTRL_I_SLEW;
+    mc->iCmd_s16 = (int16_t)(mc->iCmd_s16 + di);
+    mc->vCmd_s16 = COMP_Step(&mc->currentPi, MCTRL_Sat16((int32_t)mc->iCmd_s16 - (mc->iFiltQ_s32 >> MCTRL_I_FILT_SHIFT)));
+    mc->vSat_s8  = (mc->vCmd_s16 >= vHigh) ? 1 : ((mc->vCmd_s16 <= vLow) ? -1 : 0);
+
+    /* Vin feed-forward: m / 2 in Q1.15 = (vCmd >> 3) / vin * 2^14 */
+    int32_t m = VCTRL_M_MIN;
+    if (vin > 0u)
+    {
+        m = (int32_t)(((uint32_t)mc->vCmd_s16 << 11) / vin);
+    }
+    if (m < VCTRL_M_MIN) m = VCTRL_M_MIN;
+    if (m > VCTRL_M_MAX) m = VCTRL_M_MAX;
+    mc->m_s16 = (int16_t)m;
+
+    mc->stats.iterations_u32++;
+    if (mc->vSat_s8 != 0)
+    {
+        mc->stats.voltageSat_u32++;
+    }
+    return VCTRL_RatioToDuty(mc->stage, mc->m_s16);
+}
+
+void MCTRL_RecordCycles(MCTRL_t *mc, uint32_t cycles_u32)
+{
+    mc->stats.lastCycles_u32 = cycles_u32;
+    if (cycles_u32 > mc->stats.maxCycles_u32)
+    {
+        mc->stats.maxCycles_u32 = cycles_u32;
+    }
+    if (cycles_u32 > MCTRL_CYCLE_BUDGET)
+    {
+        mc->stats.overBudget_u32++;
+    }
+}
@@ -3,11 +3,122 @@
  *
  *  Created on: Jan 17, 2026
  *      Author: HEIR
+ *
+ *  Cascaded speed / current control of a brushed DC motor on the buck-boost output.
+ *
+ *      speed ref --ramp--> speed PI --> current ref --> current PI --> motor voltage
+ *         (every MCTRL_SPEED_DIV ticks, encoder)      (every tick, I_IN_SENSE)
+ *                                                          |
+ *                              m = Vmotor / Vin  <---------+  (Vin feed-forward)
+ *                              VCTRL_RatioToDuty(): timer C / timer D compares
+ *
+ *  Current: I_IN_SENSE is sampled at the middle of the buck on-time (timer C CMP2),
+ *  where the input current equals the average inductor current. That is the motor
+ *  current in the buck region and m / Dmax times it in buck-boost; the inner loop
+ *  regulates the inductor current, so its limit protects the switches in both
+ *  regions and the speed loop integrates the difference away.
+ *
+ *  Vin feed-forward: the current PI commands a motor voltage, divided by the
+ *  measured Vin into the conversion ratio, so an input step does not disturb the
+ *  current. Its clamp follows Vin as well (m from VCTRL_M_MIN to VCTRL_M_MAX, and
+ *  at most vMax): the integrator never winds past what the stage can deliver.
+ *
+ *  Anti-windup in the cascade: both PIs clamp their stored output (compensator.h);
+ *  while the current PI sits at a voltage clamp and the speed error pushes further
+ *  into it, the speed PI tracks the filtered current instead of integrating
+ *  (COMP_Track()), and the speed ramp waits once it leads the shaft by the error
+ *  that drives kp_w alone to the current limit, so the reference does not run away
+ *  from the shaft at either limit.
+ *
+ *  Motoring only: the stage cannot reverse the motor voltage, and regenerative
+ *  current would charge the output capacitor into OVP, so the speed reference,
+ *  current reference and voltage are all >= 0.
+ *
+ *  Units (all Q1.15, the compensators' native format):
+ *      current  : I_IN_SENSE ADC codes above the zero-current offset, << 3
+ *      voltage  : Vout ADC codes, << 3
+ *      speed    : encoder counts/s Q8 >> MCTRL_SPEED_SHIFT, full scale 2^19 counts/s
+ *
+ *  Pure computation like voltage_ctrl: the HRTIM ISR passes the injected ADC codes
+ *  and the encoder snapshot in and writes the compare values out, so the same code
+ *  runs against a motor + converter model on a host.
  */
 
 #ifndef APPLICATION_USER_MOTOR_CONTROL_H_
 #define APPLICATION_USER_MOTOR_CONTROL_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "compensator.h"
+#include "voltage_ctrl.h"
+
+#define MCTRL_SPEED_DIV         8u                                  /* speed loop at 7812 / 8 = 977 Hz */
+#define MCTRL_SPEED_SHIFT       12u                                 /* cps Q8 -> Q1.15 of 2^19 cps      */
+#define MCTRL_SPEED_FS_CPS      (1u << (15u + MCTRL_SPEED_SHIFT - 8u))
+#define MCTRL_I_FILT_SHIFT      3u                                  /* current filter, ~155 Hz          */
+#define MCTRL_ACCEL_RPM_PER_S   2000u                               /* default speed ramp              */
+#define MCTRL_CYCLE_BUDGET      1700u                               /* 10 us of the 128 us tick, 170 MHz */
+
+/* Measured values for one control tick */
+typedef struct
+{
+    uint16_t iCode_u16;             /* I_IN_SENSE, mid buck on-time     */
+    uint16_t vinCode_u16;
+    uint16_t voutCode_u16;
+    int32_t  speed_cps_q8;          /* ENC_Snapshot_t speed             */
+} MCTRL_Input_t;
+
+typedef struct
+{
+    uint32_t iterations_u32;
+    uint32_t speedSteps_u32;
+    uint32_t voltageSat_u32;        /* current PI at a voltage clamp    */
+    uint32_t currentLimited_u32;    /* speed PI at the current limit    */
+    uint32_t speedHeld_u32;         /* speed PI steps tracked (anti-windup) */
+    uint32_t lastCycles_u32;        /* ISR cost, filled by the caller (DWT) */
+    uint32_t maxCycles_u32;
+    uint32_t overBudget_u32;        /* ticks above MCTRL_CYCLE_BUDGET   */
+} MCTRL_Stats_t;
+
+typedef struct
+{
+    COMP_t          speedPi;
+    COMP_t          currentPi;
+    const VCTRL_t  *stage;          /* ratio -> compare mapping          */
+    int32_t         speedRefQ8_s32; /* ramped reference, counts/s Q8     */
+    int32_t         speedTargetQ8_s32;
+    int32_t         accelQ8_s32;    /* reference step per speed step     */
+    int32_t         rampLeadQ8_s32; /* ramp waits beyond this lead       */
+    uint16_t        iOffset_u16;    /* I_IN_SENSE code at zero current   */
+    int16_t         iLimit_s16;     /* speed PI clamp, current units     */
+    int16_t         vMax_s16;       /* motor voltage clamp, voltage units */
+    int32_t         iFiltQ_s32;     /* filtered current << MCTRL_I_FILT_SHIFT */
+    int16_t         iRef_s16;       /* speed PI output                   */
+    int16_t         iCmd_s16;       /* iRef slewed, into the current PI  */
+    int16_t         vCmd_s16;
+    int16_t         m_s16;          /* last ratio, Q1.15 of m/2          */
+    int8_t          vSat_s8;        /* current PI clamp: -1 low, 1 high  */
+    uint8_t         div_u8;
+    MCTRL_Stats_t   stats;
+} MCTRL_t;
+
+/* stage: initialised VCTRL instance of the same power stage (period) */
+void         MCTRL_Init(MCTRL_t *mc, const VCTRL_t *stage);
+
+/* Limits in ADC codes: current above the zero offset, motor voltage on Vout */
+void         MCTRL_SetLimits(MCTRL_t *mc, uint16_t iLimitCode_u16, uint16_t vMaxCode_u16);
+void         MCTRL_SetSpeed_rpm(MCTRL_t *mc, uint32_t rpm);
+void         MCTRL_SetAccel_rpm_per_s(MCTRL_t *mc, uint32_t rpm_per_s);
+
+/* I_IN_SENSE code at zero current (calibration offset) */
+void         MCTRL_SetCurrentOffset(MCTRL_t *mc, uint16_t iOffsetCode_u16);
+
+/* Bumpless start from the present speed, current and output voltage */
+void         MCTRL_Start(MCTRL_t *mc, const MCTRL_Input_t *in);
+
+/* One control tick (HRTIM timer C repetition), returns the compares to load */
+VCTRL_Duty_t MCTRL_Step(MCTRL_t *mc, const MCTRL_Input_t *in);
 
+void         MCTRL_RecordCycles(MCTRL_t *mc, uint32_t cycles_u32);
 
 #endif /* APPLICATION_USER_MOTOR_CONTROL_H_ */
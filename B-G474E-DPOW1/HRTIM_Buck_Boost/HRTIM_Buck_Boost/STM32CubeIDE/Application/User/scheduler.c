@@ -0,0 +1,108 @@
+/*
+ * scheduler.c
+ *
+ *  Created on: Jan 18, 2026
+ *      Author: HEIR
+ */
+
+#include "scheduler.h"
+#include <stddef.h>
+#include <string.h>
+
+static const SCHED_TaskDesc_t *s_tasks = NULL;
+static uint32_t          s_numTasks_u32;
+static uint32_t        (*s_cycles)(void);
+static uint32_t          s_cyclesPerUs_u32;
+
+static uint32_t          s_release_ms[SCHED_MAX_TASKS];
+static uint32_t          s_budgetCycles_u32[SCHED_MAX_TASKS];
+static volatile uint8_t  s_event_u8[SCHED_MAX_TASKS];
+static SCHED_TaskStats_t s_stats[SCHED_MAX_TASKS];
+
+bool SCHED_Init(const SCHED_TaskDesc_t *tasks, uint32_t numTasks,
+                uint32_t (*cycles)(void), uint32_t cyclesPerUs, uint32_t now_ms)
+{
+    if ((tasks == NULL) || (numTasks > SCHED_MAX_TASKS) || (cycles == NULL))
+        return false;
+
+    s_tasks = tasks;
+    s_numTasks_u32 = numTasks;
+    s_cycles = cycles;
+    s_cyclesPerUs_u32 = cyclesPerUs;
+    memset(s_stats, 0, sizeof(s_stats));
+
+    for (uint32_t i = 0u; i < numTasks; i++)
+    {
+        const uint32_t budget_us = (tasks[i].budget_us != 0u) ? tasks[i].budget_us : (tasks[i].period_ms * 1000u);
+        s_budgetCycles_u32[i] = budget_us * cyclesPerUs;
+        s_release_ms[i] = now_ms + tasks[i].period_ms;
+        s_event_u8[i] = 0u;
+    }
+    return true;
+}
+
+void SCHED_SetEvent(uint32_t task)
+{
+    if (task < SCHED_MAX_TASKS)
+        s_event_u8[task] = 1u;
+}
+
+bool SCHED_Run(uint32_t now_ms)
+{
+    for (uint32_t i = 0u; i < s_numTasks_u32; i++)
+    {
+        const SCHED_TaskDesc_t *t = &s_tasks[i];
+        SCHED_TaskStats_t *st = &s_stats[i];
+        const uint32_t period = t->period_ms;
+        const bool due = (period != 0u) && ((int32_t)(now_ms - s_release_ms[i]) >= 0);
+
+        if (!due && (s_event_u8[i] == 0u))
+            continue;
+
+        /* Cleared before the run: an event raised meanwhile runs it again */
+        s_event_u8[i] = 0u;
+
+        if (due)
+        {
+            const uint32_t late_ms = now_ms - s_release_ms[i];
+            if (late_ms > st->maxLate_ms)
+                st->maxLate_ms = late_ms;
+
+            /* Keep the phase, release once for all the periods slept through */
+            const uint32_t skipped = late_ms / period;
+            st->missed_u32 += skipped;
+            s_release_ms[i] += (skipped + 1u) * period;
+        }
+        else
+        {
+            st->events_u32++;
+        }
+
+        const uint32_t start = s_cycles();
+        t->run();
+        const uint32_t cycles = s_cycles() - start;
+
+        st->runs_u32++;
+        st->lastCycles_u32 = cycles;
+        if (cycles > st->maxCycles_u32)
+            st->maxCycles_u32 = cycles;
+        if ((s_budgetCycles_u32[i] != 0u) && (cycles > s_budgetCycles_u32[i]))
+            st->overruns_u32++;
+        return true;
+    }
+    return false;
+}
+
+const SCHED_TaskStats_t *SCHED_GetStats(uint32_t task)
+{
+    return (task < SCHED_MAX_TASKS) ? &s_stats[task] : NULL;
+}
+
+void SCHED_ResetMax(void)
+{
+    for (uint32_t i = 0u; i < s_numTasks_u32; i++)
+    {
+        s_stats[i].maxCycles_u32 = 0u;
+        s_stats[i].maxLate_ms = 0u;
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * scheduler.h
+ *
+ *  Created on: Jan 18, 2026
+ *      Author: HEIR
+ *
+ *  Cooperative run-to-completion scheduler for the main loop.
+ *
+ *  Each task has a period in ms (0 = event only) and an event flag that an
+ *  interrupt can raise with SCHED_SetEvent() to run it at the next pass instead
+ *  of its next release. SCHED_Run() runs the highest priority ready task (lowest
+ *  index) and returns, so a long low priority task delays the others by at most
+ *  its own run time. The hard real-time work stays in interrupts: control in
+ *  HRTIM1_TIMC_IRQHandler, protection sampling and telemetry in the ADC JEOS ISR.
+ *
+ *  Per task it records run time in cycles and two kinds of overrun:
+ *      overruns : a run took longer than its budget (default: its period)
+ *      missed   : releases skipped because the task started a period or more late
+ *  A late task is released once, not once per missed period.
+ *
+ *  Time (now_ms) and cycles come from the caller, so the module builds on the host.
+ */
+
+#ifndef APPLICATION_USER_SCHEDULER_H_
+#define APPLICATION_USER_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCHED_MAX_TASKS     8u
+
+typedef struct
+{
+    const char *name;
+    void      (*run)(void);
+    uint32_t    period_ms;          /* 0 = event only                   */
+    uint32_t    budget_us;          /* 0 = whole period                 */
+} SCHED_TaskDesc_t;
+
+typedef struct
+{
+    uint32_t runs_u32;
+    uint32_t events_u32;            /* runs started by an event         */
+    uint32_t lastCycles_u32;
+    uint32_t maxCycles_u32;
+    uint32_t overruns_u32;
+    uint32_t missed_u32;
+    uint32_t maxLate_ms;            /* release to start                 */
+} SCHED_TaskStats_t;
+
+/* cycles: free running cycle counter (DWT->CYCCNT on target) */
+bool     SCHED_Init(const SCHED_TaskDesc_t *tasks, uint32_t numTasks,
+                    uint32_t (*cycles)(void), uint32_t cyclesPerUs, uint32_t now_ms);
+
+/* Any context; a byte store per task, no read-modify-write */
+void     SCHED_SetEvent(uint32_t task);
+
+/* Main loop: runs at most one task, returns false when nothing was ready */
+bool     SCHED_Run(uint32_t now_ms);
+
+const SCHED_TaskStats_t *SCHED_GetStats(uint32_t task);
+void     SCHED_ResetMax(void);
+
+#endif /* APPLICATION_USER_SCHEDULER_H_ */
@@ -5,4 +5,223 @@
  *      Author: HEIR
  */
 
+#include "usb_stream.h"
+#include <stddef.h>
+#include <string.h>
 
+/* Keeps the configuration writes on their side of the enable flag */
+#define STREAM_BARRIER()    __asm volatile ("" ::: "memory")
+
+static const GCOM_Transport_t *s_tr = NULL;
+static STREAM_Config_t         s_cfg = { STREAM_DEFAULT_RECORD_DIV, STREAM_DEFAULT_CH_DIV };
+static volatile bool           s_enabled = false;
+
+/* --- Owned by the interrupt side --- */
+static uint32_t s_tick_u32;
+static uint32_t s_seqCnt_u32;       /* sequences since the last record */
+static uint8_t  s_chCnt_u8[MEAS_NUM_CH];
+static uint32_t s_lost_u32;
+static STREAM_Stats_t s_stats;
+
+static void STREAM_PutU16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t STREAM_GetU16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t STREAM_MaskBits(uint32_t mask)
+{
+    uint32_t n = 0u;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+        n += (mask >> ch) & 1u;
+    return n;
+}
+
+void STREAM_Init(const GCOM_Transport_t *tr)
+{
+    s_enabled = false;
+    STREAM_BARRIER();
+    s_tr = tr;
+    s_tick_u32 = 0u;
+    s_seqCnt_u32 = 0u;
+    s_lost_u32 = 0u;
+    memset(s_chCnt_u8, 0, sizeof(s_chCnt_u8));
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+bool STREAM_Configure(const STREAM_Config_t *cfg, uint32_t baud)
+{
+    if ((cfg == NULL) || (cfg->recordDiv_u16 == 0u))
+        return false;
+
+    /* Average stream rate against the share of the link we may take */
+    if ((uint64_t)STREAM_BytesPerSecond(cfg) * 100u >
+        (uint64_t)STREAM_LinkBytesPerSecond(baud) * STREAM_LINK_BUDGET_PCT)
+        return false;
+
+    /* The interrupt only reads s_cfg while enabled */
+    const bool wasEnabled = s_enabled;
+    s_enabled = false;
+    STREAM_BARRIER();
+    s_cfg = *cfg;
+    s_seqCnt_u32 = 0u;
+    memset(s_chCnt_u8, 0, sizeof(s_chCnt_u8));
+    STREAM_BARRIER();
+    s_enabled = wasEnabled;
+    return true;
+}
+
+void STREAM_Enable(bool enable)
+{
+    s_enabled = enable && (s_tr != NULL);
+}
+
+bool STREAM_IsEnabled(void)
+{
+    return s_enabled;
+}
+
+uint32_t STREAM_Tick(void)
+{
+    s_tick_u32++;
+    if (!s_enabled)
+        return 0u;
+
+    if (++s_seqCnt_u32 < s_cfg.recordDiv_u16)
+        return 0u;
+    s_seqCnt_u32 = 0u;
+
+    uint32_t due = STREAM_DUE;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        if (s_cfg.chDiv_u8[ch] == 0u)
+            continue;
+        if (s_chCnt_u8[ch] == 0u)
+            due |= (1u << ch);
+        if (++s_chCnt_u8[ch] >= s_cfg.chDiv_u8[ch])
+            s_chCnt_u8[ch] = 0u;
+    }
+    return due;
+}
+
+void STREAM_Push(const STREAM_Sample_t *s, uint32_t due)
+{
+    if ((due & STREAM_DUE) == 0u)
+        return;
+
+    STREAM_Record_t rec;
+    rec.tick_u32     = s_tick_u32;
+    rec.mode_u8      = s->mode_u8;
+    rec.faults_u8    = s->faults_u8;
+    rec.chMask_u8    = (uint8_t)(due & ((1u << MEAS_NUM_CH) - 1u));
+    rec.lost_u8      = (s_lost_u32 > 0xFFu) ? 0xFFu : (uint8_t)s_lost_u32;
+    memcpy(rec.ch_u16, s->ch_u16, sizeof(rec.ch_u16));
+    rec.buckCmp_u16  = s->buckCmp_u16;
+    rec.boostCmp_u16 = s->boostCmp_u16;
+
+    uint8_t payload[STREAM_MAX_PAYLOAD];
+    const uint32_t len = STREAM_Pack(&rec, payload);
+
+    if (GCOM_Send(s_tr, GCOM_TYPE_TELEMETRY, payload, len))
+    {
+        s_lost_u32 = 0u;
+        s_stats.records_u32++;
+        s_stats.bytes_u32 += len + GCOM_OVERHEAD;
+    }
+    else
+    {
+        s_lost_u32++;
+        s_stats.dropped_u32++;
+    }
+}
+
+uint32_t STREAM_AvgFrameBytes_x100(const STREAM_Config_t *cfg)
+{
+    uint32_t avg_x100 = (GCOM_OVERHEAD + STREAM_HEADER_BYTES + STREAM_TRAILER_BYTES) * 100u;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        if (cfg->chDiv_u8[ch] != 0u)
+            avg_x100 += (200u + cfg->chDiv_u8[ch] - 1u) / cfg->chDiv_u8[ch];   /* round up */
+    }
+    return avg_x100;
+}
+
+uint32_t STREAM_BytesPerSecond(const STREAM_Config_t *cfg)
+{
+    const uint64_t records_x100 = ((uint64_t)MEAS_SAMPLE_RATE_HZ * 100u) / cfg->recordDiv_u16;
+    return (uint32_t)((records_x100 * STREAM_AvgFrameBytes_x100(cfg) + 9999u) / 10000u);
+}
+
+uint32_t STREAM_LinkBytesPerSecond(uint32_t baud)
+{
+    /* 8N1: start + 8 data + stop */
+    return baud / 10u;
+}
+
+uint32_t STREAM_Pack(const STREAM_Record_t *rec, uint8_t *out)
+{
+    uint32_t n = 0u;
+
+    out[n++] = (uint8_t)rec->tick_u32;
+    out[n++] = (uint8_t)(rec->tick_u32 >> 8);
+    out[n++] = (uint8_t)(rec->tick_u32 >> 16);
+    out[n++] = (uint8_t)(rec->tick_u32 >> 24);
+    out[n++] = rec->mode_u8;
+    out[n++] = rec->faults_u8;
+    out[n++] = rec->chMask_u8;
+    out[n++] = rec->lost_u8;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        if ((rec->chMask_u8 & (1u << ch)) != 0u)
+        {
+            STREAM_PutU16(&out[n], rec->ch_u16[ch]);
+            n += 2u;
+        }
+    }
+    STREAM_PutU16(&out[n], rec->buckCmp_u16);
+    STREAM_PutU16(&out[n + 2u], rec->boostCmp_u16);
+    return n + STREAM_TRAILER_BYTES;
+}
+
+bool STREAM_Unpack(const uint8_t *payload, uint32_t len, STREAM_Record_t *rec)
+{
+    if (len < (STREAM_HEADER_BYTES + STREAM_TRAILER_BYTES))
+        return false;
+
+    const uint8_t mask = payload[6];
+    if ((mask >> MEAS_NUM_CH) != 0u)
+        return false;
+    if (len != (STREAM_HEADER_BYTES + 2u * STREAM_MaskBits(mask) + STREAM_TRAILER_BYTES))
+        return false;
+
+    memset(rec, 0, sizeof(*rec));
+    rec->tick_u32  = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) |
+                     ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+    rec->mode_u8   = payload[4];
+    rec->faults_u8 = payload[5];
+    rec->chMask_u8 = mask;
+    rec->lost_u8   = payload[7];
+
+    uint32_t n = STREAM_HEADER_BYTES;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        if ((mask & (1u << ch)) != 0u)
+        {
+            rec->ch_u16[ch] = STREAM_GetU16(&payload[n]);
+            n += 2u;
+        }
+    }
+    rec->buckCmp_u16  = STREAM_GetU16(&payload[n]);
+    rec->boostCmp_u16 = STREAM_GetU16(&payload[n + 2u]);
+    return true;
+}
+
+const STREAM_Stats_t *STREAM_GetStats(void)
+{
+    return &s_stats;
+}
@@ -3,11 +3,102 @@
  *
  *  Created on: Jan 17, 2026
  *      Author: HEIR
+ *
+ *  Binary telemetry of the power stage, sent as GCOM_TYPE_TELEMETRY frames.
+ *
+ *  STREAM_Tick() runs on every ADC1 injected sequence (MEAS_SAMPLE_RATE_HZ) and
+ *  says whether a record is due: one every recordDiv sequences, and channel ch
+ *  is included in every chDiv[ch]-th record (0 = never). Mode, fault causes and
+ *  the two duty compares are in every record. The caller then fills a
+ *  STREAM_Sample_t and calls STREAM_Push(), which packs and sends one frame.
+ *
+ *  Record payload (little endian):
+ *
+ *      u32 tick    sequence counter, MEAS_SAMPLE_RATE_HZ time base
+ *      u8  mode    AppMode_t
+ *      u8  faults  FAULT_CAUSE_x bits
+ *      u8  chMask  bit ch set: one u16 follows for channel ch, ascending
+ *      u8  lost    records dropped by the transport since the last one (saturating)
+ *      u16 ch[]    raw ADC codes
+ *      u16 buckCmp, boostCmp
+ *
+ *  STREAM_Configure() refuses a configuration whose average byte rate exceeds
+ *  STREAM_LINK_BUDGET_PCT of the UART, which shares the link with printf.
+ *  Packing/unpacking has no hardware dependency and builds on the host.
  */
 
 #ifndef APPLICATION_USER_USB_STREAM_H_
 #define APPLICATION_USER_USB_STREAM_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "com_gcom.h"
+#include "measurements.h"
+
+#define STREAM_LINK_BUDGET_PCT  80u
+#define STREAM_HEADER_BYTES     8u
+#define STREAM_TRAILER_BYTES    4u
+#define STREAM_MAX_PAYLOAD      (STREAM_HEADER_BYTES + (2u * MEAS_NUM_CH) + STREAM_TRAILER_BYTES)
+
+/* STREAM_Tick() result: record due, plus the channel mask in the low bits */
+#define STREAM_DUE              0x80u
+
+/* Default: 250 records/s, Vout in each, the other channels in every 4th */
+#define STREAM_DEFAULT_RECORD_DIV   125u
+#define STREAM_DEFAULT_CH_DIV       { 4u, 4u, 4u, 1u }
+
+typedef struct
+{
+    uint16_t recordDiv_u16;             /* sequences per record, >= 1 */
+    uint8_t  chDiv_u8[MEAS_NUM_CH];     /* records per channel value, 0 = off */
+} STREAM_Config_t;
+
+typedef struct
+{
+    uint16_t ch_u16[MEAS_NUM_CH];
+    uint16_t buckCmp_u16;
+    uint16_t boostCmp_u16;
+    uint8_t  mode_u8;
+    uint8_t  faults_u8;
+} STREAM_Sample_t;
+
+typedef struct
+{
+    uint32_t tick_u32;
+    uint8_t  mode_u8;
+    uint8_t  faults_u8;
+    uint8_t  chMask_u8;
+    uint8_t  lost_u8;
+    uint16_t ch_u16[MEAS_NUM_CH];       /* valid where chMask is set */
+    uint16_t buckCmp_u16;
+    uint16_t boostCmp_u16;
+} STREAM_Record_t;
+
+typedef struct
+{
+    uint32_t records_u32;
+    uint32_t dropped_u32;
+    uint32_t bytes_u32;
+} STREAM_Stats_t;
+
+void     STREAM_Init(const GCOM_Transport_t *tr);
+bool     STREAM_Configure(const STREAM_Config_t *cfg, uint32_t baud);
+void     STREAM_Enable(bool enable);
+bool     STREAM_IsEnabled(void);
+
+/* Interrupt side, once per ADC sequence */
+uint32_t STREAM_Tick(void);
+void     STREAM_Push(const STREAM_Sample_t *s, uint32_t due);
+
+/* Link budget */
+uint32_t STREAM_AvgFrameBytes_x100(const STREAM_Config_t *cfg);
+uint32_t STREAM_BytesPerSecond(const STREAM_Config_t *cfg);
+uint32_t STREAM_LinkBytesPerSecond(uint32_t baud);
+
+/* Packing, shared with the host decoder */
+uint32_t STREAM_Pack(const STREAM_Record_t *rec, uint8_t *out);
+bool     STREAM_Unpack(const uint8_t *payload, uint32_t len, STREAM_Record_t *rec);
 
+const STREAM_Stats_t *STREAM_GetStats(void);
 
 #endif /* APPLICATION_USER_USB_STREAM_H_ */
@@ -0,0 +1,126 @@
+/*
+ * voltage_ctrl.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ */
+
+#include "voltage_ctrl.h"
+
+/* PI tuned on the averaged buck-boost model of host/harness/buck_boost_model.c (Vin 5 V,
+ * L 4.7..22 uH, C 20..100 uF, 5..50 ohm, 50 mohm loss, compares applied one control
+ * period after the sample): no overshoot on a 3 V -> 8 V set-point step at any corner,
+ * twice this kp oscillates on the output LC resonance at 22 uH / 50 ohm
+ * (host/tests/test_voltage_ctrl.c).
+ * Gains in Q1.15 * 2^-VCTRL_PI_SHIFT (error normalized to the 12-bit full scale). */
+#define VCTRL_PI_SHIFT          2u
+#define VCTRL_PI_KP             ((int16_t)(0.20 * 32768 / 4))
+#define VCTRL_PI_KI             ((int16_t)(0.10 * 32768 / 4))
+
+static int32_t VCTRL_mVToCodeQ8(uint32_t vout_mV)
+{
+    /* code = mV * FS * DEN / (VDDA * NUM) */
+    const uint64_t num = (uint64_t)vout_mV * VCTRL_ADC_FS_COUNTS * VCTRL_VOUT_SCALE_DEN * 256u;
+    return (int32_t)(num / ((uint64_t)VCTRL_VDDA_mV * VCTRL_VOUT_SCALE_NUM));
+}
+
+void VCTRL_Init(VCTRL_t *vc, uint32_t period_u32)
+{
+    COMP_InitPI(&vc->comp, VCTRL_PI_KP, VCTRL_PI_KI, VCTRL_PI_SHIFT, VCTRL_M_MIN, VCTRL_M_MAX);
+    COMP_Reset(&vc->comp, VCTRL_M_MIN);
+
+    vc->period_u32   = period_u32;
+    vc->refQ8_s32    = 0;
+    vc->targetQ8_s32 = 0;
+    vc->m_s16        = VCTRL_M_MIN;
+    vc->region       = VCTRL_REGION_BUCK;
+    vc->stats        = (VCTRL_Stats_t){ 0 };
+    VCTRL_SetSlew_mV_per_ms(vc, VCTRL_SLEW_mV_PER_MS);
+}
+
+void VCTRL_SetSlew_mV_per_ms(VCTRL_t *vc, uint32_t slew_mV_per_ms)
+{
+    int32_t slew = VCTRL_mVToCodeQ8(slew_mV_per_ms * 1000u / VCTRL_FS_HZ);
+    vc->slewQ8_s32 = (slew > 0) ? slew : 1;
+}
+
+void VCTRL_SetTarget_mV(VCTRL_t *vc, uint32_t vout_mV)
+{
+    vc->targetQ8_s32 = VCTRL_mVToCodeQ8(vout_mV);
+}
+
+void VCTRL_Start(VCTRL_t *vc, uint16_t voutCode_u16, uint16_t vinCode_u16)
+{
+    /* Measured ratio Vout/Vin (different dividers), Q1.15 of m/2; the numerator needs
+     * 42 bits at full scale, the quotient (< 2^28) fits again */
+    int32_t m = VCTRL_M_MIN;
+    if (vinCode_u16 > 0u)
+    {
+        m = (int32_t)(((uint64_t)voutCode_u16 * VCTRL_VOUT_SCALE_NUM * VCTRL_VIN_SCALE_DEN * (uint64_t)VCTRL_M_ONE)
+                      / ((uint64_t)vinCode_u16 * VCTRL_VIN_SCALE_NUM * VCTRL_VOUT_SCALE_DEN));
+    }
+    if (m < VCTRL_M_MIN) m = VCTRL_M_MIN;
+    if (m > VCTRL_M_MAX) m = VCTRL_M_MAX;
+
+    COMP_Reset(&vc->comp, (int16_t)m);
+    vc->m_s16     = (int16_t)m;
+    vc->refQ8_s32 = (int32_t)voutCode_u16 << 8;
+}
+
+VCTRL_Duty_t VCTRL_RatioToDuty(const VCTRL_t *vc, int16_t m_s16)
+{
+    const uint32_t P = vc->period_u32;
+    VCTRL_Duty_t d;
+
+    if (m_s16 <= VCTRL_BUCK_DUTY_MAX)
+    {
+        d.buckCmp_u32  = ((uint32_t)m_s16 * P) >> 14;
+        d.boostCmp_u32 = P + 1u;                                    /* boost leg off */
+    }
+    else
+    {
+        d.buckCmp_u32  = ((uint32_t)VCTRL_BUCK_DUTY_MAX * P) >> 14;
+        d.boostCmp_u32 = ((uint32_t)VCTRL_BUCK_DUTY_MAX * P) / (uint32_t)m_s16;   /* P (1 - Dboost) */
+    }
+    d.adcTrigCmp_u32 = d.buckCmp_u32 / 2u;
+    return d;
+}
+
+VCTRL_Duty_t VCTRL_Step(VCTRL_t *vc, uint16_t voutCode_u16)
+{
+    /* Reference ramp (soft start / set-point change) */
+    if (vc->refQ8_s32 < vc->targetQ8_s32)
+    {
+        vc->refQ8_s32 += vc->slewQ8_s32;
+        if (vc->refQ8_s32 > vc->targetQ8_s32) vc->refQ8_s32 = vc->targetQ8_s32;
+    }
+    else if (vc->refQ8_s32 > vc->targetQ8_s32)
+    {
+        vc->refQ8_s32 -= vc->slewQ8_s32;
+        if (vc->refQ8_s32 < vc->targetQ8_s32) vc->refQ8_s32 = vc->targetQ8_s32;
+    }
+
+    /* Error in Q1.15 of the ADC full scale (12 bit << 3) */
+    int32_t e = ((vc->refQ8_s32 >> 8) - (int32_t)voutCode_u16) << 3;
+    if (e > INT16_MAX) e = INT16_MAX;
+    if (e < INT16_MIN) e = INT16_MIN;
+
+    vc->m_s16  = COMP_Step(&vc->comp, (int16_t)e);
+    vc->region = (vc->m_s16 > VCTRL_BUCK_DUTY_MAX) ? VCTRL_REGION_BUCK_BOOST : VCTRL_REGION_BUCK;
+
+    vc->stats.iterations_u32++;
+    if ((vc->m_s16 == vc->comp.uMin_s16) || (vc->m_s16 == vc->comp.uMax_s16))
+    {
+        vc->stats.saturated_u32++;
+    }
+    return VCTRL_RatioToDuty(vc, vc->m_s16);
+}
+
+void VCTRL_RecordCycles(VCTRL_t *vc, uint32_t cycles_u32)
+{
+    vc->stats.lastCycles_u32 = cycles_u32;
+    if (cycles_u32 > vc->stats.maxCycles_u32)
+    {
+        vc->stats.maxCycles_u32 = cycles_u32;
+    }
+}
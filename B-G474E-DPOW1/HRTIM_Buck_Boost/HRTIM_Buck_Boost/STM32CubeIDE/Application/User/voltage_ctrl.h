@@ -0,0 +1,93 @@
+/*
+ * voltage_ctrl.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Closed-loop output voltage control of the 4-switch buck-boost (HRTIM timer C = buck
+ *  leg, timer D = boost leg), executed once per HRTIM timer C repetition event.
+ *
+ *  The compensator (compensator.h) drives one continuous conversion ratio
+ *  m = Vout / Vin, Q1.15 with m/2 (VCTRL_M_ONE = 1.0), which is mapped to both legs:
+ *
+ *      m <= Dmax : buck        Dbuck = m,     boost leg off (no switching)
+ *      m >  Dmax : buck-boost  Dbuck = Dmax,  Dboost = 1 - Dmax/m
+ *
+ *  Both maps meet at m = Dmax, so crossing between buck and boost needs no mode
+ *  switch and no controller reset. Dmax < 1 keeps the buck leg out of 100 % duty.
+ *
+ *  The reference ramps towards the target (soft start, inrush limit); VCTRL_Start()
+ *  begins at the measured Vout with the measured ratio, so enabling the loop on a
+ *  charged output does not step the duty.
+ *
+ *  Pure computation: the ISR reads the injected ADC results and writes the compare
+ *  registers, so the exact same code runs against a plant model on a host.
+ */
+
+#ifndef APPLICATION_USER_VOLTAGE_CTRL_H_
+#define APPLICATION_USER_VOLTAGE_CTRL_H_
+
+#include <stdint.h>
+#include "compensator.h"
+
+/* Conversion ratio m in Q1.15 of m/2 */
+#define VCTRL_M_ONE             ((int16_t)16384)
+#define VCTRL_BUCK_DUTY_MAX     ((int16_t)14746)        /* Dmax = 0.90                     */
+#define VCTRL_M_MIN             ((int16_t)819)          /* 0.05                            */
+#define VCTRL_M_MAX             ((int16_t)(2 * 14746))  /* Dboost <= 50 %  ->  m <= 2 Dmax */
+
+/* Vout divider 13.3k / 3.3k (same as measurements.c), 12-bit ADC at 3.3 V */
+#define VCTRL_VDDA_mV           3300u
+#define VCTRL_ADC_FS_COUNTS     4095u
+#define VCTRL_VOUT_SCALE_NUM    503u
+#define VCTRL_VOUT_SCALE_DEN    100u
+#define VCTRL_VIN_SCALE_NUM     497u
+#define VCTRL_VIN_SCALE_DEN     100u
+
+/* Control rate = 250 kHz / (repetition counter 31 + 1) */
+#define VCTRL_FS_HZ             7812u
+#define VCTRL_SLEW_mV_PER_MS    100u                    /* default reference ramp           */
+
+typedef enum
+{
+    VCTRL_REGION_BUCK = 0,
+    VCTRL_REGION_BUCK_BOOST
+} VCTRL_Region_t;
+
+/* Compare values for one PWM update */
+typedef struct
+{
+    uint32_t buckCmp_u32;       /* timer C CMP1: buck leg duty            */
+    uint32_t adcTrigCmp_u32;    /* timer C CMP2: ADC trigger, mid on-time */
+    uint32_t boostCmp_u32;      /* timer D CMP1: boost leg (period + 1 = off) */
+} VCTRL_Duty_t;
+
+typedef struct
+{
+    uint32_t iterations_u32;
+    uint32_t saturated_u32;     /* steps with the ratio at a clamp        */
+    uint32_t lastCycles_u32;    /* ISR cost, filled by the caller (DWT)   */
+    uint32_t maxCycles_u32;
+} VCTRL_Stats_t;
+
+typedef struct
+{
+    COMP_t          comp;
+    uint32_t        period_u32;
+    int32_t         refQ8_s32;      /* ramped reference, Vout ADC codes Q8 */
+    int32_t         targetQ8_s32;
+    int32_t         slewQ8_s32;     /* reference step per control period   */
+    int16_t         m_s16;          /* last ratio                          */
+    VCTRL_Region_t  region;
+    VCTRL_Stats_t   stats;
+} VCTRL_t;
+
+void         VCTRL_Init(VCTRL_t *vc, uint32_t period_u32);
+void         VCTRL_SetTarget_mV(VCTRL_t *vc, uint32_t vout_mV);
+void         VCTRL_SetSlew_mV_per_ms(VCTRL_t *vc, uint32_t slew_mV_per_ms);
+void         VCTRL_Start(VCTRL_t *vc, uint16_t voutCode_u16, uint16_t vinCode_u16);
+VCTRL_Duty_t VCTRL_Step(VCTRL_t *vc, uint16_t voutCode_u16);
+VCTRL_Duty_t VCTRL_RatioToDuty(const VCTRL_t *vc, int16_t m_s16);
+void         VCTRL_RecordCycles(VCTRL_t *vc, uint32_t cycles_u32);
+
+#endif /* APPLICATION_USER_VOLTAGE_CTRL_H_ */
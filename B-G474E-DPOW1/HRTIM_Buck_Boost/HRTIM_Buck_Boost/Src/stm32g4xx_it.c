@@ -24,6 +24,17 @@
 /* USER CODE BEGIN Includes */
 #include "b_g474e_dpow1.h"
 #include "app.h"
+#include "voltage_ctrl.h"
+#include "motor_control.h"
+#include "measurements.h"
+#include "fault_mgr.h"
+#include "retarget.h"
+#include "usb_stream.h"
+#include "com_gcom.h"
+#include "scheduler.h"
+#include "encoders.h"
+#include "stm32g4xx_ll_adc.h"
+#include "stm32g4xx_ll_usart.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -204,49 +215,60 @@ void SysTick_Handler(void)
   */
 void HRTIM1_TIMC_IRQHandler(void)
 {
-  uint32_t CurrentDuty;
+  static AppMode_t lastMode = APP_MODE_DE_ENERGIZE;
+  const uint32_t startCycles = DWT->CYCCNT;
 
   /* Clear ISR flag */
   LL_HRTIM_ClearFlag_REP(HRTIM1, LL_HRTIM_TIMER_C);
 
-  switch(appMode)
+  /* Parameter block from the command interface, swapped in at the period boundary */
+  GCOM_ApplyPending();
+
+  /* Encoder position and speed for this control cycle */
+  const ENC_Snapshot_t *enc = ENC_Update();
+
+  /* One read of the mode per tick: the switch and the entry detection agree */
+  const AppMode_t mode = appMode;
+
+  switch(mode)
   {
   case APP_MODE_BUCK:
-	  HAL_GPIO_TogglePin(DBG_PA6_GPIO_Port, DBG_PA6_Pin);
-    /* Get current duty cycle value */
-    CurrentDuty = LL_HRTIM_TIM_GetCompare1(HRTIM1, LL_HRTIM_TIMER_C);
-    /* Increase the compare value up to 60% duty cycle and re-start from 33% */
-    if (CurrentDuty > (6 * BUCK_PWM_PERIOD)/10)
-    {
-      LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_C, BUCK_PWM_PERIOD/3);
-      LL_HRTIM_TIM_SetCompare2(HRTIM1, LL_HRTIM_TIMER_C, BUCK_PWM_PERIOD/6);
-    }
-    else  /* Re-start ramp from 33% duty cycle */
+  case APP_MODE_BOOST:
+  {
+    /* Closed loop: one controller for both legs, BUCK/BOOST only select the set-point */
+    HAL_GPIO_TogglePin(DBG_PA6_GPIO_Port, DBG_PA6_Pin);
+    const uint16_t voutCode = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_4);
+    if ((lastMode != APP_MODE_BUCK) && (lastMode != APP_MODE_BOOST))
     {
-      /* Update duty cycle (CMP1) and ADC triggering point (CMP2)*/
-      CurrentDuty++;
-      LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_C, CurrentDuty);
-      LL_HRTIM_TIM_SetCompare2(HRTIM1, LL_HRTIM_TIMER_C, CurrentDuty/2);
+      /* Entering regulation: start bumpless from the present output */
+      VCTRL_Start(&appVctrl, voutCode, (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_2));
     }
-    /* BOOST side PMOS turned ON permanently */
-    LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_D, BUCK_PWM_PERIOD+1);
+    const VCTRL_Duty_t duty = VCTRL_Step(&appVctrl, voutCode);
+    /* Update duty cycles (CMP1) and ADC triggering point (CMP2), applied on the next repetition update */
+    LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_C, duty.buckCmp_u32);
+    LL_HRTIM_TIM_SetCompare2(HRTIM1, LL_HRTIM_TIMER_C, duty.adcTrigCmp_u32);
+    LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_D, duty.boostCmp_u32);
     break;
-
-  case APP_MODE_BOOST:
-    /* BUCK side PMOS turned ON permanently */
-    LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_C, BUCK_PWM_PERIOD);
-    
-    /* Get current boost duty cycle value */
-    CurrentDuty = LL_HRTIM_TIM_GetCompare1(HRTIM1,  LL_HRTIM_TIMER_D);
-    // Slowly increase boost factor to limit inrush current (Boost factor is 1/CurrentDuty)
-    CurrentDuty -= 0x400;
-    /* Increase boost factor up to 50% */
-    if (CurrentDuty >= (BUCK_PWM_PERIOD/2) + 1 )
+  }
+  case APP_MODE_MOTOR:
+  {
+    /* Speed loop on the encoder, current loop on I_IN_SENSE, same compares as the voltage loop */
+    const MCTRL_Input_t in = {
+      .iCode_u16    = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_1),
+      .vinCode_u16  = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_2),
+      .voutCode_u16 = (uint16_t)LL_ADC_INJ_ReadConversionData12(ADC1, LL_ADC_INJ_RANK_4),
+      .speed_cps_q8 = enc->speed_cps_q8
+    };
+    if (lastMode != APP_MODE_MOTOR)
     {
-      LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_D, CurrentDuty);
+      MCTRL_Start(&appMctrl, &in);
     }
+    const VCTRL_Duty_t duty = MCTRL_Step(&appMctrl, &in);
+    LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_C, duty.buckCmp_u32);
+    LL_HRTIM_TIM_SetCompare2(HRTIM1, LL_HRTIM_TIMER_C, duty.adcTrigCmp_u32);
+    LL_HRTIM_TIM_SetCompare1(HRTIM1, LL_HRTIM_TIMER_D, duty.boostCmp_u32);
     break;
-
+  }
   case APP_MODE_FAULT:
   case APP_MODE_DE_ENERGIZE:
     /* BUCK side NMOS turned ON permanently */
@@ -264,5 +286,78 @@ void HRTIM1_TIMC_IRQHandler(void)
                             | LL_HRTIM_OUTPUT_TD2);
     break;
   }
+
+  lastMode = mode;
+  if (mode == APP_MODE_MOTOR)
+  {
+    MCTRL_RecordCycles(&appMctrl, DWT->CYCCNT - startCycles);
+  }
+  else
+  {
+    VCTRL_RecordCycles(&appVctrl, DWT->CYCCNT - startCycles);
+  }
+}
+
+/**
+  * @brief  This function handles ADC1 and ADC2 global interrupt.
+  *         ADC1 injected end of sequence: one HRTIM-triggered measurement set,
+  *         checked against the protection limits right away.
+  */
+void ADC1_2_IRQHandler(void)
+{
+  const uint32_t entryCycles = DWT->CYCCNT;
+  uint16_t raw[MEAS_NUM_CH];
+
+  if (MEAS_InjectedIRQHandler(raw))
+  {
+    FAULT_CheckSample(raw, HAL_GetTick(), entryCycles);
+
+    /* Telemetry record, after the protection so it never delays a trip */
+    const uint32_t due = STREAM_Tick();
+    if (due != 0u)
+    {
+      STREAM_Sample_t sample;
+      for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+      {
+        sample.ch_u16[ch] = raw[ch];
+      }
+      sample.buckCmp_u16  = (uint16_t)LL_HRTIM_TIM_GetCompare1(HRTIM1, LL_HRTIM_TIMER_C);
+      sample.boostCmp_u16 = (uint16_t)LL_HRTIM_TIM_GetCompare1(HRTIM1, LL_HRTIM_TIMER_D);
+      sample.mode_u8      = (uint8_t)appMode;
+      sample.faults_u8    = (uint8_t)FAULT_GetCauses();
+      STREAM_Push(&sample, due);
+    }
+  }
+  MEAS_CurrentAdcIRQHandler();
+}
+
+/**
+  * @brief  This function handles DMA1 channel1 global interrupt (ADC2 current samples).
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  MEAS_CurrentDmaIRQHandler();
+}
+
+/**
+  * @brief  This function handles USART3 global interrupt (command RX, printf TX FIFO refill).
+  */
+void USART3_IRQHandler(void)
+{
+  /* Command bytes into the GCOM queue, parsed by GCOM_Task() in the main loop */
+  if (LL_USART_IsActiveFlag_RXNE_RXFNE(USART3))
+  {
+    do
+    {
+      GCOM_RxPush(LL_USART_ReceiveData8(USART3));
+    } while (LL_USART_IsActiveFlag_RXNE_RXFNE(USART3));
+    SCHED_SetEvent(APP_TASK_TELEMETRY);
+  }
+  if (LL_USART_IsActiveFlag_ORE(USART3))
+  {
+    LL_USART_ClearFlag_ORE(USART3);
+  }
+
+  RetargetIRQHandler();
 }
 /* USER CODE END 1 */
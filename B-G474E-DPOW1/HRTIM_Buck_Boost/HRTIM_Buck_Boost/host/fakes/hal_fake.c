@@ -0,0 +1,375 @@
+/*
+ * hal_fake.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Host implementation of the HAL calls the application uses. See hal_fake.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/mman.h>
+
+#include "hal_fake.h"
+
+#define HAL_FAKE_NUM_IRQ        128U
+
+DWT_Type            hal_fake_dwt;
+GPIO_TypeDef        hal_fake_gpio[3];
+ADC_TypeDef         hal_fake_adc[2];
+DMA_Channel_TypeDef hal_fake_dma1_ch[8];
+USART_TypeDef       hal_fake_usart[4];
+TIM_TypeDef         hal_fake_tim[2];
+uint32_t            SystemCoreClock = 170000000U;
+
+static uint8_t  nvicPriority_u8[HAL_FAKE_NUM_IRQ];
+static bool     nvicEnabled[HAL_FAKE_NUM_IRQ];
+static uint8_t *flash;
+static uint32_t primask_u32;
+static void   (*pendedIrq)(void);
+static uint32_t apsrGe_u32;         /* GE[3:0], one bit per byte lane */
+static uint32_t tick_u32;
+static void   (*tickHook)(void);
+
+/* TX FIFO of the USART in FIFO mode, slots in its TDR_fifo */
+static USART_TypeDef *fifoUsart;
+static uint32_t fifoThreshold_u32;      /* interrupt at or below this many bytes */
+static uint32_t fifoRd_u32;
+static uint32_t fifoLevel_u32;
+static uint32_t fifoLost_u32;
+
+/* Mapped before main() so the first read of a fixed address already finds it */
+__attribute__((constructor)) static void hal_fake_flash_map(void)
+{
+    void *p = mmap((void *)(uintptr_t)HAL_FAKE_FLASH_BASE, HAL_FAKE_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (p != (void *)(uintptr_t)HAL_FAKE_FLASH_BASE)
+    {
+        fprintf(stderr, "hal_fake: cannot map the flash at 0x%08X\n", HAL_FAKE_FLASH_BASE);
+        exit(2);
+    }
+    flash = p;
+    hal_fake_flash_erase();
+}
+
+void hal_fake_reset(void)
+{
+    memset(&hal_fake_dwt, 0, sizeof(hal_fake_dwt));
+    memset(hal_fake_gpio, 0, sizeof(hal_fake_gpio));
+    memset(hal_fake_adc, 0, sizeof(hal_fake_adc));
+    memset(hal_fake_dma1_ch, 0, sizeof(hal_fake_dma1_ch));
+    memset(nvicPriority_u8, 0, sizeof(nvicPriority_u8));
+    memset(nvicEnabled, 0, sizeof(nvicEnabled));
+    memset(hal_fake_usart, 0, sizeof(hal_fake_usart));
+    memset(hal_fake_tim, 0, sizeof(hal_fake_tim));
+    fifoUsart     = NULL;
+    fifoRd_u32    = 0U;
+    fifoLevel_u32 = 0U;
+    fifoLost_u32  = 0U;
+    tick_u32      = 0U;
+    tickHook      = NULL;
+    pendedIrq     = NULL;
+    __set_PRIMASK(0U);
+    hal_fake_flash_erase();
+}
+
+/* --- Flash --- */
+
+void *hal_fake_flash(uint32_t addr)
+{
+    if ((addr < HAL_FAKE_FLASH_BASE) || ((addr - HAL_FAKE_FLASH_BASE) >= HAL_FAKE_FLASH_SIZE))
+        return NULL;
+    return &flash[addr - HAL_FAKE_FLASH_BASE];
+}
+
+void hal_fake_flash_erase(void)
+{
+    memset(flash, 0xFF, HAL_FAKE_FLASH_SIZE);
+}
+
+/* --- ADC --- */
+
+void hal_fake_adc_inject(ADC_TypeDef *adc, const uint16_t raw_u16[4])
+{
+    for (uint32_t r = 0U; r < 4U; r++)
+    {
+        adc->JDR[r] = raw_u16[r];
+    }
+    adc->ISR |= ADC_ISR_JEOS;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    (void)hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    (void)hadc;
+    (void)sConfig;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff)
+{
+    (void)hadc;
+    (void)SingleDiff;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+    (void)pData;
+    if (hadc->DMA_Handle != NULL)
+    {
+        hadc->DMA_Handle->Instance->CNDTR = Length;
+    }
+    return HAL_OK;
+}
+
+/* --- DMA --- */
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+    return HAL_OK;
+}
+
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+}
+
+/* --- NVIC --- */
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    (void)SubPriority;
+    nvicPriority_u8[IRQn] = (uint8_t)PreemptPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    nvicEnabled[IRQn] = true;
+}
+
+uint32_t hal_fake_nvic_priority(IRQn_Type irq)
+{
+    return nvicPriority_u8[irq];
+}
+
+bool hal_fake_nvic_enabled(IRQn_Type irq)
+{
+    return nvicEnabled[irq];
+}
+
+/* --- PRIMASK --- */
+
+static void hal_fake_irq_take(void)
+{
+    void (*fn)(void) = pendedIrq;
+
+    if ((fn != NULL) && (primask_u32 == 0U))
+    {
+        pendedIrq = NULL;
+        fn();
+    }
+}
+
+void hal_fake_irq_pend(void (*fn)(void))
+{
+    pendedIrq = fn;
+}
+
+void hal_fake_barrier(void)
+{
+    __sync_synchronize();
+    hal_fake_irq_take();
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return primask_u32;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    sigset_t alarm;
+
+    sigemptyset(&alarm);
+    sigaddset(&alarm, SIGALRM);
+    primask_u32 = priMask & 1U;
+    sigprocmask((primask_u32 != 0U) ? SIG_BLOCK : SIG_UNBLOCK, &alarm, NULL);
+    hal_fake_irq_take();
+}
+
+void __disable_irq(void)
+{
+    __set_PRIMASK(1U);
+}
+
+void __enable_irq(void)
+{
+    __set_PRIMASK(0U);
+}
+
+/* --- DSP extension --- */
+
+uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+    const int32_t lo = (int32_t)(int16_t)op1 * (int16_t)op2;
+    const int32_t hi = (int32_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16);
+    return op3 + (uint32_t)lo + (uint32_t)hi;
+}
+
+uint64_t __SMLALD(uint32_t op1, uint32_t op2, uint64_t acc)
+{
+    const int64_t lo = (int64_t)(int16_t)op1 * (int16_t)op2;
+    const int64_t hi = (int64_t)(int16_t)(op1 >> 16) * (int16_t)(op2 >> 16);
+    return acc + (uint64_t)lo + (uint64_t)hi;
+}
+
+uint32_t __USUB16(uint32_t op1, uint32_t op2)
+{
+    const uint32_t lo = (op1 & 0xFFFFU) - (op2 & 0xFFFFU);
+    const uint32_t hi = (op1 >> 16) - (op2 >> 16);
+
+    apsrGe_u32 = (((op1 & 0xFFFFU) >= (op2 & 0xFFFFU)) ? 0x3U : 0U) | (((op1 >> 16) >= (op2 >> 16)) ? 0xCU : 0U);
+    return (lo & 0xFFFFU) | (hi << 16);
+}
+
+uint32_t __SEL(uint32_t op1, uint32_t op2)
+{
+    uint32_t mask = 0U;
+
+    for (uint32_t b = 0U; b < 4U; b++)
+    {
+        if ((apsrGe_u32 & (1U << b)) != 0U)
+            mask |= 0xFFU << (8U * b);
+    }
+    return (op1 & mask) | (op2 & ~mask);
+}
+
+/* --- GPIO --- */
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET)
+        GPIOx->ODR |= GPIO_Pin;
+    else
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+/* --- DWT --- */
+
+void hal_fake_cycles(uint32_t cycles)
+{
+    hal_fake_dwt.CYCCNT += cycles;
+}
+
+/* --- SysTick --- */
+
+uint32_t HAL_GetTick(void)
+{
+    if (tickHook != NULL)
+        tickHook();
+    return tick_u32;
+}
+
+void hal_fake_tick(uint32_t ms)
+{
+    tick_u32 += ms;
+}
+
+void hal_fake_tick_hook(void (*fn)(void))
+{
+    tickHook = fn;
+}
+
+/* --- USART --- */
+
+HAL_StatusTypeDef HAL_UARTEx_SetTxFifoThreshold(UART_HandleTypeDef *huart, uint32_t Threshold)
+{
+    static const uint8_t bytes_u8[6] = { 1U, 2U, 4U, 6U, 7U, 8U };
+
+    (void)huart;
+    fifoThreshold_u32 = bytes_u8[(Threshold >> 29) % 6U];
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_EnableFifoMode(UART_HandleTypeDef *huart)
+{
+    fifoUsart     = huart->Instance;
+    fifoRd_u32    = 0U;
+    fifoLevel_u32 = 0U;
+    fifoUsart->ISR |= USART_ISR_TXE_TXFNF | USART_ISR_TC;
+    return HAL_OK;
+}
+
+USART_TypeDef *hal_fake_usart_fifo_mode(void)
+{
+    return fifoUsart;
+}
+
+uint32_t hal_fake_usart_tdr(void)
+{
+    if ((fifoUsart == NULL) || (fifoLevel_u32 >= HAL_FAKE_USART_FIFO))
+    {
+        fifoLost_u32++;
+        return HAL_FAKE_USART_FIFO;
+    }
+
+    const uint32_t slot = (fifoRd_u32 + fifoLevel_u32) % HAL_FAKE_USART_FIFO;
+    fifoLevel_u32++;
+    fifoUsart->ISR &= ~USART_ISR_TC;
+    if (fifoLevel_u32 == HAL_FAKE_USART_FIFO)
+        fifoUsart->ISR &= ~USART_ISR_TXE_TXFNF;
+    return slot;
+}
+
+uint32_t hal_fake_usart_shift(uint32_t n, uint8_t *out)
+{
+    uint32_t sent = 0U;
+
+    if (fifoUsart == NULL)
+        return 0U;
+    while ((sent < n) && (fifoLevel_u32 > 0U))
+    {
+        if (out != NULL)
+            out[sent] = (uint8_t)fifoUsart->TDR_fifo[fifoRd_u32];
+        fifoRd_u32 = (fifoRd_u32 + 1U) % HAL_FAKE_USART_FIFO;
+        fifoLevel_u32--;
+        sent++;
+    }
+    fifoUsart->ISR |= USART_ISR_TXE_TXFNF;
+    if (fifoLevel_u32 == 0U)
+        fifoUsart->ISR |= USART_ISR_TC;
+    return sent;
+}
+
+uint32_t hal_fake_usart_level(void)
+{
+    return fifoLevel_u32;
+}
+
+bool hal_fake_usart_txft_pending(void)
+{
+    return (fifoUsart != NULL) && ((fifoUsart->CR3 & USART_CR3_TXFTIE) != 0U) &&
+           (fifoLevel_u32 <= fifoThreshold_u32);
+}
+
+uint32_t hal_fake_usart_lost(void)
+{
+    return fifoLost_u32;
+}
@@ -0,0 +1,73 @@
+/*
+ * hal_fake.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Test side of the host HAL (hal_fake.c).
+ *
+ *      Flash : the 512 KB of the STM32G474RE mapped at its real address (0x08000000),
+ *              erased (0xFF), so records read through fixed addresses work unchanged.
+ *      ADC   : injected data registers and flags of ADC1/ADC2, loaded by the tests.
+ *      NVIC  : priorities and enables as the code set them; PRIMASK masks SIGALRM,
+ *              the signal the tests raise as an interrupt, and holds back an
+ *              interrupt a test pends at an exact point (hal_fake_irq_pend()).
+ *      DWT   : CYCCNT only moves when a test advances it.
+ *      TIM   : TIM3/TIM4 registers the tests load as the encoder and its edge capture.
+ *      USART : TX FIFO of the USART in FIFO mode; the tests shift it out (the wire)
+ *              and raise the FIFO threshold interrupt themselves.
+ *      Tick  : HAL_GetTick() returns a counter the tests advance, optionally from a
+ *              hook run on every call (time passing in a polling loop).
+ *      DSP   : SMLAD / SMLALD / USUB16 / SEL with the GE flags, for the test that
+ *              builds the __ARM_FEATURE_DSP path of measurements.c.
+ */
+
+#ifndef HOST_FAKES_HAL_FAKE_H_
+#define HOST_FAKES_HAL_FAKE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stm32g4xx_hal.h"
+
+#define HAL_FAKE_FLASH_BASE     0x08000000U
+#define HAL_FAKE_FLASH_SIZE     0x00080000U
+
+/** @brief Reset the registers, the NVIC table and the cycle counter, erase the flash */
+void hal_fake_reset(void);
+
+/* --- Flash --- */
+/* Writable view of the flash at addr, NULL outside of it */
+void    *hal_fake_flash(uint32_t addr);
+void     hal_fake_flash_erase(void);
+
+/* --- ADC --- */
+/* Load the four injected ranks and raise JEOS, as at the end of a sequence */
+void     hal_fake_adc_inject(ADC_TypeDef *adc, const uint16_t raw_u16[4]);
+
+/* --- NVIC --- */
+uint32_t hal_fake_nvic_priority(IRQn_Type irq);
+bool     hal_fake_nvic_enabled(IRQn_Type irq);
+
+/* Run fn once as an interrupt: at the next __DMB() or PRIMASK release with PRIMASK clear */
+void     hal_fake_irq_pend(void (*fn)(void));
+
+/* --- DWT --- */
+void     hal_fake_cycles(uint32_t cycles);
+
+/* --- SysTick --- */
+void     hal_fake_tick(uint32_t ms);
+/* fn (may be NULL) runs on every HAL_GetTick() call, before the counter is read */
+void     hal_fake_tick_hook(void (*fn)(void));
+
+/* --- USART --- */
+/* Send up to n bytes from the TX FIFO into out (may be NULL); returns the count */
+uint32_t hal_fake_usart_shift(uint32_t n, uint8_t *out);
+uint32_t hal_fake_usart_level(void);
+/* TXFTIE set and the FIFO at or below the threshold: the interrupt is pending */
+bool     hal_fake_usart_txft_pending(void);
+/* Bytes written to TDR while the FIFO was full */
+uint32_t hal_fake_usart_lost(void);
+USART_TypeDef *hal_fake_usart_fifo_mode(void);
+
+#endif /* HOST_FAKES_HAL_FAKE_H_ */
@@ -0,0 +1,24 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Host stand-in for Inc/main.h: the board constants of the application on top of
+ *  the host HAL (stm32g4xx_hal.h in this directory).
+ */
+
+#ifndef HOST_FAKES_MAIN_H_
+#define HOST_FAKES_MAIN_H_
+
+#include <stdint.h>
+#include "stm32g4xx_hal.h"
+
+#define DBG_PA6_Pin GPIO_PIN_6
+#define DBG_PA6_GPIO_Port GPIOA
+#define DBG1_PB0_Pin GPIO_PIN_0
+#define DBG1_PB0_GPIO_Port GPIOB
+
+#define BUCK_PWM_PERIOD ((uint16_t)21760) // 250kHz
+
+#endif /* HOST_FAKES_MAIN_H_ */
@@ -0,0 +1,336 @@
+/*
+ * stm32g4xx_hal.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Host stand-in for the STM32G4 HAL and the CMSIS core: only the types, constants
+ *  and calls the application code uses. Registers are plain structs the tests can
+ *  set; the calls are implemented in hal_fake.c (test side in hal_fake.h).
+ */
+
+#ifndef HOST_FAKES_STM32G4XX_HAL_H_
+#define HOST_FAKES_STM32G4XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    DISABLE = 0,
+    ENABLE  = 1
+} FunctionalState;
+
+#define __IO                volatile
+
+#define SET_BIT(REG, BIT)   ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+
+/* SysTick: the tests move the millisecond, see hal_fake_tick() */
+uint32_t HAL_GetTick(void);
+
+/* --- CMSIS core --- */
+
+/* A signal handler stands in for the ISRs: a compiler barrier is what matters.
+ * __DMB() is also a point where an interrupt pended by a test runs if PRIMASK allows
+ * (hal_fake_irq_pend()), the instruction boundary the code marks itself. */
+void hal_fake_barrier(void);
+#define __DMB()             hal_fake_barrier()
+#define __DSB()             __sync_synchronize()
+#define __ISB()             __sync_synchronize()
+#define __CLZ(x)            (((x) == 0U) ? 32U : (uint32_t)__builtin_clz(x))
+
+/* PRIMASK blocks SIGALRM, the interrupt of the host tests (hal_fake.c) */
+uint32_t __get_PRIMASK(void);
+void     __set_PRIMASK(uint32_t priMask);
+void     __disable_irq(void);
+void     __enable_irq(void);
+
+/* DSP extension of the M4, for the test that builds the __ARM_FEATURE_DSP path of the
+ * application on the host. Bit exact, including the APSR.GE flags USUB16 leaves for SEL. */
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3);
+uint64_t __SMLALD(uint32_t op1, uint32_t op2, uint64_t acc);
+uint32_t __USUB16(uint32_t op1, uint32_t op2);
+uint32_t __SEL(uint32_t op1, uint32_t op2);
+#endif
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;           /* advanced by the tests, see hal_fake_cycles() */
+} DWT_Type;
+
+extern DWT_Type hal_fake_dwt;
+#define DWT                 (&hal_fake_dwt)
+
+typedef enum
+{
+    ADC1_2_IRQn         = 18,
+    DMA1_Channel1_IRQn  = 11,
+    USART1_IRQn         = 37,
+    USART2_IRQn         = 38,
+    USART3_IRQn         = 39,
+    LPUART1_IRQn        = 91,
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+/* --- GPIO --- */
+typedef struct
+{
+    __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0          ((uint16_t)0x0001)
+#define GPIO_PIN_6          ((uint16_t)0x0040)
+#define GPIO_PIN_7          ((uint16_t)0x0080)
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+    uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+#define GPIO_MODE_AF_PP         0x00000002U
+#define GPIO_PULLUP             0x00000001U
+#define GPIO_SPEED_FREQ_LOW     0x00000000U
+#define GPIO_AF2_TIM3           ((uint8_t)0x02)
+
+extern GPIO_TypeDef hal_fake_gpio[3];
+#define GPIOA               (&hal_fake_gpio[0])
+#define GPIOB               (&hal_fake_gpio[1])
+#define GPIOC               (&hal_fake_gpio[2])
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+
+/* --- TIM --- */
+/* Registers only: nothing counts by itself. The tests play the timers, loading CNT,
+ * CCR1 and SR as the encoder and the capture would; reading CCR1 does not clear
+ * CC1IF here, the tests clear it after the read. */
+typedef struct
+{
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t SMCR;
+    __IO uint32_t SR;
+    __IO uint32_t EGR;
+    __IO uint32_t CCMR1;
+    __IO uint32_t CCER;
+    __IO uint32_t CNT;
+    __IO uint32_t PSC;
+    __IO uint32_t ARR;
+    __IO uint32_t CCR1;
+} TIM_TypeDef;
+
+extern TIM_TypeDef hal_fake_tim[2];
+#define TIM3                (&hal_fake_tim[0])
+#define TIM4                (&hal_fake_tim[1])
+
+#define TIM_CR1_CEN         0x00000001U
+#define TIM_CR2_MMS_3       0x02000000U
+#define TIM_SMCR_SMS_0      0x00000001U
+#define TIM_SMCR_SMS_1      0x00000002U
+#define TIM_SMCR_TS_1       0x00000020U
+#define TIM_SR_CC1IF        0x00000002U
+#define TIM_EGR_UG          0x00000001U
+#define TIM_CCMR1_CC1S_0    0x00000001U
+#define TIM_CCMR1_CC1S_1    0x00000002U
+#define TIM_CCMR1_CC2S_0    0x00000100U
+#define TIM_CCMR1_IC1F_Pos  4U
+#define TIM_CCMR1_IC2F_Pos  12U
+#define TIM_CCER_CC1E       0x00000001U
+
+/* --- DMA --- */
+typedef struct
+{
+    __IO uint32_t CNDTR;            /* transfers left in the current cycle */
+} DMA_Channel_TypeDef;
+
+extern DMA_Channel_TypeDef hal_fake_dma1_ch[8];
+#define DMA1_Channel1       (&hal_fake_dma1_ch[0])
+
+typedef struct
+{
+    uint32_t Request;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef struct
+{
+    DMA_Channel_TypeDef *Instance;
+    DMA_InitTypeDef      Init;
+    void                *Parent;
+} DMA_HandleTypeDef;
+
+#define DMA_REQUEST_ADC2            36U
+#define DMA_PERIPH_TO_MEMORY        0x00000000U
+#define DMA_PINC_DISABLE            0x00000000U
+#define DMA_MINC_ENABLE             0x00000080U
+#define DMA_PDATAALIGN_HALFWORD     0x00000100U
+#define DMA_MDATAALIGN_HALFWORD     0x00000400U
+#define DMA_CIRCULAR                0x00000020U
+#define DMA_PRIORITY_HIGH           0x00002000U
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__)   ((__HANDLE__)->Instance->CNDTR)
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+/* --- ADC --- */
+typedef struct
+{
+    __IO uint32_t ISR;
+    __IO uint32_t IER;
+    __IO uint32_t JDR[4];
+} ADC_TypeDef;
+
+#define ADC_ISR_OVR         0x00000010U
+#define ADC_ISR_JEOS        0x00000040U
+#define ADC_IER_JEOSIE      0x00000040U
+
+extern ADC_TypeDef hal_fake_adc[2];
+#define ADC1                (&hal_fake_adc[0])
+#define ADC2                (&hal_fake_adc[1])
+
+typedef struct
+{
+    uint32_t ClockPrescaler;
+    uint32_t Resolution;
+    uint32_t DataAlign;
+    uint32_t GainCompensation;
+    uint32_t ScanConvMode;
+    uint32_t EOCSelection;
+    FunctionalState LowPowerAutoWait;
+    FunctionalState ContinuousConvMode;
+    uint32_t NbrOfConversion;
+    FunctionalState DiscontinuousConvMode;
+    uint32_t ExternalTrigConv;
+    uint32_t ExternalTrigConvEdge;
+    FunctionalState DMAContinuousRequests;
+    uint32_t Overrun;
+    FunctionalState OversamplingMode;
+} ADC_InitTypeDef;
+
+typedef struct
+{
+    ADC_TypeDef       *Instance;
+    ADC_InitTypeDef    Init;
+    DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+    uint32_t SingleDiff;
+    uint32_t OffsetNumber;
+    uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+#define ADC_CLOCK_SYNC_PCLK_DIV4        0x00030000U
+#define ADC_RESOLUTION_12B              0x00000000U
+#define ADC_DATAALIGN_RIGHT             0x00000000U
+#define ADC_SCAN_DISABLE                0x00000000U
+#define ADC_EOC_SINGLE_CONV             0x00000004U
+#define ADC_SOFTWARE_START              0x00000001U
+#define ADC_EXTERNALTRIGCONVEDGE_NONE   0x00000000U
+#define ADC_OVR_DATA_OVERWRITTEN        0x00001000U
+#define ADC_CHANNEL_1                   0x04300002U
+#define ADC_REGULAR_RANK_1              0x00000006U
+#define ADC_SAMPLETIME_47CYCLES_5       0x00000004U
+#define ADC_SINGLE_ENDED                0x0000007FU
+#define ADC_OFFSET_NONE                 0x00000004U
+
+#define __HAL_LINKDMA(__HANDLE__, __PPP_DMA_FIELD__, __DMA_HANDLE__) \
+    do {                                                             \
+        (__HANDLE__)->__PPP_DMA_FIELD__ = &(__DMA_HANDLE__);         \
+        (__DMA_HANDLE__).Parent = (__HANDLE__);                      \
+    } while (0)
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t SingleDiff);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+/* --- USART --- */
+#define HAL_FAKE_USART_FIFO     8U
+
+/* On the part TDR feeds the 8 byte TX FIFO. Here every write to TDR goes to the next
+ * slot of TDR_fifo (hal_fake_usart_tdr()), so the bytes a drain loop stores are kept
+ * in order and TXFNF drops when the FIFO is full. Only the USART in FIFO mode is
+ * modelled; slot HAL_FAKE_USART_FIFO takes writes to a full FIFO (lost bytes). */
+typedef struct
+{
+    __IO uint32_t CR3;
+    __IO uint32_t ISR;
+    __IO uint32_t TDR_fifo[HAL_FAKE_USART_FIFO + 1U];
+} USART_TypeDef;
+
+uint32_t hal_fake_usart_tdr(void);
+#define TDR                 TDR_fifo[hal_fake_usart_tdr()]
+
+#define USART_ISR_TC        0x00000040U
+#define USART_ISR_TXE_TXFNF 0x00000080U
+#define USART_CR3_TXFTIE    0x00800000U
+
+extern USART_TypeDef hal_fake_usart[4];
+#define USART1              (&hal_fake_usart[0])
+#define USART2              (&hal_fake_usart[1])
+#define USART3              (&hal_fake_usart[2])
+#define LPUART1             (&hal_fake_usart[3])
+
+typedef struct
+{
+    USART_TypeDef *Instance;
+} UART_HandleTypeDef;
+
+#define UART_TXFIFO_THRESHOLD_1_8   0x00000000U
+#define UART_TXFIFO_THRESHOLD_1_4   0x20000000U
+#define UART_TXFIFO_THRESHOLD_1_2   0x40000000U
+#define UART_TXFIFO_THRESHOLD_3_4   0x60000000U
+#define UART_TXFIFO_THRESHOLD_7_8   0x80000000U
+#define UART_TXFIFO_THRESHOLD_8_8   0xA0000000U
+
+HAL_StatusTypeDef HAL_UARTEx_SetTxFifoThreshold(UART_HandleTypeDef *huart, uint32_t Threshold);
+HAL_StatusTypeDef HAL_UARTEx_EnableFifoMode(UART_HandleTypeDef *huart);
+
+/* --- RCC --- */
+#define __HAL_RCC_DMAMUX1_CLK_ENABLE()  do { } while (0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()     do { } while (0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()    do { } while (0)
+#define __HAL_RCC_TIM3_CLK_ENABLE()     do { } while (0)
+#define __HAL_RCC_TIM4_CLK_ENABLE()     do { } while (0)
+
+extern uint32_t SystemCoreClock;
+
+#endif /* HOST_FAKES_STM32G4XX_HAL_H_ */
@@ -0,0 +1,51 @@
+/*
+ * stm32g4xx_ll_adc.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Host stand-in for the LL ADC calls of measurements.c, on the register structs of
+ *  stm32g4xx_hal.h. hal_fake_adc_inject() loads a sequence and raises JEOS.
+ */
+
+#ifndef HOST_FAKES_STM32G4XX_LL_ADC_H_
+#define HOST_FAKES_STM32G4XX_LL_ADC_H_
+
+#include "stm32g4xx_hal.h"
+
+#define LL_ADC_INJ_RANK_1       0U
+#define LL_ADC_INJ_RANK_2       1U
+#define LL_ADC_INJ_RANK_3       2U
+#define LL_ADC_INJ_RANK_4       3U
+
+static inline uint32_t LL_ADC_IsActiveFlag_JEOS(ADC_TypeDef *ADCx)
+{
+    return ((ADCx->ISR & ADC_ISR_JEOS) != 0U) ? 1U : 0U;
+}
+
+static inline void LL_ADC_ClearFlag_JEOS(ADC_TypeDef *ADCx)
+{
+    ADCx->ISR &= ~ADC_ISR_JEOS;
+}
+
+static inline void LL_ADC_EnableIT_JEOS(ADC_TypeDef *ADCx)
+{
+    ADCx->IER |= ADC_IER_JEOSIE;
+}
+
+static inline uint32_t LL_ADC_IsActiveFlag_OVR(ADC_TypeDef *ADCx)
+{
+    return ((ADCx->ISR & ADC_ISR_OVR) != 0U) ? 1U : 0U;
+}
+
+static inline void LL_ADC_ClearFlag_OVR(ADC_TypeDef *ADCx)
+{
+    ADCx->ISR &= ~ADC_ISR_OVR;
+}
+
+static inline uint32_t LL_ADC_INJ_ReadConversionData12(ADC_TypeDef *ADCx, uint32_t Rank)
+{
+    return ADCx->JDR[Rank] & 0x0FFFU;
+}
+
+#endif /* HOST_FAKES_STM32G4XX_LL_ADC_H_ */
@@ -0,0 +1,98 @@
+/*
+ * buck_boost_model.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ */
+
+#include "buck_boost_model.h"
+
+#include <time.h>
+
+uint16_t BBMODEL_AdcCode(double v_V, uint32_t scaleNum, uint32_t scaleDen)
+{
+    /* code = V / (NUM/DEN) / VDDA * FS, rounded and clamped like the ADC */
+    const double code = (v_V * scaleDen * VCTRL_ADC_FS_COUNTS * 1000.0) / ((double)scaleNum * VCTRL_VDDA_mV);
+    if (code <= 0.0)
+    {
+        return 0u;
+    }
+    return (code >= VCTRL_ADC_FS_COUNTS) ? (uint16_t)VCTRL_ADC_FS_COUNTS : (uint16_t)(code + 0.5);
+}
+
+void BBMODEL_Init(BBMODEL_t *m, const BBMODEL_Params_t *p, double vOut0_V)
+{
+    m->p      = *p;
+    m->vOut_V = vOut0_V;
+    /* Buck region: iL = load current; buck-boost: iL = Iload / (1 - D2) = Iload m / Dmax */
+    const double ratio = vOut0_V / p->vin_V;
+    const double dMax  = (double)VCTRL_BUCK_DUTY_MAX / VCTRL_M_ONE;
+    m->iL_A = (vOut0_V / p->r_ohm) * ((ratio > dMax) ? (ratio / dMax) : 1.0);
+}
+
+void BBMODEL_Run(BBMODEL_t *m, const VCTRL_Duty_t *duty, uint32_t period_u32)
+{
+    const double d1 = (duty->buckCmp_u32 >= period_u32) ? 1.0 : (double)duty->buckCmp_u32 / period_u32;
+    const double d2 = (duty->boostCmp_u32 >= period_u32) ? 0.0 : 1.0 - ((double)duty->boostCmp_u32 / period_u32);
+    const double dt = 1.0 / (VCTRL_FS_HZ * (double)BBMODEL_SUBSTEPS);
+
+    for (uint32_t k = 0u; k < BBMODEL_SUBSTEPS; k++)
+    {
+        m->iL_A   += dt * ((d1 * m->p.vin_V) - ((1.0 - d2) * m->vOut_V) - (m->p.rL_ohm * m->iL_A)) / m->p.l_H;
+        m->vOut_V += dt * (((1.0 - d2) * m->iL_A) - (m->vOut_V / m->p.r_ohm)) / m->p.c_F;
+    }
+}
+
+uint16_t BBMODEL_VoutCode(const BBMODEL_t *m)
+{
+    return BBMODEL_AdcCode(m->vOut_V, VCTRL_VOUT_SCALE_NUM, VCTRL_VOUT_SCALE_DEN);
+}
+
+uint16_t BBMODEL_VinCode(const BBMODEL_t *m)
+{
+    return BBMODEL_AdcCode(m->p.vin_V, VCTRL_VIN_SCALE_NUM, VCTRL_VIN_SCALE_DEN);
+}
+
+static uint64_t BBMODEL_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+void BBMODEL_TraceReset(BBMODEL_Trace_t *trace, const BBMODEL_t *m)
+{
+    trace->vMax_V    = m->vOut_V;
+    trace->vMin_V    = m->vOut_V;
+    trace->steps_u32 = 0u;
+}
+
+void BBMODEL_Loop(BBMODEL_t *m, VCTRL_t *vc, uint32_t numSteps_u32, BBMODEL_Trace_t *trace)
+{
+    for (uint32_t n = 0u; n < numSteps_u32; n++)
+    {
+        const VCTRL_Duty_t duty = VCTRL_Step(vc, BBMODEL_VoutCode(m));
+
+        BBMODEL_Run(m, &duty, vc->period_u32);
+        if (trace != NULL)
+        {
+            trace->steps_u32++;
+            trace->vMax_V = (m->vOut_V > trace->vMax_V) ? m->vOut_V : trace->vMax_V;
+            trace->vMin_V = (m->vOut_V < trace->vMin_V) ? m->vOut_V : trace->vMin_V;
+        }
+    }
+}
+
+double BBMODEL_StepCost_ns(VCTRL_t *vc, uint32_t numSteps_u32)
+{
+    volatile uint32_t sink = 0u;
+    const uint64_t t0 = BBMODEL_NowNs();
+
+    for (uint32_t n = 0u; n < numSteps_u32; n++)
+    {
+        const VCTRL_Duty_t duty = VCTRL_Step(vc, (uint16_t)(1000u + (n & 0x3FFu)));
+        sink += duty.buckCmp_u32 + duty.boostCmp_u32;
+    }
+    (void)sink;
+    return (double)(BBMODEL_NowNs() - t0) / (double)((numSteps_u32 > 0u) ? numSteps_u32 : 1u);
+}
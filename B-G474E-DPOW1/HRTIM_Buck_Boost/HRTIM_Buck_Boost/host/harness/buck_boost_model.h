@@ -0,0 +1,73 @@
+/*
+ * buck_boost_model.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Averaged model of the 4-switch non-inverting buck-boost for the host tests.
+ *
+ *  Synchronous switches, so always continuous conduction (iL may go negative):
+ *
+ *      L diL/dt = D1 Vin - (1 - D2) vC - rL iL
+ *      C dvC/dt = (1 - D2) iL - vC / R
+ *
+ *  D1 and D2 are read back from the compare values the controller writes (timer C
+ *  CMP1 = buck high side on-time, timer D CMP1 = boost low side off-time, > period =
+ *  off), so the duty mapping of voltage_ctrl.c is part of the loop. One control period
+ *  is integrated in BBMODEL_SUBSTEPS semi-implicit Euler steps.
+ */
+
+#ifndef HOST_HARNESS_BUCK_BOOST_MODEL_H_
+#define HOST_HARNESS_BUCK_BOOST_MODEL_H_
+
+#include <stdint.h>
+#include "voltage_ctrl.h"
+
+#define BBMODEL_SUBSTEPS    128U
+
+typedef struct
+{
+    double vin_V;
+    double l_H;
+    double c_F;
+    double r_ohm;           /* load */
+    double rL_ohm;          /* inductor + switch resistance */
+} BBMODEL_Params_t;
+
+typedef struct
+{
+    BBMODEL_Params_t p;
+    double           iL_A;
+    double           vOut_V;
+} BBMODEL_t;
+
+/* Output extremes of BBMODEL_Loop() */
+typedef struct
+{
+    double   vMax_V;
+    double   vMin_V;
+    uint32_t steps_u32;
+} BBMODEL_Trace_t;
+
+/* Steady state at vOut0_V (the inductor carries the load) */
+void     BBMODEL_Init(BBMODEL_t *m, const BBMODEL_Params_t *p, double vOut0_V);
+
+/* One control period (VCTRL_FS_HZ) with the compares of duty, PWM period period_u32 */
+void     BBMODEL_Run(BBMODEL_t *m, const VCTRL_Duty_t *duty, uint32_t period_u32);
+
+/* 12 bit ADC code of v_V through a NUM/DEN divider, rounded and clamped */
+uint16_t BBMODEL_AdcCode(double v_V, uint32_t scaleNum, uint32_t scaleDen);
+
+/* The injected ADC channels: Vout (rank 4) and Vin (rank 2), 12 bit through the dividers */
+uint16_t BBMODEL_VoutCode(const BBMODEL_t *m);
+uint16_t BBMODEL_VinCode(const BBMODEL_t *m);
+
+/* Closed loop as in HRTIM1_TIMC_IRQHandler: sample, VCTRL_Step(), the compares drive the
+ * next period. trace (may be NULL) accumulates over calls, see BBMODEL_TraceReset(). */
+void     BBMODEL_Loop(BBMODEL_t *m, VCTRL_t *vc, uint32_t numSteps_u32, BBMODEL_Trace_t *trace);
+void     BBMODEL_TraceReset(BBMODEL_Trace_t *trace, const BBMODEL_t *m);
+
+/* Host time of one VCTRL_Step() in ns, mean over numSteps_u32 calls on a code sweep */
+double   BBMODEL_StepCost_ns(VCTRL_t *vc, uint32_t numSteps_u32);
+
+#endif /* HOST_HARNESS_BUCK_BOOST_MODEL_H_ */
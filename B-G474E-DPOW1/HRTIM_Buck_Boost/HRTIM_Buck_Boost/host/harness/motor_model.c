@@ -0,0 +1,126 @@
+/*
+ * motor_model.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ */
+
+#include "motor_model.h"
+#include "buck_boost_model.h"
+#include "encoders.h"
+
+#include <math.h>
+#include <time.h>
+
+void MMODEL_Init(MMODEL_t *m, const MMODEL_Params_t *p)
+{
+    m->p           = *p;
+    m->load_Nm     = 0.0;
+    m->iL_A        = 0.0;
+    m->vC_V        = 0.0;
+    m->vOut_V      = 0.0;
+    m->iM_A        = 0.0;
+    m->w_rad_s     = 0.0;
+    m->wMean_rad_s = 0.0;
+}
+
+void MMODEL_Run(MMODEL_t *m, const VCTRL_Duty_t *duty, uint32_t period_u32)
+{
+    const double d1 = (duty->buckCmp_u32 >= period_u32) ? 1.0 : (double)duty->buckCmp_u32 / period_u32;
+    const double d2 = (duty->boostCmp_u32 >= period_u32) ? 0.0 : 1.0 - ((double)duty->boostCmp_u32 / period_u32);
+    const double dt = 1.0 / (VCTRL_FS_HZ * (double)MMODEL_SUBSTEPS);
+    const MMODEL_Params_t *p = &m->p;
+    double wSum = 0.0;
+
+    for (uint32_t k = 0u; k < MMODEL_SUBSTEPS; k++)
+    {
+        /* Currents on the present output voltage, then the capacitor on the new ones */
+        m->iL_A    += dt * ((d1 * p->vin_V) - ((1.0 - d2) * m->vOut_V) - (p->rL_ohm * m->iL_A)) / p->l_H;
+        m->iM_A    += dt * (m->vOut_V - (p->rm_ohm * m->iM_A) - (p->ke_Vs * m->w_rad_s)) / p->lm_H;
+        m->w_rad_s += dt * ((p->ke_Vs * m->iM_A) - (p->b_Nms * m->w_rad_s) - m->load_Nm) / p->j_kgm2;
+
+        const double iC = ((1.0 - d2) * m->iL_A) - m->iM_A;
+        m->vC_V  += dt * iC / p->c_F;
+        m->vOut_V = m->vC_V + (p->esr_ohm * iC);
+        wSum     += m->w_rad_s;
+    }
+    m->wMean_rad_s = wSum / MMODEL_SUBSTEPS;
+}
+
+void MMODEL_Input(const MMODEL_t *m, MCTRL_Input_t *in)
+{
+    /* The ADC clamps below the zero code: negative current reads as the offset or less */
+    const double code = m->p.iZeroCode_u16 + ((m->iL_A * m->p.senseGain_VpA * VCTRL_ADC_FS_COUNTS * 1000.0) / VCTRL_VDDA_mV);
+
+    in->iCode_u16    = (code <= 0.0) ? 0u
+                     : ((code >= VCTRL_ADC_FS_COUNTS) ? (uint16_t)VCTRL_ADC_FS_COUNTS : (uint16_t)(code + 0.5));
+    in->vinCode_u16  = BBMODEL_AdcCode(m->p.vin_V, VCTRL_VIN_SCALE_NUM, VCTRL_VIN_SCALE_DEN);
+    in->voutCode_u16 = BBMODEL_AdcCode(m->vOut_V, VCTRL_VOUT_SCALE_NUM, VCTRL_VOUT_SCALE_DEN);
+    in->speed_cps_q8 = MMODEL_CpsQ8(m->wMean_rad_s);
+}
+
+void MMODEL_TraceReset(MMODEL_Trace_t *trace, const MMODEL_t *m)
+{
+    trace->wMax_rad_s = m->w_rad_s;
+    trace->wMin_rad_s = m->w_rad_s;
+    trace->iLMax_A    = m->iL_A;
+    trace->iLMin_A    = m->iL_A;
+    trace->vOutMax_V  = m->vOut_V;
+    trace->steps_u32  = 0u;
+}
+
+void MMODEL_Loop(MMODEL_t *m, MCTRL_t *mc, uint32_t numSteps_u32, MMODEL_Trace_t *trace)
+{
+    MCTRL_Input_t in;
+
+    for (uint32_t n = 0u; n < numSteps_u32; n++)
+    {
+        MMODEL_Input(m, &in);
+        const VCTRL_Duty_t duty = MCTRL_Step(mc, &in);
+
+        MMODEL_Run(m, &duty, mc->stage->period_u32);
+        if (trace != NULL)
+        {
+            trace->steps_u32++;
+            trace->wMax_rad_s = fmax(trace->wMax_rad_s, m->w_rad_s);
+            trace->wMin_rad_s = fmin(trace->wMin_rad_s, m->w_rad_s);
+            trace->iLMax_A    = fmax(trace->iLMax_A, m->iL_A);
+            trace->iLMin_A    = fmin(trace->iLMin_A, m->iL_A);
+            trace->vOutMax_V  = fmax(trace->vOutMax_V, m->vOut_V);
+        }
+    }
+}
+
+int32_t MMODEL_CpsQ8(double w_rad_s)
+{
+    return (int32_t)lround(w_rad_s * (ENC_COUNTS_PER_REV * 256.0) / (2.0 * M_PI));
+}
+
+double MMODEL_Rpm(double w_rad_s)
+{
+    return w_rad_s * 60.0 / (2.0 * M_PI);
+}
+
+static uint64_t MMODEL_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+double MMODEL_StepCost_ns(MCTRL_t *mc, uint32_t numSteps_u32)
+{
+    volatile uint32_t sink = 0u;
+    MCTRL_Input_t in = { 0u, 2000u, 1000u, 0 };
+    const uint64_t t0 = MMODEL_NowNs();
+
+    for (uint32_t n = 0u; n < numSteps_u32; n++)
+    {
+        in.iCode_u16    = (uint16_t)(100u + (n & 0x3FFu));
+        in.speed_cps_q8 = (int32_t)((n & 0xFFFu) << 12);
+        const VCTRL_Duty_t duty = MCTRL_Step(mc, &in);
+        sink += duty.buckCmp_u32 + duty.boostCmp_u32;
+    }
+    (void)sink;
+    return (double)(MMODEL_NowNs() - t0) / (double)((numSteps_u32 > 0u) ? numSteps_u32 : 1u);
+}
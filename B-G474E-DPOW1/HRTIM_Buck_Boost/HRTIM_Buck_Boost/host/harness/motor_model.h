@@ -0,0 +1,88 @@
+/*
+ * motor_model.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Averaged buck-boost stage driving a brushed DC motor, for the motor_control.c tests.
+ *
+ *      L  diL/dt = D1 Vin - (1 - D2) vOut - rL iL
+ *      C  dvC/dt = (1 - D2) iL - iM                    vOut = vC + esr C dvC/dt
+ *      Lm diM/dt = vOut - Rm iM - Ke w
+ *      J  dw/dt  = Ke iM - B w - Tload                 (Kt = Ke in SI units)
+ *
+ *  D1 and D2 come from the compares as in buck_boost_model.h. I_IN_SENSE is the
+ *  average inductor current (the mid on-time sample) through senseGain, above the
+ *  zero-current code; the speed input is the mean shaft speed over the last period,
+ *  what the encoder estimator reports once a window spans a period.
+ */
+
+#ifndef HOST_HARNESS_MOTOR_MODEL_H_
+#define HOST_HARNESS_MOTOR_MODEL_H_
+
+#include <stdint.h>
+#include "motor_control.h"
+
+#define MMODEL_SUBSTEPS     128U
+
+typedef struct
+{
+    double   vin_V;
+    double   l_H;
+    double   c_F;
+    double   esr_ohm;
+    double   rL_ohm;        /* inductor + switch resistance */
+    double   rm_ohm;        /* motor */
+    double   lm_H;
+    double   ke_Vs;         /* V s/rad = N m/A             */
+    double   j_kgm2;
+    double   b_Nms;         /* viscous friction             */
+    double   senseGain_VpA; /* I_IN_SENSE at the ADC pin    */
+    uint16_t iZeroCode_u16; /* I_IN_SENSE code at 0 A       */
+} MMODEL_Params_t;
+
+typedef struct
+{
+    MMODEL_Params_t p;
+    double          load_Nm;
+    double          iL_A;
+    double          vC_V;
+    double          vOut_V;
+    double          iM_A;
+    double          w_rad_s;
+    double          wMean_rad_s;    /* over the last period */
+} MMODEL_t;
+
+/* Extremes of MMODEL_Loop() */
+typedef struct
+{
+    double   wMax_rad_s;
+    double   wMin_rad_s;
+    double   iLMax_A;
+    double   iLMin_A;
+    double   vOutMax_V;
+    uint32_t steps_u32;
+} MMODEL_Trace_t;
+
+/* At rest, output discharged */
+void     MMODEL_Init(MMODEL_t *m, const MMODEL_Params_t *p);
+
+/* One control period (VCTRL_FS_HZ) with the compares of duty, PWM period period_u32 */
+void     MMODEL_Run(MMODEL_t *m, const VCTRL_Duty_t *duty, uint32_t period_u32);
+
+/* The measurements of the next HRTIM timer C interrupt */
+void     MMODEL_Input(const MMODEL_t *m, MCTRL_Input_t *in);
+
+/* Closed loop as in the motor mode of HRTIM1_TIMC_IRQHandler; trace (may be NULL)
+ * accumulates over calls, see MMODEL_TraceReset() */
+void     MMODEL_Loop(MMODEL_t *m, MCTRL_t *mc, uint32_t numSteps_u32, MMODEL_Trace_t *trace);
+void     MMODEL_TraceReset(MMODEL_Trace_t *trace, const MMODEL_t *m);
+
+/* rad/s <-> encoder counts/s Q8, rpm */
+int32_t  MMODEL_CpsQ8(double w_rad_s);
+double   MMODEL_Rpm(double w_rad_s);
+
+/* Host time of one MCTRL_Step() in ns, mean over numSteps_u32 calls on an input sweep */
+double   MMODEL_StepCost_ns(MCTRL_t *mc, uint32_t numSteps_u32);
+
+#endif /* HOST_HARNESS_MOTOR_MODEL_H_ */
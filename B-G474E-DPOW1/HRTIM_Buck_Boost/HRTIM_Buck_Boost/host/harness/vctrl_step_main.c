@@ -0,0 +1,76 @@
+/*
+ * vctrl_step_main.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Set-point step of the voltage loop (voltage_ctrl.c, compensator.c) on the averaged
+ *  buck-boost model: one CSV row per millisecond, then the overshoot, the settling
+ *  time and the host cost of one VCTRL_Step().
+ *
+ *      vctrl_step_host [vin_V L_uH C_uF R_ohm from_mV to_mV]
+ *
+ *  Defaults: 5 V in, 22 uH, 20 uF, 50 ohm, 3000 -> 8000 mV.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "buck_boost_model.h"
+#include "main.h"
+
+#define STEP_SETTLE_MS      200u
+#define STEP_BAND_mV        50.0
+
+int main(int argc, char **argv)
+{
+    BBMODEL_Params_t p = { 5.0, 22e-6, 20e-6, 50.0, 0.05 };
+    uint32_t from_mV = 3000u, to_mV = 8000u;
+    BBMODEL_t m;
+    VCTRL_t vc;
+
+    if (argc == 7)
+    {
+        p.vin_V = atof(argv[1]);
+        p.l_H   = atof(argv[2]) * 1e-6;
+        p.c_F   = atof(argv[3]) * 1e-6;
+        p.r_ohm = atof(argv[4]);
+        from_mV = (uint32_t)atoi(argv[5]);
+        to_mV   = (uint32_t)atoi(argv[6]);
+    }
+    else if (argc != 1)
+    {
+        fprintf(stderr, "usage: %s [vin_V L_uH C_uF R_ohm from_mV to_mV]\n", argv[0]);
+        return 2;
+    }
+
+    /* Settled at from_mV, then the step */
+    BBMODEL_Init(&m, &p, from_mV / 1000.0);
+    VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+    VCTRL_SetTarget_mV(&vc, from_mV);
+    VCTRL_Start(&vc, BBMODEL_VoutCode(&m), BBMODEL_VinCode(&m));
+    BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, NULL);
+    VCTRL_SetTarget_mV(&vc, to_mV);
+
+    const uint32_t stepsPerMs = VCTRL_FS_HZ / 1000u;
+    const double dir = (to_mV >= from_mV) ? 1.0 : -1.0;
+    double peak_mV = from_mV, settle_ms = 0.0;
+
+    printf("t_ms,ref_mV,vout_mV,iL_mA,m,region\n");
+    for (uint32_t t = 0u; t < STEP_SETTLE_MS; t++)
+    {
+        BBMODEL_Loop(&m, &vc, stepsPerMs, NULL);
+        const double v_mV = m.vOut_V * 1000.0;
+        peak_mV = ((dir * v_mV) > (dir * peak_mV)) ? v_mV : peak_mV;
+        settle_ms = (fabs(v_mV - to_mV) > STEP_BAND_mV) ? (double)(t + 1u) : settle_ms;
+        printf("%u,%.0f,%.1f,%.1f,%d,%s\n", t + 1u,
+               (vc.refQ8_s32 / 256.0) * VCTRL_VDDA_mV * VCTRL_VOUT_SCALE_NUM / (VCTRL_ADC_FS_COUNTS * (double)VCTRL_VOUT_SCALE_DEN),
+               v_mV, m.iL_A * 1000.0, vc.m_s16, (vc.region == VCTRL_REGION_BUCK) ? "buck" : "buck-boost");
+    }
+
+    const uint32_t saturated = vc.stats.saturated_u32;
+    printf("# overshoot %.1f mV, settled within %.0f mV after %.0f ms, %u saturated steps, %.1f ns per VCTRL_Step\n",
+           dir * (peak_mV - to_mV), STEP_BAND_mV, settle_ms, saturated, BBMODEL_StepCost_ns(&vc, 1000000u));
+    return (settle_ms < STEP_SETTLE_MS) ? 0 : 1;
+}
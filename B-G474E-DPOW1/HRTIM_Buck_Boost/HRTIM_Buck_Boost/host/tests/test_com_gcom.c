@@ -0,0 +1,667 @@
+/*
+ * test_com_gcom.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Framing and command interface of com_gcom.c: frames against the CRC reference
+ *  value and a byte exact golden frame, the decoder on noisy input, every request
+ *  type through GCOM_RxPush() / GCOM_Task() with the responses decoded from the
+ *  transport, the SET checks (ranges, validate hook, all or nothing), storage, and
+ *  the handoff to the control interrupt.
+ *
+ *  Handoff: a SIGALRM handler plays the PWM period interrupt calling
+ *  GCOM_ApplyPending() while the main loop publishes and reads blocks whose fields
+ *  all carry one generation number. A torn block shows up as mixed generations,
+ *  in the apply hook (interrupt side) or in GCOM_ReadParams() (main side). The
+ *  module is built with word copies here (word_memcpy.h), as they run on the M4.
+ */
+
+#include <signal.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "test_check.h"
+#include "com_gcom.h"
+
+#define SINK_MAX            4096u
+#define STRESS_TICK_US      20
+#define STRESS_SETS         50000u
+
+/* --- Parameter block of the command tests --- */
+
+typedef struct
+{
+    uint16_t target_mV;
+    uint16_t ovp_mV;
+    uint8_t  mode;
+    uint8_t  enable;
+    uint16_t reserved;
+    uint32_t limit;
+} TestParams_t;
+
+enum { P_TARGET = 1, P_OVP, P_MODE, P_ENABLE, P_LIMIT };
+
+#define TP(id, field, type, lo, hi) \
+    { (id), (type), (uint16_t)offsetof(TestParams_t, field), (lo), (hi) }
+
+static const GCOM_ParamDesc_t params[] = {
+    TP(P_TARGET, target_mV, GCOM_PT_U16,  500u,  12000u),
+    TP(P_OVP,    ovp_mV,    GCOM_PT_U16,  2000u, 15000u),
+    TP(P_MODE,   mode,      GCOM_PT_U8,   0u,    3u),
+    TP(P_ENABLE, enable,    GCOM_PT_BOOL, 0u,    1u),
+    TP(P_LIMIT,  limit,     GCOM_PT_U32,  10u,   0x01000000u),
+};
+
+static const TestParams_t defaults = { 5000u, 9000u, 1u, 0u, 0u, 1000u };
+
+/* --- Hooks --- */
+
+static TestParams_t applied;
+static uint32_t applyCalls, saveCalls, cmdCalls;
+static uint8_t  store[256];
+static uint32_t storeLen;
+static bool     storeFails;
+static uint8_t  lastCmd, lastArgs[GCOM_MAX_PAYLOAD];
+static uint32_t lastArgsLen;
+
+/* Cross check: the target stays 500 mV below the OVP threshold */
+static bool validate(const void *block)
+{
+    const TestParams_t *p = block;
+    return (p->target_mV + 500u) <= p->ovp_mV;
+}
+
+static void apply(const void *block)
+{
+    memcpy(&applied, block, sizeof(applied));
+    applyCalls++;
+}
+
+static bool save(const void *record, uint32_t len)
+{
+    saveCalls++;
+    if (storeFails || (len > sizeof(store)))
+        return false;
+    memcpy(store, record, len);
+    storeLen = len;
+    return true;
+}
+
+static bool load(void *record, uint32_t len)
+{
+    if ((storeLen == 0u) || (len != storeLen))
+        return false;
+    memcpy(record, store, len);
+    return true;
+}
+
+static GCOM_Status_t command(uint8_t cmd, const uint8_t *args, uint32_t len)
+{
+    cmdCalls++;
+    lastCmd = cmd;
+    memcpy(lastArgs, args, len);
+    lastArgsLen = len;
+    return (cmd == 0x42u) ? GCOM_ERR_REJECTED : GCOM_OK;
+}
+
+static const GCOM_Config_t cfg = {
+    .params = params, .numParams_u32 = 5u, .blockSize_u32 = sizeof(TestParams_t),
+    .defaults = &defaults, .validate = validate, .apply = apply,
+    .save = save, .load = load, .command = command
+};
+
+static const GCOM_Config_t cfgBare = {
+    .params = params, .numParams_u32 = 5u, .blockSize_u32 = sizeof(TestParams_t),
+    .defaults = &defaults, .apply = apply
+};
+
+/* --- Transport: responses collected and decoded --- */
+
+static uint8_t  sink[SINK_MAX];
+static uint32_t sinkLen;
+
+static bool sink_write(const void *data, uint32_t len)
+{
+    if ((sinkLen + len) > SINK_MAX)
+        return false;
+    memcpy(&sink[sinkLen], data, len);
+    sinkLen += len;
+    return true;
+}
+
+static const GCOM_Transport_t tr = { sink_write };
+
+static void push_bytes(const uint8_t *data, uint32_t len)
+{
+    for (uint32_t i = 0u; i < len; i++)
+        GCOM_RxPush(data[i]);
+}
+
+static void push_frame(uint8_t type, const uint8_t *payload, uint32_t len)
+{
+    uint8_t frame[GCOM_MAX_FRAME];
+    push_bytes(frame, GCOM_Encode(type, payload, len, frame));
+}
+
+/* Run the task until the queue is empty; returns the responses, the last one in *resp */
+static uint32_t run_task(GCOM_Decoder_t *resp)
+{
+    uint32_t handled = 0u, frames = 0u;
+
+    sinkLen = 0u;
+    for (uint32_t i = 0u; i < 64u; i++)
+        handled += GCOM_Task();
+    GCOM_DecoderInit(resp);
+    for (uint32_t i = 0u; i < sinkLen; i++)
+        frames += GCOM_DecodeByte(resp, sink[i]) ? 1u : 0u;
+    CHECK(frames <= handled);
+    return frames;
+}
+
+/* One request, one response of the matching type: its status byte */
+static uint8_t request(uint8_t type, const uint8_t *payload, uint32_t len, GCOM_Decoder_t *resp)
+{
+    push_frame(type, payload, len);
+    CHECK(run_task(resp) == 1u);
+    CHECK(resp->type_u8 == (type | GCOM_TYPE_RESP));
+    CHECK(resp->len_u8 >= 1u);
+    return resp->payload[0];
+}
+
+static uint32_t put_le(uint8_t *out, uint32_t v, uint32_t n)
+{
+    for (uint32_t i = 0u; i < n; i++)
+        out[i] = (uint8_t)(v >> (8u * i));
+    return n;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void test_crc_and_encode(void)
+{
+    /* CRC-16/CCITT-FALSE check value */
+    CHECK(GCOM_Crc16(0xFFFFu, (const uint8_t *)"123456789", 9u) == 0x29B1u);
+    CHECK(GCOM_Crc16(0x1234u, NULL, 0u) == 0x1234u);
+
+    /* Bitwise reference on random data */
+    uint32_t seed = 7u;
+    for (uint32_t k = 0u; k < 200u; k++)
+    {
+        uint8_t data[40];
+        uint16_t ref = 0xFFFFu;
+        for (uint32_t i = 0u; i < sizeof(data); i++)
+        {
+            seed = (seed * 1664525u) + 1013904223u;
+            data[i] = (uint8_t)(seed >> 24);
+            ref ^= (uint16_t)(data[i] << 8);
+            for (uint32_t b = 0u; b < 8u; b++)
+                ref = (ref & 0x8000u) ? (uint16_t)((ref << 1) ^ 0x1021u) : (uint16_t)(ref << 1);
+        }
+        CHECK(GCOM_Crc16(0xFFFFu, data, sizeof(data)) == ref);
+    }
+
+    uint8_t frame[GCOM_MAX_FRAME + 8u];
+    static const uint8_t payload[] = { 0x11u, 0x22u, 0x33u };
+    CHECK(GCOM_Encode(0x10u, payload, 3u, frame) == 9u);
+    const uint16_t crc = GCOM_Crc16(0xFFFFu, (const uint8_t[]){ 0x10u, 3u, 0x11u, 0x22u, 0x33u }, 5u);
+    const uint8_t golden[] = { 0xA5u, 0x5Au, 0x10u, 3u, 0x11u, 0x22u, 0x33u, (uint8_t)crc, (uint8_t)(crc >> 8) };
+    CHECK(memcmp(frame, golden, sizeof(golden)) == 0);
+
+    static uint8_t big[GCOM_MAX_PAYLOAD + 1u];
+    CHECK(GCOM_Encode(0x01u, big, GCOM_MAX_PAYLOAD, frame) == GCOM_MAX_FRAME);
+    CHECK(GCOM_Encode(0x01u, big, GCOM_MAX_PAYLOAD + 1u, frame) == 0u);
+    CHECK(GCOM_Encode(0x14u, NULL, 0u, frame) == GCOM_OVERHEAD);
+    CHECK(!GCOM_Send(&tr, 0x01u, big, GCOM_MAX_PAYLOAD + 1u));
+    CHECK(!GCOM_Send(NULL, 0x01u, big, 1u));
+}
+
+/* Frames between text, sync bytes in the noise, corrupted and oversized frames */
+static void test_decoder(void)
+{
+    static uint8_t stream[8192];
+    uint32_t len = 0u, sent = 0u, corrupted = 0u, seed = 99u;
+    uint8_t payloads[64][GCOM_MAX_PAYLOAD];
+    uint8_t lens[64];
+
+    for (uint32_t f = 0u; f < 64u; f++)
+    {
+        /* Noise, A5 runs included */
+        for (uint32_t i = 0u; i < (f % 9u); i++)
+        {
+            seed = (seed * 1664525u) + 1013904223u;
+            stream[len++] = ((i % 3u) == 0u) ? GCOM_SOF0 : (uint8_t)(seed >> 24);
+        }
+        if ((f % 7u) == 3u)
+        {
+            /* Length above the maximum: dropped at the length byte */
+            const uint8_t bad[] = { GCOM_SOF0, GCOM_SOF1, 0x01u, GCOM_MAX_PAYLOAD + 1u };
+            memcpy(&stream[len], bad, sizeof(bad));
+            len += sizeof(bad);
+        }
+        lens[f] = (uint8_t)((f * 5u) % (GCOM_MAX_PAYLOAD + 1u));
+        for (uint32_t i = 0u; i < lens[f]; i++)
+            payloads[f][i] = (uint8_t)((f * 31u) + i);
+        if ((f % 8u) == 5u)
+            payloads[f][0] = GCOM_SOF0;                          // sync bytes inside a frame
+        const uint32_t n = GCOM_Encode((uint8_t)f, payloads[f], lens[f], &stream[len]);
+        if ((f % 11u) == 10u)
+        {
+            stream[len + n - 3u] ^= 0x01u;                       // bit error
+            corrupted++;
+        }
+        else
+        {
+            sent++;
+        }
+        len += n;
+    }
+
+    GCOM_Decoder_t dec;
+    uint32_t got = 0u;
+    GCOM_DecoderInit(&dec);
+    for (uint32_t i = 0u; i < len; i++)
+    {
+        if (GCOM_DecodeByte(&dec, stream[i]))
+        {
+            const uint32_t f = dec.type_u8;
+            CHECK((f < 64u) && ((f % 11u) != 10u));
+            CHECK((dec.len_u8 == lens[f]) && (memcmp(dec.payload, payloads[f], lens[f]) == 0));
+            got++;
+        }
+    }
+    CHECK(got == sent);
+    CHECK(dec.frames_u32 == sent);
+    CHECK(dec.crcErrors_u32 == corrupted);
+
+    /* A5 A5 5A stays aligned on the second A5 */
+    uint8_t frame[GCOM_MAX_FRAME + 1u];
+    frame[0] = GCOM_SOF0;
+    const uint32_t n = GCOM_Encode(0x22u, (const uint8_t *)"ab", 2u, &frame[1]);
+    GCOM_DecoderInit(&dec);
+    got = 0u;
+    for (uint32_t i = 0u; i <= n; i++)
+        got += GCOM_DecodeByte(&dec, frame[i]) ? 1u : 0u;
+    CHECK((got == 1u) && (dec.type_u8 == 0x22u));
+}
+
+static void test_init_and_get(void)
+{
+    GCOM_Decoder_t resp;
+    TestParams_t cur;
+
+    storeLen = 0u;
+    applyCalls = 0u;
+    CHECK(!GCOM_Init(NULL, &tr));
+    CHECK(!GCOM_Init(&cfg, &tr));                                // nothing stored: defaults
+    CHECK(applyCalls == 1u);
+    CHECK(memcmp(&applied, &defaults, sizeof(defaults)) == 0);
+    CHECK(!GCOM_IsApplyPending());
+    GCOM_ReadParams(&cur);
+    CHECK(memcmp(&cur, &defaults, sizeof(defaults)) == 0);
+
+    /* All parameters in table order */
+    CHECK(request(GCOM_TYPE_PARAM_GET, NULL, 0u, &resp) == GCOM_OK);
+    static const uint8_t all[] = {
+        GCOM_OK, P_TARGET, 0x88u, 0x13u, P_OVP, 0x28u, 0x23u, P_MODE, 1u, P_ENABLE, 0u,
+        P_LIMIT, 0xE8u, 0x03u, 0u, 0u
+    };
+    CHECK((resp.len_u8 == sizeof(all)) && (memcmp(resp.payload, all, sizeof(all)) == 0));
+
+    /* Selected ids, in request order */
+    const uint8_t ids[] = { P_LIMIT, P_MODE };
+    CHECK(request(GCOM_TYPE_PARAM_GET, ids, 2u, &resp) == GCOM_OK);
+    const uint8_t sel[] = { GCOM_OK, P_LIMIT, 0xE8u, 0x03u, 0u, 0u, P_MODE, 1u };
+    CHECK((resp.len_u8 == sizeof(sel)) && (memcmp(resp.payload, sel, sizeof(sel)) == 0));
+
+    /* Unknown id, and a response that would not fit in one frame */
+    const uint8_t unknown[] = { P_MODE, 0x77u };
+    CHECK(request(GCOM_TYPE_PARAM_GET, unknown, 2u, &resp) == GCOM_ERR_PARAM);
+    CHECK(resp.len_u8 == 1u);
+    uint8_t many[13];
+    memset(many, P_LIMIT, sizeof(many));                         // 13 x 5 bytes + status
+    CHECK(request(GCOM_TYPE_PARAM_GET, many, sizeof(many), &resp) == GCOM_ERR_LEN);
+    CHECK(request(GCOM_TYPE_PARAM_GET, many, 12u, &resp) == GCOM_OK);
+    CHECK(resp.len_u8 == 61u);
+    CHECK(GCOM_GetStats()->requests_u32 == 5u);
+    CHECK(GCOM_GetStats()->errors_u32 == 2u);
+}
+
+/* SET: checked entry by entry, then as a block, published whole or not at all */
+static void test_set(void)
+{
+    GCOM_Decoder_t resp;
+    TestParams_t cur;
+    uint8_t req[GCOM_MAX_PAYLOAD];
+    uint32_t n;
+
+    storeLen = 0u;
+    GCOM_Init(&cfg, &tr);
+    applyCalls = 0u;
+
+    /* Valid: nothing changes until the control interrupt applies it */
+    n = 0u;
+    req[n++] = P_TARGET; n += put_le(&req[n], 6000u, 2u);
+    req[n++] = P_LIMIT;  n += put_le(&req[n], 0x00123456u, 4u);
+    req[n++] = P_ENABLE; req[n++] = 1u;
+    CHECK(request(GCOM_TYPE_PARAM_SET, req, n, &resp) == GCOM_OK);
+    CHECK((resp.len_u8 == 2u) && (resp.payload[1] == 3u));      // entries taken
+    CHECK(GCOM_IsApplyPending());
+    CHECK(applyCalls == 0u);
+    GCOM_ReadParams(&cur);
+    CHECK(memcmp(&cur, &defaults, sizeof(defaults)) == 0);
+
+    /* A second SET before the apply is refused, nothing is lost of the first */
+    req[0] = P_MODE; req[1] = 2u;
+    CHECK(request(GCOM_TYPE_PARAM_SET, req, 2u, &resp) == GCOM_ERR_BUSY);
+    CHECK(request(GCOM_TYPE_PARAM_DEFAULTS, NULL, 0u, &resp) == GCOM_ERR_BUSY);
+    CHECK(request(GCOM_TYPE_PARAM_SAVE, NULL, 0u, &resp) == GCOM_ERR_BUSY);
+
+    GCOM_ApplyPending();
+    CHECK(!GCOM_IsApplyPending() && (applyCalls == 1u));
+    CHECK((applied.target_mV == 6000u) && (applied.limit == 0x00123456u) && (applied.enable == 1u));
+    CHECK((applied.ovp_mV == defaults.ovp_mV) && (applied.mode == defaults.mode));
+    GCOM_ApplyPending();                                         // nothing pending: no call
+    CHECK(applyCalls == 1u);
+    CHECK(GCOM_GetStats()->applied_u32 == 1u);
+    CHECK(memcmp(GCOM_ActiveParams(), &applied, sizeof(applied)) == 0);
+
+    /* Rejections report the entry; the block stays as it was, nothing is pending */
+    struct { uint8_t bytes[12]; uint8_t len; uint8_t status; uint8_t index; } bad[] = {
+        { { P_MODE, 2u, P_OVP, 0x10u, 0x27u, P_MODE, 4u }, 7u, GCOM_ERR_RANGE, 2u },
+        { { P_MODE, 2u, 0x77u, 1u }, 4u, GCOM_ERR_PARAM, 1u },
+        { { P_MODE, 2u, P_LIMIT, 0x20u, 0x00u, 0x00u }, 6u, GCOM_ERR_LEN, 1u },
+        { { P_TARGET, 0xF4u, 0x01u, P_TARGET, 0xF3u, 0x01u }, 6u, GCOM_ERR_RANGE, 1u },  // 500 ok, 499 not
+        { { P_ENABLE, 2u }, 2u, GCOM_ERR_RANGE, 0u },
+        { { P_LIMIT, 0x01u, 0x00u, 0x00u, 0x01u }, 5u, GCOM_ERR_RANGE, 0u },
+        /* In range one by one, but the target comes within 500 mV of the OVP */
+        { { P_OVP, 0x70u, 0x17u, P_MODE, 3u }, 5u, GCOM_ERR_INVALID, 2u },
+    };
+    for (uint32_t i = 0u; i < (sizeof(bad) / sizeof(bad[0])); i++)
+    {
+        CHECK_MSG(request(GCOM_TYPE_PARAM_SET, bad[i].bytes, bad[i].len, &resp) == bad[i].status,
+                  "case %u: status %u", i, resp.payload[0]);
+        CHECK_MSG(resp.payload[1] == bad[i].index, "case %u: index %u", i, resp.payload[1]);
+        CHECK(!GCOM_IsApplyPending());
+        CHECK(memcmp(GCOM_ActiveParams(), &applied, sizeof(applied)) == 0);
+    }
+
+    /* An empty SET republishes the block as it is */
+    CHECK(request(GCOM_TYPE_PARAM_SET, NULL, 0u, &resp) == GCOM_OK);
+    GCOM_ApplyPending();
+    CHECK((applyCalls == 2u) && (applied.target_mV == 6000u));
+
+    /* Same checks through the API */
+    uint32_t badIndex = 99u;
+    req[0] = P_MODE; req[1] = 9u;
+    CHECK(GCOM_SetParams(req, 2u, &badIndex) == GCOM_ERR_RANGE);
+    CHECK(badIndex == 0u);
+
+    /* Defaults back through the same handoff */
+    CHECK(request(GCOM_TYPE_PARAM_DEFAULTS, NULL, 0u, &resp) == GCOM_OK);
+    CHECK(applyCalls == 2u);
+    GCOM_ApplyPending();
+    CHECK(memcmp(&applied, &defaults, sizeof(defaults)) == 0);
+}
+
+/* SAVE and the record GCOM_Init() accepts */
+static void test_storage(void)
+{
+    GCOM_Decoder_t resp;
+    uint8_t req[8];
+    uint32_t badIndex;
+
+    storeLen = saveCalls = 0u;
+    storeFails = false;
+    GCOM_Init(&cfg, &tr);
+    req[0] = P_MODE; req[1] = 3u;
+    CHECK(GCOM_SetParams(req, 2u, &badIndex) == GCOM_OK);
+    GCOM_ApplyPending();
+    CHECK(request(GCOM_TYPE_PARAM_SAVE, NULL, 0u, &resp) == GCOM_OK);
+    CHECK(saveCalls == 1u);
+
+    /* Loaded back and applied */
+    applyCalls = 0u;
+    CHECK(GCOM_Init(&cfg, &tr));
+    CHECK((applyCalls == 1u) && (applied.mode == 3u) && (applied.target_mV == defaults.target_mV));
+
+    /* Record layout: magic, size, CRC of the block */
+    uint32_t magic;
+    uint16_t size, crc;
+    memcpy(&magic, &store[0], 4u);
+    memcpy(&size, &store[4], 2u);
+    memcpy(&crc, &store[6], 2u);
+    CHECK((magic == GCOM_STORE_MAGIC) && (size == sizeof(TestParams_t)));
+    CHECK(crc == GCOM_Crc16(0xFFFFu, &store[8], sizeof(TestParams_t)));
+
+    /* Any damage falls back to the defaults */
+    static const uint32_t flip[] = { 0u, 4u, 6u, 8u + offsetof(TestParams_t, limit) };
+    for (uint32_t i = 0u; i < (sizeof(flip) / sizeof(flip[0])); i++)
+    {
+        store[flip[i]] ^= 0x04u;
+        CHECK_MSG(!GCOM_Init(&cfg, &tr), "byte %u", flip[i]);
+        CHECK(memcmp(&applied, &defaults, sizeof(defaults)) == 0);
+        store[flip[i]] ^= 0x04u;
+    }
+
+    /* Intact record that this firmware's ranges reject (mode 3 -> 4, CRC fixed up) */
+    store[8 + offsetof(TestParams_t, mode)] = 4u;
+    crc = GCOM_Crc16(0xFFFFu, &store[8], sizeof(TestParams_t));
+    memcpy(&store[6], &crc, 2u);
+    CHECK(!GCOM_Init(&cfg, &tr));
+    CHECK(memcmp(&applied, &defaults, sizeof(defaults)) == 0);
+
+    storeFails = true;
+    CHECK(request(GCOM_TYPE_PARAM_SAVE, NULL, 0u, &resp) == GCOM_ERR_STORAGE);
+    storeFails = false;
+
+    GCOM_Init(&cfgBare, &tr);
+    CHECK(GCOM_SaveParams() == GCOM_ERR_STORAGE);
+}
+
+static void test_commands_and_types(void)
+{
+    GCOM_Decoder_t resp;
+
+    storeLen = cmdCalls = 0u;
+    GCOM_Init(&cfg, &tr);
+    const uint8_t cmd[] = { 0x07u, 0xAAu, 0xBBu };
+    CHECK(request(GCOM_TYPE_COMMAND, cmd, 3u, &resp) == GCOM_OK);
+    CHECK((cmdCalls == 1u) && (lastCmd == 0x07u) && (lastArgsLen == 2u));
+    CHECK((lastArgs[0] == 0xAAu) && (lastArgs[1] == 0xBBu));
+    const uint8_t refused = 0x42u;
+    CHECK(request(GCOM_TYPE_COMMAND, &refused, 1u, &resp) == GCOM_ERR_REJECTED);
+    CHECK(request(GCOM_TYPE_COMMAND, NULL, 0u, &resp) == GCOM_ERR_LEN);
+    CHECK(cmdCalls == 2u);
+    CHECK(request(0x3Fu, NULL, 0u, &resp) == GCOM_ERR_TYPE);
+
+    /* Responses and telemetry coming back are not requests: no answer */
+    push_frame(GCOM_TYPE_PARAM_GET | GCOM_TYPE_RESP, NULL, 0u);
+    push_frame(GCOM_TYPE_TELEMETRY, cmd, 3u);
+    const uint32_t before = GCOM_GetStats()->requests_u32;
+    CHECK(run_task(&resp) == 0u);
+    CHECK((sinkLen == 0u) && (GCOM_GetStats()->requests_u32 == before));
+
+    GCOM_Init(&cfgBare, &tr);
+    CHECK(request(GCOM_TYPE_COMMAND, cmd, 3u, &resp) == GCOM_ERR_TYPE);
+    CHECK(cmdCalls == 2u);
+}
+
+/* The task's bounds: GCOM_RX_BUDGET bytes and one request per call, RX overruns counted */
+static void test_task_bounds(void)
+{
+    uint8_t junk[200];
+    GCOM_Decoder_t resp;
+
+    GCOM_Init(&cfgBare, &tr);
+    CHECK(GCOM_Task() == 0u);
+
+    memset(junk, 'x', sizeof(junk));
+    push_bytes(junk, sizeof(junk));
+    push_frame(GCOM_TYPE_PARAM_GET, NULL, 0u);
+    push_frame(GCOM_TYPE_PARAM_GET, NULL, 0u);
+    sinkLen = 0u;
+    uint32_t calls = 0u, handled = 0u;
+    while (handled < 2u)
+    {
+        const uint32_t h = GCOM_Task();
+        CHECK(h <= 1u);
+        handled += h;
+        calls++;
+        CHECK(calls < 16u);
+        if (calls >= 16u)
+            break;
+    }
+    CHECK(GCOM_GetStats()->maxTaskBytes_u32 == GCOM_RX_BUDGET);
+    CHECK(calls == ((sizeof(junk) + GCOM_RX_BUDGET - 1u) / GCOM_RX_BUDGET) + 1u);
+    CHECK(GCOM_GetStats()->requests_u32 == 2u);
+
+    /* Queue full: later bytes are counted and dropped, the queued ones still parse */
+    push_frame(GCOM_TYPE_PARAM_GET, NULL, 0u);
+    push_bytes(junk, GCOM_RX_BUF_SIZE - GCOM_OVERHEAD);
+    push_bytes(junk, 10u);
+    CHECK(GCOM_GetStats()->rxOverruns_u32 == 10u);
+    CHECK(run_task(&resp) == 1u);
+    CHECK(resp.type_u8 == (GCOM_TYPE_PARAM_GET | GCOM_TYPE_RESP));
+}
+
+/* ------------------------------------------------------------------------- */
+/* Handoff under preemption                                                  */
+/* ------------------------------------------------------------------------- */
+
+#define GEN_WORDS           (GCOM_PARAM_BLOCK_MAX / 4u)
+
+static GCOM_ParamDesc_t genParams[GEN_WORDS];
+static uint32_t genDefaults[GEN_WORDS];
+static volatile uint32_t isrTorn, isrApplied, isrLastGen, isrBackwards, inIsr, applyOutsideIsr;
+
+static bool gen_consistent(const uint32_t *w)
+{
+    for (uint32_t i = 1u; i < GEN_WORDS; i++)
+    {
+        if (w[i] != (w[0] ^ (i * 0x01010101u)))
+            return false;
+    }
+    return true;
+}
+
+static void gen_apply(const void *block)
+{
+    uint32_t w[GEN_WORDS];
+    memcpy(w, block, sizeof(w));
+    if (!inIsr)
+        applyOutsideIsr++;
+    if (!gen_consistent(w))
+        isrTorn++;
+    if (w[0] < isrLastGen)
+        isrBackwards++;
+    isrLastGen = w[0];
+    isrApplied++;
+}
+
+static const GCOM_Config_t genCfg = {
+    .params = genParams, .numParams_u32 = GEN_WORDS, .blockSize_u32 = sizeof(genDefaults),
+    .defaults = genDefaults, .apply = gen_apply
+};
+
+/* PWM period interrupt */
+static void pwm_isr(int sig)
+{
+    (void)sig;
+    inIsr = 1u;
+    GCOM_ApplyPending();
+    inIsr = 0u;
+}
+
+static void timer_start(void (*handler)(int))
+{
+    struct sigaction sa;
+    struct itimerval it = { { 0, STRESS_TICK_US }, { 0, STRESS_TICK_US } };
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGALRM, &sa, NULL);
+    setitimer(ITIMER_REAL, &it, NULL);
+}
+
+static void timer_stop(void)
+{
+    struct itimerval it = { { 0, 0 }, { 0, 0 } };
+    setitimer(ITIMER_REAL, &it, NULL);
+    signal(SIGALRM, SIG_IGN);
+}
+
+static void test_apply_under_preemption(void)
+{
+    uint8_t entries[GEN_WORDS * 5u];
+    uint32_t badIndex, published = 0u, republished = 0u, busy = 0u, readTorn = 0u, reads = 0u, gen = 1u;
+
+    for (uint32_t i = 0u; i < GEN_WORDS; i++)
+    {
+        genParams[i] = (GCOM_ParamDesc_t){ (uint8_t)(i + 1u), GCOM_PT_U32, (uint16_t)(4u * i), 0u, 0xFFFFFFFFu };
+        genDefaults[i] = i * 0x01010101u;
+    }
+    isrTorn = isrApplied = isrLastGen = isrBackwards = applyOutsideIsr = 0u;
+    GCOM_Init(&genCfg, NULL);
+    CHECK((isrApplied == 1u) && (applyOutsideIsr == 1u));          // the one from init
+    applyOutsideIsr = 0u;
+
+    /* Mostly reading, so the interrupt often lands inside the copy; the next block
+     * is published as soon as the previous one was taken over */
+    timer_start(pwm_isr);
+    while (published < STRESS_SETS)
+    {
+        uint32_t w[GEN_WORDS];
+        GCOM_ReadParams(w);
+        readTorn += gen_consistent(w) ? 0u : 1u;
+        reads++;
+        if (GCOM_IsApplyPending())
+            continue;
+
+        for (uint32_t i = 0u; i < GEN_WORDS; i++)
+        {
+            entries[5u * i] = (uint8_t)(i + 1u);
+            put_le(&entries[(5u * i) + 1u], gen ^ (i * 0x01010101u), 4u);
+        }
+        CHECK(GCOM_SetParams(entries, sizeof(entries), &badIndex) == GCOM_OK);
+        published++;
+        gen++;
+
+        /* The handoff refuses a second block until the first was applied; if the
+         * interrupt took it over in between, the same block goes out again */
+        const GCOM_Status_t st = GCOM_SetParams(entries, sizeof(entries), &badIndex);
+        if (st == GCOM_ERR_BUSY)
+            busy++;
+        else
+            republished += (st == GCOM_OK) ? 1u : 0u;
+    }
+    while (GCOM_IsApplyPending())
+    {
+    }
+    timer_stop();
+
+    CHECK_MSG(isrTorn == 0u, "%u torn blocks applied", isrTorn);
+    CHECK_MSG(readTorn == 0u, "%u torn reads of %u", readTorn, reads);
+    CHECK(isrBackwards == 0u);
+    CHECK(applyOutsideIsr == 0u);
+    CHECK(isrApplied == (published + republished + 1u));
+    CHECK(GCOM_GetStats()->applied_u32 == (published + republished));
+    CHECK((busy + republished) == published);
+    CHECK(isrLastGen == (gen - 1u));
+    printf("%u blocks applied at the PWM interrupt, %u SETs answered busy, %u reads\n", published, busy, reads);
+}
+
+int main(void)
+{
+    test_crc_and_encode();
+    test_decoder();
+    test_init_and_get();
+    test_set();
+    test_storage();
+    test_commands_and_types();
+    test_task_bounds();
+    test_apply_under_preemption();
+    return TEST_DONE();
+}
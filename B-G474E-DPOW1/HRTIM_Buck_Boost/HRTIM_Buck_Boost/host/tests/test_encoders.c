@@ -0,0 +1,373 @@
+/*
+ * test_encoders.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  M/T speed estimation of encoders.c on synthetic quadrature edges.
+ *
+ *  A shaft model steps in TIM4 ticks (10 MHz) along a speed profile. Edge k of the
+ *  x4 count sits at position k + err[k % 4], so the quadrature phase and duty errors
+ *  of a real encoder can be dialled in. The model plays both timers: TIM3->CNT is
+ *  the edge count, TIM4->CCR1 the tick of the newest edge, CC1IF set when edges
+ *  came since the last read. ENC_Update() runs on every control tick (128 us), as
+ *  in HRTIM1_TIMC_IRQHandler.
+ *
+ *  Accuracy is checked against the true speed with the error the method allows:
+ *  one capture tick at each end of a window, the edge errors spread over the counts
+ *  in it, and the lag of a window-long average when the speed ramps. Position is
+ *  checked against the count across 16-bit wraps. The cost is ENC_Process() on the
+ *  host, per update.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_check.h"
+#include "hal_fake.h"
+#include "encoders.h"
+
+#define CTRL_TICKS          1280u       /* 128 us at ENC_TIME_HZ: the HRTIM control tick */
+#define SIM_DT              (1.0 / (double)ENC_TIME_HZ)
+#define BENCH_UPDATES       1000000u
+
+/* --- Shaft and timers --- */
+
+typedef double (*Profile_t)(double t);
+
+typedef struct
+{
+    Profile_t speed;            /* counts/s at time t          */
+    double    err[4];           /* edge offsets, counts        */
+    double    theta;            /* position, counts            */
+    int64_t   count;
+    uint64_t  tick;             /* TIM4 time                   */
+    uint64_t  tick0;            /* at the start of the profile */
+    uint64_t  lastEdge;
+    uint64_t  edgesSinceRead;
+} Shaft_t;
+
+static Shaft_t sh;
+
+/* Edge c sits at c + err[c % 4]: count = index of the last edge at or below theta */
+static int64_t shaft_count(double theta)
+{
+    int64_t c = (int64_t)floor(theta);
+    if (theta < ((double)c + sh.err[(uint64_t)c & 3u]))
+        c--;
+    else if (theta >= ((double)(c + 1) + sh.err[(uint64_t)(c + 1) & 3u]))
+        c++;
+    return c;
+}
+
+static void shaft_start(Profile_t speed, const double err[4], double theta0)
+{
+    hal_fake_reset();
+    memset(&sh, 0, sizeof(sh));
+    sh.speed = speed;
+    if (err != NULL)
+        memcpy(sh.err, err, sizeof(sh.err));
+    sh.theta = theta0;
+    sh.count = shaft_count(theta0);
+    sh.tick  = sh.tick0 = 12345u;                                // TIM4 not at 0
+    TIM3->CNT = (uint16_t)sh.count;
+    TIM4->CNT = (uint16_t)sh.tick;
+    ENC_Init();
+}
+
+static double sim_time(void)
+{
+    return (double)(sh.tick - sh.tick0) * SIM_DT;
+}
+
+/* One control tick of shaft motion, then the ISR's ENC_Update() */
+static const ENC_Snapshot_t *control_tick(void)
+{
+    for (uint32_t i = 0u; i < CTRL_TICKS; i++)
+    {
+        sh.theta += sh.speed(sim_time()) * SIM_DT;
+        sh.tick++;
+        const int64_t c = shaft_count(sh.theta);
+        if (c != sh.count)
+        {
+            sh.count = c;
+            sh.lastEdge = sh.tick;
+            sh.edgesSinceRead++;
+        }
+    }
+    TIM3->CNT  = (uint16_t)sh.count;
+    TIM4->CNT  = (uint16_t)sh.tick;
+    TIM4->CCR1 = (uint16_t)sh.lastEdge;
+    if (sh.edgesSinceRead > 0u)
+        TIM4->SR |= TIM_SR_CC1IF;
+
+    const ENC_Snapshot_t *snap = ENC_Update();
+
+    TIM4->SR &= ~TIM_SR_CC1IF;                                   // cleared by the CCR1 read
+    sh.edgesSinceRead = 0u;
+    return snap;
+}
+
+static double cps(const ENC_Snapshot_t *s)
+{
+    return (double)s->speed_cps_q8 / 256.0;
+}
+
+/* --- Profiles --- */
+
+static double vConst;
+static double prof_const(double t) { (void)t; return vConst; }
+
+/* ------------------------------------------------------------------------- */
+
+static void test_snapshot_before_update(void)
+{
+    ENC_Snapshot_t s;
+
+    shaft_start(prof_const, NULL, 0.5);
+    CHECK(!ENC_GetSnapshot(&s));
+    const ENC_Snapshot_t *u = control_tick();
+    CHECK(ENC_GetSnapshot(&s));
+    CHECK(memcmp(&s, u, sizeof(s)) == 0);
+    CHECK((s.seq_u32 == 1u) && (s.speed_cps_q8 == 0) && !s.speedValid && (s.edgeAge_u32 == UINT32_MAX));
+}
+
+/* Worst relative error over the valid snapshots after settling; the share of them valid */
+static double run_constant(double v, const double err[4], double *validShare, double *meanRel)
+{
+    double worst = 0.0, sum = 0.0;
+    uint32_t n = 0u, valid = 0u;
+
+    vConst = v;
+    shaft_start(prof_const, err, 0.5);
+    while (sim_time() < 0.3)
+        control_tick();
+    while (sim_time() < 0.8)
+    {
+        const ENC_Snapshot_t *s = control_tick();
+        n++;
+        if (!s->speedValid)
+            continue;
+        valid++;
+        const double rel = (cps(s) - v) / v;
+        sum += rel;
+        if (fabs(rel) > worst)
+            worst = fabs(rel);
+    }
+    *validShare = (double)valid / (double)n;
+    *meanRel = (valid > 0u) ? (sum / (double)valid) : 1.0;
+    return worst;
+}
+
+/* Ideal edges: one capture tick at each end of a window of at least 100 us */
+static void test_constant_speed(void)
+{
+    static const double speeds[] = { 20.0, 150.0, 2000.0, 9000.0, 40000.0, 200000.0, 450000.0, -3000.0, -300000.0 };
+    double share, mean;
+
+    printf("  speed [cps]   rpm    worst err   valid\n");
+    for (uint32_t i = 0u; i < (sizeof(speeds) / sizeof(speeds[0])); i++)
+    {
+        const double v = speeds[i];
+        const double countTicks = (double)ENC_TIME_HZ / fabs(v);
+        const double window = (countTicks > ENC_MIN_WINDOW_TICKS) ? countTicks : (ENC_MIN_WINDOW_TICKS + countTicks);
+        const double tol = (2.0 / window) + 1e-5;                // capture ticks, float
+
+        const double worst = run_constant(v, NULL, &share, &mean);
+        printf("  %10.0f  %6.1f   %8.5f%%   %5.1f%%\n", v, v * 60.0 / ENC_COUNTS_PER_REV, worst * 100.0, share * 100.0);
+        CHECK_MSG(worst <= tol, "%.0f cps: error %.6f, allowed %.6f", v, worst, tol);
+        CHECK_MSG(share >= 0.98, "%.0f cps: %.1f %% valid", v, share * 100.0);
+        CHECK(ENC_GetStats()->windows_u32 > 0u);
+    }
+}
+
+/* Phase and duty errors: a one-count window sees them whole, a long one divided */
+static void test_quadrature_errors(void)
+{
+    static const double err[4] = { 0.0, 0.06, -0.03, -0.05 };   /* B phase, A duty */
+    double share, mean;
+
+    /* Low speed: each window is one edge interval, off by up to the two edge errors */
+    double worst = run_constant(300.0, err, &share, &mean);
+    CHECK_MSG((worst > 0.05) && (worst <= 0.115), "one-count windows: %.4f", worst);
+    CHECK_MSG(fabs(mean) < 0.01, "mean %.5f", mean);                // errors cancel over a revolution
+    CHECK(share >= 0.9);
+
+    /* High speed: ~20 counts per 100 us window, the same errors over 20 counts */
+    worst = run_constant(200000.0, err, &share, &mean);
+    CHECK_MSG(worst <= ((0.11 / 20.0) + (2.0 / 1000.0)), "20-count windows: %.4f", worst);
+    CHECK(share >= 0.98);
+    printf("quadrature errors of 6 %% of a count: %.1f %% at 300 cps, %.2f %% at 200000 cps\n",
+           run_constant(300.0, err, &share, &mean) * 100.0, worst * 100.0);
+}
+
+/* Position and delta against the count, across many 16-bit wraps both ways */
+static double prof_spin(double t) { return (t < 0.4) ? 450000.0 : -450000.0; }
+
+static void test_position(void)
+{
+    uint32_t bad = 0u;
+
+    shaft_start(prof_spin, NULL, 0.5);
+    int32_t prev = (int32_t)sh.count;
+    while (sim_time() < 0.9)
+    {
+        const ENC_Snapshot_t *s = control_tick();
+        bad += (s->pos_s32 != (int32_t)sh.count) ? 1u : 0u;
+        bad += (s->delta_s32 != (s->pos_s32 - prev)) ? 1u : 0u;
+        prev = s->pos_s32;
+    }
+    CHECK_MSG(bad == 0u, "%u position errors", bad);
+    CHECK(sh.count < -20000);                                    // went through 0 and on
+}
+
+/* Reversal: 0 from the reversing edge until a window in the new direction closes */
+static double prof_reverse(double t) { return (t < 0.1) ? 5000.0 : -5000.0; }
+
+static void test_reversal(void)
+{
+    uint32_t wrongSign = 0u;
+    double firstNeg = -1.0;
+
+    shaft_start(prof_reverse, NULL, 0.5);
+    while (sim_time() < 0.2)
+    {
+        const ENC_Snapshot_t *s = control_tick();
+        const double t = sim_time();
+        if (t < 0.1)
+            continue;
+        /* The position keeps rising for a moment after the speed reversed: no new edge
+         * up to the peak, then the reversing edge */
+        if ((sh.count < 500) && (cps(s) > 0.0))
+            wrongSign++;
+        if ((firstNeg < 0.0) && s->speedValid && (cps(s) < 0.0))
+            firstNeg = t;
+    }
+    CHECK_MSG(wrongSign == 0u, "%u positive readings after the reversing edge", wrongSign);
+    CHECK(firstNeg > 0.1);
+    CHECK_MSG(firstNeg < 0.1 + 0.0008, "valid again after %.3f ms", (firstNeg - 0.1) * 1e3);
+    CHECK(fabs((cps(control_tick()) + 5000.0) / 5000.0) < 0.003);
+}
+
+/* Stop: the bound of one count per edge age pulls the reading down, 0 after 200 ms */
+static double prof_stop(double t) { return (t < 0.1) ? 1000.0 : 0.0; }
+
+static void test_stop(void)
+{
+    double last = 1e9;
+    uint32_t rises = 0u, aboveBound = 0u;
+    const ENC_Snapshot_t *s = NULL;
+
+    shaft_start(prof_stop, NULL, 0.5);
+    while (sim_time() < 0.1)
+        control_tick();
+    while (sim_time() < 0.35)
+    {
+        s = control_tick();
+        const double mag = fabs(cps(s));
+        if (mag > (last + 1e-6))
+            rises++;
+        last = mag;
+        if ((s->edgeAge_u32 > 0u) && (s->edgeAge_u32 != UINT32_MAX) &&
+            (mag > ((double)ENC_TIME_HZ / (double)s->edgeAge_u32) + 0.01))
+            aboveBound++;
+    }
+    CHECK(rises == 0u);
+    CHECK(aboveBound == 0u);
+    CHECK((s->speed_cps_q8 == 0) && !s->speedValid && (s->edgeAge_u32 == UINT32_MAX));
+
+    /* Moving again: the first edge opens a window, the second closes it */
+    vConst = 1000.0;
+    sh.speed = prof_const;
+    uint32_t ticks = 0u;
+    while (!control_tick()->speedValid && (ticks < 100u))
+        ticks++;
+    CHECK_MSG(ticks <= ((2u * ENC_TIME_HZ / 1000u) / CTRL_TICKS) + 2u, "%u ticks to the first speed", ticks);
+}
+
+/* Dithering across one edge: every edge reverses, the speed stays 0 */
+static double prof_dither(double t) { return 0.3 * 2.0 * M_PI * 50.0 * cos(2.0 * M_PI * 50.0 * t); }
+
+static void test_dither(void)
+{
+    uint32_t nonzero = 0u;
+
+    shaft_start(prof_dither, NULL, 0.0);
+    while (sim_time() < 0.5)
+        nonzero += (control_tick()->speed_cps_q8 != 0) ? 1u : 0u;
+    CHECK_MSG(nonzero == 0u, "%u non-zero readings", nonzero);
+}
+
+/* Ramp: the reading is the average over the last closed window, so it lags by half a
+ * window plus the time since that window closed, at most one more window */
+#define RAMP_CPS_PER_S      400000.0
+static double prof_ramp(double t) { return (t < 1.0) ? (RAMP_CPS_PER_S * t) : RAMP_CPS_PER_S; }
+
+static void test_ramp(void)
+{
+    double worstExcess = 0.0;
+
+    shaft_start(prof_ramp, NULL, 0.5);
+    while (sim_time() < 1.0)
+    {
+        const ENC_Snapshot_t *s = control_tick();
+        const double v = prof_ramp(sim_time());
+        if ((v < 5000.0) || !s->speedValid)
+            continue;
+        /* A window closes at the first update that sees an edge 100 us or more after its start */
+        const double window = fmax(1.0 / v, (double)ENC_MIN_WINDOW_TICKS / ENC_TIME_HZ) +
+                              ((double)CTRL_TICKS / ENC_TIME_HZ) + (1.0 / v);
+        const double lagAllowed = RAMP_CPS_PER_S * 1.5 * window;
+        const double quant = (v * 2.0) / (window * ENC_TIME_HZ);   /* a capture tick at each end */
+        const double excess = fabs(cps(s) - v) - lagAllowed - quant;
+        if (excess > worstExcess)
+            worstExcess = excess;
+    }
+    CHECK_MSG(worstExcess <= 0.0, "ramp error above the window lag by %.1f cps", worstExcess);
+}
+
+/* Host cost of the estimator per update, on a recorded raw sequence */
+static void test_cost(void)
+{
+    static ENC_Raw_t raws[4096];
+    ENC_t e;
+    struct timespec t0, t1;
+
+    vConst = 123456.0;
+    shaft_start(prof_const, NULL, 0.5);
+    for (uint32_t i = 0u; i < 4096u; i++)
+    {
+        control_tick();
+        raws[i] = (ENC_Raw_t){ (uint16_t)sh.count, (uint16_t)sh.tick, (uint16_t)sh.lastEdge, true };
+    }
+
+    uint32_t windows = 0u;
+    ENC_Reset(&e, &raws[0]);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t i = 0u; i < BENCH_UPDATES; i++)
+    {
+        const uint32_t k = i & 4095u;
+        if (k == 0u)
+            ENC_Reset(&e, &raws[0]);
+        windows += ENC_Process(&e, &raws[k]) ? 1u : 0u;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    const double ns = (((double)(t1.tv_sec - t0.tv_sec) * 1e9) + (double)(t1.tv_nsec - t0.tv_nsec)) / BENCH_UPDATES;
+    CHECK(windows > (BENCH_UPDATES / 2u));
+    printf("ENC_Process: %.1f ns per update on the host, %u windows\n", ns, windows);
+}
+
+int main(void)
+{
+    test_snapshot_before_update();
+    test_constant_speed();
+    test_quadrature_errors();
+    test_position();
+    test_reversal();
+    test_stop();
+    test_dither();
+    test_ramp();
+    test_cost();
+    return TEST_DONE();
+}
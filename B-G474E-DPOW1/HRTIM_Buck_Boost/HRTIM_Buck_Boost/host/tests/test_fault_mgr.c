@@ -0,0 +1,302 @@
+/*
+ * test_fault_mgr.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Fault sequences injected into fault_mgr.c the way the firmware drives it:
+ *  FAULT_CheckSample() once per injected sequence (32 us), FAULT_Task() once per
+ *  millisecond of simulated time. Debounce per cause, one trip call per trip, the
+ *  hysteresis, the doubling back-off into the lockout, the UVLO restart, the retry
+ *  reset after a clean run and the log contents along the way.
+ */
+
+#include <string.h>
+
+#include "test_check.h"
+#include "hal_fake.h"
+#include "fault_mgr.h"
+
+#define SEQ_PER_MS          31u             /* 31.25 kHz */
+
+/* Operating point and levels around the default thresholds */
+#define VOUT_OK_mV          5000u
+#define VOUT_HYST_mV        9500u           /* between release and trip */
+#define VOUT_OVP_mV         10200u
+#define IIN_OK_mV           1000u
+#define IIN_HYST_mV         2700u
+#define IIN_OCP_mV          3100u
+#define VIN_OK_mV           12000u
+#define VIN_HYST_mV         4200u
+#define VIN_UVLO_mV         3500u
+
+static uint32_t trips;
+static uint32_t now_ms;
+
+static void trip_fn(void)
+{
+    trips++;
+    hal_fake_cycles(120u);      // time to the outputs off
+}
+
+static void sample(uint16_t raw[MEAS_NUM_CH], uint32_t vout_mV, uint32_t iinPin_mV, uint32_t vin_mV)
+{
+    raw[MEAS_CH_VOUT]       = MEAS_ScaledToCode(MEAS_CH_VOUT, vout_mV);
+    raw[MEAS_CH_I_IN_SENSE] = MEAS_PinToCode(MEAS_CH_I_IN_SENSE, iinPin_mV);
+    raw[MEAS_CH_I_IN_AVG]   = raw[MEAS_CH_I_IN_SENSE];
+    raw[MEAS_CH_VIN]        = MEAS_ScaledToCode(MEAS_CH_VIN, vin_mV);
+}
+
+static void check_seq(uint32_t vout_mV, uint32_t iinPin_mV, uint32_t vin_mV)
+{
+    uint16_t raw[MEAS_NUM_CH];
+
+    sample(raw, vout_mV, iinPin_mV, vin_mV);
+    FAULT_CheckSample(raw, now_ms, DWT->CYCCNT);
+}
+
+/* ms of simulated time at one operating point; returns the restarts seen */
+static uint32_t run_ms(uint32_t ms, uint32_t vout_mV, uint32_t iinPin_mV, uint32_t vin_mV)
+{
+    uint32_t restarts = 0u;
+
+    for (uint32_t t = 0u; t < ms; t++)
+    {
+        for (uint32_t k = 0u; k < SEQ_PER_MS; k++)
+        {
+            check_seq(vout_mV, iinPin_mV, vin_mV);
+        }
+        now_ms++;
+        restarts += FAULT_Task(now_ms) ? 1u : 0u;
+    }
+    return restarts;
+}
+
+/* One millisecond of sequences at the current time: the trip happens at now_ms */
+static void trip_now(uint32_t vout_mV, uint32_t iinPin_mV, uint32_t vin_mV)
+{
+    for (uint32_t k = 0u; k < SEQ_PER_MS; k++)
+    {
+        check_seq(vout_mV, iinPin_mV, vin_mV);
+    }
+}
+
+/* Ms at the operating point until FAULT_Task() restarts, 0 if not within limit_ms */
+static uint32_t ms_to_restart(uint32_t limit_ms)
+{
+    for (uint32_t t = 1u; t <= limit_ms; t++)
+    {
+        if (run_ms(1u, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV) != 0u)
+            return t;
+    }
+    return 0u;
+}
+
+static void reset(uint32_t start_ms)
+{
+    hal_fake_reset();
+    MEAS_CalibLoad();           // erased flash: nominal gains
+    trips  = 0u;
+    now_ms = start_ms;
+    FAULT_Init(trip_fn);
+}
+
+static void test_debounce(void)
+{
+    reset(1000u);
+
+    /* OVP: one sequence above is noise, two in a row trip */
+    check_seq(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    check_seq(VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV);
+    check_seq(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(FAULT_GetState() == FAULT_STATE_OK);
+    CHECK(trips == 0u);
+    check_seq(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(FAULT_GetState() == FAULT_STATE_TRIPPED);
+    CHECK(FAULT_GetCauses() == FAULT_CAUSE_OVP);
+    CHECK(trips == 1u);
+    CHECK(FAULT_GetStats()->lastReactCycles_u32 == 120u);
+
+    /* OCP: the first sequence */
+    reset(1000u);
+    check_seq(VOUT_OK_mV, IIN_OCP_mV, VIN_OK_mV);
+    CHECK(FAULT_GetCauses() == FAULT_CAUSE_OCP);
+
+    /* UVLO: eight in a row, a good one in between starts over */
+    reset(1000u);
+    for (uint32_t k = 0u; k < (FAULT_UVLO_SAMPLES - 1u); k++)
+        check_seq(VOUT_OK_mV, IIN_OK_mV, VIN_UVLO_mV);
+    check_seq(VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV);
+    for (uint32_t k = 0u; k < (FAULT_UVLO_SAMPLES - 1u); k++)
+        check_seq(VOUT_OK_mV, IIN_OK_mV, VIN_UVLO_mV);
+    CHECK(FAULT_GetState() == FAULT_STATE_OK);
+    check_seq(VOUT_OK_mV, IIN_OK_mV, VIN_UVLO_mV);
+    CHECK(FAULT_GetCauses() == FAULT_CAUSE_UVLO);
+
+    /* Without a trip function the samples are ignored */
+    reset(1000u);
+    FAULT_Init(NULL);
+    run_ms(5u, VOUT_OVP_mV, IIN_OCP_mV, VIN_UVLO_mV);
+    CHECK(FAULT_GetState() == FAULT_STATE_OK);
+    CHECK(FAULT_GetLogCount() == 0u);
+}
+
+/* One trip call, later causes are added to the latch and logged once each */
+static void test_latch_and_log(void)
+{
+    FAULT_LogEntry_t log[FAULT_LOG_LEN];
+
+    reset(5000u);
+    check_seq(VOUT_OK_mV, IIN_OCP_mV, VIN_OK_mV);
+    now_ms += 3u;
+    run_ms(2u, VOUT_OVP_mV, IIN_OCP_mV, VIN_OK_mV);
+    FAULT_Report(FAULT_CAUSE_HW_FLT, 0u, now_ms);
+    CHECK(__get_PRIMASK() == 0u);                               // restored
+    FAULT_Report(FAULT_CAUSE_HW_FLT, 0u, now_ms);               // already latched: no entry
+
+    CHECK(trips == 1u);
+    CHECK(FAULT_GetStats()->trips_u32 == 1u);
+    CHECK(FAULT_GetCauses() == (FAULT_CAUSE_OCP | FAULT_CAUSE_OVP | FAULT_CAUSE_HW_FLT));
+    CHECK(FAULT_GetLogCount() == 3u);
+    CHECK(FAULT_ReadLog(log, FAULT_LOG_LEN) == 3u);
+    CHECK((log[0].cause_u8 == FAULT_CAUSE_OCP) && (log[0].time_ms == 5000u));
+    CHECK(log[0].value_u16 == MEAS_PinToCode(MEAS_CH_I_IN_SENSE, IIN_OCP_mV));
+    CHECK((log[1].cause_u8 == FAULT_CAUSE_OVP) && (log[1].time_ms == 5003u));
+    CHECK(log[1].value_u16 == MEAS_ScaledToCode(MEAS_CH_VOUT, VOUT_OVP_mV));
+    CHECK((log[2].cause_u8 == FAULT_CAUSE_HW_FLT) && (log[2].time_ms == 5005u) && (log[2].value_u16 == 0u));
+    CHECK((log[0].retry_u8 == 0u) && (log[2].retry_u8 == 0u));
+    CHECK(FAULT_ReadLog(log, 2u) == 2u);
+    CHECK(log[0].cause_u8 == FAULT_CAUSE_OVP);                  // the newest two, oldest first
+    CHECK(FAULT_ReadLog(NULL, 2u) == 0u);
+}
+
+/* Outputs stay off while a level sits between release and trip */
+static void test_hysteresis(void)
+{
+    reset(0u);
+    run_ms(1u, VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(run_ms(2000u, VOUT_HYST_mV, IIN_OK_mV, VIN_OK_mV) == 0u);
+    CHECK(FAULT_GetState() == FAULT_STATE_TRIPPED);
+    CHECK(run_ms(1u, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV) == 1u);  // back-off long over
+
+    reset(0u);
+    run_ms(1u, VOUT_OK_mV, IIN_OCP_mV, VIN_OK_mV);
+    CHECK(run_ms(2000u, VOUT_OK_mV, IIN_HYST_mV, VIN_OK_mV) == 0u);
+    CHECK(run_ms(1u, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV) == 1u);
+
+    reset(0u);
+    run_ms(1u, VOUT_OK_mV, IIN_OK_mV, VIN_UVLO_mV);
+    CHECK(run_ms(2000u, VOUT_OK_mV, IIN_OK_mV, VIN_HYST_mV) == 0u);
+    CHECK(run_ms(1u, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV) == 1u);
+}
+
+/*
+ * OVP over and over: 500, 1000, 2000, 4000 ms off, then the lockout. Trips right
+ * after each restart, so the retries never reset. Started just below the 32-bit
+ * wrap of the millisecond clock, which the back-off must not notice.
+ */
+static void test_backoff_and_lockout(void)
+{
+    FAULT_LogEntry_t log[FAULT_LOG_LEN];
+
+    reset(0xFFFFFF00u);
+    for (uint32_t r = 0u; r < FAULT_MAX_RETRIES; r++)
+    {
+        trip_now(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+        CHECK(FAULT_GetState() == FAULT_STATE_TRIPPED);
+        const uint32_t backoff = ms_to_restart(10000u);
+        CHECK_MSG(backoff == (FAULT_BACKOFF_BASE_ms << r), "retry %u after %u ms", r, backoff);
+        CHECK(FAULT_GetState() == FAULT_STATE_OK);
+    }
+    CHECK(trips == FAULT_MAX_RETRIES);
+
+    trip_now(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(run_ms(1u, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV) == 0u);
+    CHECK(FAULT_GetState() == FAULT_STATE_LOCKOUT);
+    CHECK(ms_to_restart(60000u) == 0u);                         // stays off
+    CHECK(FAULT_GetStats()->restarts_u32 == FAULT_MAX_RETRIES);
+
+    /* Log: the trips with the retries used so far, then the lockout */
+    CHECK(FAULT_ReadLog(log, FAULT_LOG_LEN) == (FAULT_MAX_RETRIES + 2u));
+    for (uint32_t r = 0u; r <= FAULT_MAX_RETRIES; r++)
+    {
+        CHECK((log[r].cause_u8 == FAULT_CAUSE_OVP) && (log[r].retry_u8 == r));
+    }
+    CHECK(log[FAULT_MAX_RETRIES + 1u].cause_u8 == FAULT_CAUSE_LOCKOUT);
+    CHECK(log[FAULT_MAX_RETRIES + 1u].retry_u8 == FAULT_MAX_RETRIES);
+
+    /* Cleared: the first back-off step again, counted from the clear */
+    FAULT_ClearLockout(now_ms);
+    CHECK(FAULT_GetState() == FAULT_STATE_TRIPPED);
+    CHECK(ms_to_restart(10000u) == FAULT_BACKOFF_BASE_ms);
+    trip_now(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(ms_to_restart(10000u) == (2u * FAULT_BACKOFF_BASE_ms));
+}
+
+/* A clean run of FAULT_RETRY_RESET_ms forgets the retries, a shorter one does not */
+static void test_retry_reset(void)
+{
+    reset(0u);
+    trip_now(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(ms_to_restart(10000u) == FAULT_BACKOFF_BASE_ms);
+    run_ms(FAULT_RETRY_RESET_ms - 10u, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV);
+    trip_now(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(ms_to_restart(10000u) == (2u * FAULT_BACKOFF_BASE_ms));
+
+    run_ms(FAULT_RETRY_RESET_ms, VOUT_OK_mV, IIN_OK_mV, VIN_OK_mV);
+    trip_now(VOUT_OVP_mV, IIN_OK_mV, VIN_OK_mV);
+    CHECK(ms_to_restart(10000u) == FAULT_BACKOFF_BASE_ms);
+}
+
+/* UVLO restarts after the fixed delay, never counts and never locks out */
+static void test_uvlo(void)
+{
+    reset(100u);
+    for (uint32_t n = 0u; n < (3u * FAULT_MAX_RETRIES); n++)
+    {
+        trip_now(VOUT_OK_mV, IIN_OK_mV, VIN_UVLO_mV);
+        CHECK(FAULT_GetCauses() == FAULT_CAUSE_UVLO);
+        CHECK(ms_to_restart(10000u) == FAULT_UVLO_RESTART_ms);
+    }
+    CHECK(FAULT_GetState() == FAULT_STATE_OK);
+
+    /* UVLO on top of a counted cause: the counted back-off applies */
+    trip_now(VOUT_OK_mV, IIN_OCP_mV, VIN_UVLO_mV);
+    CHECK(FAULT_GetCauses() == (FAULT_CAUSE_OCP | FAULT_CAUSE_UVLO));
+    CHECK(ms_to_restart(10000u) == FAULT_BACKOFF_BASE_ms);
+}
+
+/* 20 events in a 16 entry ring: the newest 15 come back, in order */
+static void test_log_wrap(void)
+{
+    FAULT_LogEntry_t log[FAULT_LOG_LEN];
+
+    reset(0u);
+    for (uint32_t n = 0u; n < 20u; n++)
+    {
+        FAULT_Report(FAULT_CAUSE_UVLO, (uint16_t)n, now_ms);
+        now_ms += FAULT_UVLO_RESTART_ms - 1u;
+        CHECK(!FAULT_Task(now_ms));
+        now_ms += 1u;
+        CHECK(FAULT_Task(now_ms));
+    }
+    CHECK(FAULT_GetLogCount() == 20u);
+    CHECK(FAULT_ReadLog(log, 100u) == (FAULT_LOG_LEN - 1u));
+    for (uint32_t i = 0u; i < (FAULT_LOG_LEN - 1u); i++)
+    {
+        const uint32_t n = 20u - (FAULT_LOG_LEN - 1u) + i;
+        CHECK((log[i].value_u16 == n) && (log[i].time_ms == (n * FAULT_UVLO_RESTART_ms)));
+    }
+}
+
+int main(void)
+{
+    test_debounce();
+    test_latch_and_log();
+    test_hysteresis();
+    test_backoff_and_lockout();
+    test_retry_reset();
+    test_uvlo();
+    test_log_wrap();
+    return TEST_DONE();
+}
@@ -0,0 +1,153 @@
+/*
+ * test_hw_math.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  The square root of hw_math.c against a double precision reference. The host has
+ *  no CORDIC, so the software path is checked for every x up to 2^20, on both sides
+ *  of every rounding boundary (c^2 + c, c^2 + c + 1) and on random x across the full
+ *  range. HMATH_SqrtRound(), which the CORDIC estimate goes through on the target,
+ *  must give the same result from estimates a few LSB off, as well as from the
+ *  extremes of the result range.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "hw_math.h"
+
+static uint32_t rng = 12345u;
+
+static uint32_t xorshift(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* round(sqrt(x)) in double: exact for 32 bit x (no root is within 2^-20 of a half) */
+static uint32_t ref_sqrt(uint32_t x)
+{
+    return (uint32_t)lround(sqrt((double)x));
+}
+
+/* --- Software path --- */
+
+static void test_small_exhaustive(void)
+{
+    uint32_t bad = 0u;
+
+    for (uint32_t x = 0u; x <= (1uL << 20); x++)
+    {
+        if (HMATH_SwSqrt32(x) != ref_sqrt(x))
+        {
+            if (bad++ < 5u)
+                printf("sqrt(%u): %u, expected %u\n", x, HMATH_SwSqrt32(x), ref_sqrt(x));
+        }
+    }
+    CHECK(bad == 0u);
+}
+
+/* round(sqrt(x)) steps from c to c + 1 between x = c^2 + c and c^2 + c + 1 */
+static void test_boundaries(void)
+{
+    uint32_t bad = 0u;
+
+    for (uint64_t c = 0u; c < 65536u; c++)
+    {
+        const uint64_t edge = (c * c) + c;
+        if (edge > UINT32_MAX)
+            break;
+        bad += (HMATH_SwSqrt32((uint32_t)edge) == c) ? 0u : 1u;
+        if (edge < UINT32_MAX)
+            bad += (HMATH_SwSqrt32((uint32_t)edge + 1u) == (c + 1u)) ? 0u : 1u;
+    }
+    CHECK(bad == 0u);
+    CHECK(HMATH_SwSqrt32(UINT32_MAX) == 65536u);
+    CHECK(HMATH_SwSqrt32(0xFFFE0001u) == 65535u);
+}
+
+static void test_random(void)
+{
+    uint32_t bad = 0u;
+
+    for (uint32_t i = 0u; i < 2000000u; i++)
+    {
+        const uint32_t x = xorshift() >> (i & 31u);
+        bad += (HMATH_SwSqrt32(x) == ref_sqrt(x)) ? 0u : 1u;
+    }
+    CHECK(bad == 0u);
+}
+
+/* --- Rounding of the CORDIC estimate --- */
+
+static void test_round_from_estimate(void)
+{
+    uint32_t bad = 0u;
+
+    for (uint32_t i = 0u; i < 200000u; i++)
+    {
+        const uint32_t x = (i < 4u) ? ((i < 2u) ? i : (UINT32_MAX - (i - 2u))) : (xorshift() >> (i & 31u));
+        const uint32_t r = ref_sqrt(x);
+
+        for (int32_t k = -3; k <= 3; k++)
+        {
+            const int32_t c = (int32_t)r + k;
+            if (c >= 0)
+                bad += (HMATH_SqrtRound(x, (uint32_t)c) == r) ? 0u : 1u;
+        }
+    }
+    CHECK(bad == 0u);
+
+    /* Boundaries again, estimates on the wrong side of them */
+    bad = 0u;
+    for (uint32_t c = 1u; c < 65535u; c += 7u)
+    {
+        const uint32_t edge = (c * c) + c;
+        bad += (HMATH_SqrtRound(edge, c + 1u) == c) ? 0u : 1u;
+        bad += (HMATH_SqrtRound(edge + 1u, c) == (c + 1u)) ? 0u : 1u;
+    }
+    CHECK(bad == 0u);
+
+    /* Any estimate in range ends at the root, however far off */
+    CHECK(HMATH_SqrtRound(UINT32_MAX, 0u) == 65536u);
+    CHECK(HMATH_SqrtRound(0u, 65536u) == 0u);
+    CHECK(HMATH_SqrtRound(1000000u, 65536u) == 1000u);
+}
+
+/* --- Dispatch in a software build --- */
+
+static void test_sw_build(void)
+{
+    HMATH_BenchItem_t bench[HMATH_BENCH_NUM];
+    uint32_t bad = 0u;
+
+    HMATH_Init();
+    CHECK(!HMATH_HasHw());
+    for (uint32_t i = 0u; i < 100000u; i++)
+    {
+        const uint32_t x = xorshift();
+        bad += (HMATH_Sqrt32(x) == HMATH_SwSqrt32(x)) ? 0u : 1u;
+    }
+    CHECK(bad == 0u);
+    CHECK(HMATH_GetStats()->cordicBusy_u32 == 0u);
+
+    bench[HMATH_BENCH_SQRT].mismatches_u32 = 99u;
+    HMATH_Bench(bench);
+    CHECK((bench[HMATH_BENCH_SQRT].mismatches_u32 == 0u) && (bench[HMATH_BENCH_SQRT].hwCycles_u32 == 0u));
+    CHECK(strcmp(HMATH_BenchName(HMATH_BENCH_SQRT), "sqrt") == 0);
+    CHECK(strcmp(HMATH_BenchName(HMATH_BENCH_NUM), "?") == 0);
+}
+
+int main(void)
+{
+    test_small_exhaustive();
+    test_boundaries();
+    test_random();
+    test_round_from_estimate();
+    test_sw_build();
+    return TEST_DONE();
+}
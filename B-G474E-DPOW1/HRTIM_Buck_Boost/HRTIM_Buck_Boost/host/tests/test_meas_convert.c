@@ -0,0 +1,280 @@
+/*
+ * test_meas_convert.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Q16 conversion of measurements.c against the formulas it replaced, over every
+ *  ADC code and channel:
+ *
+ *      pin_mV    = raw * 3300 / 4095                 (integer division, truncated)
+ *      scaled_mV = pin_mV * 497 / 100 (503 for Vout)  (truncated again)
+ *
+ *  The Q16 result is within 1 LSB of the exact value of those formulas, and within
+ *  1 LSB of the old integer pin voltage. The old scaled value lost up to 1 mV at the
+ *  pin before the x5 divider factor, so there it may be up to 6 mV below. Then the
+ *  calibration (flash record, offset, gain trim), the inverse conversion for the
+ *  thresholds and the host time per MEAS_Convert() against the old divisions.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_check.h"
+#include "hal_fake.h"
+#include "measurements.h"
+
+#define VDDA_mV             3300u
+#define ADC_FS              4095u
+#define BENCH_ROUNDS        2000000u
+
+static const uint32_t scaleNum[MEAS_NUM_CH] = { 497u, 497u, 497u, 503u };
+
+/* The conversion as it was before the Q16 gains */
+static void old_convert(uint16_t raw, uint32_t ch, uint32_t *pin_mV, uint32_t *scaled_mV)
+{
+    *pin_mV    = (raw * VDDA_mV) / ADC_FS;
+    *scaled_mV = (*pin_mV * scaleNum[ch]) / 100u;
+}
+
+static void nominal_calib(Meas_Calib_t *cal)
+{
+    memset(cal, 0, sizeof(*cal));
+    cal->magic_u32 = MEAS_CALIB_MAGIC;
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        cal->gain_u16[ch] = MEAS_CALIB_GAIN_ONE;
+    }
+    cal->checksum_u32 = MEAS_CalibChecksum(cal);
+}
+
+/* One code on all four channels */
+static void convert_code(uint16_t raw, Meas_Values_t *v)
+{
+    const uint16_t rawAll[MEAS_NUM_CH] = { raw, raw, raw, raw };
+    MEAS_Convert(rawAll, v);
+}
+
+static void test_against_old_formulas(void)
+{
+    /* Q16 gain rounding: at most 2^-17 relative, 0.03 LSB at full scale */
+    const double tol = 0.5 + (ADC_FS * 6.0 / 65536.0 / 2.0);
+    double maxPinExact = 0.0, maxScaledExact = 0.0;
+    int32_t maxPinOld = 0, minScaledOld = 0, maxScaledOld = 0;
+    Meas_Calib_t cal;
+    Meas_Values_t v;
+
+    nominal_calib(&cal);
+    CHECK(MEAS_CalibApply(&cal));
+    for (uint32_t raw = 0u; raw <= ADC_FS; raw++)
+    {
+        convert_code((uint16_t)raw, &v);
+        for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+        {
+            uint32_t oldPin, oldScaled;
+            old_convert((uint16_t)raw, ch, &oldPin, &oldScaled);
+            const double exactPin    = (double)raw * VDDA_mV / ADC_FS;
+            const double exactScaled = exactPin * scaleNum[ch] / 100.0;
+            const int32_t dPin    = (int32_t)v.pin_mV_u16[ch] - (int32_t)oldPin;
+            const int32_t dScaled = (int32_t)v.scaled_mV_u16[ch] - (int32_t)oldScaled;
+
+            CHECK(v.raw_u16[ch] == raw);
+            maxPinExact    = fmax(maxPinExact, fabs(v.pin_mV_u16[ch] - exactPin));
+            maxScaledExact = fmax(maxScaledExact, fabs(v.scaled_mV_u16[ch] - exactScaled));
+            maxPinOld      = (abs(dPin) > maxPinOld) ? abs(dPin) : maxPinOld;
+            minScaledOld   = (dScaled < minScaledOld) ? dScaled : minScaledOld;
+            maxScaledOld   = (dScaled > maxScaledOld) ? dScaled : maxScaledOld;
+        }
+    }
+    printf("vs exact: pin %.3f, scaled %.3f LSB; vs old integers: pin %d, scaled %d..%d mV\n",
+           maxPinExact, maxScaledExact, maxPinOld, minScaledOld, maxScaledOld);
+    CHECK(maxPinExact <= tol);
+    CHECK(maxScaledExact <= tol);
+    CHECK(maxPinOld <= 1);
+    CHECK((minScaledOld >= 0) && (maxScaledOld <= 6));      // the old chain only truncated
+
+    /* Full scale: 3300 mV at the pin, 16.4 V / 16.6 V in front of the dividers */
+    convert_code((uint16_t)ADC_FS, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VIN] == 3300u);
+    CHECK(v.scaled_mV_u16[MEAS_CH_VIN] == 16401u);
+    CHECK(v.scaled_mV_u16[MEAS_CH_VOUT] == 16599u);
+}
+
+static void test_calibration(void)
+{
+    Meas_Calib_t cal;
+    Meas_Values_t v;
+
+    /* Offset: subtracted before the gain, clamped at 0 */
+    nominal_calib(&cal);
+    cal.offset_s16[MEAS_CH_VOUT] = 20;
+    cal.offset_s16[MEAS_CH_VIN]  = -10;
+    CHECK(MEAS_CalibApply(&cal));
+    convert_code(1000u, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VOUT] == (uint16_t)lround(980.0 * VDDA_mV / ADC_FS));
+    CHECK(v.pin_mV_u16[MEAS_CH_VIN] == (uint16_t)lround(1010.0 * VDDA_mV / ADC_FS));
+    convert_code(5u, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VOUT] == 0u);
+    CHECK(v.raw_u16[MEAS_CH_VOUT] == 5u);
+
+    /* Gain trim: Q15, 1.01 on Vout is 1 % on both quantities, within 1 LSB everywhere */
+    nominal_calib(&cal);
+    cal.gain_u16[MEAS_CH_VOUT] = (uint16_t)lround(1.01 * MEAS_CALIB_GAIN_ONE);
+    CHECK(MEAS_CalibApply(&cal));
+    for (uint32_t raw = 0u; raw <= ADC_FS; raw += 7u)
+    {
+        convert_code((uint16_t)raw, &v);
+        const double pin = raw * (VDDA_mV / (double)ADC_FS) * cal.gain_u16[MEAS_CH_VOUT] / MEAS_CALIB_GAIN_ONE;
+        CHECK_MSG(fabs(v.pin_mV_u16[MEAS_CH_VOUT] - pin) <= 1.0, "raw %u: %u mV, expected %.2f", raw,
+                  v.pin_mV_u16[MEAS_CH_VOUT], pin);
+        CHECK(fabs(v.scaled_mV_u16[MEAS_CH_VOUT] - (pin * 5.03)) <= 1.0);
+    }
+
+    /* Out of range: rejected, the gains in use stay */
+    convert_code(2000u, &v);
+    const uint16_t before = v.scaled_mV_u16[MEAS_CH_VOUT];
+    nominal_calib(&cal);
+    cal.offset_s16[MEAS_CH_I_IN_AVG] = MEAS_CALIB_OFFSET_MAX + 1;
+    CHECK(!MEAS_CalibApply(&cal));
+    nominal_calib(&cal);
+    cal.gain_u16[MEAS_CH_VIN] = 0u;
+    CHECK(!MEAS_CalibApply(&cal));
+    convert_code(2000u, &v);
+    CHECK(v.scaled_mV_u16[MEAS_CH_VOUT] == before);
+}
+
+static void test_flash_record(void)
+{
+    Meas_Calib_t *flashCal = hal_fake_flash(MEAS_CALIB_FLASH_ADDR);
+    Meas_Values_t v;
+
+    /* Erased page: nominal gains */
+    hal_fake_flash_erase();
+    MEAS_CalibLoad();
+    convert_code(2048u, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VOUT] == 1650u);
+
+    /* Valid record: used */
+    nominal_calib(flashCal);
+    flashCal->offset_s16[MEAS_CH_VOUT] = 48;
+    flashCal->checksum_u32 = MEAS_CalibChecksum(flashCal);
+    MEAS_CalibLoad();
+    convert_code(2048u, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VOUT] == (uint16_t)lround(2000.0 * VDDA_mV / ADC_FS));
+
+    /* One flipped bit: checksum mismatch, back to nominal */
+    flashCal->gain_u16[MEAS_CH_VIN] ^= 0x0100u;
+    MEAS_CalibLoad();
+    convert_code(2048u, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VOUT] == 1650u);
+
+    /* Consistent but out of range: rejected as well */
+    nominal_calib(flashCal);
+    flashCal->offset_s16[MEAS_CH_VIN] = -(MEAS_CALIB_OFFSET_MAX + 1);
+    flashCal->offset_s16[MEAS_CH_VOUT] = 48;
+    flashCal->checksum_u32 = MEAS_CalibChecksum(flashCal);
+    MEAS_CalibLoad();
+    convert_code(2048u, &v);
+    CHECK(v.pin_mV_u16[MEAS_CH_VOUT] == 1650u);
+    hal_fake_flash_erase();
+}
+
+/* Threshold codes: converting them back lands within one code step of the voltage,
+ * beyond the reach of the channel the code saturates at full scale */
+static void test_inverse(void)
+{
+    Meas_Calib_t cal;
+    Meas_Values_t v;
+
+    nominal_calib(&cal);
+    cal.offset_s16[MEAS_CH_I_IN_SENSE] = 31;
+    cal.gain_u16[MEAS_CH_VOUT] = 0x7E00u;
+    CHECK(MEAS_CalibApply(&cal));
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        for (uint32_t mV = 0u; mV <= 3300u; mV += 11u)
+        {
+            const uint16_t code = MEAS_PinToCode((Meas_Channel_t)ch, mV);
+            convert_code(code, &v);
+            if (code == ADC_FS)
+            {
+                CHECK(v.pin_mV_u16[ch] <= mV);
+                continue;
+            }
+            CHECK_MSG(abs((int32_t)v.pin_mV_u16[ch] - (int32_t)mV) <= 1, "ch %u: %u mV -> code %u -> %u mV", ch, mV,
+                      code, v.pin_mV_u16[ch]);
+        }
+        for (uint32_t mV = 0u; mV <= 16000u; mV += 37u)
+        {
+            const uint16_t code = MEAS_ScaledToCode((Meas_Channel_t)ch, mV);
+            convert_code(code, &v);
+            CHECK((code == ADC_FS) || abs((int32_t)v.scaled_mV_u16[ch] - (int32_t)mV) <= 3);     // 4 mV per code
+        }
+    }
+    CHECK(MEAS_PinToCode(MEAS_CH_VIN, 5000u) == ADC_FS);
+    CHECK(MEAS_PinToCode(MEAS_NUM_CH, 1000u) == 0u);
+    CHECK(MEAS_PinToCode(MEAS_CH_I_IN_SENSE, 0u) == 31u);            // the zero of the current sense
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/* Four channels per call, against the two divisions per channel it replaced */
+static void test_bench(void)
+{
+    volatile uint32_t sink = 0u;
+    Meas_Calib_t cal;
+    Meas_Values_t v;
+    uint16_t raw[MEAS_NUM_CH] = { 1234u, 2345u, 3456u, 4095u };
+
+    nominal_calib(&cal);
+    CHECK(MEAS_CalibApply(&cal));
+
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0u; i < BENCH_ROUNDS; i++)
+    {
+        raw[i & 3u] = (uint16_t)(i & 0x0FFFu);
+        MEAS_Convert(raw, &v);
+        sink += v.scaled_mV_u16[i & 3u];
+    }
+    const double q16_ns = (double)(now_ns() - t0) / BENCH_ROUNDS;
+
+    /* Runtime divisors, as the Cortex-M4 executes UDIV for the old code */
+    volatile uint32_t fs = ADC_FS, den = 100u;
+    t0 = now_ns();
+    for (uint32_t i = 0u; i < BENCH_ROUNDS; i++)
+    {
+        raw[i & 3u] = (uint16_t)(i & 0x0FFFu);
+        for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+        {
+            const uint32_t pin = (raw[ch] * VDDA_mV) / fs;
+            sink += (pin * scaleNum[ch]) / den;
+        }
+    }
+    const double div_ns = (double)(now_ns() - t0) / BENCH_ROUNDS;
+    (void)sink;
+
+    printf("MEAS_Convert: %.1f ns per 4 channels on the host, old divisions %.1f ns, sample period %.0f ns\n",
+           q16_ns, div_ns, 1e9 / MEAS_SAMPLE_RATE_HZ);
+    CHECK(q16_ns < (0.01 * 1e9 / MEAS_SAMPLE_RATE_HZ));     // 1 % of the JEOS period, with room for slow hosts
+
+    /* The target benchmark reads DWT->CYCCNT, which only the test moves here */
+    hal_fake_reset();
+    CHECK(MEAS_BenchConvert() == 0u);
+}
+
+int main(void)
+{
+    test_against_old_formulas();
+    test_calibration();
+    test_flash_record();
+    test_inverse();
+    test_bench();
+    return TEST_DONE();
+}
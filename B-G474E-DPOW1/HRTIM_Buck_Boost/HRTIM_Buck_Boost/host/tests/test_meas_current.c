@@ -0,0 +1,238 @@
+/*
+ * test_meas_current.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Block reduction of the ADC2 input current (MEAS_ProcessCurrentBlock()). Built twice:
+ *  test_meas_current runs the scalar loop, test_meas_current_dsp compiles measurements.c
+ *  again with __ARM_FEATURE_DSP so the SMLAD / SMLALD / USUB16 + SEL loop of the M4 runs
+ *  on the bit exact intrinsics of the host HAL. Both must give exactly the reference
+ *  below: the exact integer sums, rounded integer mean squares and their rounded roots
+ *  taken in double, so the two paths agree bit for bit on mean, RMS, ripple RMS, min,
+ *  max and the trace.
+ *
+ *  Waveforms: ADC2 recordings of the input current while the voltage loop runs a
+ *  set-point step on the buck-boost plant model (chopped by the buck leg, with noise),
+ *  plus the corners of the SIMD lanes: rails, extremes in one lane only, odd lengths.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#include "test_check.h"
+#include "hal_fake.h"
+#include "measurements.h"
+#include "buck_boost_model.h"
+#include "main.h"
+
+#define CUR_PWM_HZ          250000.0
+#define CUR_OFFSET_CODE     200.0       /* I_IN_SENSE at zero current           */
+#define CUR_CODES_PER_A     1200.0
+#define CUR_NOISE_CODES     3u          /* +- peak                              */
+#define CUR_REC_BLOCKS      24u         /* ~17 ms of ADC2 samples               */
+#define CUR_BENCH_BLOCKS    20000u
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define CUR_VARIANT         "SMLAD/SEL"
+#else
+#define CUR_VARIANT         "scalar"
+#endif
+
+static uint16_t recording[CUR_REC_BLOCKS * ADC2_HALF_SIZE] __attribute__((aligned(4)));
+static uint32_t lcg_u32 = 12345u;
+
+static uint32_t lcg(void)
+{
+    lcg_u32 = (lcg_u32 * 1664525u) + 1013904223u;
+    return lcg_u32 >> 8;
+}
+
+/* Expected block: exact sums, the roots as the contract of measurements.c states them */
+static void reference(const uint16_t *s, uint32_t n, Meas_CurrentBlock_t *r, double *rms, double *acRms)
+{
+    uint32_t tracePoints = n / MEAS_I_DECIM;
+    if (tracePoints > MEAS_I_TRACE_LEN)
+        tracePoints = MEAS_I_TRACE_LEN;
+    const uint32_t used = tracePoints * MEAS_I_DECIM;
+    uint64_t sum = 0u, sumSq = 0u;
+
+    memset(r, 0, sizeof(*r));
+    r->min_u16 = 0xFFFFu;
+    for (uint32_t t = 0u; t < tracePoints; t++)
+    {
+        uint32_t part = 0u;
+        for (uint32_t k = 0u; k < MEAS_I_DECIM; k++)
+        {
+            const uint16_t v = s[(t * MEAS_I_DECIM) + k];
+            part  += v;
+            sumSq += (uint64_t)v * v;
+            r->max_u16 = (v > r->max_u16) ? v : r->max_u16;
+            r->min_u16 = (v < r->min_u16) ? v : r->min_u16;
+        }
+        r->trace_u16[t] = (uint16_t)((part + (MEAS_I_DECIM / 2u)) / MEAS_I_DECIM);
+        sum += part;
+    }
+
+    const uint64_t acNum = ((uint64_t)used * sumSq) - (sum * sum);
+    r->mean_u16  = (uint16_t)((sum + (used / 2u)) / used);
+    const uint64_t n2 = (uint64_t)used * used;
+    r->rms_u16   = (uint16_t)lround(sqrt((double)((sumSq + (used / 2u)) / used)));
+    r->acRms_u16 = (uint16_t)lround(sqrt((double)((acNum + (n2 / 2u)) / n2)));
+    *rms   = sqrt((double)sumSq / used);
+    *acRms = sqrt((double)acNum) / used;
+}
+
+/* Process s through the given buffer position, compare everything with the reference */
+static void check_block(const uint16_t *s, uint32_t n, const char *what)
+{
+    Meas_CurrentBlock_t blk, ref;
+    double rms, acRms;
+    const uint32_t blocks0 = MEAS_GetCurrentStats()->blocks_u32;
+
+    reference(s, n, &ref, &rms, &acRms);
+    MEAS_ProcessCurrentBlock(s, n);
+    CHECK(MEAS_GetCurrentStats()->blocks_u32 == (blocks0 + 1u));
+    CHECK(MEAS_GetCurrentBlock(&blk));
+
+    const uint32_t tracePoints = ((n / MEAS_I_DECIM) < MEAS_I_TRACE_LEN) ? (n / MEAS_I_DECIM) : MEAS_I_TRACE_LEN;
+    CHECK_MSG((blk.mean_u16 == ref.mean_u16) && (blk.min_u16 == ref.min_u16) && (blk.max_u16 == ref.max_u16),
+              "%s: mean %u/%u min %u/%u max %u/%u", what, blk.mean_u16, ref.mean_u16,
+              blk.min_u16, ref.min_u16, blk.max_u16, ref.max_u16);
+    CHECK_MSG((blk.rms_u16 == ref.rms_u16) && (blk.acRms_u16 == ref.acRms_u16),
+              "%s: rms %u/%u ac %u/%u", what, blk.rms_u16, ref.rms_u16, blk.acRms_u16, ref.acRms_u16);
+    CHECK_MSG(memcmp(blk.trace_u16, ref.trace_u16, tracePoints * sizeof(uint16_t)) == 0, "%s: trace", what);
+
+    /* Rounding the mean square moves the root by at most 1/4 code, its own rounding 1/2 */
+    CHECK_MSG((fabs(blk.rms_u16 - rms) <= 0.75) && (fabs(blk.acRms_u16 - acRms) <= 0.75),
+              "%s: rms %u vs %.2f, ac %u vs %.2f", what, blk.rms_u16, rms, blk.acRms_u16, acRms);
+}
+
+/* ADC2 samples of the input current during a 3 V -> 8 V step at 5 V in, 10 ohm load:
+ * the reference ramps up and the current with it */
+static void record_step(void)
+{
+    const BBMODEL_Params_t p = { 5.0, 22e-6, 20e-6, 10.0, 0.05 };
+    const double tSample = 1.0 / MEAS_I_SAMPLE_RATE_HZ;
+    BBMODEL_t m;
+    VCTRL_t vc;
+    uint32_t k = 0u;
+
+    BBMODEL_Init(&m, &p, 3.0);
+    VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+    VCTRL_SetTarget_mV(&vc, 3000u);
+    VCTRL_Start(&vc, BBMODEL_VoutCode(&m), BBMODEL_VinCode(&m));
+    BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 20u, NULL);
+    VCTRL_SetTarget_mV(&vc, 8000u);
+
+    for (uint32_t step = 0u; k < (CUR_REC_BLOCKS * ADC2_HALF_SIZE); step++)
+    {
+        const VCTRL_Duty_t duty = VCTRL_Step(&vc, BBMODEL_VoutCode(&m));
+        const double d1 = (duty.buckCmp_u32 >= vc.period_u32) ? 1.0 : (double)duty.buckCmp_u32 / vc.period_u32;
+        const double i0 = m.iL_A;
+
+        BBMODEL_Run(&m, &duty, vc.period_u32);
+        const double tEnd = (step + 1u) / (double)VCTRL_FS_HZ;
+        for (; (k < (CUR_REC_BLOCKS * ADC2_HALF_SIZE)) && ((k * tSample) < tEnd); k++)
+        {
+            const double t     = k * tSample;
+            const double frac  = (t * VCTRL_FS_HZ) - step;
+            const double phase = (t * CUR_PWM_HZ) - floor(t * CUR_PWM_HZ);
+            const double iIn   = (phase < d1) ? (i0 + ((m.iL_A - i0) * frac)) : 0.0;
+            double code = CUR_OFFSET_CODE + (iIn * CUR_CODES_PER_A);
+
+            code += (double)(lcg() % ((2u * CUR_NOISE_CODES) + 1u)) - CUR_NOISE_CODES;
+            recording[k] = (uint16_t)((code < 0.0) ? 0.0 : ((code > 4095.0) ? 4095.0 : (code + 0.5)));
+        }
+    }
+}
+
+/* The recording through the two DMA halves, as the half / complete interrupts see it */
+static void test_recorded_step(void)
+{
+    char what[32];
+    uint16_t vmax[CUR_REC_BLOCKS] = {0};
+
+    record_step();
+    for (uint32_t b = 0u; b < CUR_REC_BLOCKS; b++)
+    {
+        uint16_t *half = &adc2_buf[(b & 1u) * ADC2_HALF_SIZE];
+
+        memcpy(half, &recording[b * ADC2_HALF_SIZE], ADC2_HALF_SIZE * sizeof(uint16_t));
+        snprintf(what, sizeof(what), "step block %u", b);
+        check_block(half, ADC2_HALF_SIZE, what);
+        for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++)
+            vmax[b] = (half[k] > vmax[b]) ? half[k] : vmax[b];
+    }
+    /* The recording really covers a current that rises with the soft-start ramp */
+    CHECK(vmax[CUR_REC_BLOCKS - 1u] > (vmax[0] + (0.1 * CUR_CODES_PER_A)));
+}
+
+/* Corners of the two 16-bit lanes and of the block length */
+static void test_lane_corners(void)
+{
+    static uint16_t s[ADC2_BUF_SIZE] __attribute__((aligned(4)));
+
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = 0u;
+    check_block(s, ADC2_HALF_SIZE, "zero");
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = 4095u;
+    check_block(s, ADC2_HALF_SIZE, "full scale");
+
+    /* Extremes in one lane only: the low and the high half of the words */
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = ((k & 1u) == 0u) ? 4095u : 0u;
+    check_block(s, ADC2_HALF_SIZE, "even lane high");
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = ((k & 1u) != 0u) ? 4095u : 0u;
+    check_block(s, ADC2_HALF_SIZE, "odd lane high");
+
+    /* A single extreme at the first / last sample of a block, on a flat level */
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = 2000u;
+    s[0] = 4000u;
+    s[ADC2_HALF_SIZE - 1u] = 5u;
+    check_block(s, ADC2_HALF_SIZE, "edge spikes");
+    s[0] = 3u;
+    s[ADC2_HALF_SIZE - 1u] = 4095u;
+    check_block(s, ADC2_HALF_SIZE, "edge spikes swapped");
+
+    /* Small ripple on a large level: the variance must not cancel */
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = (uint16_t)(4000u + (k % 3u));
+    check_block(s, ADC2_HALF_SIZE, "ripple on dc");
+
+    /* Mean square 4196352.47, rounded to 4196352 = 2048^2 + 2048: the last value whose
+     * root rounds to 2048. Through a float of sumSq (2^31, 24 bits) it came out as
+     * 4196353 and the root as 2049. */
+    for (uint32_t k = 0u; k < ADC2_HALF_SIZE; k++) s[k] = (k < 15u) ? 2065u : 2048u;
+    check_block(s, ADC2_HALF_SIZE, "root rounding edge");
+
+    /* Full range noise, then lengths that are no multiple of the decimation: the tail
+     * is left out, a block longer than the trace is cut at MEAS_I_TRACE_LEN points */
+    for (uint32_t k = 0u; k < ADC2_BUF_SIZE; k++) s[k] = (uint16_t)(lcg() & 0xFFFu);
+    check_block(s, ADC2_HALF_SIZE, "noise");
+    check_block(s, 200u, "noise 200");
+    check_block(s, MEAS_I_DECIM, "noise 16");
+    check_block(&s[2], ADC2_HALF_SIZE - 2u, "noise offset");
+    check_block(s, ADC2_BUF_SIZE, "noise 1024");
+}
+
+/* Host cost per block, to compare the two builds (the M4 cost is on the DWT stats) */
+static void bench(void)
+{
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (uint32_t b = 0u; b < CUR_BENCH_BLOCKS; b++)
+        MEAS_ProcessCurrentBlock(&recording[(b % CUR_REC_BLOCKS) * ADC2_HALF_SIZE], ADC2_HALF_SIZE);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    const double ns = (((t1.tv_sec - t0.tv_sec) * 1e9) + (t1.tv_nsec - t0.tv_nsec)) / CUR_BENCH_BLOCKS;
+    printf("%s path: %.0f ns per block of %u samples on the host\n", CUR_VARIANT, ns, (unsigned)ADC2_HALF_SIZE);
+}
+
+int main(void)
+{
+    hal_fake_reset();
+    test_recorded_step();
+    test_lane_corners();
+    bench();
+    return TEST_DONE();
+}
@@ -0,0 +1,320 @@
+/*
+ * test_measurements.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Publication of the injected sequences (measurements.c): the JEOS path, window
+ *  statistics and history, then MEAS_Capture() and the readers preempting each other.
+ *  A timer signal plays the interrupt: it runs to completion on top of whatever the
+ *  main code was doing, like an ISR on the single core.
+ *
+ *  Every sample is a function of its sequence number, so any frame or history copy
+ *  can be checked on its own: raw against seq, min/max/avg against the window, and
+ *  history entries against their neighbours. A torn copy cannot pass.
+ */
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "test_check.h"
+#include "hal_fake.h"
+#include "measurements.h"
+
+#define BASE_PERIOD         3000u       /* window bases cycle through 0..2999 */
+#define BASE_STEP           13u         /* coprime to BASE_PERIOD             */
+#define STRESS_TICK_US      50
+#define STRESS_TICKS        4000u
+#define STRESS_BURST        (3u * MEAS_DECIM)
+
+static volatile uint32_t captured;      /* sequences handed to MEAS_Capture() */
+
+static uint16_t window_base(uint32_t w, uint32_t ch)
+{
+    return (uint16_t)(((w * BASE_STEP) + (ch * 1000u)) % BASE_PERIOD);
+}
+
+/* Sequence n (from 1): the base of its window plus its position in the window */
+static void pattern(uint32_t n, uint16_t raw_u16[MEAS_NUM_CH])
+{
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        raw_u16[ch] = (uint16_t)(window_base((n - 1u) / MEAS_DECIM, ch) + ((n - 1u) % MEAS_DECIM));
+    }
+}
+
+static void capture_next(void)
+{
+    uint16_t raw[MEAS_NUM_CH];
+    const uint32_t n = captured + 1u;
+
+    pattern(n, raw);
+    MEAS_Capture(raw);
+    captured = n;
+}
+
+/* min = base, max = base + 31, avg = (32 base + 496 + 16) >> 5 = base + 16 */
+static bool frame_consistent(const Meas_Frame_t *f)
+{
+    uint16_t raw[MEAS_NUM_CH];
+
+    if ((f->seq_u32 == 0u) || (f->window_u32 != (f->seq_u32 / MEAS_DECIM)))
+        return false;
+    pattern(f->seq_u32, raw);
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        if (f->raw_u16[ch] != raw[ch])
+            return false;
+        if (f->window_u32 > 0u)
+        {
+            const uint16_t base = window_base(f->window_u32 - 1u, ch);
+            if ((f->min_u16[ch] != base) || (f->max_u16[ch] != (base + MEAS_DECIM - 1u)) ||
+                (f->avg_u16[ch] != (base + (MEAS_DECIM / 2u))))
+                return false;
+        }
+    }
+    return true;
+}
+
+/* Consecutive windows, the newest one completed within [wFrom, wTo] */
+static bool history_consistent(const uint16_t *h, uint32_t cnt, uint32_t ch, uint32_t wFrom, uint32_t wTo)
+{
+    if (cnt == 0u)
+        return true;
+    for (uint32_t i = 1u; i < cnt; i++)
+    {
+        if (((h[i] + BASE_PERIOD - h[i - 1u]) % BASE_PERIOD) != BASE_STEP)
+            return false;
+    }
+    for (uint32_t w = (wFrom > 0u) ? wFrom : 1u; w <= wTo; w++)
+    {
+        if (h[cnt - 1u] == (window_base(w - 1u, ch) + (MEAS_DECIM / 2u)))
+            return true;
+    }
+    return false;
+}
+
+/* MEAS_Init() on ADC1, nothing published yet */
+static void test_init_and_empty(void)
+{
+    ADC_HandleTypeDef hadc1 = { .Instance = ADC1 };
+    Meas_Frame_t frame;
+    uint16_t hist[MEAS_HISTORY_LEN];
+
+    hal_fake_reset();
+    MEAS_Init(&hadc1);
+    CHECK(hal_fake_nvic_enabled(ADC1_2_IRQn));
+    CHECK(hal_fake_nvic_priority(ADC1_2_IRQn) == 1u);           // below the HRTIM control ISR
+    CHECK((ADC1->IER & ADC_IER_JEOSIE) != 0u);
+
+    CHECK(!MEAS_GetFrame(&frame));
+    CHECK(MEAS_GetHistory(MEAS_CH_VOUT, hist, 16u) == 0u);
+    CHECK(MEAS_GetStats()->readFails_u32 == 0u);                // nothing yet is not a failure
+}
+
+static void test_injected_irq(void)
+{
+    uint16_t raw[MEAS_NUM_CH], expected[MEAS_NUM_CH];
+    Meas_Frame_t frame;
+
+    CHECK(!MEAS_InjectedIRQHandler(raw));                       // no JEOS, nothing taken
+    CHECK(MEAS_GetStats()->sequences_u32 == 0u);
+
+    pattern(captured + 1u, expected);
+    hal_fake_adc_inject(ADC1, expected);
+    CHECK(MEAS_InjectedIRQHandler(raw));
+    captured = captured + 1u;
+    CHECK(memcmp(raw, expected, sizeof(raw)) == 0);
+    CHECK((ADC1->ISR & ADC_ISR_JEOS) == 0u);
+    CHECK(MEAS_GetFrame(&frame));
+    CHECK(frame.seq_u32 == 1u);
+    CHECK(frame_consistent(&frame));
+}
+
+static void test_windows_and_history(void)
+{
+    uint16_t hist[MEAS_HISTORY_LEN];
+    Meas_Frame_t frame;
+
+    /* Up to the end of the 5th window: five history entries */
+    while (captured < (5u * MEAS_DECIM))
+    {
+        capture_next();
+    }
+    CHECK(MEAS_GetFrame(&frame));
+    CHECK(frame.window_u32 == 5u);
+    CHECK(frame_consistent(&frame));
+    for (uint32_t ch = 0u; ch < MEAS_NUM_CH; ch++)
+    {
+        CHECK(MEAS_GetHistory((Meas_Channel_t)ch, hist, MEAS_HISTORY_LEN) == 5u);
+        for (uint32_t w = 0u; w < 5u; w++)
+        {
+            CHECK(hist[w] == (window_base(w, ch) + (MEAS_DECIM / 2u)));     // oldest first
+        }
+    }
+
+    /* Half a window on: the frame keeps the last complete window */
+    for (uint32_t i = 0u; i < (MEAS_DECIM / 2u); i++)
+    {
+        capture_next();
+    }
+    CHECK(MEAS_GetFrame(&frame));
+    CHECK(frame.window_u32 == 5u);
+    CHECK(frame_consistent(&frame));
+
+    /* Past the ring size: the latest LEN - 1 windows, the one at the head is never handed out */
+    while (captured < ((MEAS_HISTORY_LEN + 40u) * MEAS_DECIM))
+    {
+        capture_next();
+    }
+    const uint32_t windows = captured / MEAS_DECIM;
+    CHECK(MEAS_GetHistory(MEAS_CH_VIN, hist, 1000u) == (MEAS_HISTORY_LEN - 1u));
+    CHECK(history_consistent(hist, MEAS_HISTORY_LEN - 1u, MEAS_CH_VIN, windows, windows));
+    CHECK(hist[0] == (window_base(windows - (MEAS_HISTORY_LEN - 1u), MEAS_CH_VIN) + (MEAS_DECIM / 2u)));
+    CHECK(MEAS_GetHistory(MEAS_CH_VOUT, hist, 10u) == 10u);
+    CHECK(history_consistent(hist, 10u, MEAS_CH_VOUT, windows, windows));
+
+    CHECK(MEAS_GetHistory(MEAS_NUM_CH, hist, 10u) == 0u);
+    CHECK(MEAS_GetHistory(MEAS_CH_VOUT, NULL, 10u) == 0u);
+    CHECK(MEAS_GetStats()->retries_u32 == 0u);                  // nobody interfered so far
+}
+
+/* --- The capture ISR preempts the main loop readers --- */
+
+static volatile uint32_t ticks;
+
+static void capture_isr(int sig)
+{
+    (void)sig;
+    /* Three windows per interrupt: a preempted history read loses its oldest entries and
+     * a preempted frame read its slot, which one window or one publish never does */
+    for (uint32_t i = 0u; i < STRESS_BURST; i++)
+    {
+        capture_next();
+    }
+    ticks = ticks + 1u;
+}
+
+static void timer_start(void (*handler)(int))
+{
+    struct sigaction sa;
+    struct itimerval timer = { { 0, STRESS_TICK_US }, { 0, STRESS_TICK_US } };
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    CHECK(sigaction(SIGALRM, &sa, NULL) == 0);
+    ticks = 0u;
+    CHECK(setitimer(ITIMER_REAL, &timer, NULL) == 0);
+}
+
+static void timer_stop(void)
+{
+    struct itimerval timer;
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+    signal(SIGALRM, SIG_DFL);
+}
+
+static void test_preempted_readers(void)
+{
+    const Meas_Stats_t *stats = MEAS_GetStats();
+    const uint32_t retries0 = stats->retries_u32, fails0 = stats->readFails_u32;
+    uint32_t frames = 0u, badFrames = 0u, seqBack = 0u, lastSeq = 0u;
+    uint32_t histories = 0u, badHistories = 0u, ch = 0u;
+    uint16_t hist[MEAS_HISTORY_LEN];
+    Meas_Frame_t frame;
+
+    timer_start(capture_isr);
+    while (ticks < STRESS_TICKS)
+    {
+        if (MEAS_GetFrame(&frame))
+        {
+            frames++;
+            badFrames += frame_consistent(&frame) ? 0u : 1u;
+            seqBack += (frame.seq_u32 < lastSeq) ? 1u : 0u;
+            lastSeq = frame.seq_u32;
+        }
+
+        const uint32_t wFrom = captured / MEAS_DECIM;
+        const uint32_t cnt = MEAS_GetHistory((Meas_Channel_t)ch, hist, MEAS_HISTORY_LEN - 1u);
+        const uint32_t wTo = captured / MEAS_DECIM;
+        if (cnt > 0u)
+        {
+            histories++;
+            badHistories += (history_consistent(hist, cnt, ch, wFrom, wTo) && (cnt == (MEAS_HISTORY_LEN - 1u))) ? 0u : 1u;
+        }
+        ch = (ch + 1u) % MEAS_NUM_CH;
+    }
+    timer_stop();
+
+    printf("preempted readers: %u frames, %u histories, %u retries, %u gave up\n", frames, histories,
+           stats->retries_u32 - retries0, stats->readFails_u32 - fails0);
+    CHECK(badFrames == 0u);
+    CHECK(seqBack == 0u);
+    CHECK(badHistories == 0u);
+    CHECK((frames > 0u) && (histories > 0u));
+    CHECK(stats->retries_u32 > retries0);       // the retry paths did run
+    CHECK(stats->sequences_u32 == captured);
+}
+
+/* --- A reader ISR preempts MEAS_Capture() (frames are readable from any context) --- */
+
+static volatile uint32_t isrFrames, isrBadFrames, isrHistories, isrBadHistories;
+
+static void reader_isr(int sig)
+{
+    (void)sig;
+    Meas_Frame_t frame;
+    uint16_t hist[MEAS_HISTORY_LEN];
+
+    /* captured is bumped after MEAS_Capture() returns: the frame is that one or the next */
+    const uint32_t n = captured;
+    if (MEAS_GetFrame(&frame))
+    {
+        isrFrames = isrFrames + 1u;
+        isrBadFrames = isrBadFrames + ((frame_consistent(&frame) && ((frame.seq_u32 - n) <= 1u)) ? 0u : 1u);
+    }
+    const uint32_t cnt = MEAS_GetHistory(MEAS_CH_VOUT, hist, MEAS_HISTORY_LEN - 1u);
+    isrHistories = isrHistories + 1u;
+    isrBadHistories = isrBadHistories +
+        ((history_consistent(hist, cnt, MEAS_CH_VOUT, n / MEAS_DECIM, (n + 1u) / MEAS_DECIM) &&
+          (cnt == (MEAS_HISTORY_LEN - 1u))) ? 0u : 1u);
+    ticks = ticks + 1u;
+}
+
+static void test_preempted_writer(void)
+{
+    const Meas_Stats_t *stats = MEAS_GetStats();
+    const uint32_t retries0 = stats->retries_u32, fails0 = stats->readFails_u32;
+
+    isrFrames = isrBadFrames = isrHistories = isrBadHistories = 0u;
+    timer_start(reader_isr);
+    while (ticks < STRESS_TICKS)
+    {
+        capture_next();
+    }
+    timer_stop();
+
+    printf("preempted writer: %u frames, %u histories read in the ISR\n", isrFrames, isrHistories);
+    CHECK(isrBadFrames == 0u);
+    CHECK(isrBadHistories == 0u);
+    /* One more tick may land between the end of the loop and timer_stop() */
+    CHECK((isrFrames == ticks) && (ticks >= STRESS_TICKS));
+    /* The suspended writer cannot move on, so the ISR reader never has to repeat */
+    CHECK(stats->retries_u32 == retries0);
+    CHECK(stats->readFails_u32 == fails0);
+    CHECK(stats->sequences_u32 == captured);
+}
+
+int main(void)
+{
+    test_init_and_empty();
+    test_injected_irq();
+    test_windows_and_history();
+    test_preempted_readers();
+    test_preempted_writer();
+    return TEST_DONE();
+}
@@ -0,0 +1,429 @@
+/*
+ * test_motor_control.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Speed / current cascade (motor_control.c) on the averaged stage + DC motor model
+ *  with the plant of the tuning comment, at the corners Vin 7 / 12 V and ESR 20 / 100
+ *  mohm: the speed step and ramp, the current step on a locked rotor, a load step, the
+ *  Vin feed-forward, both anti-windup paths, the start on a spinning shaft and the cost
+ *  of one step against MCTRL_CYCLE_BUDGET.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "test_check.h"
+#include "buck_boost_model.h"
+#include "motor_model.h"
+#include "encoders.h"
+#include "fault_mgr.h"
+#include "main.h"
+
+#define TICK_S              (1.0 / VCTRL_FS_HZ)
+#define TICKS_PER_MS(ms)    ((uint32_t)(((ms) * VCTRL_FS_HZ) / 1000u))
+#define STEP_ACCEL          1000000u                /* rpm/s: the ramp is a step */
+
+/* Tuning comment plant: 22 uH / 100 uF, 2 ohm, 1 mH, 0.02 V s/rad, 2e-5 kg m^2, 0.5 V/A */
+static const MMODEL_Params_t plant = {
+    12.0, 22e-6, 100e-6, 0.02, 0.05, 2.0, 1e-3, 0.02, 2e-5, 1e-6, 0.5, 40u
+};
+
+static const struct {
+    double vin_V, esr_ohm;
+} corners[] = {
+    { 7.0, 0.02 }, { 7.0, 0.10 }, { 12.0, 0.02 }, { 12.0, 0.10 },
+};
+#define NUM_CORNERS (sizeof(corners) / sizeof(corners[0]))
+
+/* Defaults of app.h: 2000 mV at the pin = 4 A, 8 V; OCP trips at 3000 mV = 6 A */
+#define ILIM_A              4.0
+#define VMAX_V              8.0
+#define OCP_A               (FAULT_OCP_PIN_mV / 1000.0 / plant.senseGain_VpA)
+
+static double rpm_to_rad_s(double rpm)
+{
+    return rpm * 2.0 * M_PI / 60.0;
+}
+
+static MMODEL_Params_t corner(uint32_t c)
+{
+    MMODEL_Params_t p = plant;
+    p.vin_V   = corners[c].vin_V;
+    p.esr_ohm = corners[c].esr_ohm;
+    return p;
+}
+
+/* The limits in codes as APP_ParamsApply() sets them, then MCTRL_Start() on the model */
+static void start(MMODEL_t *m, VCTRL_t *vc, MCTRL_t *mc, double iLim_A, double vMax_V)
+{
+    MCTRL_Input_t in;
+
+    VCTRL_Init(vc, BUCK_PWM_PERIOD);
+    MCTRL_Init(mc, vc);
+    MCTRL_SetCurrentOffset(mc, m->p.iZeroCode_u16);
+    MCTRL_SetLimits(mc, (uint16_t)lround(iLim_A * m->p.senseGain_VpA * VCTRL_ADC_FS_COUNTS * 1000.0 / VCTRL_VDDA_mV),
+                    BBMODEL_AdcCode(vMax_V, VCTRL_VOUT_SCALE_NUM, VCTRL_VOUT_SCALE_DEN));
+    MMODEL_Input(m, &in);
+    MCTRL_Start(mc, &in);
+}
+
+static void setup(MMODEL_t *m, VCTRL_t *vc, MCTRL_t *mc, const MMODEL_Params_t *p, double iLim_A, double vMax_V)
+{
+    MMODEL_Init(m, p);
+    start(m, vc, mc, iLim_A, vMax_V);
+}
+
+/* Filtered current of the controller in A */
+static double filtered_A(const MCTRL_t *mc, const MMODEL_t *m)
+{
+    return (mc->iFiltQ_s32 >> MCTRL_I_FILT_SHIFT) * (double)VCTRL_VDDA_mV
+           / (8.0 * VCTRL_ADC_FS_COUNTS * 1000.0 * m->p.senseGain_VpA);
+}
+
+/* Ticks until the speed crosses level (from the present side), limit if it never does */
+static uint32_t ticks_to_speed(MMODEL_t *m, MCTRL_t *mc, double level, uint32_t limit, MMODEL_Trace_t *trace)
+{
+    const bool rising = (m->w_rad_s < level);
+
+    for (uint32_t n = 1u; n <= limit; n++)
+    {
+        MMODEL_Loop(m, mc, 1u, trace);
+        if (rising ? (m->w_rad_s >= level) : (m->w_rad_s <= level))
+        {
+            return n;
+        }
+    }
+    return limit;
+}
+
+/* Same for the filtered current, rising */
+static uint32_t ticks_to_current(MMODEL_t *m, MCTRL_t *mc, double level, uint32_t limit, MMODEL_Trace_t *trace)
+{
+    for (uint32_t n = 1u; n <= limit; n++)
+    {
+        MMODEL_Loop(m, mc, 1u, trace);
+        if (filtered_A(mc, m) >= level)
+        {
+            return n;
+        }
+    }
+    return limit;
+}
+
+/*
+ * Start from rest on the default 2000 rpm/s ramp to 1000 rpm, then a 100 rpm step
+ * without the ramp: 10-90 % in about 10 ms (speed loop crossover ~25 Hz), < 5 %
+ * overshoot, settled to 0.2 %.
+ */
+static void test_speed_step(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        const MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+
+        setup(&m, &vc, &mc, &p, ILIM_A, VMAX_V);
+        MCTRL_SetSpeed_rpm(&mc, 1000u);
+        MMODEL_TraceReset(&trace, &m);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(250u), &trace);
+        CHECK_MSG(fabs(MMODEL_Rpm(m.w_rad_s) - (MCTRL_ACCEL_RPM_PER_S * 0.25)) < 20.0,
+                  "%.0f V: %.1f rpm on the ramp at 250 ms", p.vin_V, MMODEL_Rpm(m.w_rad_s));
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(750u), &trace);
+        const double w0 = m.w_rad_s;
+        CHECK(fabs(MMODEL_Rpm(w0) - 1000.0) < 1.0);
+        CHECK(MMODEL_Rpm(trace.wMax_rad_s) < (1000.0 + 25.0));
+        CHECK(mc.stats.currentLimited_u32 == 0u);
+
+        const double w1 = rpm_to_rad_s(1100.0);
+        MCTRL_SetAccel_rpm_per_s(&mc, STEP_ACCEL);
+        MCTRL_SetSpeed_rpm(&mc, 1100u);
+        MMODEL_TraceReset(&trace, &m);
+        (void)ticks_to_speed(&m, &mc, w0 + (0.1 * (w1 - w0)), TICKS_PER_MS(100u), &trace);
+        const uint32_t rise = ticks_to_speed(&m, &mc, w0 + (0.9 * (w1 - w0)), TICKS_PER_MS(100u), &trace);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(300u), &trace);
+
+        const double rise_ms = rise * TICK_S * 1e3;
+        const double overshoot = (trace.wMax_rad_s - w1) / (w1 - w0);
+        printf("speed step %.0f V / %.0f mohm: 10-90 %% %.2f ms, overshoot %.1f %%, iL max %.2f A\n",
+               p.vin_V, p.esr_ohm * 1e3, rise_ms, overshoot * 100.0, trace.iLMax_A);
+        CHECK_MSG((rise_ms > 6.0) && (rise_ms < 15.0), "rise %.2f ms", rise_ms);
+        CHECK_MSG(overshoot < 0.05, "overshoot %.1f %%", overshoot * 100.0);
+        CHECK(fabs(m.w_rad_s - w1) < (0.002 * w1));
+        CHECK(trace.iLMax_A < ILIM_A);
+    }
+}
+
+/*
+ * Current step on a locked rotor: the speed PI saturates at once and the current
+ * loop alone takes the current to a 2 A limit, 10-90 % in about 4 ms, and the slewed
+ * reference does not ring the output LC: the sampled inductor current stays < 5 % over.
+ */
+static void test_current_step(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+        const double iLim = 2.0;
+
+        p.j_kgm2 = 1e6;
+        setup(&m, &vc, &mc, &p, iLim, VMAX_V);
+        MCTRL_SetAccel_rpm_per_s(&mc, STEP_ACCEL);
+        MCTRL_SetSpeed_rpm(&mc, 3000u);
+        MMODEL_TraceReset(&trace, &m);
+        const uint32_t t10  = ticks_to_current(&m, &mc, 0.1 * iLim, TICKS_PER_MS(50u), &trace);
+        const uint32_t rise = ticks_to_current(&m, &mc, 0.9 * iLim, TICKS_PER_MS(50u), &trace);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(100u), &trace);
+
+        const double rise_ms = rise * TICK_S * 1e3;
+        printf("current step %.0f V / %.0f mohm: 10-90 %% %.2f ms, iL max %.3f A, final %.3f A\n",
+               p.vin_V, p.esr_ohm * 1e3, rise_ms, trace.iLMax_A, m.iM_A);
+        CHECK(t10 < TICKS_PER_MS(2u));
+        CHECK_MSG((rise_ms > 3.0) && (rise_ms < 6.0), "rise %.2f ms", rise_ms);
+        CHECK_MSG(trace.iLMax_A < (1.05 * iLim), "iL max %.3f A", trace.iLMax_A);
+        CHECK(fabs(m.iM_A - iLim) < 0.01);
+        CHECK(fabs(m.iL_A - iLim) < 0.01);
+        CHECK(mc.iRef_s16 == mc.iLimit_s16);
+    }
+}
+
+/* Load torque 1 A -> 2 A at 1000 rpm: dip below 6 %, back within 0.5 % in 400 ms */
+static void test_load_step(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        const MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+
+        setup(&m, &vc, &mc, &p, ILIM_A, VMAX_V);
+        m.load_Nm = 0.02;
+        MCTRL_SetSpeed_rpm(&mc, 1000u);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(1000u), NULL);
+        const double w0 = m.w_rad_s;
+
+        m.load_Nm = 0.04;
+        MMODEL_TraceReset(&trace, &m);
+        const uint32_t out  = ticks_to_speed(&m, &mc, 0.995 * w0, TICKS_PER_MS(100u), &trace);
+        const uint32_t back = out + ticks_to_speed(&m, &mc, 0.995 * w0, TICKS_PER_MS(500u), &trace);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(500u), &trace);
+
+        const double dip = (w0 - trace.wMin_rad_s) / w0;
+        printf("load step %.0f V / %.0f mohm: dip %.2f %%, back in %.1f ms\n",
+               p.vin_V, p.esr_ohm * 1e3, dip * 100.0, back * TICK_S * 1e3);
+        CHECK_MSG(dip < 0.06, "dip %.2f %%", dip * 100.0);
+        CHECK_MSG(back < TICKS_PER_MS(400u), "back in %.1f ms", back * TICK_S * 1e3);
+        CHECK(fabs(m.w_rad_s - w0) < (0.002 * w0));
+        CHECK(fabs(m.iM_A - 2.0) < 0.02);
+    }
+}
+
+/* Vin 12 <-> 7 V at 1000 rpm and 1 A: the feed-forward keeps the current within 20 mA */
+static void test_vin_step(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        const MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+        double di = 0.0;
+
+        setup(&m, &vc, &mc, &p, ILIM_A, VMAX_V);
+        m.load_Nm = 0.02;
+        MCTRL_SetSpeed_rpm(&mc, 1000u);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(1000u), NULL);
+        const double i0 = m.iM_A, w0 = m.w_rad_s;
+
+        m.p.vin_V = (p.vin_V > 10.0) ? 7.0 : 12.0;
+        MMODEL_TraceReset(&trace, &m);
+        for (uint32_t n = 0u; n < TICKS_PER_MS(100u); n++)
+        {
+            MMODEL_Loop(&m, &mc, 1u, &trace);
+            di = fmax(di, fabs(m.iM_A - i0));
+        }
+        printf("Vin %.0f -> %.0f V / %.0f mohm: motor current within %.1f mA\n",
+               p.vin_V, m.p.vin_V, p.esr_ohm * 1e3, di * 1e3);
+        CHECK_MSG(di < 0.02, "di %.1f mA", di * 1e3);
+        CHECK(fmax(trace.wMax_rad_s - w0, w0 - trace.wMin_rad_s) < (0.001 * w0));
+    }
+}
+
+/*
+ * Anti-windup at the voltage clamp: 1500 rpm behind a 4 V limit, then the limit is
+ * raised to 8 V. While the current PI is clamped the speed PI tracks the delivered
+ * current, so the reference it resumes from is the present one: no overshoot.
+ */
+static void test_voltage_clamp(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        const MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+
+        setup(&m, &vc, &mc, &p, ILIM_A, 4.0);
+        m.load_Nm = 0.01;
+        MCTRL_SetSpeed_rpm(&mc, 1500u);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(1000u), NULL);
+        const double rpmClamp = MMODEL_Rpm(m.w_rad_s);
+        CHECK_MSG(fabs(m.vOut_V - 4.0) < 0.1, "%.3f V", m.vOut_V);
+        CHECK(rpmClamp < 1450.0);
+        CHECK(mc.stats.voltageSat_u32 > 0u);
+        CHECK(mc.stats.speedHeld_u32 > 0u);
+        CHECK_MSG(fabs(filtered_A(&mc, &m) - 0.5) < 0.05, "%.3f A at the clamp", filtered_A(&mc, &m));
+        CHECK(abs(mc.iRef_s16 - (int32_t)(mc.iFiltQ_s32 >> MCTRL_I_FILT_SHIFT)) < (mc.iLimit_s16 / 40));
+
+        MCTRL_SetLimits(&mc, mc.iLimit_s16 >> 3, BBMODEL_AdcCode(VMAX_V, VCTRL_VOUT_SCALE_NUM, VCTRL_VOUT_SCALE_DEN));
+        MMODEL_TraceReset(&trace, &m);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(1000u), &trace);
+        printf("voltage clamp %.0f V / %.0f mohm: %.0f rpm at 4 V, max %.1f rpm after the release\n",
+               p.vin_V, p.esr_ohm * 1e3, rpmClamp, MMODEL_Rpm(trace.wMax_rad_s));
+        CHECK(MMODEL_Rpm(trace.wMax_rad_s) < 1500.0 * 1.005);
+        CHECK(fabs(MMODEL_Rpm(m.w_rad_s) - 1500.0) < 3.0);
+    }
+}
+
+/*
+ * Anti-windup at the current limit: 0 -> 2000 rpm at 20000 rpm/s with 10x the inertia,
+ * 3800 rpm/s at 4 A. The ramp leads the shaft by no more than what saturates the
+ * speed PI (plus a ramp step), the voltage clamp is met on the way, yet the overshoot
+ * stays < 5 %; the filtered current keeps to the limit and the sampled inductor
+ * current stays below OCP.
+ */
+static void test_current_limit(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+        double iFiltMax = 0.0, leadMax = 0.0;
+
+        p.j_kgm2 = 2e-4;
+        setup(&m, &vc, &mc, &p, ILIM_A, VMAX_V);
+        MCTRL_SetAccel_rpm_per_s(&mc, 20000u);
+        MCTRL_SetSpeed_rpm(&mc, 2000u);
+        MMODEL_TraceReset(&trace, &m);
+        for (uint32_t n = 0u; n < TICKS_PER_MS(2000u); n++)
+        {
+            MMODEL_Loop(&m, &mc, 1u, &trace);
+            iFiltMax = fmax(iFiltMax, filtered_A(&mc, &m));
+            leadMax  = fmax(leadMax, ENC_RPM_Q8(mc.speedRefQ8_s32) / 256.0 - MMODEL_Rpm(m.w_rad_s));
+        }
+
+        const double overshoot = (MMODEL_Rpm(trace.wMax_rad_s) / 2000.0) - 1.0;
+        printf("current limit %.0f V / %.0f mohm: overshoot %.1f %%, reference lead %.1f rpm, filtered %.3f A, "
+               "iL max %.2f A (OCP %.1f A)\n", p.vin_V, p.esr_ohm * 1e3, overshoot * 100.0, leadMax, iFiltMax,
+               trace.iLMax_A, OCP_A);
+        CHECK(mc.stats.currentLimited_u32 > 0u);
+        CHECK_MSG(leadMax < (ENC_RPM_Q8(mc.rampLeadQ8_s32 + mc.accelQ8_s32) / 256.0) + 5.0,
+                  "reference %.1f rpm ahead", leadMax);
+        CHECK_MSG(overshoot < 0.05, "overshoot %.1f %%", overshoot * 100.0);
+        CHECK(iFiltMax < (1.02 * ILIM_A));
+        CHECK(trace.iLMax_A < (0.9 * OCP_A));
+        CHECK(fabs(MMODEL_Rpm(m.w_rad_s) - 2000.0) < 20.0);
+    }
+}
+
+/* Enabling the loop on a coasting shaft with a charged output: no current or speed bump */
+static void test_spinning_start(void)
+{
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        const MMODEL_Params_t p = corner(c);
+        MMODEL_t m;
+        VCTRL_t vc;
+        MCTRL_t mc;
+        MMODEL_Trace_t trace;
+
+        MMODEL_Init(&m, &p);
+        m.w_rad_s = m.wMean_rad_s = rpm_to_rad_s(1500.0);
+        m.vC_V = m.vOut_V = p.ke_Vs * m.w_rad_s;
+        start(&m, &vc, &mc, ILIM_A, VMAX_V);
+        MCTRL_SetSpeed_rpm(&mc, 1500u);
+        MMODEL_TraceReset(&trace, &m);
+        MMODEL_Loop(&m, &mc, TICKS_PER_MS(200u), &trace);
+
+        CHECK_MSG((trace.iLMax_A < 0.05) && (trace.iLMin_A > -0.05), "iL %.3f .. %.3f A", trace.iLMin_A, trace.iLMax_A);
+        CHECK(fabs(MMODEL_Rpm(trace.wMin_rad_s) - 1500.0) < 3.0);
+        CHECK(fabs(MMODEL_Rpm(trace.wMax_rad_s) - 1500.0) < 3.0);
+    }
+}
+
+/* The rpm conversions saturate: a huge acceleration is a step, not a wrapped value */
+static void test_conversions(void)
+{
+    VCTRL_t vc;
+    MCTRL_t mc;
+
+    VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+    MCTRL_Init(&mc, &vc);
+    CHECK(mc.accelQ8_s32 == (int32_t)(((uint64_t)MCTRL_ACCEL_RPM_PER_S * ENC_COUNTS_PER_REV * 256u / 60u)
+                                      / (VCTRL_FS_HZ / MCTRL_SPEED_DIV)));
+    MCTRL_SetAccel_rpm_per_s(&mc, STEP_ACCEL);
+    CHECK(mc.accelQ8_s32 > MMODEL_CpsQ8(rpm_to_rad_s(1000.0)));
+    MCTRL_SetAccel_rpm_per_s(&mc, UINT32_MAX);
+    CHECK(mc.accelQ8_s32 == (int32_t)(MCTRL_SPEED_FS_CPS << 8));
+    MCTRL_SetAccel_rpm_per_s(&mc, 0u);
+    CHECK(mc.accelQ8_s32 == 1);
+    MCTRL_SetSpeed_rpm(&mc, UINT32_MAX);
+    CHECK(mc.speedTargetQ8_s32 == (int32_t)((MCTRL_SPEED_FS_CPS - 1u) << 8));
+    MCTRL_SetSpeed_rpm(&mc, 1000u);
+    CHECK(abs(mc.speedTargetQ8_s32 - MMODEL_CpsQ8(rpm_to_rad_s(1000.0))) <= 1);
+}
+
+/* Host time of one step against the 10 us of MCTRL_CYCLE_BUDGET, and its accounting */
+static void test_cost(void)
+{
+    MMODEL_t m;
+    VCTRL_t vc;
+    MCTRL_t mc;
+
+    setup(&m, &vc, &mc, &plant, ILIM_A, VMAX_V);
+    MCTRL_SetSpeed_rpm(&mc, 1000u);
+    const uint32_t before = mc.stats.iterations_u32;
+    const double ns = MMODEL_StepCost_ns(&mc, 1000000u);
+    const double budget_ns = MCTRL_CYCLE_BUDGET * 1e9 / SystemCoreClock;
+    printf("MCTRL_Step: %.1f ns per step on the host (budget %.0f ns)\n", ns, budget_ns);
+    CHECK(mc.stats.iterations_u32 == (before + 1000000u));
+    CHECK((mc.stats.speedSteps_u32 + mc.stats.speedHeld_u32) == (mc.stats.iterations_u32 / MCTRL_SPEED_DIV));
+    CHECK(ns < budget_ns);
+
+    MCTRL_RecordCycles(&mc, 900u);
+    MCTRL_RecordCycles(&mc, MCTRL_CYCLE_BUDGET);
+    MCTRL_RecordCycles(&mc, 800u);
+    CHECK((mc.stats.lastCycles_u32 == 800u) && (mc.stats.maxCycles_u32 == MCTRL_CYCLE_BUDGET));
+    CHECK(mc.stats.overBudget_u32 == 0u);
+    MCTRL_RecordCycles(&mc, MCTRL_CYCLE_BUDGET + 1u);
+    CHECK((mc.stats.overBudget_u32 == 1u) && (mc.stats.maxCycles_u32 == (MCTRL_CYCLE_BUDGET + 1u)));
+}
+
+int main(void)
+{
+    test_speed_step();
+    test_current_step();
+    test_load_step();
+    test_vin_step();
+    test_voltage_clamp();
+    test_current_limit();
+    test_spinning_start();
+    test_conversions();
+    test_cost();
+    return TEST_DONE();
+}
@@ -0,0 +1,433 @@
+/*
+ * test_retarget.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  The printf ring of retarget.c against a simulated USART: the tests shift the TX
+ *  FIFO out (the wire) and run RetargetIRQHandler() while the FIFO threshold
+ *  interrupt is pending, as the NVIC would.
+ *
+ *  Overflow: a write that does not fit is dropped whole and counted, everything
+ *  accepted leaves in order. A deterministic producer/consumer run predicts every
+ *  accept/drop from the free space; a signal driven run adds an interrupt producer
+ *  preempting the main one, and checks that every line arrives whole and the
+ *  counters add up to what was written, sent and dropped.
+ */
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "test_check.h"
+#include "hal_fake.h"
+#include "retarget.h"
+
+#define WIRE_MAX            (1u << 21)
+#define SIM_STEPS           400000u
+#define STRESS_TICK_US      50
+#define STRESS_TICKS        4000u
+#define STRESS_BYTES_TICK   4u          /* ~800 kbaud */
+#define STRESS_ISR_EVERY    5u          /* ticks between interrupt lines */
+
+static uint32_t main_line(uint32_t n, char *buf);
+
+/* newlib hooks of retarget.c */
+int _write(int file, char *ptr, int len);
+int __io_putchar(int ch);
+
+static UART_HandleTypeDef huart3 = { .Instance = USART3 };
+static uint8_t  wire[WIRE_MAX];
+static volatile uint32_t wireLen;
+static uint8_t  expected[WIRE_MAX];
+static uint32_t lcg_u32 = 1u;
+
+static uint32_t lcg(void)
+{
+    lcg_u32 = (lcg_u32 * 1664525u) + 1013904223u;
+    return lcg_u32 >> 8;
+}
+
+static void wire_shift(uint32_t n)
+{
+    if ((wireLen + n) <= WIRE_MAX)
+        wireLen += hal_fake_usart_shift(n, &wire[wireLen]);
+}
+
+/* The NVIC side of USART3: the handler runs while the threshold interrupt is pending */
+static void uart_irq(void)
+{
+    if (hal_fake_usart_txft_pending())
+        RetargetIRQHandler();
+}
+
+/* Ring, stats and FIFO from scratch (RetargetInit() also resets stdout's buffer) */
+static void init(void)
+{
+    fflush(stdout);
+    hal_fake_reset();
+    RetargetInit(&huart3);
+    wireLen = 0u;
+}
+
+static void drain_all(void)
+{
+    for (uint32_t guard = 0u; guard < (2u * RETARGET_TX_BUF_SIZE); guard++)
+    {
+        uart_irq();
+        wire_shift(HAL_FAKE_USART_FIFO);
+        if (((USART3->CR3 & USART_CR3_TXFTIE) == 0u) && (hal_fake_usart_level() == 0u))
+            return;
+    }
+}
+
+static void test_before_init(void)
+{
+    CHECK(!RetargetWrite("x", 1u));
+    CHECK(RetargetFlush(0u));
+}
+
+static void test_init(void)
+{
+    init();
+    CHECK(hal_fake_usart_fifo_mode() == USART3);
+    CHECK(hal_fake_nvic_enabled(USART3_IRQn));
+    CHECK(hal_fake_nvic_priority(USART3_IRQn) == RETARGET_IRQ_PRIORITY);
+    CHECK((USART3->CR3 & USART_CR3_TXFTIE) == 0u);              // nothing to send yet
+    CHECK(!RetargetWrite("x", 0u));
+    CHECK(RetargetGetStats()->droppedWrites_u32 == 0u);
+}
+
+/* Nothing drains: the ring fills to the last byte, then writes are dropped whole */
+static void test_overflow_whole_writes(void)
+{
+    uint8_t rec[100];
+    uint32_t len = 0u;
+
+    init();
+    for (uint32_t i = 0u; i < 25u; i++)
+    {
+        memset(rec, 'A' + (int)i, sizeof(rec));
+        const bool ok = RetargetWrite(rec, sizeof(rec));
+        CHECK(ok == (i < 20u));
+        if (ok)
+        {
+            memcpy(&expected[len], rec, sizeof(rec));
+            len += sizeof(rec);
+        }
+    }
+    memset(rec, 'z', 48u);
+    CHECK(RetargetWrite(rec, 48u));                             // exactly the rest
+    memcpy(&expected[len], rec, 48u);
+    len += 48u;
+    CHECK(!RetargetWrite("!", 1u));
+
+    const RetargetStats_t *st = RetargetGetStats();
+    CHECK(st->writtenBytes_u32 == RETARGET_TX_BUF_SIZE);
+    CHECK(st->droppedBytes_u32 == ((5u * sizeof(rec)) + 1u));
+    CHECK(st->droppedWrites_u32 == 6u);
+    CHECK(st->highWater_u32 == RETARGET_TX_BUF_SIZE);
+    CHECK((USART3->CR3 & USART_CR3_TXFTIE) != 0u);
+
+    drain_all();
+    CHECK(wireLen == len);
+    CHECK(memcmp(wire, expected, len) == 0);
+    CHECK((USART3->CR3 & USART_CR3_TXFTIE) == 0u);
+    CHECK((USART3->ISR & USART_ISR_TC) != 0u);
+    CHECK(hal_fake_usart_lost() == 0u);
+
+    /* Empty again, also across the wrap: the whole ring fits, one byte more does not */
+    static uint8_t big[RETARGET_TX_BUF_SIZE + 1u];
+    CHECK(!RetargetWrite(big, sizeof(big)));
+    CHECK(RetargetWrite(big, RETARGET_TX_BUF_SIZE));
+}
+
+/* Random writes against a link that is sometimes slower, sometimes faster than them.
+ * Bytes leave the ring only through the FIFO, so the free space is known exactly. */
+static void test_simulated_link(void)
+{
+    uint8_t rec[160];
+    uint32_t accepted = 0u, rejected = 0u, rejectedWrites = 0u, highWater = 0u, pos = 0u;
+
+    init();
+    for (uint32_t step = 0u; step < SIM_STEPS; step++)
+    {
+        /* Phases of 20000 steps: ~20 bytes written per step against 2 sent, then
+         * ~2.5 written against 8 sent (the FIFO refills once per step) */
+        const bool fast = ((step / 20000u) & 1u) != 0u;
+
+        if ((lcg() % (fast ? 32u : 4u)) == 0u)
+        {
+            const uint32_t len  = 1u + (lcg() % sizeof(rec));
+            const uint32_t used = accepted - (wireLen + hal_fake_usart_level());
+
+            for (uint32_t k = 0u; k < len; k++)
+                rec[k] = (uint8_t)(pos + k);
+            const bool ok = RetargetWrite(rec, len);
+            CHECK_MSG(ok == (len <= (RETARGET_TX_BUF_SIZE - used)), "step %u: len %u used %u", step, len, used);
+            if (ok)
+            {
+                memcpy(&expected[accepted], rec, len);
+                accepted += len;
+                pos += len;
+                highWater = ((used + len) > highWater) ? (used + len) : highWater;
+            }
+            else
+            {
+                rejected += len;
+                rejectedWrites++;
+            }
+        }
+
+        wire_shift(fast ? HAL_FAKE_USART_FIFO : 2u);
+        uart_irq();
+    }
+    drain_all();
+
+    const RetargetStats_t *st = RetargetGetStats();
+    CHECK((rejectedWrites > 1000u) && (accepted > (100u * RETARGET_TX_BUF_SIZE)));
+    CHECK(highWater == RETARGET_TX_BUF_SIZE);
+    CHECK(wireLen == accepted);
+    CHECK(memcmp(wire, expected, accepted) == 0);
+    CHECK(st->writtenBytes_u32 == accepted);
+    CHECK(st->droppedBytes_u32 == rejected);
+    CHECK(st->droppedWrites_u32 == rejectedWrites);
+    CHECK(st->highWater_u32 == highWater);
+    CHECK(hal_fake_usart_lost() == 0u);
+}
+
+/* --- Interrupt producer on top of the main one --- */
+
+static uint32_t pendSeq;
+
+static void isr_line(void)
+{
+    char line[16];
+    const int len = snprintf(line, sizeof(line), "I%07u.\n", pendSeq++);
+    CHECK(RetargetWrite(line, (uint32_t)len));
+}
+
+/* An interrupt producer pended during each main write runs at its first chance: the
+ * barrier before the head update if the write were not masked, else right after it.
+ * Either way both lines must arrive whole, the main one first. */
+static void test_pended_producer(void)
+{
+    char buf[80];
+    uint32_t len = 0u;
+
+    init();
+    pendSeq = 0u;
+    for (uint32_t n = 0u; n < 200u; n++)
+    {
+        const uint32_t mLen = main_line(n, buf);
+
+        hal_fake_irq_pend(isr_line);
+        CHECK(RetargetWrite(buf, mLen));
+        memcpy(&expected[len], buf, mLen);
+        len += mLen;
+        len += (uint32_t)snprintf((char *)&expected[len], 16u, "I%07u.\n", n);
+        drain_all();
+    }
+    CHECK(pendSeq == 200u);
+    CHECK(wireLen == len);
+    CHECK(memcmp(wire, expected, len) == 0);
+}
+
+static volatile uint32_t ticks;
+static volatile uint32_t isrSeq, isrAccepted, isrDropped;
+
+static void uart_isr(int sig)
+{
+    (void)sig;
+    wire_shift(STRESS_BYTES_TICK);
+    uart_irq();
+    if ((++ticks % STRESS_ISR_EVERY) == 0u)
+    {
+        /* "I0000123.\n" from an interrupt that may have preempted a main write */
+        const uint32_t seq = isrSeq++;
+        if (RetargetPrintf("I%07u.\n", seq) > 0)
+            isrAccepted++;
+        else
+            isrDropped++;
+    }
+}
+
+static void timer_start(void (*handler)(int))
+{
+    struct sigaction sa;
+    struct itimerval it = { { 0, STRESS_TICK_US }, { 0, STRESS_TICK_US } };
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGALRM, &sa, NULL);
+    setitimer(ITIMER_REAL, &it, NULL);
+}
+
+static void timer_stop(void)
+{
+    struct itimerval it = { { 0, 0 }, { 0, 0 } };
+    setitimer(ITIMER_REAL, &it, NULL);
+    signal(SIGALRM, SIG_IGN);
+}
+
+/* Main line n: "M0000042:" then n % 50 letters of one kind */
+static uint32_t main_line(uint32_t n, char *buf)
+{
+    uint32_t len = (uint32_t)snprintf(buf, 16u, "M%07u:", n);
+    for (uint32_t k = 0u; k < (n % 50u); k++)
+        buf[len++] = (char)('a' + (n % 26u));
+    buf[len++] = '\n';
+    return len;
+}
+
+static bool line_ok(const uint8_t *line, uint32_t len, uint32_t *lastM, uint32_t *lastI, uint32_t *nM, uint32_t *nI)
+{
+    char ref[80];
+    unsigned seq;
+
+    if ((len == 9u) && (sscanf((const char *)line, "I%7u.", &seq) == 1) && (line[8] == '.'))
+    {
+        if ((*nI > 0u) && (seq <= *lastI))
+            return false;
+        *lastI = seq;
+        (*nI)++;
+        return true;
+    }
+    if ((len >= 9u) && (sscanf((const char *)line, "M%7u:", &seq) == 1))
+    {
+        const uint32_t refLen = main_line(seq, ref) - 1u;
+        if ((refLen != len) || (memcmp(ref, line, len) != 0) || ((*nM > 0u) && (seq <= *lastM)))
+            return false;
+        *lastM = seq;
+        (*nM)++;
+        return true;
+    }
+    return false;
+}
+
+static void wire_flush_poll(void)
+{
+    wire_shift(HAL_FAKE_USART_FIFO);
+    hal_fake_tick(1u);
+}
+
+static void test_preempting_producer(void)
+{
+    char buf[80];
+    uint32_t mAccepted = 0u, mDropped = 0u, mDroppedBytes = 0u;
+
+    init();
+    ticks = 0u;
+    isrSeq = isrAccepted = isrDropped = 0u;
+    timer_start(uart_isr);
+    for (uint32_t n = 0u; ticks < STRESS_TICKS; n++)
+    {
+        const uint32_t len = main_line(n, buf);
+
+        /* First half: write only while there is room, so the interrupt mostly lands in
+         * accepted writes; second half: as fast as possible into the full ring */
+        while ((ticks < (STRESS_TICKS / 2u)) &&
+               (((RetargetGetStats()->writtenBytes_u32 - wireLen) + len) > RETARGET_TX_BUF_SIZE)) { }
+        if (RetargetWrite(buf, len))
+            mAccepted++;
+        else
+        {
+            mDropped++;
+            mDroppedBytes += len;
+        }
+    }
+    timer_stop();
+
+    hal_fake_tick_hook(wire_flush_poll);
+    CHECK(RetargetFlush(1000u));
+    hal_fake_tick_hook(NULL);
+
+    /* Every line whole, each producer's lines in order, the counts as returned */
+    uint32_t lastM = 0u, lastI = 0u, nM = 0u, nI = 0u, start = 0u, bad = 0u;
+    for (uint32_t i = 0u; i < wireLen; i++)
+    {
+        if (wire[i] == '\n')
+        {
+            bad += line_ok(&wire[start], i - start, &lastM, &lastI, &nM, &nI) ? 0u : 1u;
+            start = i + 1u;
+        }
+    }
+    const RetargetStats_t *st = RetargetGetStats();
+    CHECK(bad == 0u);
+    CHECK(start == wireLen);                                    // ends on a line end
+    CHECK_MSG((nM == mAccepted) && (nI == isrAccepted), "main %u/%u isr %u/%u", nM, mAccepted, nI, isrAccepted);
+    CHECK((mDropped > 0u) && (isrDropped > 0u) && (nI > 0u));  // both hit the full ring
+    CHECK(st->writtenBytes_u32 == wireLen);
+    CHECK(st->droppedBytes_u32 == (mDroppedBytes + (isrDropped * 10u)));
+    CHECK(st->droppedWrites_u32 == (mDropped + isrDropped));
+    CHECK(st->highWater_u32 <= RETARGET_TX_BUF_SIZE);
+    CHECK(hal_fake_usart_lost() == 0u);
+}
+
+/* Time passes, nothing leaves the FIFO */
+static void stalled_poll(void)
+{
+    hal_fake_tick(1u);
+}
+
+/* RetargetFlush() drains by polling; a stalled link runs into the timeout */
+static void test_flush(void)
+{
+    static uint8_t rec[300];
+
+    init();
+    memset(rec, 'f', sizeof(rec));
+    CHECK(RetargetWrite(rec, sizeof(rec)));
+    hal_fake_tick_hook(wire_flush_poll);
+    CHECK(RetargetFlush(100u));
+    CHECK((wireLen == sizeof(rec)) && ((USART3->ISR & USART_ISR_TC) != 0u));
+
+    CHECK(RetargetWrite(rec, 50u));
+    hal_fake_tick_hook(stalled_poll);
+    const uint32_t t0 = HAL_GetTick();
+    CHECK(!RetargetFlush(20u));
+    CHECK((HAL_GetTick() - t0) > 20u);
+    CHECK((hal_fake_usart_level() == HAL_FAKE_USART_FIFO) && (hal_fake_usart_lost() == 0u));
+
+    hal_fake_tick_hook(wire_flush_poll);
+    CHECK(RetargetFlush(100u));
+    CHECK(wireLen == (sizeof(rec) + 50u));
+    hal_fake_tick_hook(NULL);
+}
+
+static void test_printf_and_hooks(void)
+{
+    char longStr[200];
+
+    init();
+    memset(longStr, 'x', sizeof(longStr) - 1u);
+    longStr[sizeof(longStr) - 1u] = '\0';
+    CHECK(RetargetPrintf("%s", longStr) == (int)(RETARGET_PRINTF_MAX - 1u));     // truncated
+    CHECK(__io_putchar('A') == 'A');
+    CHECK(_write(1, "abc", 3) == 3);
+    drain_all();
+    CHECK(wireLen == (RETARGET_PRINTF_MAX - 1u + 4u));
+    CHECK(memcmp(&wire[RETARGET_PRINTF_MAX - 1u], "Aabc", 4u) == 0);
+
+    /* A dropped _write() still reports success, newlib would latch an error on stdout */
+    static uint8_t big[RETARGET_TX_BUF_SIZE];
+    CHECK(RetargetWrite(big, sizeof(big)));
+    CHECK(_write(1, "abc", 3) == 3);
+    CHECK(__io_putchar('A') == -1);
+    CHECK(RetargetGetStats()->droppedWrites_u32 == 2u);
+}
+
+int main(void)
+{
+    test_before_init();
+    test_init();
+    test_overflow_whole_writes();
+    test_simulated_link();
+    test_pended_producer();
+    test_preempting_producer();
+    test_flush();
+    test_printf_and_hooks();
+    fflush(stdout);
+    return TEST_DONE();
+}
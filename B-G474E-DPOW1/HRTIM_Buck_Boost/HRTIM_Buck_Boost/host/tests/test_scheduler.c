@@ -0,0 +1,389 @@
+/*
+ * test_scheduler.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  scheduler.c on simulated time: one cycle counter at the G474's 170 MHz gives
+ *  both the cycles the scheduler measures and the millisecond tick it is called
+ *  with. Tasks cost a scripted number of cycles, interrupts raise events at given
+ *  times, and the idle main loop moves on by one microsecond per empty pass.
+ *
+ *  Every run is logged with its start time, so release times, priority order,
+ *  lateness, missed releases and overruns are checked against what the schedule
+ *  must have been, not only against the module's own counters.
+ */
+
+#include <string.h>
+
+#include "test_check.h"
+#include "scheduler.h"
+
+#define CPU_HZ              170000000u
+#define CYC_PER_US          (CPU_HZ / 1000000u)
+#define CYC_PER_MS          (CPU_HZ / 1000u)
+#define LOG_MAX             200000u
+
+/* --- Simulated time --- */
+
+static uint64_t simCycles;          /* since the start of the run */
+static uint32_t tickBase_ms;        /* HAL tick at simCycles == 0 */
+
+static uint32_t sim_cycles(void)
+{
+    return (uint32_t)simCycles;
+}
+
+static uint32_t now_ms(void)
+{
+    return tickBase_ms + (uint32_t)(simCycles / CYC_PER_MS);
+}
+
+/* --- Interrupts raising events: at atCycles, SCHED_SetEvent(task) --- */
+
+typedef struct
+{
+    uint64_t atCycles;
+    uint32_t task;
+} SimIrq_t;
+
+static SimIrq_t irqs[64];
+static uint32_t numIrqs, nextIrq;
+
+static void advance(uint64_t cycles)
+{
+    const uint64_t end = simCycles + cycles;
+    while ((nextIrq < numIrqs) && (irqs[nextIrq].atCycles <= end))
+    {
+        if (irqs[nextIrq].atCycles > simCycles)
+            simCycles = irqs[nextIrq].atCycles;
+        SCHED_SetEvent(irqs[nextIrq].task);
+        nextIrq++;
+    }
+    simCycles = end;
+}
+
+/* --- Tasks: cost per run in cycles, optionally one long run --- */
+
+typedef struct
+{
+    uint32_t task;
+    uint32_t start_ms;
+    uint64_t startCycles;
+} RunLog_t;
+
+static RunLog_t  runLog[LOG_MAX];
+static uint32_t  numRuns;
+static uint32_t  taskCost[SCHED_MAX_TASKS];
+static uint32_t  longRunAt[SCHED_MAX_TASKS];     /* run index with longCost, 0 = none */
+static uint32_t  longCost[SCHED_MAX_TASKS];
+static uint32_t  runsOf[SCHED_MAX_TASKS];
+static uint32_t  raiseOwnEvent[SCHED_MAX_TASKS];  /* runs that raise their own event */
+
+static void task_body(uint32_t task)
+{
+    if (numRuns < LOG_MAX)
+        runLog[numRuns++] = (RunLog_t){ task, now_ms(), simCycles };
+    runsOf[task]++;
+    if (raiseOwnEvent[task] > 0u)
+    {
+        raiseOwnEvent[task]--;
+        SCHED_SetEvent(task);
+    }
+    advance(((longRunAt[task] != 0u) && (runsOf[task] == longRunAt[task])) ? longCost[task] : taskCost[task]);
+}
+
+static void task0(void) { task_body(0u); }
+static void task1(void) { task_body(1u); }
+static void task2(void) { task_body(2u); }
+static void task3(void) { task_body(3u); }
+
+static void sim_reset(uint32_t tick0_ms)
+{
+    simCycles = 0u;
+    tickBase_ms = tick0_ms;
+    numIrqs = nextIrq = numRuns = 0u;
+    memset(taskCost, 0, sizeof(taskCost));
+    memset(longRunAt, 0, sizeof(longRunAt));
+    memset(longCost, 0, sizeof(longCost));
+    memset(runsOf, 0, sizeof(runsOf));
+    memset(raiseOwnEvent, 0, sizeof(raiseOwnEvent));
+}
+
+/* The main loop: one task per pass, 1 us per pass with nothing ready */
+static void run_for_ms(uint32_t ms)
+{
+    const uint64_t end = simCycles + ((uint64_t)ms * CYC_PER_MS);
+    while (simCycles < end)
+    {
+        if (!SCHED_Run(now_ms()))
+            advance(CYC_PER_US);
+    }
+}
+
+static uint32_t runs_of(uint32_t task, uint32_t *firstIdx)
+{
+    uint32_t n = 0u;
+    *firstIdx = LOG_MAX;
+    for (uint32_t i = 0u; i < numRuns; i++)
+    {
+        if (runLog[i].task == task)
+        {
+            if (n == 0u)
+                *firstIdx = i;
+            n++;
+        }
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void test_init(void)
+{
+    static const SCHED_TaskDesc_t one[1] = { { "t0", task0, 1u, 0u } };
+    static SCHED_TaskDesc_t many[SCHED_MAX_TASKS + 1u];
+
+    CHECK(!SCHED_Init(NULL, 1u, sim_cycles, CYC_PER_US, 0u));
+    CHECK(!SCHED_Init(one, 1u, NULL, CYC_PER_US, 0u));
+    CHECK(!SCHED_Init(many, SCHED_MAX_TASKS + 1u, sim_cycles, CYC_PER_US, 0u));
+    CHECK(SCHED_Init(one, 1u, sim_cycles, CYC_PER_US, 0u));
+    CHECK(SCHED_GetStats(SCHED_MAX_TASKS) == NULL);
+    SCHED_SetEvent(SCHED_MAX_TASKS);                             // ignored
+}
+
+/* Light load: every release on time, in its period, in priority order */
+static void test_periodic_timing(void)
+{
+    static const SCHED_TaskDesc_t tasks[3] = {
+        { "fast", task0, 1u,  0u },
+        { "mid",  task1, 10u, 0u },
+        { "slow", task2, 100u, 0u },
+    };
+    uint32_t first;
+
+    sim_reset(5000u);
+    taskCost[0] = 20u * CYC_PER_US;
+    taskCost[1] = 150u * CYC_PER_US;
+    taskCost[2] = 600u * CYC_PER_US;
+    CHECK(SCHED_Init(tasks, 3u, sim_cycles, CYC_PER_US, now_ms()));
+    run_for_ms(1000u);
+
+    /* Released at init + k * period, k >= 1: the release at 1000 ms is past the run */
+    CHECK(runs_of(0u, &first) == 999u);
+    CHECK(runs_of(1u, &first) == 99u);
+    CHECK(runs_of(2u, &first) == 9u);
+
+    uint32_t k[3] = { 0u, 0u, 0u };
+    uint32_t maxLate = 0u;
+    for (uint32_t i = 0u; i < numRuns; i++)
+    {
+        const uint32_t t = runLog[i].task;
+        const uint32_t release = 5000u + ((k[t] + 1u) * tasks[t].period_ms);
+        CHECK_MSG(runLog[i].start_ms >= release, "task %u run %u at %u ms, release %u", t, k[t], runLog[i].start_ms, release);
+        if ((runLog[i].start_ms - release) > maxLate)
+            maxLate = runLog[i].start_ms - release;
+        k[t]++;
+
+        /* Same tick: the higher priority task of the two ran first */
+        if ((i > 0u) && (runLog[i - 1u].start_ms == runLog[i].start_ms) && (runLog[i - 1u].task > t))
+            CHECK_MSG(runLog[i - 1u].startCycles + taskCost[runLog[i - 1u].task] <= runLog[i].startCycles, "order at %u ms", runLog[i].start_ms);
+    }
+    /* The 600 us task delays the 1 ms one by less than a tick */
+    CHECK(maxLate <= 1u);
+
+    for (uint32_t t = 0u; t < 3u; t++)
+    {
+        const SCHED_TaskStats_t *st = SCHED_GetStats(t);
+        CHECK((st->overruns_u32 == 0u) && (st->missed_u32 == 0u) && (st->events_u32 == 0u));
+        CHECK((st->lastCycles_u32 == taskCost[t]) && (st->maxCycles_u32 == taskCost[t]));
+        CHECK(st->maxLate_ms <= 1u);
+    }
+    CHECK(SCHED_GetStats(0u)->runs_u32 == 999u);
+}
+
+/* A long low priority run: the fast task misses releases, runs once, keeps its phase */
+static void test_missed_releases(void)
+{
+    static const SCHED_TaskDesc_t tasks[2] = {
+        { "fast", task0, 2u,  0u },
+        { "slow", task1, 50u, 0u },
+    };
+    uint32_t first;
+
+    sim_reset(0u);
+    taskCost[0] = 10u * CYC_PER_US;
+    taskCost[1] = 100u * CYC_PER_US;
+    longRunAt[1] = 2u;                                           // second run takes 25.3 ms
+    longCost[1] = (25u * CYC_PER_MS) + (300u * CYC_PER_US);
+    CHECK(SCHED_Init(tasks, 2u, sim_cycles, CYC_PER_US, now_ms()));
+    run_for_ms(200u);
+
+    const SCHED_TaskStats_t *fast = SCHED_GetStats(0u);
+    const SCHED_TaskStats_t *slow = SCHED_GetStats(1u);
+
+    /* The slow task starts at 100 ms and blocks until 125.3: releases 102 .. 124 are
+     * late, the one at 126 is not. The twelve run once at 125: 11 missed. */
+    CHECK_MSG(fast->missed_u32 == 11u, "missed %u", fast->missed_u32);
+    CHECK(fast->maxLate_ms == 23u);
+    CHECK(fast->runs_u32 == (99u - 11u));
+
+    /* Phase kept: every run after the stall starts on an even tick again */
+    runs_of(0u, &first);
+    bool seenStall = false;
+    for (uint32_t i = first; i < numRuns; i++)
+    {
+        if (runLog[i].task != 0u)
+            continue;
+        if (runLog[i].start_ms == 125u)
+            seenStall = true;
+        else
+            CHECK_MSG((runLog[i].start_ms % 2u) == 0u, "fast run at %u ms", runLog[i].start_ms);
+    }
+    CHECK(seenStall);
+
+    /* Budget = period: 25.3 ms in a 50 ms period is no overrun, the lateness it
+     * caused belongs to the other task */
+    CHECK((slow->overruns_u32 == 0u) && (slow->missed_u32 == 0u));
+    CHECK(slow->maxCycles_u32 == longCost[1]);
+    CHECK(slow->lastCycles_u32 == taskCost[1]);
+}
+
+/* Overruns: a run above the explicit budget, or above the period by default */
+static void test_overruns(void)
+{
+    static const SCHED_TaskDesc_t tasks[3] = {
+        { "budget", task0, 5u,  200u },
+        { "period", task1, 20u, 0u   },
+        { "event",  task2, 0u,  50u  },
+    };
+
+    sim_reset(0u);
+    taskCost[0] = 200u * CYC_PER_US;                             // exactly the budget
+    longRunAt[0] = 7u;
+    longCost[0] = (200u * CYC_PER_US) + 1u;                      // one cycle over
+    taskCost[1] = 3u * CYC_PER_MS;
+    longRunAt[1] = 3u;
+    longCost[1] = (20u * CYC_PER_MS) + CYC_PER_US;               // longer than its period
+    taskCost[2] = 51u * CYC_PER_US;
+    irqs[numIrqs++] = (SimIrq_t){ 50u * CYC_PER_MS, 2u };
+    CHECK(SCHED_Init(tasks, 3u, sim_cycles, CYC_PER_US, now_ms()));
+    run_for_ms(300u);
+
+    CHECK(SCHED_GetStats(0u)->overruns_u32 == 1u);
+    CHECK(SCHED_GetStats(0u)->maxCycles_u32 == longCost[0]);
+    CHECK(SCHED_GetStats(1u)->overruns_u32 == 1u);
+    CHECK(SCHED_GetStats(1u)->missed_u32 == 0u);                 // its own stall delays the next release only
+    CHECK((SCHED_GetStats(2u)->runs_u32 == 1u) && (SCHED_GetStats(2u)->overruns_u32 == 1u));
+    CHECK(SCHED_GetStats(2u)->events_u32 == 1u);
+
+    /* The 20 ms stall made the 5 ms task late: four releases run as one, 3 missed */
+    CHECK(SCHED_GetStats(0u)->missed_u32 == 3u);
+    CHECK(SCHED_GetStats(0u)->maxLate_ms >= 15u);
+
+    SCHED_ResetMax();
+    CHECK((SCHED_GetStats(0u)->maxCycles_u32 == 0u) && (SCHED_GetStats(0u)->maxLate_ms == 0u));
+    CHECK(SCHED_GetStats(0u)->overruns_u32 == 1u);               // counters stay
+    run_for_ms(20u);
+    CHECK(SCHED_GetStats(0u)->maxCycles_u32 == taskCost[0]);
+    CHECK(SCHED_GetStats(0u)->maxLate_ms == 0u);
+}
+
+/* Events: the next pass, not the next release; raised during the run: once more */
+static void test_events(void)
+{
+    static const SCHED_TaskDesc_t tasks[3] = {
+        { "prot",  task0, 0u,  0u },
+        { "ctrl",  task1, 10u, 0u },
+        { "tele",  task2, 0u,  0u },
+    };
+    uint32_t first;
+
+    sim_reset(0u);
+    taskCost[0] = 5u * CYC_PER_US;
+    taskCost[1] = 400u * CYC_PER_US;
+    taskCost[2] = 30u * CYC_PER_US;
+    for (uint32_t i = 0u; i < 20u; i++)
+        irqs[numIrqs++] = (SimIrq_t){ (uint64_t)((i * 7u) + 3u) * CYC_PER_MS + (i * 13u * CYC_PER_US), i % 3u };
+    CHECK(SCHED_Init(tasks, 3u, sim_cycles, CYC_PER_US, now_ms()));
+    run_for_ms(150u);
+
+    /* Every event runs its task within the longest run of another task plus a pass */
+    for (uint32_t e = 0u; e < numIrqs; e++)
+    {
+        if (irqs[e].task == 1u)
+            continue;
+        bool ran = false;
+        for (uint32_t i = 0u; i < numRuns; i++)
+        {
+            if ((runLog[i].task == irqs[e].task) && (runLog[i].startCycles >= irqs[e].atCycles))
+            {
+                CHECK_MSG((runLog[i].startCycles - irqs[e].atCycles) <= (taskCost[1] + taskCost[0] + CYC_PER_US),
+                          "event %u ran %llu cycles late", e, (unsigned long long)(runLog[i].startCycles - irqs[e].atCycles));
+                ran = true;
+                break;
+            }
+        }
+        CHECK_MSG(ran, "event %u never ran", e);
+    }
+    CHECK(runs_of(0u, &first) == 7u);
+    CHECK(runs_of(2u, &first) == 6u);
+    CHECK(SCHED_GetStats(0u)->events_u32 == 7u);
+
+    /* An event on a periodic task runs it early; the release stays where it was */
+    CHECK(SCHED_GetStats(1u)->events_u32 == 7u);
+    CHECK(SCHED_GetStats(1u)->runs_u32 == (14u + 7u));
+
+    /* Raised during its own run: runs again at the next pass, once */
+    const uint32_t before = runsOf[2];
+    raiseOwnEvent[2] = 1u;
+    SCHED_SetEvent(2u);
+    run_for_ms(1u);
+    CHECK(runsOf[2] == (before + 2u));
+}
+
+/* The tick wraps during the run: releases and lateness carry on */
+static void test_tick_wrap(void)
+{
+    static const SCHED_TaskDesc_t tasks[1] = { { "fast", task0, 3u, 0u } };
+    uint32_t first;
+
+    sim_reset(0xFFFFFFFFu - 100u);
+    taskCost[0] = 50u * CYC_PER_US;
+    CHECK(SCHED_Init(tasks, 1u, sim_cycles, CYC_PER_US, now_ms()));
+    run_for_ms(300u);
+    CHECK(runs_of(0u, &first) == 99u);
+    CHECK((SCHED_GetStats(0u)->missed_u32 == 0u) && (SCHED_GetStats(0u)->maxLate_ms == 0u));
+    for (uint32_t i = 1u; i < numRuns; i++)
+        CHECK((uint32_t)(runLog[i].start_ms - runLog[i - 1u].start_ms) == 3u);
+}
+
+/* Full table, nothing released at the init tick: idle passes, then the first release */
+static void test_idle_passes(void)
+{
+    static const SCHED_TaskDesc_t tasks[SCHED_MAX_TASKS] = {
+        { "t0", task0, 1u, 0u }, { "t1", task1, 2u, 0u }, { "t2", task2, 5u, 0u }, { "t3", task3, 10u, 0u },
+        { "t0", task0, 20u, 0u }, { "t1", task1, 50u, 0u }, { "t2", task2, 100u, 0u }, { "t3", task3, 0u, 0u },
+    };
+
+    sim_reset(0u);
+    CHECK(SCHED_Init(tasks, SCHED_MAX_TASKS, sim_cycles, CYC_PER_US, now_ms()));
+    uint32_t idle = 0u;
+    for (uint32_t i = 0u; i < 1000u; i++)
+        idle += SCHED_Run(0u) ? 0u : 1u;
+    CHECK(idle == 1000u);                                        // nothing released at the init tick
+    CHECK(SCHED_Run(1u));
+    CHECK((numRuns == 1u) && (runLog[0].task == 0u));
+}
+
+int main(void)
+{
+    test_init();
+    test_periodic_timing();
+    test_missed_releases();
+    test_overruns();
+    test_events();
+    test_tick_wrap();
+    test_idle_passes();
+    return TEST_DONE();
+}
@@ -0,0 +1,331 @@
+/*
+ * test_voltage_ctrl.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Voltage loop (voltage_ctrl.c, compensator.c) on the averaged buck-boost model: the
+ *  measured start ratio, a bumpless start on a charged output, set-point steps across
+ *  buck and buck-boost at the corners of the power stage, the gain margin behind the
+ *  VCTRL_PI_KP tuning, the same steps and the anti-windup at the clamp with a 2p2z and
+ *  a 3p3z compensator, and the cost of one step.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "buck_boost_model.h"
+#include "main.h"
+
+static const BBMODEL_Params_t corners[] = {
+    { 5.0, 4.7e-6, 20e-6,  5.0,  0.05 },
+    { 5.0, 4.7e-6, 20e-6,  50.0, 0.05 },
+    { 5.0, 4.7e-6, 100e-6, 5.0,  0.05 },
+    { 5.0, 4.7e-6, 100e-6, 50.0, 0.05 },
+    { 5.0, 22e-6,  20e-6,  5.0,  0.05 },
+    { 5.0, 22e-6,  20e-6,  50.0, 0.05 },
+    { 5.0, 22e-6,  100e-6, 5.0,  0.05 },
+    { 5.0, 22e-6,  100e-6, 50.0, 0.05 },
+};
+#define NUM_CORNERS (sizeof(corners) / sizeof(corners[0]))
+
+static void start_at(BBMODEL_t *m, VCTRL_t *vc, const BBMODEL_Params_t *p, uint32_t vout_mV)
+{
+    BBMODEL_Init(m, p, vout_mV / 1000.0);
+    VCTRL_Init(vc, BUCK_PWM_PERIOD);
+    VCTRL_SetTarget_mV(vc, vout_mV);
+    VCTRL_Start(vc, BBMODEL_VoutCode(m), BBMODEL_VinCode(m));
+}
+
+/* m = Vout / Vin from the two dividers, over the whole code range */
+static void test_start_ratio(void)
+{
+    static const struct {
+        double vin_V, vout_V, m;
+    } cases[] = {
+        { 5.0,  5.0,  1.0 },
+        { 12.0, 3.0,  0.25 },
+        { 5.0,  8.0,  1.6 },
+        { 3.3,  1.0,  1.0 / 3.3 },
+        { 15.0, 16.0, 16.0 / 15.0 },
+    };
+    BBMODEL_Params_t p = corners[0];
+    BBMODEL_t m;
+    VCTRL_t vc;
+
+    for (uint32_t c = 0u; c < (sizeof(cases) / sizeof(cases[0])); c++)
+    {
+        p.vin_V = cases[c].vin_V;
+        BBMODEL_Init(&m, &p, cases[c].vout_V);
+        VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+        VCTRL_Start(&vc, BBMODEL_VoutCode(&m), BBMODEL_VinCode(&m));
+        CHECK_MSG(fabs(vc.m_s16 - (cases[c].m * VCTRL_M_ONE)) < (0.005 * VCTRL_M_ONE) + 8.0,
+                  "%.1f V -> %.1f V: m = %d, expected %.0f", cases[c].vin_V, cases[c].vout_V, vc.m_s16,
+                  cases[c].m * VCTRL_M_ONE);
+        CHECK(vc.comp.y_s16[0] == vc.m_s16);                        // the PI holds it
+    }
+
+    /* Full-scale codes (the uint32 product overflowed from a Vout code of about 5 on) */
+    VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+    VCTRL_Start(&vc, 4095u, 4095u);
+    CHECK(fabs(vc.m_s16 - (503.0 / 497.0 * VCTRL_M_ONE)) < 2.0);
+    VCTRL_Start(&vc, 4095u, 1u);
+    CHECK(vc.m_s16 == VCTRL_M_MAX);
+    VCTRL_Start(&vc, 0u, 2000u);
+    CHECK(vc.m_s16 == VCTRL_M_MIN);
+    VCTRL_Start(&vc, 2000u, 0u);
+    CHECK(vc.m_s16 == VCTRL_M_MIN);
+}
+
+/*
+ * Enabling the loop on a charged output does not step the duty: the first ratio is the
+ * measured Vout/Vin, and the output only sags by the conduction loss (the ideal ratio
+ * is a few percent short of the operating point) until the integrator makes it up.
+ */
+static void test_bumpless_start(void)
+{
+    static const uint32_t outputs_mV[] = { 2500u, 5000u, 8000u };
+    BBMODEL_Trace_t trace;
+    BBMODEL_t m;
+    VCTRL_t vc;
+
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        for (uint32_t k = 0u; k < (sizeof(outputs_mV) / sizeof(outputs_mV[0])); k++)
+        {
+            const double v_V = outputs_mV[k] / 1000.0;
+            start_at(&m, &vc, &corners[c], outputs_mV[k]);
+            BBMODEL_TraceReset(&trace, &m);
+            BBMODEL_Loop(&m, &vc, 1u, &trace);
+            CHECK(fabs(vc.m_s16 - ((v_V / corners[c].vin_V) * VCTRL_M_ONE)) < (0.01 * VCTRL_M_ONE));
+            BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 20u, &trace);          // 50 ms
+            const double dev = fmax(trace.vMax_V - v_V, v_V - trace.vMin_V);
+            CHECK_MSG(dev < (0.06 * v_V), "corner %u at %u mV: %.0f mV excursion", c, outputs_mV[k], dev * 1000.0);
+            CHECK(fabs(m.vOut_V - v_V) < 0.03);
+        }
+    }
+}
+
+/*
+ * 3 V -> 8 V (buck into buck-boost) and back at every corner: no overshoot beyond the
+ * ADC resolution, settled within the ramp time plus a few ms, no limit cycle.
+ */
+static void test_step_response(void)
+{
+    BBMODEL_Trace_t trace;
+    BBMODEL_t m;
+    VCTRL_t vc;
+    const double ramp_s = 5.0 / VCTRL_SLEW_mV_PER_MS;                // 5 V at the default slew (V/s)
+
+    for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+    {
+        start_at(&m, &vc, &corners[c], 3000u);
+        BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, NULL);
+        CHECK(fabs(m.vOut_V - 3.0) < 0.02);
+        CHECK(vc.region == VCTRL_REGION_BUCK);
+
+        VCTRL_SetTarget_mV(&vc, 8000u);
+        BBMODEL_TraceReset(&trace, &m);
+        BBMODEL_Loop(&m, &vc, (uint32_t)((ramp_s + 0.020) * VCTRL_FS_HZ), &trace);
+        CHECK_MSG(trace.vMax_V < 8.03, "corner %u: peak %.3f V", c, trace.vMax_V);
+        CHECK_MSG(fabs(m.vOut_V - 8.0) < 0.03, "corner %u: %.3f V after the ramp + 20 ms", c, m.vOut_V);
+        CHECK(vc.region == VCTRL_REGION_BUCK_BOOST);
+
+        BBMODEL_TraceReset(&trace, &m);
+        BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, &trace);
+        CHECK_MSG((trace.vMax_V - trace.vMin_V) < 0.02, "corner %u: %.0f mV ripple at 8 V", c,
+                  (trace.vMax_V - trace.vMin_V) * 1000.0);
+
+        VCTRL_SetTarget_mV(&vc, 3000u);
+        BBMODEL_TraceReset(&trace, &m);
+        BBMODEL_Loop(&m, &vc, (uint32_t)((ramp_s + 0.020) * VCTRL_FS_HZ), &trace);
+        CHECK_MSG(trace.vMin_V > 2.97, "corner %u: dip to %.3f V", c, trace.vMin_V);
+        CHECK_MSG(fabs(m.vOut_V - 3.0) < 0.03, "corner %u: %.3f V after the ramp down", c, m.vOut_V);
+        CHECK(vc.region == VCTRL_REGION_BUCK);
+    }
+}
+
+/* Twice VCTRL_PI_KP oscillates on the LC resonance of the large-L, light-load corner */
+static void test_gain_margin(void)
+{
+    const BBMODEL_Params_t *p = &corners[5];        // 22 uH, 20 uF, 50 ohm
+    BBMODEL_Trace_t trace;
+    BBMODEL_t m;
+    VCTRL_t vc;
+
+    start_at(&m, &vc, p, 3000u);
+    const int16_t kp = (int16_t)-vc.comp.b_s16[1];
+    const int16_t ki = (int16_t)(vc.comp.b_s16[0] - kp);
+    COMP_InitPI(&vc.comp, (int16_t)(2 * kp), ki, vc.comp.postShift_u8, VCTRL_M_MIN, VCTRL_M_MAX);
+    COMP_Reset(&vc.comp, vc.m_s16);
+    VCTRL_SetTarget_mV(&vc, 8000u);
+    BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, NULL);
+    BBMODEL_TraceReset(&trace, &m);
+    BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 2u, &trace);
+    printf("2 x kp at 22 uH / 20 uF / 50 ohm: %.2f .. %.2f V\n", trace.vMin_V, trace.vMax_V);
+    CHECK((trace.vMax_V - trace.vMin_V) > 1.0);
+}
+
+/*
+ * 2p2z / 3p3z: the VCTRL PI followed by first-order sections (1 - q z^-1) / (1 - p z^-1)
+ * at unity DC gain, multiplied out into one compensator. The poles are dyadic, so the
+ * integrator at z = 1 survives the Q1.15 rounding of the a-coefficients exactly.
+ */
+typedef struct
+{
+    double zero, pole;                      /* q, p */
+} Section_t;
+
+static COMP_Coeffs_t npnz_coeffs(const Section_t *sec, uint32_t numSec)
+{
+    VCTRL_t vc;
+    VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+
+    /* The PI as polynomials in z^-1, real values (scaled by 2^-R in the coefficients) */
+    const double scale = 32768.0 / (double)(1u << vc.comp.postShift_u8);
+    double b[COMP_MAX_ORDER + 1u] = { vc.comp.b_s16[0] / scale, vc.comp.b_s16[1] / scale };
+    double a[COMP_MAX_ORDER + 1u] = { 1.0, -vc.comp.a_s16[0] / scale };
+    COMP_Coeffs_t cf = { .order_u8 = (uint8_t)(1u + numSec), .postShift_u8 = vc.comp.postShift_u8 };
+
+    for (uint32_t s = 0u; s < numSec; s++)
+    {
+        const double g = (1.0 - sec[s].pole) / (1.0 - sec[s].zero);
+        for (uint32_t k = 2u + s; k > 0u; k--)
+        {
+            b[k] = g * (b[k] - (sec[s].zero * b[k - 1u]));
+            a[k] = a[k] - (sec[s].pole * a[k - 1u]);
+        }
+        b[0] *= g;
+    }
+    for (uint32_t k = 0u; k <= cf.order_u8; k++)
+    {
+        cf.b_s16[k] = (int16_t)lround(b[k] * scale);
+        if (k > 0u)
+            cf.a_s16[k - 1u] = (int16_t)lround(-a[k] * scale);
+    }
+    return cf;
+}
+
+static void start_npnz(BBMODEL_t *m, VCTRL_t *vc, const BBMODEL_Params_t *p, uint32_t vout_mV, const COMP_Coeffs_t *cf)
+{
+    start_at(m, vc, p, vout_mV);
+    CHECK(COMP_InitNpNz(&vc->comp, cf, VCTRL_M_MIN, VCTRL_M_MAX));
+    COMP_Reset(&vc->comp, vc->m_s16);
+}
+
+/* Orders the history shifts cannot take are refused, the compensator left as it was */
+static void test_npnz_init(void)
+{
+    COMP_Coeffs_t cf = npnz_coeffs(NULL, 0u);
+    COMP_t comp, ref;
+
+    COMP_InitPI(&comp, 1000, 100, 2u, -100, 100);
+    ref = comp;
+    cf.order_u8 = 0u;
+    CHECK(!COMP_InitNpNz(&comp, &cf, 0, 1));
+    cf.order_u8 = COMP_MAX_ORDER + 1u;
+    CHECK(!COMP_InitNpNz(&comp, &cf, 0, 1));
+    cf.order_u8 = 1u;
+    cf.postShift_u8 = 8u;
+    CHECK(!COMP_InitNpNz(&comp, &cf, 0, 1));
+    CHECK(memcmp(&comp, &ref, sizeof(comp)) == 0);
+
+    /* The first-order set is the PI itself */
+    VCTRL_t vc;
+    VCTRL_Init(&vc, BUCK_PWM_PERIOD);
+    cf.postShift_u8 = vc.comp.postShift_u8;
+    CHECK(COMP_InitNpNz(&comp, &cf, VCTRL_M_MIN, VCTRL_M_MAX));
+    CHECK(memcmp(comp.b_s16, vc.comp.b_s16, sizeof(comp.b_s16)) == 0);
+    CHECK(memcmp(comp.a_s16, vc.comp.a_s16, sizeof(comp.a_s16)) == 0);
+}
+
+static void test_npnz(void)
+{
+    static const Section_t sections[] = { { -1.0, 0.5 }, { 0.75, 0.25 } };
+    BBMODEL_Trace_t trace;
+    BBMODEL_t m;
+    VCTRL_t vc;
+    const double ramp_s = 5.0 / VCTRL_SLEW_mV_PER_MS;
+
+    for (uint32_t n = 1u; n <= 2u; n++)
+    {
+        const COMP_Coeffs_t cf = npnz_coeffs(sections, n);
+        int32_t aSum = -(32768 >> cf.postShift_u8);
+        for (uint32_t k = 0u; k < cf.order_u8; k++)
+            aSum += cf.a_s16[k];
+        CHECK(aSum == 0);                                       // integrator kept exactly
+
+        for (uint32_t c = 0u; c < NUM_CORNERS; c++)
+        {
+            start_npnz(&m, &vc, &corners[c], 3000u, &cf);
+            BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, NULL);
+            CHECK(fabs(m.vOut_V - 3.0) < 0.02);
+
+            VCTRL_SetTarget_mV(&vc, 8000u);
+            BBMODEL_TraceReset(&trace, &m);
+            BBMODEL_Loop(&m, &vc, (uint32_t)((ramp_s + 0.020) * VCTRL_FS_HZ), &trace);
+            CHECK_MSG(trace.vMax_V < 8.03, "%up%uz corner %u: peak %.3f V", n + 1u, n + 1u, c, trace.vMax_V);
+            CHECK_MSG(fabs(m.vOut_V - 8.0) < 0.03, "%up%uz corner %u: %.3f V after the ramp + 20 ms", n + 1u, n + 1u, c, m.vOut_V);
+
+            BBMODEL_TraceReset(&trace, &m);
+            BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, &trace);
+            CHECK_MSG((trace.vMax_V - trace.vMin_V) < 0.02, "%up%uz corner %u: %.0f mV ripple at 8 V", n + 1u, n + 1u, c,
+                      (trace.vMax_V - trace.vMin_V) * 1000.0);
+
+            /* Anti-windup: 12 V is out of reach from 5 V, the ratio sits at the clamp
+             * and so does the whole y history. Stepped down to 6 V, the output leaves
+             * the clamp on the next error of the other sign. */
+            VCTRL_SetTarget_mV(&vc, 12000u);
+            BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 10u, NULL);
+            bool held = (vc.m_s16 == VCTRL_M_MAX);
+            for (uint32_t k = 0u; k < cf.order_u8; k++)
+                held = held && (vc.comp.y_s16[k] == VCTRL_M_MAX);
+            CHECK_MSG(held, "%up%uz corner %u: m = %d at 12 V", n + 1u, n + 1u, c, vc.m_s16);
+
+            VCTRL_SetSlew_mV_per_ms(&vc, 100000u);
+            VCTRL_SetTarget_mV(&vc, 6000u);
+            uint32_t steps = 0u;
+            while ((vc.m_s16 == VCTRL_M_MAX) && (steps < VCTRL_FS_HZ))
+            {
+                BBMODEL_Loop(&m, &vc, 1u, NULL);
+                steps++;
+            }
+            BBMODEL_TraceReset(&trace, &m);
+            BBMODEL_Loop(&m, &vc, VCTRL_FS_HZ / 20u, &trace);
+            CHECK_MSG(steps <= 2u, "%up%uz corner %u: %u steps at the clamp after the step down", n + 1u, n + 1u, c, steps);
+            CHECK_MSG(trace.vMin_V > 5.97, "%up%uz corner %u: dip to %.3f V", n + 1u, n + 1u, c, trace.vMin_V);
+            CHECK_MSG(fabs(m.vOut_V - 6.0) < 0.03, "%up%uz corner %u: %.3f V 50 ms after 12 V -> 6 V", n + 1u, n + 1u, c, m.vOut_V);
+        }
+    }
+}
+
+static void test_cost(void)
+{
+    BBMODEL_t m;
+    VCTRL_t vc;
+
+    start_at(&m, &vc, &corners[0], 5000u);
+    const uint32_t before = vc.stats.iterations_u32;
+    const double ns = BBMODEL_StepCost_ns(&vc, 1000000u);
+    printf("VCTRL_Step: %.1f ns per step on the host (control period %.0f ns)\n", ns, 1e9 / VCTRL_FS_HZ);
+    CHECK(vc.stats.iterations_u32 == (before + 1000000u));
+    CHECK(ns < (1e9 / VCTRL_FS_HZ));
+
+    VCTRL_RecordCycles(&vc, 300u);
+    VCTRL_RecordCycles(&vc, 200u);
+    CHECK((vc.stats.lastCycles_u32 == 200u) && (vc.stats.maxCycles_u32 == 300u));
+}
+
+int main(void)
+{
+    test_start_ratio();
+    test_bumpless_start();
+    test_step_response();
+    test_gain_margin();
+    test_npnz_init();
+    test_npnz();
+    test_cost();
+    return TEST_DONE();
+}
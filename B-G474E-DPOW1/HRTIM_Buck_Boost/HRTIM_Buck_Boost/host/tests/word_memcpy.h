@@ -0,0 +1,36 @@
+/*
+ * word_memcpy.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Forced into the copy of com_gcom.c that test_com_gcom builds: memcpy() becomes a
+ *  word loop, as on the M4, where an interrupt can land between any two words. The
+ *  x86 memcpy moves a 64 byte block in two vector loads and would hide a torn copy.
+ */
+
+#ifndef HOST_TESTS_WORD_MEMCPY_H_
+#define HOST_TESTS_WORD_MEMCPY_H_
+
+#include <stdint.h>
+#include <string.h>
+
+static inline void *word_memcpy(void *dst, const void *src, size_t n)
+{
+    volatile uint8_t *d = dst;
+    const volatile uint8_t *s = src;
+
+    /* Words while both sides are aligned, then bytes */
+    if ((((uintptr_t)dst | (uintptr_t)src) & 3u) == 0u)
+    {
+        for (; n >= 4u; n -= 4u, d += 4, s += 4)
+            *(volatile uint32_t *)d = *(const volatile uint32_t *)s;
+    }
+    for (; n > 0u; n--)
+        *d++ = *s++;
+    return dst;
+}
+
+#define memcpy(dst, src, n)     word_memcpy((dst), (src), (n))
+
+#endif /* HOST_TESTS_WORD_MEMCPY_H_ */
@@ -53,6 +53,8 @@ void SVC_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
+void USART3_IRQHandler(void);
+void DMA1_Channel1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
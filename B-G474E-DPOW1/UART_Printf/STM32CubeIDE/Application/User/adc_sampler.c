@@ -0,0 +1,246 @@
+#include "adc_sampler.h"
+#include "adc_stats.h"
+#include "lockfree.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SMP_DMA_LEN         (2u * SMP_BLOCK_LEN)
+
+#if (SMP_RING_LEN & (SMP_RING_LEN - 1u)) != 0
+#error "SMP_RING_LEN must be a power of 2"
+#endif
+
+typedef struct
+{
+    STATS_Acc_t ch[2];              /* ADC1, ADC2                               */
+    uint32_t    cycles_u32;         /* cost of the reduction                    */
+} SMP_Block_t;
+
+static ADC_HandleTypeDef *s_master = NULL;
+static ADC_HandleTypeDef *s_slave  = NULL;
+static DMA_HandleTypeDef  s_hdma;
+
+static uint32_t s_dmaBuf[SMP_DMA_LEN] __attribute__((aligned(4)));
+
+/* DMA interrupt -> main loop, filled in place */
+static SMP_Block_t s_blockStore[SMP_RING_LEN];
+static LF_Spsc_t   s_blocks = LF_SPSC_INIT(s_blockStore, sizeof(SMP_Block_t), SMP_RING_LEN);
+
+static SMP_Stats_t s_stats;
+
+/* Current report, main loop only */
+static STATS_Acc_t s_report[2];
+static uint64_t    s_reportCycles_u64;
+static uint32_t    s_reportStart_ms;
+
+static bool SMP_ConfigAdc(ADC_HandleTypeDef *hadc)
+{
+    hadc->Init.ContinuousConvMode    = ENABLE;
+    hadc->Init.DMAContinuousRequests = ENABLE;
+    hadc->Init.Overrun               = ADC_OVR_DATA_OVERWRITTEN;
+    hadc->Init.OversamplingMode      = ENABLE;
+    hadc->Init.Oversampling.Ratio                 = SMP_OVS_RATIO;
+    hadc->Init.Oversampling.RightBitShift         = SMP_OVS_SHIFT;
+    hadc->Init.Oversampling.TriggeredMode         = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+    hadc->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
+    return HAL_ADC_Init(hadc) == HAL_OK;
+}
+
+static void SMP_ReportReset(uint32_t now_ms)
+{
+    STATS_Reset(&s_report[0], SMP_RESULT_BITS);
+    STATS_Reset(&s_report[1], SMP_RESULT_BITS);
+    s_reportCycles_u64 = 0u;
+    s_reportStart_ms   = now_ms;
+}
+
+bool SMP_Init(ADC_HandleTypeDef *master, ADC_HandleTypeDef *slave)
+{
+    ADC_MultiModeTypeDef multimode = {0};
+
+    s_master = master;
+    s_slave  = slave;
+
+    if (!SMP_ConfigAdc(master) || !SMP_ConfigAdc(slave))
+        return false;
+
+    /* Slave follows the master's conversions; one DMA word per result pair */
+    multimode.Mode             = ADC_DUALMODE_REGSIMULT;
+    multimode.DMAAccessMode    = ADC_DMAACCESSMODE_12_10_BITS;
+    multimode.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_1CYCLE;
+    if (HAL_ADCEx_MultiModeConfigChannel(master, &multimode) != HAL_OK)
+        return false;
+
+    __HAL_RCC_DMAMUX1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    s_hdma.Instance                 = DMA1_Channel1;
+    s_hdma.Init.Request             = DMA_REQUEST_ADC1;
+    s_hdma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    s_hdma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    s_hdma.Init.MemInc              = DMA_MINC_ENABLE;
+    s_hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    s_hdma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    s_hdma.Init.Mode                = DMA_CIRCULAR;
+    s_hdma.Init.Priority            = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&s_hdma) != HAL_OK)
+        return false;
+    __HAL_LINKDMA(master, DMA_Handle, s_hdma);
+
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, SMP_DMA_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+    /* Cycle counter for the reduction cost */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    return true;
+}
+
+bool SMP_Start(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+    SMP_ReportReset(HAL_GetTick());
+    return HAL_ADCEx_MultiModeStart_DMA(s_master, s_dmaBuf, SMP_DMA_LEN) == HAL_OK;
+}
+
+/* DMA half/full transfer: reduce the half the DMA has just left */
+static void SMP_ProcessBlock(const uint32_t *words_u32, bool firstHalf)
+{
+    const uint32_t start = DWT->CYCCNT;
+
+    SMP_Block_t *blk = LF_SpscWriteSlot(&s_blocks);
+    if (blk == NULL)
+    {
+        s_stats.dropped_u32++;
+        return;
+    }
+
+    STATS_Reset(&blk->ch[0], SMP_RESULT_BITS);
+    STATS_Reset(&blk->ch[1], SMP_RESULT_BITS);
+    STATS_AccumulateDual(blk->ch, words_u32, SMP_BLOCK_LEN);
+
+    /* The DMA must still be in the other half, or part of this one was overwritten
+     * while it was read (the block then mixes in newer samples, still real ones) */
+    const uint32_t pos = SMP_DMA_LEN - __HAL_DMA_GET_COUNTER(&s_hdma);
+    if (firstHalf ? (pos < SMP_BLOCK_LEN) : (pos >= SMP_BLOCK_LEN))
+    {
+        s_stats.late_u32++;
+    }
+
+    const uint32_t cycles = DWT->CYCCNT - start;
+    blk->cycles_u32 = cycles;
+    LF_SpscCommit(&s_blocks);
+
+    s_stats.blocks_u32++;
+    s_stats.lastCycles_u32 = cycles;
+    if (cycles > s_stats.maxCycles_u32)
+    {
+        s_stats.maxCycles_u32 = cycles;
+    }
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc == s_master)
+    {
+        SMP_ProcessBlock(&s_dmaBuf[0], true);
+    }
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc == s_master)
+    {
+        SMP_ProcessBlock(&s_dmaBuf[SMP_BLOCK_LEN], false);
+    }
+}
+
+void SMP_DmaIRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&s_hdma);
+}
+
+const SMP_Stats_t *SMP_GetStats(void)
+{
+    return &s_stats;
+}
+
+/* x / 16 with one decimal */
+#define SMP_X16_FMT             "%lu.%lu"
+#define SMP_X16_ARG(x)          (unsigned long)((x) >> 4), (unsigned long)((((x) & 15u) * 10u) >> 4)
+
+static void SMP_PrintChannel(const char *name, const STATS_Acc_t *acc)
+{
+    STATS_Result_t r;
+    STATS_Finish(acc, &r);
+
+    printf("%s mean " SMP_X16_FMT " rms " SMP_X16_FMT " std " SMP_X16_FMT " min/max %u/%u\r\n",
+           name, SMP_X16_ARG(r.mean_x16_u32), SMP_X16_ARG(r.rms_x16_u32), SMP_X16_ARG(r.std_x16_u32),
+           r.min_u16, r.max_u16);
+
+    /* Occupied bins only, each 2^histShift codes wide */
+    printf("%s hist /%u:", name, 1u << acc->histShift_u8);
+    for (uint32_t i = 0u; i < STATS_HIST_BINS; i++)
+    {
+        if (acc->hist_u32[i] != 0u)
+        {
+            printf(" %lu:%lu", (unsigned long)i, (unsigned long)acc->hist_u32[i]);
+        }
+    }
+    printf("\r\n");
+}
+
+static void SMP_Report(uint32_t elapsed_ms)
+{
+    const uint32_t n = s_report[0].n_u32;
+
+    /* Results per channel and second, and what the reduction costs per result pair */
+    const uint32_t rate_x10   = (uint32_t)(((uint64_t)n * 10000u) / elapsed_ms);
+    const uint32_t cyc_x100   = (n != 0u) ? (uint32_t)((s_reportCycles_u64 * 100u) / n) : 0u;
+    const uint32_t load_x100  = (uint32_t)((s_reportCycles_u64 * 100000u) / ((uint64_t)elapsed_ms * SystemCoreClock / 100u));
+    const uint32_t capacity_k = (s_reportCycles_u64 != 0u)
+                              ? (uint32_t)(((uint64_t)SystemCoreClock * 2u * n) / (s_reportCycles_u64 * 1000u)) : 0u;
+
+    printf("ADC %lu-bit: %lu pairs in %lu ms = %lu.%lu S/s per ADC, reduce %lu.%02lu cycles/pair "
+           "(load %lu.%02lu %%, capacity %lu kS/s)\r\n",
+           (unsigned long)SMP_RESULT_BITS, (unsigned long)n, (unsigned long)elapsed_ms,
+           (unsigned long)(rate_x10 / 10u), (unsigned long)(rate_x10 % 10u),
+           (unsigned long)(cyc_x100 / 100u), (unsigned long)(cyc_x100 % 100u),
+           (unsigned long)(load_x100 / 100u), (unsigned long)(load_x100 % 100u),
+           (unsigned long)capacity_k);
+    SMP_PrintChannel("ADC1", &s_report[0]);
+    SMP_PrintChannel("ADC2", &s_report[1]);
+    printf("blocks %lu dropped %lu late %lu ovr %lu max %lu cycles\r\n",
+           s_stats.blocks_u32, s_stats.dropped_u32, s_stats.late_u32,
+           s_stats.overruns_u32, s_stats.maxCycles_u32);
+}
+
+bool SMP_Task(uint32_t now_ms)
+{
+    const SMP_Block_t *blk;
+    while ((blk = LF_SpscReadSlot(&s_blocks)) != NULL)
+    {
+        STATS_Merge(&s_report[0], &blk->ch[0]);
+        STATS_Merge(&s_report[1], &blk->ch[1]);
+        s_reportCycles_u64 += blk->cycles_u32;
+        LF_SpscRelease(&s_blocks);
+    }
+
+    /* With DMA an overrun blocks further requests: restart the acquisition */
+    if (__HAL_ADC_GET_FLAG(s_master, ADC_FLAG_OVR) || __HAL_ADC_GET_FLAG(s_slave, ADC_FLAG_OVR))
+    {
+        (void)HAL_ADCEx_MultiModeStop_DMA(s_master);
+        __HAL_ADC_CLEAR_FLAG(s_master, ADC_FLAG_OVR);
+        __HAL_ADC_CLEAR_FLAG(s_slave, ADC_FLAG_OVR);
+        s_stats.overruns_u32++;
+        (void)HAL_ADCEx_MultiModeStart_DMA(s_master, s_dmaBuf, SMP_DMA_LEN);
+    }
+
+    const uint32_t elapsed_ms = now_ms - s_reportStart_ms;
+    if (elapsed_ms < SMP_REPORT_MS)
+        return false;
+
+    SMP_Report(elapsed_ms);
+    SMP_ReportReset(now_ms);
+    return true;
+}
@@ -0,0 +1,86 @@
+#include "adc_stats.h"
+#include <string.h>
+#include <math.h>
+
+void STATS_Reset(STATS_Acc_t *acc, uint32_t resultBits)
+{
+    memset(acc, 0, sizeof(*acc));
+    acc->min_u16      = UINT16_MAX;
+    acc->histShift_u8 = (uint8_t)(resultBits - STATS_HIST_BITS);
+}
+
+void STATS_AccumulateDual(STATS_Acc_t acc[2], const uint32_t *words_u32, uint32_t n)
+{
+    STATS_Acc_t *a = &acc[0];
+    STATS_Acc_t *b = &acc[1];
+
+    /* Block sums in registers; 32 bits hold 65536 samples of 16 bits */
+    uint32_t sumA = 0u, sumB = 0u;
+    uint64_t sqA = 0u, sqB = 0u;
+    uint32_t minA = a->min_u16, maxA = a->max_u16;
+    uint32_t minB = b->min_u16, maxB = b->max_u16;
+    const uint32_t shA = a->histShift_u8;
+    const uint32_t shB = b->histShift_u8;
+
+    for (uint32_t i = 0u; i < n; i++)
+    {
+        const uint32_t w  = words_u32[i];
+        const uint32_t xa = w & 0xFFFFu;
+        const uint32_t xb = w >> 16;
+
+        sumA += xa;
+        sumB += xb;
+        sqA  += xa * xa;
+        sqB  += xb * xb;
+        if (xa < minA) minA = xa;
+        if (xa > maxA) maxA = xa;
+        if (xb < minB) minB = xb;
+        if (xb > maxB) maxB = xb;
+        a->hist_u32[xa >> shA]++;
+        b->hist_u32[xb >> shB]++;
+    }
+
+    a->n_u32     += n;
+    a->sum_u64   += sumA;
+    a->sumSq_u64 += sqA;
+    a->min_u16    = (uint16_t)minA;
+    a->max_u16    = (uint16_t)maxA;
+    b->n_u32     += n;
+    b->sum_u64   += sumB;
+    b->sumSq_u64 += sqB;
+    b->min_u16    = (uint16_t)minB;
+    b->max_u16    = (uint16_t)maxB;
+}
+
+void STATS_Merge(STATS_Acc_t *dst, const STATS_Acc_t *src)
+{
+    dst->n_u32     += src->n_u32;
+    dst->sum_u64   += src->sum_u64;
+    dst->sumSq_u64 += src->sumSq_u64;
+    if (src->min_u16 < dst->min_u16) dst->min_u16 = src->min_u16;
+    if (src->max_u16 > dst->max_u16) dst->max_u16 = src->max_u16;
+    for (uint32_t i = 0u; i < STATS_HIST_BINS; i++)
+    {
+        dst->hist_u32[i] += src->hist_u32[i];
+    }
+}
+
+void STATS_Finish(const STATS_Acc_t *acc, STATS_Result_t *res)
+{
+    memset(res, 0, sizeof(*res));
+    res->n_u32 = acc->n_u32;
+    if (acc->n_u32 == 0u)
+        return;
+
+    const double n    = (double)acc->n_u32;
+    const double mean = (double)acc->sum_u64 / n;
+    const double msq  = (double)acc->sumSq_u64 / n;
+    double var = msq - mean * mean;
+    if (var < 0.0) var = 0.0;           /* rounding on a noise free input */
+
+    res->mean_x16_u32 = (uint32_t)(mean * 16.0 + 0.5);
+    res->rms_x16_u32  = (uint32_t)(sqrt(msq) * 16.0 + 0.5);
+    res->std_x16_u32  = (uint32_t)(sqrt(var) * 16.0 + 0.5);
+    res->min_u16      = acc->min_u16;
+    res->max_u16      = acc->max_u16;
+}
@@ -0,0 +1,60 @@
+/*
+ * adc_stats.h
+ *
+ *  Block statistics of ADC samples: count, sum, sum of squares, min/max and a
+ *  histogram, accumulated in one pass straight off the DMA buffer.
+ *
+ *  STATS_AccumulateDual() reads dual regular simultaneous words as the DMA copies
+ *  them from ADC12_COMMON->CDR (master result in bits 15:0, slave in 31:16), so the
+ *  two channels are split on the fly instead of being copied out first. The loop
+ *  is integer only: one 32 x 32 -> 64 bit multiply-accumulate (UMLAL) per sample.
+ *
+ *  Accumulators of several blocks merge exactly (STATS_Merge), so a report can
+ *  cover any number of blocks. STATS_Finish() turns an accumulator into mean,
+ *  RMS and standard deviation in 1/16 LSB; it uses double precision and belongs
+ *  in the main loop, not in the DMA interrupt.
+ *
+ *  No hardware access: the same code runs on a host.
+ */
+
+#ifndef ADC_STATS_H
+#define ADC_STATS_H
+
+#include <stdint.h>
+
+#define STATS_HIST_BITS         5u
+#define STATS_HIST_BINS         (1u << STATS_HIST_BITS)     /* equal bins over the full range */
+
+typedef struct
+{
+    uint32_t n_u32;
+    uint64_t sum_u64;
+    uint64_t sumSq_u64;
+    uint16_t min_u16;
+    uint16_t max_u16;
+    uint8_t  histShift_u8;              /* sample >> histShift = bin            */
+    uint32_t hist_u32[STATS_HIST_BINS];
+} STATS_Acc_t;
+
+typedef struct
+{
+    uint32_t n_u32;
+    uint32_t mean_x16_u32;              /* 1/16 LSB                             */
+    uint32_t rms_x16_u32;               /* total RMS, 1/16 LSB                  */
+    uint32_t std_x16_u32;               /* RMS around the mean (noise), 1/16 LSB */
+    uint16_t min_u16;
+    uint16_t max_u16;
+} STATS_Result_t;
+
+/* Empty accumulator for samples of resultBits (6..16) bits */
+void STATS_Reset(STATS_Acc_t *acc, uint32_t resultBits);
+
+/* n (<= 65536) dual mode words: bits 15:0 into acc[0], bits 31:16 into acc[1] */
+void STATS_AccumulateDual(STATS_Acc_t acc[2], const uint32_t *words_u32, uint32_t n);
+
+/* dst += src (same resultBits) */
+void STATS_Merge(STATS_Acc_t *dst, const STATS_Acc_t *src);
+
+void STATS_Finish(const STATS_Acc_t *acc, STATS_Result_t *res);
+
+#endif /* ADC_STATS_H */
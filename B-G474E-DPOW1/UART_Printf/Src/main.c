@@ -23,6 +23,8 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "retarget.h"
+#include "adc_sampler.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -56,16 +58,7 @@ static void MX_USART3_UART_Init(void);
 static void MX_ADC2_Init(void);
 static void MX_ADC1_Init(void);
 /* USER CODE BEGIN PFP */
-#if defined(__ICCARM__)
-/* New definition from EWARM V9, compatible with EWARM8 */
-int iar_fputc(int ch);
-#define PUTCHAR_PROTOTYPE int iar_fputc(int ch)
-#elif defined ( __CC_ARM ) || defined(__ARMCC_VERSION)
-/* ARM Compiler 5/6*/
-#define PUTCHAR_PROTOTYPE int fputc(int ch, FILE *f)
-#elif defined(__GNUC__)
-#define PUTCHAR_PROTOTYPE int __io_putchar(int ch)
-#endif /* __ICCARM__ */
+
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
@@ -121,6 +114,14 @@ int main(void)
   MX_ADC2_Init();
   MX_ADC1_Init();
   /* USER CODE BEGIN 2 */
+  /* printf goes through a ring buffer drained by the USART3 TX FIFO interrupt */
+  RetargetInit(&huart3);
+
+  /* Dual simultaneous, oversampled, circular DMA; reprograms the handles from MX_ADCx_Init() */
+  if (!SMP_Init(&hadc1, &hadc2))
+  {
+    Error_Handler();
+  }
   if (HAL_ADCEx_Calibration_Start(&hadc2, ADC_SINGLE_ENDED) != HAL_OK)
   {
     Error_Handler();
@@ -132,7 +133,11 @@ int main(void)
   /* Output a message on Hyperterminal using printf function */
   printf("\n\r UART Printf Example: retarget the C library printf function to the UART\n\r");
   printf("** Test finished successfully. ** \n\r");
-  printf("\n\r Starting ADC readings...\n\r");
+  printf("\n\r Starting ADC sampling, summary every %lu ms...\n\r", (unsigned long)SMP_REPORT_MS);
+  if (!SMP_Start())
+  {
+    Error_Handler();
+  }
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -142,36 +147,12 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-	uint32_t adc_value1 = 0;
-	uint32_t adc_value2 = 0;
-	//float voltage = 0.0;
-
-	/* Start ADC Conversion */
-	HAL_ADC_Start(&hadc1);
-	HAL_ADC_Start(&hadc2);
-
-	/* Poll for conversion completion (with timeout) */
-	if (HAL_ADC_PollForConversion(&hadc1, 100) == HAL_OK)
-	{
-	adc_value1 = HAL_ADC_GetValue(&hadc1);
-	printf("ADC1: %lu\n\r", adc_value1);
-	}
-	if (HAL_ADC_PollForConversion(&hadc2, 100) == HAL_OK)
-	{
-	adc_value2 = HAL_ADC_GetValue(&hadc2);
-	printf("ADC2: %lu\n\r", adc_value2);
-	}
-
-	/* Stop ADC */
-	HAL_ADC_Stop(&hadc1);
-	HAL_ADC_Stop(&hadc2);
-
-	/* Toggle LED to show activity */
-	BSP_LED_Toggle(LED2);
-
-	/* Delay 500ms between readings */
-	HAL_Delay(500);
-
+    /* Blocks are reduced in the DMA interrupt; only the summaries are printed */
+    if (SMP_Task(HAL_GetTick()))
+    {
+      /* Toggle LED to show activity */
+      BSP_LED_Toggle(LED2);
+    }
   }
   /* USER CODE END 3 */
 }
@@ -416,39 +397,6 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
-/**
-  * @brief  Retargets the C library __write function to the IAR function iar_fputc.
-  * @param  file: file descriptor.
-  * @param  ptr: pointer to the buffer where the data is stored.
-  * @param  len: length of the data to write in bytes.
-  * @retval length of the written data in bytes.
-  */
-#if defined(__ICCARM__)
-size_t __write(int file, unsigned char const *ptr, size_t len)
-{
-  size_t idx;
-  unsigned char const *pdata = ptr;
-
-  for (idx = 0; idx < len; idx++)
-  {
-    iar_fputc((int)*pdata);
-    pdata++;
-  }
-  return len;
-}
-#endif /* __ICCARM__ */
-
-/**
-  * @brief  Retargets the C library printf function to the USART.
-  */
-PUTCHAR_PROTOTYPE
-{
-  /* Place your implementation of fputc here */
-  /* e.g. write a character to the USART3 and Loop until the end of transmission */
-  HAL_UART_Transmit(&huart3, (uint8_t *)&ch, 1, 0xFFFF);
-
-  return ch;
-}
 
 /* USER CODE END 4 */
 
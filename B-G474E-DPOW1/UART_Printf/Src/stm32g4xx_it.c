@@ -25,7 +25,8 @@
 #include "stm32g4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "retarget.h"
+#include "adc_sampler.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -143,5 +144,19 @@ void SysTick_Handler(void)
 /******************************************************************************/
 
 /* USER CODE BEGIN 1 */
+/**
+  * @brief  This function handles USART3 global interrupt (printf TX FIFO refill).
+  */
+void USART3_IRQHandler(void)
+{
+  RetargetIRQHandler();
+}
 
+/**
+  * @brief  This function handles DMA1 channel 1 global interrupt (ADC1/ADC2 sample blocks).
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  SMP_DmaIRQHandler();
+}
 /* USER CODE END 1 */
@@ -0,0 +1,77 @@
+/*
+ * stats_bench_main.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Samples/s of STATS_AccumulateDual() on the host: reps blocks of pairs dual mode
+ *  words (noisy 14 bit data, as after the oversampler), each reduced into a fresh
+ *  accumulator and merged like the sampler does. The target reports its own figure
+ *  (cycles per pair, capacity in kS/s) in the SMP_Task() summary.
+ *
+ *      stats_bench_host [pairs reps]
+ *
+ *  Defaults: 1024 pairs (one DMA half, SMP_BLOCK_LEN), 20000 blocks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "adc_stats.h"
+
+#define BENCH_BITS      14u
+#define BENCH_MAX_PAIRS 65536u
+
+static uint32_t words[BENCH_MAX_PAIRS];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t pairs = 1024u, reps = 20000u, rng = 1u;
+    STATS_Acc_t total[2], blk[2];
+    STATS_Result_t res;
+
+    if (argc == 3)
+    {
+        pairs = (uint32_t)strtoul(argv[1], NULL, 0);
+        reps  = (uint32_t)strtoul(argv[2], NULL, 0);
+    }
+    if ((pairs == 0u) || (pairs > BENCH_MAX_PAIRS) || (reps == 0u))
+    {
+        fprintf(stderr, "usage: %s [pairs (1..%u) reps]\n", argv[0], BENCH_MAX_PAIRS);
+        return 2;
+    }
+
+    for (uint32_t i = 0u; i < pairs; i++)
+    {
+        rng = (rng * 1664525u) + 1013904223u;
+        words[i] = (8000u + ((rng >> 8) & 0x3Fu)) | ((3000u + ((rng >> 20) & 0xFu)) << 16);
+    }
+
+    STATS_Reset(&total[0], BENCH_BITS);
+    STATS_Reset(&total[1], BENCH_BITS);
+    const uint64_t t0 = now_ns();
+    for (uint32_t r = 0u; r < reps; r++)
+    {
+        STATS_Reset(&blk[0], BENCH_BITS);
+        STATS_Reset(&blk[1], BENCH_BITS);
+        STATS_AccumulateDual(blk, words, pairs);
+        STATS_Merge(&total[0], &blk[0]);
+        STATS_Merge(&total[1], &blk[1]);
+    }
+    const double s = (double)(now_ns() - t0) * 1e-9;
+    const double samples = 2.0 * pairs * (double)reps;
+
+    STATS_Finish(&total[0], &res);
+    printf("%u blocks of %u pairs: %.2f ns/pair, %.1f M samples/s (ch0 mean %lu.%02lu LSB)\n", reps, pairs,
+           (s * 1e9) / (pairs * (double)reps), (samples / s) * 1e-6,
+           (unsigned long)(res.mean_x16_u32 >> 4), (unsigned long)(((res.mean_x16_u32 & 15u) * 100u) >> 4));
+    return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * test_adc_stats.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  The block statistics (adc_stats.c) against a reference on the same words: sums,
+ *  sums of squares, extremes and histogram exactly in 64 bit, mean/RMS/std from a
+ *  two pass long double computation to within the 1/16 LSB rounding. Blocks are
+ *  the largest the API takes (65536 pairs), where the 32 bit block sums are closest
+ *  to overflowing, and merging or appending any split of a block must give the
+ *  accumulator of one pass.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "test_check.h"
+#include "adc_stats.h"
+
+#define MAX_PAIRS       65536u
+#define SMP_BITS        14u         /* the sampler's oversampled results */
+
+static uint32_t words[MAX_PAIRS];
+static uint32_t rng = 12345u;
+
+static uint32_t xorshift(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* Roughly gaussian, +-span */
+static int32_t noise(int32_t span)
+{
+    int32_t s = 0;
+    for (uint32_t k = 0u; k < 4u; k++)
+        s += (int32_t)(xorshift() % (uint32_t)(span + 1)) - (span / 2);
+    return s / 2;
+}
+
+static uint32_t clamp(int32_t x, uint32_t bits)
+{
+    const int32_t top = (int32_t)((1u << bits) - 1u);
+    return (uint32_t)((x < 0) ? 0 : ((x > top) ? top : x));
+}
+
+static uint32_t channel(uint32_t w, uint32_t ch)
+{
+    return (ch == 0u) ? (w & 0xFFFFu) : (w >> 16);
+}
+
+/* --- Reference --- */
+
+static void check_against_reference(const char *name, const uint32_t *w, uint32_t n, uint32_t bits)
+{
+    STATS_Acc_t acc[2];
+    STATS_Result_t res;
+
+    STATS_Reset(&acc[0], bits);
+    STATS_Reset(&acc[1], bits);
+    STATS_AccumulateDual(acc, w, n);
+
+    for (uint32_t ch = 0u; ch < 2u; ch++)
+    {
+        uint64_t sum = 0u, sumSq = 0u;
+        uint32_t mn = UINT16_MAX, mx = 0u, hist[STATS_HIST_BINS] = { 0u };
+
+        for (uint32_t i = 0u; i < n; i++)
+        {
+            const uint32_t x = channel(w[i], ch);
+            sum   += x;
+            sumSq += (uint64_t)x * x;
+            mn = (x < mn) ? x : mn;
+            mx = (x > mx) ? x : mx;
+            hist[(x * STATS_HIST_BINS) >> bits]++;
+        }
+
+        const long double mean = (long double)sum / n;
+        long double var = 0.0L;
+        for (uint32_t i = 0u; i < n; i++)
+        {
+            const long double d = (long double)channel(w[i], ch) - mean;
+            var += d * d;
+        }
+        var /= n;
+        const long double rms = sqrtl((long double)sumSq / n);
+
+        STATS_Finish(&acc[ch], &res);
+        printf("%s ch%u: mean %.4f (%.4Lf), rms %.4f (%.4Lf), std %.4f (%.4Lf) LSB\n", name, ch,
+               res.mean_x16_u32 / 16.0, mean, res.rms_x16_u32 / 16.0, rms, res.std_x16_u32 / 16.0, sqrtl(var));
+
+        CHECK((acc[ch].n_u32 == n) && (res.n_u32 == n));
+        CHECK(acc[ch].sum_u64 == sum);
+        CHECK(acc[ch].sumSq_u64 == sumSq);
+        CHECK((res.min_u16 == mn) && (res.max_u16 == mx));
+        for (uint32_t b = 0u; b < STATS_HIST_BINS; b++)
+        {
+            CHECK_MSG(acc[ch].hist_u32[b] == hist[b], "%s ch%u bin %u: %u, expected %u", name, ch, b,
+                      acc[ch].hist_u32[b], hist[b]);
+        }
+        CHECK(fabsl(res.mean_x16_u32 - (mean * 16.0L)) <= 0.5L + 1e-6L);
+        CHECK(fabsl(res.rms_x16_u32 - (rms * 16.0L)) <= 0.5L + 1e-6L);
+        CHECK_MSG(fabsl(res.std_x16_u32 - (sqrtl(var) * 16.0L)) <= 0.5L + 1e-6L, "%s ch%u std %u x16, expected %.4Lf",
+                  name, ch, res.std_x16_u32, sqrtl(var) * 16.0L);
+    }
+}
+
+static void test_noisy_dc(void)
+{
+    for (uint32_t i = 0u; i < MAX_PAIRS; i++)
+    {
+        words[i] = clamp(8000 + noise(40), SMP_BITS) | (clamp(3000 + noise(6), SMP_BITS) << 16);
+    }
+    check_against_reference("noisy dc", words, MAX_PAIRS, SMP_BITS);
+}
+
+static void test_sine(void)
+{
+    for (uint32_t i = 0u; i < MAX_PAIRS; i++)
+    {
+        const double ph = 2.0 * M_PI * i / 1000.0;
+        words[i] = clamp((int32_t)lround(8192.0 + (8190.0 * sin(ph))) + noise(4), SMP_BITS)
+                 | (clamp((int32_t)lround(100.0 + (99.0 * cos(ph))), SMP_BITS) << 16);
+    }
+    check_against_reference("sine", words, MAX_PAIRS, SMP_BITS);
+}
+
+/* 16 bit results over the whole range, both extremes included */
+static void test_full_scale(void)
+{
+    for (uint32_t i = 0u; i < MAX_PAIRS; i++)
+    {
+        words[i] = xorshift();
+    }
+    words[17] = 0u;
+    words[4711] = 0xFFFFFFFFu;
+    check_against_reference("full scale", words, MAX_PAIRS, 16u);
+
+    /* All at the top: the 32 bit block sums are at their limit (65536 x 65535) */
+    for (uint32_t i = 0u; i < MAX_PAIRS; i++)
+    {
+        words[i] = 0xFFFFFFFFu;
+    }
+    check_against_reference("all ones", words, MAX_PAIRS, 16u);
+}
+
+/* --- Merging and appending --- */
+
+static bool acc_equal(const STATS_Acc_t *a, const STATS_Acc_t *b)
+{
+    bool eq = (a->n_u32 == b->n_u32) && (a->sum_u64 == b->sum_u64) && (a->sumSq_u64 == b->sumSq_u64)
+           && (a->min_u16 == b->min_u16) && (a->max_u16 == b->max_u16) && (a->histShift_u8 == b->histShift_u8);
+
+    for (uint32_t i = 0u; i < STATS_HIST_BINS; i++)
+        eq = eq && (a->hist_u32[i] == b->hist_u32[i]);
+    return eq;
+}
+
+/* Blocks of random size (empty ones included), each reduced on its own and merged as
+ * SMP_Task() does, or appended to one accumulator: both equal the single pass */
+static void test_merge(void)
+{
+    STATS_Acc_t one[2], merged[2], appended[2], blk[2];
+    uint32_t blocks = 0u, bad = 0u;
+
+    for (uint32_t i = 0u; i < MAX_PAIRS; i++)
+    {
+        words[i] = clamp(5000 + noise(3000), SMP_BITS) | (clamp(12000 + noise(2000), SMP_BITS) << 16);
+    }
+    for (uint32_t ch = 0u; ch < 2u; ch++)
+    {
+        STATS_Reset(&one[ch], SMP_BITS);
+        STATS_Reset(&merged[ch], SMP_BITS);
+        STATS_Reset(&appended[ch], SMP_BITS);
+    }
+    STATS_AccumulateDual(one, words, MAX_PAIRS);
+
+    for (uint32_t pos = 0u; pos < MAX_PAIRS; blocks++)
+    {
+        uint32_t len = ((xorshift() % 8u) == 0u) ? 0u : (xorshift() % 4000u);
+        len = (len > (MAX_PAIRS - pos)) ? (MAX_PAIRS - pos) : len;
+
+        STATS_Reset(&blk[0], SMP_BITS);
+        STATS_Reset(&blk[1], SMP_BITS);
+        STATS_AccumulateDual(blk, &words[pos], len);
+        STATS_Merge(&merged[0], &blk[0]);
+        STATS_Merge(&merged[1], &blk[1]);
+        STATS_AccumulateDual(appended, &words[pos], len);
+        pos += len;
+    }
+
+    for (uint32_t ch = 0u; ch < 2u; ch++)
+    {
+        bad += acc_equal(&merged[ch], &one[ch]) ? 0u : 1u;
+        bad += acc_equal(&appended[ch], &one[ch]) ? 0u : 1u;
+    }
+    printf("merge: %u blocks\n", blocks);
+    CHECK(bad == 0u);
+}
+
+/* --- Corner cases --- */
+
+static void test_empty(void)
+{
+    STATS_Acc_t acc[2], ref;
+    STATS_Result_t res;
+
+    STATS_Reset(&acc[0], SMP_BITS);
+    STATS_Reset(&acc[1], SMP_BITS);
+    CHECK((acc[0].min_u16 == UINT16_MAX) && (acc[0].max_u16 == 0u) && (acc[0].histShift_u8 == (SMP_BITS - STATS_HIST_BITS)));
+
+    STATS_AccumulateDual(acc, words, 0u);
+    STATS_Finish(&acc[0], &res);
+    CHECK((res.n_u32 == 0u) && (res.mean_x16_u32 == 0u) && (res.rms_x16_u32 == 0u) && (res.std_x16_u32 == 0u));
+    CHECK((res.min_u16 == 0u) && (res.max_u16 == 0u));
+
+    /* An empty block merges as a no-op, its min/max included */
+    words[0] = 100u | (200u << 16);
+    STATS_AccumulateDual(acc, words, 1u);
+    ref = acc[0];
+    STATS_Reset(&acc[1], SMP_BITS);
+    STATS_Merge(&acc[0], &acc[1]);
+    CHECK(acc_equal(&acc[0], &ref));
+}
+
+static void test_constant(void)
+{
+    STATS_Acc_t acc[2];
+    STATS_Result_t res;
+
+    for (uint32_t i = 0u; i < MAX_PAIRS; i++)
+    {
+        words[i] = 0x1234u | (0x0000u << 16);
+    }
+    STATS_Reset(&acc[0], SMP_BITS);
+    STATS_Reset(&acc[1], SMP_BITS);
+    STATS_AccumulateDual(acc, words, MAX_PAIRS);
+
+    STATS_Finish(&acc[0], &res);
+    CHECK((res.mean_x16_u32 == (0x1234u * 16u)) && (res.rms_x16_u32 == (0x1234u * 16u)) && (res.std_x16_u32 == 0u));
+    CHECK((res.min_u16 == 0x1234u) && (res.max_u16 == 0x1234u));
+    CHECK(acc[0].hist_u32[0x1234u >> (SMP_BITS - STATS_HIST_BITS)] == MAX_PAIRS);
+
+    STATS_Finish(&acc[1], &res);
+    CHECK((res.mean_x16_u32 == 0u) && (res.rms_x16_u32 == 0u) && (res.std_x16_u32 == 0u));
+    CHECK((res.min_u16 == 0u) && (res.max_u16 == 0u) && (acc[1].hist_u32[0] == MAX_PAIRS));
+}
+
+/* Equal bins over the full range of every supported result width */
+static void test_hist_range(void)
+{
+    STATS_Acc_t acc[2];
+    uint32_t bad = 0u;
+
+    for (uint32_t bits = 6u; bits <= 16u; bits++)
+    {
+        const uint32_t top = (1u << bits) - 1u;
+
+        words[0] = 0u | (top << 16);
+        words[1] = (1u << (bits - 1u)) | (((1u << (bits - 1u)) - 1u) << 16);
+        STATS_Reset(&acc[0], bits);
+        STATS_Reset(&acc[1], bits);
+        STATS_AccumulateDual(acc, words, 2u);
+
+        bad += ((acc[0].hist_u32[0] == 1u) && (acc[0].hist_u32[STATS_HIST_BINS / 2u] == 1u)) ? 0u : 1u;
+        bad += ((acc[1].hist_u32[STATS_HIST_BINS - 1u] == 1u) && (acc[1].hist_u32[(STATS_HIST_BINS / 2u) - 1u] == 1u)) ? 0u : 1u;
+    }
+    CHECK(bad == 0u);
+}
+
+int main(void)
+{
+    test_noisy_dc();
+    test_sine();
+    test_full_scale();
+    test_merge();
+    test_empty();
+    test_constant();
+    test_hist_range();
+    return TEST_DONE();
+}
@@ -0,0 +1,50 @@
+/*
+ * lf_record.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Payload of the stress tests: every word derives from the record number, so a
+ *  copy that mixes two publishes (or a half written one) fails LF_RecCheck().
+ */
+
+#ifndef HOST_TESTS_LF_RECORD_H_
+#define HOST_TESTS_LF_RECORD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LF_REC_WORDS    63U
+
+typedef struct
+{
+    uint32_t n;
+    uint32_t w[LF_REC_WORDS];
+} LF_Rec_t;
+
+static inline uint32_t LF_RecWord(uint32_t n, uint32_t i)
+{
+    return (n * 2654435761U) ^ (i * 0x9E3779B9U);
+}
+
+/* Word by word through a volatile pointer, as slowly as a real ISR would fill it */
+static inline void LF_RecFill(void *dst, uint32_t n)
+{
+    volatile LF_Rec_t *r = (volatile LF_Rec_t *)dst;
+
+    r->n = n;
+    for (uint32_t i = 0U; i < LF_REC_WORDS; i++)
+        r->w[i] = LF_RecWord(n, i);
+}
+
+static inline bool LF_RecCheck(const LF_Rec_t *r)
+{
+    for (uint32_t i = 0U; i < LF_REC_WORDS; i++)
+    {
+        if (r->w[i] != LF_RecWord(r->n, i))
+            return false;
+    }
+    return true;
+}
+
+#endif /* HOST_TESTS_LF_RECORD_H_ */
@@ -0,0 +1,183 @@
+/*
+ * test_lf_basic.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  The single-context contract of lockfree.h: full and empty rings, the free
+ *  running counters across their wrap, in-place slots, the snapshot slot the writer
+ *  fills while readers keep the last publish, the triple buffer's fresh flag, and
+ *  flag bits taken once.
+ */
+
+#include <string.h>
+
+#include "test_check.h"
+#include "lockfree.h"
+
+#define RING_CAP    4U
+
+static void test_spsc_full_empty(void)
+{
+    uint32_t store[RING_CAP];
+    LF_Spsc_t q;
+    uint32_t v = 0U;
+
+    LF_SpscInit(&q, store, sizeof(uint32_t), RING_CAP);
+    CHECK(!LF_SpscPop(&q, &v));
+    CHECK(LF_SpscReadSlot(&q) == NULL);
+    CHECK(LF_SpscCount(&q) == 0U);
+
+    for (uint32_t i = 0U; i < RING_CAP; i++)
+    {
+        CHECK(LF_SpscPush(&q, &i));
+    }
+    CHECK(LF_SpscCount(&q) == RING_CAP);
+    CHECK(LF_SpscWriteSlot(&q) == NULL);
+    v = 99U;
+    CHECK(!LF_SpscPush(&q, &v));
+
+    for (uint32_t i = 0U; i < RING_CAP; i++)
+    {
+        CHECK(LF_SpscPop(&q, &v) && (v == i));
+    }
+    CHECK(!LF_SpscPop(&q, &v));
+}
+
+/* head/tail run through UINT32_MAX: full, empty and the slot index stay right */
+static void test_spsc_wrap(void)
+{
+    uint32_t store[RING_CAP];
+    LF_Spsc_t q = LF_SPSC_INIT(store, sizeof(uint32_t), RING_CAP);
+    uint32_t v = 0U, bad = 0U;
+
+    atomic_store(&q.head, UINT32_MAX - 5U);
+    atomic_store(&q.tail, UINT32_MAX - 5U);
+    for (uint32_t i = 0U; i < 40U; i++)
+    {
+        const uint32_t burst = 1U + (i % RING_CAP);
+
+        for (uint32_t k = 0U; k < burst; k++)
+        {
+            const uint32_t x = (i << 8) | k;
+            bad += LF_SpscPush(&q, &x) ? 0U : 1U;
+        }
+        bad += (LF_SpscCount(&q) == burst) ? 0U : 1U;
+        for (uint32_t k = 0U; k < burst; k++)
+        {
+            bad += (LF_SpscPop(&q, &v) && (v == ((i << 8) | k))) ? 0U : 1U;
+        }
+        bad += LF_SpscPop(&q, &v) ? 1U : 0U;
+    }
+    CHECK(atomic_load(&q.head) < 100U);         // did wrap
+    CHECK(bad == 0U);
+}
+
+/* Filled and drained in place: the consumer sees the slot the producer wrote */
+static void test_spsc_in_place(void)
+{
+    char store[RING_CAP][16];
+    LF_Spsc_t q;
+
+    LF_SpscInit(&q, store, sizeof(store[0]), RING_CAP);
+    char *w = LF_SpscWriteSlot(&q);
+    CHECK(w == store[0]);
+    strcpy(w, "in place");
+    CHECK(LF_SpscReadSlot(&q) == NULL);         // not committed yet
+    LF_SpscCommit(&q);
+
+    const char *r = LF_SpscReadSlot(&q);
+    CHECK((r == w) && (strcmp(r, "in place") == 0));
+    CHECK(LF_SpscReadSlot(&q) == r);            // the consumer's until released
+    LF_SpscRelease(&q);
+    CHECK(LF_SpscReadSlot(&q) == NULL);
+    CHECK(LF_SpscWriteSlot(&q) == store[1]);
+}
+
+static void test_snap(void)
+{
+    uint32_t store[2][4];
+    LF_Snap_t s = LF_SNAP_INIT(store, sizeof(store[0]));
+    uint32_t out[4] = { 0U }, retries = 0U;
+
+    CHECK(!LF_SnapRead(&s, out, 4U, &retries));
+    CHECK(LF_SnapCount(&s) == 0U);
+
+    for (uint32_t n = 1U; n <= 5U; n++)
+    {
+        uint32_t *w = LF_SnapWriteSlot(&s);
+        for (uint32_t i = 0U; i < 4U; i++)
+            w[i] = (n * 10U) + i;
+        CHECK(LF_SnapPublish(&s) == n);
+        CHECK(LF_SnapRead(&s, out, 1U, &retries) && (out[0] == (n * 10U)) && (out[3] == ((n * 10U) + 3U)));
+    }
+
+    /* An update in progress fills the other slot: readers keep getting publish 5 */
+    uint32_t *w = LF_SnapWriteSlot(&s);
+    CHECK(w != &store[LF_SnapCount(&s) & 1U][0]);
+    memset(w, 0xA5, sizeof(store[0]));
+    CHECK(LF_SnapRead(&s, out, 1U, NULL) && (out[0] == 50U));
+    CHECK(retries == 0U);
+
+    /* Two updates begun since the publish a reader would copy: that slot is reused */
+    atomic_store(&s.begin, LF_SnapCount(&s) + 2U);
+    CHECK(!LF_SnapRead(&s, out, 3U, &retries));
+    CHECK(retries == 3U);
+    CHECK(!LF_SnapRead(&s, out, 0U, NULL));
+}
+
+static void test_triple(void)
+{
+    uint32_t store[3];
+    LF_Triple_t t = LF_TRIPLE_INIT(store, sizeof(uint32_t));
+    bool fresh = true;
+
+    CHECK(LF_TripleRead(&t, &fresh) == NULL);
+    CHECK(!fresh);
+
+    *(uint32_t *)LF_TripleWriteBuf(&t) = 1U;
+    LF_TriplePublish(&t);
+    const uint32_t *r = LF_TripleRead(&t, &fresh);
+    CHECK((r != NULL) && (*r == 1U) && fresh);
+    r = LF_TripleRead(&t, &fresh);
+    CHECK((r != NULL) && (*r == 1U) && !fresh);
+
+    /* Unread publishes are overwritten: the reader gets the latest only */
+    for (uint32_t n = 2U; n <= 4U; n++)
+    {
+        uint32_t *w = LF_TripleWriteBuf(&t);
+        CHECK(w != r);                          // never the reader's buffer
+        *w = n;
+        LF_TriplePublish(&t);
+    }
+    r = LF_TripleRead(&t, &fresh);
+    CHECK((r != NULL) && (*r == 4U) && fresh);
+    CHECK(LF_TripleRead(&t, NULL) == r);
+    CHECK(LF_TripleWriteBuf(&t) != r);
+}
+
+static void test_flags(void)
+{
+    LF_Flags_t f = 0U;
+
+    LF_FlagsSet(&f, 0x5U);
+    LF_FlagsSet(&f, 0x80000000U);
+    CHECK(LF_FlagsPeek(&f) == 0x80000005U);
+    CHECK(LF_FlagsTake(&f, 0x3U) == 0x1U);      // only the bits asked for
+    CHECK(LF_FlagsTake(&f, 0x3U) == 0U);        // each set is taken once
+    CHECK(LF_FlagsPeek(&f) == 0x80000004U);
+    LF_FlagsClear(&f, 0x80000000U);
+    CHECK(LF_FlagsTake(&f, UINT32_MAX) == 0x4U);
+    CHECK(LF_FlagsPeek(&f) == 0U);
+}
+
+int main(void)
+{
+    test_spsc_full_empty();
+    test_spsc_wrap();
+    test_spsc_in_place();
+    test_snap();
+    test_triple();
+    test_flags();
+    return TEST_DONE();
+}
@@ -0,0 +1,416 @@
+/*
+ * test_lf_preempt.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  The single core case the primitives are written for: a timer signal plays the
+ *  interrupt and runs to completion on top of whatever the main loop was doing,
+ *  including the middle of a copy or between the load and the store of a
+ *  read-modify-write. Every primitive is run with the ISR on either side.
+ *
+ *  The last scenario is the control: the main loop updates the flag word with a
+ *  plain load / OR / store, and the ISR's bits must get lost. It shows the signal
+ *  really lands between instructions, so the clean runs above mean something.
+ */
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "test_check.h"
+#include "lockfree.h"
+#include "lf_record.h"
+
+#define STRESS_TICK_US      50
+#define STRESS_TICKS        3000u
+#define SPSC_CAP            16U
+#define ISR_BURST           6U          /* ring elements per tick */
+#define MAIN_BIT            31U         /* flag bit the main loop owns */
+#define ISR_BITS            8U
+
+static volatile sig_atomic_t ticks;
+
+static void timer_start(void (*handler)(int))
+{
+    struct sigaction sa;
+    struct itimerval timer = { { 0, STRESS_TICK_US }, { 0, STRESS_TICK_US } };
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handler;
+    sigemptyset(&sa.sa_mask);
+    CHECK(sigaction(SIGALRM, &sa, NULL) == 0);
+    ticks = 0;
+    CHECK(setitimer(ITIMER_REAL, &timer, NULL) == 0);
+}
+
+static void timer_stop(void)
+{
+    struct itimerval timer;
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+    signal(SIGALRM, SIG_DFL);
+}
+
+/* --- SPSC --- */
+
+static uint32_t  ringStore[SPSC_CAP];
+static LF_Spsc_t ring;
+static uint32_t  isrSeq;            /* next element of the ISR side   */
+static uint32_t  isrBad;            /* ISR side saw a wrong element   */
+static uint32_t  isrDrops;          /* producer ISR found the ring full */
+
+static void producer_isr(int sig)
+{
+    (void)sig;
+    for (uint32_t k = 0U; k < ISR_BURST; k++)
+    {
+        if (!LF_SpscPush(&ring, &isrSeq))
+        {
+            isrDrops++;
+            break;
+        }
+        isrSeq++;
+    }
+    ticks++;
+}
+
+/* ISR producer, the main loop consumes and checks the sequence */
+static void test_spsc_isr_producer(void)
+{
+    uint32_t next = 0U, bad = 0U, v;
+
+    LF_SpscInit(&ring, ringStore, sizeof(uint32_t), SPSC_CAP);
+    isrSeq = 0U;
+    isrDrops = 0U;
+    timer_start(producer_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        if (LF_SpscPop(&ring, &v))
+        {
+            bad += (v == next) ? 0U : 1U;
+            next = v + 1U;
+        }
+    }
+    timer_stop();
+    while (LF_SpscPop(&ring, &v))
+    {
+        bad += (v == next) ? 0U : 1U;
+        next = v + 1U;
+    }
+
+    printf("spsc, ISR producer: %u elements, %u bursts cut short\n", next, isrDrops);
+    CHECK(bad == 0U);
+    CHECK(next == isrSeq);
+}
+
+static void consumer_isr(int sig)
+{
+    uint32_t v;
+
+    (void)sig;
+    while (LF_SpscPop(&ring, &v))
+    {
+        isrBad += (v == isrSeq) ? 0U : 1U;
+        isrSeq = v + 1U;
+    }
+    ticks++;
+}
+
+/* The main loop produces, partly in place; the ISR drains and checks */
+static void test_spsc_isr_consumer(void)
+{
+    uint32_t n = 0U, full = 0U;
+
+    LF_SpscInit(&ring, ringStore, sizeof(uint32_t), SPSC_CAP);
+    isrSeq = 0U;
+    isrBad = 0U;
+    timer_start(consumer_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        volatile uint32_t *slot = LF_SpscWriteSlot(&ring);
+        if (slot == NULL)
+        {
+            full++;
+            continue;
+        }
+        *slot = n++;
+        LF_SpscCommit(&ring);
+    }
+    timer_stop();
+    consumer_isr(0);
+
+    printf("spsc, ISR consumer: %u elements, ring full %u times\n", n, full);
+    CHECK(isrBad == 0U);
+    CHECK(isrSeq == n);
+}
+
+/* --- Snapshot --- */
+
+static LF_Rec_t  snapStore[2];
+static LF_Snap_t snap;
+static uint32_t  isrN;              /* records published by the ISR   */
+static uint32_t  isrReads, isrFails, isrTorn, isrBack, isrLast;
+
+static void snap_init(void)
+{
+    const LF_Snap_t init = LF_SNAP_INIT(snapStore, sizeof(LF_Rec_t));
+    memcpy(&snap, &init, sizeof(snap));
+}
+
+/* Two publishes per tick: a main loop copy the tick lands in has its slot reused */
+static void snap_writer_isr(int sig)
+{
+    (void)sig;
+    for (uint32_t k = 0U; k < 2U; k++)
+    {
+        LF_RecFill(LF_SnapWriteSlot(&snap), ++isrN);
+        LF_SnapPublish(&snap);
+    }
+    ticks++;
+}
+
+static void test_snap_isr_writer(void)
+{
+    uint32_t reads = 0U, gaveUp = 0U, retries = 0U, torn = 0U, back = 0U, last = 0U;
+    LF_Rec_t rec;
+
+    snap_init();
+    isrN = 0U;
+    timer_start(snap_writer_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        if (!LF_SnapRead(&snap, &rec, 2U, &retries))
+        {
+            gaveUp += (LF_SnapCount(&snap) != 0U) ? 1U : 0U;
+            continue;
+        }
+        reads++;
+        torn += LF_RecCheck(&rec) ? 0U : 1U;
+        back += (rec.n < last) ? 1U : 0U;
+        last = rec.n;
+    }
+    timer_stop();
+
+    printf("snapshot, ISR writer: %u reads, %u retries, %u gave up\n", reads, retries, gaveUp);
+    CHECK(torn == 0U);
+    CHECK(back == 0U);
+    CHECK(retries > 0U);                        // interrupted copies were caught
+}
+
+/* A reader ISR on top of the writer: it must never fail nor retry, the update it
+ * preempted fills the other slot */
+static void snap_reader_isr(int sig)
+{
+    LF_Rec_t rec;
+    uint32_t retries = 0U;
+
+    (void)sig;
+    if (LF_SnapRead(&snap, &rec, 1U, &retries))
+    {
+        isrReads++;
+        isrTorn += LF_RecCheck(&rec) ? 0U : 1U;
+        isrBack += (rec.n < isrLast) ? 1U : 0U;
+        isrLast = rec.n;
+    }
+    else if (LF_SnapCount(&snap) != 0U)
+    {
+        isrFails++;
+    }
+    isrFails += retries;
+    ticks++;
+}
+
+static void test_snap_isr_reader(void)
+{
+    uint32_t n = 0U;
+
+    snap_init();
+    isrReads = isrFails = isrTorn = isrBack = isrLast = 0U;
+    timer_start(snap_reader_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        LF_RecFill(LF_SnapWriteSlot(&snap), ++n);
+        LF_SnapPublish(&snap);
+    }
+    timer_stop();
+
+    printf("snapshot, ISR reader: %u publishes, %u reads in the ISR\n", n, isrReads);
+    CHECK(isrTorn == 0U);
+    CHECK(isrBack == 0U);
+    CHECK(isrFails == 0U);
+    CHECK(isrReads > 0U);
+}
+
+/* --- Triple buffer --- */
+
+static LF_Rec_t    tripleStore[3];
+static LF_Triple_t triple;
+
+static void triple_init(void)
+{
+    const LF_Triple_t init = LF_TRIPLE_INIT(tripleStore, sizeof(LF_Rec_t));
+    memcpy(&triple, &init, sizeof(triple));
+}
+
+static void triple_writer_isr(int sig)
+{
+    (void)sig;
+    LF_RecFill(LF_TripleWriteBuf(&triple), ++isrN);
+    LF_TriplePublish(&triple);
+    ticks++;
+}
+
+static void test_triple_isr_writer(void)
+{
+    uint32_t reads = 0U, fresh = 0U, torn = 0U, stale = 0U, last = 0U;
+
+    triple_init();
+    isrN = 0U;
+    timer_start(triple_writer_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        bool isFresh;
+        const LF_Rec_t *rec = LF_TripleRead(&triple, &isFresh);
+        if (rec == NULL)
+            continue;
+        reads++;
+        torn += LF_RecCheck(rec) ? 0U : 1U;
+        stale += (isFresh ? (rec->n <= last) : (rec->n != last)) ? 1U : 0U;
+        fresh += isFresh ? 1U : 0U;
+        last = rec->n;
+    }
+    timer_stop();
+
+    printf("triple, ISR writer: %u reads, %u fresh of %u publishes\n", reads, fresh, isrN);
+    CHECK(torn == 0U);
+    CHECK(stale == 0U);
+    CHECK(fresh > (STRESS_TICKS / 2U));
+}
+
+static void triple_reader_isr(int sig)
+{
+    bool isFresh;
+
+    (void)sig;
+    const LF_Rec_t *rec = LF_TripleRead(&triple, &isFresh);
+    if (rec != NULL)
+    {
+        isrReads++;
+        isrTorn += LF_RecCheck(rec) ? 0U : 1U;
+        isrBack += (isFresh ? (rec->n <= isrLast) : (rec->n != isrLast)) ? 1U : 0U;
+        isrLast = rec->n;
+    }
+    ticks++;
+}
+
+static void test_triple_isr_reader(void)
+{
+    uint32_t n = 0U;
+
+    triple_init();
+    isrReads = isrTorn = isrBack = isrLast = 0U;
+    timer_start(triple_reader_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        LF_RecFill(LF_TripleWriteBuf(&triple), ++n);
+        LF_TriplePublish(&triple);
+    }
+    timer_stop();
+
+    printf("triple, ISR reader: %u publishes, %u reads in the ISR\n", n, isrReads);
+    CHECK(isrTorn == 0U);
+    CHECK(isrBack == 0U);
+    CHECK(isrReads > 0U);
+}
+
+/* --- Flags: the ISR raises a bit again only once the main loop took it, so every
+ *     set is taken exactly once unless an update of the flag word loses it --- */
+
+static LF_Flags_t flags;
+static uint32_t   isrSent[ISR_BITS];
+static _Atomic uint32_t isrTaken[ISR_BITS];
+
+static void flag_isr(int sig)
+{
+    const uint32_t b = (uint32_t)ticks % ISR_BITS;
+
+    (void)sig;
+    if (atomic_load_explicit(&isrTaken[b], memory_order_relaxed) == isrSent[b])
+    {
+        isrSent[b]++;
+        LF_FlagsSet(&flags, 1U << b);
+    }
+    ticks++;
+}
+
+/* The main loop sets and clears its own bit and takes the ISR's; plainRmw updates
+ * its bit with a load and a store instead of LF_FlagsSet()/LF_FlagsClear().
+ * Returns the ISR sets never taken. */
+static uint32_t flags_run(bool plainRmw)
+{
+    const uint32_t isrMask = (1U << ISR_BITS) - 1U;
+    uint32_t sent = 0U, taken = 0U;
+
+    atomic_store(&flags, 0U);
+    for (uint32_t b = 0U; b < ISR_BITS; b++)
+    {
+        isrSent[b] = 0U;
+        atomic_store(&isrTaken[b], 0U);
+    }
+
+    timer_start(flag_isr);
+    while (ticks < (sig_atomic_t)STRESS_TICKS)
+    {
+        if (plainRmw)
+        {
+            volatile uint32_t *word = (volatile uint32_t *)&flags;
+            const uint32_t v = *word;
+            *word = v ^ (1U << MAIN_BIT);
+        }
+        else if ((LF_FlagsPeek(&flags) & (1U << MAIN_BIT)) != 0U)
+        {
+            LF_FlagsClear(&flags, 1U << MAIN_BIT);
+        }
+        else
+        {
+            LF_FlagsSet(&flags, 1U << MAIN_BIT);
+        }
+
+        uint32_t got = LF_FlagsTake(&flags, isrMask);
+        while (got != 0U)
+        {
+            const uint32_t b = (uint32_t)__builtin_ctz(got);
+            got &= got - 1U;
+            taken++;
+            atomic_fetch_add_explicit(&isrTaken[b], 1U, memory_order_relaxed);
+        }
+    }
+    timer_stop();
+    taken += (uint32_t)__builtin_popcount(LF_FlagsTake(&flags, isrMask));
+
+    for (uint32_t b = 0U; b < ISR_BITS; b++)
+        sent += isrSent[b];
+    printf("flags%s: %u sets, %u taken\n", plainRmw ? ", plain load/store" : "", sent, taken);
+    CHECK(taken <= sent);
+    return sent - taken;
+}
+
+static void test_flags(void)
+{
+    CHECK(flags_run(false) == 0U);
+    CHECK_MSG(flags_run(true) > 0U, "the signal never landed inside a read-modify-write");
+}
+
+int main(void)
+{
+    test_spsc_isr_producer();
+    test_spsc_isr_consumer();
+    test_snap_isr_writer();
+    test_snap_isr_reader();
+    test_triple_isr_writer();
+    test_triple_isr_reader();
+    test_flags();
+    return TEST_DONE();
+}
@@ -0,0 +1,312 @@
+/*
+ * test_lf_threads.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Each primitive with its two sides on two threads, which on a multicore host run
+ *  truly in parallel: a stronger test of the memory orders than the single core
+ *  ever needs. Ring elements carry a sequence number and snapshot/triple payloads
+ *  are LF_Rec_t, so loss, duplication, reordering and torn copies all show.
+ *
+ *  A side that has to wait for the other yields, so the test also finishes on a
+ *  single CPU, where a spinning thread would hold it for a whole time slice.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "test_check.h"
+#include "lockfree.h"
+#include "lf_record.h"
+
+#define SPSC_CAP        64U
+#define SPSC_ITEMS      2000000U
+#define PUBLISHES       200000U
+#define SNAP_READERS    2U
+#define FLAG_SETTERS    4U
+#define FLAG_EVENTS     20000U      /* per setter */
+#define STUCK_NS        2000000000LL
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t inv;
+    uint64_t mix;
+} Item_t;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
+/* --- SPSC: producer thread, the main thread consumes --- */
+
+static LF_Spsc_t ring;
+static Item_t    ringStore[SPSC_CAP];
+static uint32_t  ringFull;
+
+static void *spsc_producer(void *arg)
+{
+    (void)arg;
+    for (uint32_t n = 0U; n < SPSC_ITEMS; )
+    {
+        /* Alternately copied in and filled in place */
+        if ((n & 1U) != 0U)
+        {
+            const Item_t it = { n, ~n, (uint64_t)n * 0x9E3779B97F4A7C15ULL };
+            if (!LF_SpscPush(&ring, &it))
+            {
+                ringFull++;
+                sched_yield();
+                continue;
+            }
+        }
+        else
+        {
+            Item_t *slot = LF_SpscWriteSlot(&ring);
+            if (slot == NULL)
+            {
+                ringFull++;
+                sched_yield();
+                continue;
+            }
+            slot->seq = n;
+            slot->inv = ~n;
+            slot->mix = (uint64_t)n * 0x9E3779B97F4A7C15ULL;
+            LF_SpscCommit(&ring);
+        }
+        n++;
+    }
+    return NULL;
+}
+
+static void test_spsc(void)
+{
+    pthread_t th;
+    uint32_t next = 0U, bad = 0U, maxCount = 0U;
+
+    LF_SpscInit(&ring, ringStore, sizeof(Item_t), SPSC_CAP);
+    CHECK(pthread_create(&th, NULL, spsc_producer, NULL) == 0);
+    while (next < SPSC_ITEMS)
+    {
+        const uint32_t count = LF_SpscCount(&ring);
+        maxCount = (count > maxCount) ? count : maxCount;
+
+        const Item_t *it = LF_SpscReadSlot(&ring);
+        if (it == NULL)
+        {
+            sched_yield();
+            continue;
+        }
+        if ((it->seq != next) || (it->inv != ~next) || (it->mix != ((uint64_t)next * 0x9E3779B97F4A7C15ULL)))
+            bad++;
+        LF_SpscRelease(&ring);
+        next++;
+    }
+    pthread_join(th, NULL);
+
+    printf("spsc: %u items, producer found the ring full %u times\n", next, ringFull);
+    CHECK(bad == 0U);
+    CHECK(maxCount <= SPSC_CAP);
+    CHECK(LF_SpscCount(&ring) == 0U);
+}
+
+/* --- Snapshot: one writer thread, readers on the main and a second thread --- */
+
+static LF_Rec_t          snapStore[2];
+static LF_Snap_t         snap = LF_SNAP_INIT(snapStore, sizeof(LF_Rec_t));
+static atomic_bool       writerDone;
+
+typedef struct
+{
+    uint32_t reads;
+    uint32_t gaveUp;
+    uint32_t retries;
+    uint32_t torn;
+    uint32_t back;
+} SnapReader_t;
+
+static void *snap_writer(void *arg)
+{
+    (void)arg;
+    for (uint32_t n = 1U; n <= PUBLISHES; n++)
+    {
+        LF_RecFill(LF_SnapWriteSlot(&snap), n);
+        LF_SnapPublish(&snap);
+    }
+    atomic_store(&writerDone, true);
+    return NULL;
+}
+
+static void *snap_reader(void *arg)
+{
+    SnapReader_t *r = arg;
+    uint32_t last = 0U;
+    LF_Rec_t rec;
+
+    while (!atomic_load(&writerDone))
+    {
+        if (!LF_SnapRead(&snap, &rec, 4U, &r->retries))
+        {
+            r->gaveUp += (LF_SnapCount(&snap) != 0U) ? 1U : 0U;
+            continue;
+        }
+        r->reads++;
+        r->torn += LF_RecCheck(&rec) ? 0U : 1U;
+        r->back += (rec.n < last) ? 1U : 0U;
+        last = rec.n;
+    }
+    return NULL;
+}
+
+static void test_snap(void)
+{
+    pthread_t writer, reader;
+    SnapReader_t r[SNAP_READERS] = { 0 };
+    LF_Rec_t last;
+
+    atomic_store(&writerDone, false);
+    CHECK(pthread_create(&reader, NULL, snap_reader, &r[1]) == 0);
+    CHECK(pthread_create(&writer, NULL, snap_writer, NULL) == 0);
+    snap_reader(&r[0]);
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+
+    for (uint32_t k = 0U; k < SNAP_READERS; k++)
+    {
+        printf("snapshot reader %u: %u reads, %u retries, %u gave up\n", k, r[k].reads, r[k].retries, r[k].gaveUp);
+        CHECK(r[k].torn == 0U);
+        CHECK(r[k].back == 0U);
+    }
+    CHECK(LF_SnapRead(&snap, &last, 1U, NULL) && (last.n == PUBLISHES) && LF_RecCheck(&last));
+}
+
+/* --- Triple buffer: writer thread, the main thread reads --- */
+
+static LF_Rec_t          tripleStore[3];
+static LF_Triple_t       triple = LF_TRIPLE_INIT(tripleStore, sizeof(LF_Rec_t));
+
+static void *triple_writer(void *arg)
+{
+    (void)arg;
+    for (uint32_t n = 1U; n <= PUBLISHES; n++)
+    {
+        LF_RecFill(LF_TripleWriteBuf(&triple), n);
+        LF_TriplePublish(&triple);
+    }
+    atomic_store(&writerDone, true);
+    return NULL;
+}
+
+static void test_triple(void)
+{
+    pthread_t th;
+    uint32_t reads = 0U, fresh = 0U, torn = 0U, stale = 0U, last = 0U;
+    bool done = false;
+
+    atomic_store(&writerDone, false);
+    CHECK(pthread_create(&th, NULL, triple_writer, NULL) == 0);
+    while (!done)
+    {
+        done = atomic_load(&writerDone);        // one more read after the last publish
+
+        bool isFresh;
+        const LF_Rec_t *rec = LF_TripleRead(&triple, &isFresh);
+        if (rec == NULL)
+            continue;
+        reads++;
+        torn += LF_RecCheck(rec) ? 0U : 1U;
+        /* fresh: a newer publish; not fresh: the same buffer as before */
+        stale += (isFresh ? (rec->n <= last) : (rec->n != last)) ? 1U : 0U;
+        fresh += isFresh ? 1U : 0U;
+        last = rec->n;
+    }
+    pthread_join(th, NULL);
+
+    printf("triple: %u reads, %u fresh\n", reads, fresh);
+    CHECK(torn == 0U);
+    CHECK(stale == 0U);
+    CHECK(last == PUBLISHES);
+}
+
+/* --- Flags: setter threads, the main thread takes. A setter raises a bit again only
+ *     once its previous set was taken, so every set must be taken exactly once. --- */
+
+static LF_Flags_t        flags;
+static _Atomic uint32_t  takenBit[32];
+static uint32_t          stuck[FLAG_SETTERS];
+
+static void *flag_setter(void *arg)
+{
+    const uint32_t t = (uint32_t)(uintptr_t)arg;
+    uint32_t sent[8] = { 0U };
+
+    for (uint32_t k = 0U; k < FLAG_EVENTS; k++)
+    {
+        const uint32_t b = k % 8U, bit = (t * 8U) + b;
+        const int64_t t0 = now_ns();
+
+        while (atomic_load_explicit(&takenBit[bit], memory_order_acquire) != sent[b])
+        {
+            if ((now_ns() - t0) > STUCK_NS)
+            {
+                stuck[t]++;         // a set was lost
+                return NULL;
+            }
+            sched_yield();
+        }
+        sent[b]++;
+        LF_FlagsSet(&flags, 1U << bit);
+    }
+    return NULL;
+}
+
+static void test_flags(void)
+{
+    pthread_t th[FLAG_SETTERS];
+    uint32_t taken = 0U, stuckSetters = 0U;
+
+    atomic_store(&flags, 0U);
+    for (uint32_t t = 0U; t < FLAG_SETTERS; t++)
+    {
+        CHECK(pthread_create(&th[t], NULL, flag_setter, (void *)(uintptr_t)t) == 0);
+    }
+
+    const int64_t t0 = now_ns();
+    while ((taken < (FLAG_SETTERS * FLAG_EVENTS)) && ((now_ns() - t0) < (2 * STUCK_NS)))
+    {
+        uint32_t got = LF_FlagsTake(&flags, UINT32_MAX);
+        if (got == 0U)
+            sched_yield();
+        while (got != 0U)
+        {
+            const uint32_t bit = (uint32_t)__builtin_ctz(got);
+            got &= got - 1U;
+            taken++;
+            atomic_fetch_add_explicit(&takenBit[bit], 1U, memory_order_release);
+        }
+    }
+    for (uint32_t t = 0U; t < FLAG_SETTERS; t++)
+    {
+        pthread_join(th[t], NULL);
+        stuckSetters += stuck[t];
+    }
+
+    printf("flags: %u sets taken\n", taken);
+    CHECK(stuckSetters == 0U);
+    CHECK(taken == (FLAG_SETTERS * FLAG_EVENTS));
+    CHECK(LF_FlagsPeek(&flags) == 0U);
+}
+
+int main(void)
+{
+    test_spsc();
+    test_snap();
+    test_triple();
+    test_flags();
+    return TEST_DONE();
+}
@@ -0,0 +1,263 @@
+/*
+ * lockfree.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Lock-free ISR <-> main loop data exchange, shared by the STM32 projects.
+ *
+ *      LF_Spsc_t   : single producer / single consumer ring of fixed size slots,
+ *                    filled and drained in place (no copy needed)
+ *      LF_Snap_t   : latest value, double buffered seqlock. Readers never block the
+ *                    writer and may run in any context, including an ISR that
+ *                    preempted the writer; a reader retries only if the writer
+ *                    started two updates during its copy.
+ *      LF_Triple_t : latest value, triple buffer. One writer and one reader that
+ *                    never wait and never retry (deterministic time on both sides).
+ *      LF_Flags_t  : 32 event bits, set from any context, taken atomically.
+ *
+ *  Built on C11 <stdatomic.h>: on ARMv7-M (Cortex-M3/M4/M7) the read-modify-write
+ *  operations become LDREX/STREX loops and acquire/release become DMB, so an
+ *  interrupt between the load and the store simply makes the STREX fail and retry.
+ *  No interrupt masking anywhere. ARMv6-M (Cortex-M0) has no LDREX/STREX and is not
+ *  supported. The same header compiles on a host, where the ISR side is a thread
+ *  or a signal handler: host/ builds the stress tests (host/CMakeLists.txt).
+ *
+ *  "Producer" / "consumer" / "writer" / "reader" are execution contexts: two ISRs
+ *  at the same NVIC priority (they never preempt each other) count as one context.
+ *
+ *  Header only: include path <repo>/Common/lockfree, nothing to link.
+ */
+
+#ifndef COMMON_LOCKFREE_H_
+#define COMMON_LOCKFREE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+/* ---------------------------------------------------------------------------
+ * SPSC ring: capacity a power of 2, head/tail are free running counts
+ * ------------------------------------------------------------------------- */
+
+typedef struct
+{
+    _Atomic uint32_t head;          /* slots committed, written by the producer  */
+    _Atomic uint32_t tail;          /* slots released, written by the consumer   */
+    uint8_t         *buf;           /* capacity * elemSize bytes                 */
+    uint32_t         elemSize;
+    uint32_t         mask;          /* capacity - 1                              */
+} LF_Spsc_t;
+
+#define LF_SPSC_INIT(storage, elemSize, capacity) \
+    { 0u, 0u, (uint8_t *)(storage), (uint32_t)(elemSize), (uint32_t)(capacity) - 1u }
+
+static inline void LF_SpscInit(LF_Spsc_t *q, void *storage, uint32_t elemSize, uint32_t capacity)
+{
+    q->buf      = (uint8_t *)storage;
+    q->elemSize = elemSize;
+    q->mask     = capacity - 1u;
+    atomic_store_explicit(&q->head, 0u, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, 0u, memory_order_relaxed);
+}
+
+/* Producer: free slot to fill, NULL when full; LF_SpscCommit() hands it over */
+static inline void *LF_SpscWriteSlot(LF_Spsc_t *q)
+{
+    const uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    const uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    if ((head - tail) > q->mask)
+        return NULL;
+    return &q->buf[(head & q->mask) * q->elemSize];
+}
+
+static inline void LF_SpscCommit(LF_Spsc_t *q)
+{
+    const uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    atomic_store_explicit(&q->head, head + 1u, memory_order_release);
+}
+
+/* Consumer: oldest slot, NULL when empty; it stays the consumer's until LF_SpscRelease() */
+static inline void *LF_SpscReadSlot(LF_Spsc_t *q)
+{
+    const uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    const uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+    if (head == tail)
+        return NULL;
+    return &q->buf[(tail & q->mask) * q->elemSize];
+}
+
+static inline void LF_SpscRelease(LF_Spsc_t *q)
+{
+    const uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    atomic_store_explicit(&q->tail, tail + 1u, memory_order_release);
+}
+
+static inline bool LF_SpscPush(LF_Spsc_t *q, const void *elem)
+{
+    void *slot = LF_SpscWriteSlot(q);
+    if (slot == NULL)
+        return false;
+    memcpy(slot, elem, q->elemSize);
+    LF_SpscCommit(q);
+    return true;
+}
+
+static inline bool LF_SpscPop(LF_Spsc_t *q, void *elem)
+{
+    const void *slot = LF_SpscReadSlot(q);
+    if (slot == NULL)
+        return false;
+    memcpy(elem, slot, q->elemSize);
+    LF_SpscRelease(q);
+    return true;
+}
+
+/* Any context; exact for the producer and the consumer, a snapshot for others */
+static inline uint32_t LF_SpscCount(LF_Spsc_t *q)
+{
+    const uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    return atomic_load_explicit(&q->head, memory_order_acquire) - tail;
+}
+
+/* ---------------------------------------------------------------------------
+ * Snapshot: slot (seq & 1) holds publish number seq, the writer fills the other.
+ * begin is the number of the update in progress, so a reader can tell whether
+ * its slot was touched during the copy, even by a writer running on another core.
+ * ------------------------------------------------------------------------- */
+
+typedef struct
+{
+    _Atomic uint32_t seq;           /* publishes, 0 = nothing yet                */
+    _Atomic uint32_t begin;         /* updates started                           */
+    uint8_t         *slots;         /* 2 * size bytes                            */
+    uint32_t         size;
+} LF_Snap_t;
+
+#define LF_SNAP_INIT(storage, size)     { 0u, 0u, (uint8_t *)(storage), (uint32_t)(size) }
+
+/* Writer: slot of the next publish */
+static inline void *LF_SnapWriteSlot(LF_Snap_t *s)
+{
+    const uint32_t next = atomic_load_explicit(&s->seq, memory_order_relaxed) + 1u;
+
+    atomic_store_explicit(&s->begin, next, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);      /* begin before the slot stores */
+    return &s->slots[(next & 1u) * s->size];
+}
+
+/* Writer: make the slot from LF_SnapWriteSlot() current, returns its publish number */
+static inline uint32_t LF_SnapPublish(LF_Snap_t *s)
+{
+    const uint32_t next = atomic_load_explicit(&s->seq, memory_order_relaxed) + 1u;
+    atomic_store_explicit(&s->seq, next, memory_order_release);
+    return next;
+}
+
+static inline uint32_t LF_SnapCount(LF_Snap_t *s)
+{
+    return atomic_load_explicit(&s->seq, memory_order_acquire);
+}
+
+/* Any context: copy of the latest publish. False if there is none yet or the writer
+ * kept reusing the slot for all attempts; *retries (optional) counts the repeats. */
+static inline bool LF_SnapRead(LF_Snap_t *s, void *dst, uint32_t attempts, uint32_t *retries)
+{
+    for (uint32_t a = 0u; a < attempts; a++)
+    {
+        const uint32_t seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        if (seq == 0u)
+            return false;
+
+        memcpy(dst, &s->slots[(seq & 1u) * s->size], s->size);
+        atomic_thread_fence(memory_order_acquire);   /* copy before the check */
+
+        /* update seq + 1 goes to the other slot, seq + 2 is the first to reuse ours */
+        if ((atomic_load_explicit(&s->begin, memory_order_relaxed) - seq) < 2u)
+            return true;
+        if (retries != NULL)
+            (*retries)++;
+    }
+    return false;
+}
+
+/* ---------------------------------------------------------------------------
+ * Triple buffer: the writer owns one buffer, the reader one, the third is the
+ * latest complete value. Publishing and taking are one atomic exchange each.
+ * ------------------------------------------------------------------------- */
+
+#define LF_TRIPLE_FRESH     4u      /* middle holds a value the reader has not taken */
+
+typedef struct
+{
+    _Atomic uint32_t middle;        /* buffer index | LF_TRIPLE_FRESH            */
+    uint32_t         writeIdx;      /* writer only                               */
+    uint32_t         readIdx;       /* reader only                               */
+    bool             readValid;     /* reader only: readIdx holds a value        */
+    uint8_t         *bufs;          /* 3 * size bytes                            */
+    uint32_t         size;
+} LF_Triple_t;
+
+#define LF_TRIPLE_INIT(storage, size)   { 1u, 0u, 2u, false, (uint8_t *)(storage), (uint32_t)(size) }
+
+static inline void *LF_TripleWriteBuf(LF_Triple_t *t)
+{
+    return &t->bufs[t->writeIdx * t->size];
+}
+
+/* Writer: the filled buffer becomes the latest, a new one is handed back */
+static inline void LF_TriplePublish(LF_Triple_t *t)
+{
+    const uint32_t old = atomic_exchange_explicit(&t->middle, t->writeIdx | LF_TRIPLE_FRESH, memory_order_acq_rel);
+    t->writeIdx = old & 3u;
+}
+
+/* Reader: latest value (NULL before the first publish), valid until the next call.
+ * *fresh (optional) tells whether it was published since the previous call. */
+static inline const void *LF_TripleRead(LF_Triple_t *t, bool *fresh)
+{
+    const bool isFresh = (atomic_load_explicit(&t->middle, memory_order_relaxed) & LF_TRIPLE_FRESH) != 0u;
+
+    if (isFresh)
+    {
+        const uint32_t old = atomic_exchange_explicit(&t->middle, t->readIdx, memory_order_acq_rel);
+        t->readIdx   = old & 3u;
+        t->readValid = true;
+    }
+    if (fresh != NULL)
+        *fresh = isFresh;
+    return t->readValid ? &t->bufs[t->readIdx * t->size] : NULL;
+}
+
+/* ---------------------------------------------------------------------------
+ * Flag set
+ * ------------------------------------------------------------------------- */
+
+typedef _Atomic uint32_t LF_Flags_t;
+
+static inline void LF_FlagsSet(LF_Flags_t *f, uint32_t mask)
+{
+    (void)atomic_fetch_or_explicit(f, mask, memory_order_release);
+}
+
+static inline void LF_FlagsClear(LF_Flags_t *f, uint32_t mask)
+{
+    (void)atomic_fetch_and_explicit(f, ~mask, memory_order_relaxed);
+}
+
+/* Clears and returns the bits of mask that were set: each set is taken once */
+static inline uint32_t LF_FlagsTake(LF_Flags_t *f, uint32_t mask)
+{
+    return atomic_fetch_and_explicit(f, ~mask, memory_order_acquire) & mask;
+}
+
+static inline uint32_t LF_FlagsPeek(LF_Flags_t *f)
+{
+    return atomic_load_explicit(f, memory_order_acquire);
+}
+
+#endif /* COMMON_LOCKFREE_H_ */
@@ -0,0 +1,176 @@
+#include "retarget.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define RETARGET_TX_MASK    (RETARGET_TX_BUF_SIZE - 1u)
+
+#if (RETARGET_TX_BUF_SIZE & RETARGET_TX_MASK) != 0
+#error "RETARGET_TX_BUF_SIZE must be a power of 2"
+#endif
+
+static USART_TypeDef *g_uart = NULL;
+
+/* Free running indices: head written by producers only, tail by the drain only */
+static uint8_t           s_txBuf[RETARGET_TX_BUF_SIZE];
+static volatile uint32_t s_head;
+static volatile uint32_t s_tail;
+
+static char              s_lineBuf[RETARGET_LINE_BUF_SIZE];
+static RetargetStats_t   s_stats;
+
+/* Move bytes from the ring into the TX FIFO until one of them is full/empty.
+ * Single consumer: runs in the UART interrupt or with interrupts masked. */
+static void Retarget_Drain(void)
+{
+    uint32_t tail = s_tail;
+    const uint32_t head = s_head;
+
+    while ((tail != head) && ((g_uart->ISR & USART_ISR_TXE_TXFNF) != 0u))
+    {
+        g_uart->TDR = s_txBuf[tail & RETARGET_TX_MASK];
+        tail++;
+    }
+    s_tail = tail;
+
+    if (tail == head)
+    {
+        CLEAR_BIT(g_uart->CR3, USART_CR3_TXFTIE);
+        /* A producer preempting the read-modify-write may have lost its TXFTIE set, re-check */
+        if (s_head != tail)
+        {
+            SET_BIT(g_uart->CR3, USART_CR3_TXFTIE);
+        }
+    }
+}
+
+static IRQn_Type Retarget_IRQn(const USART_TypeDef *uart)
+{
+    if (uart == USART1)  return USART1_IRQn;
+    if (uart == USART2)  return USART2_IRQn;
+    if (uart == LPUART1) return LPUART1_IRQn;
+    return USART3_IRQn;
+}
+
+void RetargetInit(UART_HandleTypeDef *huart)
+{
+    s_head = 0u;
+    s_tail = 0u;
+    memset(&s_stats, 0, sizeof(s_stats));
+
+    /* Refill when the 8 byte TX FIFO is down to 1/8, i.e. 7 bytes per interrupt */
+    HAL_UARTEx_SetTxFifoThreshold(huart, UART_TXFIFO_THRESHOLD_1_8);
+    HAL_UARTEx_EnableFifoMode(huart);
+    g_uart = huart->Instance;
+
+    HAL_NVIC_SetPriority(Retarget_IRQn(g_uart), RETARGET_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(Retarget_IRQn(g_uart));
+
+    /* _write() is cheap now, let newlib hand over whole lines */
+    setvbuf(stdout, s_lineBuf, _IOLBF, sizeof(s_lineBuf));
+}
+
+bool RetargetWrite(const void *data, uint32_t len)
+{
+    if ((g_uart == NULL) || (len == 0u))
+        return false;
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint32_t head = s_head;
+    const uint32_t used = head - s_tail;
+
+    if (len > (RETARGET_TX_BUF_SIZE - used))
+    {
+        s_stats.droppedBytes_u32 += len;
+        s_stats.droppedWrites_u32++;
+        __set_PRIMASK(primask);
+        return false;
+    }
+
+    /* Bulk copy, at most two segments around the wrap */
+    const uint32_t idx   = head & RETARGET_TX_MASK;
+    const uint32_t first = (len < (RETARGET_TX_BUF_SIZE - idx)) ? len : (RETARGET_TX_BUF_SIZE - idx);
+    memcpy(&s_txBuf[idx], data, first);
+    memcpy(s_txBuf, (const uint8_t *)data + first, len - first);
+
+    /* Data visible before the new head */
+    __DMB();
+    s_head = head + len;
+
+    s_stats.writtenBytes_u32 += len;
+    if ((used + len) > s_stats.highWater_u32)
+        s_stats.highWater_u32 = used + len;
+
+    /* TXFT is set while the FIFO is at/below threshold, enabling it starts the drain */
+    SET_BIT(g_uart->CR3, USART_CR3_TXFTIE);
+
+    __set_PRIMASK(primask);
+    return true;
+}
+
+int RetargetPrintf(const char *fmt, ...)
+{
+    char buf[RETARGET_PRINTF_MAX];
+    va_list args;
+
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (n < 0)
+        return n;
+    if ((uint32_t)n >= sizeof(buf))
+        n = (int)sizeof(buf) - 1;   /* truncated */
+
+    return RetargetWrite(buf, (uint32_t)n) ? n : 0;
+}
+
+bool RetargetFlush(uint32_t timeout_ms)
+{
+    if (g_uart == NULL)
+        return true;
+
+    const uint32_t start = HAL_GetTick();
+    while (((s_head != s_tail) || ((g_uart->ISR & USART_ISR_TC) == 0u)))
+    {
+        /* Drain here as well, interrupts may be masked by the caller */
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        Retarget_Drain();
+        __set_PRIMASK(primask);
+
+        if ((HAL_GetTick() - start) > timeout_ms)
+            return false;
+    }
+    return true;
+}
+
+void RetargetIRQHandler(void)
+{
+    if ((g_uart != NULL) && ((g_uart->CR3 & USART_CR3_TXFTIE) != 0u))
+    {
+        Retarget_Drain();
+    }
+}
+
+const RetargetStats_t *RetargetGetStats(void)
+{
+    return &s_stats;
+}
+
+/* newlib: stdout/stderr flushes, one call per line */
+int _write(int file, char *ptr, int len)
+{
+    (void)file;
+    (void)RetargetWrite(ptr, (uint32_t)len);
+    /* Report dropped data as written, an error would latch stdout in newlib */
+    return len;
+}
+
+int __io_putchar(int ch)
+{
+    const uint8_t c = (uint8_t)ch;
+    return RetargetWrite(&c, 1u) ? ch : -1;
+}
@@ -0,0 +1,60 @@
+/*
+ * retarget.h
+ *
+ *  printf redirection to a UART without blocking the caller. Shared by the
+ *  B-G474E-DPOW1 projects (HRTIM_Buck_Boost, UART_Printf) on the STM32G4 HAL.
+ *
+ *  Output goes into a RAM ring (RETARGET_TX_BUF_SIZE bytes) and is drained by the
+ *  UART TX FIFO threshold interrupt, so a printf costs the formatting plus one
+ *  memcpy. The interrupt handler is the only consumer and never locks. Producers
+ *  (main loop and interrupts) are serialised by a critical section around the
+ *  copy into the ring, which makes RetargetWrite()/RetargetPrintf() safe from any
+ *  interrupt priority.
+ *
+ *  stdout is line buffered, newlib hands over one line per _write() call. printf
+ *  itself shares the stdout buffer and must stay in thread mode; interrupts use
+ *  RetargetPrintf(), which formats into a stack buffer (no %f there, newlib
+ *  allocates for float conversion).
+ *
+ *  Drop policy: a write that does not fit in the free space is dropped as a whole
+ *  (no truncated lines) and counted in RetargetStats_t.
+ */
+
+#ifndef RETARGET_H
+#define RETARGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stm32g4xx_hal.h"
+
+#define RETARGET_TX_BUF_SIZE    2048u   /* power of 2 */
+#define RETARGET_LINE_BUF_SIZE  128u    /* stdout line buffer */
+#define RETARGET_PRINTF_MAX     96u     /* RetargetPrintf() stack buffer */
+#define RETARGET_IRQ_PRIORITY   3u      /* below the control, ADC and DMA interrupts */
+
+typedef struct
+{
+    uint32_t writtenBytes_u32;
+    uint32_t droppedBytes_u32;
+    uint32_t droppedWrites_u32;
+    uint32_t highWater_u32;     /* max ring fill level seen by a producer */
+} RetargetStats_t;
+
+/* Initialize printf redirection to the given UART */
+void RetargetInit(UART_HandleTypeDef *huart);
+
+/* Queue len bytes; returns false if they were dropped. Interrupt safe. */
+bool RetargetWrite(const void *data, uint32_t len);
+
+/* printf into the ring without touching stdout. Interrupt safe. */
+int  RetargetPrintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+/* Busy-wait until the ring and the UART are empty; the timeout needs SysTick */
+bool RetargetFlush(uint32_t timeout_ms);
+
+/* Call from the UART interrupt handler */
+void RetargetIRQHandler(void);
+
+const RetargetStats_t *RetargetGetStats(void);
+
+#endif /* RETARGET_H */
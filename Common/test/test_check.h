@@ -0,0 +1,42 @@
+/*
+ * test_check.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: HEIR
+ *
+ *  Minimal checks for the host tests of every project (each host CMakeLists puts
+ *  this directory on the tests' include path): a failed CHECK prints the location
+ *  and is counted, TEST_DONE() returns the exit code for ctest.
+ */
+
+#ifndef COMMON_TEST_TEST_CHECK_H_
+#define COMMON_TEST_TEST_CHECK_H_
+
+#include <stdio.h>
+
+static int testFailures;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);         \
+            testFailures++;                                                         \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_MSG(cond, ...)                                                        \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            printf("%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #cond);         \
+            printf(__VA_ARGS__);                                                    \
+            printf("\n");                                                           \
+            testFailures++;                                                         \
+        }                                                                           \
+    } while (0)
+
+#define TEST_DONE()                                                                 \
+    (printf("%s: %s (%d failed checks)\n", __FILE__,                                \
+            (testFailures == 0) ? "PASS" : "FAIL", testFailures),                   \
+     (testFailures == 0) ? 0 : 1)
+
+#endif /* COMMON_TEST_TEST_CHECK_H_ */
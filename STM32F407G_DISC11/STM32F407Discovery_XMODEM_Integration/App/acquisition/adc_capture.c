@@ -0,0 +1,203 @@
+/*
+ * adc_capture.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Ping-pong block bookkeeping of the ADC capture (hardware independent).
+ *
+ *      The ISR publishes a finished block as one 32-bit tag (sequence, valid flag,
+ *      half) and the consumer takes it with a compare-exchange, so neither side
+ *      needs to disable interrupts.
+ *
+ *      The consumer announces the half it is about to take (inUseHalf) before it takes
+ *      the tag. An ISR that runs in between sees the announced half; it also replaces
+ *      the tag, so the compare-exchange fails and the consumer retries with the new
+ *      block. Once taken, the held block is torn as soon as the DMA enters its half,
+ *      i.e. when the other half completes.
+ */
+
+#include <stddef.h>
+
+#include "adc_capture.h"
+#include "board_config.h"
+#include "mem_placement.h"
+
+#define TAG_VALID           (1UL << 1U)
+#define TAG_HALF_MASK       (1UL)
+#define TAG_SEQ_SHIFT       2U
+#define HALF_NONE           0xFFU
+
+/* Circular DMA buffer, two halves of blockLen samples. Must be DMA-reachable SRAM. */
+static uint16_t adcCaptureBuf[2U * ADC_CAPTURE_MAX_BLOCK_LEN] MEM_DMA_BSS;
+
+static const AdcCaptureHw_t *pCaptureHw = NULL;
+static AdcCaptureStats_t captureStats;
+
+static volatile uint32_t pendingTag_u32 = 0U;     /* last finished, not yet taken block */
+static volatile uint8_t  inUseHalf      = HALF_NONE;
+static volatile bool     heldTorn       = false;  /* DMA entered the held half */
+static volatile uint32_t seq_u32        = 0U;
+static volatile bool     running        = false;
+
+/**
+ * @brief  Select the hardware implementation and check the DMA buffer placement.
+ */
+void adc_capture_init(const AdcCaptureHw_t *pHw)
+{
+    pCaptureHw = pHw;
+    mem_assert_dma_buffer(adcCaptureBuf, sizeof(adcCaptureBuf), "adcCaptureBuf");
+}
+
+/**
+ * @brief  Start continuous capture with blocks of blockLen samples at rate_u32 Hz.
+ * @return false if the parameters are out of range or the hardware refused to start.
+ */
+bool adc_capture_start(uint32_t blockLen_u32, uint32_t rate_u32)
+{
+    if ((pCaptureHw == NULL) || (blockLen_u32 == 0U) || (blockLen_u32 > ADC_CAPTURE_MAX_BLOCK_LEN)) {
+        return false;
+    }
+    if (running) {
+        adc_capture_stop();
+    }
+
+    if (rate_u32 < ADC_CAPTURE_MIN_RATE) {
+        rate_u32 = ADC_CAPTURE_MIN_RATE;
+    } else if (rate_u32 > ADC_CAPTURE_MAX_RATE) {
+        rate_u32 = ADC_CAPTURE_MAX_RATE;
+    }
+
+    captureStats = (AdcCaptureStats_t){ 0 };
+    captureStats.blockLen_u32 = blockLen_u32;
+    pendingTag_u32 = 0U;
+    inUseHalf      = HALF_NONE;
+    heldTorn       = false;
+    seq_u32        = 0U;
+
+    running = pCaptureHw->start(adcCaptureBuf, 2U * blockLen_u32, rate_u32, &captureStats.actualRate_u32);
+    return running;
+}
+
+void adc_capture_stop(void)
+{
+    if ((pCaptureHw != NULL) && running) {
+        pCaptureHw->stop();
+    }
+    running = false;
+}
+
+bool adc_capture_is_running(void)
+{
+    return running;
+}
+
+/**
+ * @brief  Producer side: half (0/1) of the circular buffer has been filled.
+ *
+ * The DMA continues in the other half, so a block the consumer holds there is
+ * being overwritten from now on.
+ */
+void adc_capture_block_done(uint8_t half)
+{
+    half &= 1U;
+    const uint32_t seq = ++seq_u32;
+
+    captureStats.blocks_u32++;
+
+    const uint32_t newTag = (seq << TAG_SEQ_SHIFT) | TAG_VALID | half;
+    const uint32_t oldTag = __atomic_exchange_n(&pendingTag_u32, newTag, __ATOMIC_SEQ_CST);
+    const bool     oldPending = ((oldTag & TAG_VALID) != 0U);
+    if (oldPending) {
+        captureStats.dropped_u32++;     // previous block was never picked up
+    }
+
+    // Announced but still pending means not taken: the consumer's compare-exchange fails
+    const uint8_t held = __atomic_load_n(&inUseHalf, __ATOMIC_SEQ_CST);
+    if ((held == (half ^ 1U)) && !(oldPending && ((oldTag & TAG_HALF_MASK) == held)) && !heldTorn) {
+        __atomic_store_n(&heldTorn, true, __ATOMIC_SEQ_CST);
+        captureStats.overrun_u32++;     // counted once per held block
+    }
+}
+
+/**
+ * @brief  Consumer side: take the latest finished block (non-blocking).
+ *
+ * @param[out] ppBlock   Pointer to the blockLen samples of the block.
+ * @param[out] pSeq_u32  Sequence number of the block (1, 2, ...), optional.
+ * @return true if a block was available. Release it with adc_capture_release_block().
+ */
+bool adc_capture_get_block(const uint16_t **ppBlock, uint32_t *pSeq_u32)
+{
+    uint32_t tag = __atomic_load_n(&pendingTag_u32, __ATOMIC_SEQ_CST);
+    do {
+        if ((tag & TAG_VALID) == 0U) {
+            return false;               // only possible on the first pass, the ISR never clears the tag
+        }
+        __atomic_store_n(&heldTorn, false, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&inUseHalf, (uint8_t)(tag & TAG_HALF_MASK), __ATOMIC_SEQ_CST);
+    } while (!__atomic_compare_exchange_n(&pendingTag_u32, &tag, 0U, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+
+    const uint8_t half = (uint8_t)(tag & TAG_HALF_MASK);
+    *ppBlock = &adcCaptureBuf[half * captureStats.blockLen_u32];
+    if (pSeq_u32 != NULL) {
+        *pSeq_u32 = tag >> TAG_SEQ_SHIFT;
+    }
+    return true;
+}
+
+/**
+ * @brief  Blocking variant of adc_capture_get_block() with timeout.
+ */
+bool adc_capture_wait_block(const uint16_t **ppBlock, uint32_t *pSeq_u32, uint32_t timeout_ms)
+{
+    const uint32_t start_ms = platform_get_time_ms();
+    while (!adc_capture_get_block(ppBlock, pSeq_u32)) {
+        if (!running || ((platform_get_time_ms() - start_ms) > timeout_ms)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Consumer side: done with the block of adc_capture_get_block().
+ * @return true if the DMA did not enter the block while it was held, i.e. everything
+ *         read from it before this call belongs to that block.
+ */
+bool adc_capture_release_block(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);    // the block reads happen before the check
+    __atomic_store_n(&inUseHalf, HALF_NONE, __ATOMIC_SEQ_CST);
+    return !__atomic_load_n(&heldTorn, __ATOMIC_SEQ_CST);
+}
+
+const AdcCaptureStats_t *adc_capture_get_stats(void)
+{
+    return &captureStats;
+}
+
+bool adc_capture_single_block_mV(float32_t *pOut_mV, uint32_t numSamples, uint32_t rate_u32,
+                                 uint16_t vRef_mV, uint16_t adcMax_u16)
+{
+    const uint16_t *pBlock;
+
+    if (!adc_capture_start(numSamples, rate_u32)) {
+        return false;
+    }
+
+    // One block takes numSamples / rate; allow twice that plus margin
+    const uint32_t timeout_ms = (uint32_t)((2ULL * numSamples * 1000ULL) / captureStats.actualRate_u32) + 100U;
+    bool ok = adc_capture_wait_block(&pBlock, NULL, timeout_ms);
+    if (ok) {
+        const float32_t mVPerCode = (float32_t)vRef_mV / (float32_t)adcMax_u16;
+        for (uint32_t i = 0U; i < numSamples; ++i) {
+            pOut_mV[i] = (float32_t)pBlock[i] * mVPerCode;
+        }
+        ok = adc_capture_release_block();
+    }
+
+    adc_capture_stop();
+    return ok;
+}
@@ -0,0 +1,94 @@
+/*
+ * adc_capture.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Timer-triggered ADC capture into a circular DMA buffer split in two halves
+ *      (ping-pong). Each half is one block of blockLen samples.
+ *
+ *      Producer side (DMA half/complete ISR, or a fake feeding recorded blocks):
+ *          adc_capture_block_done(half)
+ *      Consumer side (main loop):
+ *          adc_capture_get_block() -> process -> adc_capture_release_block()
+ *
+ *      Dropped-block detection:
+ *          - dropped : a finished block was replaced by the next one before the
+ *                      consumer picked it up (consumer too slow).
+ *          - overrun : the DMA entered the half the consumer still holds (the other
+ *                      half completed), i.e. the held block is being overwritten.
+ *                      adc_capture_release_block() tells the consumer per block.
+ *      Every block carries a sequence number, gaps are visible to the consumer too.
+ *
+ *      The hardware is reached only through AdcCaptureHw_t, so another implementation
+ *      (e.g. a host fake replaying recorded data) can be plugged in with adc_capture_init().
+ */
+
+#ifndef ACQUISITION_ADC_CAPTURE_H_
+#define ACQUISITION_ADC_CAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arm_math_include.h"
+
+#define ADC_CAPTURE_MAX_BLOCK_LEN   4096U       /* samples per half, DMA buffer = 2 blocks */
+#define ADC_CAPTURE_MIN_RATE        1000UL      /* [Hz] */
+#define ADC_CAPTURE_MAX_RATE        1400000UL   /* [Hz] 12-bit, 3-cycle sampling at 21 MHz ADCCLK */
+
+/** @brief Hardware interface of the capture subsystem */
+typedef struct {
+    /**
+     * Start continuous timer-triggered conversions into pBuf (circular, totalLen samples),
+     * raising adc_capture_block_done() at half and full buffer.
+     * Returns the sample rate actually achieved in *pActualRate_u32.
+     */
+    bool (*start)(uint16_t *pBuf, uint32_t totalLen_u32, uint32_t rate_u32, uint32_t *pActualRate_u32);
+    /** Stop timer, ADC and DMA. */
+    void (*stop)(void);
+} AdcCaptureHw_t;
+
+/** @brief Capture statistics since the last adc_capture_start() */
+typedef struct {
+    uint32_t blocks_u32;        /**< blocks completed by the producer */
+    uint32_t dropped_u32;       /**< blocks lost because they were never picked up */
+    uint32_t overrun_u32;       /**< held blocks the DMA started to overwrite */
+    uint32_t actualRate_u32;    /**< sample rate programmed in hardware [Hz] */
+    uint32_t blockLen_u32;      /**< samples per block */
+} AdcCaptureStats_t;
+
+/** @brief STM32F407 implementation: TIM2 TRGO -> ADC1 IN1 (PA1) -> DMA2 Stream0 */
+extern const AdcCaptureHw_t adcCaptureHwF407;
+
+/* DMA2 Stream0 interrupt body of the F407 implementation */
+void adc_capture_f407_dma_irq(void);
+
+void adc_capture_init(const AdcCaptureHw_t *pHw);
+bool adc_capture_start(uint32_t blockLen_u32, uint32_t rate_u32);
+void adc_capture_stop(void);
+bool adc_capture_is_running(void);
+
+/* Producer entry, called from the DMA ISR (half = 0: first half, 1: second half) */
+void adc_capture_block_done(uint8_t half);
+
+bool adc_capture_get_block(const uint16_t **ppBlock, uint32_t *pSeq_u32);
+bool adc_capture_wait_block(const uint16_t **ppBlock, uint32_t *pSeq_u32, uint32_t timeout_ms);
+bool adc_capture_release_block(void);
+
+const AdcCaptureStats_t *adc_capture_get_stats(void);
+
+/**
+ * @brief  Capture one block and convert it to millivolts (same unit as SignalGen_GenerateComposite()).
+ *
+ * @param[out] pOut_mV      Output buffer, numSamples entries.
+ * @param[in]  numSamples   Block length (<= ADC_CAPTURE_MAX_BLOCK_LEN).
+ * @param[in]  rate_u32     Sample rate [Hz].
+ * @param[in]  vRef_mV      ADC reference voltage [mV].
+ * @param[in]  adcMax_u16   Full-scale ADC code (4095 for 12 bit).
+ * @return true if a complete block was captured.
+ */
+bool adc_capture_single_block_mV(float32_t *pOut_mV, uint32_t numSamples, uint32_t rate_u32,
+                                 uint16_t vRef_mV, uint16_t adcMax_u16);
+
+#endif /* ACQUISITION_ADC_CAPTURE_H_ */
@@ -0,0 +1,132 @@
+/*
+ * adc_capture_hw_f407.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      STM32F407 back end of the ADC capture:
+ *          TIM2 update (TRGO) -> ADC1 regular channel 1 (PA1) -> DMA2 Stream0 / Channel 0 (circular)
+ *
+ *      The ADC and TIM HAL modules are not part of this project, the peripherals are
+ *      configured on register level. The timer paces the conversions, so the sample rate
+ *      is exact (TIMCLK / period) and independent of CPU load.
+ *
+ *      ADCCLK = PCLK2 / 4 = 21 MHz, 3 cycles sampling + 12 cycles conversion
+ *      -> max. 1.4 MSPS. Keep the source impedance low at high rates.
+ */
+
+#include "main.h"
+#include "adc_capture.h"
+
+#define ADC1_CHANNEL            1U          /* PA1 */
+#define DMA_STREAM0_IT_FLAGS    (DMA_LIFCR_CFEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTCIF0)
+
+/**
+ * @brief  Timer kernel clock of APB1 timers (twice PCLK1 if the APB1 prescaler is not 1).
+ */
+static uint32_t get_tim2_clock_hz(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    return ((RCC->CFGR & RCC_CFGR_PPRE1_2) != 0U) ? (2U * pclk1) : pclk1;
+}
+
+static bool adc_capture_f407_start(uint16_t *pBuf, uint32_t totalLen_u32, uint32_t rate_u32, uint32_t *pActualRate_u32)
+{
+    if ((totalLen_u32 == 0U) || (totalLen_u32 > 0xFFFFU) || (rate_u32 == 0U)) {
+        return false;
+    }
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;
+    (void)RCC->APB2ENR;
+
+    /* PA1 analog */
+    GPIOA->MODER |= (3U << (ADC1_CHANNEL * 2U));
+
+    //***** DMA2 Stream0, Channel 0 = ADC1 *****//
+    DMA2_Stream0->CR &= ~DMA_SxCR_EN;
+    while ((DMA2_Stream0->CR & DMA_SxCR_EN) != 0U) {
+    }
+    DMA2->LIFCR  = DMA_STREAM0_IT_FLAGS;
+    DMA2_Stream0->PAR  = (uint32_t)&ADC1->DR;
+    DMA2_Stream0->M0AR = (uint32_t)pBuf;
+    DMA2_Stream0->NDTR = totalLen_u32;
+    DMA2_Stream0->FCR  = 0U;                                /* direct mode */
+    DMA2_Stream0->CR   = DMA_SxCR_PL_1                      /* high priority */
+                       | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 /* 16 bit */
+                       | DMA_SxCR_MINC | DMA_SxCR_CIRC
+                       | DMA_SxCR_HTIE | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+    DMA2_Stream0->CR  |= DMA_SxCR_EN;
+
+    //***** ADC1: single channel, triggered by TIM2 TRGO on rising edge *****//
+    ADC->CCR   = (ADC->CCR & ~ADC_CCR_ADCPRE) | ADC_CCR_ADCPRE_0;   /* PCLK2 / 4 */
+    ADC1->CR2  = 0U;
+    ADC1->CR1  = 0U;                                                /* 12 bit, no scan */
+    ADC1->SMPR2 &= ~(ADC_SMPR2_SMP0 << (ADC1_CHANNEL * 3U));       /* 3 cycles */
+    ADC1->SQR1 = 0U;                                                /* 1 conversion */
+    ADC1->SQR3 = ADC1_CHANNEL;
+    ADC1->SR   = 0U;
+    ADC1->CR2  = ADC_CR2_DMA | ADC_CR2_DDS
+               | (6U << ADC_CR2_EXTSEL_Pos)                        /* TIM2 TRGO */
+               | ADC_CR2_EXTEN_0
+               | ADC_CR2_ADON;
+
+    //***** TIM2: update event every TIMCLK / rate *****//
+    uint32_t timClk = get_tim2_clock_hz();
+    uint32_t period = (timClk + (rate_u32 / 2U)) / rate_u32;
+    if (period < 2U) {
+        period = 2U;
+    }
+
+    TIM2->CR1 = 0U;
+    TIM2->PSC = 0U;
+    TIM2->ARR = period - 1U;
+    TIM2->CR2 = TIM_CR2_MMS_1;                                      /* TRGO = update */
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->SR  = 0U;
+    TIM2->CR1 = TIM_CR1_CEN;
+
+    *pActualRate_u32 = timClk / period;
+    return true;
+}
+
+static void adc_capture_f407_stop(void)
+{
+    TIM2->CR1 &= ~TIM_CR1_CEN;
+    ADC1->CR2 = 0U;
+
+    DMA2_Stream0->CR &= ~DMA_SxCR_EN;
+    while ((DMA2_Stream0->CR & DMA_SxCR_EN) != 0U) {
+    }
+    DMA2->LIFCR = DMA_STREAM0_IT_FLAGS;
+    HAL_NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+}
+
+const AdcCaptureHw_t adcCaptureHwF407 = {
+    .start = adc_capture_f407_start,
+    .stop  = adc_capture_f407_stop,
+};
+
+/**
+ * @brief  DMA2 Stream0 interrupt body, called from DMA2_Stream0_IRQHandler().
+ */
+void adc_capture_f407_dma_irq(void)
+{
+    uint32_t lisr = DMA2->LISR;
+    DMA2->LIFCR = lisr & DMA_STREAM0_IT_FLAGS;
+
+    if ((lisr & DMA_LISR_TEIF0) != 0U) {
+        adc_capture_f407_stop();
+        return;
+    }
+    if ((lisr & DMA_LISR_HTIF0) != 0U) {
+        adc_capture_block_done(0U);
+    }
+    if ((lisr & DMA_LISR_TCIF0) != 0U) {
+        adc_capture_block_done(1U);
+    }
+}
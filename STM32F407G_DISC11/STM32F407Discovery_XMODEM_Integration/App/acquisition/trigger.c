@@ -0,0 +1,229 @@
+/*
+ * trigger.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Trigger engine with pre-trigger ring and hold-off. See trigger.h.
+ */
+
+#include <string.h>
+
+#include "trigger.h"
+
+/* SWAR compare: two 16-bit lanes per word, sample values must be < 0x8000 */
+#define LANE_MSB        0x80008000UL
+#define LANE0_MSB       0x00008000UL
+#define LANE1_MSB       0x80000000UL
+#define SAMPLE_LIMIT    0x7FFFU
+
+/**
+ * @brief  Per lane: MSB set if the sample is >= level (both lanes at once).
+ */
+static inline uint32_t lanes_ge(uint32_t word, uint32_t levelPair)
+{
+    return ((word | LANE_MSB) - levelPair) & LANE_MSB;
+}
+
+static inline uint32_t level_pair(uint32_t level)
+{
+    return level | (level << 16U);
+}
+
+/**
+ * @brief  Trigger predicate of a single sample (before the edge check).
+ */
+static inline bool sample_pred(const TrigConfig_t *pCfg, uint16_t s)
+{
+    switch (pCfg->mode) {
+        case TRIG_FALLING: return s < pCfg->level_u16;
+        case TRIG_WINDOW:  return (s < pCfg->level_u16) || (s > pCfg->levelHigh_u16);
+        default:           return s >= pCfg->level_u16;     // TRIG_RISING, TRIG_LEVEL
+    }
+}
+
+int32_t trig_find(const TrigConfig_t *pCfg, uint16_t prev_u16, bool hasPrev, const uint16_t *pBlock, uint32_t len_u32)
+{
+    const bool edge = (pCfg->mode != TRIG_LEVEL);
+    const uint32_t loPair = level_pair(pCfg->level_u16);
+    const bool     useHi  = (pCfg->mode == TRIG_WINDOW) && (pCfg->levelHigh_u16 < SAMPLE_LIMIT);
+    const uint32_t hiPair = level_pair((uint32_t)pCfg->levelHigh_u16 + 1U);
+
+    // An edge needs a predecessor in which the predicate was false; without one, start "true"
+    bool prevPred = hasPrev ? sample_pred(pCfg, prev_u16) : true;
+    if (!edge) {
+        prevPred = false;
+    }
+
+    uint32_t i = 0U;
+    for (; (i + 1U) < len_u32; i += 2U) {
+        uint32_t word;
+        memcpy(&word, &pBlock[i], sizeof(word));    // lane 0 = pBlock[i] (little endian)
+
+        uint32_t pred;
+        switch (pCfg->mode) {
+            case TRIG_FALLING: pred = lanes_ge(word, loPair) ^ LANE_MSB; break;
+            case TRIG_WINDOW:  pred = (lanes_ge(word, loPair) ^ LANE_MSB) | (useHi ? lanes_ge(word, hiPair) : 0U); break;
+            default:           pred = lanes_ge(word, loPair); break;
+        }
+
+        // Fast path: no sample true, or (edge modes) all true and already true before
+        if (pred == 0U) {
+            prevPred = false;
+            continue;
+        }
+        if (edge && prevPred && (pred == LANE_MSB)) {
+            continue;
+        }
+
+        if (((pred & LANE0_MSB) != 0U) && !prevPred) {
+            return (int32_t)i;
+        }
+        if (((pred & LANE1_MSB) != 0U) && (!edge || ((pred & LANE0_MSB) == 0U))) {
+            return (int32_t)(i + 1U);
+        }
+        prevPred = edge && ((pred & LANE1_MSB) != 0U);
+    }
+
+    // Odd tail
+    if (i < len_u32) {
+        const bool p = sample_pred(pCfg, pBlock[i]);
+        if (p && !prevPred) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief  Append samples to the pre-trigger ring (only the newest ringCap are kept).
+ */
+static void ring_push(TrigEngine_t *pEng, const uint16_t *pSrc, uint32_t len_u32)
+{
+    const uint32_t cap = pEng->ringCap_u32;
+    if (cap == 0U) {
+        return;
+    }
+    if (len_u32 >= cap) {
+        memcpy(pEng->pRing, &pSrc[len_u32 - cap], cap * sizeof(uint16_t));
+        pEng->ringHead_u32 = 0U;
+        pEng->ringFill_u32 = cap;
+        return;
+    }
+
+    const uint32_t first = ((cap - pEng->ringHead_u32) < len_u32) ? (cap - pEng->ringHead_u32) : len_u32;
+    memcpy(&pEng->pRing[pEng->ringHead_u32], pSrc, first * sizeof(uint16_t));
+    memcpy(pEng->pRing, &pSrc[first], (len_u32 - first) * sizeof(uint16_t));
+    pEng->ringHead_u32 = (pEng->ringHead_u32 + len_u32) % cap;
+    pEng->ringFill_u32 = ((pEng->ringFill_u32 + len_u32) < cap) ? (pEng->ringFill_u32 + len_u32) : cap;
+}
+
+/**
+ * @brief  Copy the newest n samples of the ring (oldest first) to pDst.
+ */
+static void ring_copy_tail(const TrigEngine_t *pEng, uint16_t *pDst, uint32_t n)
+{
+    const uint32_t cap   = pEng->ringCap_u32;
+    const uint32_t start = (pEng->ringHead_u32 + cap - n) % cap;
+    const uint32_t first = ((cap - start) < n) ? (cap - start) : n;
+
+    memcpy(pDst, &pEng->pRing[start], first * sizeof(uint16_t));
+    memcpy(&pDst[first], pEng->pRing, (n - first) * sizeof(uint16_t));
+}
+
+bool trig_init(TrigEngine_t *pEng, const TrigConfig_t *pCfg, uint16_t *pRing, uint32_t ringCap_u32, uint16_t *pOut)
+{
+    if ((pCfg->mode >= TRIG_MODE_MAX) || (pCfg->postTrig_u32 == 0U) || (pCfg->preTrig_u32 > ringCap_u32) ||
+        (pCfg->level_u16 > SAMPLE_LIMIT) ||
+        ((pCfg->mode == TRIG_WINDOW) && (pCfg->levelHigh_u16 < pCfg->level_u16))) {
+        return false;
+    }
+
+    *pEng = (TrigEngine_t){ 0 };
+    pEng->cfg         = *pCfg;
+    pEng->pRing       = pRing;
+    pEng->ringCap_u32 = ringCap_u32;
+    pEng->pOut        = pOut;
+    pEng->armIdx_u32  = pCfg->holdoff_u32;
+    pEng->state       = TRIG_STATE_ARMED;
+    return true;
+}
+
+void trig_rearm(TrigEngine_t *pEng)
+{
+    // Samples after the last window were not recorded: history and edge state restart
+    pEng->ringHead_u32 = 0U;
+    pEng->ringFill_u32 = 0U;
+    pEng->havePrev     = false;
+    pEng->outLen_u32   = 0U;
+    pEng->armIdx_u32   = pEng->trigIdx_u32 + pEng->cfg.holdoff_u32;
+    pEng->state        = TRIG_STATE_ARMED;
+}
+
+/**
+ * @brief  Append post-trigger samples to the window.
+ */
+static void collect_post(TrigEngine_t *pEng, const uint16_t *pSrc, uint32_t avail_u32)
+{
+    const uint32_t total = pEng->cfg.preTrig_u32 + pEng->cfg.postTrig_u32;
+    const uint32_t need  = total - pEng->outLen_u32;
+    const uint32_t n     = (avail_u32 < need) ? avail_u32 : need;
+
+    memcpy(&pEng->pOut[pEng->outLen_u32], pSrc, n * sizeof(uint16_t));
+    pEng->outLen_u32 += n;
+    pEng->state = (pEng->outLen_u32 == total) ? TRIG_STATE_DONE : TRIG_STATE_CAPTURING;
+}
+
+TrigState_t trig_process_block(TrigEngine_t *pEng, const uint16_t *pBlock, uint32_t len_u32)
+{
+    const uint32_t blockStart = pEng->sampleIdx_u32;
+    pEng->sampleIdx_u32 += len_u32;
+
+    if ((pEng->state == TRIG_STATE_DONE) || (len_u32 == 0U)) {
+        return pEng->state;
+    }
+    if (pEng->state == TRIG_STATE_CAPTURING) {
+        collect_post(pEng, pBlock, len_u32);
+        return pEng->state;
+    }
+
+    //***** ARMED: first sample that may trigger (hold-off and pre-trigger history) *****//
+    uint32_t s0 = 0U;
+    if ((int32_t)(pEng->armIdx_u32 - blockStart) > 0) {
+        s0 = pEng->armIdx_u32 - blockStart;
+    }
+    if ((pEng->ringFill_u32 < pEng->cfg.preTrig_u32) && ((pEng->cfg.preTrig_u32 - pEng->ringFill_u32) > s0)) {
+        s0 = pEng->cfg.preTrig_u32 - pEng->ringFill_u32;
+    }
+
+    int32_t hit = -1;
+    if (s0 < len_u32) {
+        const bool     hasPrev = (s0 > 0U) || pEng->havePrev;
+        const uint16_t prev    = (s0 > 0U) ? pBlock[s0 - 1U] : pEng->prevSample_u16;
+        hit = trig_find(&pEng->cfg, prev, hasPrev, &pBlock[s0], len_u32 - s0);
+    }
+
+    if (hit < 0) {
+        ring_push(pEng, pBlock, len_u32);
+        pEng->prevSample_u16 = pBlock[len_u32 - 1U];
+        pEng->havePrev = true;
+        return pEng->state;
+    }
+
+    //***** Triggered: pre-trigger part from ring + this block, then post-trigger part *****//
+    const uint32_t trig = s0 + (uint32_t)hit;
+    const uint32_t pre  = pEng->cfg.preTrig_u32;
+    pEng->trigIdx_u32 = blockStart + trig;
+
+    const uint32_t fromBlock = (trig < pre) ? trig : pre;
+    const uint32_t fromRing  = pre - fromBlock;
+    if (fromRing > 0U) {
+        ring_copy_tail(pEng, pEng->pOut, fromRing);
+    }
+    memcpy(&pEng->pOut[fromRing], &pBlock[trig - fromBlock], fromBlock * sizeof(uint16_t));
+    pEng->outLen_u32 = pre;
+
+    collect_post(pEng, &pBlock[trig], len_u32 - trig);
+    return pEng->state;
+}
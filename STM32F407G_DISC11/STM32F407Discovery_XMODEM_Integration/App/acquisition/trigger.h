@@ -0,0 +1,115 @@
+/*
+ * trigger.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Oscilloscope-style trigger on a stream of 12-bit sample blocks (uint16 ADC codes),
+ *      independent of the sample source (generator blocks or ADC ping-pong blocks).
+ *
+ *      Trigger conditions (sample s[n], previous sample s[n-1]):
+ *          - TRIG_RISING  : s[n-1] <  level  and  s[n] >= level
+ *          - TRIG_FALLING : s[n-1] >= level  and  s[n] <  level
+ *          - TRIG_LEVEL   : s[n] >= level (first sample at or above the level)
+ *          - TRIG_WINDOW  : s[n] <  level  or   s[n] > levelHigh (signal leaves the window)
+ *
+ *      The captured window is preTrig samples before the trigger sample followed by
+ *      postTrig samples starting with the trigger sample. The pre-trigger history is kept
+ *      in a ring buffer so it can reach back into earlier blocks. A trigger is accepted
+ *      only once the ring holds preTrig samples and the hold-off has expired (holdoff
+ *      samples after arming, or after the previous trigger when re-armed).
+ *
+ *      The scan compares two samples per 32-bit word (SWAR) and only inspects single
+ *      samples in words where the condition changes, so quiet stretches of the signal cost
+ *      a few ALU operations per sample pair.
+ */
+
+#ifndef ACQUISITION_TRIGGER_H_
+#define ACQUISITION_TRIGGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Trigger condition */
+typedef enum {
+    TRIG_RISING = 0,
+    TRIG_FALLING,
+    TRIG_LEVEL,
+    TRIG_WINDOW,
+    TRIG_MODE_MAX
+} TrigMode_t;
+
+/** @brief Engine state */
+typedef enum {
+    TRIG_STATE_ARMED = 0,   /**< scanning for the trigger condition */
+    TRIG_STATE_CAPTURING,   /**< triggered, collecting post-trigger samples */
+    TRIG_STATE_DONE         /**< window complete, see pOut / outLen_u32 */
+} TrigState_t;
+
+/** @brief Trigger configuration */
+typedef struct {
+    TrigMode_t mode;
+    uint16_t   level_u16;       /**< trigger level; lower bound for TRIG_WINDOW */
+    uint16_t   levelHigh_u16;   /**< upper bound for TRIG_WINDOW */
+    uint32_t   preTrig_u32;     /**< samples before the trigger sample */
+    uint32_t   postTrig_u32;    /**< samples from the trigger sample on (>= 1) */
+    uint32_t   holdoff_u32;     /**< samples after arming / the last trigger without triggering */
+} TrigConfig_t;
+
+/** @brief Trigger engine instance (buffers are provided by the caller) */
+typedef struct {
+    TrigConfig_t cfg;
+    TrigState_t  state;
+    uint16_t    *pRing;             /**< pre-trigger history */
+    uint32_t     ringCap_u32;
+    uint32_t     ringHead_u32;      /**< next write position */
+    uint32_t     ringFill_u32;      /**< valid samples in the ring (<= ringCap) */
+    uint16_t    *pOut;              /**< captured window, preTrig + postTrig samples */
+    uint32_t     outLen_u32;
+    uint32_t     sampleIdx_u32;     /**< absolute index of the next sample fed */
+    uint32_t     armIdx_u32;        /**< triggers are accepted from this absolute index on */
+    uint32_t     trigIdx_u32;       /**< absolute index of the trigger sample */
+    uint16_t     prevSample_u16;    /**< last sample of the previous block (edge detection) */
+    bool         havePrev;
+} TrigEngine_t;
+
+/**
+ * @brief  Initialize and arm the engine.
+ *
+ * @param[out] pEng        Engine instance.
+ * @param[in]  pCfg        Trigger configuration.
+ * @param[in]  pRing       Ring buffer for the pre-trigger history, ringCap_u32 samples (>= preTrig).
+ * @param[in]  ringCap_u32 Ring buffer capacity.
+ * @param[in]  pOut        Output window buffer, preTrig + postTrig samples.
+ * @return false if the configuration does not fit the buffers or is invalid.
+ */
+bool trig_init(TrigEngine_t *pEng, const TrigConfig_t *pCfg, uint16_t *pRing, uint32_t ringCap_u32, uint16_t *pOut);
+
+/**
+ * @brief  Re-arm after TRIG_STATE_DONE. The hold-off counts from the previous trigger.
+ */
+void trig_rearm(TrigEngine_t *pEng);
+
+/**
+ * @brief  Feed the next block of the sample stream.
+ *
+ * Blocks must be contiguous in time. Samples after the end of the window are ignored.
+ *
+ * @return State after the block; TRIG_STATE_DONE once the window is complete.
+ */
+TrigState_t trig_process_block(TrigEngine_t *pEng, const uint16_t *pBlock, uint32_t len_u32);
+
+/**
+ * @brief  Find the first trigger sample in a block (vectorized scan).
+ *
+ * @param[in] pCfg         Trigger configuration (mode and levels).
+ * @param[in] prev_u16     Sample preceding pBlock[0] (ignored if hasPrev is false).
+ * @param[in] hasPrev      false at the very start of the stream (no edge possible at index 0).
+ * @param[in] pBlock       Samples.
+ * @param[in] len_u32      Number of samples.
+ * @return Index of the trigger sample, or -1 if the block holds none.
+ */
+int32_t trig_find(const TrigConfig_t *pCfg, uint16_t prev_u16, bool hasPrev, const uint16_t *pBlock, uint32_t len_u32);
+
+#endif /* ACQUISITION_TRIGGER_H_ */
@@ -0,0 +1,121 @@
+/*
+ * audio_out.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      I2S3 circular DMA output with half/complete refill. See audio_out.h.
+ *      The SPI3_TX DMA stream (DMA1 Stream7, channel 0) is linked in HAL_I2S_MspInit() (i2s.c).
+ */
+
+#include "main.h"
+#include "i2s.h"
+#include "audio_out.h"
+#include "cs43l22.h"
+#include "mem_placement.h"
+#include "profiling.h"
+
+#define AUDIO_OUT_BUF_LEN       (2U * 2U * AUDIO_OUT_FRAMES_PER_BLOCK)     /* 2 halves, L + R */
+#define AUDIO_OUT_HALF_LEN      (AUDIO_OUT_BUF_LEN / 2U)
+#define AUDIO_OUT_STAGE_TIMEOUT_MS  10U
+
+static int16_t audioOutBuf[AUDIO_OUT_BUF_LEN] MEM_DMA_BSS;
+
+static AudioSynth_t    audioSynth;
+static AudioOutStats_t audioStats;
+static volatile bool   audioRunning = false;
+static bool            codecReady   = false;
+
+/**
+ * @brief  Refill one half of the DMA buffer (called from the DMA callbacks).
+ */
+static void audio_out_refill(uint32_t half)
+{
+    const uint32_t t0 = prof_now();
+
+    audio_synth_fill(&audioSynth, &audioOutBuf[half * AUDIO_OUT_HALF_LEN], AUDIO_OUT_FRAMES_PER_BLOCK);
+
+    const uint32_t ticks = prof_now() - t0;
+    const uint32_t blockTicks = (uint32_t)(((uint64_t)prof_tick_hz() * AUDIO_OUT_FRAMES_PER_BLOCK) / AUDIO_OUT_FS);
+    audioStats.blocks_u32++;
+    audioStats.lastTicks_u32 = ticks;
+    if (ticks > audioStats.maxTicks_u32) {
+        audioStats.maxTicks_u32 = ticks;
+    }
+    if (ticks > blockTicks) {
+        audioStats.late_u32++;
+    }
+#if PROFILING_ENABLED
+    prof_record(PROF_AUDIO_REFILL, ticks);
+#endif
+}
+
+void HAL_I2S_TxHalfCpltCallback(I2S_HandleTypeDef *hi2s)
+{
+    if ((hi2s == &hi2s3) && audioRunning) {
+        audio_out_refill(0U);
+    }
+}
+
+void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s)
+{
+    if ((hi2s == &hi2s3) && audioRunning) {
+        audio_out_refill(1U);
+    }
+}
+
+bool audio_out_start(const AudioSynthParams_t *pParams, uint8_t volume_u8)
+{
+    if (audioRunning) {
+        audio_out_stop();
+    }
+
+    if (!codecReady) {
+        mem_assert_dma_buffer(audioOutBuf, sizeof(audioOutBuf), "audioOutBuf");
+        codecReady = cs43l22_init(volume_u8);
+        if (!codecReady) {
+            return false;
+        }
+    } else if (!cs43l22_set_volume(volume_u8)) {
+        return false;
+    }
+
+    audio_synth_init(&audioSynth, AUDIO_OUT_FS, pParams);
+    audioStats = (AudioOutStats_t){ 0 };
+
+    // Both halves are valid before the first transfer, later refills run one half ahead
+    audio_synth_fill(&audioSynth, audioOutBuf, 2U * AUDIO_OUT_FRAMES_PER_BLOCK);
+
+    audioRunning = true;
+    if (HAL_I2S_Transmit_DMA(&hi2s3, (uint16_t *)audioOutBuf, AUDIO_OUT_BUF_LEN) != HAL_OK) {
+        audioRunning = false;
+        return false;
+    }
+    return cs43l22_power(true);
+}
+
+bool audio_out_update(const AudioSynthParams_t *pParams)
+{
+    return audioRunning && audio_synth_stage(&audioSynth, pParams, AUDIO_OUT_STAGE_TIMEOUT_MS);
+}
+
+void audio_out_stop(void)
+{
+    if (!audioRunning) {
+        return;
+    }
+    (void)cs43l22_power(false);
+    audioRunning = false;
+    (void)HAL_I2S_DMAStop(&hi2s3);
+}
+
+bool audio_out_is_running(void)
+{
+    return audioRunning;
+}
+
+const AudioOutStats_t *audio_out_get_stats(void)
+{
+    return &audioStats;
+}
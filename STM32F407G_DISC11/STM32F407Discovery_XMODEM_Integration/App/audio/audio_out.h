@@ -0,0 +1,43 @@
+/*
+ * audio_out.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Continuous audio output of synthesized tones: I2S3 (96 kHz, 16 bit stereo)
+ *      -> CS43L22 headphone output of the Discovery board.
+ *
+ *      The DMA runs in circular mode over two half buffers. The half-complete and
+ *      complete callbacks refill the half the DMA has just left, from a phase-continuous
+ *      synthesizer (audio_synth.h), so block boundaries are seamless. Tone changes are
+ *      staged and applied at the next block boundary.
+ */
+
+#ifndef AUDIO_AUDIO_OUT_H_
+#define AUDIO_AUDIO_OUT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "audio_synth.h"
+
+#define AUDIO_OUT_FS                96000U  /* = hi2s3.Init.AudioFreq (I2S_AUDIOFREQ_96K) */
+#define AUDIO_OUT_FRAMES_PER_BLOCK  256U    /* stereo frames per half buffer (2.67 ms) */
+#define AUDIO_OUT_DEFAULT_VOLUME    200U
+
+/** @brief Output statistics since audio_out_start() */
+typedef struct {
+    uint32_t blocks_u32;        /**< half buffers refilled */
+    uint32_t late_u32;          /**< refills that took longer than one block period */
+    uint32_t lastTicks_u32;     /**< cost of the last refill [prof_now() ticks] */
+    uint32_t maxTicks_u32;      /**< worst refill cost */
+} AudioOutStats_t;
+
+bool audio_out_start(const AudioSynthParams_t *pParams, uint8_t volume_u8);
+bool audio_out_update(const AudioSynthParams_t *pParams);
+void audio_out_stop(void);
+bool audio_out_is_running(void);
+const AudioOutStats_t *audio_out_get_stats(void);
+
+#endif /* AUDIO_AUDIO_OUT_H_ */
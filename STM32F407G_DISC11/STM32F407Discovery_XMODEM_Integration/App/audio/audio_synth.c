@@ -0,0 +1,75 @@
+/*
+ * audio_synth.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      DDS tone synthesizer, see audio_synth.h.
+ */
+
+#include "audio_synth.h"
+#include "board_config.h"
+
+/**
+ * @brief  Copy a synthesizer tone set into the generator tone set.
+ */
+static void audio_synth_to_tones(const AudioSynthParams_t *pParams, SignalGen_Tones_t *pTones)
+{
+    uint8_t numTones = pParams->numTones_u8;
+    if (numTones > AUDIO_SYNTH_MAX_TONES) {
+        numTones = AUDIO_SYNTH_MAX_TONES;
+    }
+
+    *pTones = (SignalGen_Tones_t){ .numTones_u8 = numTones };
+    for (uint8_t k = 0U; k < numTones; ++k) {
+        pTones->freqs_u32[k] = pParams->freqs_u32[k];
+        pTones->amps_u16[k]  = pParams->amps_u16[k];
+    }
+}
+
+void audio_synth_init(AudioSynth_t *pSynth, uint32_t fs_u32, const AudioSynthParams_t *pParams)
+{
+    SignalGen_Tones_t tones;
+    audio_synth_to_tones(pParams, &tones);
+
+    const SignalGen_HandleType sigSettingsHandle = {
+        .startSample_u32       = 0U,
+        .samplingRate_u32      = fs_u32,
+        .dcOffset_u16          = 0U,
+        .vRef_u16              = 2U * AUDIO_SYNTH_FULL_SCALE_MV,
+        .adcMaxValue_u16       = 0xFFFFU,
+        .numTones_u8           = tones.numTones_u8,
+        .pToneFreqs_u32        = tones.freqs_u32,
+        .pToneAmps_u16         = tones.amps_u16,
+        .sineMethod            = SINE_METHOD_CMSIS,
+    };
+    SignalGen_StateInit(&pSynth->gen, &sigSettingsHandle);
+}
+
+bool audio_synth_stage(AudioSynth_t *pSynth, const AudioSynthParams_t *pParams, uint32_t timeout_ms)
+{
+    const uint32_t start_ms = platform_get_time_ms();
+    SignalGen_Tones_t tones;
+    audio_synth_to_tones(pParams, &tones);
+
+    // Retune is refused while the previous set has not been applied by the consumer
+    while (!SignalGen_Retune(&pSynth->gen, &tones)) {
+        if ((platform_get_time_ms() - start_ms) > timeout_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void audio_synth_fill(AudioSynth_t *pSynth, int16_t *pOut, uint32_t numFrames)
+{
+    // Mono block into the first half, then expand to L/R in place from the end
+    SignalGen_Next(&pSynth->gen, numFrames, DATA_TYPE_Q15, pOut);
+
+    for (uint32_t i = numFrames; i > 0U; --i) {
+        const int16_t sample = pOut[i - 1U];
+        pOut[2U * i - 2U] = sample;     // left
+        pOut[2U * i - 1U] = sample;     // right
+    }
+}
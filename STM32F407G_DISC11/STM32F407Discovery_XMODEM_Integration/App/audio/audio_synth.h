@@ -0,0 +1,67 @@
+/*
+ * audio_synth.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Phase-continuous multi-tone synthesizer for the audio output (I2S3 -> CS43L22).
+ *
+ *      Thin layer over the persistent signal generator (SignalGen_State_t, Q15 output):
+ *      the per-tone phases persist between calls, so consecutive blocks form one
+ *      continuous waveform.
+ *
+ *      Retuning: parameters are staged with audio_synth_stage() (SignalGen_Retune()) and
+ *      take effect at the start of the next block. Only the increments and amplitudes
+ *      change, the phases continue, so a retune never produces a phase jump.
+ *
+ *      No hardware access: the same code runs in the DMA callbacks and on a host.
+ */
+
+#ifndef AUDIO_AUDIO_SYNTH_H_
+#define AUDIO_AUDIO_SYNTH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arm_math_include.h"
+#include "signal_gen.h"
+
+#define AUDIO_SYNTH_MAX_TONES       8U
+#define AUDIO_SYNTH_FULL_SCALE_MV   1650U   /* amplitude that maps to int16 full scale */
+
+/** @brief Tone set of the synthesizer */
+typedef struct {
+    uint8_t  numTones_u8;
+    uint32_t freqs_u32[AUDIO_SYNTH_MAX_TONES];  /**< [Hz], < fs/2 */
+    uint16_t amps_u16[AUDIO_SYNTH_MAX_TONES];   /**< peak amplitude [mV], see AUDIO_SYNTH_FULL_SCALE_MV */
+} AudioSynthParams_t;
+
+/** @brief Synthesizer instance */
+typedef struct {
+    SignalGen_State_t  gen;     /**< Q15 output, vRef/2 = AUDIO_SYNTH_FULL_SCALE_MV */
+} AudioSynth_t;
+
+/**
+ * @brief  Reset all phases and apply a tone set (integer Hz, phase-exact at fs_u32).
+ */
+void audio_synth_init(AudioSynth_t *pSynth, uint32_t fs_u32, const AudioSynthParams_t *pParams);
+
+/**
+ * @brief  Stage a new tone set for the next block boundary.
+ *
+ * Call from thread context while the synthesizer runs in an interrupt. A previously
+ * staged set that has not been applied yet is waited for (at most one block).
+ *
+ * @return false if the previous set was not applied within timeout_ms.
+ */
+bool audio_synth_stage(AudioSynth_t *pSynth, const AudioSynthParams_t *pParams, uint32_t timeout_ms);
+
+/**
+ * @brief  Render numFrames stereo frames (L = R) as interleaved int16.
+ *
+ * Applies a staged tone set first (block boundary).
+ */
+void audio_synth_fill(AudioSynth_t *pSynth, int16_t *pOut, uint32_t numFrames);
+
+#endif /* AUDIO_AUDIO_SYNTH_H_ */
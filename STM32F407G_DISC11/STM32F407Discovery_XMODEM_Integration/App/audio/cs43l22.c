@@ -0,0 +1,80 @@
+/*
+ * cs43l22.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      CS43L22 register setup (sequence as in the ST Discovery BSP).
+ */
+
+#include "main.h"
+#include "i2c.h"
+#include "cs43l22.h"
+
+#define CS43L22_REG_ID              0x01U
+#define CS43L22_REG_POWER_CTL1      0x02U
+#define CS43L22_REG_POWER_CTL2      0x04U
+#define CS43L22_REG_CLOCKING_CTL    0x05U
+#define CS43L22_REG_INTERFACE_CTL1  0x06U
+#define CS43L22_REG_ANALOG_ZC_SR    0x0AU
+#define CS43L22_REG_PCMA_VOL        0x1AU
+#define CS43L22_REG_PCMB_VOL        0x1BU
+#define CS43L22_REG_TONE_CTL        0x1FU
+#define CS43L22_REG_MASTER_A_VOL    0x20U
+#define CS43L22_REG_MASTER_B_VOL    0x21U
+#define CS43L22_REG_LIMIT_CTL1      0x27U
+
+#define CS43L22_I2C_TIMEOUT_MS      10U
+
+static bool cs43l22_write(uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = { reg, value };
+    return HAL_I2C_Master_Transmit(&hi2c1, CS43L22_I2C_ADDR, buf, sizeof(buf), CS43L22_I2C_TIMEOUT_MS) == HAL_OK;
+}
+
+static bool cs43l22_read(uint8_t reg, uint8_t *pValue)
+{
+    return (HAL_I2C_Master_Transmit(&hi2c1, CS43L22_I2C_ADDR, &reg, 1U, CS43L22_I2C_TIMEOUT_MS) == HAL_OK) &&
+           (HAL_I2C_Master_Receive(&hi2c1, CS43L22_I2C_ADDR, pValue, 1U, CS43L22_I2C_TIMEOUT_MS) == HAL_OK);
+}
+
+bool cs43l22_set_volume(uint8_t volume_u8)
+{
+    // Master volume register, 0.5 dB steps: 0x18 = +12 dB ... 0x00 = 0 dB, 0xFF = -0.5 dB ... 0x34 = -102 dB.
+    // 255 -> 0x00 (0 dB, no gain that could clip), one step less per count, 0x34 from 51 down.
+    const uint8_t reg = (volume_u8 > 0x33U) ? (uint8_t)(volume_u8 + 1U) : 0x34U;
+    return cs43l22_write(CS43L22_REG_MASTER_A_VOL, reg) && cs43l22_write(CS43L22_REG_MASTER_B_VOL, reg);
+}
+
+bool cs43l22_power(bool on)
+{
+    return cs43l22_write(CS43L22_REG_POWER_CTL1, on ? 0x9EU : 0x01U);
+}
+
+bool cs43l22_init(uint8_t volume_u8)
+{
+    uint8_t id = 0U;
+
+    HAL_GPIO_WritePin(Audio_RST_GPIO_Port, Audio_RST_Pin, GPIO_PIN_RESET);
+    HAL_Delay(5);
+    HAL_GPIO_WritePin(Audio_RST_GPIO_Port, Audio_RST_Pin, GPIO_PIN_SET);
+    HAL_Delay(5);
+
+    // Chip ID 0b11100xxx
+    if (!cs43l22_read(CS43L22_REG_ID, &id) || ((id & 0xF8U) != 0xE0U)) {
+        return false;
+    }
+
+    bool ok = cs43l22_power(false);
+    ok = ok && cs43l22_write(CS43L22_REG_POWER_CTL2, 0xAFU);        // headphone on, speaker off
+    ok = ok && cs43l22_write(CS43L22_REG_CLOCKING_CTL, 0x81U);      // auto-detect speed, MCLK / 2
+    ok = ok && cs43l22_write(CS43L22_REG_INTERFACE_CTL1, 0x04U);    // slave, I2S Philips, 16 bit
+    ok = ok && cs43l22_set_volume(volume_u8);
+    ok = ok && cs43l22_write(CS43L22_REG_ANALOG_ZC_SR, 0x00U);      // no soft ramp / zero cross
+    ok = ok && cs43l22_write(CS43L22_REG_LIMIT_CTL1, 0x00U);        // limiter off
+    ok = ok && cs43l22_write(CS43L22_REG_TONE_CTL, 0x0FU);          // bass / treble 0 dB
+    ok = ok && cs43l22_write(CS43L22_REG_PCMA_VOL, 0x0AU);
+    ok = ok && cs43l22_write(CS43L22_REG_PCMB_VOL, 0x0AU);
+    return ok;
+}
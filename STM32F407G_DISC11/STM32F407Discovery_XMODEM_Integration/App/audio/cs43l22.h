@@ -0,0 +1,38 @@
+/*
+ * cs43l22.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Minimal driver of the CS43L22 audio DAC on the STM32F407G-DISC1
+ *      (control: I2C1 PB6/PB9, reset: PD4, audio: I2S3 slave, Philips, 16 bit).
+ */
+
+#ifndef AUDIO_CS43L22_H_
+#define AUDIO_CS43L22_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CS43L22_I2C_ADDR    0x94U   /* 8-bit write address */
+
+/**
+ * @brief  Reset the codec and configure headphone output for 16-bit Philips I2S.
+ * @param[in] volume_u8  Master volume, see cs43l22_set_volume().
+ * @return false if the codec does not answer on I2C.
+ */
+bool cs43l22_init(uint8_t volume_u8);
+
+/**
+ * @brief  Power the codec up (play) or down (mute, I2S clocks may stop).
+ */
+bool cs43l22_power(bool on);
+
+/**
+ * @brief  Set the master volume of both channels.
+ * @param[in] volume_u8  255 = 0 dB, -0.5 dB per step below, 51 and less = -102 dB.
+ */
+bool cs43l22_set_volume(uint8_t volume_u8);
+
+#endif /* AUDIO_CS43L22_H_ */
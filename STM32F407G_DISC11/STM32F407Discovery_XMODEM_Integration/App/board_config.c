@@ -1,5 +1,32 @@
 #include "board_config.h"
-#include "stm32f4xx_hal_gpio.h"
+#include "stm32f4xx_hal.h"
+#include "usart.h"
+#include "rng.h"
+#include "uart_app.h"
+
+#define DEBUG_UART_HANDLE    (&huart2)  // Or USARTx, etc., configurable per project
+#define DEBUG2_UART_HANDLE    (&huart3)  // Or USARTx, etc., configurable per project
+
+/* HAL_UART_Transmit() takes a 16-bit size, larger writes are split */
+#define PLATFORM_UART_MAX_CHUNK     (0x8000UL)
+
+static UART_HandleTypeDef *platform_uart_handle(PlatformUart_t port)
+{
+    return (port == PLATFORM_UART_DEBUG2) ? DEBUG2_UART_HANDLE : DEBUG_UART_HANDLE;
+}
+
+/* false for a handle that is not one of the App ports */
+static bool platform_uart_port(const UART_HandleTypeDef *huart, PlatformUart_t *pPort)
+{
+    if (huart == DEBUG_UART_HANDLE) {
+        *pPort = PLATFORM_UART_DEBUG;
+    } else if (huart == DEBUG2_UART_HANDLE) {
+        *pPort = PLATFORM_UART_DEBUG2;
+    } else {
+        return false;
+    }
+    return true;
+}
 
 
 void write_BlueLed_PD15(bool state)
@@ -50,5 +77,58 @@ void platform_delay_ms(uint32_t ms)
 
 uint32_t platform_get_time_ms(void)
 {
-  return uwTick;
+  return HAL_GetTick();
+}
+
+bool platform_uart_write(PlatformUart_t port, const uint8_t *pData, uint32_t len)
+{
+    UART_HandleTypeDef *huart = platform_uart_handle(port);
+
+    while (len > 0U)
+    {
+        uint16_t chunk = (uint16_t)((len > PLATFORM_UART_MAX_CHUNK) ? PLATFORM_UART_MAX_CHUNK : len);
+        if (HAL_UART_Transmit(huart, (uint8_t *)pData, chunk, HAL_MAX_DELAY) != HAL_OK) {
+            return false;
+        }
+        pData += chunk;
+        len   -= chunk;
+    }
+    return true;
+}
+
+bool platform_uart_write_dma(PlatformUart_t port, const uint8_t *pData, uint16_t len)
+{
+    return HAL_UART_Transmit_DMA(platform_uart_handle(port), (uint8_t *)pData, len) == HAL_OK;
+}
+
+bool platform_uart_start_rx(PlatformUart_t port, uint8_t *pBuf, uint16_t len)
+{
+    return HAL_UART_Receive_DMA(platform_uart_handle(port), pBuf, len) == HAL_OK;
+}
+
+uint32_t platform_uart_get_baud(PlatformUart_t port)
+{
+    return platform_uart_handle(port)->Init.BaudRate;
+}
+
+bool platform_rng_read(uint32_t *pValue)
+{
+    return HAL_RNG_GenerateRandomNumber(&hrng, pValue) == HAL_OK;
+}
+
+/* HAL UART callbacks (DMA RX / TX complete), forwarded to uart_app.c by port */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    PlatformUart_t port;
+    if (platform_uart_port(huart, &port)) {
+        uart_app_rx_complete(port);
+    }
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    PlatformUart_t port;
+    if (platform_uart_port(huart, &port)) {
+        uart_app_tx_complete(port);
+    }
 }
@@ -1,15 +1,7 @@
 #ifndef BOARD_CONFIG_H_
 #define BOARD_CONFIG_H_
+#include <stdint.h>
 #include <stdbool.h>
-#include "stm32f4xx_hal.h"
-
-extern UART_HandleTypeDef huart2;  // Provided by CubeMX
-extern UART_HandleTypeDef huart3;  // Provided by CubeMX
-
-#define DEBUG_UART_HANDLE    (&huart2)  // Or USARTx, etc., configurable per project
-#define DEBUG2_UART_HANDLE    (&huart3)  // Or USARTx, etc., configurable per project
-
-
 
 void write_BlueLed_PD15(bool state);
 void toggle_BlueLed_PD15(void);
@@ -26,5 +18,48 @@ void toggle_GreenLed_PD12(void);
 void platform_delay_ms(uint32_t ms);
 uint32_t platform_get_time_ms(void);
 
+/* --- Platform port ------------------------------------------------------------
+ * The App layer reaches UART, RNG and tick only through these functions, so that
+ * board_config.c is the single file to replace when App/ runs on other hardware
+ * or against fakes. No HAL type is visible through this header; the UART handles
+ * and the HAL UART callbacks live in board_config.c, which forwards them to
+ * uart_app_rx_complete() / uart_app_tx_complete(). */
+
+/** @brief Logical UART ports used by the App layer */
+typedef enum {
+    PLATFORM_UART_DEBUG = 0,    /**< command / data link (USART2) */
+    PLATFORM_UART_DEBUG2        /**< secondary debug output (USART3) */
+} PlatformUart_t;
+
+/**
+ * @brief  Blocking write of an arbitrary (32-bit) number of bytes to a UART port.
+ * @return true if all bytes were transmitted.
+ */
+bool platform_uart_write(PlatformUart_t port, const uint8_t *pData, uint32_t len);
+
+/**
+ * @brief  Start a DMA write; uart_app_tx_complete() is called when it is done.
+ * @return true if the transfer was started.
+ */
+bool platform_uart_write_dma(PlatformUart_t port, const uint8_t *pData, uint16_t len);
+
+/**
+ * @brief  (Re)start DMA reception of len bytes into pBuf on a UART port;
+ *         uart_app_rx_complete() is called when they have arrived.
+ * @return true if the reception was started.
+ */
+bool platform_uart_start_rx(PlatformUart_t port, uint8_t *pBuf, uint16_t len);
+
+/**
+ * @brief  Configured baud rate of a UART port.
+ */
+uint32_t platform_uart_get_baud(PlatformUart_t port);
+
+/**
+ * @brief  Read one 32-bit random number.
+ * @return true on success, false if the RNG reported an error.
+ */
+bool platform_rng_read(uint32_t *pValue);
+
 
 #endif /* BOARD_CONFIG_H_ */
@@ -24,7 +24,23 @@
  */
 uint32_t calculate_crc32(const uint8_t *data, uint32_t length)
 {
-    uint32_t crc = 0xFFFFFFFF;
+    return crc32_update(0U, data, length);
+}
+
+/**
+ * @brief Continue a CRC-32 over the next chunk of a data stream.
+ *
+ * Chaining crc32_update() over consecutive chunks gives the same result as one
+ * calculate_crc32() over the whole data. Start with crc = 0.
+ *
+ * @param crc    CRC-32 of the previous chunks (0 for the first chunk).
+ * @param data   Pointer to the next chunk.
+ * @param length Length of the chunk in bytes.
+ * @return uint32_t The CRC-32 checksum including this chunk.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    crc = ~crc;
     for (uint32_t i = 0; i < length; i++) {
         crc ^= (uint32_t)data[i];
         for (uint8_t j = 0; j < 8; j++) {
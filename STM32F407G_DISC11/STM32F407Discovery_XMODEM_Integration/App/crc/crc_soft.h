@@ -22,4 +22,14 @@
  */
 uint32_t calculate_crc32(const uint8_t *data, uint32_t length);
 
+/**
+ * @brief Continue a CRC-32 over the next chunk of a data stream.
+ *
+ * @param crc CRC-32 of the previous chunks (0 for the first chunk).
+ * @param data Pointer to the next chunk.
+ * @param length Length of the chunk in bytes.
+ * @return uint32_t The CRC-32 checksum including this chunk.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t length);
+
 #endif /* CRC_SOFT_H_ */
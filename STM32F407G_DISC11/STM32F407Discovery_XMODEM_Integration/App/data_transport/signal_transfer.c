@@ -13,6 +13,20 @@
 #include "signal_transfer.h"
 #include "arm_math_include.h"	// To make float32_t known to this file
 
+/**
+ * @brief Byte size of one sample of the given data type (0 for unknown types).
+ */
+static uint32_t get_sample_size_bytes(DataType_t data_type)
+{
+    switch (data_type)
+    {
+        case DATA_TYPE_FLOAT32: return sizeof(float32_t);
+        case DATA_TYPE_UINT16:  return sizeof(uint16_t);
+        case DATA_TYPE_Q15:     return sizeof(q15_t);
+        default:                return 0U;
+    }
+}
+
 
 /**
  * @brief  Send signal response over UART, supporting JSON+ASCII or JSON+binary.
@@ -26,7 +40,7 @@
 void send_signal_response(const char *cmd_name,
                          const JsonParsedSigGenPar_HandlType_t *config,
                          const void *data_ptr,
-                         uint16_t num_samples,
+                         uint32_t num_samples,
                          DataType_t data_type,
                          TransferMode_t transferMode)
 {
@@ -44,7 +58,7 @@ void send_signal_response(const char *cmd_name,
     // --- Prepare and send JSON header ONLY (no data attached)
     printToDebugUartBlocking("{\"cmd\":\"%s\",\"status\":\"OK\",\"args\":{", cmd_name);
     printToDebugUartBlocking("\"num_tones\":%u,", (uint32_t)config->numTones_u16);
-    printToDebugUartBlocking("\"len\":%u,", (uint32_t)num_samples);
+    printToDebugUartBlocking("\"len\":%lu,", (unsigned long)num_samples);
     printToDebugUartBlocking("\"data_type\":\"%u\",", data_type);
     printToDebugUartBlocking("\"transferMode\":\"%u\"", transferMode);
 
@@ -89,7 +103,7 @@ void send_signal_response(const char *cmd_name,
     else
     {
         // Send binary data block (no wrapper JSON)
-        HAL_UART_Transmit(&huart2, (const uint8_t *)data_ptr, num_samples * data_size_bytes, HAL_MAX_DELAY);
+        platform_uart_write(PLATFORM_UART_DEBUG, (const uint8_t *)data_ptr, num_samples * data_size_bytes);
     }
 }
 
@@ -107,7 +121,7 @@ void send_signal_response(const char *cmd_name,
 void send_signal_header(const char *cmd_name,
                         const JsonParsedSigGenPar_HandlType_t *config,
                         const void *data_ptr,
-                        uint16_t num_samples,
+                        uint32_t num_samples,
                         DataType_t data_type,
                         TransferMode_t transferMode)
 {
@@ -125,7 +139,7 @@ void send_signal_header(const char *cmd_name,
     // --- Send JSON header
     printToDebugUartBlocking("{\"cmd\":\"%s\",\"status\":\"OK\",\"args\":{", cmd_name);
     printToDebugUartBlocking("\"num_tones\":%u,", (uint32_t)config->numTones_u16);
-    printToDebugUartBlocking("\"len\":%u,", (uint32_t)num_samples);
+    printToDebugUartBlocking("\"len\":%lu,", (unsigned long)num_samples);
     printToDebugUartBlocking("\"data_type\":\"%u\",", data_type);
     printToDebugUartBlocking("\"transferMode\":\"%u\"", transferMode);
 
@@ -149,7 +163,7 @@ void send_signal_header(const char *cmd_name,
  * @param[in] transferMode  Output format: ASCII JSON or binary.
  */
 void send_signal_payload(const void *data_ptr,
-                         uint16_t num_samples,
+                         uint32_t num_samples,
                          DataType_t data_type,
                          TransferMode_t transferMode)
 {
@@ -195,7 +209,113 @@ void send_signal_payload(const void *data_ptr,
             case DATA_TYPE_Q15:     data_size_bytes = sizeof(q15_t);     break;
             default:                return;  // Unknown data type
         }
-        HAL_UART_Transmit(&huart2, (const uint8_t *)data_ptr, num_samples * data_size_bytes, HAL_MAX_DELAY);
+        platform_uart_write(PLATFORM_UART_DEBUG, (const uint8_t *)data_ptr, num_samples * data_size_bytes);
     }
 }
 
+
+/**
+ * @brief Send the JSON header of a streamed signal.
+ *
+ * Used when a signal is longer than the sample buffer and is produced block by block.
+ * The header announces the total length and the block length; the CRC is not known
+ * yet and follows in the trailer (see send_signal_stream_trailer()).
+ *
+ * @param[in] cmd_name      Command name to embed in the response.
+ * @param[in] config        Pointer to parsed signal generation parameters.
+ * @param[in] num_samples   Total number of samples of the stream.
+ * @param[in] block_len     Number of samples per block (last block may be shorter).
+ * @param[in] data_type     Data type of the signal samples.
+ * @param[in] transferMode  Transfer mode (ASCII or Binary).
+ */
+void send_signal_stream_header(const char *cmd_name,
+                               const JsonParsedSigGenPar_HandlType_t *config,
+                               uint32_t num_samples,
+                               uint32_t block_len,
+                               DataType_t data_type,
+                               TransferMode_t transferMode)
+{
+    printToDebugUartBlocking("{\"cmd\":\"%s\",\"status\":\"OK\",\"args\":{", cmd_name);
+    printToDebugUartBlocking("\"num_tones\":%u,", (uint32_t)config->numTones_u16);
+    printToDebugUartBlocking("\"len\":%lu,", (unsigned long)num_samples);
+    printToDebugUartBlocking("\"block\":%lu,", (unsigned long)block_len);
+    printToDebugUartBlocking("\"data_type\":\"%u\",", data_type);
+    printToDebugUartBlocking("\"transferMode\":\"%u\"", transferMode);
+    printToDebugUartBlocking("}}\r\n");
+}
+
+/**
+ * @brief Send one block of a streamed signal and update the running CRC.
+ *
+ * In ASCII mode every block is a separate {"data":{"SIG1":[...]}} line.
+ *
+ * @param[in] data_ptr      Pointer to the block samples.
+ * @param[in] num_samples   Number of samples in this block.
+ * @param[in] data_type     Data type of the buffer elements.
+ * @param[in] transferMode  Output format: ASCII JSON or binary.
+ * @param[in] crc           CRC-32 of the previous blocks (0 for the first block).
+ * @return CRC-32 over all blocks sent so far.
+ */
+uint32_t send_signal_stream_block(const void *data_ptr,
+                                  uint32_t num_samples,
+                                  DataType_t data_type,
+                                  TransferMode_t transferMode,
+                                  uint32_t crc)
+{
+    crc = crc32_update(crc, (const uint8_t *)data_ptr, num_samples * get_sample_size_bytes(data_type));
+    send_signal_payload(data_ptr, num_samples, data_type, transferMode);
+    return crc;
+}
+
+/**
+ * @brief Close a streamed signal with the number of samples sent and the CRC-32.
+ *
+ * @param[in] cmd_name     Command name to embed in the response.
+ * @param[in] num_samples  Total number of samples that were sent.
+ * @param[in] crc          CRC-32 over all sent blocks.
+ */
+void send_signal_stream_trailer(const char *cmd_name, uint32_t num_samples, uint32_t crc)
+{
+    printToDebugUartBlocking("{\"cmd\":\"%s\",\"status\":\"DONE\",\"args\":{", cmd_name);
+    printToDebugUartBlocking("\"len\":%lu,\"crc\":%lu", (unsigned long)num_samples, (unsigned long)crc);
+    printToDebugUartBlocking("}}\r\n");
+}
+
+/**
+ * @brief Send the JSON header of one frame of a continuous stream (START_STREAM).
+ *
+ * The payload follows with send_signal_payload(). Frames of the changed-bins view carry
+ * two payloads: the uint16 bin indices first, then the values; the CRC covers both.
+ *
+ * @param[in] cmd_name      Frame name to embed in the response (e.g. "STREAM_FFT").
+ * @param[in] seq           Sequence number of the frame (gaps = dropped frames).
+ * @param[in] dropped       Total number of dropped frames since the stream start.
+ * @param[in] view          Bin representation (0 = full, 1 = decimated, 2 = changed bins).
+ * @param[in] decim         Decimation factor of the bins (1 = none).
+ * @param[in] num_values    Number of values in the payload.
+ * @param[in] data_type     Data type of the values.
+ * @param[in] transferMode  Transfer mode (ASCII or Binary).
+ * @param[in] crc           CRC-32 of the binary payload (ignored in ASCII mode).
+ */
+void send_stream_frame_header(const char *cmd_name,
+                              uint32_t seq,
+                              uint32_t dropped,
+                              uint32_t view,
+                              uint32_t decim,
+                              uint32_t num_values,
+                              DataType_t data_type,
+                              TransferMode_t transferMode,
+                              uint32_t crc)
+{
+    printToDebugUartBlocking("{\"cmd\":\"%s\",\"status\":\"OK\",\"args\":{", cmd_name);
+    printToDebugUartBlocking("\"seq\":%lu,\"dropped\":%lu,", (unsigned long)seq, (unsigned long)dropped);
+    printToDebugUartBlocking("\"view\":%lu,\"decim\":%lu,", (unsigned long)view, (unsigned long)decim);
+    printToDebugUartBlocking("\"len\":%lu,", (unsigned long)num_values);
+    printToDebugUartBlocking("\"data_type\":\"%u\",", data_type);
+    printToDebugUartBlocking("\"transferMode\":\"%u\"", transferMode);
+    if (transferMode == TRANSFER_BINARY)
+    {
+        printToDebugUartBlocking(",\"crc\":%lu", (unsigned long)crc);
+    }
+    printToDebugUartBlocking("}}\r\n");
+}
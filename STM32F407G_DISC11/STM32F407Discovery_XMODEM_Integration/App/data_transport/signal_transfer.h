@@ -8,6 +8,10 @@
 #ifndef DATA_TRANSPORT_SIGNAL_TRANSFER_H_
 #define DATA_TRANSPORT_SIGNAL_TRANSFER_H_
 
+#include <stdint.h>
+
+/* Upper bound for streamed signals (generated block by block, longer than RAM) */
+#define SIG_STREAM_MAX_LEN   (1024UL * 1024UL)
 
 
 /** @brief Output data type */
@@ -37,7 +41,7 @@ typedef enum {
 /* Signal source selection coming from host */
 typedef enum {
     SIG_SRC_CALC = 0,   /* generate synthetically (your current path) */
-    SIG_SRC_ADC,        /* capture from ADC/DMA (future) */
+    SIG_SRC_ADC,        /* capture from ADC1/PA1, TIM2-triggered DMA (see adc_capture.h) */
 	SIG_SRC_MAX
 } SignalSource_t;
 
@@ -46,7 +50,7 @@ typedef enum {
  */
 typedef struct {
     uint16_t numTones_u16;        /**< Number of tones */
-    uint16_t numSamples_u16;      /**< Number of samples */
+    uint32_t numSamples_u32;      /**< Number of samples (may exceed MAX_SIG_LEN for streamed signals) */
     uint32_t sampl_rate;		  /**< Sampling rate define by the host */
     uint32_t *pFreqs;             /**< Pointer to frequencies array */
     uint16_t *pAmps;              /**< Pointer to amplitudes array */
@@ -54,6 +58,7 @@ typedef struct {
     TransferMode_t transferMode;  /**< Transfer mode (ASCII or Binary) */
     FilterType_t    filterType;   /**< FILT_NONE, FILT_FIR_LP, ... */
     SignalSource_t  sigSource; 	  /**< SIG_SRC_CALC, SIG_SRC_ADC, ... */
+    const struct SignalGen_Wave_s *pWave; /**< Waveform mode for SIG_SRC_CALC (chirp, AM/FM, table, tone phases) */
 } JsonParsedSigGenPar_HandlType_t;
 
 
@@ -70,7 +75,7 @@ typedef struct {
 void send_signal_response(const char *cmd_name,
                          const JsonParsedSigGenPar_HandlType_t *config,
                          const void *data_ptr,
-                         uint16_t num_samples,
+                         uint32_t num_samples,
                          DataType_t data_type,
                          TransferMode_t transferMode);
 
@@ -87,7 +92,7 @@ void send_signal_response(const char *cmd_name,
 void send_signal_header(const char *cmd_name,
                         const JsonParsedSigGenPar_HandlType_t *config,
                         const void *data_ptr,
-                        uint16_t num_samples,
+                        uint32_t num_samples,
                         DataType_t data_type,
                         TransferMode_t transferMode);
 
@@ -100,8 +105,73 @@ void send_signal_header(const char *cmd_name,
  * @param[in] transferMode  Output format: ASCII JSON or binary.
  */
 void send_signal_payload(const void *data_ptr,
-                         uint16_t num_samples,
+                         uint32_t num_samples,
                          DataType_t data_type,
                          TransferMode_t transferMode);
 
+/**
+ * @brief Send the JSON header of a streamed signal (total length and block length, no CRC).
+ *
+ * @param[in] cmd_name      Command name to embed in the response.
+ * @param[in] config        Pointer to parsed signal generation parameters.
+ * @param[in] num_samples   Total number of samples of the stream.
+ * @param[in] block_len     Number of samples per block (last block may be shorter).
+ * @param[in] data_type     Data type of the signal samples.
+ * @param[in] transferMode  Transfer mode (ASCII or Binary).
+ */
+void send_signal_stream_header(const char *cmd_name,
+                               const JsonParsedSigGenPar_HandlType_t *config,
+                               uint32_t num_samples,
+                               uint32_t block_len,
+                               DataType_t data_type,
+                               TransferMode_t transferMode);
+
+/**
+ * @brief Send one block of a streamed signal and update the running CRC.
+ *
+ * @param[in] data_ptr      Pointer to the block samples.
+ * @param[in] num_samples   Number of samples in this block.
+ * @param[in] data_type     Data type of the buffer elements.
+ * @param[in] transferMode  Output format: ASCII JSON or binary.
+ * @param[in] crc           CRC-32 of the previous blocks (0 for the first block).
+ * @return CRC-32 over all blocks sent so far.
+ */
+uint32_t send_signal_stream_block(const void *data_ptr,
+                                  uint32_t num_samples,
+                                  DataType_t data_type,
+                                  TransferMode_t transferMode,
+                                  uint32_t crc);
+
+/**
+ * @brief Close a streamed signal with the number of samples sent and the CRC-32.
+ *
+ * @param[in] cmd_name     Command name to embed in the response.
+ * @param[in] num_samples  Total number of samples that were sent.
+ * @param[in] crc          CRC-32 over all sent blocks.
+ */
+void send_signal_stream_trailer(const char *cmd_name, uint32_t num_samples, uint32_t crc);
+
+/**
+ * @brief Send the JSON header of one frame of a continuous stream (START_STREAM).
+ *
+ * @param[in] cmd_name      Frame name to embed in the response (e.g. "STREAM_FFT").
+ * @param[in] seq           Sequence number of the frame (gaps = dropped frames).
+ * @param[in] dropped       Total number of dropped frames since the stream start.
+ * @param[in] view          Bin representation (0 = full, 1 = decimated, 2 = changed bins).
+ * @param[in] decim         Decimation factor of the bins (1 = none).
+ * @param[in] num_values    Number of values in the payload.
+ * @param[in] data_type     Data type of the values.
+ * @param[in] transferMode  Transfer mode (ASCII or Binary).
+ * @param[in] crc           CRC-32 of the binary payload (ignored in ASCII mode).
+ */
+void send_stream_frame_header(const char *cmd_name,
+                              uint32_t seq,
+                              uint32_t dropped,
+                              uint32_t view,
+                              uint32_t decim,
+                              uint32_t num_values,
+                              DataType_t data_type,
+                              TransferMode_t transferMode,
+                              uint32_t crc);
+
 #endif /* DATA_TRANSPORT_SIGNAL_TRANSFER_H_ */
@@ -0,0 +1,139 @@
+/*
+ * spectrum_stream.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Frame pacing, drop accounting and view reduction of the spectrum stream.
+ *      See spectrum_stream.h.
+ */
+
+#include "spectrum_stream.h"
+
+#define THROUGHPUT_SHIFT    2U      /* smoothing: new = old + (sample - old) / 4 */
+
+/**
+ * @brief  Wire size of one value: raw bytes in binary mode, typical "%.6f," / "%u," width in ASCII.
+ */
+static uint32_t value_bytes(DataType_t dataType, TransferMode_t transferMode)
+{
+    if (transferMode == TRANSFER_BINARY) {
+        return (dataType == DATA_TYPE_FLOAT32) ? 4U : 2U;
+    }
+    return (dataType == DATA_TYPE_FLOAT32) ? 12U : 7U;
+}
+
+void spec_stream_pacer_init(SpecStreamPacer_t *pPacer, uint32_t periodMs_u32, uint32_t nowMs_u32, uint32_t linkBaud_u32)
+{
+    *pPacer = (SpecStreamPacer_t){ 0 };
+    pPacer->periodMs_u32     = (periodMs_u32 == 0U) ? 1U : periodMs_u32;
+    pPacer->startMs_u32      = nowMs_u32;
+    pPacer->bytesPerMsQ8_u32 = ((linkBaud_u32 / 10U) << 8U) / 1000U;   // 10 bit per byte (8N1)
+}
+
+bool spec_stream_pacer_due(SpecStreamPacer_t *pPacer, uint32_t nowMs_u32, uint32_t *pSeq_u32)
+{
+    const uint32_t slot = (nowMs_u32 - pPacer->startMs_u32) / pPacer->periodMs_u32;
+
+    if (!pPacer->started) {
+        pPacer->started = true;
+    } else if (slot == pPacer->lastSlot_u32) {
+        return false;
+    } else {
+        pPacer->dropped_u32 += slot - pPacer->lastSlot_u32 - 1U;   // slots that passed without a frame
+    }
+
+    pPacer->lastSlot_u32 = slot;
+    *pSeq_u32 = slot;
+    return true;
+}
+
+void spec_stream_pacer_drop(SpecStreamPacer_t *pPacer)
+{
+    pPacer->dropped_u32++;
+}
+
+void spec_stream_pacer_sent(SpecStreamPacer_t *pPacer, uint32_t bytes_u32, uint32_t txMs_u32, SpecView_t view)
+{
+    pPacer->sent_u32++;
+    if ((view == SPEC_VIEW_DECIM) || (view == SPEC_VIEW_DELTA)) {
+        pPacer->reduced_u32++;
+    }
+
+    // Frames shorter than a tick carry no usable rate information
+    if (txMs_u32 >= 2U) {
+        const int32_t sampleQ8 = (int32_t)((bytes_u32 << 8U) / txMs_u32);
+        const int32_t oldQ8    = (int32_t)pPacer->bytesPerMsQ8_u32;
+        int32_t newQ8 = oldQ8 + ((sampleQ8 - oldQ8) >> THROUGHPUT_SHIFT);
+        pPacer->bytesPerMsQ8_u32 = (newQ8 > 0) ? (uint32_t)newQ8 : 1U;
+    }
+}
+
+uint32_t spec_stream_frame_budget(const SpecStreamPacer_t *pPacer)
+{
+    const uint64_t perPeriodQ8 = (uint64_t)pPacer->bytesPerMsQ8_u32 * pPacer->periodMs_u32;
+    return (uint32_t)(((perPeriodQ8 * SPEC_STREAM_TX_DUTY_PCT) / 100U) >> 8U);
+}
+
+uint32_t spec_stream_frame_bytes(uint32_t numValues_u32, DataType_t dataType, TransferMode_t transferMode)
+{
+    return SPEC_STREAM_HEADER_BYTES + (numValues_u32 * value_bytes(dataType, transferMode));
+}
+
+uint32_t spec_stream_delta_capacity(uint32_t budget_u32, DataType_t dataType, TransferMode_t transferMode)
+{
+    if (budget_u32 <= SPEC_STREAM_HEADER_BYTES) {
+        return 0U;
+    }
+    // Each entry is one uint16 index plus one value
+    const uint32_t entryBytes = value_bytes(DATA_TYPE_UINT16, transferMode) + value_bytes(dataType, transferMode);
+    return (budget_u32 - SPEC_STREAM_HEADER_BYTES) / entryBytes;
+}
+
+uint32_t spec_stream_select_decim(uint32_t numBins_u32, uint32_t budget_u32, DataType_t dataType, TransferMode_t transferMode)
+{
+    for (uint32_t decim = 1U; decim <= SPEC_STREAM_MAX_DECIM; decim <<= 1U) {
+        const uint32_t outBins = (numBins_u32 + decim - 1U) / decim;
+        if (spec_stream_frame_bytes(outBins, dataType, transferMode) <= budget_u32) {
+            return decim;
+        }
+    }
+    return SPEC_STREAM_MAX_DECIM;
+}
+
+uint32_t spec_stream_decimate_max(const float32_t *pIn, float32_t *pOut, uint32_t numBins_u32, uint32_t decim_u32)
+{
+    uint32_t outBins = 0U;
+
+    for (uint32_t i = 0U; i < numBins_u32; i += decim_u32) {
+        const uint32_t end = ((i + decim_u32) < numBins_u32) ? (i + decim_u32) : numBins_u32;
+        float32_t maxVal = pIn[i];
+        for (uint32_t k = i + 1U; k < end; ++k) {
+            if (pIn[k] > maxVal) {
+                maxVal = pIn[k];
+            }
+        }
+        pOut[outBins++] = maxVal;   // outBins <= i, so in-place is safe
+    }
+    return outBins;
+}
+
+uint32_t spec_stream_changed_bins(const float32_t *pMag, const float32_t *pRef, uint32_t numBins_u32, float32_t thr,
+                                  uint16_t *pIdx_u16, float32_t *pVal, uint32_t maxChanged_u32)
+{
+    uint32_t numChanged = 0U;
+
+    for (uint32_t i = 0U; i < numBins_u32; ++i) {
+        const float32_t diff = pMag[i] - pRef[i];
+        if ((diff > thr) || (diff < -thr)) {
+            if (numChanged == maxChanged_u32) {
+                return maxChanged_u32 + 1U;
+            }
+            pIdx_u16[numChanged] = (uint16_t)i;
+            pVal[numChanged]     = pMag[i];
+            numChanged++;
+        }
+    }
+    return numChanged;
+}
@@ -0,0 +1,144 @@
+/*
+ * spectrum_stream.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Frame pacing and bandwidth reduction for the continuous spectrum stream
+ *      (START_STREAM / STOP_STREAM).
+ *
+ *      Pacing:
+ *          Frames are scheduled on a fixed grid t0 + k * period. The sequence number of
+ *          a frame is its slot index k. When the link or the processing is too slow and
+ *          slots pass without a frame, they are counted as dropped, the host sees the
+ *          same gap in the sequence numbers.
+ *
+ *      Back-pressure:
+ *          The link throughput is measured on every frame (bytes / ms, smoothed). The
+ *          byte budget of one frame is a fixed share of what the link moves in one period.
+ *          A spectrum that does not fit is reduced:
+ *              - SPEC_VIEW_DELTA : only bins that changed by more than a threshold
+ *                                  since the last full frame (index + value pairs)
+ *              - SPEC_VIEW_DECIM : max-hold decimation by 2, 4, 8, ... (peaks survive)
+ *
+ *      No hardware access in this module: time and byte counts are passed in, so the
+ *      accounting can be driven by a simulated, rate-limited link.
+ */
+
+#ifndef DATA_TRANSPORT_SPECTRUM_STREAM_H_
+#define DATA_TRANSPORT_SPECTRUM_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arm_math_include.h"
+#include "signal_transfer.h"
+
+#define SPEC_STREAM_TX_DUTY_PCT     75U     /* share of a period the link may be busy */
+#define SPEC_STREAM_HEADER_BYTES    160U    /* estimated size of the JSON frame header */
+#define SPEC_STREAM_MAX_DECIM       64U
+
+/** @brief Representation of the bins in one frame */
+typedef enum {
+    SPEC_VIEW_FULL = 0,     /**< all bins */
+    SPEC_VIEW_DECIM,        /**< max-hold over groups of decim bins */
+    SPEC_VIEW_DELTA         /**< changed bins only: uint16 indices followed by values */
+} SpecView_t;
+
+/** @brief Frame scheduler and link statistics */
+typedef struct {
+    uint32_t periodMs_u32;      /**< frame period */
+    uint32_t startMs_u32;       /**< time of slot 0 */
+    uint32_t lastSlot_u32;      /**< slot of the last emitted (or dropped) frame */
+    bool     started;           /**< false until the first frame was emitted */
+    uint32_t sent_u32;          /**< frames sent */
+    uint32_t dropped_u32;       /**< slots without a frame */
+    uint32_t reduced_u32;       /**< frames sent as DECIM or DELTA view */
+    uint32_t bytesPerMsQ8_u32;  /**< measured link throughput [bytes/ms], Q24.8 */
+} SpecStreamPacer_t;
+
+/**
+ * @brief  Reset the pacer.
+ *
+ * @param[in] pPacer        Pacer instance.
+ * @param[in] periodMs_u32  Frame period [ms] (> 0).
+ * @param[in] nowMs_u32     Current time, becomes slot 0.
+ * @param[in] linkBaud_u32  Nominal link baud rate, initial throughput estimate (8N1).
+ */
+void spec_stream_pacer_init(SpecStreamPacer_t *pPacer, uint32_t periodMs_u32, uint32_t nowMs_u32, uint32_t linkBaud_u32);
+
+/**
+ * @brief  Check whether a frame is due and account for missed slots.
+ *
+ * @param[in]  pPacer     Pacer instance.
+ * @param[in]  nowMs_u32  Current time.
+ * @param[out] pSeq_u32   Sequence number (slot index) of the due frame.
+ * @return true if a new slot has started since the last frame. Slots between the
+ *         last frame and this one are added to dropped_u32.
+ */
+bool spec_stream_pacer_due(SpecStreamPacer_t *pPacer, uint32_t nowMs_u32, uint32_t *pSeq_u32);
+
+/**
+ * @brief  Record a due frame that could not be produced (e.g. acquisition failed).
+ */
+void spec_stream_pacer_drop(SpecStreamPacer_t *pPacer);
+
+/**
+ * @brief  Record a sent frame and update the throughput estimate.
+ *
+ * @param[in] pPacer      Pacer instance.
+ * @param[in] bytes_u32   Bytes written for the frame.
+ * @param[in] txMs_u32    Time the write blocked [ms].
+ * @param[in] view        View used for the frame.
+ */
+void spec_stream_pacer_sent(SpecStreamPacer_t *pPacer, uint32_t bytes_u32, uint32_t txMs_u32, SpecView_t view);
+
+/**
+ * @brief  Byte budget of one frame at the current throughput estimate.
+ */
+uint32_t spec_stream_frame_budget(const SpecStreamPacer_t *pPacer);
+
+/**
+ * @brief  Estimated wire size of numValues samples (plus the frame header).
+ */
+uint32_t spec_stream_frame_bytes(uint32_t numValues_u32, DataType_t dataType, TransferMode_t transferMode);
+
+/**
+ * @brief  Number of changed bins a SPEC_VIEW_DELTA frame can carry within the budget.
+ */
+uint32_t spec_stream_delta_capacity(uint32_t budget_u32, DataType_t dataType, TransferMode_t transferMode);
+
+/**
+ * @brief  Smallest power-of-two decimation whose frame fits the budget.
+ * @return 1 if the full spectrum fits. If not even SPEC_STREAM_MAX_DECIM fits, that is
+ *         returned anyway: the frame then outlasts its slot and the following slots are
+ *         accounted as dropped, while the throughput estimate keeps being updated.
+ */
+uint32_t spec_stream_select_decim(uint32_t numBins_u32, uint32_t budget_u32, DataType_t dataType, TransferMode_t transferMode);
+
+/**
+ * @brief  Max-hold decimation, in place allowed (pOut == pIn).
+ * @return Number of output bins (numBins / decim, rounded up).
+ */
+uint32_t spec_stream_decimate_max(const float32_t *pIn, float32_t *pOut, uint32_t numBins_u32, uint32_t decim_u32);
+
+/**
+ * @brief  Collect the bins that differ from the reference by more than thr.
+ *
+ * Stops after maxChanged_u32 entries and returns maxChanged_u32 + 1 to signal
+ * that the delta view does not fit. The reference is not modified.
+ *
+ * @param[in]  pMag         Current magnitude spectrum.
+ * @param[in]  pRef         Spectrum the host holds.
+ * @param[in]  numBins_u32  Number of bins.
+ * @param[in]  thr          Change threshold (same unit as the spectrum).
+ * @param[out] pIdx_u16     Indices of the changed bins.
+ * @param[out] pVal         Values of the changed bins.
+ * @param[in]  maxChanged_u32 Capacity of pIdx_u16 / pVal.
+ * @return Number of changed bins.
+ */
+uint32_t spec_stream_changed_bins(const float32_t *pMag, const float32_t *pRef, uint32_t numBins_u32, float32_t thr,
+                                  uint16_t *pIdx_u16, float32_t *pVal, uint32_t maxChanged_u32);
+
+#endif /* DATA_TRANSPORT_SPECTRUM_STREAM_H_ */
@@ -1,23 +1,41 @@
 #include "fft_utils.h"
+#include "signal_memory.h"
 
-// List of CMSIS-DSP supported FFT lengths (must be power-of-two)
-static const uint16_t supported_fft_lengths[] = {
-    16, 32, 64, 128, 256, 512, 1024, 2048, 4096
+// List of supported FFT lengths (must be power-of-two).
+// Up to 4096 CMSIS-DSP arm_rfft_fast_f32 is used directly, 8192 is built from a
+// 4096-point complex FFT plus a split stage (see fft_real_f32()).
+// 16 is not listed: arm_rfft_fast_init_f32() of the linked v1.4.x library rejects it.
+static const uint32_t supported_fft_lengths[] = {
+    32, 64, 128, 256, 512, 1024, 2048, 4096,
+#if (MAX_SIG_LEN >= 8192U)
+    8192
+#endif
 };
 
 #define NUM_SUPPORTED_LENGTHS (sizeof(supported_fft_lengths)/sizeof(supported_fft_lengths[0]))
 
+#if (FFT_MAX_LEN > FFT_CMSIS_RFFT_MAX_LEN)
+/**
+ * @brief Quarter-wave cosine table for the real-FFT split stage: cos(2πk/N), k = 0..N/4.
+ *
+ * 8 KB for N = 8192. CPU-only, placed in CCM next to the other FFT working sets;
+ * filled on the first FFT_MAX_LEN transform.
+ */
+static float32_t fftSplitCos_f32[(FFT_MAX_LEN / 4U) + 1U] MEM_CCM_BSS;
+static bool fftSplitCosValid = false;
+#endif
+
 // Internal: round down to next power of two
-static uint16_t round_down_pow2(uint16_t n) {
-    uint16_t p = 1;
-    while (p * 2 <= n)
+static uint32_t round_down_pow2(uint32_t n) {
+    uint32_t p = 1;
+    while ((p * 2U != 0U) && (p * 2U <= n))
         p *= 2;
     return p;
 }
 
 // Public: check if FFT length is supported
-bool is_valid_fft_length(uint16_t len) {
-    for (uint16_t i = 0; i < NUM_SUPPORTED_LENGTHS; ++i) {
+bool is_valid_fft_length(uint32_t len) {
+    for (uint32_t i = 0; i < NUM_SUPPORTED_LENGTHS; ++i) {
         if (supported_fft_lengths[i] == len)
             return true;
     }
@@ -25,8 +43,8 @@ bool is_valid_fft_length(uint16_t len) {
 }
 
 // Public: get best supported FFT length <= requested
-uint16_t get_supported_fft_length(uint16_t requested_len) {
-    uint16_t pow2_len = round_down_pow2(requested_len);
+uint32_t get_supported_fft_length(uint32_t requested_len) {
+    uint32_t pow2_len = round_down_pow2(requested_len);
 
     // Search backwards from pow2_len
     for (int i = NUM_SUPPORTED_LENGTHS - 1; i >= 0; --i) {
@@ -38,6 +56,120 @@ uint16_t get_supported_fft_length(uint16_t requested_len) {
     return supported_fft_lengths[0];
 }
 
+// Public: number of supported FFT lengths and access by index (for reports)
+uint32_t get_num_supported_fft_lengths(void) {
+    return (uint32_t)NUM_SUPPORTED_LENGTHS;
+}
+
+uint32_t get_supported_fft_length_at(uint32_t idx) {
+    return (idx < NUM_SUPPORTED_LENGTHS) ? supported_fft_lengths[idx] : 0U;
+}
+
+/**
+ * @brief Initialize a real FFT instance for any supported length.
+ *
+ * @param[out] S       Instance to initialize.
+ * @param[in]  fftLen  FFT length, must pass is_valid_fft_length().
+ * @return ARM_MATH_SUCCESS or ARM_MATH_ARGUMENT_ERROR for unsupported lengths.
+ */
+arm_status fft_real_init_f32(FftReal_Instance_f32 *S, uint32_t fftLen)
+{
+    if (!is_valid_fft_length(fftLen)) {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLen_u32 = fftLen;
+
+    if (fftLen <= FFT_CMSIS_RFFT_MAX_LEN) {
+        return arm_rfft_fast_init_f32(&S->rfft, (uint16_t)fftLen);
+    }
+
+#if (FFT_MAX_LEN > FFT_CMSIS_RFFT_MAX_LEN)
+    if (!fftSplitCosValid) {
+        for (uint32_t k = 0U; k <= (FFT_MAX_LEN / 4U); ++k) {
+            fftSplitCos_f32[k] = cosf((2.0f * PI * (float32_t)k) / (float32_t)FFT_MAX_LEN);
+        }
+        fftSplitCosValid = true;
+    }
+    return ARM_MATH_SUCCESS;
+#else
+    return ARM_MATH_ARGUMENT_ERROR;
+#endif
+}
+
+#if (FFT_MAX_LEN > FFT_CMSIS_RFFT_MAX_LEN)
+/**
+ * @brief Real FFT of FFT_MAX_LEN points via a half-length complex FFT.
+ *
+ * The N real samples are treated as N/2 complex samples z[n] = x[2n] + j·x[2n+1],
+ * transformed in place with arm_cfft_f32() and separated into the spectrum of x:
+ *
+ *   X[k] = E[k] + W^k·O[k],  W = e^(-j2π/N)
+ *   E[k] = ( Z[k] + Z*[N/2-k] ) / 2
+ *   O[k] = ( Z[k] - Z*[N/2-k] ) / 2j
+ *
+ * The output is packed like arm_rfft_fast_f32(): pOut[0] = X[0] (DC), pOut[1] = X[N/2]
+ * (Nyquist), followed by Re/Im of X[1] .. X[N/2-1].
+ */
+static void fft_real_split_f32(float32_t *pIn, float32_t *pOut)
+{
+    const uint32_t N    = FFT_MAX_LEN;
+    const uint32_t half = N / 2U;
+    const uint32_t quarter = N / 4U;
+
+    arm_cfft_f32(&arm_cfft_sR_f32_len4096, pIn, 0U, 1U);
+
+    pOut[0] = pIn[0] + pIn[1];
+    pOut[1] = pIn[0] - pIn[1];
+
+    for (uint32_t k = 1U; k < half; ++k) {
+        const float32_t ar = pIn[2U * k];
+        const float32_t ai = pIn[(2U * k) + 1U];
+        const float32_t br = pIn[2U * (half - k)];
+        const float32_t bi = pIn[(2U * (half - k)) + 1U];
+
+        // cos/sin of 2πk/N from the quarter-wave table
+        float32_t c, sn;
+        if (k <= quarter) {
+            c  = fftSplitCos_f32[k];
+            sn = fftSplitCos_f32[quarter - k];
+        } else {
+            c  = -fftSplitCos_f32[half - k];
+            sn =  fftSplitCos_f32[k - quarter];
+        }
+
+        const float32_t er = 0.5f * (ar + br);
+        const float32_t ei = 0.5f * (ai - bi);
+        const float32_t or_ = 0.5f * (ai + bi);
+        const float32_t oi = 0.5f * (br - ar);
+
+        // W^k = c - j·sn
+        pOut[2U * k]        = er + (c * or_) + (sn * oi);
+        pOut[(2U * k) + 1U] = ei + (c * oi) - (sn * or_);
+    }
+}
+#endif
+
+/**
+ * @brief Real forward FFT for any supported length.
+ *
+ * Same contract as arm_rfft_fast_f32(): pIn is used as scratch and overwritten,
+ * pOut receives fftLen packed floats.
+ *
+ * @param[in]     S     Instance initialized with fft_real_init_f32().
+ * @param[in,out] pIn   fftLen real input samples (destroyed).
+ * @param[out]    pOut  fftLen floats, packed complex spectrum.
+ */
+void fft_real_f32(FftReal_Instance_f32 *S, float32_t *pIn, float32_t *pOut)
+{
+    if (S->fftLen_u32 <= FFT_CMSIS_RFFT_MAX_LEN) {
+        arm_rfft_fast_f32(&S->rfft, pIn, pOut, 0);
+        return;
+    }
+#if (FFT_MAX_LEN > FFT_CMSIS_RFFT_MAX_LEN)
+    fft_real_split_f32(pIn, pOut);
+#endif
+}
+
 /**
  * @brief Apply a Blackman window to a float32 signal array.
  *
@@ -52,29 +184,45 @@ uint16_t get_supported_fft_length(uint16_t requested_len) {
  *   - n is the current sample index (0 to N-1)
  *   - a0 = 0.42, a1 = 0.5, a2 = 0.08
  *
+ * The window is symmetric (w(n) = w(N-1-n)), so only the first half is computed and
+ * kept in the CCM cache sigWINDOW_CACHE. The cosines are only evaluated again when
+ * the length changes; repeated calls with the same length are a plain multiply.
+ *
  * @param[in,out] data   Pointer to float32 signal array to apply the window on
- * @param[in]     length Number of elements in the signal array
+ * @param[in]     length Number of elements in the signal array (<= MAX_SIG_LEN)
  */
 void apply_blackman_window(float32_t *data, uint32_t length)
 {
-    // Define Blackman window coefficients
-    const float32_t a0 = 0.42f;
-    const float32_t a1 = 0.50f;
-    const float32_t a2 = 0.08f;
+    static uint32_t cachedLength = 0U;
+
+    if ((length < 2U) || (length > MAX_SIG_LEN)) {
+        return;
+    }
 
-    // Precompute denominator (N-1) to avoid redundant computation
-    const float32_t N_minus_1 = (float32_t)(length - 1);
+    const uint32_t half = length / 2U;
 
-    for (uint32_t i = 0; i < length; i++) {
-        // Convert index to float for calculation
-        float32_t n = (float32_t)i;
+    if (cachedLength != length) {
+        // Define Blackman window coefficients
+        const float32_t a0 = 0.42f;
+        const float32_t a1 = 0.50f;
+        const float32_t a2 = 0.08f;
 
-        // Calculate the Blackman window value at index n
-        float32_t w = a0
-                    - a1 * cosf((2.0f * PI * n) / N_minus_1)
-                    + a2 * cosf((4.0f * PI * n) / N_minus_1);
+        // Precompute denominator (N-1) to avoid redundant computation
+        const float32_t N_minus_1 = (float32_t)(length - 1);
+
+        for (uint32_t i = 0; i < half; i++) {
+            float32_t n = (float32_t)i;
+            sigWINDOW_CACHE[i] = a0
+                               - a1 * cosf((2.0f * PI * n) / N_minus_1)
+                               + a2 * cosf((4.0f * PI * n) / N_minus_1);
+        }
+        cachedLength = length;
+    }
 
-        // Apply the window to the data in-place
-        data[i] *= w;
+    // Apply both halves from the cached table; for odd N the centre weight is 1.0
+    for (uint32_t i = 0; i < half; i++) {
+        const float32_t w = sigWINDOW_CACHE[i];
+        data[i]              *= w;
+        data[length - 1U - i] *= w;
     }
 }
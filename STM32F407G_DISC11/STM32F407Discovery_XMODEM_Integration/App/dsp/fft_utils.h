@@ -6,8 +6,24 @@
 
 #include "arm_math_include.h"
 
-uint16_t get_supported_fft_length(uint16_t requested_len);
-bool is_valid_fft_length(uint16_t len);
+/* Largest length CMSIS-DSP arm_rfft_fast_f32 (v1.4.x) supports directly */
+#define FFT_CMSIS_RFFT_MAX_LEN   4096U
+/* Largest supported FFT length (bounded by the sample buffers, see signal_memory.h) */
+#define FFT_MAX_LEN              8192U
+
+/** @brief Real FFT instance covering CMSIS lengths and the 8192 split-stage transform */
+typedef struct {
+    uint32_t                   fftLen_u32;  /**< FFT length */
+    arm_rfft_fast_instance_f32 rfft;        /**< used for fftLen <= FFT_CMSIS_RFFT_MAX_LEN */
+} FftReal_Instance_f32;
+
+uint32_t get_supported_fft_length(uint32_t requested_len);
+bool is_valid_fft_length(uint32_t len);
+uint32_t get_num_supported_fft_lengths(void);
+uint32_t get_supported_fft_length_at(uint32_t idx);
+
+arm_status fft_real_init_f32(FftReal_Instance_f32 *S, uint32_t fftLen);
+void fft_real_f32(FftReal_Instance_f32 *S, float32_t *pIn, float32_t *pOut);
 
 void apply_blackman_window(float32_t *data, uint32_t length);
 
@@ -0,0 +1,32 @@
+/*
+ * filter_utils.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ */
+
+#include "filter_utils.h"
+#include "signal_memory.h"
+
+bool apply_fir_filter_f32(const float32_t *pCoeffs, uint16_t numTaps, float32_t *pData, uint32_t length)
+{
+    if ((numTaps == 0U) || (numTaps > MAX_NUM_FILTER_TAPS)) {
+        return false;
+    }
+
+    arm_fir_instance_f32 fir;
+    arm_fir_init_f32(&fir, numTaps, (float32_t *)pCoeffs, sigFIR_STATE, FIR_BLOCK_SIZE);
+
+    // The CMSIS FIR keeps its delay line across calls, so consecutive blocks
+    // produce exactly the same output as one call over the whole buffer.
+    uint32_t offset = 0U;
+    while (offset < length) {
+        uint32_t block = length - offset;
+        if (block > FIR_BLOCK_SIZE) {
+            block = FIR_BLOCK_SIZE;
+        }
+        arm_fir_f32(&fir, &pData[offset], &pData[offset], block);
+        offset += block;
+    }
+    return true;
+}
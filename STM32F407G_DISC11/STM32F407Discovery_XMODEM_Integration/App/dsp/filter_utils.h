@@ -0,0 +1,32 @@
+/*
+ * filter_utils.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Block-wise FIR filtering on top of CMSIS-DSP.
+ *      The delay line lives in CCM (sigFIR_STATE) and only needs
+ *      numTaps + FIR_BLOCK_SIZE - 1 samples, independent of the signal length.
+ */
+
+#ifndef DSP_FILTER_UTILS_H_
+#define DSP_FILTER_UTILS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arm_math_include.h"
+
+/**
+ * @brief  Apply an FIR filter in-place to a float32 signal, block by block.
+ *
+ * @param[in]     pCoeffs  Filter coefficients (time-reversed, CMSIS order).
+ * @param[in]     numTaps  Number of coefficients (<= MAX_NUM_FILTER_TAPS).
+ * @param[in,out] pData    Signal buffer, filtered in-place.
+ * @param[in]     length   Number of samples in the signal buffer.
+ * @return true on success, false if numTaps exceeds the state buffer.
+ */
+bool apply_fir_filter_f32(const float32_t *pCoeffs, uint16_t numTaps, float32_t *pData, uint32_t length);
+
+#endif /* DSP_FILTER_UTILS_H_ */
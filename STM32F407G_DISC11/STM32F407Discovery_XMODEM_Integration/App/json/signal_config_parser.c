@@ -15,6 +15,9 @@
 #include "uart_app.h"  // <-- For printToDebugUartBlocking()
 #include "signal_config_parser.h"
 
+/* Waveform of the last parsed command (referenced by config->pWave) */
+static SignalGen_Wave_t parsedWave;
+
 /**
  * @brief  Parse and validate signal generation parameters from JSON string.
  *         Now uses integer codes for data_type and transfer mode to optimize parsing.
@@ -22,7 +25,8 @@
  * @param[in]  json_str   Pointer to JSON string.
  * @param[in]  cmd_name   Command name for error reporting.
  * @param[out] config     Pointer to JsonParsedSigGenPar_HandlType_t to fill.
- * @return 0 on success, no early exits — fallback defaults on invalid fields.
+ * @return 0 on success, -1 (FAIL response sent) for invalid JSON or "sampl_rate":0;
+ *         other invalid fields fall back to defaults.
  */
 int32_t parse_and_validate_signal_config(
     const char *json_str,
@@ -56,9 +60,9 @@ int32_t parse_and_validate_signal_config(
     }
 
     /* --- len --- */
-    st = json_parse_u16(json_str, tokens, (uint32_t)tokCount_s32, "len", &config->numSamples_u16);
+    st = json_parse_u32(json_str, tokens, (uint32_t)tokCount_s32, "len", &config->numSamples_u32);
     if (st != JSON_PARSE_OK) {
-        config->numSamples_u16 = 1024U;
+        config->numSamples_u32 = 1024U;
         printToDebugUartBlocking("[DBG]: Warning: 'len' missing/invalid. Defaulting to 1024.\r\n");
     }
 
@@ -85,6 +89,9 @@ int32_t parse_and_validate_signal_config(
     if (st != JSON_PARSE_OK) {
         config->sampl_rate = 1024000U;
         printToDebugUartBlocking("[DBG]: Warning: 'sampl_rate' missing/invalid. Defaulting to 1024000.\r\n");
+    } else if (config->sampl_rate == 0U) {
+        send_uart_response(cmd_name, "FAIL", "{\"error\":\"invalid_sampl_rate\"}");
+        return -1;
     }
 
     /* --- Validate array length match --- */
@@ -95,12 +102,14 @@ int32_t parse_and_validate_signal_config(
         config->numTones_u16 = minTones;
     }
 
-    /* --- Clip numSamples --- */
-    if (config->numSamples_u16 > MAX_SIG_LEN) {
-        printToDebugUartBlocking("[DBG]: Warning: 'len'=%u exceeds max=%u. Clipping.\r\n",
-                                 (uint32_t)config->numSamples_u16,
-                                 (uint32_t)MAX_SIG_LEN);
-        config->numSamples_u16 = MAX_SIG_LEN;
+    /* --- Clip numSamples ---
+     * Lengths above MAX_SIG_LEN are valid: handlers that stream generate them block by block,
+     * handlers working on one buffer (FFT) clip to their own maximum. */
+    if (config->numSamples_u32 > SIG_STREAM_MAX_LEN) {
+        printToDebugUartBlocking("[DBG]: Warning: 'len'=%lu exceeds max=%lu. Clipping.\r\n",
+                                 (unsigned long)config->numSamples_u32,
+                                 (unsigned long)SIG_STREAM_MAX_LEN);
+        config->numSamples_u32 = SIG_STREAM_MAX_LEN;
     }
 
     /* --- Assign frequency/amp arrays --- */
@@ -147,6 +156,61 @@ int32_t parse_and_validate_signal_config(
                                  (unsigned)code_u16);
     }
 
+    /* --- wave (optional, default: sum of tones) --- */
+    parse_wave_config(json_str, tokens, tokCount_s32, config);
+
     return 0;
 }
 
+/**
+ * @brief  Parse the optional waveform fields into parsedWave and link it to config->pWave.
+ *
+ *         - "wave" (uint16): SignalGen_Mode_t code, default SIG_MODE_TONES.
+ *         - "phases" (array of uint16): start phase per tone, Q16 fraction of a period.
+ *         - "schroeder" (uint16): 1 = Schroeder phases (overrides "phases").
+ *         - "f1" (uint32), "sweep_len" (uint32, default 'len'): chirp end frequency and sweep length.
+ *         - "mod_freq" (uint32), "mod_depth" (uint32): AM depth in permille (max 1000) / FM deviation in Hz (max fs/2).
+ *         Tables are uploaded beforehand with SET_WAVE_TABLE.
+ */
+void parse_wave_config(const char *json_str, jsmntok_t *tokens, int32_t tokCount_s32,
+                       JsonParsedSigGenPar_HandlType_t *config)
+{
+    uint16_t code_u16 = (uint16_t)SIG_MODE_TONES;
+    size_t   parsedPhases_u32 = 0U;
+
+    parsedWave = (SignalGen_Wave_t){ .mode = SIG_MODE_TONES };
+
+    if ((json_parse_u16(json_str, tokens, tokCount_s32, "wave", &code_u16) == JSON_PARSE_OK) &&
+        (code_u16 < (uint16_t)SIG_MODE_MAX)) {
+        parsedWave.mode = (SignalGen_Mode_t)code_u16;
+    }
+
+    if ((json_parse_u16(json_str, tokens, tokCount_s32, "schroeder", &code_u16) == JSON_PARSE_OK) && (code_u16 != 0U)) {
+        SignalGen_SchroederPhases((uint8_t)config->numTones_u16, phases_int);
+        parsedWave.pTonePhases_u16 = phases_int;
+    } else if ((json_parse_array_u16(json_str, tokens, tokCount_s32, "phases", phases_int, MAX_TONES,
+                                     &parsedPhases_u32) == JSON_PARSE_OK) && (parsedPhases_u32 > 0U)) {
+        for (size_t k = parsedPhases_u32; k < MAX_TONES; ++k) {
+            phases_int[k] = 0U;     // missing phases start at 0
+        }
+        parsedWave.pTonePhases_u16 = phases_int;
+    }
+
+    if (json_parse_u32(json_str, tokens, tokCount_s32, "f1", &parsedWave.f1_u32) != JSON_PARSE_OK) {
+        parsedWave.f1_u32 = config->sampl_rate / 2U;
+    }
+    if (json_parse_u32(json_str, tokens, tokCount_s32, "sweep_len", &parsedWave.sweepLen_u32) != JSON_PARSE_OK) {
+        parsedWave.sweepLen_u32 = config->numSamples_u32;
+    }
+    (void)json_parse_u32(json_str, tokens, tokCount_s32, "mod_freq", &parsedWave.modFreq_u32);
+    (void)json_parse_u32(json_str, tokens, tokCount_s32, "mod_depth", &parsedWave.modDepth_u32);
+
+    parsedWave.pTable_s16   = sigWAVE_TABLE;
+    parsedWave.tableLen_u16 = sigWaveTableLen_u16;
+    if ((parsedWave.mode == SIG_MODE_TABLE) && (sigWaveTableLen_u16 == 0U)) {
+        printToDebugUartBlocking("[DBG]: Warning: 'wave'=table but no table loaded (SET_WAVE_TABLE). Using tone 0.\r\n");
+    }
+
+    config->pWave = &parsedWave;
+}
+
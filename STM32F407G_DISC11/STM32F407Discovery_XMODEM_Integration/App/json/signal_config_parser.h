@@ -8,6 +8,10 @@
 #ifndef JSON_SIGNAL_CONFIG_PARSER_H_
 #define JSON_SIGNAL_CONFIG_PARSER_H_
 
+#include "json_utils.h"
+#include "signal_transfer.h"
+
 int32_t parse_and_validate_signal_config(const char *json_str, const char *cmd_name, JsonParsedSigGenPar_HandlType_t *config);
+void parse_wave_config(const char *json_str, jsmntok_t *tokens, int32_t tokCount_s32, JsonParsedSigGenPar_HandlType_t *config);
 
 #endif /* JSON_SIGNAL_CONFIG_PARSER_H_ */
@@ -0,0 +1,80 @@
+/*
+ * mem_placement.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Placement rules for DMA-visible and CPU-only buffers.
+ *      The classification functions only work on a MemMap_t description, so the
+ *      same rules can be evaluated against a simulated memory map.
+ */
+
+#include "mem_placement.h"
+#include "main.h"
+#include "uart_app.h"
+
+static const MemRegionDesc_t memRegionsF407[] = {
+    { MEM_FLASH_START, MEM_FLASH_SIZE, MEM_REGION_FLASH, true  },
+    { MEM_CCM_START,   MEM_CCM_SIZE,   MEM_REGION_CCM,   false },
+    { MEM_SRAM_START,  MEM_SRAM_SIZE,  MEM_REGION_SRAM,  true  },
+};
+
+const MemMap_t memMapF407 = {
+    .pRegions      = memRegionsF407,
+    .numRegions_u8 = (uint8_t)(sizeof(memRegionsF407) / sizeof(memRegionsF407[0]))
+};
+
+/* Map mem_assert_dma_buffer() checks against */
+static const MemMap_t *pActiveMap = &memMapF407;
+
+/**
+ * @brief  Find the region descriptor containing the complete address range.
+ * @return Pointer to the descriptor, or NULL if no single region holds the range.
+ */
+static const MemRegionDesc_t *mem_find_region(const MemMap_t *map, uintptr_t addr, uint32_t len)
+{
+    if ((map == NULL) || (len == 0U) || ((uint64_t)addr > 0xFFFFFFFFULL)) {
+        return NULL;    /* the map is 32-bit, so is every target address */
+    }
+
+    for (uint8_t i = 0U; i < map->numRegions_u8; ++i) {
+        const MemRegionDesc_t *r = &map->pRegions[i];
+        uint32_t offset = (uint32_t)addr - r->start_u32;
+
+        /* Unsigned offset arithmetic rejects addresses below start as well */
+        if (((uint32_t)addr >= r->start_u32) && (offset < r->size_u32) && (len <= (r->size_u32 - offset))) {
+            return r;
+        }
+    }
+    return NULL;
+}
+
+MemRegion_t mem_classify(const MemMap_t *map, uintptr_t addr, uint32_t len)
+{
+    const MemRegionDesc_t *r = mem_find_region(map, addr, len);
+    return (r != NULL) ? r->region : MEM_REGION_UNKNOWN;
+}
+
+bool mem_is_dma_capable(const MemMap_t *map, uintptr_t addr, uint32_t len)
+{
+    const MemRegionDesc_t *r = mem_find_region(map, addr, len);
+    return (r != NULL) && r->dmaCapable;
+}
+
+void mem_set_map(const MemMap_t *map)
+{
+    pActiveMap = (map != NULL) ? map : &memMapF407;
+}
+
+void mem_assert_dma_buffer(const volatile void *pBuf, uint32_t len, const char *tag)
+{
+    if (mem_is_dma_capable(pActiveMap, (uintptr_t)pBuf, len)) {
+        return;
+    }
+
+    printToDebugUartBlocking("[DBG] [Error] DMA buffer <%s> @0x%08lX (%lu bytes) is not DMA-reachable (region %u).\r\n",
+                             tag, (unsigned long)(uintptr_t)pBuf, (unsigned long)len,
+                             (unsigned)mem_classify(pActiveMap, (uintptr_t)pBuf, len));
+    Error_Handler();
+}
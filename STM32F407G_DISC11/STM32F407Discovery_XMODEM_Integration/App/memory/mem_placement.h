@@ -0,0 +1,106 @@
+/*
+ * mem_placement.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Linker-section placement API for the STM32F407 memory map.
+ *
+ *      The F407 has 64 KB of core-coupled memory (CCM) next to the 128 KB main SRAM.
+ *      CCM sits on the CPU D-bus only: it is the fastest place for DSP working sets
+ *      and it is never contended by the DMA controllers, but DMA can NOT reach it.
+ *
+ *      Placement rules:
+ *          - MEM_CCM_BSS : CPU-only working sets (FFT scratch, window cache, FIR state,
+ *                          twiddles). Section is NOLOAD, contents are undefined after reset.
+ *          - MEM_DMA_BSS : anything a DMA stream reads or writes (UART RX/TX, ADC, I2S).
+ *                          Always main SRAM.
+ *
+ *      Every DMA buffer must be checked once with mem_assert_dma_buffer() before the
+ *      first transfer is started. A violation halts the firmware via Error_Handler().
+ */
+
+#ifndef MEMORY_MEM_PLACEMENT_H_
+#define MEMORY_MEM_PLACEMENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* --- Section attributes (see STM32F407VGTX_FLASH.ld) --- */
+#define MEM_CCM_BSS     __attribute__((section(".ccmram_bss"), aligned(4)))
+#define MEM_DMA_BSS     __attribute__((aligned(4)))
+
+/* --- F407 address map --- */
+#define MEM_FLASH_START     0x08000000UL
+#define MEM_FLASH_SIZE      (1024UL * 1024UL)
+#define MEM_CCM_START       0x10000000UL
+#define MEM_CCM_SIZE        (64UL * 1024UL)
+#define MEM_SRAM_START      0x20000000UL
+#define MEM_SRAM_SIZE       (128UL * 1024UL)
+
+/** @brief Memory region a buffer resides in */
+typedef enum {
+    MEM_REGION_FLASH = 0,
+    MEM_REGION_CCM,
+    MEM_REGION_SRAM,
+    MEM_REGION_UNKNOWN
+} MemRegion_t;
+
+/** @brief One contiguous address range of the memory map */
+typedef struct {
+    uint32_t    start_u32;      /**< first address of the region */
+    uint32_t    size_u32;       /**< region size in bytes */
+    MemRegion_t region;         /**< region identifier */
+    bool        dmaCapable;     /**< true if the DMA controllers can access it */
+} MemRegionDesc_t;
+
+/** @brief Memory map description (target map or a simulated one) */
+typedef struct {
+    const MemRegionDesc_t *pRegions;
+    uint8_t               numRegions_u8;
+} MemMap_t;
+
+/** @brief Memory map of the STM32F407VG as configured in the linker script */
+extern const MemMap_t memMapF407;
+
+/**
+ * @brief  Classify an address range against a memory map.
+ *
+ * @param[in] map   Memory map to check against.
+ * @param[in] addr  Start address of the buffer.
+ * @param[in] len   Buffer length in bytes.
+ * @return Region containing the whole range, or MEM_REGION_UNKNOWN if the range
+ *         is outside the map or straddles two regions.
+ */
+MemRegion_t mem_classify(const MemMap_t *map, uintptr_t addr, uint32_t len);
+
+/**
+ * @brief  Check whether a buffer can be used as a DMA source/destination.
+ *
+ * @param[in] map   Memory map to check against.
+ * @param[in] addr  Start address of the buffer.
+ * @param[in] len   Buffer length in bytes.
+ * @return true if the whole range lies in one DMA-capable region.
+ */
+bool mem_is_dma_capable(const MemMap_t *map, uintptr_t addr, uint32_t len);
+
+/**
+ * @brief  Select the memory map mem_assert_dma_buffer() checks against.
+ *
+ * A host build describes where its linker put the buffers; NULL restores memMapF407.
+ */
+void mem_set_map(const MemMap_t *map);
+
+/**
+ * @brief  Fail loudly if a DMA buffer is not DMA-reachable (e.g. placed in CCM).
+ *
+ * Prints the offending buffer on the debug UART and halts in Error_Handler().
+ *
+ * @param[in] pBuf  Buffer that will be handed to a DMA stream.
+ * @param[in] len   Buffer length in bytes.
+ * @param[in] tag   Buffer name used in the error message.
+ */
+void mem_assert_dma_buffer(const volatile void *pBuf, uint32_t len, const char *tag);
+
+#endif /* MEMORY_MEM_PLACEMENT_H_ */
@@ -10,6 +10,7 @@
  */
 
 #include "signal_memory.h"
+#include "uart_app.h"
 
 /* Frequency array [Hz] for tone generation */
 uint32_t freqs_int[MAX_TONES];
@@ -17,6 +18,9 @@ uint32_t freqs_int[MAX_TONES];
 /* Amplitude array [mV] for tone generation */
 uint16_t amps_int[MAX_TONES];
 
+/* Start phase array [Q16 fraction of a period] for tone generation */
+uint16_t phases_int[MAX_TONES];
+
 /**
  * @brief Shared signal buffer instance using a union for flexible data access.
  *
@@ -29,20 +33,35 @@ uint16_t amps_int[MAX_TONES];
  * Since this buffer is shared and reused across different signal operations, its contents are *not preserved*.
  * It should only be used when intermediate data does not need to be retained across function calls.
  */
-SignalBufferUnion sigBUFFER_UNION;
+SignalBufferUnion sigBUFFER_UNION MEM_DMA_BSS;
+
 /**
- * @brief Shared signal buffer instance using a union for flexible data access.
- *
- * This buffer allows shared memory access as either:
- *  - sigBUFFER_UNION.bufF32 → float32_t buffer of length MAX_SIG_LEN
- *  - sigBUFFER_UNION.bufU16 → uint16_t buffer of length MAX_SIG_LEN * 2
- *
- * Primary usage: store raw or processed time-domain signal data (e.g., for signal generation, filtering, FFT).
+ * @brief FFT scratch / spectrum output buffer.
  *
- * Since this buffer is shared and reused across different signal operations, its contents are *not preserved*.
- * It should only be used when intermediate data does not need to be retained across function calls.
+ * CPU-only working set, placed in CCM so FFT and magnitude loops do not compete
+ * with UART DMA for the SRAM bus. Must never be handed to a DMA stream.
  */
-SignalBufferUnion sigBUFFER_UNION;
+float32_t sigBUFF2[MAX_SIG_LEN] MEM_CCM_BSS;
+
+/* Half-length Blackman window cache (window is symmetric), filled on length change */
+float32_t sigWINDOW_CACHE[MAX_SIG_LEN / 2U] MEM_CCM_BSS;
 
+/* FIR delay line for block-wise filtering (numTaps + blockSize - 1) */
+float32_t sigFIR_STATE[MAX_NUM_FILTER_TAPS + FIR_BLOCK_SIZE - 1U] MEM_CCM_BSS;
 
-float32_t sigBUFF2[MAX_SIG_LEN + MAX_NUM_FILTER_TAPS];
+/* User waveform table, one period in Q15, uploaded in chunks by SET_WAVE_TABLE */
+int16_t  sigWAVE_TABLE[MAX_WAVE_TABLE_LEN] MEM_CCM_BSS;
+uint16_t sigWaveTableLen_u16 = 0U;
+
+/**
+ * @brief  Verify that every buffer handed to a DMA stream lies in DMA-reachable SRAM.
+ *
+ * Must be called once at startup before the first DMA transfer. Halts via
+ * Error_Handler() if a DMA buffer was (accidentally) placed in CCM.
+ */
+void signal_memory_check_placement(void)
+{
+    mem_assert_dma_buffer(&sigBUFFER_UNION, sizeof(sigBUFFER_UNION), "sigBUFFER_UNION");
+    mem_assert_dma_buffer(uart2_rxBuf, sizeof(uart2_rxBuf), "uart2_rxBuf");
+    mem_assert_dma_buffer(uart3_rxBuf, sizeof(uart3_rxBuf), "uart3_rxBuf");
+}
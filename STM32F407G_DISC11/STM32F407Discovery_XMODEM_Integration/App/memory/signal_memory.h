@@ -14,6 +14,10 @@
  *          - signalBuf of type SignalBufferUnion is defined to share the memory between.
  *          	- bufU16[MAX_SIG_LEN]:  Buffer for generated signal samples (ADC codes).
  *          	- bufU16[MAX_SIG_LEN]:  Buffer for generated signal samples (ADC codes).
+ *
+ *      Placement (see mem_placement.h):
+ *          - SRAM : sigBUFFER_UNION (DMA-visible: UART/XMODEM transfers, future ADC capture).
+ *          - CCM  : sigBUFF2 (FFT scratch/output), sigWINDOW_CACHE, sigFIR_STATE.
  */
 
 #ifndef SIGNAL_MEMORY_H_
@@ -21,11 +25,14 @@
 
 #include <stdint.h>
 #include "arm_math_include.h"
+#include "mem_placement.h"
 
 /* Maximum supported tone count and signal length */
 #define MAX_TONES    16
-#define MAX_SIG_LEN  (1024U * 4U)  /* 4096 samples */
+#define MAX_SIG_LEN  (1024U * 8U)  /* 8192 samples */
 #define MAX_NUM_FILTER_TAPS 256U
+#define FIR_BLOCK_SIZE      256U   /* FIR runs block-wise so its state stays small */
+#define MAX_WAVE_TABLE_LEN  1024U  /* user waveform table (SET_WAVE_TABLE), one period */
 
 
 /* Union to share memory between uint16_t and float32_t buffers */
@@ -36,11 +43,23 @@ typedef union {
 
 /* Extern shared buffer instance */
 extern SignalBufferUnion sigBUFFER_UNION;
-extern float32_t sigBUFF2[MAX_SIG_LEN + MAX_NUM_FILTER_TAPS];
+extern float32_t sigBUFF2[MAX_SIG_LEN];
+
+/* CCM working sets */
+extern float32_t sigWINDOW_CACHE[MAX_SIG_LEN / 2U];
+extern float32_t sigFIR_STATE[MAX_NUM_FILTER_TAPS + FIR_BLOCK_SIZE - 1U];
 
 /* Frequency and amplitude arrays */
 extern uint32_t freqs_int[MAX_TONES];
 extern uint16_t amps_int[MAX_TONES];
+extern uint16_t phases_int[MAX_TONES];
+
+/* User waveform table (CPU only) and its loaded length */
+extern int16_t  sigWAVE_TABLE[MAX_WAVE_TABLE_LEN];
+extern uint16_t sigWaveTableLen_u16;
+
+/* Check all DMA-visible buffers against the placement rules; halts on violation */
+void signal_memory_check_placement(void);
 
 #endif /* SIGNAL_MEMORY_H_ */
 
@@ -17,19 +17,18 @@
 #include "signal_memory.h"
 #include "uart_app.h"
 #include "parse_utils.h"
-#include "rng.h"
-
-extern RNG_HandleTypeDef hrng;
 
 
 #define SIGNAL_CONFIG_OK       (0)
 #define SIGNAL_CONFIG_FAIL     (-1)
 
+#define SIGNAL_GEN_SWEEP_ANCHOR  256U   /* log sweep: exact increment every N samples */
+
 
 float32_t generate_noise_mV(float32_t noise_amplitude_mV)
 {
     uint32_t rand_val = 0;
-    if (HAL_RNG_GenerateRandomNumber(&hrng, &rand_val) != HAL_OK) {
+    if (!platform_rng_read(&rand_val)) {
         return 0.0f;  // fallback on RNG error
     }
 
@@ -38,6 +37,413 @@ float32_t generate_noise_mV(float32_t noise_amplitude_mV)
     return rand_norm * noise_amplitude_mV;
 }
 
+/**
+ * @brief  Frequency in Hz to a phase increment per sample, Q48 fraction of a period.
+ */
+static uint64_t SignalGen_FreqToQ48(uint32_t freq_u32, uint32_t fs_u32)
+{
+    if (fs_u32 == 0U) {
+        return 0U;
+    }
+    const uint64_t num = (uint64_t)(freq_u32 % fs_u32) << 32U;
+    const uint64_t q32 = num / fs_u32;
+    return (q32 << 16U) + (((num % fs_u32) << 16U) / fs_u32);
+}
+
+/**
+ * @brief  Take over a tone set: increments and amplitudes change, the phases continue.
+ *
+ * Tones that did not exist before start at phase 0.
+ */
+static void SignalGen_ApplyTones(SignalGen_State_t *s, const SignalGen_Tones_t *pTones)
+{
+    uint8_t numTones = (pTones->numTones_u8 > MAX_TONES) ? (uint8_t)MAX_TONES : pTones->numTones_u8;
+
+    for (uint8_t k = 0U; k < numTones; ++k) {
+        uint32_t gain_u32 = ((uint32_t)pTones->amps_u16[k] << 15U) / (s->vRef_u16 / 2U);
+
+        s->phaseInc_u32[k] = pTones->freqs_u32[k] % s->samplingRate_u32;
+        s->amps_u16[k]     = pTones->amps_u16[k];
+        s->gainQ15_s32[k]  = (int32_t)((gain_u32 > 0xFFFFU) ? 0xFFFFU : gain_u32);   // >2x full scale saturates anyway
+        if (k >= s->numTones_u8) {
+            s->phaseAcc_u32[k] = 0U;
+        }
+    }
+    s->numTones_u8 = numTones;
+
+    // Fixed-frequency carriers follow tone 0
+    if ((s->mode == SIG_MODE_AM) || (s->mode == SIG_MODE_FM) || (s->mode == SIG_MODE_TABLE)) {
+        s->oscInc_u64 = (numTones > 0U) ? SignalGen_FreqToQ48(pTones->freqs_u32[0], s->samplingRate_u32) : 0U;
+    }
+}
+
+/**
+ * @brief  One sample of the carrier of the non-tone modes, Q15 (AM peaks reach 2.0).
+ *
+ * All modes advance a Q48 phase accumulator; the sine comes from arm_sin_q15() like the
+ * tone kernel, so chirps and modulated carriers use the same block loop as the tones.
+ */
+static inline int32_t SignalGen_OscStep(SignalGen_State_t *s)
+{
+    const uint32_t phase_u32 = (uint32_t)(s->oscPhase_u64 >> 16U);
+    int32_t w;
+
+    switch (s->mode) {
+        case SIG_MODE_AM: {
+            const int32_t m = arm_sin_q15((q15_t)(s->modPhase_u32 >> 17U));
+            const int32_t c = arm_sin_q15((q15_t)(phase_u32 >> 17U));
+            w = (int32_t)(((int64_t)c * (32768 + (int32_t)((s->modDepth_s64 * m) >> 15U))) >> 15U);
+            s->modPhase_u32 += s->modInc_u32;
+            s->oscPhase_u64 += s->oscInc_u64;
+            break;
+        }
+        case SIG_MODE_FM: {
+            const int32_t m = arm_sin_q15((q15_t)(s->modPhase_u32 >> 17U));
+            w = arm_sin_q15((q15_t)(phase_u32 >> 17U));
+            s->modPhase_u32 += s->modInc_u32;
+            s->oscPhase_u64 += s->oscInc_u64 + (uint64_t)((s->modDepth_s64 * m) >> 15U);
+            break;
+        }
+        case SIG_MODE_TABLE: {
+            // Table position with 32 fractional bits: integer part = index, fraction interpolates
+            const uint64_t pos   = (uint64_t)phase_u32 * s->tableLen_u16;
+            const uint32_t idx   = (uint32_t)(pos >> 32U);
+            const uint32_t next  = (idx + 1U < s->tableLen_u16) ? (idx + 1U) : 0U;
+            const int32_t  frac  = (int32_t)((uint32_t)pos >> 17U);
+            const int32_t  y0    = s->pTable_s16[idx];
+            w = y0 + (((s->pTable_s16[next] - y0) * frac) >> 15U);
+            s->oscPhase_u64 += s->oscInc_u64;
+            break;
+        }
+        default: {  // SIG_MODE_CHIRP_LIN / SIG_MODE_CHIRP_LOG
+            w = arm_sin_q15((q15_t)(phase_u32 >> 17U));
+            s->oscPhase_u64 += s->oscInc_u64;
+            if (++s->sweepPos_u32 >= s->sweepLen_u32) {
+                s->sweepPos_u32    = 0U;
+                s->oscInc_u64      = s->sweepInc0_u64;      // restart at f0, the phase continues
+                s->sweepIncQ32_f32 = (float32_t)(uint32_t)(s->sweepInc0_u64 >> 16U);
+            } else if (s->mode == SIG_MODE_CHIRP_LIN) {
+                s->oscInc_u64 += (uint64_t)s->sweepStep_s64;
+            } else {
+                // Geometric step per sample, re-anchored at fixed sweep positions so the float
+                // products cannot drift and the result does not depend on the block size
+                if ((s->sweepPos_u32 % SIGNAL_GEN_SWEEP_ANCHOR) == 0U) {
+                    s->sweepIncQ32_f32 = (float32_t)(uint32_t)(s->sweepInc0_u64 >> 16U)
+                                         * expf(s->sweepLnRatio_f32 * (float32_t)s->sweepPos_u32);
+                } else {
+                    s->sweepIncQ32_f32 *= s->sweepRatio_f32;
+                }
+                s->oscInc_u64 = (uint64_t)(uint32_t)s->sweepIncQ32_f32 << 16U;
+            }
+            break;
+        }
+    }
+    return w;
+}
+
+/**
+ * @brief  Float kernel: mV samples (with optional noise) and/or ADC codes scaled in float.
+ */
+static void SignalGen_KernelF32(SignalGen_State_t *s, uint32_t numSamples, float32_t *pOut_f32, uint16_t *pOut_u16)
+{
+    const uint32_t fs_u32 = s->samplingRate_u32;
+
+    // Phase angle per tick: θ = 2π·(phaseAcc / fs)
+    const float32_t radPerTick_f32 = (2.0f * PI) / (float32_t)fs_u32;
+
+    // Loop through each sample to generate the composite waveform
+    for (uint32_t i = 0U; i < numSamples; ++i) {
+
+        // Start with DC offset (in mV)
+        float32_t sum_mV = (float32_t)s->dcOffset_u16;
+
+        if (s->mode != SIG_MODE_TONES) {
+            sum_mV += (float32_t)s->amps_u16[0] * (float32_t)SignalGen_OscStep(s) * (1.0f / 32768.0f);
+        }
+
+        // Loop over each sine tone and add its contribution
+        for (uint8_t k = 0U; (s->mode == SIG_MODE_TONES) && (k < s->numTones_u8); ++k) {
+
+            // Compute the sine wave phase angle θ = 2π·f·t, with f·t kept modulo one period
+            float32_t angle_f32 = radPerTick_f32 * (float32_t)s->phaseAcc_u32[k];
+
+            // Advance the tone phase by one sample and wrap at one period
+            s->phaseAcc_u32[k] += s->phaseInc_u32[k];
+            if (s->phaseAcc_u32[k] >= fs_u32) {
+                s->phaseAcc_u32[k] -= fs_u32;
+            }
+
+            // Compute the sine wave value using CMSIS or standard math library
+            float32_t s_f32 = (s->sineMethod == SINE_METHOD_CMSIS)
+                                ? arm_sin_f32(angle_f32)
+                                : sinf(angle_f32);
+
+            // Multiply sine by its amplitude (in mV) and add to sum
+            sum_mV += (float32_t)s->amps_u16[k] * s_f32;
+        }
+
+        // If float32 output is requested, store result in float buffer
+        if (pOut_f32 != NULL) {
+            if (s->noise_mV > 0.0f) {
+                sum_mV += generate_noise_mV(s->noise_mV);   // add noise to the signal
+            }
+            pOut_f32[i] = sum_mV;
+        }
+
+        // If uint16 (ADC code) output is requested, scale and clip
+        if (pOut_u16 != NULL) {
+
+            // Normalize mV to range [0.0, 1.0] relative to reference voltage
+            float32_t ratio = sum_mV / (float32_t)s->vRef_u16;
+            if (ratio < 0.0f) {
+                ratio = 0.0f;
+            }
+
+            // Scale normalized value to ADC code range and round
+            uint32_t code_u32 = (uint32_t)((ratio * (float32_t)s->adcMaxValue_u16) + 0.5f);
+
+            // Clamp value to max ADC range
+            if (code_u32 > s->adcMaxValue_u16) {
+                code_u32 = (uint32_t)s->adcMaxValue_u16;
+            }
+
+            // Store as uint16 ADC code
+            pOut_u16[i] = (uint16_t)code_u32;
+        }
+    }
+}
+
+/**
+ * @brief  Fixed-point kernel: ADC codes and/or signed Q15 samples (no floating point).
+ *
+ * The phase in ticks [0, fs) is mapped to a Q15 period fraction with one 32-bit multiply:
+ * phaseAcc * floor(2^32 / fs) < 2^32, the upper 15 bits are the arm_sin_q15() argument.
+ * The ADC codes are summed in mV, the Q15 output with per-tone gains relative to vRef/2
+ * so small amplitudes keep the full sine resolution.
+ */
+static void SignalGen_KernelQ15(SignalGen_State_t *s, uint32_t numSamples, uint16_t *pOut_u16, q15_t *pOut_q15)
+{
+    const uint32_t fs_u32     = s->samplingRate_u32;
+    const uint32_t q32PerTick = (uint32_t)(0x100000000ULL / fs_u32);
+
+    for (uint32_t i = 0U; i < numSamples; ++i) {
+        int32_t sum_mV  = (int32_t)s->dcOffset_u16;
+        int32_t sum_q15 = 0;
+
+        if (s->mode != SIG_MODE_TONES) {
+            const int64_t w = SignalGen_OscStep(s);
+            sum_mV  += (int32_t)((w * s->amps_u16[0]) >> 15U);
+            sum_q15 += (int32_t)((w * s->gainQ15_s32[0]) >> 15U);
+        }
+
+        for (uint8_t k = 0U; (s->mode == SIG_MODE_TONES) && (k < s->numTones_u8); ++k) {
+            const q15_t sine = arm_sin_q15((q15_t)((s->phaseAcc_u32[k] * q32PerTick) >> 17U));
+            sum_mV  += ((int32_t)sine * s->amps_u16[k]) >> 15U;
+            sum_q15 += ((int32_t)sine * s->gainQ15_s32[k]) >> 15U;
+
+            s->phaseAcc_u32[k] += s->phaseInc_u32[k];
+            if (s->phaseAcc_u32[k] >= fs_u32) {
+                s->phaseAcc_u32[k] -= fs_u32;
+            }
+        }
+
+        if (pOut_q15 != NULL) {
+            pOut_q15[i] = (q15_t)__SSAT(sum_q15, 16);
+        }
+
+        if (pOut_u16 != NULL) {
+            /* Clamp to [0, vRef] and scale to ADC code */
+            if (sum_mV < 0) {
+                sum_mV = 0;
+            } else if ((uint32_t)sum_mV > s->vRef_u16) {
+                sum_mV = (int32_t)s->vRef_u16;
+            }
+            pOut_u16[i] = (uint16_t)(((uint32_t)sum_mV * s->adcMaxValue_u16 + s->vRef_u16 / 2U) / s->vRef_u16);
+        }
+    }
+}
+
+/**
+ * @brief  Set up the carrier of a non-tone mode (carrier frequency = tone 0).
+ *
+ * The sweep and modulation laws are not integrated in closed form: a startSample_u32 > 0
+ * is reached by stepping the oscillator, so block-wise callers should keep one
+ * SignalGen_State_t instead of re-initializing per block.
+ */
+static void SignalGen_InitOsc(SignalGen_State_t *s, const SignalGen_Wave_t *pWave, uint32_t f0_u32, uint32_t startSample_u32)
+{
+    const uint32_t fs_u32 = s->samplingRate_u32;
+
+    switch (s->mode) {
+        case SIG_MODE_CHIRP_LIN:
+        case SIG_MODE_CHIRP_LOG:
+            s->sweepLen_u32    = (pWave->sweepLen_u32 > 0U) ? pWave->sweepLen_u32 : 1U;
+            s->sweepInc0_u64   = SignalGen_FreqToQ48(f0_u32, fs_u32);
+            s->sweepStep_s64   = ((int64_t)SignalGen_FreqToQ48(pWave->f1_u32, fs_u32) - (int64_t)s->sweepInc0_u64)
+                                 / (int64_t)s->sweepLen_u32;
+            s->oscInc_u64      = s->sweepInc0_u64;
+            s->sweepIncQ32_f32 = (float32_t)(uint32_t)(s->sweepInc0_u64 >> 16U);
+            if ((s->mode == SIG_MODE_CHIRP_LOG) && (f0_u32 > 0U) && (pWave->f1_u32 > 0U)) {
+                s->sweepLnRatio_f32 = logf((float32_t)pWave->f1_u32 / (float32_t)f0_u32) / (float32_t)s->sweepLen_u32;
+                s->sweepRatio_f32   = expf(s->sweepLnRatio_f32);
+            } else {
+                s->mode = SIG_MODE_CHIRP_LIN;   // a log sweep needs f0, f1 > 0
+            }
+            break;
+
+        case SIG_MODE_AM: {
+            // At most 100 %: the envelope 1 + m*sin stays in [0, 2] and fits the Q15 product
+            const uint32_t depth_u32 = (pWave->modDepth_u32 > 1000U) ? 1000U : pWave->modDepth_u32;
+            s->modInc_u32   = (uint32_t)(SignalGen_FreqToQ48(pWave->modFreq_u32, fs_u32) >> 16U);
+            s->modDepth_s64 = ((int64_t)depth_u32 << 15U) / 1000;
+            break;
+        }
+
+        case SIG_MODE_FM: {
+            // At most fs/2 (Q48: 2^47), so modDepth * m stays below 2^62 and a deviation
+            // >= fs is not folded back by the modulo of SignalGen_FreqToQ48()
+            const uint32_t dev_u32 = (pWave->modDepth_u32 > (fs_u32 / 2U)) ? (fs_u32 / 2U) : pWave->modDepth_u32;
+            s->modInc_u32   = (uint32_t)(SignalGen_FreqToQ48(pWave->modFreq_u32, fs_u32) >> 16U);
+            s->modDepth_s64 = (int64_t)SignalGen_FreqToQ48(dev_u32, fs_u32);
+            break;
+        }
+
+        case SIG_MODE_TABLE:
+            s->pTable_s16   = pWave->pTable_s16;
+            s->tableLen_u16 = pWave->tableLen_u16;
+            break;
+
+        default:
+            break;
+    }
+
+    for (uint32_t i = 0U; i < startSample_u32; ++i) {
+        (void)SignalGen_OscStep(s);
+    }
+}
+
+/**
+ * @brief  Initialize a persistent generator from a handle.
+ *
+ * Takes samplingRate_u32, dcOffset_u16, vRef_u16, adcMaxValue_u16, sineMethod, the tone arrays
+ * (copied) and startSample_u32 (phase of the first sample). The buffers of the handle are not used.
+ * A sampling rate of 0 is taken as 1 Hz (every tone at phase 0, i.e. the DC offset only)
+ * instead of dividing by zero.
+ *
+ * @param[out] s  Generator state.
+ * @param[in]  h  Generator configuration.
+ */
+void SignalGen_StateInit(SignalGen_State_t *s, const SignalGen_HandleType *h)
+{
+    SignalGen_Tones_t tones = { .numTones_u8 = h->numTones_u8 };
+
+    *s = (SignalGen_State_t){ 0 };
+    s->samplingRate_u32 = (h->samplingRate_u32 != 0U) ? h->samplingRate_u32 : 1U;   // 0: every tone aliases to DC
+    s->dcOffset_u16     = h->dcOffset_u16;
+    s->vRef_u16         = h->vRef_u16;
+    s->adcMaxValue_u16  = h->adcMaxValue_u16;
+    s->sineMethod       = h->sineMethod;
+    s->noise_mV         = 0.0f;
+
+    if (tones.numTones_u8 > MAX_TONES) {
+        tones.numTones_u8 = MAX_TONES;
+    }
+    for (uint8_t k = 0U; k < tones.numTones_u8; ++k) {
+        tones.freqs_u32[k] = h->pToneFreqs_u32[k];
+        tones.amps_u16[k]  = h->pToneAmps_u16[k];
+    }
+
+    const SignalGen_Wave_t *pWave = h->pWave;
+    if ((pWave != NULL) && (pWave->mode < SIG_MODE_MAX) && (tones.numTones_u8 > 0U)) {
+        s->mode = pWave->mode;
+    }
+    if ((s->mode == SIG_MODE_TABLE) && ((pWave->pTable_s16 == NULL) || (pWave->tableLen_u16 == 0U))) {
+        s->mode = SIG_MODE_TONES;   // no table loaded: plain tone 0
+        tones.numTones_u8 = 1U;
+    }
+    SignalGen_ApplyTones(s, &tones);
+
+    // Phase of each tone in sampling-clock ticks [0, fs) at startSample_u32
+    for (uint8_t k = 0U; k < s->numTones_u8; ++k) {
+        uint64_t ticks = (uint64_t)s->phaseInc_u32[k] * h->startSample_u32;
+        if ((pWave != NULL) && (pWave->pTonePhases_u16 != NULL)) {
+            ticks += ((uint64_t)pWave->pTonePhases_u16[k] * s->samplingRate_u32) >> 16U;
+        }
+        s->phaseAcc_u32[k] = (uint32_t)(ticks % s->samplingRate_u32);
+    }
+
+    if (s->mode != SIG_MODE_TONES) {
+        SignalGen_InitOsc(s, pWave, tones.freqs_u32[0], h->startSample_u32);
+    }
+    s->sampleIdx_u32 = h->startSample_u32;
+}
+
+/**
+ * @brief  Stage a new tone set, applied atomically before the next SignalGen_Next() block.
+ *
+ * Safe when SignalGen_Next() runs in an interrupt: the staged set is only written while
+ * no other set is pending, and the consumer copies it completely before releasing it.
+ *
+ * @return false if a previously staged set has not been applied yet (retry later).
+ */
+bool SignalGen_Retune(SignalGen_State_t *s, const SignalGen_Tones_t *pTones)
+{
+    if (__atomic_load_n(&s->stagedValid, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    s->staged = *pTones;
+    __atomic_store_n(&s->stagedValid, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief  Produce the next numSamples samples of the continuous signal.
+ *
+ * Consecutive calls produce exactly the samples of one long generation.
+ *
+ * @param[in,out] s           Generator state.
+ * @param[in]     numSamples  Number of samples.
+ * @param[in]     dataType    DATA_TYPE_FLOAT32: mV incl. DC (float kernel, optional noise)
+ *                            DATA_TYPE_UINT16 : ADC codes (fixed-point kernel)
+ *                            DATA_TYPE_Q15    : signed AC part, vRef/2 = full scale (fixed-point kernel)
+ * @param[out]    pOut        Output buffer of numSamples elements of dataType.
+ */
+void SignalGen_Next(SignalGen_State_t *s, uint32_t numSamples, DataType_t dataType, void *pOut)
+{
+    if (__atomic_load_n(&s->stagedValid, __ATOMIC_ACQUIRE)) {
+        SignalGen_ApplyTones(s, &s->staged);
+        __atomic_store_n(&s->stagedValid, false, __ATOMIC_RELEASE);
+    }
+
+    switch (dataType) {
+        case DATA_TYPE_FLOAT32: SignalGen_KernelF32(s, numSamples, (float32_t *)pOut, NULL); break;
+        case DATA_TYPE_UINT16:  SignalGen_KernelQ15(s, numSamples, (uint16_t *)pOut, NULL);  break;
+        case DATA_TYPE_Q15:     SignalGen_KernelQ15(s, numSamples, NULL, (q15_t *)pOut);     break;
+        default:                return;
+    }
+    s->sampleIdx_u32 += numSamples;
+}
+
+/**
+ * @brief  Schroeder start phases for a multitone of equal amplitudes (low crest factor).
+ *
+ * phi_k = -pi * k * (k - 1) / N for k = 1..N, written as Q16 fraction of a period for
+ * SignalGen_Wave_t.pTonePhases_u16. The tones should be harmonics of a common base.
+ *
+ * @param[in]  numTones     Number of tones N.
+ * @param[out] pPhases_u16  Array[numTones] of start phases.
+ */
+void SignalGen_SchroederPhases(uint8_t numTones, uint16_t *pPhases_u16)
+{
+    const uint32_t twoN = 2U * (uint32_t)numTones;
+
+    for (uint32_t k = 1U; k <= numTones; ++k) {
+        // phi / (2*pi) = -k(k-1) / 2N, taken modulo one period
+        const uint32_t m = (k * (k - 1U)) % twoN;
+        pPhases_u16[k - 1U] = (uint16_t)(0x10000U - ((m << 16U) / twoN));
+    }
+}
+
 /**
  * @brief  Generate a composite sine wave signal using Q15-based sine lookup.
  *
@@ -46,9 +452,7 @@ float32_t generate_noise_mV(float32_t noise_amplitude_mV)
  * output to a reference voltage range, and rescales the result to unsigned
  * ADC code values (e.g., 12-bit ADC output range 0–4095).
  *
- * Internally, the function uses a fixed-point Q15 representation for phase
- * accumulation and sine computation to achieve efficient signal generation
- * without floating-point math.
+ * One-shot wrapper of the persistent generator (SignalGen_StateInit() + SignalGen_Next()).
  *
  * @param[in] h  Pointer to a fully initialized SignalGen_HandleType:
  *            - samplingRate_u32: Sampling rate in Hz
@@ -58,62 +462,19 @@ float32_t generate_noise_mV(float32_t noise_amplitude_mV)
  *            - numTones_u8: Number of sine components
  *            - pToneFreqs_u32: Pointer to array[numTones] of frequencies in Hz
  *            - pToneAmps_u16: Pointer to array[numTones] of amplitudes in mV
- *            - pOutBuffer_u16: Pointer to output buffer (uint16_t), must hold at least numSamples_u16 entries
- *
- * @note   Signal Generation Steps:
- *         1. For each tone, a phase accumulator is initialized and incremented
- *            per sample based on the tone frequency.
- *         2. For each sample:
- *              - Sum all sine waves (amplitude-weighted).
- *              - Add a DC offset (in mV).
- *              - Clamp the result between 0 and vRef_u16 (mV range).
- *              - Rescale the result to fit into [0, adcMaxValue_u16].
- *         3. Store the result as an unsigned 16-bit integer (uint16_t).
- *
- * @note   Q15 Sine Lookup:
- *         - The sine function is evaluated using `arm_sin_q15()` from the CMSIS-DSP library.
- *         - The phase accumulator and increment are scaled to 16-bit fixed-point range (0…65535).
- *         - This avoids the need for floating-point computation and enables fast, efficient signal generation.
- *
- * @note   Intended Use:
- *         - The output signal mimics the output of an ADC: unsigned integer values
- *           corresponding to sampled analog voltages between 0 and vRef_u16 mV.
- *         - If the generated signal is to be analyzed by FFT, post-processing
- *           must re-center the signal around 0 (e.g., subtract DC midpoint)
- *           and possibly convert to a signed type (e.g., q15_t or float32_t).
+ *            - pOutBuffer_u16: Pointer to output buffer (uint16_t), must hold at least numSamples_u32 entries
+ *            - startSample_u32: Index of the first sample (phase offset for block-wise generation)
+ *
+ * @note   The phase is tracked per tone in sampling-clock ticks modulo fs and mapped to
+ *         the arm_sin_q15() argument with integer math only; the output is clamped to
+ *         [0, vRef_u16] mV and rescaled to [0, adcMaxValue_u16].
  */
 void SignalGen_GenerateComposite_Q15(SignalGen_HandleType *h)
 {
-    uint16_t phaseInc[MAX_TONES];
-    uint16_t phaseAcc[MAX_TONES] = { 0U };
-
-    /* Precompute per-tone phase increments */
-    for (uint8_t k = 0U; k < h->numTones_u8; ++k) {
-        uint32_t tmp = ((uint64_t)h->pToneFreqs_u32[k] << 16U) / h->samplingRate_u32;
-        phaseInc[k] = (uint16_t)tmp;
-    }
-
-    /* Generate each sample */
-    for (uint16_t i = 0U; i < h->numSamples_u16; ++i) {
-        int32_t sum_mV = (int32_t)h->dcOffset_u16;
-
-        for (uint8_t k = 0U; k < h->numTones_u8; ++k) {
-            phaseAcc[k] += phaseInc[k];
-            q15_t s = arm_sin_q15((q15_t)(phaseAcc[k] >> 1U));
-            sum_mV += ((int32_t)s * h->pToneAmps_u16[k]) >> 15U;
-        }
+    SignalGen_State_t state;
 
-        /* Clamp to [0, vRef] */
-        if (sum_mV < 0) {
-            sum_mV = 0;
-        } else if ((uint32_t)sum_mV > h->vRef_u16) {
-            sum_mV = (int32_t)h->vRef_u16;
-        }
-
-        /* Scale to ADC code */
-        uint32_t code = ((uint32_t)sum_mV * h->adcMaxValue_u16 + h->vRef_u16 / 2U) / h->vRef_u16;
-        h->pOutBuffer_u16[i] = (uint16_t)code;
-    }
+    SignalGen_StateInit(&state, h);
+    SignalGen_Next(&state, h->numSamples_u32, DATA_TYPE_UINT16, h->pOutBuffer_u16);
 }
 
 
@@ -132,75 +493,25 @@ void SignalGen_GenerateComposite_Q15(SignalGen_HandleType *h)
  *            - pOutBuffer_u16: Pointer to uint16_t output buffer (optional)
  *            - sineMethod: Sine computation method (CMSIS or standard library)
  *            - dataType: Target output data type (float32 or uint16_t ADC codes)
+ *            - numSamples_u32 / startSample_u32: block length and index of its first sample
  *
  * @note   For each sample:
  *         - Computes sum of DC offset plus sine components.
- *         - Sine phase angle: 2π·f·t
+ *         - Sine phase angle: 2π·f·t, tracked per tone as an integer phase modulo fs
+ *         - startSample_u32 offsets t, so consecutive blocks form one continuous signal
  *         - If CMSIS sine method is selected, uses arm_sin_f32().
  *         - Otherwise, uses standard sinf().
- *         - Floating point waveform is stored if requested.
+ *         - Floating point waveform (with 5 mV RNG noise) is stored if requested.
  *         - ADC codes are scaled and clamped if requested.
  */
 void SignalGen_GenerateComposite(SignalGen_HandleType *sig_handle)
 {
-    // Calculate the time step between two samples [s] from the sampling rate
-    const float32_t timeStep_f32 = 1.0f / (float32_t)sig_handle->samplingRate_u32;
-
-    // Initialize the time variable to start at t = 0
-    float32_t t_f32 = 0.0f;
-
-    // Loop through each sample to generate the composite waveform
-    for (uint16_t i = 0U; i < sig_handle->numSamples_u16; ++i) {
-
-        // Start with DC offset (in mV)
-        float32_t sum_mV = (float32_t)sig_handle->dcOffset_u16;
-
-        // Loop over each sine tone and add its contribution
-        for (uint8_t k = 0U; k < sig_handle->numTones_u8; ++k) {
-
-            // Frequency of the current tone [Hz]
-            float32_t freq_f32 = (float32_t)sig_handle->pToneFreqs_u32[k];
-
-            // Compute the sine wave phase angle θ = 2π·f·t
-            float32_t angle_f32 = 2.0f * PI * freq_f32 * t_f32;
+    SignalGen_State_t state;
 
-            // Compute the sine wave value using CMSIS or standard math library
-            float32_t s_f32 = (sig_handle->sineMethod == SINE_METHOD_CMSIS)
-                                ? arm_sin_f32(angle_f32)
-                                : sinf(angle_f32);
-
-            // Multiply sine by its amplitude (in mV) and add to sum
-            sum_mV += (float32_t)sig_handle->pToneAmps_u16[k] * s_f32;
-
-        }
-
-        // If float32 output is requested, store result in float buffer
-        if ((sig_handle->dataType == DATA_TYPE_FLOAT32) && (sig_handle->pOutBuffer_f32 != NULL)) {
-
-            float32_t noise = generate_noise_mV(5.0f);  // adjustable noise amplitude
-            sum_mV += noise;							// add noise to the signal
-            sig_handle->pOutBuffer_f32[i] = sum_mV;
-        }
-
-        // If uint16 (ADC code) output is requested, scale and clip
-        if ((sig_handle->dataType == DATA_TYPE_UINT16) && (sig_handle->pOutBuffer_u16 != NULL)) {
-
-            // Normalize mV to range [0.0, 1.0] relative to reference voltage
-            float32_t ratio = sum_mV / (float32_t)sig_handle->vRef_u16;
-
-            // Scale normalized value to ADC code range and round
-            uint32_t code_u32 = (uint32_t)((ratio * (float32_t)sig_handle->adcMaxValue_u16) + 0.5f);
-
-            // Clamp value to max ADC range
-            if (code_u32 > sig_handle->adcMaxValue_u16) {
-                code_u32 = (uint32_t)sig_handle->adcMaxValue_u16;
-            }
-
-            // Store as uint16 ADC code
-            sig_handle->pOutBuffer_u16[i] = (uint16_t)code_u32;
-        }
+    SignalGen_StateInit(&state, sig_handle);
+    state.noise_mV = 5.0f;  // adjustable noise amplitude
 
-        // Advance time by one sample period
-        t_f32 += timeStep_f32;
-    }
+    float32_t *pF32 = (sig_handle->dataType == DATA_TYPE_FLOAT32) ? sig_handle->pOutBuffer_f32 : NULL;
+    uint16_t  *pU16 = (sig_handle->dataType == DATA_TYPE_UINT16)  ? sig_handle->pOutBuffer_u16 : NULL;
+    SignalGen_KernelF32(&state, sig_handle->numSamples_u32, pF32, pU16);
 }
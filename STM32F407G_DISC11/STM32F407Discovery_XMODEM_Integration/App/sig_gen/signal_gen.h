@@ -16,8 +16,10 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "arm_math_include.h"
+#include "signal_memory.h"     /* MAX_TONES */
 
 
 /** @brief Sine‐generation method */
@@ -26,6 +28,34 @@ typedef enum {
     SINE_METHOD_CMSIS        /**< use arm_sin_f32() */
 } SineMethod_t;
 
+/** @brief Waveform produced by the generator */
+typedef enum {
+    SIG_MODE_TONES = 0,     /**< sum of sine tones, optional start phase per tone */
+    SIG_MODE_CHIRP_LIN,     /**< tone 0: linear sweep f0 -> f1 over sweepLen samples, repeats */
+    SIG_MODE_CHIRP_LOG,     /**< tone 0: exponential sweep f0 -> f1 over sweepLen samples, repeats */
+    SIG_MODE_AM,            /**< tone 0 carrier, amplitude (1 + m*sin(2*pi*fm*t)) */
+    SIG_MODE_FM,            /**< tone 0 carrier, frequency f0 + dev*sin(2*pi*fm*t) */
+    SIG_MODE_TABLE,         /**< tone 0 plays one period of a user table */
+    SIG_MODE_MAX
+} SignalGen_Mode_t;
+
+/**
+ * @brief Optional waveform description (SignalGen_HandleType.pWave, NULL = plain tones).
+ *
+ * All modes except SIG_MODE_TONES use tone 0 as carrier: freqs[0] is the (start)
+ * frequency, amps[0] the amplitude in mV; further tones are ignored.
+ */
+typedef struct SignalGen_Wave_s {
+    SignalGen_Mode_t 	mode;
+    const uint16_t   	*pTonePhases_u16;	/**< TONES: array[numTones] start phase, Q16 fraction of a period (NULL = 0) */
+    uint32_t         	f1_u32;          	/**< CHIRP: end frequency in Hz (log: f0, f1 > 0) */
+    uint32_t         	sweepLen_u32;    	/**< CHIRP: samples per sweep */
+    uint32_t         	modFreq_u32;     	/**< AM/FM: modulating frequency in Hz */
+    uint32_t         	modDepth_u32;    	/**< AM: modulation depth in permille (max 1000), FM: peak deviation in Hz (max fs/2) */
+    const int16_t    	*pTable_s16;     	/**< TABLE: one period, Q15, linearly interpolated */
+    uint16_t         	tableLen_u16;    	/**< TABLE: number of table entries */
+} SignalGen_Wave_t;
+
 /**
  * @brief Configuration and buffers for the composite-signal generator.
  *
@@ -33,9 +63,12 @@ typedef enum {
  * - toneFreqs and toneAmps point to arrays of length numTones.
  * - Depending on dataType, either outFloat32 or outUint16 (or both) must be non-NULL,
  *   and each must point to an array of length numSamples.
+ * - Signals longer than the output buffer are generated block by block: call again
+ *   with startSample_u32 advanced by numSamples_u32 and the phase continues seamlessly.
  */
 typedef struct {
-    uint16_t      		numSamples_u16;    	/**< total number of samples to generate */
+    uint32_t      		numSamples_u32;    	/**< number of samples to generate in this call */
+    uint32_t      		startSample_u32;   	/**< index of the first sample; continues the phase of a previous block */
     uint32_t         	samplingRate_u32;  	/**< sampling rate in Hz */
     uint16_t         	dcOffset_u16;      	/**< DC offset to add to the composite signal */
     uint16_t         	vRef_u16;          	/**< reference voltage for scaling to uint16_t */
@@ -47,9 +80,63 @@ typedef struct {
     DataType_t    		dataType;      		/**< choose output format (float32_t or uint16_t) */
     float32_t    		*pOutBuffer_f32;    /**< pointer to float32_t output buffer */
     uint16_t     		*pOutBuffer_u16;    /**< pointer to uint16_t output buffer */
+    const SignalGen_Wave_t *pWave;      /**< optional waveform mode (NULL = sum of tones at phase 0) */
 } SignalGen_HandleType;
 
 
+/** @brief Tone set of the persistent generator (copied, so it may live on the stack) */
+typedef struct {
+    uint8_t       		numTones_u8;
+    uint32_t      		freqs_u32[MAX_TONES];  	/**< frequencies in Hz */
+    uint16_t      		amps_u16[MAX_TONES];   	/**< peak amplitudes in mV */
+} SignalGen_Tones_t;
+
+/**
+ * @brief Persistent generator: the per-tone phase survives between calls.
+ *
+ * SignalGen_Next() continues where the previous call stopped, so a signal of any length
+ * can be produced block by block (UART streaming, I2S, DAC). A new tone set staged with
+ * SignalGen_Retune() takes effect at the next block boundary without a phase jump.
+ * In the non-tone modes a retune changes the carrier amplitude (and the carrier
+ * frequency of AM/FM/TABLE); a running sweep keeps its frequency law.
+ */
+typedef struct {
+    uint32_t      		samplingRate_u32;
+    uint16_t      		dcOffset_u16;
+    uint16_t      		vRef_u16;
+    uint16_t      		adcMaxValue_u16;
+    SineMethod_t  		sineMethod;
+    float32_t     		noise_mV;              	/**< RNG noise amplitude of the float output, 0 = off */
+    uint8_t       		numTones_u8;
+    uint32_t      		phaseInc_u32[MAX_TONES];	/**< phase step per sample, ticks of fs */
+    uint32_t      		phaseAcc_u32[MAX_TONES];	/**< current phase, ticks [0, fs) */
+    uint16_t      		amps_u16[MAX_TONES];     	/**< mV, ADC-code / float output */
+    int32_t       		gainQ15_s32[MAX_TONES];  	/**< amplitude relative to vRef/2, Q15 output */
+    SignalGen_Mode_t    mode;
+    uint64_t      		oscPhase_u64;          	/**< carrier phase, Q48 fraction of a period (non-tone modes) */
+    uint64_t      		oscInc_u64;            	/**< carrier increment per sample, Q48 */
+    uint64_t      		sweepInc0_u64;         	/**< CHIRP: increment at f0, Q48 */
+    int64_t       		sweepStep_s64;         	/**< CHIRP_LIN: increment change per sample, Q48 */
+    float32_t     		sweepLnRatio_f32;      	/**< CHIRP_LOG: ln(f1/f0) / sweepLen */
+    float32_t     		sweepRatio_f32;        	/**< CHIRP_LOG: increment factor per sample */
+    float32_t     		sweepIncQ32_f32;       	/**< CHIRP_LOG: current increment, Q32 */
+    uint32_t      		sweepPos_u32;
+    uint32_t      		sweepLen_u32;
+    uint32_t      		modPhase_u32;          	/**< AM/FM: modulator phase, Q32 */
+    uint32_t      		modInc_u32;
+    int64_t       		modDepth_s64;          	/**< AM: depth Q15, FM: peak deviation Q48 */
+    const int16_t 		*pTable_s16;
+    uint16_t      		tableLen_u16;
+    uint32_t      		sampleIdx_u32;         	/**< index of the next sample */
+    SignalGen_Tones_t 	staged;                	/**< tone set waiting for the next block */
+    volatile bool 		stagedValid;
+} SignalGen_State_t;
+
+void SignalGen_StateInit(SignalGen_State_t *s, const SignalGen_HandleType *h);
+bool SignalGen_Retune(SignalGen_State_t *s, const SignalGen_Tones_t *pTones);
+void SignalGen_Next(SignalGen_State_t *s, uint32_t numSamples, DataType_t dataType, void *pOut);
+void SignalGen_SchroederPhases(uint8_t numTones, uint16_t *pPhases_u16);
+
 /**
  * @brief Generate a composite signal of multiple sine tones.
  * @param h  Pointer to a fully initialized SignalGen_Handle_t.
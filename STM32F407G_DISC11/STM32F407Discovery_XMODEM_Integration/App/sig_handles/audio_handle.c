@@ -0,0 +1,110 @@
+/*
+ * audio_handle.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      AUDIO_START / AUDIO_SET / AUDIO_STOP, see audio_handle.h.
+ */
+
+#include <string.h>
+
+#include "audio_handle.h"
+#include "audio_out.h"
+#include "uart_app.h"
+#include "json_utils.h"
+#include "profiling.h"
+
+#define JSMN_HEADER
+#include "jsmn.h"
+
+/**
+ * @brief  Parse "num_tones", "freqs", "amps" (and optionally "volume") into a tone set.
+ * @return false (and a FAIL response) if the tone arguments are missing or invalid.
+ */
+static bool parse_audio_params(const char *json_str, const char *cmd, AudioSynthParams_t *pParams, uint16_t *pVolume_u16)
+{
+    jsmn_parser parser;
+    jsmntok_t tokens[MAX_JSON_TOKENS];
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, MAX_JSON_TOKENS);
+    if ((tokCount < 1) || (tokens[0].type != JSMN_OBJECT)) {
+        send_uart_response(cmd, "FAIL", "{\"error\":\"invalid_json\"}");
+        return false;
+    }
+
+    size_t numFreqs = 0U;
+    size_t numAmps  = 0U;
+    *pParams = (AudioSynthParams_t){ 0 };
+    if ((json_parse_array_u32(json_str, tokens, tokCount, "freqs", pParams->freqs_u32, AUDIO_SYNTH_MAX_TONES, &numFreqs) != JSON_PARSE_OK) ||
+        (json_parse_array_u16(json_str, tokens, tokCount, "amps", pParams->amps_u16, AUDIO_SYNTH_MAX_TONES, &numAmps) != JSON_PARSE_OK)) {
+        send_uart_response(cmd, "FAIL", "{\"error\":\"freqs_amps_missing\",\"max_tones\":%u}", (unsigned)AUDIO_SYNTH_MAX_TONES);
+        return false;
+    }
+    pParams->numTones_u8 = (uint8_t)((numFreqs < numAmps) ? numFreqs : numAmps);
+
+    for (uint8_t k = 0U; k < pParams->numTones_u8; ++k) {
+        if (pParams->freqs_u32[k] >= (AUDIO_OUT_FS / 2U)) {
+            send_uart_response(cmd, "FAIL", "{\"error\":\"freq_above_nyquist\",\"freq\":%lu}", (unsigned long)pParams->freqs_u32[k]);
+            return false;
+        }
+    }
+
+    if (pVolume_u16 != NULL) {
+        *pVolume_u16 = AUDIO_OUT_DEFAULT_VOLUME;
+        (void)json_parse_u16(json_str, tokens, tokCount, "volume", pVolume_u16);
+        if (*pVolume_u16 > 255U) {
+            *pVolume_u16 = 255U;
+        }
+    }
+    return true;
+}
+
+void handle_audio_start(const char *json_str)
+{
+    AudioSynthParams_t params;
+    uint16_t volume_u16;
+
+    if (!parse_audio_params(json_str, "AUDIO_START", &params, &volume_u16)) {
+        return;
+    }
+    if (!audio_out_start(&params, (uint8_t)volume_u16)) {
+        send_uart_response("AUDIO_START", "FAIL", "{\"error\":\"codec_or_i2s_failed\"}");
+        return;
+    }
+    send_uart_response("AUDIO_START", "OK", "{\"fs\":%lu,\"block\":%lu,\"num_tones\":%u,\"volume\":%u}",
+                       (unsigned long)AUDIO_OUT_FS, (unsigned long)AUDIO_OUT_FRAMES_PER_BLOCK,
+                       (unsigned)params.numTones_u8, (unsigned)volume_u16);
+}
+
+void handle_audio_set(const char *json_str)
+{
+    AudioSynthParams_t params;
+
+    if (!parse_audio_params(json_str, "AUDIO_SET", &params, NULL)) {
+        return;
+    }
+    if (!audio_out_update(&params)) {
+        send_uart_response("AUDIO_SET", "FAIL", "{\"error\":\"not_running\"}");
+        return;
+    }
+    send_uart_response("AUDIO_SET", "OK", "{\"num_tones\":%u}", (unsigned)params.numTones_u8);
+}
+
+void handle_audio_stop(const char *json_str)
+{
+    (void)json_str;
+
+    if (!audio_out_is_running()) {
+        send_uart_response("AUDIO_STOP", "FAIL", "{\"error\":\"not_running\"}");
+        return;
+    }
+    audio_out_stop();
+
+    const AudioOutStats_t *stats = audio_out_get_stats();
+    send_uart_response("AUDIO_STOP", "OK", "{\"blocks\":%lu,\"late\":%lu,\"last_ticks\":%lu,\"max_ticks\":%lu,\"tick_hz\":%lu}",
+                       (unsigned long)stats->blocks_u32, (unsigned long)stats->late_u32,
+                       (unsigned long)stats->lastTicks_u32, (unsigned long)stats->maxTicks_u32,
+                       (unsigned long)prof_tick_hz());
+}
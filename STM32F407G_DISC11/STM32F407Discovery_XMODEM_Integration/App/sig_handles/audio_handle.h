@@ -0,0 +1,24 @@
+/*
+ * audio_handle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      JSON commands of the audio output (I2S3 -> CS43L22 headphone jack):
+ *          AUDIO_START : {"cmd":"AUDIO_START","num_tones":2,"freqs":[1000,3000],"amps":[500,200],"volume":200}
+ *          AUDIO_SET   : same tone arguments, retunes the running output at the next block boundary
+ *          AUDIO_STOP  : stops the output and reports the refill statistics
+ *      Amplitudes are in mV with 1650 mV = digital full scale (AUDIO_SYNTH_FULL_SCALE_MV).
+ */
+
+#ifndef SIG_HANDLES_AUDIO_HANDLE_H_
+#define SIG_HANDLES_AUDIO_HANDLE_H_
+
+#include <stdint.h>
+
+void handle_audio_start(const char *json_str);
+void handle_audio_set(const char *json_str);
+void handle_audio_stop(const char *json_str);
+
+#endif /* SIG_HANDLES_AUDIO_HANDLE_H_ */
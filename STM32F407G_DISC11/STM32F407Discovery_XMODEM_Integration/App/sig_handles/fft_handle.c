@@ -6,7 +6,7 @@
  *
  *  Description:
  *      This module generates a composite signal based on provided parameters,
- *      computes its FFT using CMSIS-DSP's arm_rfft_fast_f32, and sends
+ *      computes its FFT using CMSIS-DSP (fft_real_f32, up to FFT_MAX_LEN points), and sends
  *      the magnitude spectrum over UART in binary format.
  */
 
@@ -17,10 +17,52 @@
 #include "uart_app.h"
 #include "json_utils.h"
 #include "fft_utils.h"
+#include "filter_utils.h"
 #include "signal_transfer.h"
 #include "signal_config_parser.h"
 #include "filter_coefficients.h"
+#include "profiling.h"
+#include "adc_capture.h"
 
+/* CCM section bounds from the linker script (STM32F407VGTX_FLASH.ld) */
+extern uint8_t _sccmram, _eccmram, _sccmram_bss, _eccmram_bss;
+
+/**
+ * @brief  Fill the time-domain buffer of the handle from the selected signal source.
+ *
+ * SIG_SRC_CALC generates the composite signal, SIG_SRC_ADC captures one block from
+ * ADC1 (PA1) at the requested rate. Both deliver millivolts, so the rest of the
+ * pipeline does not depend on the source. ADC blocks are limited to
+ * ADC_CAPTURE_MAX_BLOCK_LEN, the handle length is reduced accordingly.
+ *
+ * @param[in]     cmd     Command name used in the error response.
+ * @param[in]     config  Parsed command parameters.
+ * @param[in,out] handle  Generator handle, numSamples_u32 may be reduced.
+ * @return true if the buffer holds a complete block.
+ */
+static bool acquire_signal_block(const char *cmd, const JsonParsedSigGenPar_HandlType_t *config, SignalGen_HandleType *handle)
+{
+    if (config->sigSource != SIG_SRC_ADC) {
+        SignalGen_GenerateComposite(handle);
+        return true;
+    }
+
+    if (handle->numSamples_u32 > ADC_CAPTURE_MAX_BLOCK_LEN) {
+        handle->numSamples_u32 = get_supported_fft_length(ADC_CAPTURE_MAX_BLOCK_LEN);
+    }
+
+    bool ok = adc_capture_single_block_mV(handle->pOutBuffer_f32, handle->numSamples_u32, handle->samplingRate_u32,
+                                          handle->vRef_u16, handle->adcMaxValue_u16);
+    const AdcCaptureStats_t *stats = adc_capture_get_stats();
+    printToDebugUartBlocking("[DBG] ADC capture: len=%lu rate=%lu Hz blocks=%lu dropped=%lu overrun=%lu\r\n",
+                             (unsigned long)handle->numSamples_u32, (unsigned long)stats->actualRate_u32,
+                             (unsigned long)stats->blocks_u32, (unsigned long)stats->dropped_u32,
+                             (unsigned long)stats->overrun_u32);
+    if (!ok) {
+        send_uart_response(cmd, "FAIL", "{\"error\":\"adc_capture_failed\"}");
+    }
+    return ok;
+}
 
 
 
@@ -31,7 +73,7 @@
  *
  * @param[in] json_str  Pointer to JSON string containing generation parameters:
  *                      - "num_tones" (uint16): Number of sine components.
- *                      - "len" (uint16): Number of samples to generate (will be clipped to max buffer length).
+ *                      - "len" (uint32): Number of samples to generate (rounded down to a supported FFT length <= FFT_MAX_LEN).
  *                      - "freqs" (array of uint32): Frequencies in Hz.
  *                      - "amps" (array of uint16): Amplitudes in mV.
  *                      - "data_type" (optional, enum): Output data type.
@@ -39,21 +81,23 @@
  */
 void handle_read_fft(const char *json_str)
 {
-	write_OrangeLed_PD13(GPIO_PIN_SET);
+	write_OrangeLed_PD13(true);
     JsonParsedSigGenPar_HandlType_t config;
     /* --- Parse and Validate JSON Parameters and write them into config structure --- */
     if (parse_and_validate_signal_config(json_str, "READ_FFT", &config) != 0) {
+        write_OrangeLed_PD13(false);
         return;  // Early exit on error
     }
 
-    uint16_t supported_length = get_supported_fft_length(config.numSamples_u16);
+    uint32_t supported_length = get_supported_fft_length(config.numSamples_u32);
     bool status_len = is_valid_fft_length(supported_length);
     if(!status_len){
     	printToDebugUartBlocking("[DBG] Error : Unsupported Length\r\n");
     }
     /* --- Setup signal generation handle --- */
     SignalGen_HandleType sigSettingsHandle = {
-        .numSamples_u16        = supported_length,
+        .numSamples_u32        = supported_length,
+        .startSample_u32       = 0U,
         .samplingRate_u32      = config.sampl_rate,
         .dcOffset_u16          = 1650U,
         .vRef_u16              = 3300U,
@@ -61,88 +105,82 @@ void handle_read_fft(const char *json_str)
         .numTones_u8           = (uint8_t)config.numTones_u16,
         .pToneFreqs_u32        = config.pFreqs,
         .pToneAmps_u16         = config.pAmps,
+        .pWave                 = config.pWave,
         .sineMethod            = SINE_METHOD_CMSIS,
         .dataType              = DATA_TYPE_FLOAT32,
         .pOutBuffer_f32        = sigBUFFER_UNION.bufF32,
         .pOutBuffer_u16        = NULL
     };
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
 
-    //***************** Generate Composite Signal (Directly as float32) ***********************************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    SignalGen_GenerateComposite(&sigSettingsHandle);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    //***************** Generate Composite Signal or capture ADC block (float32, mV) *********************************//
+    if (!acquire_signal_block("READ_FFT", &config, &sigSettingsHandle)) {
+        write_OrangeLed_PD13(false);
+        return;
+    }
 
     //***************** Initialize and apply FIR-FILTER ***************************************************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    arm_fir_instance_f32 fir;
-    arm_fir_init_f32(&fir, NUM_TAPS_FIR_LP, (float32_t *)LP_FIR_COEFF, sigBUFF2, sigSettingsHandle.numSamples_u16);
-    arm_fir_f32(&fir, sigBUFFER_UNION.bufF32, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    apply_fir_filter_f32(LP_FIR_COEFF, NUM_TAPS_FIR_LP, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
 
     //***************** Remove DC (center to 0) and normalize to [-1, 1] **********************************************//
     const float32_t adcMidpoint = 2048.0f;
     const float32_t scaleFactor = 1.0f / (adcMidpoint - 1.0f);
-    arm_offset_f32(sigBUFFER_UNION.bufF32, -adcMidpoint, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-    arm_scale_f32(sigBUFFER_UNION.bufF32, scaleFactor, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
+    arm_offset_f32(sigBUFFER_UNION.bufF32, -adcMidpoint, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
+    arm_scale_f32(sigBUFFER_UNION.bufF32, scaleFactor, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
 
     //***************** Apply Blackman window ***********************************************************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    apply_blackman_window(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    apply_blackman_window(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
 
     //***************** FFT setup and execution ***********************************************************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    arm_rfft_fast_instance_f32 fft_instance;
-    arm_status status = arm_rfft_fast_init_f32(&fft_instance, sigSettingsHandle.numSamples_u16);
+    FftReal_Instance_f32 fft_instance;
+    arm_status status = fft_real_init_f32(&fft_instance, sigSettingsHandle.numSamples_u32);
     if (status != ARM_MATH_SUCCESS) {
         send_uart_response("READ_FFT", "FAIL", "{\"error\":\"fft_init_failed\"}");
-        write_OrangeLed_PD13(GPIO_PIN_RESET);
+        write_OrangeLed_PD13(false);
         return;
     }
-    arm_rfft_fast_f32(&fft_instance, sigBUFFER_UNION.bufF32, sigBUFF2, 0); // Compute FFT (real input, complex output)
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    fft_real_f32(&fft_instance, sigBUFFER_UNION.bufF32, sigBUFF2); // Compute FFT (real input, complex output)
 
 
     //***************** Compute magnitude spectrum from complex FFT ****************************************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    arm_cmplx_mag_f32(sigBUFF2, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16 / 2);
+    arm_cmplx_mag_f32(sigBUFF2, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32 / 2);
     const float32_t coherent_gain_blackman = 1.0f / 0.42f;
-    arm_scale_f32(sigBUFFER_UNION.bufF32, (coherent_gain_blackman / (sigSettingsHandle.numSamples_u16 / 4)), sigBUFF2, sigSettingsHandle.numSamples_u16);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    arm_scale_f32(sigBUFFER_UNION.bufF32, (coherent_gain_blackman / (sigSettingsHandle.numSamples_u32 / 4)), sigBUFF2, sigSettingsHandle.numSamples_u32);
 
     //***************** Send FFT Output as cmlx magnitude **************************************************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    send_signal_header("READ_FFT", &config, sigBUFF2, sigSettingsHandle.numSamples_u16 / 2, config.dataType, config.transferMode);
-    send_signal_payload(sigBUFF2, sigSettingsHandle.numSamples_u16 / 2, config.dataType, config.transferMode);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    send_signal_header("READ_FFT", &config, sigBUFF2, sigSettingsHandle.numSamples_u32 / 2, config.dataType, config.transferMode);
+    send_signal_payload(sigBUFF2, sigSettingsHandle.numSamples_u32 / 2, config.dataType, config.transferMode);
+    write_OrangeLed_PD13(false);
 }
 
 
+/**
+ * @brief  Handle JSON command READ_SIG_FFT: generate, send raw/filtered time signal, then the spectrum.
+ *
+ * Every stage is measured with a profiling probe (PROF_SIG_FFT_*), the timings can be
+ * read back with READ_PROFILE. The orange LED is on while the command runs.
+ *
+ * @param[in] json_str  Pointer to JSON string with the signal parameters (see handle_read_fft()).
+ */
 void handle_read_sig_fft(const char *json_str)
 {
-	write_OrangeLed_PD13(GPIO_PIN_SET);
+	write_OrangeLed_PD13(true);
+	PROF_BEGIN(PROF_SIG_FFT_TOTAL);
     JsonParsedSigGenPar_HandlType_t config;
     /* --- Parse and Validate JSON Parameters and write them into config structure --- */
     if (parse_and_validate_signal_config(json_str, "READ_SIG_FFT", &config) != 0) {
+        write_OrangeLed_PD13(false);
         return;  // Early exit on error
     }
 
-    uint16_t supported_length = get_supported_fft_length(config.numSamples_u16);
+    uint32_t supported_length = get_supported_fft_length(config.numSamples_u32);
     bool status_len = is_valid_fft_length(supported_length);
     if(!status_len){
     	printToDebugUartBlocking("[DBG] Error : Unsupported Length\r\n");
     }
     /* --- Setup signal generation handle --- */
     SignalGen_HandleType sigSettingsHandle = {
-        .numSamples_u16        = supported_length,
+        .numSamples_u32        = supported_length,
+        .startSample_u32       = 0U,
         .samplingRate_u32      = config.sampl_rate,
         .dcOffset_u16          = 1600U,
         .vRef_u16              = 3300U,
@@ -150,106 +188,123 @@ void handle_read_sig_fft(const char *json_str)
         .numTones_u8           = (uint8_t)config.numTones_u16,
         .pToneFreqs_u32        = config.pFreqs,
         .pToneAmps_u16         = config.pAmps,
+        .pWave                 = config.pWave,
         .sineMethod            = SINE_METHOD_CMSIS,
         .dataType              = DATA_TYPE_FLOAT32,
         .pOutBuffer_f32        = sigBUFFER_UNION.bufF32,
         .pOutBuffer_u16        = NULL
     };
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
-
-    //***************** Generate Composite Signal (Directly as float32) ***********************************************//
-    //***************** It takes around 55ms to generate a signal of 4096 points with 14 freq. tones and noise ********//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    SignalGen_GenerateComposite(&sigSettingsHandle);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
 
+    //***************** Generate Composite Signal or capture ADC block (float32, mV) *********************************//
+    PROF_BEGIN(PROF_SIG_FFT_GEN);
+    bool acquired = acquire_signal_block("READ_SIG_FFT", &config, &sigSettingsHandle);
+    PROF_END(PROF_SIG_FFT_GEN);
+    if (!acquired) {
+        write_OrangeLed_PD13(false);
+        return;
+    }
 
     //***************** Send Time-Domain Signal Unfiltered ************************************************************//
-    //***************** It takes around 200ms to send 4096points x 4 = 16.4kByte + Header at 921600 Baud-Rate *********//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    send_signal_header("SIG_TIME_RAW", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    send_signal_payload(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    PROF_BEGIN(PROF_SIG_FFT_SEND_RAW);
+    send_signal_header("SIG_TIME_RAW", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+    send_signal_payload(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+    PROF_END(PROF_SIG_FFT_SEND_RAW);
 
     //***************** Initialize and apply FILTER Dependent on user selection ***************************************//
-    //***************** It takes around 8.2ms to perform FIR filtering with 89-Taps on signal with 4096 points ********//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    arm_fir_instance_f32 fir;
+    PROF_BEGIN(PROF_SIG_FFT_FILTER);
     if(config.filterType == FILT_FIR_LP){
-    	arm_fir_init_f32(&fir, NUM_TAPS_FIR_LP, (float32_t *)LP_FIR_COEFF, sigBUFF2, sigSettingsHandle.numSamples_u16);
-    	arm_fir_f32(&fir, sigBUFFER_UNION.bufF32, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
+    	apply_fir_filter_f32(LP_FIR_COEFF, NUM_TAPS_FIR_LP, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
     }
     else if(config.filterType == FILT_FIR_BP){
-    	arm_fir_init_f32(&fir, NUM_TAPS_FIR_BP, (float32_t *)BP_FIR_COEFF, sigBUFF2, sigSettingsHandle.numSamples_u16);
-    	arm_fir_f32(&fir, sigBUFFER_UNION.bufF32, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
+    	apply_fir_filter_f32(BP_FIR_COEFF, NUM_TAPS_FIR_BP, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
     }
     else{
     	// Do nothing. No filter.
     }
-
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
-
-//    //***************** Remove DC (center to 0) and normalize to [-1, 1] **********************************************//
-//    //***************** It takes around 300us to remove offset and scale the signal with 4096 points ******************//
-//    write_OrangeLed_PD13(GPIO_PIN_SET);
-//    const float32_t adcMidpoint = 2048.0f;
-//    const float32_t scaleFactor = 1.0f / (adcMidpoint - 1.0f);
-//    arm_offset_f32(sigBUFFER_UNION.bufF32, -adcMidpoint, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-//    arm_scale_f32(sigBUFFER_UNION.bufF32, scaleFactor, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-//    write_OrangeLed_PD13(GPIO_PIN_RESET);
-//    platform_delay_ms(1U);
+    PROF_END(PROF_SIG_FFT_FILTER);
 
     //***************** Send Time-Domain Signal ***********************************************************************//
-    //***************** It takes around 200ms to send 4096points x 4 = 16.4kByte + Header at 921600 Baud-Rate *********//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    send_signal_header("SIG_TIME", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    send_signal_payload(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    PROF_BEGIN(PROF_SIG_FFT_SEND_TIME);
+    send_signal_header("SIG_TIME", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+    send_signal_payload(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+    PROF_END(PROF_SIG_FFT_SEND_TIME);
 
-    //***************** Apply Blackman window ***********************************************************************//
-    //***************** It takes around 13ms to apply a blackman window on a signal of 4096 points ******************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    apply_blackman_window(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    //***************** Apply Blackman window (coefficients cached per length) ****************************************//
+    PROF_BEGIN(PROF_SIG_FFT_WINDOW);
+    apply_blackman_window(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
+    PROF_END(PROF_SIG_FFT_WINDOW);
 
     //***************** FFT setup and execution ***********************************************************************//
-    //***************** It takes around 2ms to perform FFT on a signal of 4096 points *********************************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    arm_rfft_fast_instance_f32 fft_instance;
-    arm_status status = arm_rfft_fast_init_f32(&fft_instance, sigSettingsHandle.numSamples_u16);
+    PROF_BEGIN(PROF_SIG_FFT_FFT);
+    FftReal_Instance_f32 fft_instance;
+    arm_status status = fft_real_init_f32(&fft_instance, sigSettingsHandle.numSamples_u32);
     if (status != ARM_MATH_SUCCESS) {
         send_uart_response("READ_FFT", "FAIL", "{\"error\":\"fft_init_failed\"}");
-        write_OrangeLed_PD13(GPIO_PIN_RESET);
+        write_OrangeLed_PD13(false);
         return;
     }
-    arm_rfft_fast_f32(&fft_instance, sigBUFFER_UNION.bufF32, sigBUFF2, 0); // Compute FFT (real input, complex output)
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    fft_real_f32(&fft_instance, sigBUFFER_UNION.bufF32, sigBUFF2); // Compute FFT (real input, complex output)
+    PROF_END(PROF_SIG_FFT_FFT);
 
     //***************** Compute magnitude spectrum from complex FFT ****************************************************//
-    //***************** It takes around 0.4ms to perform arm_cmplx_mag_f32 on a signal of 4096 points ******************//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    arm_cmplx_mag_f32(sigBUFF2, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16 / 2);
+    PROF_BEGIN(PROF_SIG_FFT_MAG);
+    arm_cmplx_mag_f32(sigBUFF2, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32 / 2);
     const float32_t coherent_gain_blackman = 1.0f / 0.42f;
-    arm_scale_f32(sigBUFFER_UNION.bufF32, (coherent_gain_blackman / (sigSettingsHandle.numSamples_u16 / 4)), sigBUFF2, sigSettingsHandle.numSamples_u16);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    arm_scale_f32(sigBUFFER_UNION.bufF32, (coherent_gain_blackman / (sigSettingsHandle.numSamples_u32 / 4)), sigBUFF2, sigSettingsHandle.numSamples_u32);
+    PROF_END(PROF_SIG_FFT_MAG);
 
     //***************** Send FFT Output as cmlx magnitude **************************************************************//
-    //***************** It takes around 100ms to send 2048points x 4 = 8.2kByte + Header at 921600 Baud-Rate ***********//
-    write_OrangeLed_PD13(GPIO_PIN_SET);
-    send_signal_header("SIG_FFT", &config, sigBUFF2, sigSettingsHandle.numSamples_u16 / 2, config.dataType, config.transferMode);
-    send_signal_payload(sigBUFF2, sigSettingsHandle.numSamples_u16 / 2, config.dataType, config.transferMode);
-    write_OrangeLed_PD13(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+    PROF_BEGIN(PROF_SIG_FFT_SEND_FFT);
+    send_signal_header("SIG_FFT", &config, sigBUFF2, sigSettingsHandle.numSamples_u32 / 2, config.dataType, config.transferMode);
+    send_signal_payload(sigBUFF2, sigSettingsHandle.numSamples_u32 / 2, config.dataType, config.transferMode);
+    PROF_END(PROF_SIG_FFT_SEND_FFT);
+
+    PROF_END(PROF_SIG_FFT_TOTAL);
+    write_OrangeLed_PD13(false);
 }
 
 
 
 
+/**
+ * @brief  Report the RAM budget of the FFT pipeline for every supported FFT length.
+ *
+ * Per length:
+ *  - "time_b"  : time-domain samples in sigBUFFER_UNION (SRAM)
+ *  - "spec_b"  : packed complex spectrum in sigBUFF2 (CCM)
+ *  - "win_b"   : half-length Blackman window cache (CCM)
+ *  - "split_b" : split-stage cosine table, only for lengths above FFT_CMSIS_RFFT_MAX_LEN (CCM)
+ *  - "fits"    : 1 if the working set fits the statically allocated buffers
+ * The CMSIS twiddle and bit-reversal tables are const and stay in flash.
+ *
+ * @param[in] json_str  Unused, command has no arguments.
+ */
+void handle_read_mem_budget(const char *json_str)
+{
+    (void)json_str;
+
+    const uint32_t ccmUsed_u32 = (uint32_t)(&_eccmram - &_sccmram) + (uint32_t)(&_eccmram_bss - &_sccmram_bss);
+
+    printToDebugUartBlocking("{\"cmd\":\"READ_MEM_BUDGET\",\"status\":\"OK\",\"args\":{");
+    printToDebugUartBlocking("\"ccm_used\":%lu,\"ccm_size\":%lu,\"sram_sig\":%lu,\"max_fft\":%lu,\"lengths\":[",
+                             (unsigned long)ccmUsed_u32, (unsigned long)MEM_CCM_SIZE,
+                             (unsigned long)sizeof(sigBUFFER_UNION), (unsigned long)FFT_MAX_LEN);
+
+    const uint32_t numLengths_u32 = get_num_supported_fft_lengths();
+    for (uint32_t i = 0U; i < numLengths_u32; ++i) {
+        const uint32_t len_u32   = get_supported_fft_length_at(i);
+        const uint32_t time_u32  = len_u32 * sizeof(float32_t);
+        const uint32_t spec_u32  = len_u32 * sizeof(float32_t);
+        const uint32_t win_u32   = (len_u32 / 2U) * sizeof(float32_t);
+        const uint32_t split_u32 = (len_u32 > FFT_CMSIS_RFFT_MAX_LEN) ? (((FFT_MAX_LEN / 4U) + 1U) * sizeof(float32_t)) : 0U;
+        const bool     fits      = (time_u32 <= sizeof(sigBUFFER_UNION)) &&
+                                   (spec_u32 <= sizeof(sigBUFF2)) &&
+                                   (win_u32  <= sizeof(sigWINDOW_CACHE));
+
+        printToDebugUartBlocking("{\"len\":%lu,\"time_b\":%lu,\"spec_b\":%lu,\"win_b\":%lu,\"split_b\":%lu,\"fits\":%u}%s",
+                                 (unsigned long)len_u32, (unsigned long)time_u32, (unsigned long)spec_u32,
+                                 (unsigned long)win_u32, (unsigned long)split_u32, fits ? 1U : 0U,
+                                 (i < (numLengths_u32 - 1U)) ? "," : "");
+    }
+    printToDebugUartBlocking("]}}\r\n");
+}
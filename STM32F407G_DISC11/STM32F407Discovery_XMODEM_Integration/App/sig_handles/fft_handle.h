@@ -20,12 +20,17 @@
  *
  * @param[in] json_str  Pointer to JSON string containing generation parameters:
  *                      - "num_tones" (uint16): Number of sine components.
- *                      - "len" (uint16): Number of samples to generate (must be a power of 2).
+ *                      - "len" (uint32): Number of samples to generate (rounded down to a supported FFT length).
  *                      - "freqs" (array of uint32): Frequencies in Hz.
  *                      - "amps" (array of uint16): Amplitudes in mV.
  */
 void handle_read_fft(const char *json_str);
 void handle_read_sig_fft(const char *json_str);
 
+/**
+ * @brief  Print the SRAM/CCM budget of the FFT pipeline per supported FFT length (JSON).
+ */
+void handle_read_mem_budget(const char *json_str);
+
 #endif /* FFT_HANDLE_H_ */
 
@@ -19,9 +19,13 @@
 /**
  * @brief  Handle JSON command to generate a composite signal, scale it to float32, and send ASCII numbers in JSON or binary.
  *
+ * Signals up to MAX_SIG_LEN samples are generated in one go and sent with the CRC in the header.
+ * Longer signals (up to SIG_STREAM_MAX_LEN) are generated and sent block by block through the
+ * sample buffer; the header announces the block length and a trailer carries the CRC.
+ *
  * @param[in] json_str  Pointer to JSON string containing generation parameters:
  *                      - "num_tones" (uint16): Number of sine components.
- *                      - "len" (uint16): Number of samples to generate (will be clipped to max buffer length).
+ *                      - "len" (uint32): Number of samples to generate (clipped to SIG_STREAM_MAX_LEN).
  *                      - "freqs" (array of uint32): Frequencies in Hz.
  *                      - "amps" (array of uint16): Amplitudes in mV.
  *                      - "data_type" (optional, enum): Output data type.
@@ -29,19 +33,23 @@
  */
 void handle_read_scaled_signal(const char *json_str)
 {
-    write_BlueLed_PD15(GPIO_PIN_SET);
+    write_BlueLed_PD15(true);
 
     JsonParsedSigGenPar_HandlType_t config;
 
     // --- Parse and Validate JSON Parameters; fill config struct (may apply defaults for missing fields) ---
     if (parse_and_validate_signal_config(json_str, "READ_SCALED_SIG", &config) != 0) {
-        write_BlueLed_PD15(GPIO_PIN_RESET);
+        write_BlueLed_PD15(false);
         return;  // Early exit on error
     }
 
+    const uint32_t totalSamples_u32 = config.numSamples_u32;
+    const bool     streamed         = (totalSamples_u32 > MAX_SIG_LEN);
+
     // --- Setup signal generation handle; adapt if you want more fields configurable ---
     SignalGen_HandleType sigSettingsHandle = {
-        .numSamples_u16        = config.numSamples_u16,
+        .numSamples_u32        = streamed ? MAX_SIG_LEN : totalSamples_u32,
+        .startSample_u32       = 0U,
         .samplingRate_u32      = config.sampl_rate,
         .dcOffset_u16          = 1650U,        // Hardcoded DC offset [mV]
         .vRef_u16              = 3300U,        // Hardcoded reference voltage [mV]
@@ -49,31 +57,51 @@ void handle_read_scaled_signal(const char *json_str)
         .numTones_u8           = (uint8_t)config.numTones_u16,
         .pToneFreqs_u32        = config.pFreqs,
         .pToneAmps_u16         = config.pAmps,
+        .pWave                 = config.pWave,
         .sineMethod            = SINE_METHOD_CMSIS,
         .dataType              = DATA_TYPE_FLOAT32,  // Always float32 output for this handler
         .pOutBuffer_f32        = sigBUFFER_UNION.bufF32,   // Main float output buffer
         .pOutBuffer_u16        = NULL               // Not used
     };
 
-    write_BlueLed_PD15(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
-
-    // --- Generate Composite Signal in float32 ---
-    write_BlueLed_PD15(GPIO_PIN_SET);
-    SignalGen_GenerateComposite(&sigSettingsHandle);
-    write_BlueLed_PD15(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
-
     // Convert mV to [-1, 1] based on your Vref:
     float32_t mv_to_unit = 1.0f / sigSettingsHandle.vRef_u16;  // i.e., 1/3300 for 3.3V
-    // Convert mV → unit scale (V/V)
-    arm_scale_f32(sigBUFFER_UNION.bufF32, mv_to_unit, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16);
-
-    // --- Send response using unified JSON/ASCII or binary protocol ---
-    write_BlueLed_PD15(GPIO_PIN_SET);
-    //send_signal_response("READ_SCALED_SIG", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    send_signal_header("READ_SCALED_SIG", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    send_signal_payload(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u16, config.dataType, config.transferMode);
-    write_BlueLed_PD15(GPIO_PIN_RESET);
-    platform_delay_ms(1U);
+
+    if (!streamed)
+    {
+        // --- Generate Composite Signal in float32 ---
+        SignalGen_GenerateComposite(&sigSettingsHandle);
+
+        // Convert mV → unit scale (V/V)
+        arm_scale_f32(sigBUFFER_UNION.bufF32, mv_to_unit, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32);
+
+        // --- Send response using unified JSON/ASCII or binary protocol ---
+        //send_signal_response("READ_SCALED_SIG", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+        send_signal_header("READ_SCALED_SIG", &config, sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+        send_signal_payload(sigBUFFER_UNION.bufF32, sigSettingsHandle.numSamples_u32, config.dataType, config.transferMode);
+        write_BlueLed_PD15(false);
+        return;
+    }
+
+    // --- Streamed: generate and send MAX_SIG_LEN blocks from one persistent generator, the phase continues ---
+    send_signal_stream_header("READ_SCALED_SIG", &config, totalSamples_u32, MAX_SIG_LEN, config.dataType, config.transferMode);
+
+    SignalGen_State_t genState;
+    SignalGen_StateInit(&genState, &sigSettingsHandle);
+    genState.noise_mV = 5.0f;
+
+    uint32_t crc_u32 = 0U;
+    while (genState.sampleIdx_u32 < totalSamples_u32)
+    {
+        const uint32_t remaining_u32 = totalSamples_u32 - genState.sampleIdx_u32;
+        const uint32_t blockLen_u32  = (remaining_u32 > MAX_SIG_LEN) ? MAX_SIG_LEN : remaining_u32;
+
+        SignalGen_Next(&genState, blockLen_u32, DATA_TYPE_FLOAT32, sigBUFFER_UNION.bufF32);
+        arm_scale_f32(sigBUFFER_UNION.bufF32, mv_to_unit, sigBUFFER_UNION.bufF32, blockLen_u32);
+        crc_u32 = send_signal_stream_block(sigBUFFER_UNION.bufF32, blockLen_u32,
+                                           config.dataType, config.transferMode, crc_u32);
+    }
+
+    send_signal_stream_trailer("READ_SCALED_SIG", totalSamples_u32, crc_u32);
+    write_BlueLed_PD15(false);
 }
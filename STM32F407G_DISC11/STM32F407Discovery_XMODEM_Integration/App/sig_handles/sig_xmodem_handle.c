@@ -14,10 +14,12 @@
 #include "uart_app.h"
 #include "xmodem_transmitter.h"
 
+#define SIG_XMODEM_TIMEOUT_MS   0xFFFFFFFFUL    // no timeout (was HAL_MAX_DELAY)
+
 void handle_read_GenSignal_Flex_Xmodem(const char *args)
 {
     const char *cmd_id = "READ_GEN_SIG_XMD";
-    write_BlueLed_PD15(GPIO_PIN_SET);
+    write_BlueLed_PD15(true);
 
     jsmn_parser parser;
     jsmntok_t tokens[64];
@@ -29,21 +31,32 @@ void handle_read_GenSignal_Flex_Xmodem(const char *args)
         return;
     }
 
-    uint16_t numTones = 0, numSamples = 0;
+    uint16_t numTones = 0;
+    uint32_t numSamples = 0;
     size_t parsedTones = 0, parsedAmps = 0;
 
-    if (!json_parse_u16(args, tokens, tok_count, "num_tones", &numTones) ||
-        !json_parse_u16(args, tokens, tok_count, "len", &numSamples) ||
-        !json_parse_array_u32(args, tokens, tok_count, "freqs", freqs_int, MAX_TONES, &parsedTones) ||
-        !json_parse_array_u16(args, tokens, tok_count, "amps", amps_int, MAX_TONES, &parsedAmps) ||
+    // json_parse_* return JSON_PARSE_OK (0) on success
+    if ((json_parse_u16(args, tokens, tok_count, "num_tones", &numTones) != JSON_PARSE_OK) ||
+        (json_parse_u32(args, tokens, tok_count, "len", &numSamples) != JSON_PARSE_OK) ||
+        (json_parse_array_u32(args, tokens, tok_count, "freqs", freqs_int, MAX_TONES, &parsedTones) != JSON_PARSE_OK) ||
+        (json_parse_array_u16(args, tokens, tok_count, "amps", amps_int, MAX_TONES, &parsedAmps) != JSON_PARSE_OK) ||
         parsedTones != numTones || parsedAmps != numTones)
     {
         send_uart_response(cmd_id, "FAIL", "{\"error\":\"missing_or_invalid_fields\"}");
         return;
     }
 
+    // XMODEM sends from one buffer: limit to the uint16_t view of the sample buffer
+    const uint32_t maxSamples = sizeof(sigBUFFER_UNION.bufU16) / sizeof(sigBUFFER_UNION.bufU16[0]);
+    if (numSamples > maxSamples) {
+        printToDebugUartBlocking("[DBG]: Warning: 'len'=%lu exceeds max=%lu. Clipping.\r\n",
+                                 (unsigned long)numSamples, (unsigned long)maxSamples);
+        numSamples = maxSamples;
+    }
+
     SignalGen_HandleType sigSettingsHandle = {
-        .numSamples_u16        = numSamples,
+        .numSamples_u32        = numSamples,
+        .startSample_u32       = 0u,
         .samplingRate_u32      = 1024000u,
         .dcOffset_u16           = 1650u,
         .vRef_u16               = 3300u,
@@ -57,17 +70,13 @@ void handle_read_GenSignal_Flex_Xmodem(const char *args)
         .pOutBuffer_u16         = sigBUFFER_UNION.bufU16
     };
 
-    write_BlueLed_PD15(GPIO_PIN_RESET); platform_delay_ms(1);
-    write_BlueLed_PD15(GPIO_PIN_SET);
 
     SignalGen_GenerateComposite_Q15(&sigSettingsHandle);
 
-    write_BlueLed_PD15(GPIO_PIN_RESET); platform_delay_ms(1);
-    write_BlueLed_PD15(GPIO_PIN_SET);
 
     // === JSON HEADER PRINT ===
     printToDebugUartBlocking("{\"cmd\":\"%s\",\"status\":\"OK\",\"args\":{", cmd_id);
-    printToDebugUartBlocking("\"num_tones\":%u,\"len\":%u,\"freqs\":[", numTones, numSamples);
+    printToDebugUartBlocking("\"num_tones\":%u,\"len\":%lu,\"freqs\":[", numTones, (unsigned long)numSamples);
     for (uint16_t i = 0; i < numTones; i++) {
         printToDebugUartBlocking("%lu%s", freqs_int[i], (i < numTones - 1) ? "," : "]");
     }
@@ -78,18 +87,18 @@ void handle_read_GenSignal_Flex_Xmodem(const char *args)
     printToDebugUartBlocking("}}\r\n");
 
     // === INITIATE XMODEM TRANSMISSION ===
-    const uint32_t bytes_to_send = sigSettingsHandle.numSamples_u16 * sizeof(uint16_t);
+    const uint32_t bytes_to_send = sigSettingsHandle.numSamples_u32 * sizeof(uint16_t);
     if (!xmodem_transmit_init((uint8_t *)sigSettingsHandle.pOutBuffer_u16, bytes_to_send)) {
         send_uart_response(cmd_id, "FAIL", "{\"error\":\"xmodem_init_failed\"}");
         return;
     }
 
-    uint32_t lastTick = HAL_GetTick();
+    uint32_t lastTick = platform_get_time_ms();
     while (xmodem_transmit_state() != XMODEM_TRANSMIT_COMPLETE &&
            xmodem_transmit_state() != XMODEM_TRANSMIT_ABORT_TRANSFER)
     {
-        xmodem_transmit_process(HAL_GetTick());
-        if ((HAL_GetTick() - lastTick) > HAL_MAX_DELAY) {
+        xmodem_transmit_process(platform_get_time_ms());
+        if ((platform_get_time_ms() - lastTick) > SIG_XMODEM_TIMEOUT_MS) {
             break;
         }
     }
@@ -100,7 +109,7 @@ void handle_read_GenSignal_Flex_Xmodem(const char *args)
         send_uart_response(cmd_id, "FAIL", "ABORT");
     }
 
-    write_BlueLed_PD15(GPIO_PIN_RESET); platform_delay_ms(1);
+    write_BlueLed_PD15(false);
 }
 
 
@@ -122,7 +131,7 @@ void handle_xmodem_test(const char *args)
 
     printToDebugUartBlocking("[DBG] Begin transmitting...\r\n");
     while (xmodem_transmit_state() != XMODEM_TRANSMIT_COMPLETE && xmodem_transmit_state() != XMODEM_TRANSMIT_ABORT_TRANSFER) {
-        xmodem_transmit_process(HAL_GetTick());
+        xmodem_transmit_process(platform_get_time_ms());
     }
 
     if (xmodem_transmit_state() == XMODEM_TRANSMIT_COMPLETE) {
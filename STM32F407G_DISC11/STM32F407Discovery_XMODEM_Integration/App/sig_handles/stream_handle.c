@@ -0,0 +1,298 @@
+/*
+ * stream_handle.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Continuous spectrum stream. Each frame:
+ *          acquire block (generator, phase continuous / ADC ping-pong) -> Blackman window
+ *          -> real FFT -> magnitude -> view selection (full / decimated / changed bins) -> UART
+ *
+ *      Frame header (one JSON line, see send_stream_frame_header()):
+ *          {"cmd":"STREAM_FFT","status":"OK","args":{"seq":..,"dropped":..,"view":..,"decim":..,"len":..,...}}
+ *      followed by the payload(s) of send_signal_payload(). Sequence numbers are frame slots;
+ *      a gap of N means N frames were dropped, and "dropped" carries the running total.
+ */
+
+#include <string.h>
+
+#include "stream_handle.h"
+#include "signal_gen.h"
+#include "board_config.h"
+#include "signal_memory.h"
+#include "uart_app.h"
+#include "json_utils.h"
+#include "fft_utils.h"
+#include "signal_transfer.h"
+#include "signal_config_parser.h"
+#include "spectrum_stream.h"
+#include "adc_capture.h"
+#include "crc_soft.h"
+
+#define JSMN_HEADER
+#include "jsmn.h"
+
+#define STREAM_VREF_MV      3300U
+#define STREAM_ADC_MAX      4095U
+
+typedef enum {
+    STREAM_MODE_DECIM = 0,  /**< full spectrum, decimated under back-pressure */
+    STREAM_MODE_DELTA       /**< changed bins between key frames */
+} StreamMode_t;
+
+typedef struct {
+    bool                            active;
+    JsonParsedSigGenPar_HandlType_t config;
+    uint32_t                        freqs_u32[MAX_TONES];  /**< own copy, the parser arrays are shared */
+    uint16_t                        amps_u16[MAX_TONES];
+    uint32_t                        fftLen_u32;
+    SignalGen_State_t               gen;                    /**< phase-continuous generator (SIG_SRC_GEN) */
+    StreamMode_t                    mode;
+    float32_t                       thr;
+    uint32_t                        keyframe_u32;
+    uint32_t                        sinceKey_u32;
+    bool                            refValid;               /**< streamRefSpectrum holds what the host holds */
+    uint32_t                        linkBaud_u32;
+    SpecStreamPacer_t               pacer;
+    FftReal_Instance_f32            fft;
+} StreamState_t;
+
+static StreamState_t stream;
+
+/* Spectrum known to the host (delta view reference) and index list of changed bins */
+static float32_t streamRefSpectrum[STREAM_MAX_LEN / 2U];
+static uint16_t  streamDeltaIdx[STREAM_MAX_LEN / 2U];
+
+/**
+ * @brief  Start the generator of the configured tones at sample 0 (consecutive blocks are continuous).
+ */
+static void stream_init_generator(void)
+{
+    const SignalGen_HandleType sigSettingsHandle = {
+        .startSample_u32       = 0U,
+        .samplingRate_u32      = stream.config.sampl_rate,
+        .dcOffset_u16          = 1650U,
+        .vRef_u16              = STREAM_VREF_MV,
+        .adcMaxValue_u16       = STREAM_ADC_MAX,
+        .numTones_u8           = (uint8_t)stream.config.numTones_u16,
+        .pToneFreqs_u32        = stream.freqs_u32,
+        .pToneAmps_u16         = stream.amps_u16,
+        .sineMethod            = SINE_METHOD_CMSIS,
+        .pWave                 = stream.config.pWave,
+    };
+    SignalGen_StateInit(&stream.gen, &sigSettingsHandle);
+    stream.gen.noise_mV = 5.0f;
+}
+
+/**
+ * @brief  Fill sigBUFFER_UNION.bufF32 with the next block in mV.
+ */
+static bool stream_acquire_block(void)
+{
+    if (stream.config.sigSource == SIG_SRC_ADC) {
+        const uint16_t *pBlock;
+
+        if (!adc_capture_is_running() && !adc_capture_start(stream.fftLen_u32, stream.config.sampl_rate)) {
+            return false;
+        }
+        const uint32_t timeout_ms = (uint32_t)((2ULL * stream.fftLen_u32 * 1000ULL) / adc_capture_get_stats()->actualRate_u32) + 100U;
+        if (!adc_capture_wait_block(&pBlock, NULL, timeout_ms)) {
+            return false;
+        }
+        const float32_t mVPerCode = (float32_t)STREAM_VREF_MV / (float32_t)STREAM_ADC_MAX;
+        for (uint32_t i = 0U; i < stream.fftLen_u32; ++i) {
+            sigBUFFER_UNION.bufF32[i] = (float32_t)pBlock[i] * mVPerCode;
+        }
+        return adc_capture_release_block();     // a torn block counts as a dropped frame
+    }
+
+    SignalGen_Next(&stream.gen, stream.fftLen_u32, DATA_TYPE_FLOAT32, sigBUFFER_UNION.bufF32);
+    return true;
+}
+
+/**
+ * @brief  Window, FFT and magnitude of the block in bufF32; result in sigBUFF2 (fftLen/2 bins).
+ */
+static void stream_compute_spectrum(void)
+{
+    const uint32_t numBins = stream.fftLen_u32 / 2U;
+
+    apply_blackman_window(sigBUFFER_UNION.bufF32, stream.fftLen_u32);
+    fft_real_f32(&stream.fft, sigBUFFER_UNION.bufF32, sigBUFF2);
+    arm_cmplx_mag_f32(sigBUFF2, sigBUFFER_UNION.bufF32, numBins);
+    const float32_t coherent_gain_blackman = 1.0f / 0.42f;
+    arm_scale_f32(sigBUFFER_UNION.bufF32, (coherent_gain_blackman / (stream.fftLen_u32 / 4U)), sigBUFF2, numBins);
+}
+
+/**
+ * @brief  Select the view within the frame budget and send the frame.
+ * @return View that was sent.
+ */
+static SpecView_t stream_send_frame(uint32_t seq_u32, uint32_t *pBytes_u32)
+{
+    const TransferMode_t mode   = stream.config.transferMode;
+    const uint32_t numBins      = stream.fftLen_u32 / 2U;
+    const uint32_t budget       = spec_stream_frame_budget(&stream.pacer);
+    const bool     keyframeDue  = !stream.refValid || (stream.sinceKey_u32 >= stream.keyframe_u32);
+
+    //***************** Changed bins only (indices, then values) ******************************************************//
+    if ((stream.mode == STREAM_MODE_DELTA) && !keyframeDue) {
+        uint32_t capacity = spec_stream_delta_capacity(budget, DATA_TYPE_FLOAT32, mode);
+        if (capacity > numBins) {
+            capacity = numBins;
+        }
+        float32_t *pVal = sigBUFFER_UNION.bufF32;   // free after stream_compute_spectrum()
+        const uint32_t numChanged = spec_stream_changed_bins(sigBUFF2, streamRefSpectrum, numBins, stream.thr,
+                                                             streamDeltaIdx, pVal, capacity);
+        if (numChanged <= capacity) {
+            uint32_t crc = 0U;      // binary payloads only, as for the full view
+            if (mode == TRANSFER_BINARY) {
+                crc = crc32_update(0U, (const uint8_t *)streamDeltaIdx, numChanged * sizeof(uint16_t));
+                crc = crc32_update(crc, (const uint8_t *)pVal, numChanged * sizeof(float32_t));
+            }
+
+            send_stream_frame_header("STREAM_FFT", seq_u32, stream.pacer.dropped_u32, SPEC_VIEW_DELTA, 1U,
+                                     numChanged, DATA_TYPE_FLOAT32, mode, crc);
+            send_signal_payload(streamDeltaIdx, numChanged, DATA_TYPE_UINT16, mode);
+            send_signal_payload(pVal, numChanged, DATA_TYPE_FLOAT32, mode);
+
+            for (uint32_t i = 0U; i < numChanged; ++i) {
+                streamRefSpectrum[streamDeltaIdx[i]] = pVal[i];
+            }
+            stream.sinceKey_u32++;
+            *pBytes_u32 = spec_stream_frame_bytes(numChanged, DATA_TYPE_FLOAT32, mode) +
+                          (numChanged * ((mode == TRANSFER_BINARY) ? 2U : 7U));
+            return SPEC_VIEW_DELTA;
+        }
+        // Too many changes for the link: fall through to a (decimated) full frame
+    }
+
+    //***************** Full or max-hold decimated spectrum ***********************************************************//
+    const uint32_t decim = spec_stream_select_decim(numBins, budget, DATA_TYPE_FLOAT32, mode);
+    uint32_t numOut = numBins;
+    SpecView_t view = SPEC_VIEW_FULL;
+    if (decim > 1U) {
+        numOut = spec_stream_decimate_max(sigBUFF2, sigBUFF2, numBins, decim);
+        view = SPEC_VIEW_DECIM;
+        stream.refValid = false;    // host holds no full-resolution spectrum now
+    } else {
+        memcpy(streamRefSpectrum, sigBUFF2, numBins * sizeof(float32_t));
+        stream.refValid = true;
+        stream.sinceKey_u32 = 0U;
+    }
+
+    const uint32_t crc = (mode == TRANSFER_BINARY) ? crc32_update(0U, (const uint8_t *)sigBUFF2, numOut * sizeof(float32_t)) : 0U;
+    send_stream_frame_header("STREAM_FFT", seq_u32, stream.pacer.dropped_u32, view, decim, numOut, DATA_TYPE_FLOAT32, mode, crc);
+    send_signal_payload(sigBUFF2, numOut, DATA_TYPE_FLOAT32, mode);
+
+    *pBytes_u32 = spec_stream_frame_bytes(numOut, DATA_TYPE_FLOAT32, mode);
+    return view;
+}
+
+void stream_task(void)
+{
+    uint32_t seq_u32;
+
+    if (!stream.active || !spec_stream_pacer_due(&stream.pacer, platform_get_time_ms(), &seq_u32)) {
+        return;
+    }
+
+    if (!stream_acquire_block()) {
+        spec_stream_pacer_drop(&stream.pacer);
+        return;
+    }
+    stream_compute_spectrum();
+
+    uint32_t bytes_u32 = 0U;
+    const uint32_t txStart_ms = platform_get_time_ms();
+    SpecView_t view = stream_send_frame(seq_u32, &bytes_u32);
+    spec_stream_pacer_sent(&stream.pacer, bytes_u32, platform_get_time_ms() - txStart_ms, view);
+}
+
+bool stream_is_active(void)
+{
+    return stream.active;
+}
+
+void handle_start_stream(const char *json_str)
+{
+    JsonParsedSigGenPar_HandlType_t config;
+
+    if (parse_and_validate_signal_config(json_str, "START_STREAM", &config) != 0) {
+        return;
+    }
+
+    /* --- Stream specific arguments --- */
+    jsmn_parser parser;
+    jsmntok_t tokens[MAX_JSON_TOKENS];
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, MAX_JSON_TOKENS);
+
+    uint32_t fps_u32      = STREAM_DEFAULT_FPS;
+    uint32_t thr_u32      = 1U;
+    uint32_t keyframe_u32 = STREAM_DEFAULT_KEYFRAME;
+    uint16_t view_u16     = (uint16_t)STREAM_MODE_DECIM;
+    (void)json_parse_u32(json_str, tokens, tokCount, "fps", &fps_u32);
+    (void)json_parse_u32(json_str, tokens, tokCount, "thr_mv", &thr_u32);
+    (void)json_parse_u32(json_str, tokens, tokCount, "keyframe", &keyframe_u32);
+    (void)json_parse_u16(json_str, tokens, tokCount, "view", &view_u16);
+
+    if ((fps_u32 == 0U) || (fps_u32 > STREAM_MAX_FPS)) {
+        send_uart_response("START_STREAM", "FAIL", "{\"error\":\"fps_out_of_range\"}");
+        return;
+    }
+
+    uint32_t maxLen = (config.sigSource == SIG_SRC_ADC) ? ADC_CAPTURE_MAX_BLOCK_LEN : STREAM_MAX_LEN;
+    uint32_t fftLen = get_supported_fft_length((config.numSamples_u32 < maxLen) ? config.numSamples_u32 : maxLen);
+    if (!is_valid_fft_length(fftLen) || (fft_real_init_f32(&stream.fft, fftLen) != ARM_MATH_SUCCESS)) {
+        send_uart_response("START_STREAM", "FAIL", "{\"error\":\"unsupported_length\"}");
+        return;
+    }
+
+    /* --- (Re)start --- */
+    if (stream.active && (stream.config.sigSource == SIG_SRC_ADC)) {
+        adc_capture_stop();
+    }
+
+    stream.config = config;
+    memcpy(stream.freqs_u32, config.pFreqs, sizeof(stream.freqs_u32));
+    memcpy(stream.amps_u16, config.pAmps, sizeof(stream.amps_u16));
+    stream.config.pFreqs    = stream.freqs_u32;
+    stream.config.pAmps     = stream.amps_u16;
+    stream.fftLen_u32       = fftLen;
+    stream_init_generator();
+    stream.mode             = (view_u16 == (uint16_t)STREAM_MODE_DELTA) ? STREAM_MODE_DELTA : STREAM_MODE_DECIM;
+    stream.thr              = (float32_t)thr_u32;
+    stream.keyframe_u32     = (keyframe_u32 == 0U) ? 1U : keyframe_u32;
+    stream.sinceKey_u32     = 0U;
+    stream.refValid         = false;
+    stream.linkBaud_u32     = platform_uart_get_baud(PLATFORM_UART_DEBUG);
+
+    send_uart_response("START_STREAM", "OK", "{\"len\":%lu,\"bins\":%lu,\"fps\":%lu,\"view\":%u,\"budget\":%lu}",
+                       (unsigned long)fftLen, (unsigned long)(fftLen / 2U), (unsigned long)fps_u32, (unsigned)stream.mode,
+                       (unsigned long)(((stream.linkBaud_u32 / 10U) * SPEC_STREAM_TX_DUTY_PCT) / (100U * fps_u32)));
+
+    spec_stream_pacer_init(&stream.pacer, 1000U / fps_u32, platform_get_time_ms(), stream.linkBaud_u32);
+    stream.active = true;
+}
+
+void handle_stop_stream(const char *json_str)
+{
+    (void)json_str;
+
+    if (!stream.active) {
+        send_uart_response("STOP_STREAM", "FAIL", "{\"error\":\"not_streaming\"}");
+        return;
+    }
+
+    stream.active = false;
+    if (stream.config.sigSource == SIG_SRC_ADC) {
+        adc_capture_stop();
+    }
+
+    send_uart_response("STOP_STREAM", "OK", "{\"last_seq\":%lu,\"sent\":%lu,\"dropped\":%lu,\"reduced\":%lu,\"bytes_per_ms\":%lu}",
+                       (unsigned long)stream.pacer.lastSlot_u32, (unsigned long)stream.pacer.sent_u32,
+                       (unsigned long)stream.pacer.dropped_u32, (unsigned long)stream.pacer.reduced_u32,
+                       (unsigned long)(stream.pacer.bytesPerMsQ8_u32 >> 8U));
+}
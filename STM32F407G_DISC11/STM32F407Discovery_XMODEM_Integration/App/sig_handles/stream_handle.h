@@ -0,0 +1,49 @@
+/*
+ * stream_handle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Continuous spectrum streaming (START_STREAM / STOP_STREAM).
+ *      The command handlers only configure the stream; the frames are produced by
+ *      stream_task(), which the state machine calls on every pass of its loop, so
+ *      commands (e.g. STOP_STREAM) are still served between two frames.
+ */
+
+#ifndef SIG_HANDLES_STREAM_HANDLE_H_
+#define SIG_HANDLES_STREAM_HANDLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STREAM_MAX_LEN          4096U   /* FFT length limit, = ADC_CAPTURE_MAX_BLOCK_LEN */
+#define STREAM_DEFAULT_FPS      10U
+#define STREAM_MAX_FPS          100U
+#define STREAM_DEFAULT_KEYFRAME 16U     /* a full frame at least every N frames in the delta view */
+
+/**
+ * @brief  Start streaming spectra at a fixed frame rate.
+ *
+ * @param[in] json_str  Signal parameters as for READ_FFT (incl. "sig_source") plus:
+ *                      - "fps" (uint32, optional): frame rate, 1..STREAM_MAX_FPS (default 10).
+ *                      - "view" (uint16, optional): 0 = full, decimated when the link is too slow,
+ *                                                   1 = changed bins only between key frames.
+ *                      - "thr_mv" (uint32, optional): change threshold of the delta view (default 1).
+ *                      - "keyframe" (uint32, optional): full frame every N frames (default 16).
+ */
+void handle_start_stream(const char *json_str);
+
+/**
+ * @brief  Stop the stream and report the frame statistics.
+ */
+void handle_stop_stream(const char *json_str);
+
+/**
+ * @brief  Produce the next frame if it is due (call from the main loop).
+ */
+void stream_task(void);
+
+bool stream_is_active(void);
+
+#endif /* SIG_HANDLES_STREAM_HANDLE_H_ */
@@ -0,0 +1,140 @@
+/*
+ * trig_handle.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      READ_TRIG command. The sample stream is fed block by block into the trigger
+ *      engine (trigger.h) until the window is complete or the timeout expires:
+ *          - SIG_SRC_CALC : generator blocks of ADC codes, phase continuous
+ *          - SIG_SRC_ADC  : ADC ping-pong blocks at the requested sample rate
+ *      The response is an info line followed by the window as a uint16 signal
+ *      (send_signal_header() / send_signal_payload()).
+ */
+
+#include <string.h>
+
+#include "trig_handle.h"
+#include "trigger.h"
+#include "signal_gen.h"
+#include "board_config.h"
+#include "signal_memory.h"
+#include "uart_app.h"
+#include "json_utils.h"
+#include "signal_transfer.h"
+#include "signal_config_parser.h"
+#include "adc_capture.h"
+
+#define JSMN_HEADER
+#include "jsmn.h"
+
+static uint16_t trigPreRing[TRIG_MAX_PRE];
+static uint16_t trigGenBlock[TRIG_BLOCK_LEN];
+
+/**
+ * @brief  Run the engine on the selected source until DONE or timeout.
+ * @return true if the window is complete.
+ */
+static bool trig_run_source(TrigEngine_t *pEng, const JsonParsedSigGenPar_HandlType_t *config, uint32_t timeout_ms)
+{
+    const uint32_t start_ms = platform_get_time_ms();
+
+    if (config->sigSource == SIG_SRC_ADC) {
+        if (!adc_capture_start(TRIG_BLOCK_LEN, config->sampl_rate)) {
+            return false;
+        }
+        const uint16_t *pBlock;
+        while (pEng->state != TRIG_STATE_DONE) {
+            const uint32_t elapsed = platform_get_time_ms() - start_ms;
+            if ((elapsed > timeout_ms) || !adc_capture_wait_block(&pBlock, NULL, timeout_ms - elapsed)) {
+                break;
+            }
+            trig_process_block(pEng, pBlock, TRIG_BLOCK_LEN);
+            adc_capture_release_block();
+        }
+        adc_capture_stop();
+        return pEng->state == TRIG_STATE_DONE;
+    }
+
+    SignalGen_HandleType sigSettingsHandle = {
+        .startSample_u32       = 0U,
+        .samplingRate_u32      = config->sampl_rate,
+        .dcOffset_u16          = 1650U,
+        .vRef_u16              = 3300U,
+        .adcMaxValue_u16       = 4095U,
+        .numTones_u8           = (uint8_t)config->numTones_u16,
+        .pToneFreqs_u32        = config->pFreqs,
+        .pToneAmps_u16         = config->pAmps,
+        .sineMethod            = SINE_METHOD_CMSIS,
+        .pWave                 = config->pWave
+    };
+    SignalGen_State_t genState;
+    SignalGen_StateInit(&genState, &sigSettingsHandle);
+
+    while ((pEng->state != TRIG_STATE_DONE) && ((platform_get_time_ms() - start_ms) <= timeout_ms)) {
+        SignalGen_Next(&genState, TRIG_BLOCK_LEN, DATA_TYPE_UINT16, trigGenBlock);
+        trig_process_block(pEng, trigGenBlock, TRIG_BLOCK_LEN);
+    }
+    return pEng->state == TRIG_STATE_DONE;
+}
+
+void handle_read_trig(const char *json_str)
+{
+    write_OrangeLed_PD13(true);
+    JsonParsedSigGenPar_HandlType_t config;
+    if (parse_and_validate_signal_config(json_str, "READ_TRIG", &config) != 0) {
+        write_OrangeLed_PD13(false);
+        return;
+    }
+
+    /* --- Trigger arguments --- */
+    jsmn_parser parser;
+    jsmntok_t tokens[MAX_JSON_TOKENS];
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, MAX_JSON_TOKENS);
+
+    uint16_t mode_u16   = (uint16_t)TRIG_RISING;
+    uint32_t timeout_ms = TRIG_DEFAULT_TIMEOUT_MS;
+    TrigConfig_t trigCfg = {
+        .mode          = TRIG_RISING,
+        .level_u16     = 2048U,
+        .levelHigh_u16 = 4095U,
+        .preTrig_u32   = 256U,
+        .postTrig_u32  = 768U,
+        .holdoff_u32   = 0U
+    };
+    (void)json_parse_u16(json_str, tokens, tokCount, "trig_mode", &mode_u16);
+    (void)json_parse_u16(json_str, tokens, tokCount, "level", &trigCfg.level_u16);
+    (void)json_parse_u16(json_str, tokens, tokCount, "level_hi", &trigCfg.levelHigh_u16);
+    (void)json_parse_u32(json_str, tokens, tokCount, "pre", &trigCfg.preTrig_u32);
+    (void)json_parse_u32(json_str, tokens, tokCount, "post", &trigCfg.postTrig_u32);
+    (void)json_parse_u32(json_str, tokens, tokCount, "holdoff", &trigCfg.holdoff_u32);
+    (void)json_parse_u32(json_str, tokens, tokCount, "timeout_ms", &timeout_ms);
+    trigCfg.mode = (TrigMode_t)mode_u16;
+
+    TrigEngine_t engine;
+    if (((trigCfg.preTrig_u32 + trigCfg.postTrig_u32) > TRIG_MAX_WINDOW) ||
+        !trig_init(&engine, &trigCfg, trigPreRing, TRIG_MAX_PRE, sigBUFFER_UNION.bufU16)) {
+        send_uart_response("READ_TRIG", "FAIL", "{\"error\":\"invalid_trigger_config\"}");
+        write_OrangeLed_PD13(false);
+        return;
+    }
+
+    /* --- Scan until triggered --- */
+    if (!trig_run_source(&engine, &config, timeout_ms)) {
+        send_uart_response("READ_TRIG", "FAIL", "{\"error\":\"no_trigger\",\"scanned\":%lu}",
+                           (unsigned long)engine.sampleIdx_u32);
+        write_OrangeLed_PD13(false);
+        return;
+    }
+
+    const uint32_t adcDropped = (config.sigSource == SIG_SRC_ADC) ? adc_capture_get_stats()->dropped_u32 : 0U;
+    send_uart_response("READ_TRIG", "OK", "{\"trig_idx\":%lu,\"pre\":%lu,\"post\":%lu,\"adc_dropped\":%lu}",
+                       (unsigned long)engine.trigIdx_u32, (unsigned long)trigCfg.preTrig_u32,
+                       (unsigned long)trigCfg.postTrig_u32, (unsigned long)adcDropped);
+
+    send_signal_header("READ_TRIG", &config, engine.pOut, engine.outLen_u32, DATA_TYPE_UINT16, config.transferMode);
+    send_signal_payload(engine.pOut, engine.outLen_u32, DATA_TYPE_UINT16, config.transferMode);
+    write_OrangeLed_PD13(false);
+}
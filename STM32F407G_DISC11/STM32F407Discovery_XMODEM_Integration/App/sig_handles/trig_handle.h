@@ -0,0 +1,35 @@
+/*
+ * trig_handle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      READ_TRIG: triggered capture on the generated or ADC sample stream.
+ */
+
+#ifndef SIG_HANDLES_TRIG_HANDLE_H_
+#define SIG_HANDLES_TRIG_HANDLE_H_
+
+#include <stdint.h>
+
+#define TRIG_MAX_PRE            4096U   /* pre-trigger ring depth [samples] */
+#define TRIG_MAX_WINDOW         8192U   /* pre + post [samples], = MAX_SIG_LEN */
+#define TRIG_BLOCK_LEN          512U    /* samples per scanned block */
+#define TRIG_DEFAULT_TIMEOUT_MS 1000U
+
+/**
+ * @brief  Capture the window around the first trigger event and send it as ADC codes.
+ *
+ * @param[in] json_str  Signal parameters as for READ_FFT (incl. "sig_source") plus:
+ *                      - "trig_mode" (uint16): 0 = rising, 1 = falling, 2 = level, 3 = window.
+ *                      - "level" (uint16): trigger level in ADC codes (window: lower bound).
+ *                      - "level_hi" (uint16, window only): upper bound in ADC codes.
+ *                      - "pre" (uint32): samples before the trigger (<= TRIG_MAX_PRE).
+ *                      - "post" (uint32): samples from the trigger sample on.
+ *                      - "holdoff" (uint32, optional): samples after arming without triggering.
+ *                      - "timeout_ms" (uint32, optional): give up after this time (default 1000).
+ */
+void handle_read_trig(const char *json_str);
+
+#endif /* SIG_HANDLES_TRIG_HANDLE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * wave_handle.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      SET_WAVE_TABLE command, see wave_handle.h. The table lives in signal_memory
+ *      (sigWAVE_TABLE), the signal commands pick it up through parse_wave_config().
+ */
+
+#include <string.h>
+
+#include "wave_handle.h"
+#include "signal_memory.h"
+#include "board_config.h"
+#include "uart_app.h"
+#include "json_utils.h"
+
+#define JSMN_HEADER
+#include "jsmn.h"
+
+/* Index the next chunk has to start at (0 = no upload in progress) */
+static uint16_t waveNextOffset_u16 = 0U;
+
+void handle_set_wave_table(const char *json_str)
+{
+    write_OrangeLed_PD13(true);
+
+    jsmn_parser parser;
+    jsmntok_t tokens[MAX_JSON_TOKENS];
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, MAX_JSON_TOKENS);
+
+    uint16_t total_u16  = 0U;
+    uint16_t offset_u16 = 0U;
+    size_t   count      = 0U;
+    int16_t  chunk[WAVE_TABLE_CHUNK_MAX];
+
+    // json_parse_array_u16 converts with atoi(), negative values arrive as two's complement
+    if ((tokCount < 1) ||
+        (json_parse_u16(json_str, tokens, tokCount, "total", &total_u16) != JSON_PARSE_OK) ||
+        (json_parse_u16(json_str, tokens, tokCount, "offset", &offset_u16) != JSON_PARSE_OK) ||
+        (json_parse_array_u16(json_str, tokens, tokCount, "data", (uint16_t *)chunk, WAVE_TABLE_CHUNK_MAX, &count) != JSON_PARSE_OK) ||
+        (count == 0U) || (total_u16 == 0U) || (total_u16 > MAX_WAVE_TABLE_LEN) ||
+        (((uint32_t)offset_u16 + count) > total_u16))
+    {
+        send_uart_response("SET_WAVE_TABLE", "FAIL", "{\"error\":\"missing_or_invalid_fields\"}");
+        write_OrangeLed_PD13(false);
+        return;
+    }
+
+    if (offset_u16 == 0U) {
+        sigWaveTableLen_u16 = 0U;           // new upload: old table is gone
+    } else if (offset_u16 != waveNextOffset_u16) {
+        send_uart_response("SET_WAVE_TABLE", "FAIL", "{\"error\":\"unexpected_offset\",\"expected\":%u}",
+                           (unsigned)waveNextOffset_u16);
+        write_OrangeLed_PD13(false);
+        return;
+    }
+
+    memcpy(&sigWAVE_TABLE[offset_u16], chunk, count * sizeof(chunk[0]));
+    waveNextOffset_u16 = (uint16_t)(offset_u16 + count);
+
+    if (waveNextOffset_u16 == total_u16) {
+        sigWaveTableLen_u16 = total_u16;    // complete: SIG_MODE_TABLE uses it from now on
+        waveNextOffset_u16  = 0U;
+    }
+
+    send_uart_response("SET_WAVE_TABLE", "OK", "{\"offset\":%u,\"count\":%u,\"loaded\":%u}",
+                       (unsigned)offset_u16, (unsigned)count, (unsigned)sigWaveTableLen_u16);
+    write_OrangeLed_PD13(false);
+}
@@ -0,0 +1,32 @@
+/*
+ * wave_handle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      SET_WAVE_TABLE: upload of the user waveform table for "wave" = SIG_MODE_TABLE.
+ */
+
+#ifndef SIG_HANDLES_WAVE_HANDLE_H_
+#define SIG_HANDLES_WAVE_HANDLE_H_
+
+#include <stdint.h>
+
+#define WAVE_TABLE_CHUNK_MAX    48U     /* values per command, limited by MAX_JSON_TOKENS */
+
+/**
+ * @brief  Store one chunk of the waveform table (one period, Q15 values -32768..32767).
+ *
+ * The table becomes active when its last chunk has arrived; while it is loaded,
+ * SIG_MODE_TABLE falls back to a plain sine.
+ *
+ * @param[in] json_str  JSON command with:
+ *                      - "total" (uint16): table length (<= MAX_WAVE_TABLE_LEN).
+ *                      - "offset" (uint16): index of the first value; 0 starts a new table,
+ *                        further chunks must continue where the previous one ended.
+ *                      - "data" (array of int16): up to WAVE_TABLE_CHUNK_MAX values.
+ */
+void handle_set_wave_table(const char *json_str);
+
+#endif /* SIG_HANDLES_WAVE_HANDLE_H_ */
@@ -19,6 +19,14 @@
 #include "xmodem_transmitter.h"
 
 #include "signal_gen.h"
+#include "signal_memory.h"
+#include "profiling.h"
+#include "bench.h"
+#include "adc_capture.h"
+#include "stream_handle.h"
+#include "trig_handle.h"
+#include "audio_handle.h"
+#include "wave_handle.h"
 #include "json_utils.h"
 #define JSMN_HEADER
 #include "jsmn.h"  // declares only
@@ -30,9 +38,6 @@ typedef struct {
     void (*handler)(const char *args);
 } command_entry_t;
 
-/* Private function prototypes -----------------------------------------------*/
-void execute_command(void);
-
 static const command_entry_t command_table[] = {
     { "READ_FW", handle_read_fw },
 	{ "READ_SER", handle_read_ser },
@@ -42,6 +47,17 @@ static const command_entry_t command_table[] = {
 	{"READ_FFT", handle_read_fft},
 	{"READ_SCALED_SIG", handle_read_scaled_signal},
 	{"READ_SIG_FFT", handle_read_sig_fft},
+	{"READ_MEM_BUDGET", handle_read_mem_budget},
+	{"READ_PROFILE", handle_read_profile},
+	{"RUN_BENCH", handle_run_bench},
+	{"BENCH_BASELINE", handle_bench_baseline},
+	{"START_STREAM", handle_start_stream},
+	{"STOP_STREAM", handle_stop_stream},
+	{"READ_TRIG", handle_read_trig},
+	{"AUDIO_START", handle_audio_start},
+	{"AUDIO_SET", handle_audio_set},
+	{"AUDIO_STOP", handle_audio_stop},
+	{"SET_WAVE_TABLE", handle_set_wave_table},
 };
 
 #define NUM_COMMANDS (sizeof(command_table) / sizeof(command_table[0]))
@@ -50,9 +66,18 @@ volatile uint8_t cmdTransferFinished = 0;
 
 void state_machine(void)
 {
-	// Start first DMA reception (per‐byte). After the first byte of data is received it will call HAL_UART_RxCpltCallback located uart_app.c, then the callback will be restarted there.
-	HAL_UART_Receive_DMA(DEBUG_UART_HANDLE, (uint8_t*)uart2_rxBuf, DMA_BUFFER_SIZE);
-	HAL_UART_Receive_DMA(DEBUG2_UART_HANDLE, (uint8_t*)uart3_rxBuf, DMA_BUFFER_SIZE);
+	// Refuse to start any DMA transfer if a DMA buffer ended up in CCM (not reachable by DMA).
+	signal_memory_check_placement();
+
+	// Start the cycle counter used by the profiling probes (no-op if PROFILING_ENABLED is 0)
+	prof_init();
+
+	// SIG_SRC_ADC captures through TIM2 -> ADC1 -> DMA2 Stream0 (started on demand)
+	adc_capture_init(&adcCaptureHwF407);
+
+	// Start first DMA reception (per‐byte). After the first byte of data is received it will call uart_app_rx_complete() located uart_app.c (via HAL_UART_RxCpltCallback in board_config.c), then the callback will be restarted there.
+	platform_uart_start_rx(PLATFORM_UART_DEBUG, (uint8_t*)uart2_rxBuf, DMA_BUFFER_SIZE);
+	platform_uart_start_rx(PLATFORM_UART_DEBUG2, (uint8_t*)uart3_rxBuf, DMA_BUFFER_SIZE);
 	setup_xmodem_callbacks();
 
 	printToDebugUartBlocking("[DBG] Enter command:\r\n");
@@ -68,6 +93,7 @@ void state_machine(void)
                 break;
             case Command_State:
             	execute_command();
+            	stream_task();	// emits the next spectrum frame if START_STREAM is active and a frame is due
             	break;
             default:
                 break;
@@ -77,9 +103,10 @@ void state_machine(void)
 
 void execute_command(void)
 {
-    if (commandQueue.count > 0)
+    // Oldest command, parsed in place; its slot stays ours until released below
+    char *command = LF_SpscReadSlot(&commandQueue);
+    if (command != NULL)
     {
-        char *command = commandQueue.buffer[commandQueue.head];
         // Trim newline
         char *newline = strpbrk(command, "\r\n");
         if (newline) *newline = '\0';
@@ -133,8 +160,7 @@ void execute_command(void)
         }
 
         // Advance queue
-        commandQueue.head = (commandQueue.head + 1) % COMMAND_BUFFER_SIZE;
-        commandQueue.count--;
+        LF_SpscRelease(&commandQueue);
         printToDebugUartBlocking("\r\n[DBG]:Enter command:\r\n");
     }
 }
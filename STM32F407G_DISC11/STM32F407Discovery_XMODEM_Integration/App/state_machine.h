@@ -3,6 +3,7 @@
 #define STATE_MACHINE_H_
 
 void state_machine(void);
+void execute_command(void);     // one pass of the command loop (also driven by the host harness)
 
 typedef enum
 {
@@ -23,9 +23,6 @@ typedef struct {
 
 
 /* Private variables ---------------------------------------------------------*/
-UART_HandleTypeDef *DebugUart 	= DEBUG_UART_HANDLE;
-UART_HandleTypeDef *Debug2Uart 	= DEBUG2_UART_HANDLE;
-
 
 /* This is a FIFO buffers that store all incoming bytes in order.
    It decouples the DMA reception from the higher-level parsing logic.
@@ -41,13 +38,16 @@ UART_RingBuffer uart3_rxRingBuffer = {{0}, 0, 0};
 volatile char uart2_rxBuf[DMA_BUFFER_SIZE];
 volatile char uart3_rxBuf[DMA_BUFFER_SIZE];
 
-/* Purpose: This stores fully parsed commands (one command per line, up to 10 commands in parallel).
+/* Purpose: This stores fully parsed commands (one command per line, up to COMMAND_BUFFER_SIZE in parallel).
  * Each command can be up to 511 characters (plus \0).
+ * Lock-free SPSC ring: both RX callbacks are the producer (same NVIC priority, they never
+ * preempt each other), execute_command() in the main loop is the consumer and works on
+ * the slot in place, so a command arriving meanwhile can never touch it.
  */
-CommandBuffer commandQueue = {
-		.head = 0,
-		.tail = 0,
-		.count = 0 };
+_Static_assert((COMMAND_BUFFER_SIZE & (COMMAND_BUFFER_SIZE - 1)) == 0, "COMMAND_BUFFER_SIZE must be a power of 2");
+static char commandStore[COMMAND_BUFFER_SIZE][COMMAND_LENGTH];
+LF_Spsc_t commandQueue = LF_SPSC_INIT(commandStore, COMMAND_LENGTH, COMMAND_BUFFER_SIZE);
+static volatile uint32_t commandDropCounter = 0;	// Counts commands dropped because the command queue was full.
 
 /* Purpose: This is used for queued debug output when sending messages with DMA.
  * It stores formatted strings for transmission.
@@ -60,6 +60,7 @@ static volatile uint32_t overflowCounter = 0;	// Counts how many messages were d
 /* Private function prototypes -----------------------------------------------*/
 
 void RingBuffer_Write(UART_RingBuffer *ringBuffer, char newByte);
+static void enqueue_command(const char *command);
 
 /* Private function prototypes -----------------------------------------------*/
 /**
@@ -116,14 +117,15 @@ int RingBuffer_Read(UART_RingBuffer *ringBuffer, char *data)
  * and other standard output functions to send characters.
  *
  * In this implementation, each character is transmitted via
- * HAL_UART_Transmit() using the UART handle `DebugUart`.
+ * platform_uart_write() on the secondary debug UART.
  *
  * @param  ch Character to transmit
  * @return The transmitted character
  */
 int __io_putchar(int ch)
 {
-    HAL_UART_Transmit(Debug2Uart, (uint8_t*)&ch, 1, HAL_MAX_DELAY);
+    uint8_t byte = (uint8_t)ch;
+    platform_uart_write(PLATFORM_UART_DEBUG2, &byte, 1U);
     return ch;
 }
 
@@ -134,7 +136,7 @@ int __io_putchar(int ch)
  *
  * This function is a convenient wrapper similar to printf(). It formats
  * the input using vsnprintf() and transmits the full resulting message
- * using HAL_UART_Transmit() in blocking mode.
+ * using platform_uart_write() in blocking mode.
  *
  * Unlike printf(), which sends one character at a time via __io_putchar(),
  * this sends the entire message in one UART transaction.
@@ -150,7 +152,7 @@ void printToDebugUartBlocking(char *format, ...)
     vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
 
-    HAL_UART_Transmit(DebugUart, (uint8_t*)buffer, strlen(buffer), HAL_MAX_DELAY);
+    platform_uart_write(PLATFORM_UART_DEBUG, (const uint8_t*)buffer, strlen(buffer));
 }
 
 void printToDebug2UartBlocking(char *format, ...)
@@ -161,7 +163,7 @@ void printToDebug2UartBlocking(char *format, ...)
     vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
 
-    HAL_UART_Transmit(Debug2Uart, (uint8_t*)buffer, strlen(buffer), HAL_MAX_DELAY);
+    platform_uart_write(PLATFORM_UART_DEBUG2, (const uint8_t*)buffer, strlen(buffer));
 }
 
 /**
@@ -194,6 +196,32 @@ void send_uart_response(const char *cmd, const char *status, const char *payload
 }
 
 
+/**
+ * @brief  Copies one command into the next free `commandQueue` slot.
+ *
+ * The slot is filled in place and only then committed, so execute_command() never
+ * sees a partly copied command.
+ *
+ * @param  command  Null-terminated command, truncated to `COMMAND_LENGTH-1` characters.
+ *
+ * @note   Producer side of the queue: call only from the UART RX callbacks.
+ * @note   If the queue is full the command is dropped and counted in commandDropCounter.
+ */
+static void enqueue_command(const char *command)
+{
+    char *slot = LF_SpscWriteSlot(&commandQueue);
+    if (slot == NULL)
+    {
+        commandDropCounter++;
+        return;
+    }
+
+    strncpy(slot, command, COMMAND_LENGTH - 1);
+    slot[COMMAND_LENGTH - 1] = '\0';
+    LF_SpscCommit(&commandQueue);
+}
+
+
 /**
  * @brief  process_full_command_debug_uart - Queues full JSON or ASCII commands from the debug UART.
  *
@@ -207,7 +235,7 @@ void send_uart_response(const char *cmd, const char *status, const char *payload
  * @note The function no longer tokenizes input using `strtok` — JSON strings are preserved as-is.
  * @note Lines longer than `COMMAND_LENGTH-1` will be truncated before enqueuing.
  * @note Lines without a terminating `\n` will remain unprocessed until a newline is received.
- * @note `commandQueue` must be large enough to hold full commands; if full, new lines are dropped silently.
+ * @note `commandQueue` must be large enough to hold full commands; if full, new lines are dropped and counted.
  */
 
 void process_full_command_debug_uart(void)
@@ -227,13 +255,7 @@ void process_full_command_debug_uart(void)
                 command_line[cmd_pos] = '\0';  // Null-terminate the line
 
                 // Enqueue the full command line as a single entry
-                if (commandQueue.count < COMMAND_BUFFER_SIZE)
-                {
-                    strncpy(commandQueue.buffer[commandQueue.tail], command_line, COMMAND_LENGTH - 1);
-                    commandQueue.buffer[commandQueue.tail][COMMAND_LENGTH - 1] = '\0';
-                    commandQueue.tail = (commandQueue.tail + 1) % COMMAND_BUFFER_SIZE;
-                    commandQueue.count++;
-                }
+                enqueue_command(command_line);
 
                 break;  // Exit after a full line
             }
@@ -254,8 +276,8 @@ void process_full_command_debug_uart(void)
  * @note   Uses `SOFTWARE_RING_BUFFER_SIZE` for the temporary line buffer size.
  * @note   Tokens retain no trailing newline or delimiter characters.
  * @note   `commandQueue` must be large enough to hold all expected tokens;
- *         excess tokens are dropped silently if `commandQueue.count` reaches
- *         `COMMAND_BUFFER_SIZE`.
+ *         excess tokens are dropped (and counted) once `COMMAND_BUFFER_SIZE`
+ *         commands are waiting.
  */
 void process_full_command_app_uart(void)
 {
@@ -279,13 +301,7 @@ void process_full_command_app_uart(void)
     char *command = strtok(command_line, ":");
     while (command != NULL)
     {
-        if (commandQueue.count < COMMAND_BUFFER_SIZE)
-        {
-            strncpy(commandQueue.buffer[commandQueue.tail], command, COMMAND_LENGTH - 1);
-            commandQueue.buffer[commandQueue.tail][COMMAND_LENGTH - 1] = '\0';
-            commandQueue.tail = (commandQueue.tail + 1) % COMMAND_BUFFER_SIZE;
-            commandQueue.count++;
-        }
+        enqueue_command(command);
         command = strtok(NULL, ":");
     }
 }
@@ -435,7 +451,7 @@ void printToDebugUart(const char *format, ...)
         {
             txComplete = 0;                                       // mark busy
             // start DMA of the message at 'head', using stored length
-            if (HAL_UART_Transmit_DMA(DebugUart, (uint8_t*)uartQueue.buffer[uartQueue.head], uartQueue.length[uartQueue.head]) != HAL_OK)
+            if (!platform_uart_write_dma(PLATFORM_UART_DEBUG, (const uint8_t*)uartQueue.buffer[uartQueue.head], uartQueue.length[uartQueue.head]))
             {
                 txComplete = 1;                                   // on error, back to idle
             }
@@ -453,24 +469,22 @@ void printToDebugUart(const char *format, ...)
 /**
  * @brief  UART receive complete callback.
  *
- * This function is called by the HAL when a DMA‐driven UART reception
- * completes (i.e. when DMA_BUFFER_SIZE bytes have been received).
- * It checks that the interrupt came from the debug UART (DebugUart),
- * pushes the new byte into a software ring buffer, and when a newline
- * (‘\n’) is seen it calls process_full_command() to parse any complete
- * command(s). Finally, it re-arms the DMA reception for the next byte(s).
+ * Called from HAL_UART_RxCpltCallback() (board_config.c) when a DMA‐driven UART
+ * reception completes (i.e. when DMA_BUFFER_SIZE bytes have been received).
+ * It pushes the new byte into the software ring buffer of that port, and when
+ * the end-of-line character is seen it calls process_full_command_x() to parse
+ * any complete command(s). Finally, it re-arms the DMA reception for the next byte(s).
  *
- * @param  huart  Pointer to the UART handle for which the callback is invoked.
- *                Must be equal to DebugUart or Debug2Uart
+ * @param  port  UART port the byte was received on.
  *
  * @note   DMA_BUFFER_SIZE is typically 1 here for per-byte receive.
  * @note   uartx_rxRingBuffer and uartx_rxBuf are external globals.
  * @note   process_full_command() drains uart2_rxRingBuffer into your
  *         commandQueue when it sees a newline.
  */
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+void uart_app_rx_complete(PlatformUart_t port)
 {
-    if (huart == DebugUart)
+    if (port == PLATFORM_UART_DEBUG)
     {
     	// Add the received byte to the software circular buffer
         RingBuffer_Write(&uart2_rxRingBuffer, uart2_rxBuf[0]);
@@ -479,24 +493,17 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
         if (uart2_rxBuf[0] == '\n')
         	process_full_command_debug_uart();
     }
-    else if (huart == Debug2Uart)
+    else
     {
         // e.g. ringBuffer3, uart3_rxBuf[]
         RingBuffer_Write(&uart3_rxRingBuffer, uart3_rxBuf[0]);
         if (uart3_rxBuf[0] == '\r')
             // Signal that a full command has been received
-			//uint32_t tickstart = getTick();
         	process_full_command_app_uart();
-        	//uint32_t tickstart1 = getTick();
-        	//printToDebugUart("%ld-%ld=%ld\r\n",tickstart1, tickstart, (tickstart1-tickstart));
-    }
-    else
-    {
-        // Unexpected UART handle?
     }
 
     // Restart DMA reception for the next byte (automatically wraps in circular mode)
-    if (HAL_UART_Receive_DMA(huart, (uint8_t*)(huart == DebugUart ? uart2_rxBuf : uart3_rxBuf), DMA_BUFFER_SIZE) != HAL_OK)
+    if (!platform_uart_start_rx(port, (uint8_t*)(port == PLATFORM_UART_DEBUG ? uart2_rxBuf : uart3_rxBuf), DMA_BUFFER_SIZE))
     {
         // Optionally log or handle error
     }
@@ -508,11 +515,11 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
  *         and starts its DMA transmission. Marks the UART idle when
  *         no messages remain.
  *
- * @param  huart  Pointer to the UART handle for which the DMA TX just completed.
+ * @param  port  UART port whose DMA TX just completed.
  */
-void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) // callback invoked by HAL on DMA TX complete
+void uart_app_tx_complete(PlatformUart_t port) // called from HAL_UART_TxCpltCallback() on DMA TX complete
 {
-    if (huart == DebugUart)                                          // only handle DebugUart events
+    if (port == PLATFORM_UART_DEBUG)                                 // only the debug port uses the queue
     {
         uartQueue.head = (uartQueue.head + 1) % UART_TX_BUFFER_SIZE;    // advance head to the next message
         uartQueue.count--;                                           // decrement queued message count
@@ -521,7 +528,7 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) // callback invoked by H
         {
         	uint16_t len = uartQueue.length[uartQueue.head]; // grab the length stored when enqueuing
             // start DMA TX of the next message at 'head'
-            if (HAL_UART_Transmit_DMA(DebugUart, (uint8_t*)uartQueue.buffer[uartQueue.head], len) != HAL_OK)
+            if (!platform_uart_write_dma(PLATFORM_UART_DEBUG, (const uint8_t*)uartQueue.buffer[uartQueue.head], len))
             {
                 txComplete = 1;                                      // on error, mark UART idle to avoid lock-up
             }
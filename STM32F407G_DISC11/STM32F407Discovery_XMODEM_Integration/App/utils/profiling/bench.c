@@ -0,0 +1,453 @@
+/*
+ * bench.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Benchmark suite for the signal pipeline kernels (see bench.h for the output schema).
+ *      Every case runs one untimed warm-up (fills caches such as the window table) and
+ *      then "reps" timed runs. In-place kernels get fresh input before every run (untimed).
+ *
+ *      Kernels and their "sample" unit:
+ *          gen_f32     SignalGen_GenerateComposite,     float32 sample (incl. RNG noise)
+ *          gen_q15     SignalGen_GenerateComposite_Q15, uint16 ADC code
+ *          window      apply_blackman_window,           float32 sample
+ *          fir_lp/bp   apply_fir_filter_f32,            float32 sample
+ *          fft         fft_real_f32 (CMSIS rfft_fast / 8192 split), float32 sample
+ *          crc32       calculate_crc32 over float32 samples (as sent in binary mode)
+ *          xmodem_crc  xmodem_calculate_crc over uint16 samples (as sent via XMODEM)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "profiling.h"
+#include "uart_app.h"
+#include "json_utils.h"
+#include "signal_gen.h"
+#include "signal_memory.h"
+#include "fft_utils.h"
+#include "filter_utils.h"
+#include "filter_coefficients.h"
+#include "crc_soft.h"
+#include "xmodem.h"
+#define JSMN_HEADER
+#include "jsmn.h"
+
+#define BENCH_MIN_LEN           16U
+#define BENCH_NUM_LENGTHS       10U                 /* 16 .. 8192 */
+#define BENCH_NUM_TONE_STEPS    3U
+
+typedef enum {
+    BENCH_K_GEN_F32 = 0,
+    BENCH_K_GEN_Q15,
+    BENCH_K_WINDOW,
+    BENCH_K_FIR_LP,
+    BENCH_K_FIR_BP,
+    BENCH_K_FFT,
+    BENCH_K_CRC32,
+    BENCH_K_XMODEM_CRC,
+    BENCH_NUM_KERNELS
+} BenchKernel_t;
+
+/* Kernel name, data type and whether the tone count is swept */
+typedef struct {
+    const char *name;
+    const char *dtype;
+    bool        sweepTones;
+} BenchKernelDesc_t;
+
+static const BenchKernelDesc_t benchKernels[BENCH_NUM_KERNELS] = {
+    [BENCH_K_GEN_F32]    = { "gen_f32",    "float32", true  },
+    [BENCH_K_GEN_Q15]    = { "gen_q15",    "uint16",  true  },
+    [BENCH_K_WINDOW]     = { "window",     "float32", false },
+    [BENCH_K_FIR_LP]     = { "fir_lp",     "float32", false },
+    [BENCH_K_FIR_BP]     = { "fir_bp",     "float32", false },
+    [BENCH_K_FFT]        = { "fft",        "float32", false },
+    [BENCH_K_CRC32]      = { "crc32",      "float32", false },
+    [BENCH_K_XMODEM_CRC] = { "xmodem_crc", "uint16",  false },
+};
+
+static const uint8_t benchToneSteps[BENCH_NUM_TONE_STEPS] = { 1U, 4U, MAX_TONES };
+
+/* Tone set used by the generator cases */
+static const uint32_t benchFreqs_u32[MAX_TONES] = {
+    1000U, 3000U, 7000U, 11000U, 13000U, 17000U, 19000U, 23000U,
+    29000U, 31000U, 37000U, 41000U, 43000U, 47000U, 53000U, 59000U
+};
+static const uint16_t benchAmps_u16[MAX_TONES] = {
+    500U, 250U, 125U, 100U, 90U, 80U, 70U, 60U,
+    50U, 45U, 40U, 35U, 30U, 25U, 20U, 15U
+};
+
+/* Baseline: mean ticks per case index, 0 = no baseline */
+#define BENCH_MAX_CASES   (BENCH_NUM_LENGTHS * BENCH_NUM_KERNELS * BENCH_NUM_TONE_STEPS)
+static uint32_t benchBaseline_u32[BENCH_MAX_CASES];
+
+/* Schema columns the baseline is keyed on / taken from (CSV column index) */
+#define BENCH_COL_KERNEL        0U
+#define BENCH_COL_LEN           1U
+#define BENCH_COL_TONES         2U
+#define BENCH_COL_MEAN_TICKS    6U
+
+/**
+ * @brief Case index of (kernel, tone step, length step); fixed, independent of max_len.
+ */
+static uint32_t bench_case_index(uint32_t kernel, uint32_t toneStep, uint32_t lenStep)
+{
+    return (((kernel * BENCH_NUM_TONE_STEPS) + toneStep) * BENCH_NUM_LENGTHS) + lenStep;
+}
+
+/**
+ * @brief Case index of a result row's key; false if the row names no case of the sweep.
+ */
+static bool bench_find_case(const char *kernel, uint32_t kernelLen, uint32_t len_u32, uint32_t tones_u32,
+                            uint32_t *pCaseIdx)
+{
+    for (uint32_t k = 0U; k < (uint32_t)BENCH_NUM_KERNELS; ++k)
+    {
+        if ((strlen(benchKernels[k].name) != kernelLen) || (strncmp(benchKernels[k].name, kernel, kernelLen) != 0)) {
+            continue;
+        }
+        const uint32_t numToneSteps = benchKernels[k].sweepTones ? BENCH_NUM_TONE_STEPS : 1U;
+        for (uint32_t t = 0U; t < numToneSteps; ++t)
+        {
+            if (benchToneSteps[t] != tones_u32) {
+                continue;
+            }
+            for (uint32_t l = 0U; l < BENCH_NUM_LENGTHS; ++l)
+            {
+                if ((BENCH_MIN_LEN << l) == len_u32) {
+                    *pCaseIdx = bench_case_index(k, t, l);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Deterministic test input (untimed), about +-50 around 0 like a centred ADC signal.
+ */
+static void bench_fill_input(float32_t *pBuf, uint32_t len)
+{
+    for (uint32_t i = 0U; i < len; ++i) {
+        pBuf[i] = (float32_t)((int32_t)((i * 37U) % 101U) - 50);
+    }
+}
+
+/**
+ * @brief Run one kernel once on len samples.
+ */
+static void bench_run_kernel(BenchKernel_t kernel, uint32_t len, uint8_t numTones, FftReal_Instance_f32 *pFft)
+{
+    SignalGen_HandleType gen = {
+        .numSamples_u32        = len,
+        .startSample_u32       = 0U,
+        .samplingRate_u32      = 1024000U,
+        .dcOffset_u16          = 1650U,
+        .vRef_u16              = 3300U,
+        .adcMaxValue_u16       = 4095U,
+        .numTones_u8           = numTones,
+        .pToneFreqs_u32        = benchFreqs_u32,
+        .pToneAmps_u16         = benchAmps_u16,
+        .sineMethod            = SINE_METHOD_CMSIS,
+        .dataType              = DATA_TYPE_FLOAT32,
+        .pOutBuffer_f32        = sigBUFFER_UNION.bufF32,
+        .pOutBuffer_u16        = NULL
+    };
+    uint16_t crc16;
+
+    switch (kernel)
+    {
+        case BENCH_K_GEN_F32:
+            SignalGen_GenerateComposite(&gen);
+            break;
+        case BENCH_K_GEN_Q15:
+            gen.dataType       = DATA_TYPE_UINT16;
+            gen.pOutBuffer_f32 = NULL;
+            gen.pOutBuffer_u16 = sigBUFFER_UNION.bufU16;
+            SignalGen_GenerateComposite_Q15(&gen);
+            break;
+        case BENCH_K_WINDOW:
+            apply_blackman_window(sigBUFFER_UNION.bufF32, len);
+            break;
+        case BENCH_K_FIR_LP:
+            apply_fir_filter_f32(LP_FIR_COEFF, NUM_TAPS_FIR_LP, sigBUFFER_UNION.bufF32, len);
+            break;
+        case BENCH_K_FIR_BP:
+            apply_fir_filter_f32(BP_FIR_COEFF, NUM_TAPS_FIR_BP, sigBUFFER_UNION.bufF32, len);
+            break;
+        case BENCH_K_FFT:
+            fft_real_f32(pFft, sigBUFFER_UNION.bufF32, sigBUFF2);
+            break;
+        case BENCH_K_CRC32:
+            (void)calculate_crc32((const uint8_t *)sigBUFFER_UNION.bufF32, len * sizeof(float32_t));
+            break;
+        case BENCH_K_XMODEM_CRC:
+            (void)xmodem_calculate_crc((const uint8_t *)sigBUFFER_UNION.bufU16, len * sizeof(uint16_t), &crc16);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Print one result row in the selected format.
+ */
+static void bench_print_row(const BenchConfig_t *pCfg, BenchKernel_t kernel, uint32_t len, uint8_t numTones,
+                            const ProfStats_t *pStats, uint32_t baseline_u32, const char *status)
+{
+    const uint32_t  mean_u32        = prof_stats_mean(pStats);
+    const float32_t ticksPerSample  = (float32_t)mean_u32 / (float32_t)len;
+    const float32_t msps            = (ticksPerSample > 0.0f) ? ((float32_t)prof_tick_hz() / ticksPerSample / 1.0e6f) : 0.0f;
+    const float32_t deltaPct        = (baseline_u32 != 0U) ? (100.0f * ((float32_t)mean_u32 - (float32_t)baseline_u32) / (float32_t)baseline_u32) : 0.0f;
+
+    if (pCfg->format == BENCH_FORMAT_JSON)
+    {
+        printToDebugUartBlocking("{\"kernel\":\"%s\",\"len\":%lu,\"tones\":%u,\"dtype\":\"%s\",\"reps\":%lu,"
+                                 "\"min_ticks\":%lu,\"mean_ticks\":%lu,\"ticks_per_sample\":%.3f,\"msps\":%.3f,"
+                                 "\"baseline_ticks\":%lu,\"delta_pct\":%.1f,\"status\":\"%s\"}\r\n",
+                                 benchKernels[kernel].name, (unsigned long)len, (unsigned)numTones, benchKernels[kernel].dtype,
+                                 (unsigned long)pStats->count_u32, (unsigned long)pStats->min_u32, (unsigned long)mean_u32,
+                                 ticksPerSample, msps, (unsigned long)baseline_u32, deltaPct, status);
+    }
+    else
+    {
+        printToDebugUartBlocking("%s,%lu,%u,%s,%lu,%lu,%lu,%.3f,%.3f,%lu,%.1f,%s\r\n",
+                                 benchKernels[kernel].name, (unsigned long)len, (unsigned)numTones, benchKernels[kernel].dtype,
+                                 (unsigned long)pStats->count_u32, (unsigned long)pStats->min_u32, (unsigned long)mean_u32,
+                                 ticksPerSample, msps, (unsigned long)baseline_u32, deltaPct, status);
+    }
+}
+
+uint32_t bench_run(const BenchConfig_t *pCfg)
+{
+    uint32_t regress_u32 = 0U;
+    const uint32_t reps_u32 = (pCfg->reps_u32 == 0U) ? 1U : pCfg->reps_u32;
+
+    if (pCfg->format == BENCH_FORMAT_CSV) {
+        printToDebugUartBlocking("kernel,len,tones,dtype,reps,min_ticks,mean_ticks,ticks_per_sample,msps,baseline_ticks,delta_pct,status\r\n");
+    }
+
+    for (uint32_t k = 0U; k < (uint32_t)BENCH_NUM_KERNELS; ++k)
+    {
+        const BenchKernel_t kernel = (BenchKernel_t)k;
+        const uint32_t numToneSteps = benchKernels[k].sweepTones ? BENCH_NUM_TONE_STEPS : 1U;
+
+        for (uint32_t t = 0U; t < numToneSteps; ++t)
+        {
+            const uint8_t numTones = benchToneSteps[t];
+
+            for (uint32_t l = 0U; l < BENCH_NUM_LENGTHS; ++l)
+            {
+                const uint32_t caseIdx_u32 = bench_case_index(k, t, l);
+                const uint32_t len_u32 = BENCH_MIN_LEN << l;
+                if ((len_u32 > pCfg->maxLen_u32) || (len_u32 > MAX_SIG_LEN)) {
+                    continue;
+                }
+
+                // The FFT only runs at the supported lengths, the other kernels at all of them
+                FftReal_Instance_f32 fft;
+                if ((kernel == BENCH_K_FFT) && (fft_real_init_f32(&fft, len_u32) != ARM_MATH_SUCCESS)) {
+                    continue;
+                }
+
+                ProfStats_t stats;
+                prof_stats_reset(&stats);
+
+                // Warm-up run (untimed), then the timed repetitions
+                for (uint32_t r = 0U; r <= reps_u32; ++r)
+                {
+                    bench_fill_input(sigBUFFER_UNION.bufF32, len_u32);
+
+                    const uint32_t t0_u32 = prof_now();
+                    bench_run_kernel(kernel, len_u32, numTones, &fft);
+                    const uint32_t ticks_u32 = prof_now() - t0_u32;
+
+                    if (r > 0U) {
+                        prof_stats_add(&stats, ticks_u32);
+                    }
+                }
+
+                // Compare against / update the baseline
+                const uint32_t baseline_u32 = benchBaseline_u32[caseIdx_u32];
+                const char *status = "new";
+                if (baseline_u32 != 0U) {
+                    const uint64_t limit_u64 = ((uint64_t)baseline_u32 * (100U + pCfg->tolPct_u32)) / 100U;
+                    if ((uint64_t)prof_stats_mean(&stats) > limit_u64) {
+                        status = "regress";
+                        ++regress_u32;
+                    } else {
+                        status = "ok";
+                    }
+                }
+                if (pCfg->saveBaseline) {
+                    benchBaseline_u32[caseIdx_u32] = prof_stats_mean(&stats);
+                }
+
+                bench_print_row(pCfg, kernel, len_u32, numTones, &stats, baseline_u32, status);
+            }
+        }
+    }
+    return regress_u32;
+}
+
+void bench_clear_baseline(void)
+{
+    memset(benchBaseline_u32, 0, sizeof(benchBaseline_u32));
+}
+
+bool bench_load_baseline_row(const char *row)
+{
+    const char *kernel = NULL;
+    uint32_t kernelLen = 0U;
+    uint32_t len_u32 = 0U, tones_u32 = 0U, mean_u32 = 0U;
+
+    while ((*row == ' ') || (*row == '\t')) {
+        ++row;
+    }
+
+    if (*row == '{')
+    {
+        // JSON row: the keys of the schema, other keys (e.g. "cmd") are ignored
+        jsmn_parser parser;
+        jsmntok_t tokens[32U];
+
+        jsmn_init(&parser);
+        int tokCount = jsmn_parse(&parser, row, strlen(row), tokens, sizeof(tokens) / sizeof(tokens[0]));
+        if ((tokCount < 1) || (tokens[0].type != JSMN_OBJECT)) {
+            return false;
+        }
+        for (int i = 1; i < (tokCount - 1); ++i) {
+            if ((tokens[i].type == JSMN_STRING) && json_token_streq(row, &tokens[i], "kernel") &&
+                (tokens[i + 1].type == JSMN_STRING)) {
+                kernel    = row + tokens[i + 1].start;
+                kernelLen = (uint32_t)(tokens[i + 1].end - tokens[i + 1].start);
+                break;
+            }
+        }
+        if ((kernel == NULL) ||
+            (json_parse_u32(row, tokens, tokCount, "len", &len_u32) != JSON_PARSE_OK) ||
+            (json_parse_u32(row, tokens, tokCount, "tones", &tones_u32) != JSON_PARSE_OK) ||
+            (json_parse_u32(row, tokens, tokCount, "mean_ticks", &mean_u32) != JSON_PARSE_OK)) {
+            return false;
+        }
+    }
+    else
+    {
+        // CSV row in schema column order; the column line and foreign lines do not match a case
+        const char *field = row;
+        for (uint32_t col = 0U; col <= BENCH_COL_MEAN_TICKS; ++col)
+        {
+            const char *end = strchr(field, ',');
+            if (end == NULL) {
+                return false;
+            }
+            switch (col)
+            {
+                case BENCH_COL_KERNEL:     kernel = field; kernelLen = (uint32_t)(end - field); break;
+                case BENCH_COL_LEN:        len_u32   = (uint32_t)strtoul(field, NULL, 10); break;
+                case BENCH_COL_TONES:      tones_u32 = (uint32_t)strtoul(field, NULL, 10); break;
+                case BENCH_COL_MEAN_TICKS: mean_u32  = (uint32_t)strtoul(field, NULL, 10); break;
+                default: break;
+            }
+            field = end + 1;
+        }
+    }
+
+    uint32_t caseIdx_u32;
+    if ((mean_u32 == 0U) || !bench_find_case(kernel, kernelLen, len_u32, tones_u32, &caseIdx_u32)) {
+        return false;
+    }
+    benchBaseline_u32[caseIdx_u32] = mean_u32;
+    return true;
+}
+
+/**
+ * @brief  Handle JSON command RUN_BENCH (arguments see bench.h).
+ *
+ * Response: JSON header line, result rows (CSV incl. column line, or one JSON object per row),
+ * JSON trailer line with the number of regressions.
+ */
+void handle_run_bench(const char *json_str)
+{
+    jsmn_parser parser;
+    jsmntok_t tokens[32U];
+    uint32_t value_u32;
+
+    BenchConfig_t cfg = {
+        .reps_u32     = 3U,
+        .maxLen_u32   = FFT_MAX_LEN,
+        .tolPct_u32   = 5U,
+        .format       = BENCH_FORMAT_CSV,
+        .saveBaseline = false
+    };
+
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, sizeof(tokens) / sizeof(tokens[0]));
+    if ((tokCount < 1) || (tokens[0].type != JSMN_OBJECT)) {
+        send_uart_response("RUN_BENCH", "FAIL", "{\"error\":\"invalid_json\"}");
+        return;
+    }
+
+    if (json_parse_u32(json_str, tokens, tokCount, "reps", &value_u32) == JSON_PARSE_OK && value_u32 > 0U) {
+        cfg.reps_u32 = value_u32;
+    }
+    if (json_parse_u32(json_str, tokens, tokCount, "max_len", &value_u32) == JSON_PARSE_OK && value_u32 >= BENCH_MIN_LEN) {
+        cfg.maxLen_u32 = value_u32;
+    }
+    if (json_parse_u32(json_str, tokens, tokCount, "tol_pct", &value_u32) == JSON_PARSE_OK) {
+        cfg.tolPct_u32 = value_u32;
+    }
+    if (json_parse_u32(json_str, tokens, tokCount, "format", &value_u32) == JSON_PARSE_OK && value_u32 <= BENCH_FORMAT_JSON) {
+        cfg.format = (BenchFormat_t)value_u32;
+    }
+    if (json_parse_u32(json_str, tokens, tokCount, "baseline", &value_u32) == JSON_PARSE_OK) {
+        cfg.saveBaseline = (value_u32 != 0U);
+    }
+
+    printToDebugUartBlocking("{\"cmd\":\"RUN_BENCH\",\"status\":\"OK\",\"args\":{\"format\":%u,\"reps\":%lu,\"max_len\":%lu,\"tol_pct\":%lu,\"tick_hz\":%lu}}\r\n",
+                             (unsigned)cfg.format, (unsigned long)cfg.reps_u32, (unsigned long)cfg.maxLen_u32,
+                             (unsigned long)cfg.tolPct_u32, (unsigned long)prof_tick_hz());
+
+    const uint32_t regress_u32 = bench_run(&cfg);
+
+    printToDebugUartBlocking("{\"cmd\":\"RUN_BENCH\",\"status\":\"DONE\",\"args\":{\"regress\":%lu,\"baseline_saved\":%u}}\r\n",
+                             (unsigned long)regress_u32, cfg.saveBaseline ? 1U : 0U);
+}
+
+/**
+ * @brief  Handle JSON command BENCH_BASELINE (see bench.h).
+ *
+ * A JSON result row with "cmd":"BENCH_BASELINE" added sets the baseline of its case,
+ * so a stored run can be replayed line by line; "clear":1 drops the whole baseline.
+ */
+void handle_bench_baseline(const char *json_str)
+{
+    jsmn_parser parser;
+    jsmntok_t tokens[32U];
+    uint32_t clear_u32 = 0U;
+
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, sizeof(tokens) / sizeof(tokens[0]));
+    if ((tokCount < 1) || (tokens[0].type != JSMN_OBJECT)) {
+        send_uart_response("BENCH_BASELINE", "FAIL", "{\"error\":\"invalid_json\"}");
+        return;
+    }
+
+    if ((json_parse_u32(json_str, tokens, tokCount, "clear", &clear_u32) == JSON_PARSE_OK) && (clear_u32 != 0U)) {
+        bench_clear_baseline();
+        send_uart_response("BENCH_BASELINE", "OK", "{\"cleared\":1}");
+        return;
+    }
+
+    if (!bench_load_baseline_row(json_str)) {
+        send_uart_response("BENCH_BASELINE", "FAIL", "{\"error\":\"unknown_case\"}");
+        return;
+    }
+    send_uart_response("BENCH_BASELINE", "OK", "{\"loaded\":1}");
+}
@@ -0,0 +1,75 @@
+/*
+ * bench.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Benchmark suite for the DSP and CRC kernels of the signal pipeline.
+ *
+ *      The suite sweeps FFT lengths (16 .. max_len), tone counts and generator data
+ *      types, measures every case "reps" times with the profiling time base and
+ *      reports min/mean ticks, ticks per sample and throughput.
+ *
+ *      Output schema (identical field names for CSV and JSON, one row per case):
+ *          kernel,len,tones,dtype,reps,min_ticks,mean_ticks,ticks_per_sample,msps,
+ *          baseline_ticks,delta_pct,status
+ *      status: "new" (no baseline), "ok" or "regress" (mean > baseline * (1 + tol)).
+ *
+ *      A run can be stored as baseline ("baseline":1); later runs are compared against it.
+ *      A baseline can also be loaded from the rows of an earlier run (CSV or JSON, keyed on
+ *      kernel/len/tones, mean_ticks is the reference): bench_load_baseline_row() per row,
+ *      on target with BENCH_BASELINE, on the host with bench_host --baseline <file>.
+ */
+
+#ifndef UTILS_PROFILING_BENCH_H_
+#define UTILS_PROFILING_BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Output format of a benchmark run */
+typedef enum {
+    BENCH_FORMAT_CSV  = 0,
+    BENCH_FORMAT_JSON = 1
+} BenchFormat_t;
+
+/** @brief Run-time options of the benchmark suite */
+typedef struct {
+    uint32_t      reps_u32;         /**< repetitions per case (>= 1) */
+    uint32_t      maxLen_u32;       /**< largest length of the sweep */
+    uint32_t      tolPct_u32;       /**< allowed slow-down against the baseline [%] */
+    BenchFormat_t format;           /**< CSV or JSON rows */
+    bool          saveBaseline;     /**< store this run as the new baseline */
+} BenchConfig_t;
+
+/**
+ * @brief  Run the complete benchmark sweep and print one row per case on the debug UART.
+ * @return Number of cases flagged as regression.
+ */
+uint32_t bench_run(const BenchConfig_t *pCfg);
+
+/** @brief Drop the whole baseline (every case reports "new" again) */
+void bench_clear_baseline(void);
+
+/**
+ * @brief  Take mean_ticks of one result row (CSV or JSON schema) as the baseline of its case.
+ * @return false for the CSV column line, rows of unknown cases and anything else.
+ */
+bool bench_load_baseline_row(const char *row);
+
+/**
+ * @brief  JSON command RUN_BENCH.
+ *
+ *         Optional arguments: "reps" (default 3), "max_len" (default FFT_MAX_LEN),
+ *         "format" (0 = CSV, 1 = JSON), "tol_pct" (default 5), "baseline" (1 = save run as baseline).
+ */
+void handle_run_bench(const char *json_str);
+
+/**
+ * @brief  JSON command BENCH_BASELINE: a JSON result row plus "cmd" loads the baseline
+ *         of that case; "clear":1 drops the whole baseline.
+ */
+void handle_bench_baseline(const char *json_str);
+
+#endif /* UTILS_PROFILING_BENCH_H_ */
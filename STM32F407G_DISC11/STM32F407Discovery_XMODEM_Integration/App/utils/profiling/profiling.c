@@ -0,0 +1,242 @@
+/*
+ * profiling.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Probe storage, statistics and the READ_PROFILE command.
+ *      Time base: DWT CYCCNT on the Cortex-M4 (wraps after 2^32 cycles = 25 s at 168 MHz,
+ *      differences stay valid as long as one measurement is shorter than that),
+ *      clock_gettime(CLOCK_MONOTONIC) in ns off-target.
+ */
+
+#include <string.h>
+
+#include "profiling.h"
+#include "uart_app.h"
+#include "json_utils.h"
+#define JSMN_HEADER
+#include "jsmn.h"
+
+#if defined(__arm__)
+#include "main.h"
+#define PROF_TICK_HZ    (SystemCoreClock)
+#else
+#include <time.h>
+#define PROF_TICK_HZ    (1000000000UL)
+#endif
+
+/**
+ * @brief Reset one statistics record.
+ */
+void prof_stats_reset(ProfStats_t *pStats)
+{
+    memset(pStats, 0, sizeof(*pStats));
+    pStats->min_u32 = UINT32_MAX;
+}
+
+/**
+ * @brief Add one measurement to a statistics record.
+ *
+ * @param[in,out] pStats     Record to update.
+ * @param[in]     ticks_u32  Measured duration in ticks.
+ */
+void prof_stats_add(ProfStats_t *pStats, uint32_t ticks_u32)
+{
+    uint32_t bucket_u32 = 0U;
+    uint32_t v_u32 = ticks_u32;
+
+    while ((v_u32 >>= 1U) != 0U) {
+        ++bucket_u32;   // floor(log2(ticks)), 0 for 0 and 1
+    }
+
+    pStats->count_u32++;
+    pStats->sum_u64 += ticks_u32;
+    if (ticks_u32 < pStats->min_u32) {
+        pStats->min_u32 = ticks_u32;
+    }
+    if (ticks_u32 > pStats->max_u32) {
+        pStats->max_u32 = ticks_u32;
+    }
+    pStats->hist_u32[bucket_u32]++;
+}
+
+/**
+ * @brief Mean of all recorded measurements (0 if empty).
+ */
+uint32_t prof_stats_mean(const ProfStats_t *pStats)
+{
+    return (pStats->count_u32 == 0U) ? 0U : (uint32_t)(pStats->sum_u64 / pStats->count_u32);
+}
+
+/**
+ * @brief Enable the time base and clear all probes. Call once at startup.
+ */
+void prof_init(void)
+{
+#if defined(__arm__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;   // enable DWT/ITM
+    DWT->CYCCNT = 0U;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;            // start cycle counter
+#endif
+    prof_reset();
+}
+
+/**
+ * @brief Current time stamp in ticks (CPU cycles on target, ns off-target).
+ */
+uint32_t prof_now(void)
+{
+#if defined(__arm__)
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Tick rate of prof_now() in Hz.
+ */
+uint32_t prof_tick_hz(void)
+{
+    return (uint32_t)PROF_TICK_HZ;
+}
+
+#if PROFILING_ENABLED
+
+static const char *const probeNames[PROF_NUM_PROBES] = {
+    [PROF_SIG_FFT_GEN]       = "sig_fft.gen",
+    [PROF_SIG_FFT_SEND_RAW]  = "sig_fft.send_raw",
+    [PROF_SIG_FFT_FILTER]    = "sig_fft.filter",
+    [PROF_SIG_FFT_SEND_TIME] = "sig_fft.send_time",
+    [PROF_SIG_FFT_WINDOW]    = "sig_fft.window",
+    [PROF_SIG_FFT_FFT]       = "sig_fft.fft",
+    [PROF_SIG_FFT_MAG]       = "sig_fft.mag",
+    [PROF_SIG_FFT_SEND_FFT]  = "sig_fft.send_fft",
+    [PROF_SIG_FFT_TOTAL]     = "sig_fft.total",
+    [PROF_AUDIO_REFILL]      = "audio.refill",
+};
+
+static ProfStats_t probeStats[PROF_NUM_PROBES];
+
+/* PROF_AUDIO_REFILL is recorded from the I2S DMA callback: the main loop reads and
+ * clears a record only with interrupts masked, for the length of one copy */
+#if defined(__arm__)
+static uint32_t prof_irq_save(void)
+{
+    const uint32_t primask_u32 = __get_PRIMASK();
+    __disable_irq();
+    return primask_u32;
+}
+
+static void prof_irq_restore(uint32_t primask_u32)
+{
+    __set_PRIMASK(primask_u32);
+}
+#else
+static uint32_t prof_irq_save(void)
+{
+    return 0U;
+}
+
+static void prof_irq_restore(uint32_t primask_u32)
+{
+    (void)primask_u32;
+}
+#endif
+
+/**
+ * @brief Consistent copy of one probe, optionally cleared in the same step.
+ */
+static void prof_snapshot(uint32_t id_u32, ProfStats_t *pOut, bool reset)
+{
+    const uint32_t primask_u32 = prof_irq_save();
+    *pOut = probeStats[id_u32];
+    if (reset) {
+        prof_stats_reset(&probeStats[id_u32]);
+    }
+    prof_irq_restore(primask_u32);
+}
+
+/**
+ * @brief Clear the statistics of all probes.
+ */
+void prof_reset(void)
+{
+    for (uint32_t i = 0U; i < (uint32_t)PROF_NUM_PROBES; ++i) {
+        const uint32_t primask_u32 = prof_irq_save();
+        prof_stats_reset(&probeStats[i]);
+        prof_irq_restore(primask_u32);
+    }
+}
+
+void prof_record(ProfProbeId_t id, uint32_t ticks_u32)
+{
+    if ((uint32_t)id < (uint32_t)PROF_NUM_PROBES) {
+        prof_stats_add(&probeStats[id], ticks_u32);
+    }
+}
+
+const ProfStats_t *prof_get_stats(ProfProbeId_t id)
+{
+    return ((uint32_t)id < (uint32_t)PROF_NUM_PROBES) ? &probeStats[id] : NULL;
+}
+
+const char *prof_get_name(ProfProbeId_t id)
+{
+    return ((uint32_t)id < (uint32_t)PROF_NUM_PROBES) ? probeNames[id] : "?";
+}
+
+#endif /* PROFILING_ENABLED */
+
+/**
+ * @brief  Handle JSON command READ_PROFILE.
+ *
+ * Response (one line per probe to keep the lines short):
+ *   {"cmd":"READ_PROFILE","status":"OK","args":{"enabled":1,"tick_hz":168000000,"probes":[
+ *   {"name":"sig_fft.gen","count":3,"min":..,"max":..,"mean":..,"hist":[..32 buckets..]},
+ *   ...]}}
+ *
+ * @param[in] json_str  Full JSON command; optional "reset":1 clears each probe as it is dumped.
+ */
+void handle_read_profile(const char *json_str)
+{
+#if PROFILING_ENABLED
+    jsmn_parser parser;
+    jsmntok_t tokens[16U];
+    uint16_t reset_u16 = 0U;
+
+    jsmn_init(&parser);
+    int tokCount = jsmn_parse(&parser, json_str, strlen(json_str), tokens, sizeof(tokens) / sizeof(tokens[0]));
+    if ((tokCount > 0) && (json_parse_u16(json_str, tokens, tokCount, "reset", &reset_u16) != JSON_PARSE_OK)) {
+        reset_u16 = 0U;
+    }
+
+    printToDebugUartBlocking("{\"cmd\":\"READ_PROFILE\",\"status\":\"OK\",\"args\":{\"enabled\":1,\"tick_hz\":%lu,\"probes\":[\r\n",
+                             (unsigned long)prof_tick_hz());
+
+    // Each probe is copied (and cleared with "reset":1) before printing, so a record
+    // from the DMA callback lands either in this dump or in the next, never half
+    for (uint32_t i = 0U; i < (uint32_t)PROF_NUM_PROBES; ++i) {
+        ProfStats_t stats;
+        prof_snapshot(i, &stats, reset_u16 != 0U);
+        const ProfStats_t *pStats = &stats;
+
+        printToDebugUartBlocking("{\"name\":\"%s\",\"count\":%lu,\"min\":%lu,\"max\":%lu,\"mean\":%lu,\"hist\":[",
+                                 probeNames[i], (unsigned long)pStats->count_u32,
+                                 (unsigned long)((pStats->count_u32 == 0U) ? 0U : pStats->min_u32),
+                                 (unsigned long)pStats->max_u32, (unsigned long)prof_stats_mean(pStats));
+        for (uint32_t b = 0U; b < PROF_HIST_BUCKETS; ++b) {
+            printToDebugUartBlocking("%lu%s", (unsigned long)pStats->hist_u32[b], (b < (PROF_HIST_BUCKETS - 1U)) ? "," : "");
+        }
+        printToDebugUartBlocking("]}%s\r\n", (i < ((uint32_t)PROF_NUM_PROBES - 1U)) ? "," : "");
+    }
+    printToDebugUartBlocking("]}}\r\n");
+#else
+    (void)json_str;
+    printToDebugUartBlocking("{\"cmd\":\"READ_PROFILE\",\"status\":\"OK\",\"args\":{\"enabled\":0}}\r\n");
+#endif
+}
@@ -0,0 +1,98 @@
+/*
+ * profiling.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Cycle-accurate profiling probes.
+ *
+ *      Every probe is a fixed entry of ProfProbeId_t and collects count, min, max,
+ *      sum (-> mean) and a log2 histogram of the measured cycle counts.
+ *      On target the time base is the DWT cycle counter (CYCCNT), off-target
+ *      clock_gettime() in nanoseconds is used instead.
+ *
+ *      Usage:
+ *          PROF_BEGIN(PROF_SIG_FFT_GEN);
+ *          SignalGen_GenerateComposite(&h);
+ *          PROF_END(PROF_SIG_FFT_GEN);
+ *
+ *      A probe is recorded from one context only. PROF_AUDIO_REFILL is recorded from
+ *      the I2S DMA callback; prof_reset() and READ_PROFILE copy or clear each probe
+ *      with interrupts masked, so they never see or leave a half-updated record.
+ *
+ *      With PROFILING_ENABLED = 0 all PROF_* macros expand to nothing and no probe
+ *      storage is linked; READ_PROFILE then only reports "enabled":0. The time base
+ *      (prof_init/prof_now/prof_tick_hz) stays available.
+ */
+
+#ifndef UTILS_PROFILING_PROFILING_H_
+#define UTILS_PROFILING_PROFILING_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED       1
+#endif
+
+#define PROF_HIST_BUCKETS       32U     /* bucket i counts samples with floor(log2(cycles)) == i */
+
+/** @brief Named probes. Add new probes here and in the name table in profiling.c */
+typedef enum {
+    PROF_SIG_FFT_GEN = 0,       /**< handle_read_sig_fft: composite signal generation */
+    PROF_SIG_FFT_SEND_RAW,      /**< handle_read_sig_fft: send unfiltered time signal */
+    PROF_SIG_FFT_FILTER,        /**< handle_read_sig_fft: FIR filter */
+    PROF_SIG_FFT_SEND_TIME,     /**< handle_read_sig_fft: send filtered time signal */
+    PROF_SIG_FFT_WINDOW,        /**< handle_read_sig_fft: Blackman window */
+    PROF_SIG_FFT_FFT,           /**< handle_read_sig_fft: FFT init + execution */
+    PROF_SIG_FFT_MAG,           /**< handle_read_sig_fft: magnitude + scaling */
+    PROF_SIG_FFT_SEND_FFT,      /**< handle_read_sig_fft: send spectrum */
+    PROF_SIG_FFT_TOTAL,         /**< handle_read_sig_fft: complete command */
+    PROF_AUDIO_REFILL,          /**< audio_out: synthesis of one I2S half buffer (DMA callback) */
+    PROF_NUM_PROBES
+} ProfProbeId_t;
+
+/** @brief Statistics of one probe */
+typedef struct {
+    uint32_t count_u32;                         /**< number of samples */
+    uint32_t min_u32;                           /**< smallest sample [ticks] */
+    uint32_t max_u32;                           /**< largest sample [ticks] */
+    uint64_t sum_u64;                           /**< sum of all samples [ticks] */
+    uint32_t hist_u32[PROF_HIST_BUCKETS];       /**< log2 histogram */
+} ProfStats_t;
+
+/* Statistics helpers, independent of the time base */
+void prof_stats_reset(ProfStats_t *pStats);
+void prof_stats_add(ProfStats_t *pStats, uint32_t ticks_u32);
+uint32_t prof_stats_mean(const ProfStats_t *pStats);
+
+/* Time base, always available (also used by the benchmark suite) */
+void prof_init(void);
+uint32_t prof_now(void);
+uint32_t prof_tick_hz(void);
+
+#if PROFILING_ENABLED
+
+void prof_reset(void);
+void prof_record(ProfProbeId_t id, uint32_t ticks_u32);
+const ProfStats_t *prof_get_stats(ProfProbeId_t id);
+const char *prof_get_name(ProfProbeId_t id);
+
+#define PROF_BEGIN(id)      const uint32_t prof_t0_##id = prof_now()
+#define PROF_END(id)        prof_record((id), prof_now() - prof_t0_##id)
+
+#else
+
+#define prof_reset()        ((void)0)
+#define PROF_BEGIN(id)      ((void)0)
+#define PROF_END(id)        ((void)0)
+
+#endif /* PROFILING_ENABLED */
+
+/**
+ * @brief  JSON command READ_PROFILE: dump all probes. Optional "reset":1 clears each one as it is dumped.
+ */
+void handle_read_profile(const char *json_str);
+
+#endif /* UTILS_PROFILING_PROFILING_H_ */
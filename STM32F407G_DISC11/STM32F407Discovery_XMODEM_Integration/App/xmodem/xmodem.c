@@ -9,8 +9,7 @@
 
 bool xmodem_calculate_crc(const uint8_t *data, const uint32_t size, uint16_t *result)
 {
-	uint32_t start_time = platform_get_time_ms();
-	write_OrangeLed_PD13(GPIO_PIN_SET);
+	write_OrangeLed_PD13(true);
 
 	uint16_t crc    = 0x0;
 	uint32_t count  = size;
@@ -45,9 +44,7 @@ bool xmodem_calculate_crc(const uint8_t *data, const uint32_t size, uint16_t *re
 
 	   *result = crc;
    }
-	write_OrangeLed_PD13(GPIO_PIN_RESET);
-	uint32_t stop_time = platform_get_time_ms();
-	printf("crc calc duration %lu - %lu = %lu ms \r\n", stop_time, start_time, (stop_time - start_time));
+	write_OrangeLed_PD13(false);
 
 	return status;
 }
@@ -140,7 +140,7 @@ bool xmodem_transmit_process(const uint32_t current_time)
 
       case XMODEM_TRANSMIT_WRITE_BLOCK:
       {
-    	  write_RedLed_PD14(GPIO_PIN_SET);
+    	  write_RedLed_PD14(true);
          if (current_time > (write_block_timer + TRANSFER_WRITE_BLOCK_TIMEOUT))
          {
             transmit_state = XMODEM_TRANSMIT_WRITE_BLOCK_TIMEOUT;
@@ -170,7 +170,7 @@ bool xmodem_transmit_process(const uint32_t current_time)
             }
 
          }
-         write_RedLed_PD14(GPIO_PIN_RESET);
+         write_RedLed_PD14(false);
          break;
       }
 
@@ -205,7 +205,7 @@ bool xmodem_transmit_process(const uint32_t current_time)
 
       case XMODEM_TRANSMIT_WAIT_FOR_C_ACK:
       {
-    	  write_GreenLed_PD12(GPIO_PIN_SET);
+    	  write_GreenLed_PD12(true);
           if (current_time > stopwatch_ack + TRANSFER_ACK_TIMEOUT)
           {
              transmit_state = XMODEM_TRANSMIT_WRITE_BLOCK_FAILED;
@@ -236,7 +236,7 @@ bool xmodem_transmit_process(const uint32_t current_time)
                 } 
              } 
           }
-          write_GreenLed_PD12(GPIO_PIN_RESET);
+          write_GreenLed_PD12(false);
           break;
       }
 
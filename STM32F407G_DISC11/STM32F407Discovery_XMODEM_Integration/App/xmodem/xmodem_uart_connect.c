@@ -51,7 +51,7 @@ static bool xmodem_read_data(uint32_t requested_size, uint8_t *buffer, uint32_t
 /**
  * @brief Write data to UART using blocking transmit.
  *
- * This function uses HAL_UART_Transmit to send `requested_size` bytes from `buffer`
+ * This function uses platform_uart_write to send `requested_size` bytes from `buffer`
  * through the Debug UART interface.
  *
  * @param[in]  requested_size  Number of bytes to send
@@ -60,7 +60,7 @@ static bool xmodem_read_data(uint32_t requested_size, uint8_t *buffer, uint32_t
  * @return true if transmit was attempted (even if failed), false otherwise
  */
 static bool uart_write_data(uint32_t requested_size, uint8_t *buffer, bool *write_status) {
-    if (HAL_UART_Transmit(DebugUart, buffer, requested_size, HAL_MAX_DELAY) == HAL_OK) {
+    if (platform_uart_write(PLATFORM_UART_DEBUG, buffer, requested_size)) {
         *write_status = true;
         return true;
     }
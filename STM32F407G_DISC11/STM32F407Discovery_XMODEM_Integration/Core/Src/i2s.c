@@ -21,7 +21,8 @@
 #include "i2s.h"
 
 /* USER CODE BEGIN 0 */
-
+/* SPI3_TX DMA for the audio output (App/audio/audio_out.c), circular half/complete refill */
+DMA_HandleTypeDef hdma_spi3_tx;
 /* USER CODE END 0 */
 
 I2S_HandleTypeDef hi2s3;
@@ -104,6 +105,27 @@ void HAL_I2S_MspInit(I2S_HandleTypeDef* i2sHandle)
 
   /* USER CODE BEGIN SPI3_MspInit 1 */
 
+    /* I2S3 DMA Init: SPI3_TX on DMA1 Stream7, channel 0 (Stream5 is taken by USART2_RX) */
+    hdma_spi3_tx.Instance = DMA1_Stream7;
+    hdma_spi3_tx.Init.Channel = DMA_CHANNEL_0;
+    hdma_spi3_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_spi3_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_spi3_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_spi3_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    hdma_spi3_tx.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    hdma_spi3_tx.Init.Mode = DMA_CIRCULAR;
+    hdma_spi3_tx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_spi3_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_spi3_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(i2sHandle,hdmatx,hdma_spi3_tx);
+
+    HAL_NVIC_SetPriority(DMA1_Stream7_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream7_IRQn);
+
   /* USER CODE END SPI3_MspInit 1 */
   }
 }
@@ -130,7 +152,8 @@ void HAL_I2S_MspDeInit(I2S_HandleTypeDef* i2sHandle)
     HAL_GPIO_DeInit(GPIOC, I2S3_MCK_Pin|I2S3_SCK_Pin|I2S3_SD_Pin);
 
   /* USER CODE BEGIN SPI3_MspDeInit 1 */
-
+    HAL_DMA_DeInit(i2sHandle->hdmatx);
+    HAL_NVIC_DisableIRQ(DMA1_Stream7_IRQn);
   /* USER CODE END SPI3_MspDeInit 1 */
   }
 }
@@ -22,6 +22,7 @@
 #include "stm32f4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "adc_capture.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -63,6 +64,7 @@ extern DMA_HandleTypeDef hdma_usart3_tx;
 extern UART_HandleTypeDef huart2;
 extern UART_HandleTypeDef huart3;
 /* USER CODE BEGIN EV */
+extern DMA_HandleTypeDef hdma_spi3_tx;
 
 /* USER CODE END EV */
 
@@ -304,4 +306,20 @@ void OTG_FS_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA2 stream0 global interrupt (ADC1 capture).
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  adc_capture_f407_dma_irq();
+}
+
+/**
+  * @brief This function handles DMA1 stream7 global interrupt (SPI3_TX, audio output).
+  */
+void DMA1_Stream7_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi3_tx);
+}
+
 /* USER CODE END 1 */
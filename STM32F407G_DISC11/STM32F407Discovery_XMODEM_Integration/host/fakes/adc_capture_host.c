@@ -0,0 +1,116 @@
+/*
+ * adc_capture_host.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Simulated TIM2 -> ADC1 -> DMA2 Stream0 chain, see adc_capture_host.h.
+ */
+
+#include <stddef.h>
+#include <math.h>
+
+#include "adc_capture.h"
+#include "adc_capture_host.h"
+
+static uint16_t *pDmaBuf;
+static uint32_t dmaLen_u32;
+static uint32_t dmaPos_u32;
+static uint32_t sampleIndex_u32;
+static uint32_t rate_u32;
+static uint32_t startMs_u32;
+static bool     startMsValid;
+static bool     dmaRunning;
+
+static uint16_t source_sine_1k(uint32_t index)
+{
+    const double t = (double)index / (double)rate_u32;
+    return (uint16_t)lround(2047.5 + (2047.0 * sin(2.0 * 3.14159265358979323846 * 1000.0 * t)));
+}
+
+static uint16_t (*sampleSource)(uint32_t index) = source_sine_1k;
+
+static bool adc_capture_host_start(uint16_t *pBuf, uint32_t totalLen_u32, uint32_t rate, uint32_t *pActualRate_u32)
+{
+    if ((totalLen_u32 == 0U) || (totalLen_u32 > 0xFFFFU) || (rate == 0U)) {
+        return false;
+    }
+
+    uint32_t period = (ADC_CAPTURE_HOST_TIMCLK_HZ + (rate / 2U)) / rate;
+    if (period < 2U) {
+        period = 2U;
+    }
+
+    pDmaBuf         = pBuf;
+    dmaLen_u32      = totalLen_u32;
+    dmaPos_u32      = 0U;
+    sampleIndex_u32 = 0U;
+    rate_u32        = ADC_CAPTURE_HOST_TIMCLK_HZ / period;
+    startMsValid    = false;
+    dmaRunning      = true;
+
+    *pActualRate_u32 = rate_u32;
+    return true;
+}
+
+static void adc_capture_host_stop(void)
+{
+    dmaRunning = false;
+}
+
+const AdcCaptureHw_t adcCaptureHwF407 = {
+    .start = adc_capture_host_start,
+    .stop  = adc_capture_host_stop,
+};
+
+void adc_capture_f407_dma_irq(void)
+{
+}
+
+void adc_capture_host_set_source(uint16_t (*source)(uint32_t index))
+{
+    sampleSource = (source != NULL) ? source : source_sine_1k;
+}
+
+void adc_capture_host_run(uint32_t numSamples)
+{
+    const uint32_t half = dmaLen_u32 / 2U;
+
+    while (dmaRunning && (numSamples-- > 0U)) {
+        pDmaBuf[dmaPos_u32++] = sampleSource(sampleIndex_u32++);
+        if (dmaPos_u32 == half) {
+            adc_capture_block_done(0U);
+        } else if (dmaPos_u32 == dmaLen_u32) {
+            dmaPos_u32 = 0U;
+            adc_capture_block_done(1U);
+        }
+    }
+}
+
+void adc_capture_host_on_tick(uint32_t now_ms)
+{
+    if (!dmaRunning) {
+        return;
+    }
+    if (!startMsValid) {
+        startMs_u32  = now_ms;
+        startMsValid = true;
+        return;
+    }
+
+    const uint64_t due = ((uint64_t)(now_ms - startMs_u32) * rate_u32) / 1000U;
+    if (due > sampleIndex_u32) {
+        adc_capture_host_run((uint32_t)(due - sampleIndex_u32));
+    }
+}
+
+uint32_t adc_capture_host_position(void)
+{
+    return dmaPos_u32;
+}
+
+bool adc_capture_host_running(void)
+{
+    return dmaRunning;
+}
@@ -0,0 +1,37 @@
+/*
+ * adc_capture_host.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Host back end of the ADC capture, linked instead of adc_capture_hw_f407.c.
+ *      It programs the same TIM2 period (84 MHz timer clock) and replaces
+ *      TIM2 -> ADC1 -> DMA2 Stream0 by a simulated circular DMA: samples come from
+ *      a source function and adc_capture_block_done() is raised at half and full
+ *      buffer, from adc_capture_host_run() or from the simulated clock.
+ */
+
+#ifndef HOST_FAKES_ADC_CAPTURE_HOST_H_
+#define HOST_FAKES_ADC_CAPTURE_HOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ADC_CAPTURE_HOST_TIMCLK_HZ  84000000UL
+
+/* Sample source, index counts from 0 at start; default: 1 kHz full-scale sine */
+void adc_capture_host_set_source(uint16_t (*source)(uint32_t index));
+
+/* The DMA writes numSamples, raising the half/complete events on the way */
+void adc_capture_host_run(uint32_t numSamples);
+
+/* Like adc_capture_host_run() for the samples due at simulated time now_ms;
+ * install with hal_fake_tick_set_hook() to let captures run in simulated time. */
+void adc_capture_host_on_tick(uint32_t now_ms);
+
+/* Next buffer index the DMA writes (the NDTR view of the position) */
+uint32_t adc_capture_host_position(void);
+bool     adc_capture_host_running(void);
+
+#endif /* HOST_FAKES_ADC_CAPTURE_HOST_H_ */
@@ -0,0 +1,86 @@
+/*
+ * arm_math.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Host stand-in for the CMSIS-DSP (v1.4.5) subset App/ uses. Same types,
+ *      instance structures, output packing and length limits as the library in
+ *      Lib/libarm_cortexM4lf_math.a; arm_math_host.c computes the transforms in
+ *      double precision, so host spectra are a reference rather than a bit copy
+ *      of the target.
+ */
+
+#ifndef HOST_FAKES_ARM_MATH_H_
+#define HOST_FAKES_ARM_MATH_H_
+
+#include <stdint.h>
+#include <math.h>
+
+typedef float   float32_t;
+typedef double  float64_t;
+typedef int8_t  q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+
+typedef enum {
+    ARM_MATH_SUCCESS        =  0,
+    ARM_MATH_ARGUMENT_ERROR = -1,
+    ARM_MATH_LENGTH_ERROR   = -2,
+    ARM_MATH_SIZE_MISMATCH  = -3,
+    ARM_MATH_NANINF         = -4,
+    ARM_MATH_SINGULAR       = -5,
+    ARM_MATH_TEST_FAILURE   = -6
+} arm_status;
+
+#ifndef PI
+#define PI  3.14159265358979f
+#endif
+
+static inline int32_t __SSAT(int32_t val, uint32_t sat)
+{
+    const int32_t max = (int32_t)((1UL << (sat - 1U)) - 1U);
+    const int32_t min = -max - 1;
+    return (val > max) ? max : ((val < min) ? min : val);
+}
+
+typedef struct {
+    uint16_t fftLen;
+    const float32_t *pTwiddle;
+    const uint16_t *pBitRevTable;
+    uint16_t bitRevLength;
+} arm_cfft_instance_f32;
+
+typedef struct {
+    arm_cfft_instance_f32 Sint;
+    uint16_t fftLenRFFT;
+    float32_t *pTwiddleRFFT;
+} arm_rfft_fast_instance_f32;
+
+typedef struct {
+    uint16_t numTaps;
+    float32_t *pState;
+    float32_t *pCoeffs;
+} arm_fir_instance_f32;
+
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len4096;
+
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen);
+void arm_rfft_fast_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+void arm_cmplx_mag_f32(float32_t *pSrc, float32_t *pDst, uint32_t numSamples);
+
+void arm_fir_init_f32(arm_fir_instance_f32 *S, uint16_t numTaps, float32_t *pCoeffs, float32_t *pState, uint32_t blockSize);
+void arm_fir_f32(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+void arm_scale_f32(float32_t *pSrc, float32_t scale, float32_t *pDst, uint32_t blockSize);
+void arm_offset_f32(float32_t *pSrc, float32_t offset, float32_t *pDst, uint32_t blockSize);
+void arm_scale_q15(q15_t *pSrc, q15_t scaleFract, int8_t shift, q15_t *pDst, uint32_t blockSize);
+void arm_offset_q15(q15_t *pSrc, q15_t offset, q15_t *pDst, uint32_t blockSize);
+
+float32_t arm_sin_f32(float32_t x);
+q15_t arm_sin_q15(q15_t x);
+
+#endif /* HOST_FAKES_ARM_MATH_H_ */
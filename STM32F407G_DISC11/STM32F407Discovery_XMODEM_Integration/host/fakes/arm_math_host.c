@@ -0,0 +1,245 @@
+/*
+ * arm_math_host.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Host implementation of the CMSIS-DSP subset in arm_math.h.
+ *
+ *      - FFTs: iterative radix-2 in double precision, CMSIS scaling (the inverse
+ *        divides by N) and CMSIS packing for the real transform.
+ *      - arm_rfft_fast_init_f32() accepts 32 .. 4096 points like v1.4.5.
+ *      - arm_sin_q15(): the v1.4.5 algorithm (512-point table, linear interpolation),
+ *        so the generators produce the same samples as on the target.
+ *      - Q15 helpers saturate like the library.
+ */
+
+#include <string.h>
+
+#include "arm_math.h"
+
+#define SIN_TABLE_Q15_LEN   512U
+
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len4096 = { 4096U, NULL, NULL, 0U };
+
+/* In-place complex FFT of n = 2^k points (interleaved re/im), natural order out */
+static void fft_complex(float32_t *p, uint32_t n, int inverse)
+{
+    /* bit-reversal permutation */
+    for (uint32_t i = 1U, j = 0U; i < n; ++i) {
+        uint32_t bit = n >> 1U;
+        for (; (j & bit) != 0U; bit >>= 1U) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float32_t t;
+            t = p[2U * i];      p[2U * i] = p[2U * j];             p[2U * j] = t;
+            t = p[2U * i + 1U]; p[2U * i + 1U] = p[2U * j + 1U];   p[2U * j + 1U] = t;
+        }
+    }
+
+    for (uint32_t len = 2U; len <= n; len <<= 1U) {
+        const double ang = (inverse ? 2.0 : -2.0) * 3.14159265358979323846 / (double)len;
+        for (uint32_t i = 0U; i < n; i += len) {
+            for (uint32_t k = 0U; k < (len / 2U); ++k) {
+                const double wr = cos(ang * (double)k);
+                const double wi = sin(ang * (double)k);
+                float32_t *a = &p[2U * (i + k)];
+                float32_t *b = &p[2U * (i + k + (len / 2U))];
+                const double br = ((double)b[0] * wr) - ((double)b[1] * wi);
+                const double bi = ((double)b[0] * wi) + ((double)b[1] * wr);
+                const double ar = a[0];
+                const double ai = a[1];
+                a[0] = (float32_t)(ar + br);
+                a[1] = (float32_t)(ai + bi);
+                b[0] = (float32_t)(ar - br);
+                b[1] = (float32_t)(ai - bi);
+            }
+        }
+    }
+
+    if (inverse) {
+        const float32_t s = 1.0f / (float32_t)n;
+        for (uint32_t i = 0U; i < (2U * n); ++i) {
+            p[i] *= s;
+        }
+    }
+}
+
+static void bit_reverse(float32_t *p, uint32_t n)
+{
+    for (uint32_t i = 1U, j = 0U; i < n; ++i) {
+        uint32_t bit = n >> 1U;
+        for (; (j & bit) != 0U; bit >>= 1U) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float32_t t;
+            t = p[2U * i];      p[2U * i] = p[2U * j];             p[2U * j] = t;
+            t = p[2U * i + 1U]; p[2U * i + 1U] = p[2U * j + 1U];   p[2U * j + 1U] = t;
+        }
+    }
+}
+
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    fft_complex(p1, S->fftLen, ifftFlag != 0U);
+    if (bitReverseFlag == 0U) {
+        bit_reverse(p1, S->fftLen);     // the library leaves the output in bit-reversed order
+    }
+}
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{
+    switch (fftLen) {
+    case 4096U: case 2048U: case 1024U: case 512U:
+    case 256U:  case 128U:  case 64U:   case 32U:
+        break;
+    default:
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLenRFFT   = fftLen;
+    S->Sint.fftLen  = fftLen / 2U;
+    S->pTwiddleRFFT = NULL;
+    return ARM_MATH_SUCCESS;
+}
+
+/*
+ * Packed spectrum: p[0] = X[0], p[1] = X[N/2], then Re/Im of X[1] .. X[N/2-1].
+ * The input buffer is used as scratch, as in the library.
+ */
+void arm_rfft_fast_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{
+    const uint32_t n = S->fftLenRFFT;
+
+    if (ifftFlag == 0U) {
+        double re0 = 0.0, reN = 0.0;
+        for (uint32_t i = 0U; i < n; ++i) {
+            re0 += p[i];
+            reN += ((i & 1U) != 0U) ? -(double)p[i] : (double)p[i];
+        }
+        /* complex FFT of the real data, imaginary part 0 (2N floats of scratch on the stack) */
+        float32_t buf[2U * 4096U];
+        for (uint32_t i = 0U; i < n; ++i) {
+            buf[2U * i]      = p[i];
+            buf[2U * i + 1U] = 0.0f;
+        }
+        fft_complex(buf, n, 0);
+        pOut[0] = (float32_t)re0;
+        pOut[1] = (float32_t)reN;
+        memcpy(&pOut[2], &buf[2], (n - 2U) * sizeof(float32_t));
+        memcpy(p, buf, n * sizeof(float32_t));
+    } else {
+        float32_t buf[2U * 4096U];
+        buf[0] = p[0];
+        buf[1] = 0.0f;
+        buf[n] = p[1];
+        buf[n + 1U] = 0.0f;
+        for (uint32_t k = 1U; k < (n / 2U); ++k) {
+            buf[2U * k]            = p[2U * k];
+            buf[2U * k + 1U]       = p[2U * k + 1U];
+            buf[2U * (n - k)]      = p[2U * k];
+            buf[2U * (n - k) + 1U] = -p[2U * k + 1U];
+        }
+        fft_complex(buf, n, 1);
+        for (uint32_t i = 0U; i < n; ++i) {
+            pOut[i] = buf[2U * i];
+        }
+    }
+}
+
+void arm_cmplx_mag_f32(float32_t *pSrc, float32_t *pDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0U; i < numSamples; ++i) {
+        const float32_t re = pSrc[2U * i];
+        const float32_t im = pSrc[2U * i + 1U];
+        pDst[i] = sqrtf((re * re) + (im * im));
+    }
+}
+
+/* Coefficients in time-reversed order {b[numTaps-1] .. b[0]}, state numTaps + blockSize - 1 */
+void arm_fir_init_f32(arm_fir_instance_f32 *S, uint16_t numTaps, float32_t *pCoeffs, float32_t *pState, uint32_t blockSize)
+{
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState  = pState;
+    memset(pState, 0, (numTaps + blockSize - 1U) * sizeof(float32_t));
+}
+
+void arm_fir_f32(const arm_fir_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    const uint32_t taps = S->numTaps;
+    float32_t *st = S->pState;
+
+    memcpy(&st[taps - 1U], pSrc, blockSize * sizeof(float32_t));
+    for (uint32_t n = 0U; n < blockSize; ++n) {
+        float32_t acc = 0.0f;
+        for (uint32_t k = 0U; k < taps; ++k) {
+            acc += st[n + k] * S->pCoeffs[k];
+        }
+        pDst[n] = acc;
+    }
+    memmove(st, &st[blockSize], (taps - 1U) * sizeof(float32_t));
+}
+
+void arm_scale_f32(float32_t *pSrc, float32_t scale, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0U; i < blockSize; ++i) {
+        pDst[i] = pSrc[i] * scale;
+    }
+}
+
+void arm_offset_f32(float32_t *pSrc, float32_t offset, float32_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0U; i < blockSize; ++i) {
+        pDst[i] = pSrc[i] + offset;
+    }
+}
+
+void arm_scale_q15(q15_t *pSrc, q15_t scaleFract, int8_t shift, q15_t *pDst, uint32_t blockSize)
+{
+    const int8_t kShift = (int8_t)(15 - shift);
+    for (uint32_t i = 0U; i < blockSize; ++i) {
+        pDst[i] = (q15_t)__SSAT(((q31_t)pSrc[i] * scaleFract) >> kShift, 16U);
+    }
+}
+
+void arm_offset_q15(q15_t *pSrc, q15_t offset, q15_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0U; i < blockSize; ++i) {
+        pDst[i] = (q15_t)__SSAT((q31_t)pSrc[i] + offset, 16U);
+    }
+}
+
+float32_t arm_sin_f32(float32_t x)
+{
+    return sinf(x);
+}
+
+q15_t arm_sin_q15(q15_t x)
+{
+    static q15_t sinTable_q15[SIN_TABLE_Q15_LEN + 1U];
+    static int tableValid = 0;
+
+    if (!tableValid) {
+        for (uint32_t i = 0U; i <= SIN_TABLE_Q15_LEN; ++i) {
+            long v = lround(32768.0 * sin((2.0 * 3.14159265358979323846 * (double)i) / SIN_TABLE_Q15_LEN));
+            sinTable_q15[i] = (q15_t)((v > 32767) ? 32767 : v);
+        }
+        tableValid = 1;
+    }
+
+    /* Input 0 .. 0x7FFF maps to 0 .. 2*pi (negative inputs are outside the contract) */
+    const uint16_t in = (uint16_t)x & 0x7FFFU;
+    const int32_t index = in >> 6U;
+    const q15_t fract = (q15_t)((in - (index << 6U)) << 9U);
+    const q15_t a = sinTable_q15[index];
+    const q15_t b = sinTable_q15[index + 1];
+
+    q15_t sinVal = (q15_t)(((q31_t)(0x8000 - fract) * a) >> 16);
+    sinVal = (q15_t)((((q31_t)sinVal << 16) + ((q31_t)fract * b)) >> 16);
+    return (q15_t)(sinVal << 1);
+}
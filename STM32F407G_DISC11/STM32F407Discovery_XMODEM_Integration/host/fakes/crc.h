@@ -0,0 +1,9 @@
+/* Host stand-in for Core/Inc/crc.h */
+#ifndef HOST_FAKES_CRC_H_
+#define HOST_FAKES_CRC_H_
+
+#include "stm32f4xx_hal.h"
+
+extern CRC_HandleTypeDef hcrc;
+
+#endif /* HOST_FAKES_CRC_H_ */
@@ -0,0 +1,399 @@
+/*
+ * hal_fake.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Host implementation of the HAL calls App/ uses, and the handles CubeMX
+ *      would generate in Core/Src. See hal_fake.h for the behaviour.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal_fake.h"
+#include "main.h"
+#include "usart.h"
+#include "rng.h"
+#include "crc.h"
+#include "i2c.h"
+#include "i2s.h"
+
+#define HAL_FAKE_UART_NUM       2U
+#define HAL_FAKE_UART_BAUD      921600U     /* as in Core/Src/usart.c */
+#define HAL_FAKE_CS43L22_ADDR   0x94U
+#define HAL_FAKE_CS43L22_ID     0xE3U       /* CS43L22 rev. B1 */
+
+UART_HandleTypeDef huart2 = { .Init = { .BaudRate = HAL_FAKE_UART_BAUD }, .index_u8 = 0U };
+UART_HandleTypeDef huart3 = { .Init = { .BaudRate = HAL_FAKE_UART_BAUD }, .index_u8 = 1U };
+RNG_HandleTypeDef  hrng;
+CRC_HandleTypeDef  hcrc;
+I2C_HandleTypeDef  hi2c1;
+I2S_HandleTypeDef  hi2s3;
+GPIO_TypeDef       hal_fake_gpiod;
+
+__IO uint32_t uwTick;
+
+typedef struct {
+    uint8_t  *pData;
+    uint32_t len_u32;
+    uint32_t cap_u32;
+} HalFakeCapture_t;
+
+static HalFakeCapture_t uartTx[HAL_FAKE_UART_NUM];
+static bool     wireModel;
+static uint32_t wireBaud_u32;   /* 0: the configured baud rate */
+static uint64_t wireTime_us;
+static void   (*txHook)(PlatformUart_t port, const uint8_t *pData, uint32_t len);
+
+static uint32_t tickAutoStep_u32 = 1U;
+static void   (*tickHook)(uint32_t now_ms);
+
+static uint32_t rngState_u32 = 0x2545F491U;
+static bool     rngFail;
+
+static uint8_t  i2cRegs[256];
+static uint32_t i2cWrites_u32;
+
+static uint32_t errorCount_u32;
+
+void hal_fake_reset(void)
+{
+    for (uint32_t i = 0U; i < HAL_FAKE_UART_NUM; ++i) {
+        free(uartTx[i].pData);
+        uartTx[i] = (HalFakeCapture_t){ 0 };
+    }
+    huart2.pRxBuffPtr = NULL;
+    huart3.pRxBuffPtr = NULL;
+    wireModel    = false;
+    wireBaud_u32 = 0U;
+    wireTime_us  = 0U;
+    txHook       = NULL;
+
+    uwTick = 0U;
+    tickAutoStep_u32 = 1U;
+    tickHook = NULL;
+
+    rngState_u32 = 0x2545F491U;
+    rngFail = false;
+
+    hal_fake_gpiod.ODR = 0U;
+
+    memset(i2cRegs, 0, sizeof(i2cRegs));
+    i2cRegs[0x01] = HAL_FAKE_CS43L22_ID;
+    hi2c1.regPtr_u8 = 0U;
+    i2cWrites_u32 = 0U;
+
+    hi2s3.pTxBuffPtr = NULL;
+    hi2s3.TxXferSize = 0U;
+
+    errorCount_u32 = 0U;
+}
+
+/* ------------------------------------------------------------------ tick */
+
+static void tick_advance(uint32_t ms)
+{
+    if (ms == 0U) {
+        return;
+    }
+    uwTick += ms;
+    if (tickHook != NULL) {
+        tickHook(uwTick);
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    tick_advance(tickAutoStep_u32);
+    return uwTick;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    tick_advance(Delay);
+}
+
+void hal_fake_tick_set_auto(uint32_t step_ms)
+{
+    tickAutoStep_u32 = step_ms;
+}
+
+void hal_fake_tick_advance(uint32_t ms)
+{
+    tick_advance(ms);
+}
+
+void hal_fake_tick_set_hook(void (*hook)(uint32_t now_ms))
+{
+    tickHook = hook;
+}
+
+/* ------------------------------------------------------------------ UART */
+
+static PlatformUart_t uart_port(const UART_HandleTypeDef *huart)
+{
+    return (huart->index_u8 == 0U) ? PLATFORM_UART_DEBUG : PLATFORM_UART_DEBUG2;
+}
+
+static void uart_capture(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    HalFakeCapture_t *c = &uartTx[huart->index_u8];
+
+    if ((c->len_u32 + Size) > c->cap_u32) {
+        uint32_t cap = (c->cap_u32 == 0U) ? 4096U : c->cap_u32;
+        while (cap < (c->len_u32 + Size)) {
+            cap *= 2U;
+        }
+        c->pData   = realloc(c->pData, cap);
+        c->cap_u32 = cap;
+    }
+    memcpy(&c->pData[c->len_u32], pData, Size);
+    c->len_u32 += Size;
+
+    if (txHook != NULL) {
+        txHook(uart_port(huart), pData, Size);
+    }
+    if (wireModel) {
+        // 10 bit per character (8N1)
+        const uint32_t baud = (wireBaud_u32 != 0U) ? wireBaud_u32 : huart->Init.BaudRate;
+        const uint64_t before_ms = wireTime_us / 1000U;
+        wireTime_us += ((uint64_t)Size * 10U * 1000000U) / baud;
+        tick_advance((uint32_t)((wireTime_us / 1000U) - before_ms));
+    }
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    uart_capture(huart, pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+    uart_capture(huart, pData, Size);
+    HAL_UART_TxCpltCallback(huart);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+    if ((pData == NULL) || (Size == 0U)) {
+        return HAL_ERROR;
+    }
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    return HAL_OK;
+}
+
+const uint8_t *hal_fake_uart_tx(PlatformUart_t port, uint32_t *pLen)
+{
+    const HalFakeCapture_t *c = &uartTx[(port == PLATFORM_UART_DEBUG) ? 0U : 1U];
+    *pLen = c->len_u32;
+    return c->pData;
+}
+
+void hal_fake_uart_tx_clear(PlatformUart_t port)
+{
+    uartTx[(port == PLATFORM_UART_DEBUG) ? 0U : 1U].len_u32 = 0U;
+}
+
+uint32_t hal_fake_uart_rx(PlatformUart_t port, const uint8_t *pData, uint32_t len)
+{
+    UART_HandleTypeDef *huart = (port == PLATFORM_UART_DEBUG) ? &huart2 : &huart3;
+    static uint16_t fill_u16[HAL_FAKE_UART_NUM];
+    uint32_t accepted = 0U;
+
+    for (uint32_t i = 0U; i < len; ++i) {
+        if (huart->pRxBuffPtr == NULL) {
+            break;      // nobody listening: the byte is lost, like on the wire
+        }
+        uint16_t *pFill = &fill_u16[huart->index_u8];
+        huart->pRxBuffPtr[(*pFill)++] = pData[i];
+        accepted++;
+        if (*pFill >= huart->RxXferSize) {
+            *pFill = 0U;
+            huart->pRxBuffPtr = NULL;       // normal mode: the callback re-arms
+            HAL_UART_RxCpltCallback(huart);
+        }
+    }
+    return accepted;
+}
+
+void hal_fake_uart_set_wire(bool on)
+{
+    wireModel = on;
+}
+
+void hal_fake_uart_set_wire_baud(uint32_t baud)
+{
+    wireBaud_u32 = baud;
+}
+
+void hal_fake_uart_set_tx_hook(void (*hook)(PlatformUart_t port, const uint8_t *pData, uint32_t len))
+{
+    txHook = hook;
+}
+
+/* ------------------------------------------------------------------ RNG */
+
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef *hrngx, uint32_t *random32bit)
+{
+    if (rngFail) {
+        return HAL_ERROR;
+    }
+    rngState_u32 ^= rngState_u32 << 13U;
+    rngState_u32 ^= rngState_u32 >> 17U;
+    rngState_u32 ^= rngState_u32 << 5U;
+    hrngx->RandomNumber = rngState_u32;
+    *random32bit = rngState_u32;
+    return HAL_OK;
+}
+
+void hal_fake_rng_seed(uint32_t seed)
+{
+    rngState_u32 = (seed != 0U) ? seed : 1U;
+}
+
+void hal_fake_rng_set_fail(bool fail)
+{
+    rngFail = fail;
+}
+
+/* ------------------------------------------------------------------ GPIO */
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+uint32_t hal_fake_gpiod_odr(void)
+{
+    return hal_fake_gpiod.ODR;
+}
+
+/* ------------------------------------------------------------------ CRC */
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrcx, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    uint32_t crc = hcrcx->DR;
+
+    for (uint32_t i = 0U; i < BufferLength; ++i) {
+        crc ^= pBuffer[i];
+        for (uint32_t b = 0U; b < 32U; ++b) {
+            crc = ((crc & 0x80000000U) != 0U) ? ((crc << 1U) ^ 0x04C11DB7U) : (crc << 1U);
+        }
+    }
+    hcrcx->DR = crc;
+    return crc;
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrcx, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    hcrcx->DR = 0xFFFFFFFFU;
+    return HAL_CRC_Accumulate(hcrcx, pBuffer, BufferLength);
+}
+
+/* ------------------------------------------------------------------ I2C */
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    if ((DevAddress != HAL_FAKE_CS43L22_ADDR) || (Size == 0U)) {
+        return HAL_ERROR;       // no ACK
+    }
+    hi2c->regPtr_u8 = pData[0];
+    for (uint16_t i = 1U; i < Size; ++i) {
+        i2cRegs[(uint8_t)(hi2c->regPtr_u8 + i - 1U)] = pData[i];
+        i2cWrites_u32++;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    if (DevAddress != HAL_FAKE_CS43L22_ADDR) {
+        return HAL_ERROR;
+    }
+    for (uint16_t i = 0U; i < Size; ++i) {
+        pData[i] = i2cRegs[(uint8_t)(hi2c->regPtr_u8 + i)];
+    }
+    return HAL_OK;
+}
+
+uint8_t hal_fake_i2c_reg(uint8_t reg)
+{
+    return i2cRegs[reg];
+}
+
+uint32_t hal_fake_i2c_writes(void)
+{
+    return i2cWrites_u32;
+}
+
+/* ------------------------------------------------------------------ I2S */
+
+HAL_StatusTypeDef HAL_I2S_Transmit_DMA(I2S_HandleTypeDef *hi2s, uint16_t *pData, uint16_t Size)
+{
+    if ((pData == NULL) || (Size == 0U) || (hi2s->pTxBuffPtr != NULL)) {
+        return (hi2s->pTxBuffPtr != NULL) ? HAL_BUSY : HAL_ERROR;
+    }
+    hi2s->pTxBuffPtr = pData;
+    hi2s->TxXferSize = Size;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2S_DMAStop(I2S_HandleTypeDef *hi2s)
+{
+    hi2s->pTxBuffPtr = NULL;
+    return HAL_OK;
+}
+
+bool hal_fake_i2s_running(void)
+{
+    return hi2s3.pTxBuffPtr != NULL;
+}
+
+const int16_t *hal_fake_i2s_buffer(uint32_t *pLen)
+{
+    *pLen = hi2s3.TxXferSize;
+    return (const int16_t *)hi2s3.pTxBuffPtr;
+}
+
+void hal_fake_i2s_half(void)
+{
+    if (hi2s3.pTxBuffPtr != NULL) {
+        HAL_I2S_TxHalfCpltCallback(&hi2s3);
+    }
+}
+
+void hal_fake_i2s_complete(void)
+{
+    if (hi2s3.pTxBuffPtr != NULL) {
+        HAL_I2S_TxCpltCallback(&hi2s3);
+    }
+}
+
+/* ------------------------------------------------------------------ Error_Handler */
+
+void Error_Handler(void)
+{
+    errorCount_u32++;       // the target halts here
+}
+
+uint32_t hal_fake_error_count(void)
+{
+    return errorCount_u32;
+}
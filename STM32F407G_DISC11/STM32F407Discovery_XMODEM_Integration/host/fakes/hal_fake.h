@@ -0,0 +1,74 @@
+/*
+ * hal_fake.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Test side of the host HAL (hal_fake.c).
+ *
+ *      UART : everything transmitted is captured per port; received bytes are
+ *             delivered through the armed DMA reception, one HAL_UART_RxCpltCallback()
+ *             per DMA_BUFFER_SIZE, exactly like the target. DMA transmits complete
+ *             immediately. With the wire model on, every transmitted byte costs the
+ *             character time at the configured baud rate (10 bit) of simulated time.
+ *      Tick : simulated milliseconds. Every HAL_GetTick() advances the clock by the
+ *             auto step (default 1 ms), so polling loops make progress; 0 freezes it
+ *             and hal_fake_tick_advance() moves it explicitly.
+ *      RNG  : xorshift32 with a settable seed, can be made to fail.
+ *      GPIO : output data register of GPIOD (the LEDs and the codec reset).
+ *      CRC  : the STM32 CRC unit (CRC-32/MPEG-2 over 32-bit words).
+ *      I2C  : a 256-byte register file behind the CS43L22 address, ID preset.
+ *      I2S  : the running DMA transmission; half/complete events are raised by the test.
+ */
+
+#ifndef HOST_FAKES_HAL_FAKE_H_
+#define HOST_FAKES_HAL_FAKE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stm32f4xx_hal.h"
+#include "board_config.h"
+
+/** @brief Reset all fake peripherals, the captured output and the clock */
+void hal_fake_reset(void);
+
+/* --- UART --- */
+const uint8_t *hal_fake_uart_tx(PlatformUart_t port, uint32_t *pLen);
+void     hal_fake_uart_tx_clear(PlatformUart_t port);
+/* Deliver bytes to the port; returns the number accepted (reception armed) */
+uint32_t hal_fake_uart_rx(PlatformUart_t port, const uint8_t *pData, uint32_t len);
+void     hal_fake_uart_set_wire(bool on);
+/* Rate of the wire model, e.g. a link slower than configured; 0 = the configured baud */
+void     hal_fake_uart_set_wire_baud(uint32_t baud);
+/* Called for every transmit with the bytes sent, NULL to remove */
+void     hal_fake_uart_set_tx_hook(void (*hook)(PlatformUart_t port, const uint8_t *pData, uint32_t len));
+
+/* --- Tick --- */
+void     hal_fake_tick_set_auto(uint32_t step_ms);
+void     hal_fake_tick_advance(uint32_t ms);
+/* Called on every clock advance (e.g. a simulated DMA), NULL to remove */
+void     hal_fake_tick_set_hook(void (*hook)(uint32_t now_ms));
+
+/* --- RNG --- */
+void     hal_fake_rng_seed(uint32_t seed);
+void     hal_fake_rng_set_fail(bool fail);
+
+/* --- GPIO --- */
+uint32_t hal_fake_gpiod_odr(void);
+
+/* --- I2C (CS43L22 register file) --- */
+uint8_t  hal_fake_i2c_reg(uint8_t reg);
+uint32_t hal_fake_i2c_writes(void);
+
+/* --- I2S --- */
+bool     hal_fake_i2s_running(void);
+const int16_t *hal_fake_i2s_buffer(uint32_t *pLen);
+void     hal_fake_i2s_half(void);
+void     hal_fake_i2s_complete(void);
+
+/* --- Error_Handler() calls --- */
+uint32_t hal_fake_error_count(void);
+
+#endif /* HOST_FAKES_HAL_FAKE_H_ */
@@ -0,0 +1,9 @@
+/* Host stand-in for Core/Inc/i2c.h */
+#ifndef HOST_FAKES_I2C_H_
+#define HOST_FAKES_I2C_H_
+
+#include "stm32f4xx_hal.h"
+
+extern I2C_HandleTypeDef hi2c1;
+
+#endif /* HOST_FAKES_I2C_H_ */
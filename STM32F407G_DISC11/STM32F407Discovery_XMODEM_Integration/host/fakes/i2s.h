@@ -0,0 +1,9 @@
+/* Host stand-in for Core/Inc/i2s.h */
+#ifndef HOST_FAKES_I2S_H_
+#define HOST_FAKES_I2S_H_
+
+#include "stm32f4xx_hal.h"
+
+extern I2S_HandleTypeDef hi2s3;
+
+#endif /* HOST_FAKES_I2S_H_ */
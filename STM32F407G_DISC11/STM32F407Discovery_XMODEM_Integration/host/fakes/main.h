@@ -0,0 +1,18 @@
+/*
+ * main.h
+ *
+ *  Host stand-in for Core/Inc/main.h: the board pins and Error_Handler() App/ uses.
+ *  Error_Handler() does not halt here, it is counted (hal_fake_error_count()).
+ */
+
+#ifndef HOST_FAKES_MAIN_H_
+#define HOST_FAKES_MAIN_H_
+
+#include "stm32f4xx_hal.h"
+
+void Error_Handler(void);
+
+#define Audio_RST_Pin GPIO_PIN_4
+#define Audio_RST_GPIO_Port GPIOD
+
+#endif /* HOST_FAKES_MAIN_H_ */
@@ -0,0 +1,9 @@
+/* Host stand-in for Core/Inc/rng.h */
+#ifndef HOST_FAKES_RNG_H_
+#define HOST_FAKES_RNG_H_
+
+#include "stm32f4xx_hal.h"
+
+extern RNG_HandleTypeDef hrng;
+
+#endif /* HOST_FAKES_RNG_H_ */
@@ -0,0 +1,109 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Host stand-in for the STM32F4 HAL: only the types, constants and calls App/
+ *      uses (UART, RNG, tick, GPIO, CRC, I2C, I2S). The calls are implemented in
+ *      hal_fake.c, which also provides the hooks the host tests drive them with
+ *      (hal_fake.h).
+ */
+
+#ifndef HOST_FAKES_STM32F4XX_HAL_H_
+#define HOST_FAKES_STM32F4XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+#define __IO               volatile
+
+/* --- GPIO --- */
+typedef struct {
+    __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_4         ((uint16_t)0x0010)
+#define GPIO_PIN_12        ((uint16_t)0x1000)
+#define GPIO_PIN_13        ((uint16_t)0x2000)
+#define GPIO_PIN_14        ((uint16_t)0x4000)
+#define GPIO_PIN_15        ((uint16_t)0x8000)
+
+extern GPIO_TypeDef hal_fake_gpiod;
+#define GPIOD              (&hal_fake_gpiod)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* --- Tick --- */
+extern __IO uint32_t uwTick;
+uint32_t HAL_GetTick(void);
+void     HAL_Delay(uint32_t Delay);
+
+/* --- UART --- */
+typedef struct {
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct {
+    UART_InitTypeDef Init;
+    uint8_t          *pRxBuffPtr;   /* armed DMA reception, NULL if none */
+    uint16_t         RxXferSize;
+    uint8_t          index_u8;      /* hal_fake.c bookkeeping */
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+
+/* --- RNG --- */
+typedef struct {
+    uint32_t RandomNumber;
+} RNG_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_RNG_GenerateRandomNumber(RNG_HandleTypeDef *hrng, uint32_t *random32bit);
+
+/* --- CRC (CRC-32/MPEG-2 unit: poly 0x04C11DB7, init 0xFFFFFFFF, 32-bit words, no reflection) --- */
+typedef struct {
+    uint32_t DR;
+} CRC_HandleTypeDef;
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
+/* --- I2C --- */
+typedef struct {
+    uint8_t regPtr_u8;
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/* --- I2S --- */
+typedef struct {
+    uint16_t *pTxBuffPtr;           /* running DMA transmission, NULL if stopped */
+    uint16_t TxXferSize;
+} I2S_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2S_Transmit_DMA(I2S_HandleTypeDef *hi2s, uint16_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2S_DMAStop(I2S_HandleTypeDef *hi2s);
+void HAL_I2S_TxHalfCpltCallback(I2S_HandleTypeDef *hi2s);
+void HAL_I2S_TxCpltCallback(I2S_HandleTypeDef *hi2s);
+
+#endif /* HOST_FAKES_STM32F4XX_HAL_H_ */
@@ -0,0 +1,2 @@
+/* Host stand-in: the GPIO part lives in stm32f4xx_hal.h */
+#include "stm32f4xx_hal.h"
@@ -0,0 +1,10 @@
+/* Host stand-in for Core/Inc/usart.h */
+#ifndef HOST_FAKES_USART_H_
+#define HOST_FAKES_USART_H_
+
+#include "stm32f4xx_hal.h"
+
+extern UART_HandleTypeDef huart2;
+extern UART_HandleTypeDef huart3;
+
+#endif /* HOST_FAKES_USART_H_ */
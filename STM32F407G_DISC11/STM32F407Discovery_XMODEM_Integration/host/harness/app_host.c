@@ -0,0 +1,96 @@
+/*
+ * app_host.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_host.h"
+#include "hal_fake.h"
+#include "adc_capture_host.h"
+#include "state_machine.h"
+#include "uart_app.h"
+#include "signal_memory.h"
+#include "mem_placement.h"
+#include "profiling.h"
+#include "adc_capture.h"
+#include "stream_handle.h"
+#include "xmodem_uart_connect.h"
+
+/* The host executables are linked without PIE, so static buffers sit below 4 GB
+ * and the 32-bit placement rules apply; all of it is reachable for the fake DMA. */
+static const MemRegionDesc_t memRegionsHost[] = {
+    { 0x00000000UL, 0xFFFFFFFFUL, MEM_REGION_SRAM, true },
+};
+static const MemMap_t memMapHost = { memRegionsHost, 1U };
+
+static char    *pOutText;
+static uint32_t outTextCap_u32;
+
+void app_host_init(void)
+{
+    hal_fake_reset();
+    hal_fake_tick_set_hook(adc_capture_host_on_tick);
+    mem_set_map(&memMapHost);
+
+    // state_machine() up to its endless loop
+    signal_memory_check_placement();
+    prof_init();
+    adc_capture_init(&adcCaptureHwF407);
+    platform_uart_start_rx(PLATFORM_UART_DEBUG, (uint8_t*)uart2_rxBuf, DMA_BUFFER_SIZE);
+    platform_uart_start_rx(PLATFORM_UART_DEBUG2, (uint8_t*)uart3_rxBuf, DMA_BUFFER_SIZE);
+    setup_xmodem_callbacks();
+}
+
+bool app_host_command(const char *line)
+{
+    const uint32_t len = (uint32_t)strlen(line);
+    bool ok = (hal_fake_uart_rx(PLATFORM_UART_DEBUG, (const uint8_t *)line, len) == len);
+
+    if ((len == 0U) || (line[len - 1U] != '\n')) {
+        ok = ok && (hal_fake_uart_rx(PLATFORM_UART_DEBUG, (const uint8_t *)"\n", 1U) == 1U);
+    }
+
+    while (LF_SpscReadSlot(&commandQueue) != NULL) {
+        execute_command();
+        stream_task();
+    }
+    return ok;
+}
+
+void app_host_run_ms(uint32_t ms)
+{
+    const uint32_t end = platform_get_time_ms() + ms;
+
+    while ((int32_t)(platform_get_time_ms() - end) < 0) {
+        execute_command();
+        stream_task();
+    }
+}
+
+const char *app_host_output(uint32_t *pLen)
+{
+    uint32_t len;
+    const uint8_t *p = hal_fake_uart_tx(PLATFORM_UART_DEBUG, &len);
+
+    if ((len + 1U) > outTextCap_u32) {
+        outTextCap_u32 = len + 1U;
+        pOutText = realloc(pOutText, outTextCap_u32);
+    }
+    if (len > 0U) {
+        memcpy(pOutText, p, len);
+    }
+    pOutText[len] = '\0';
+    if (pLen != NULL) {
+        *pLen = len;
+    }
+    return pOutText;
+}
+
+void app_host_output_clear(void)
+{
+    hal_fake_uart_tx_clear(PLATFORM_UART_DEBUG);
+}
@@ -0,0 +1,33 @@
+/*
+ * app_host.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      App/ on the host: the start-up of state_machine() and its main loop, driven
+ *      one command line at a time. Commands enter through the fake USART2 DMA
+ *      reception byte by byte, the responses are the bytes App/ wrote to USART2.
+ */
+
+#ifndef HOST_HARNESS_APP_HOST_H_
+#define HOST_HARNESS_APP_HOST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Reset the fakes and run the start-up of state_machine() */
+void app_host_init(void);
+
+/* Send one line (newline appended if missing) and run the main loop until the
+ * command queue is empty. Returns false if the fake UART did not take every byte. */
+bool app_host_command(const char *line);
+
+/* Run the main loop (execute_command + stream_task) for ms of simulated time */
+void app_host_run_ms(uint32_t ms);
+
+/* Captured USART2 output since the last clear, NUL-terminated */
+const char *app_host_output(uint32_t *pLen);
+void app_host_output_clear(void);
+
+#endif /* HOST_HARNESS_APP_HOST_H_ */
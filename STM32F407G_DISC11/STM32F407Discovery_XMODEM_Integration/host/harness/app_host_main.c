@@ -0,0 +1,58 @@
+/*
+ * app_host_main.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      JSON-line harness: one command per input line, App/'s USART2 output to stdout
+ *      byte for byte (binary payloads included), so recorded sessions can be diffed.
+ *
+ *          app_host [--run-ms N] < commands.jsonl > responses.txt
+ *
+ *      --run-ms N  keeps the main loop running for N simulated ms after each line
+ *                  (e.g. to collect spectrum frames after START_STREAM).
+ *      Lines starting with '#' are skipped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_host.h"
+
+int main(int argc, char **argv)
+{
+    uint32_t runMs = 0U;
+    char line[1024];
+
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "--run-ms") == 0) && ((i + 1) < argc)) {
+            runMs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [--run-ms N] < commands.jsonl\n", argv[0]);
+            return 2;
+        }
+    }
+
+    app_host_init();
+    app_host_output_clear();
+
+    while (fgets(line, sizeof(line), stdin) != NULL) {
+        if ((line[0] == '#') || (line[0] == '\n')) {
+            continue;
+        }
+        if (!app_host_command(line)) {
+            fprintf(stderr, "app_host: command line dropped by the UART\n");
+        }
+        if (runMs > 0U) {
+            app_host_run_ms(runMs);
+        }
+
+        uint32_t len;
+        const char *out = app_host_output(&len);
+        fwrite(out, 1U, len, stdout);
+        app_host_output_clear();
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * bench_host_main.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      The RUN_BENCH suite (bench.c) as a Linux executable. The rows are the ones the
+ *      target prints (same CSV/JSON schema), timed with clock_gettime() in ns, so a run
+ *      stored with "> file" can be the baseline of the next one:
+ *
+ *          bench_host [--reps N] [--max-len N] [--tol-pct N] [--format csv|json]
+ *                     [--baseline FILE]
+ *
+ *      --baseline  rows of an earlier run (CSV or JSON, other lines are skipped);
+ *                  every case slower than its row by more than tol-pct is "regress".
+ *      Exit code: 0, 1 if a case regressed, 2 for usage/file errors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_host.h"
+#include "bench.h"
+#include "fft_utils.h"
+
+static uint32_t load_baseline(const char *path)
+{
+    char line[512];
+    uint32_t rows_u32 = 0U;
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL) {
+        return UINT32_MAX;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (bench_load_baseline_row(line)) {
+            rows_u32++;
+        }
+    }
+    fclose(f);
+    return rows_u32;
+}
+
+int main(int argc, char **argv)
+{
+    const char *baselinePath = NULL;
+    BenchConfig_t cfg = {
+        .reps_u32     = 3U,
+        .maxLen_u32   = FFT_MAX_LEN,
+        .tolPct_u32   = 5U,
+        .format       = BENCH_FORMAT_CSV,
+        .saveBaseline = false
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *val = ((i + 1) < argc) ? argv[i + 1] : NULL;
+
+        if (val == NULL) {
+            fprintf(stderr, "bench_host: %s needs a value\n", arg);
+            return 2;
+        }
+        if (strcmp(arg, "--reps") == 0) {
+            cfg.reps_u32 = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--max-len") == 0) {
+            cfg.maxLen_u32 = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--tol-pct") == 0) {
+            cfg.tolPct_u32 = (uint32_t)strtoul(val, NULL, 0);
+        } else if (strcmp(arg, "--format") == 0) {
+            cfg.format = (strcmp(val, "json") == 0) ? BENCH_FORMAT_JSON : BENCH_FORMAT_CSV;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            baselinePath = val;
+        } else {
+            fprintf(stderr, "usage: %s [--reps N] [--max-len N] [--tol-pct N] [--format csv|json] [--baseline FILE]\n",
+                    argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    app_host_init();
+    app_host_output_clear();
+
+    if (baselinePath != NULL) {
+        const uint32_t rows_u32 = load_baseline(baselinePath);
+        if (rows_u32 == UINT32_MAX) {
+            fprintf(stderr, "bench_host: cannot open %s\n", baselinePath);
+            return 2;
+        }
+        fprintf(stderr, "bench_host: %u baseline rows from %s\n", rows_u32, baselinePath);
+    }
+
+    const uint32_t regress_u32 = bench_run(&cfg);
+
+    uint32_t len;
+    const char *out = app_host_output(&len);
+    fwrite(out, 1U, len, stdout);
+    fprintf(stderr, "bench_host: %u regressions\n", regress_u32);
+    return (regress_u32 == 0U) ? 0 : 1;
+}
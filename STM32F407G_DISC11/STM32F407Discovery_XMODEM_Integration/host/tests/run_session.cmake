@@ -0,0 +1,16 @@
+# Runs app_host on INPUT and compares its output byte for byte with EXPECTED.
+# Regenerate EXPECTED with: app_host < INPUT > EXPECTED (after checking the diff).
+get_filename_component(name ${EXPECTED} NAME_WE)
+set(actual ${CMAKE_CURRENT_BINARY_DIR}/${name}.actual)
+execute_process(COMMAND ${APP_HOST}
+                INPUT_FILE ${INPUT}
+                OUTPUT_FILE ${actual}
+                RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "app_host exited with ${rc}")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${actual} ${EXPECTED}
+                RESULT_VARIABLE differs)
+if(differs)
+    message(FATAL_ERROR "output differs from ${EXPECTED}, see ${actual}")
+endif()
@@ -0,0 +1,231 @@
+/*
+ * test_adc_capture.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Ping-pong bookkeeping of the ADC capture (adc_capture.c) on the simulated DMA
+ *      (fakes/adc_capture_host.c): sequence numbers, dropped blocks, torn blocks
+ *      (the DMA entering the held half) and the release result, then the DMA + ISR on a
+ *      timer signal preempting the consumer to check that every block reported
+ *      intact really is.
+ */
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "adc_capture.h"
+#include "adc_capture_host.h"
+
+#define BLOCK   64U
+
+/* Sample = its index (12 bit), so a block is intact iff it counts up by one */
+static uint16_t source_index(uint32_t index)
+{
+    return (uint16_t)(index & 0xFFFU);
+}
+
+static bool block_consecutive(const uint16_t *pBlock, uint32_t len)
+{
+    for (uint32_t i = 1U; i < len; ++i) {
+        if ((uint16_t)((pBlock[i] - pBlock[0]) & 0xFFFU) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void start_capture(void)
+{
+    app_host_init();
+    hal_fake_tick_set_hook(NULL);           // the DMA only moves with adc_capture_host_run()
+    adc_capture_host_set_source(source_index);
+    CHECK(adc_capture_start(BLOCK, 48000U));
+}
+
+static void test_sequence_and_drops(void)
+{
+    const uint16_t *pBlock;
+    uint32_t seq;
+
+    start_capture();
+    CHECK(!adc_capture_get_block(&pBlock, &seq));       // nothing finished yet
+
+    adc_capture_host_run(BLOCK);
+    CHECK(adc_capture_get_block(&pBlock, &seq));
+    CHECK(seq == 1U);
+    CHECK(pBlock[0] == 0U);
+    CHECK(block_consecutive(pBlock, BLOCK));
+    CHECK(adc_capture_release_block());
+    CHECK(!adc_capture_get_block(&pBlock, &seq));       // taken only once
+
+    /* three blocks without a consumer: the two older ones are dropped */
+    adc_capture_host_run(3U * BLOCK);
+    CHECK(adc_capture_get_block(&pBlock, &seq));
+    CHECK(seq == 4U);
+    CHECK(pBlock[0] == (3U * BLOCK));                   // newest block, second half
+    CHECK(adc_capture_release_block());
+
+    const AdcCaptureStats_t *pStats = adc_capture_get_stats();
+    CHECK(pStats->blocks_u32 == 4U);
+    CHECK(pStats->dropped_u32 == 2U);
+    CHECK(pStats->overrun_u32 == 0U);
+    CHECK(pStats->blockLen_u32 == BLOCK);
+    CHECK(pStats->actualRate_u32 == 48000U);            // 84 MHz / 1750
+}
+
+/* The held block is torn when the DMA enters its half, not only when it finished it */
+static void test_torn_block(void)
+{
+    const uint16_t *pBlock;
+    uint32_t seq;
+
+    /* hold half 0: the DMA fills half 1, intact until half 1 completes */
+    start_capture();
+    adc_capture_host_run(BLOCK);
+    CHECK(adc_capture_get_block(&pBlock, &seq));
+    adc_capture_host_run(BLOCK - 1U);
+    CHECK(adc_capture_get_stats()->overrun_u32 == 0U);
+    adc_capture_host_run(1U);                           // half 1 complete, DMA wraps into half 0
+    CHECK(adc_capture_get_stats()->overrun_u32 == 1U);
+    adc_capture_host_run(1U);
+    CHECK(!block_consecutive(pBlock, BLOCK));           // really overwritten
+    CHECK(!adc_capture_release_block());
+
+    /* hold half 1: torn when half 0 completes */
+    CHECK(adc_capture_get_block(&pBlock, &seq));        // block 2 (half 1), pending since the wrap
+    CHECK(seq == 2U);
+    adc_capture_host_run(BLOCK - 2U);                   // DMA at the end of half 0
+    CHECK(adc_capture_get_stats()->overrun_u32 == 1U);
+    CHECK(block_consecutive(pBlock, BLOCK));
+    CHECK(adc_capture_release_block());
+
+    /* a long hold is one overrun, not one per wrap */
+    adc_capture_host_run(1U);                           // half 0 complete
+    CHECK(adc_capture_get_block(&pBlock, &seq));
+    CHECK(seq == 3U);
+    adc_capture_host_run(6U * BLOCK);
+    CHECK(!adc_capture_release_block());
+    CHECK(adc_capture_get_stats()->overrun_u32 == 2U);
+
+    /* the next block starts clean */
+    CHECK(adc_capture_get_block(&pBlock, &seq));
+    CHECK(adc_capture_release_block());
+
+    /* restart clears the statistics and the state */
+    CHECK(adc_capture_start(BLOCK, 48000U));
+    CHECK(adc_capture_get_stats()->overrun_u32 == 0U);
+    CHECK(!adc_capture_get_block(&pBlock, &seq));
+}
+
+/* One block through the simulated clock, converted to mV */
+static void test_single_block_mV(void)
+{
+    static float32_t out_mV[256];
+
+    app_host_init();
+    adc_capture_host_set_source(source_index);
+    CHECK(adc_capture_single_block_mV(out_mV, 256U, 48000U, 3300U, 4095U));
+    CHECK(!adc_capture_is_running());
+    CHECK(adc_capture_get_stats()->overrun_u32 == 0U);
+    for (uint32_t i = 1U; i < 256U; ++i) {
+        const float32_t step = out_mV[i] - out_mV[i - 1U];
+        CHECK_MSG((step > 0.80f) && (step < 0.82f), "sample %u step %.3f", i, step);   // 3300/4095 mV per code
+    }
+
+    CHECK(!adc_capture_start(0U, 48000U));
+    CHECK(!adc_capture_start(ADC_CAPTURE_MAX_BLOCK_LEN + 1U, 48000U));
+    adc_capture_host_set_source(NULL);
+}
+
+/* --- DMA + ISR as a timer signal, preempting the consumer like the real ISR --- */
+
+#define STRESS_SAMPLES  60000U
+#define STRESS_BLOCK    16U
+#define STRESS_TICK_US  20
+
+static volatile sig_atomic_t samplesDone;
+
+static void dma_tick(int sig)
+{
+    (void)sig;
+    if (samplesDone < (sig_atomic_t)STRESS_SAMPLES) {
+        adc_capture_host_run(1U);
+        samplesDone = samplesDone + 1;
+    }
+}
+
+static void test_stress_preemption(void)
+{
+    uint16_t copy[STRESS_BLOCK];
+    uint32_t taken = 0U, intact = 0U, torn = 0U, falseIntact = 0U, lastSeq = 0U, seqErrors = 0U;
+    struct sigaction sa;
+    struct itimerval timer = { { 0, STRESS_TICK_US }, { 0, STRESS_TICK_US } };
+
+    app_host_init();
+    hal_fake_tick_set_hook(NULL);
+    adc_capture_host_set_source(source_index);
+    CHECK(adc_capture_start(STRESS_BLOCK, 50000U));
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = dma_tick;
+    sigemptyset(&sa.sa_mask);
+    CHECK(sigaction(SIGALRM, &sa, NULL) == 0);
+    samplesDone = 0;
+    CHECK(setitimer(ITIMER_REAL, &timer, NULL) == 0);
+
+    while (samplesDone < (sig_atomic_t)STRESS_SAMPLES) {
+        const uint16_t *pBlock;
+        uint32_t seq;
+        if (!adc_capture_get_block(&pBlock, &seq)) {
+            continue;
+        }
+        taken++;
+        seqErrors += (seq <= lastSeq) ? 1U : 0U;
+        lastSeq = seq;
+
+        /* copy at varying speed so the DMA catches up now and then */
+        for (uint32_t i = 0U; i < STRESS_BLOCK; ++i) {
+            copy[i] = __atomic_load_n(&pBlock[i], __ATOMIC_RELAXED);
+            for (volatile uint32_t spin = 0U; spin < ((taken % 4U) * 4000U); spin = spin + 1U) {
+            }
+        }
+        if (adc_capture_release_block()) {
+            intact++;
+            falseIntact += block_consecutive(copy, STRESS_BLOCK) ? 0U : 1U;
+        } else {
+            torn++;
+        }
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, NULL);
+    signal(SIGALRM, SIG_DFL);
+    adc_capture_stop();
+
+    const AdcCaptureStats_t *pStats = adc_capture_get_stats();
+    printf("stress: %u blocks, %u taken, %u intact, %u torn, %u dropped, %u overrun\n",
+           pStats->blocks_u32, taken, intact, torn, pStats->dropped_u32, pStats->overrun_u32);
+    CHECK(falseIntact == 0U);
+    CHECK(seqErrors == 0U);
+    CHECK(pStats->blocks_u32 == (STRESS_SAMPLES / STRESS_BLOCK));
+    CHECK(pStats->overrun_u32 == torn);     // the ISR preempts, never runs beside the consumer
+    CHECK((taken + pStats->dropped_u32) <= pStats->blocks_u32);
+    CHECK((taken + pStats->dropped_u32) >= (pStats->blocks_u32 - 1U));    // the last one may still be pending
+    CHECK(intact > 0U);
+    CHECK(torn > 0U);
+}
+
+int main(void)
+{
+    test_sequence_and_drops();
+    test_torn_block();
+    test_single_block_mV();
+    test_stress_preemption();
+    return TEST_DONE();
+}
@@ -0,0 +1,219 @@
+/*
+ * test_audio.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Audio output (audio_out.c, audio_synth.c, cs43l22.c) on the fake I2S: the stream
+ *      the DMA plays, half by half as the callbacks refill it, equals one long synthesis
+ *      and a sine within a few LSB; retunes land on a block boundary without a phase
+ *      jump; refill cost per block; the CS43L22 volume mapping.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "audio_out.h"
+#include "audio_synth.h"
+#include "profiling.h"
+
+#define BLOCK       AUDIO_OUT_FRAMES_PER_BLOCK
+#define NUM_BLOCKS  200U
+#define PI_D        3.14159265358979323846
+
+#define CS43L22_REG_MASTER_A_VOL    0x20U
+#define CS43L22_REG_MASTER_B_VOL    0x21U
+
+static int16_t played[NUM_BLOCKS * BLOCK];      /* left channel as the DAC receives it */
+static int16_t reference[NUM_BLOCKS * BLOCK * 2U];
+
+/*
+ * Let the DMA play numBlocks halves: copy the half it has just finished, then raise the
+ * event that makes the driver refill it. Returns false if L != R anywhere.
+ */
+static bool play_blocks(int16_t *pDst, uint32_t firstBlock, uint32_t numBlocks)
+{
+    uint32_t len;
+    const int16_t *pBuf = hal_fake_i2s_buffer(&len);
+    bool stereoOk = (len == (4U * BLOCK));
+
+    for (uint32_t b = firstBlock; b < (firstBlock + numBlocks); ++b) {
+        const int16_t *pHalf = &pBuf[(b & 1U) * 2U * BLOCK];
+        for (uint32_t i = 0U; i < BLOCK; ++i) {
+            pDst[(b * BLOCK) + i] = pHalf[2U * i];
+            stereoOk = stereoOk && (pHalf[2U * i] == pHalf[(2U * i) + 1U]);
+        }
+        if ((b & 1U) == 0U) {
+            hal_fake_i2s_half();
+        } else {
+            hal_fake_i2s_complete();
+        }
+    }
+    return stereoOk;
+}
+
+static AudioSynthParams_t tone_set(uint32_t f0, uint16_t a0, uint32_t f1, uint16_t a1)
+{
+    AudioSynthParams_t p = { 0 };
+    p.numTones_u8 = (a1 != 0U) ? 2U : 1U;
+    p.freqs_u32[0] = f0;
+    p.amps_u16[0]  = a0;
+    p.freqs_u32[1] = f1;
+    p.amps_u16[1]  = a1;
+    return p;
+}
+
+/* Block-wise output == one long synthesis == a sine */
+static void test_phase_continuity(void)
+{
+    const AudioSynthParams_t params = tone_set(1000U, 1000U, 7919U, 300U);
+
+    app_host_init();
+    CHECK(audio_out_start(&params, 255U));
+    CHECK(hal_fake_i2s_running());
+    CHECK(play_blocks(played, 0U, NUM_BLOCKS));
+    CHECK(audio_out_get_stats()->blocks_u32 == NUM_BLOCKS);
+
+    AudioSynth_t synth;
+    audio_synth_init(&synth, AUDIO_OUT_FS, &params);
+    audio_synth_fill(&synth, reference, NUM_BLOCKS * BLOCK);
+    uint32_t diffs = 0U;
+    for (uint32_t i = 0U; i < (NUM_BLOCKS * BLOCK); ++i) {
+        diffs += (played[i] != reference[2U * i]) ? 1U : 0U;
+    }
+    CHECK_MSG(diffs == 0U, "%u samples differ from one long synthesis", diffs);
+
+    // Against the analytic signal: full scale is AUDIO_SYNTH_FULL_SCALE_MV
+    const double scale = 32767.0 / AUDIO_SYNTH_FULL_SCALE_MV;
+    double maxErr = 0.0;
+    for (uint32_t n = 0U; n < (NUM_BLOCKS * BLOCK); ++n) {
+        const double t = (double)n / AUDIO_OUT_FS;
+        const double want = scale * ((1000.0 * sin(2.0 * PI_D * 1000.0 * t)) + (300.0 * sin(2.0 * PI_D * 7919.0 * t)));
+        const double err = fabs((double)played[n] - want);
+        maxErr = (err > maxErr) ? err : maxErr;
+    }
+    CHECK_MSG(maxErr <= 16.0, "max error %.2f LSB", maxErr);     // arm_sin_f32 table: ~5e-4 of full scale
+    audio_out_stop();
+    CHECK(!hal_fake_i2s_running());
+}
+
+/* A retune takes effect at the next refill, the phase runs on */
+static void test_retune(void)
+{
+    const AudioSynthParams_t first  = tone_set(1000U, 1600U, 0U, 0U);
+    const AudioSynthParams_t second = tone_set(3000U, 1600U, 0U, 0U);
+
+    app_host_init();
+    CHECK(audio_out_start(&first, 255U));
+    CHECK(play_blocks(played, 0U, 5U));
+    CHECK(audio_out_update(&second));       // applied by the refill of block 7 (after 5 refills)
+    CHECK(play_blocks(played, 5U, 20U));
+    audio_out_stop();
+    CHECK(!audio_out_update(&second));       // not running
+
+    // Blocks 0..6 were rendered before the retune: 1 kHz; from block 7 on 3 kHz
+    const double scale = 32767.0 / AUDIO_SYNTH_FULL_SCALE_MV;
+    const uint32_t edge = 7U * BLOCK;
+    double maxErr = 0.0;
+    for (uint32_t n = 0U; n < (25U * BLOCK); ++n) {
+        const double phase = (n < edge) ? (2.0 * PI_D * 1000.0 * n / AUDIO_OUT_FS)
+                                        : (2.0 * PI_D * ((1000.0 * edge) + (3000.0 * (n - edge))) / AUDIO_OUT_FS);
+        const double err = fabs((double)played[n] - (scale * 1600.0 * sin(phase)));
+        maxErr = (err > maxErr) ? err : maxErr;
+    }
+    CHECK_MSG(maxErr <= 16.0, "max error %.2f LSB against the continuous phase", maxErr);
+
+    // No step at the boundary larger than the steepest slope of the 3 kHz tone
+    const double maxStep = scale * 1600.0 * 2.0 * PI_D * 3000.0 / AUDIO_OUT_FS;
+    CHECK(fabs((double)played[edge] - (double)played[edge - 1U]) <= (maxStep + 2.0));
+}
+
+/* Cost of one refill against its 2.67 ms period */
+static void test_refill_cost(void)
+{
+    const AudioSynthParams_t params = tone_set(440U, 800U, 5000U, 800U);
+
+    app_host_init();
+    prof_reset();
+    CHECK(audio_out_start(&params, 200U));
+    CHECK(play_blocks(played, 0U, NUM_BLOCKS));
+    const AudioOutStats_t *pStats = audio_out_get_stats();
+    const ProfStats_t *pProf = prof_get_stats(PROF_AUDIO_REFILL);
+    const uint32_t blockTicks = (uint32_t)(((uint64_t)prof_tick_hz() * BLOCK) / AUDIO_OUT_FS);
+
+    printf("refill: mean %u, max %u ticks per %u-frame block (period %u ticks)\n",
+           prof_stats_mean(pProf), pStats->maxTicks_u32, BLOCK, blockTicks);
+    CHECK(pStats->blocks_u32 == NUM_BLOCKS);
+    CHECK(pProf->count_u32 == NUM_BLOCKS);
+    CHECK(pStats->maxTicks_u32 == pProf->max_u32);
+    CHECK((pStats->lastTicks_u32 > 0U) && (pStats->lastTicks_u32 <= pStats->maxTicks_u32));
+    CHECK(prof_stats_mean(pProf) < (blockTicks / 4U));
+    audio_out_stop();
+}
+
+/* 255 = 0 dB, 0.5 dB per count below, -102 dB floor; never above 0 dB */
+static void test_volume(void)
+{
+    static const struct {
+        uint8_t volume;
+        uint8_t reg;
+    } cases[] = {
+        { 255U, 0x00U },    // 0 dB
+        { 254U, 0xFFU },    // -0.5 dB
+        { 200U, 0xC9U },    // -27.5 dB
+        { 52U,  0x35U },    // -101.5 dB
+        { 51U,  0x34U },    // -102 dB
+        { 0U,   0x34U },
+    };
+    const AudioSynthParams_t params = tone_set(1000U, 100U, 0U, 0U);
+
+    for (uint32_t c = 0U; c < (sizeof(cases) / sizeof(cases[0])); ++c) {
+        app_host_init();
+        CHECK(audio_out_start(&params, cases[c].volume));
+        CHECK_MSG(hal_fake_i2c_reg(CS43L22_REG_MASTER_A_VOL) == cases[c].reg, "volume %u -> 0x%02X",
+                  cases[c].volume, hal_fake_i2c_reg(CS43L22_REG_MASTER_A_VOL));
+        CHECK(hal_fake_i2c_reg(CS43L22_REG_MASTER_B_VOL) == cases[c].reg);
+        audio_out_stop();
+    }
+
+    // Every setting is at or below 0 dB and one step per count
+    for (uint32_t v = 52U; v <= 255U; ++v) {
+        app_host_init();
+        CHECK(audio_out_start(&params, (uint8_t)v));
+        const int32_t reg = hal_fake_i2c_reg(CS43L22_REG_MASTER_A_VOL);
+        const int32_t halfDb = (reg <= 0x18) ? reg : (reg - 256);     // 0x19..0x33 are not used
+        CHECK_MSG(halfDb == ((int32_t)v - 255), "volume %u -> 0x%02X", v, (unsigned)reg);
+        audio_out_stop();
+    }
+}
+
+static void test_commands(void)
+{
+    app_host_init();
+    CHECK(app_host_command("{\"cmd\":\"AUDIO_START\",\"num_tones\":1,\"freqs\":[1000],\"amps\":[500],\"volume\":255}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:AUDIO_START|OK|{\"fs\":96000,\"block\":256,\"num_tones\":1,\"volume\":255}>") != NULL);
+    CHECK(hal_fake_i2c_reg(CS43L22_REG_MASTER_A_VOL) == 0x00U);
+    CHECK(play_blocks(played, 0U, 4U));
+    CHECK(app_host_command("{\"cmd\":\"AUDIO_SET\",\"num_tones\":1,\"freqs\":[2000],\"amps\":[500]}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:AUDIO_SET|OK|{\"num_tones\":1}>") != NULL);
+    CHECK(app_host_command("{\"cmd\":\"AUDIO_SET\",\"num_tones\":1,\"freqs\":[48000],\"amps\":[500]}"));
+    CHECK(strstr(app_host_output(NULL), "\"error\":\"freq_above_nyquist\"") != NULL);
+    CHECK(app_host_command("{\"cmd\":\"AUDIO_STOP\"}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:AUDIO_STOP|OK|{\"blocks\":4,\"late\":0,") != NULL);
+    CHECK(app_host_command("{\"cmd\":\"AUDIO_STOP\"}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:AUDIO_STOP|FAIL|{\"error\":\"not_running\"}>") != NULL);
+}
+
+int main(void)
+{
+    test_phase_continuity();
+    test_retune();
+    test_refill_cost();
+    test_volume();
+    test_commands();
+    return TEST_DONE();
+}
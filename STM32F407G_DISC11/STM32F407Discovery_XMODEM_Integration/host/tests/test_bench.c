@@ -0,0 +1,156 @@
+/*
+ * test_bench.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Benchmark baseline handling (bench.c): rows of the CSV/JSON schema as baseline,
+ *      the regression check against it, BENCH_BASELINE and RUN_BENCH on the host.
+ */
+
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "bench.h"
+
+static uint32_t count_occurrences(const char *text, const char *what)
+{
+    uint32_t n = 0U;
+    for (const char *p = strstr(text, what); p != NULL; p = strstr(p + 1, what)) {
+        n++;
+    }
+    return n;
+}
+
+/* Row of kernel/len/tones in CSV output, or NULL */
+static const char *find_csv_row(const char *out, const char *prefix)
+{
+    const char *p = strstr(out, prefix);
+    while ((p != NULL) && (p != out) && (p[-1] != '\n')) {
+        p = strstr(p + 1, prefix);
+    }
+    return p;
+}
+
+static void test_load_rows(void)
+{
+    bench_clear_baseline();
+
+    /* CSV and JSON rows of the schema */
+    CHECK(bench_load_baseline_row("fft,1024,1,float32,3,100,120,0.117,8.533,0,0.0,new\r\n"));
+    CHECK(bench_load_baseline_row("{\"kernel\":\"gen_f32\",\"len\":64,\"tones\":4,\"dtype\":\"float32\",\"reps\":3,"
+                                  "\"min_ticks\":10,\"mean_ticks\":12,\"ticks_per_sample\":0.188,\"msps\":5.3,"
+                                  "\"baseline_ticks\":0,\"delta_pct\":0.0,\"status\":\"new\"}\r\n"));
+    CHECK(bench_load_baseline_row("  crc32,16,1,float32,3,5,6,0.375,2.6,0,0.0,new"));
+
+    /* the column line, unknown cases and foreign lines are skipped */
+    CHECK(!bench_load_baseline_row("kernel,len,tones,dtype,reps,min_ticks,mean_ticks,ticks_per_sample,msps,baseline_ticks,delta_pct,status\r\n"));
+    CHECK(!bench_load_baseline_row("fft,1000,1,float32,3,100,120,0.1,8.5,0,0.0,new"));       // no such length
+    CHECK(!bench_load_baseline_row("fft,1024,4,float32,3,100,120,0.1,8.5,0,0.0,new"));       // fft does not sweep tones
+    CHECK(!bench_load_baseline_row("gen_f32,64,5,float32,3,100,120,0.1,8.5,0,0.0,new"));     // not a tone step
+    CHECK(!bench_load_baseline_row("fft_x,1024,1,float32,3,100,120,0.1,8.5,0,0.0,new"));
+    CHECK(!bench_load_baseline_row("fft,1024,1,float32,3,100,0,0,0,0,0.0,new"));             // no mean
+    CHECK(!bench_load_baseline_row("fft,1024,1"));
+    CHECK(!bench_load_baseline_row("{\"cmd\":\"RUN_BENCH\",\"status\":\"DONE\",\"args\":{\"regress\":0,\"baseline_saved\":0}}"));
+    CHECK(!bench_load_baseline_row(""));
+}
+
+/* A baseline of 1 tick is beaten by every real run, a huge one never */
+static void test_regression_check(void)
+{
+    const BenchConfig_t cfg = { 1U, 32U, 5U, BENCH_FORMAT_CSV, false };
+
+    app_host_init();
+    bench_clear_baseline();
+    CHECK(bench_load_baseline_row("window,32,1,float32,1,1,1,0.031,32.0,0,0.0,new"));
+    CHECK(bench_load_baseline_row("crc32,32,1,float32,1,1,4000000000,0,0,0,0.0,new"));
+    app_host_output_clear();
+
+    CHECK(bench_run(&cfg) == 1U);
+    const char *out = app_host_output(NULL);
+    const char *row = find_csv_row(out, "window,32,1,float32,1,");
+    CHECK((row != NULL) && (strncmp(strstr(row, "\r\n") - 8, ",regress", 8) == 0));
+    row = find_csv_row(out, "crc32,32,1,float32,1,");
+    CHECK((row != NULL) && (strncmp(strstr(row, "\r\n") - 3, ",ok", 3) == 0));
+    row = find_csv_row(out, "fft,32,1,float32,1,");
+    CHECK((row != NULL) && (strncmp(strstr(row, "\r\n") - 4, ",new", 4) == 0));
+
+    /* lengths above max_len are not run */
+    CHECK(find_csv_row(out, "fft,64,") == NULL);
+    CHECK(find_csv_row(out, "fft,16,") == NULL);        // the FFT skips unsupported lengths
+    CHECK(find_csv_row(out, "window,16,1,") != NULL);   // the other kernels do not
+
+    /* a run saved as baseline turns every case of the next run into ok/regress */
+    const BenchConfig_t save = { 1U, 32U, 1000000U, BENCH_FORMAT_JSON, true };
+    bench_clear_baseline();
+    CHECK(bench_run(&save) == 0U);
+    app_host_output_clear();
+    CHECK(bench_run(&save) == 0U);
+    out = app_host_output(NULL);
+    CHECK(count_occurrences(out, "\"status\":\"new\"") == 0U);
+    CHECK(count_occurrences(out, "\"status\":\"ok\"") == count_occurrences(out, "{\"kernel\":"));
+}
+
+/* The rows of one run, fed back line by line, are the baseline of the next */
+static void test_round_trip(void)
+{
+    static char rows[64U * 1024U];
+    const BenchConfig_t json = { 1U, 64U, 1000000U, BENCH_FORMAT_JSON, false };
+
+    app_host_init();
+    bench_clear_baseline();
+    app_host_output_clear();
+    CHECK(bench_run(&json) == 0U);
+    strncpy(rows, app_host_output(NULL), sizeof(rows) - 1U);
+
+    uint32_t loaded = 0U;
+    for (char *line = strtok(rows, "\n"); line != NULL; line = strtok(NULL, "\n")) {
+        loaded += bench_load_baseline_row(line) ? 1U : 0U;
+    }
+    CHECK(loaded == count_occurrences(app_host_output(NULL), "{\"kernel\":"));
+    CHECK(loaded > 0U);
+
+    app_host_output_clear();
+    const BenchConfig_t csv = { 1U, 64U, 1000000U, BENCH_FORMAT_CSV, false };
+    CHECK(bench_run(&csv) == 0U);
+    CHECK(count_occurrences(app_host_output(NULL), ",new\r\n") == 0U);
+    CHECK(count_occurrences(app_host_output(NULL), ",ok\r\n") == loaded);
+}
+
+static void test_commands(void)
+{
+    app_host_init();
+    app_host_output_clear();
+
+    CHECK(app_host_command("{\"cmd\":\"BENCH_BASELINE\",\"clear\":1}"));
+    CHECK(strstr(app_host_output(NULL), "\"cleared\":1") != NULL);
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"BENCH_BASELINE\",\"kernel\":\"xmodem_crc\",\"len\":16,\"tones\":1,"
+                           "\"dtype\":\"uint16\",\"reps\":3,\"min_ticks\":1,\"mean_ticks\":1}"));
+    CHECK(strstr(app_host_output(NULL), "\"loaded\":1") != NULL);
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"BENCH_BASELINE\",\"kernel\":\"nope\",\"len\":16,\"tones\":1,\"mean_ticks\":1}"));
+    CHECK(strstr(app_host_output(NULL), "\"error\":\"unknown_case\"") != NULL);
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"RUN_BENCH\",\"reps\":1,\"max_len\":16,\"format\":0}"));
+    const char *out = app_host_output(NULL);
+    CHECK(strstr(out, "{\"cmd\":\"RUN_BENCH\",\"status\":\"OK\",\"args\":{\"format\":0,\"reps\":1,\"max_len\":16,") != NULL);
+    CHECK(strstr(out, "kernel,len,tones,dtype,reps,min_ticks,mean_ticks,ticks_per_sample,msps,baseline_ticks,delta_pct,status\r\n") != NULL);
+    const char *row = find_csv_row(out, "xmodem_crc,16,1,uint16,1,");
+    CHECK((row != NULL) && (strncmp(strstr(row, "\r\n") - 8, ",regress", 8) == 0));
+    CHECK(strstr(out, "\"status\":\"DONE\",\"args\":{\"regress\":1,\"baseline_saved\":0}") != NULL);
+}
+
+int main(void)
+{
+    test_load_rows();
+    test_regression_check();
+    test_round_trip();
+    test_commands();
+    return TEST_DONE();
+}
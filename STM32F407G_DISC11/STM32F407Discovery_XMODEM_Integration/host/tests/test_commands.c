@@ -0,0 +1,151 @@
+/*
+ * test_commands.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      The command path on the host: USART2 DMA reception -> line assembly ->
+ *      command queue -> execute_command() -> handler -> USART2, plus the fakes
+ *      behind the platform port (tick, RNG, LEDs).
+ */
+
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "board_config.h"
+#include "uart_app.h"
+#include "state_machine.h"
+
+static uint32_t count_occurrences(const char *text, const char *what)
+{
+    uint32_t n = 0U;
+    for (const char *p = strstr(text, what); p != NULL; p = strstr(p + 1, what)) {
+        n++;
+    }
+    return n;
+}
+
+static void test_version_commands(void)
+{
+    app_host_init();
+    app_host_output_clear();
+
+    CHECK(app_host_command("{\"cmd\":\"READ_HW\"}"));
+    const char *out = app_host_output(NULL);
+    CHECK(strstr(out, "[DBG] Received: {\"cmd\":\"READ_HW\"}") != NULL);
+    CHECK(strstr(out, "{\"cmd\":\"READ_HW\",\"status\":\"OK\",\"data\":\"STM32407DISCOVERY_MB998_C-01\"}\r\n") != NULL);
+    CHECK(strstr(out, "[DBG]:Enter command:") != NULL);
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_SER\"}\r\n"));     // CR before LF is trimmed
+    CHECK(strstr(app_host_output(NULL), "\"data\":\"STM32407DISCOVERY#001\"}") != NULL);
+}
+
+static void test_unknown_commands(void)
+{
+    app_host_init();
+    app_host_output_clear();
+
+    CHECK(app_host_command("{\"cmd\":\"NO_SUCH_CMD\"}"));
+    CHECK(strstr(app_host_output(NULL), "Command <{\"cmd\":\"NO_SUCH_CMD\"}> not recognized") != NULL);
+
+    app_host_output_clear();
+    CHECK(app_host_command("READ_FW"));
+    CHECK(strstr(app_host_output(NULL), "Command <READ_FW> not recognized") != NULL);
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":"));
+    CHECK(strstr(app_host_output(NULL), "JSON parsing failed") != NULL);
+}
+
+static void test_split_reception(void)
+{
+    // A line arriving in pieces is executed once, when its newline is in
+    const char *part1 = "{\"cmd\":\"RE";
+    const char *part2 = "AD_HW\"}\n";
+
+    app_host_init();
+    app_host_output_clear();
+    CHECK(hal_fake_uart_rx(PLATFORM_UART_DEBUG, (const uint8_t *)part1, strlen(part1)) == strlen(part1));
+    execute_command();
+    CHECK(app_host_output(NULL)[0] == '\0');
+    CHECK(hal_fake_uart_rx(PLATFORM_UART_DEBUG, (const uint8_t *)part2, strlen(part2)) == strlen(part2));
+    execute_command();
+    CHECK(count_occurrences(app_host_output(NULL), "\"cmd\":\"READ_HW\",\"status\":\"OK\"") == 1U);
+}
+
+static void test_queue_full(void)
+{
+    // COMMAND_BUFFER_SIZE lines are queued while the main loop is busy, the next is dropped
+    const char *line = "{\"cmd\":\"READ_HW\"}\n";
+
+    app_host_init();
+    app_host_output_clear();
+    for (uint32_t i = 0U; i < (COMMAND_BUFFER_SIZE + 1U); ++i) {
+        CHECK(hal_fake_uart_rx(PLATFORM_UART_DEBUG, (const uint8_t *)line, strlen(line)) == strlen(line));
+    }
+    for (uint32_t i = 0U; i < (COMMAND_BUFFER_SIZE + 1U); ++i) {
+        execute_command();
+    }
+    CHECK(count_occurrences(app_host_output(NULL), "\"cmd\":\"READ_HW\",\"status\":\"OK\"") == COMMAND_BUFFER_SIZE);
+}
+
+static void test_platform_fakes(void)
+{
+    uint32_t a, b;
+
+    app_host_init();
+
+    // Tick: frozen, explicit, auto step
+    hal_fake_tick_set_auto(0U);
+    const uint32_t t0 = platform_get_time_ms();
+    CHECK(platform_get_time_ms() == t0);
+    platform_delay_ms(25U);
+    CHECK(platform_get_time_ms() == (t0 + 25U));
+    hal_fake_tick_set_auto(1U);
+    CHECK(platform_get_time_ms() == (t0 + 26U));
+
+    // RNG: deterministic per seed, errors reported
+    hal_fake_rng_seed(1234U);
+    CHECK(platform_rng_read(&a));
+    hal_fake_rng_seed(1234U);
+    CHECK(platform_rng_read(&b) && (a == b));
+    CHECK(platform_rng_read(&b) && (a != b));
+    hal_fake_rng_set_fail(true);
+    CHECK(!platform_rng_read(&b));
+
+    // LEDs on GPIOD 12..15
+    write_GreenLed_PD12(true);
+    write_BlueLed_PD15(true);
+    CHECK((hal_fake_gpiod_odr() & 0xF000U) == 0x9000U);
+    toggle_GreenLed_PD12();
+    write_BlueLed_PD15(false);
+    toggle_RedLed_PD14();
+    CHECK((hal_fake_gpiod_odr() & 0xF000U) == 0x4000U);
+
+    // UART: baud as configured by CubeMX, wire model costs character times
+    CHECK(platform_uart_get_baud(PLATFORM_UART_DEBUG) == 921600U);
+    hal_fake_tick_set_auto(0U);
+    hal_fake_uart_set_wire(true);
+    const uint32_t t1 = platform_get_time_ms();
+    static uint8_t block[9216];     // 92160 bit = 100 ms at 921600 baud
+    CHECK(platform_uart_write(PLATFORM_UART_DEBUG2, block, sizeof(block)));
+    CHECK(platform_get_time_ms() == (t1 + 100U));
+
+    uint32_t len;
+    (void)hal_fake_uart_tx(PLATFORM_UART_DEBUG2, &len);
+    CHECK(len >= sizeof(block));
+}
+
+int main(void)
+{
+    test_version_commands();
+    test_unknown_commands();
+    test_split_reception();
+    test_queue_full();
+    test_platform_fakes();
+    return TEST_DONE();
+}
@@ -0,0 +1,154 @@
+/*
+ * test_mem_placement.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Placement rules (mem_placement.c): the classifier on the F407 map and on a
+ *      simulated map, the DMA-buffer assertion, and where the linker put the
+ *      MEM_CCM_BSS buffers (all of them in .ccmram_bss, nothing in the loaded .ccmram).
+ */
+
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "mem_placement.h"
+#include "signal_memory.h"
+
+extern uint8_t _sccmram, _eccmram, _sccmram_bss, _eccmram_bss;
+
+static void test_classify_f407(void)
+{
+    const MemMap_t *m = &memMapF407;
+
+    /* first and last byte of every region */
+    CHECK(mem_classify(m, MEM_FLASH_START, 1U) == MEM_REGION_FLASH);
+    CHECK(mem_classify(m, MEM_FLASH_START + MEM_FLASH_SIZE - 1U, 1U) == MEM_REGION_FLASH);
+    CHECK(mem_classify(m, MEM_CCM_START, 1U) == MEM_REGION_CCM);
+    CHECK(mem_classify(m, MEM_CCM_START + MEM_CCM_SIZE - 1U, 1U) == MEM_REGION_CCM);
+    CHECK(mem_classify(m, MEM_SRAM_START, 1U) == MEM_REGION_SRAM);
+    CHECK(mem_classify(m, MEM_SRAM_START + MEM_SRAM_SIZE - 1U, 1U) == MEM_REGION_SRAM);
+
+    /* whole regions, and one byte more */
+    CHECK(mem_classify(m, MEM_CCM_START, MEM_CCM_SIZE) == MEM_REGION_CCM);
+    CHECK(mem_classify(m, MEM_CCM_START, MEM_CCM_SIZE + 1U) == MEM_REGION_UNKNOWN);
+    CHECK(mem_classify(m, MEM_SRAM_START, MEM_SRAM_SIZE) == MEM_REGION_SRAM);
+    CHECK(mem_classify(m, MEM_SRAM_START + 4U, MEM_SRAM_SIZE) == MEM_REGION_UNKNOWN);
+
+    /* outside the map: below flash, between regions, above SRAM, 0 */
+    CHECK(mem_classify(m, MEM_FLASH_START - 1U, 1U) == MEM_REGION_UNKNOWN);
+    CHECK(mem_classify(m, MEM_CCM_START + MEM_CCM_SIZE, 4U) == MEM_REGION_UNKNOWN);
+    CHECK(mem_classify(m, MEM_SRAM_START - 4U, 4U) == MEM_REGION_UNKNOWN);
+    CHECK(mem_classify(m, MEM_SRAM_START + MEM_SRAM_SIZE, 4U) == MEM_REGION_UNKNOWN);
+    CHECK(mem_classify(m, 0U, 4U) == MEM_REGION_UNKNOWN);
+
+    /* a length that wraps the 32-bit address space must not alias into a region */
+    CHECK(mem_classify(m, MEM_SRAM_START + 16U, 0xFFFFFFF8UL) == MEM_REGION_UNKNOWN);
+
+    /* empty ranges, no map, addresses beyond 32 bit */
+    CHECK(mem_classify(m, MEM_SRAM_START, 0U) == MEM_REGION_UNKNOWN);
+    CHECK(mem_classify(NULL, MEM_SRAM_START, 4U) == MEM_REGION_UNKNOWN);
+#if UINTPTR_MAX > 0xFFFFFFFFUL
+    CHECK(mem_classify(m, (uintptr_t)0x100000000ULL + MEM_SRAM_START, 4U) == MEM_REGION_UNKNOWN);
+#endif
+
+    /* DMA capability: flash and SRAM yes, CCM never, straddling never */
+    CHECK(mem_is_dma_capable(m, MEM_FLASH_START + 0x100U, 64U));
+    CHECK(mem_is_dma_capable(m, MEM_SRAM_START + 0x100U, 64U));
+    CHECK(!mem_is_dma_capable(m, MEM_CCM_START + 0x100U, 64U));
+    CHECK(!mem_is_dma_capable(m, MEM_SRAM_START + MEM_SRAM_SIZE - 32U, 64U));
+    CHECK(!mem_is_dma_capable(m, MEM_SRAM_START, 0U));
+}
+
+/* Two adjacent regions: a range across the seam belongs to neither */
+static void test_classify_simulated(void)
+{
+    static const MemRegionDesc_t regions[] = {
+        { 0x1000U, 0x1000U, MEM_REGION_CCM,  false },
+        { 0x2000U, 0x1000U, MEM_REGION_SRAM, true  },
+    };
+    const MemMap_t m = { regions, 2U };
+
+    CHECK(mem_classify(&m, 0x1FFCU, 4U) == MEM_REGION_CCM);
+    CHECK(mem_classify(&m, 0x2000U, 4U) == MEM_REGION_SRAM);
+    CHECK(mem_classify(&m, 0x1FFCU, 8U) == MEM_REGION_UNKNOWN);
+    CHECK(!mem_is_dma_capable(&m, 0x1FFCU, 8U));
+    CHECK(mem_is_dma_capable(&m, 0x2FFCU, 4U));
+    CHECK(!mem_is_dma_capable(&m, 0x2FFCU, 5U));
+
+    const MemMap_t empty = { regions, 0U };
+    CHECK(mem_classify(&empty, 0x2000U, 4U) == MEM_REGION_UNKNOWN);
+}
+
+static void test_assert_dma_buffer(void)
+{
+    app_host_init();
+    CHECK(hal_fake_error_count() == 0U);     // the startup check passed on the host map
+    app_host_output_clear();
+
+    /* Against the F407 map: SRAM passes silently, CCM halts with a message */
+    mem_set_map(NULL);
+    mem_assert_dma_buffer((const void *)(uintptr_t)(MEM_SRAM_START + 0x400U), 256U, "sram_buf");
+    CHECK(hal_fake_error_count() == 0U);
+    CHECK(app_host_output(NULL)[0] == '\0');
+
+    mem_assert_dma_buffer((const void *)(uintptr_t)(MEM_CCM_START + 0x400U), 256U, "ccm_buf");
+    CHECK(hal_fake_error_count() == 1U);
+    CHECK(strstr(app_host_output(NULL),
+                 "DMA buffer <ccm_buf> @0x10000400 (256 bytes) is not DMA-reachable (region 1)") != NULL);
+
+    /* straddling SRAM end reports UNKNOWN */
+    app_host_output_clear();
+    mem_assert_dma_buffer((const void *)(uintptr_t)(MEM_SRAM_START + MEM_SRAM_SIZE - 16U), 32U, "edge_buf");
+    CHECK(hal_fake_error_count() == 2U);
+    CHECK(strstr(app_host_output(NULL), "<edge_buf>") != NULL);
+    CHECK(strstr(app_host_output(NULL), "(region 3)") != NULL);
+
+    /* A map in which the real buffers sit in CCM makes the startup check fire for each */
+    const MemRegionDesc_t allCcm[] = { { 0U, 0xFFFFFFFFUL, MEM_REGION_CCM, false } };
+    const MemMap_t ccmMap = { allCcm, 1U };
+    mem_set_map(&ccmMap);
+    app_host_output_clear();
+    signal_memory_check_placement();
+    CHECK(hal_fake_error_count() == 5U);
+    CHECK(strstr(app_host_output(NULL), "<sigBUFFER_UNION>") != NULL);
+    CHECK(strstr(app_host_output(NULL), "<uart2_rxBuf>") != NULL);
+    CHECK(strstr(app_host_output(NULL), "<uart3_rxBuf>") != NULL);
+
+    mem_set_map(NULL);
+}
+
+static bool in_ccm_bss(const void *p, uint32_t len)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    return (b >= &_sccmram_bss) && ((b + len) <= &_eccmram_bss);
+}
+
+/* MEM_CCM_BSS must land in the NOLOAD section; a loaded .ccmram would copy ~60 KB from flash */
+static void test_ccm_sections(void)
+{
+    CHECK(in_ccm_bss(sigBUFF2, sizeof(sigBUFF2)));
+    CHECK(in_ccm_bss(sigWINDOW_CACHE, sizeof(sigWINDOW_CACHE)));
+    CHECK(in_ccm_bss(sigFIR_STATE, sizeof(sigFIR_STATE)));
+    CHECK(in_ccm_bss(sigWAVE_TABLE, sizeof(sigWAVE_TABLE)));
+    CHECK_MSG(&_eccmram == &_sccmram, ".ccmram holds %ld bytes", (long)(&_eccmram - &_sccmram));
+
+    const uint32_t bssLen_u32 = (uint32_t)(&_eccmram_bss - &_sccmram_bss);
+    CHECK(bssLen_u32 >= (sizeof(sigBUFF2) + sizeof(sigWINDOW_CACHE) + sizeof(sigFIR_STATE) + sizeof(sigWAVE_TABLE)));
+    CHECK(bssLen_u32 <= MEM_CCM_SIZE);
+
+    /* DMA buffers stay out of CCM */
+    CHECK(!in_ccm_bss(&sigBUFFER_UNION, 1U));
+}
+
+int main(void)
+{
+    test_classify_f407();
+    test_classify_simulated();
+    test_assert_dma_buffer();
+    test_ccm_sections();
+    return TEST_DONE();
+}
@@ -0,0 +1,241 @@
+/*
+ * test_profiling.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Profiling statistics (profiling.c): count/min/max/mean, the log2 histogram
+ *      edges, 64-bit sums, the probe table and READ_PROFILE with "reset", also with
+ *      the audio refill recorded in the middle of the dump as the I2S DMA callback can.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "profiling.h"
+
+static void test_stats_basic(void)
+{
+    ProfStats_t s;
+
+    prof_stats_reset(&s);
+    CHECK(s.count_u32 == 0U);
+    CHECK(s.min_u32 == UINT32_MAX);
+    CHECK(s.max_u32 == 0U);
+    CHECK(prof_stats_mean(&s) == 0U);       // empty: no division by zero
+
+    const uint32_t samples[] = { 100U, 7U, 250U, 64U, 63U };
+    for (uint32_t i = 0U; i < (sizeof(samples) / sizeof(samples[0])); ++i) {
+        prof_stats_add(&s, samples[i]);
+    }
+    CHECK(s.count_u32 == 5U);
+    CHECK(s.min_u32 == 7U);
+    CHECK(s.max_u32 == 250U);
+    CHECK(s.sum_u64 == 484U);
+    CHECK(prof_stats_mean(&s) == 96U);      // 484 / 5, truncated
+
+    uint32_t histTotal = 0U;
+    for (uint32_t b = 0U; b < PROF_HIST_BUCKETS; ++b) {
+        histTotal += s.hist_u32[b];
+    }
+    CHECK(histTotal == s.count_u32);
+}
+
+/* Bucket i holds floor(log2(ticks)) == i; 0 and 1 share bucket 0 */
+static void test_histogram_edges(void)
+{
+    ProfStats_t s;
+
+    prof_stats_reset(&s);
+    prof_stats_add(&s, 0U);
+    prof_stats_add(&s, 1U);
+    CHECK(s.hist_u32[0] == 2U);
+    CHECK(s.min_u32 == 0U);
+
+    for (uint32_t b = 1U; b < PROF_HIST_BUCKETS; ++b) {
+        prof_stats_reset(&s);
+        const uint32_t lo = 1UL << b;
+        const uint32_t hi = (b == 31U) ? UINT32_MAX : ((1UL << (b + 1U)) - 1U);
+        prof_stats_add(&s, lo);
+        prof_stats_add(&s, hi);
+        prof_stats_add(&s, lo - 1U);
+        CHECK_MSG(s.hist_u32[b] == 2U, "bucket %u holds %u", b, s.hist_u32[b]);
+        CHECK_MSG(s.hist_u32[b - 1U] == 1U, "bucket %u holds %u", b - 1U, s.hist_u32[b - 1U]);
+    }
+}
+
+/* The sum is 64 bit: many long samples do not wrap the mean */
+static void test_sum_no_overflow(void)
+{
+    ProfStats_t s;
+
+    prof_stats_reset(&s);
+    for (uint32_t i = 0U; i < 1000U; ++i) {
+        prof_stats_add(&s, UINT32_MAX);
+    }
+    CHECK(s.sum_u64 == (1000ULL * UINT32_MAX));
+    CHECK(prof_stats_mean(&s) == UINT32_MAX);
+    CHECK(s.hist_u32[31] == 1000U);
+    CHECK(s.min_u32 == UINT32_MAX);
+    CHECK(s.max_u32 == UINT32_MAX);
+}
+
+static void test_probes(void)
+{
+    prof_init();
+    for (uint32_t i = 0U; i < (uint32_t)PROF_NUM_PROBES; ++i) {
+        CHECK(prof_get_stats((ProfProbeId_t)i)->count_u32 == 0U);
+        CHECK(strcmp(prof_get_name((ProfProbeId_t)i), "?") != 0);
+    }
+    CHECK(prof_get_stats(PROF_NUM_PROBES) == NULL);
+    CHECK(strcmp(prof_get_name(PROF_NUM_PROBES), "?") == 0);
+
+    prof_record(PROF_AUDIO_REFILL, 40U);
+    prof_record(PROF_AUDIO_REFILL, 20U);
+    prof_record(PROF_NUM_PROBES, 99U);      // out of range: ignored
+    const ProfStats_t *pStats = prof_get_stats(PROF_AUDIO_REFILL);
+    CHECK(pStats->count_u32 == 2U);
+    CHECK(pStats->min_u32 == 20U);
+    CHECK(pStats->max_u32 == 40U);
+    CHECK(prof_stats_mean(pStats) == 30U);
+
+    /* the macros measure with prof_now(): a later end never reads as a negative span */
+    PROF_BEGIN(PROF_SIG_FFT_GEN);
+    for (volatile uint32_t spin = 0U; spin < 10000U; spin = spin + 1U) {
+    }
+    PROF_END(PROF_SIG_FFT_GEN);
+    pStats = prof_get_stats(PROF_SIG_FFT_GEN);
+    CHECK(pStats->count_u32 == 1U);
+    CHECK(pStats->max_u32 < prof_tick_hz());   // well below one second
+
+    prof_reset();
+    CHECK(prof_get_stats(PROF_AUDIO_REFILL)->count_u32 == 0U);
+    CHECK(prof_get_stats(PROF_AUDIO_REFILL)->min_u32 == UINT32_MAX);
+}
+
+/* Value of "key": in the probe line named name, or -1 */
+static long probe_field(const char *out, const char *name, const char *key)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "{\"name\":\"%s\",", name);
+    const char *line = strstr(out, pattern);
+    if (line == NULL) {
+        return -1;
+    }
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *field = strstr(line, pattern);
+    return (field != NULL) ? strtol(field + strlen(pattern), NULL, 10) : -1;
+}
+
+static void test_read_profile(void)
+{
+    app_host_init();
+
+    /* READ_SIG_FFT records every sig_fft.* stage once */
+    CHECK(app_host_command("{\"cmd\":\"READ_SIG_FFT\",\"num_tones\":1,\"len\":256,\"freqs\":[4000],\"amps\":[1000],"
+                           "\"sampl_rate\":32000,\"data_type\":0,\"transfer\":1,\"filt_type\":1,\"sig_source\":0}"));
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_PROFILE\"}"));
+    const char *out = app_host_output(NULL);
+
+    CHECK(strstr(out, "{\"cmd\":\"READ_PROFILE\",\"status\":\"OK\",\"args\":{\"enabled\":1,\"tick_hz\":1000000000,\"probes\":[") != NULL);
+    const char *stages[] = { "sig_fft.gen", "sig_fft.send_raw", "sig_fft.filter", "sig_fft.send_time",
+                             "sig_fft.window", "sig_fft.fft", "sig_fft.mag", "sig_fft.send_fft" };
+    long stageSum = 0;
+    for (uint32_t i = 0U; i < (sizeof(stages) / sizeof(stages[0])); ++i) {
+        CHECK_MSG(probe_field(out, stages[i], "count") == 1, "%s", stages[i]);
+        CHECK_MSG(probe_field(out, stages[i], "min") == probe_field(out, stages[i], "max"), "%s", stages[i]);
+        stageSum += probe_field(out, stages[i], "mean");
+    }
+    CHECK(probe_field(out, "sig_fft.total", "count") == 1);
+    CHECK(probe_field(out, "sig_fft.total", "mean") >= stageSum);
+
+    /* an unused probe reports min 0, not UINT32_MAX */
+    CHECK(probe_field(out, "audio.refill", "count") == 0);
+    CHECK(probe_field(out, "audio.refill", "min") == 0);
+    CHECK(strstr(out, "\"hist\":[0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]}\r\n]}}\r\n") != NULL);
+
+    /* "reset":1 dumps, then clears */
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_PROFILE\",\"reset\":1}"));
+    CHECK(probe_field(app_host_output(NULL), "sig_fft.total", "count") == 1);
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_PROFILE\"}"));
+    CHECK(probe_field(app_host_output(NULL), "sig_fft.total", "count") == 0);
+}
+
+/* Sum of the "hist" buckets in the probe line named name */
+static long probe_hist_sum(const char *out, const char *name)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "{\"name\":\"%s\",", name);
+    const char *p = strstr(out, pattern);
+    if ((p == NULL) || ((p = strstr(p, "\"hist\":[")) == NULL)) {
+        return -1;
+    }
+    p += strlen("\"hist\":[");
+    long sum = 0;
+    for (uint32_t b = 0U; b < PROF_HIST_BUCKETS; ++b) {
+        char *end;
+        sum += strtol(p, &end, 10);
+        p = end + 1;
+    }
+    return sum;
+}
+
+/* A refill (the I2S DMA callback on the target) on every UART write of the dump */
+static void refill_on_tx(PlatformUart_t port, const uint8_t *pData, uint32_t len)
+{
+    (void)port;
+    (void)pData;
+    (void)len;
+    prof_record(PROF_AUDIO_REFILL, 1000U);
+}
+
+static void test_read_profile_isr(void)
+{
+    app_host_init();
+    hal_fake_uart_set_tx_hook(refill_on_tx);
+
+    /* The line is one copy: count, min/max/mean and the histogram agree */
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_PROFILE\"}"));
+    const char *out = app_host_output(NULL);
+    const long count = probe_field(out, "audio.refill", "count");
+    CHECK(count > 0);
+    CHECK_MSG(probe_hist_sum(out, "audio.refill") == count, "hist sum %ld, count %ld",
+              probe_hist_sum(out, "audio.refill"), count);
+    CHECK((probe_field(out, "audio.refill", "min") == 1000) && (probe_field(out, "audio.refill", "max") == 1000));
+    CHECK(probe_field(out, "audio.refill", "mean") == 1000);
+
+    /* "reset":1 clears each probe with its copy: refills after it are kept for the next dump */
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_PROFILE\",\"reset\":1}"));
+    out = app_host_output(NULL);
+    const long dumped = probe_field(out, "audio.refill", "count");
+    CHECK(probe_hist_sum(out, "audio.refill") == dumped);
+
+    hal_fake_uart_set_tx_hook(NULL);
+    const uint32_t before = prof_get_stats(PROF_AUDIO_REFILL)->count_u32;
+    CHECK(before > 0U);
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_PROFILE\"}"));
+    out = app_host_output(NULL);
+    CHECK(probe_field(out, "audio.refill", "count") == (long)before);
+    CHECK(probe_hist_sum(out, "audio.refill") == (long)before);
+}
+
+int main(void)
+{
+    test_stats_basic();
+    test_histogram_edges();
+    test_sum_no_overflow();
+    test_probes();
+    test_read_profile();
+    test_read_profile_isr();
+    return TEST_DONE();
+}
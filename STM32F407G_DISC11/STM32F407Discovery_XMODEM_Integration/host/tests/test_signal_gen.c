@@ -0,0 +1,405 @@
+/*
+ * test_signal_gen.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Persistent signal generator (signal_gen.c): blocks of any size, concatenated, are
+ *      exactly one long generation in every mode and output type, and so are one-shot
+ *      calls with startSample_u32; a sampling rate of 0 gives the DC offset instead of a
+ *      division by zero and is rejected by the command parser. The waveform modes against
+ *      their laws: instantaneous frequency of the chirps and of FM, AM crest factor, table
+ *      interpolation, Schroeder crest factor; out-of-range AM depth and FM deviation clamp.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "signal_gen.h"
+#include "signal_config_parser.h"
+
+#define GEN_LEN     20000U
+#define FS          48000U
+#define SIG_AMP_MV  1000.0f
+#define PI_D        3.14159265358979323846
+
+static const uint32_t freqs[3] = { 1000U, 2500U, 7U };
+static const uint16_t amps[3]  = { 500U, 300U, 100U };
+static const int16_t  table[5] = { 0, 20000, 32767, -12000, -32768 };
+static uint16_t       phases[3];
+
+static float32_t longF32[GEN_LEN], blockF32[GEN_LEN];
+static uint16_t  longU16[GEN_LEN], blockU16[GEN_LEN];
+static q15_t     longQ15[GEN_LEN], blockQ15[GEN_LEN];
+
+static SignalGen_HandleType make_handle(const SignalGen_Wave_t *pWave)
+{
+    SignalGen_HandleType h = { 0 };
+    h.numSamples_u32   = GEN_LEN;
+    h.samplingRate_u32 = FS;
+    h.dcOffset_u16     = 1650U;
+    h.vRef_u16         = 3300U;
+    h.adcMaxValue_u16  = 4095U;
+    h.numTones_u8      = 3U;
+    h.pToneFreqs_u32   = freqs;
+    h.pToneAmps_u16    = amps;
+    h.sineMethod       = SINE_METHOD_CMSIS;
+    h.pWave            = pWave;
+    return h;
+}
+
+static SignalGen_Wave_t make_wave(SignalGen_Mode_t mode)
+{
+    SignalGen_Wave_t w = { 0 };
+    w.mode            = mode;
+    w.pTonePhases_u16 = phases;
+    w.f1_u32          = 9000U;
+    w.sweepLen_u32    = 4321U;          // several sweeps, restarts inside blocks
+    w.modFreq_u32     = 37U;
+    w.modDepth_u32    = (mode == SIG_MODE_AM) ? 800U : 400U;
+    w.pTable_s16      = table;
+    w.tableLen_u16    = (uint16_t)(sizeof(table) / sizeof(table[0]));
+    return w;
+}
+
+/* Random block sizes, 0 included, until len samples are produced */
+static void generate_blocks(const SignalGen_HandleType *h, DataType_t type, void *pOut, size_t elemSize)
+{
+    SignalGen_State_t s;
+    uint32_t done = 0U;
+
+    SignalGen_StateInit(&s, h);
+    while (done < GEN_LEN) {
+        uint32_t n = (uint32_t)(rand() % 700);
+        n = ((done + n) > GEN_LEN) ? (GEN_LEN - done) : n;
+        SignalGen_Next(&s, n, type, (uint8_t *)pOut + ((size_t)done * elemSize));
+        done += n;
+    }
+    CHECK(s.sampleIdx_u32 == GEN_LEN);
+}
+
+static void test_blocks_equal_long_generation(void)
+{
+    static const char *names[SIG_MODE_MAX] = { "tones", "chirp_lin", "chirp_log", "am", "fm", "table" };
+
+    SignalGen_SchroederPhases(3U, phases);
+    srand(35);
+    for (uint32_t m = 0U; m < (uint32_t)SIG_MODE_MAX; ++m) {
+        const SignalGen_Wave_t wave = make_wave((SignalGen_Mode_t)m);
+        const SignalGen_HandleType h = make_handle(&wave);
+        SignalGen_State_t s;
+
+        SignalGen_StateInit(&s, &h);
+        SignalGen_Next(&s, GEN_LEN, DATA_TYPE_FLOAT32, longF32);
+        SignalGen_StateInit(&s, &h);
+        SignalGen_Next(&s, GEN_LEN, DATA_TYPE_UINT16, longU16);
+        SignalGen_StateInit(&s, &h);
+        SignalGen_Next(&s, GEN_LEN, DATA_TYPE_Q15, longQ15);
+
+        generate_blocks(&h, DATA_TYPE_FLOAT32, blockF32, sizeof(float32_t));
+        generate_blocks(&h, DATA_TYPE_UINT16, blockU16, sizeof(uint16_t));
+        generate_blocks(&h, DATA_TYPE_Q15, blockQ15, sizeof(q15_t));
+        CHECK_MSG(memcmp(longF32, blockF32, sizeof(longF32)) == 0, "%s: float32 blocks differ", names[m]);
+        CHECK_MSG(memcmp(longU16, blockU16, sizeof(longU16)) == 0, "%s: uint16 blocks differ", names[m]);
+        CHECK_MSG(memcmp(longQ15, blockQ15, sizeof(longQ15)) == 0, "%s: q15 blocks differ", names[m]);
+
+        // Not a constant: the comparison above would hold trivially
+        uint32_t changes = 0U;
+        for (uint32_t i = 1U; i < GEN_LEN; ++i) {
+            changes += (longQ15[i] != longQ15[i - 1U]) ? 1U : 0U;
+        }
+        CHECK_MSG(changes > (GEN_LEN / 2U), "%s: %u changes", names[m], changes);
+    }
+}
+
+/* One-shot calls with startSample_u32 continue the phase as well */
+static void test_start_sample_slices(void)
+{
+    SignalGen_SchroederPhases(3U, phases);
+    for (uint32_t m = 0U; m < (uint32_t)SIG_MODE_MAX; ++m) {
+        const SignalGen_Wave_t wave = make_wave((SignalGen_Mode_t)m);
+        SignalGen_HandleType h = make_handle(&wave);
+        SignalGen_State_t s;
+
+        SignalGen_StateInit(&s, &h);
+        SignalGen_Next(&s, GEN_LEN, DATA_TYPE_UINT16, longU16);
+
+        for (uint32_t start = 0U; start < GEN_LEN; start += 1024U) {
+            h.startSample_u32 = start;
+            h.numSamples_u32  = ((GEN_LEN - start) < 1024U) ? (GEN_LEN - start) : 1024U;
+            h.pOutBuffer_u16  = &blockU16[start];
+            SignalGen_GenerateComposite_Q15(&h);
+        }
+        CHECK_MSG(memcmp(longU16, blockU16, sizeof(longU16)) == 0, "mode %u: slices differ", m);
+    }
+}
+
+/* fs = 0: every tone at phase 0, the DC offset only, no division by zero */
+static void test_zero_sampling_rate(void)
+{
+    for (uint32_t m = 0U; m < (uint32_t)SIG_MODE_MAX; ++m) {
+        const SignalGen_Wave_t wave = make_wave((SignalGen_Mode_t)m);
+        SignalGen_HandleType h = make_handle((m == (uint32_t)SIG_MODE_TABLE) ? NULL : &wave);
+        SignalGen_State_t s;
+
+        h.samplingRate_u32 = 0U;
+        h.startSample_u32  = 100U;
+        SignalGen_StateInit(&s, &h);
+        SignalGen_Next(&s, 256U, DATA_TYPE_UINT16, longU16);
+        SignalGen_Next(&s, 256U, DATA_TYPE_FLOAT32, longF32);
+        for (uint32_t i = 0U; i < 256U; ++i) {
+            CHECK_MSG(longU16[i] == 2048U, "mode %u sample %u: %u", m, i, longU16[i]);     // 1650 mV
+            CHECK(longF32[i] == 1650.0f);
+        }
+        CHECK(SignalGen_Retune(&s, &(SignalGen_Tones_t){ .numTones_u8 = 1U, .freqs_u32 = { 1000U }, .amps_u16 = { 10U } }));
+        SignalGen_Next(&s, 16U, DATA_TYPE_Q15, longQ15);
+        CHECK(longQ15[15] == 0);
+    }
+}
+
+static void test_parser_rejects_zero_rate(void)
+{
+    JsonParsedSigGenPar_HandlType_t config;
+
+    app_host_init();
+    app_host_output_clear();
+    CHECK(parse_and_validate_signal_config("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":64,"
+                                           "\"freqs\":[1000],\"amps\":[500],\"sampl_rate\":0}",
+                                           "READ_SCALED_SIG", &config) == -1);
+    CHECK(strstr(app_host_output(NULL), "<RESP:READ_SCALED_SIG|FAIL|{\"error\":\"invalid_sampl_rate\"}>") != NULL);
+
+    /* missing still falls back to the default */
+    CHECK(parse_and_validate_signal_config("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":64,"
+                                           "\"freqs\":[1000],\"amps\":[500]}",
+                                           "READ_SCALED_SIG", &config) == 0);
+    CHECK(config.sampl_rate == 1024000U);
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_SIG_FFT\",\"num_tones\":1,\"len\":1024,"
+                           "\"freqs\":[1000],\"amps\":[500],\"sampl_rate\":0}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:READ_SIG_FFT|FAIL|{\"error\":\"invalid_sampl_rate\"}>") != NULL);
+}
+
+/* One carrier of SIG_AMP_MV around 0 mV, float output */
+static void generate_wave(const SignalGen_Wave_t *pWave, uint32_t f0, uint32_t len, float32_t *pOut)
+{
+    static uint32_t f0_u32;
+    static const uint16_t amp_u16 = (uint16_t)SIG_AMP_MV;
+    SignalGen_HandleType h = make_handle(pWave);
+    SignalGen_State_t s;
+
+    f0_u32 = f0;
+    h.numTones_u8    = 1U;
+    h.pToneFreqs_u32 = &f0_u32;
+    h.pToneAmps_u16  = &amp_u16;
+    h.dcOffset_u16   = 0U;
+    SignalGen_StateInit(&s, &h);
+    SignalGen_Next(&s, len, DATA_TYPE_FLOAT32, pOut);
+}
+
+#define FREQ_SPAN   8U      /* periods per frequency estimate */
+
+/*
+ * Frequency over FREQ_SPAN periods between rising zero crossings (linear interpolation),
+ * compared with the mean of the law over the same interval. Returns the largest error in Hz.
+ */
+static double max_freq_error(const float32_t *pSig, uint32_t len, double (*law)(double n))
+{
+    double crossings[FREQ_SPAN + 1U];
+    uint32_t count = 0U;
+    double maxErr = 0.0;
+
+    for (uint32_t i = 1U; i < len; ++i) {
+        if ((pSig[i - 1U] < 0.0f) && (pSig[i] >= 0.0f)) {
+            memmove(&crossings[0], &crossings[1], FREQ_SPAN * sizeof(double));
+            crossings[FREQ_SPAN] = (double)(i - 1U) + (pSig[i - 1U] / (pSig[i - 1U] - pSig[i]));
+            if (++count > FREQ_SPAN) {
+                const double span = crossings[FREQ_SPAN] - crossings[0];
+                double mean = 0.0;
+                for (uint32_t k = 0U; k < 16U; ++k) {
+                    mean += law(crossings[0] + (span * (k + 0.5) / 16.0)) / 16.0;
+                }
+                const double err = fabs((FREQ_SPAN * (double)FS / span) - mean);
+                maxErr = (err > maxErr) ? err : maxErr;
+            }
+        }
+    }
+    return maxErr;
+}
+
+#define CHIRP_F0    1000.0
+#define CHIRP_F1    9000.0
+#define CHIRP_LEN   GEN_LEN
+
+static double law_chirp_lin(double n)
+{
+    return CHIRP_F0 + ((CHIRP_F1 - CHIRP_F0) * n / CHIRP_LEN);
+}
+
+static double law_chirp_log(double n)
+{
+    return CHIRP_F0 * pow(CHIRP_F1 / CHIRP_F0, n / CHIRP_LEN);
+}
+
+#define FM_FC       6000.0
+#define FM_DEV      2000.0
+#define FM_FM       25.0
+
+static double law_fm(double n)
+{
+    return FM_FC + (FM_DEV * sin(2.0 * PI_D * FM_FM * n / FS));
+}
+
+static void test_chirp_frequency(void)
+{
+    SignalGen_Wave_t wave = make_wave(SIG_MODE_CHIRP_LIN);
+    wave.f1_u32       = (uint32_t)CHIRP_F1;
+    wave.sweepLen_u32 = CHIRP_LEN;
+
+    generate_wave(&wave, (uint32_t)CHIRP_F0, GEN_LEN, longF32);
+    double err = max_freq_error(longF32, GEN_LEN, law_chirp_lin);
+    CHECK_MSG(err < 20.0, "linear chirp: max error %.1f Hz", err);
+
+    wave.mode = SIG_MODE_CHIRP_LOG;
+    generate_wave(&wave, (uint32_t)CHIRP_F0, GEN_LEN, longF32);
+    err = max_freq_error(longF32, GEN_LEN, law_chirp_log);
+    CHECK_MSG(err < 20.0, "log chirp: max error %.1f Hz", err);
+
+    // Half way the log sweep is at the geometric mean, the linear one at the arithmetic
+    CHECK(fabs(law_chirp_log(CHIRP_LEN / 2.0) - 3000.0) < 1.0);
+}
+
+static void test_fm_frequency(void)
+{
+    SignalGen_Wave_t wave = make_wave(SIG_MODE_FM);
+    wave.modFreq_u32  = (uint32_t)FM_FM;
+    wave.modDepth_u32 = (uint32_t)FM_DEV;
+
+    generate_wave(&wave, (uint32_t)FM_FC, GEN_LEN, longF32);
+    const double err = max_freq_error(longF32, GEN_LEN, law_fm);
+    CHECK_MSG(err < 20.0, "FM: max error %.1f Hz", err);
+
+    // Deviations beyond fs/2 clamp there instead of overflowing or folding modulo fs
+    wave.modDepth_u32 = FS / 2U;
+    generate_wave(&wave, (uint32_t)FM_FC, 4096U, longF32);
+    wave.modDepth_u32 = 0xFFFFFFFFU;
+    generate_wave(&wave, (uint32_t)FM_FC, 4096U, blockF32);
+    CHECK(memcmp(longF32, blockF32, 4096U * sizeof(float32_t)) == 0);
+    wave.modDepth_u32 = FS + 10U;       // not the same as 10 Hz
+    generate_wave(&wave, (uint32_t)FM_FC, 4096U, blockF32);
+    CHECK(memcmp(longF32, blockF32, 4096U * sizeof(float32_t)) == 0);
+}
+
+static double crest_factor(const float32_t *pSig, uint32_t len)
+{
+    double peak = 0.0, sumSq = 0.0;
+
+    for (uint32_t i = 0U; i < len; ++i) {
+        const double v = fabs((double)pSig[i]);
+        peak = (v > peak) ? v : peak;
+        sumSq += v * v;
+    }
+    return peak / sqrt(sumSq / len);
+}
+
+/* Peak A(1 + m), crest factor (1 + m) / sqrt((1 + m^2/2) / 2), over whole modulation periods */
+static void test_am_envelope(void)
+{
+    static const uint32_t depths[] = { 0U, 300U, 800U, 1000U };
+    const uint32_t len = FS / 2U;       // 1 kHz carrier, 20 Hz modulation: 10 periods
+
+    for (uint32_t d = 0U; d < (sizeof(depths) / sizeof(depths[0])); ++d) {
+        SignalGen_Wave_t wave = make_wave(SIG_MODE_AM);
+        wave.modFreq_u32  = 20U;
+        wave.modDepth_u32 = depths[d];
+        generate_wave(&wave, 1000U, len, longF32);
+
+        const double m = depths[d] / 1000.0;
+        const double want = (1.0 + m) / sqrt((1.0 + (0.5 * m * m)) / 2.0);
+        const double crest = crest_factor(longF32, len);
+        double peak = 0.0;
+        for (uint32_t i = 0U; i < len; ++i) {
+            peak = (fabs(longF32[i]) > peak) ? fabs(longF32[i]) : peak;
+        }
+        CHECK_MSG(fabs(crest - want) < 0.01, "AM %u permille: crest %.4f, expected %.4f", depths[d], crest, want);
+        CHECK_MSG(fabs(peak - (SIG_AMP_MV * (1.0 + m))) < 2.0, "AM %u permille: peak %.1f mV", depths[d], peak);
+    }
+
+    // Over-modulation clamps to 100 % (the Q15 envelope would wrap otherwise)
+    SignalGen_Wave_t wave = make_wave(SIG_MODE_AM);
+    wave.modDepth_u32 = 1000U;
+    generate_wave(&wave, 1000U, 4096U, longF32);
+    wave.modDepth_u32 = 0xFFFFFFFFU;
+    generate_wave(&wave, 1000U, 4096U, blockF32);
+    CHECK(memcmp(longF32, blockF32, 4096U * sizeof(float32_t)) == 0);
+}
+
+/* One table period per carrier period, linearly interpolated */
+static void test_table_interpolation(void)
+{
+    const uint32_t f0 = 750U;
+    const uint32_t tableLen = sizeof(table) / sizeof(table[0]);
+    const SignalGen_Wave_t wave = make_wave(SIG_MODE_TABLE);
+    double maxErr = 0.0;
+
+    generate_wave(&wave, f0, GEN_LEN, longF32);
+    for (uint32_t n = 0U; n < GEN_LEN; ++n) {
+        const double pos  = fmod((double)n * f0 / FS, 1.0) * tableLen;
+        const uint32_t i0 = (uint32_t)pos;
+        const double y0   = table[i0];
+        const double y1   = table[(i0 + 1U) % tableLen];
+        const double want = SIG_AMP_MV * (y0 + ((y1 - y0) * (pos - i0))) / 32768.0;
+        const double err  = fabs((double)longF32[n] - want);
+        maxErr = (err > maxErr) ? err : maxErr;
+    }
+    CHECK_MSG(maxErr < 0.1, "table: max error %.3f mV", maxErr);
+}
+
+/* Equal-amplitude harmonics: Schroeder phases instead of all at 0 */
+static void test_schroeder_crest(void)
+{
+    static const uint16_t amp8[8] = { 200U, 200U, 200U, 200U, 200U, 200U, 200U, 200U };
+    static const uint32_t f8[8]   = { 500U, 1000U, 1500U, 2000U, 2500U, 3000U, 3500U, 4000U };
+    uint16_t phase8[8];
+    SignalGen_Wave_t wave = make_wave(SIG_MODE_TONES);
+    SignalGen_HandleType h = make_handle(&wave);
+    SignalGen_State_t s;
+    const uint32_t len = FS / 10U;      // 50 periods of the base
+
+    h.numTones_u8    = 8U;
+    h.pToneFreqs_u32 = f8;
+    h.pToneAmps_u16  = amp8;
+    h.dcOffset_u16   = 0U;
+    wave.pTonePhases_u16 = NULL;
+    SignalGen_StateInit(&s, &h);
+    SignalGen_Next(&s, len, DATA_TYPE_FLOAT32, longF32);
+    const double crestZero = crest_factor(longF32, len);
+
+    SignalGen_SchroederPhases(8U, phase8);
+    wave.pTonePhases_u16 = phase8;
+    SignalGen_StateInit(&s, &h);
+    SignalGen_Next(&s, len, DATA_TYPE_FLOAT32, longF32);
+    const double crestSchroeder = crest_factor(longF32, len);
+
+    printf("crest factor of 8 harmonics: %.3f at phase 0, %.3f Schroeder\n", crestZero, crestSchroeder);
+    CHECK(crestZero > 3.0);
+    CHECK(crestSchroeder < 2.0);
+}
+
+int main(void)
+{
+    test_blocks_equal_long_generation();
+    test_start_sample_slices();
+    test_zero_sampling_rate();
+    test_parser_rejects_zero_rate();
+    test_chirp_frequency();
+    test_fm_frequency();
+    test_am_envelope();
+    test_table_interpolation();
+    test_schroeder_crest();
+    return TEST_DONE();
+}
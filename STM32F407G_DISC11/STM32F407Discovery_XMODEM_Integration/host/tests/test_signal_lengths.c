@@ -0,0 +1,327 @@
+/*
+ * test_signal_lengths.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      32-bit sample counts through the signal pipeline: "len" values that do not fit
+ *      16 bit, the supported FFT lengths and their accuracy against a reference DFT
+ *      (8192 runs the split stage on top of the 4096-point complex FFT), and the
+ *      streamed READ_SCALED_SIG with the CRC-32 in the trailer.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "fft_utils.h"
+#include "crc_soft.h"
+#include "signal_memory.h"
+#include "signal_transfer.h"
+#include "signal_config_parser.h"
+
+static float32_t fftIn[FFT_MAX_LEN];
+static float32_t fftOut[FFT_MAX_LEN];
+static float32_t fftRef[FFT_MAX_LEN];
+
+static void test_parse_long_len(void)
+{
+    JsonParsedSigGenPar_HandlType_t config;
+
+    app_host_init();
+    CHECK(parse_and_validate_signal_config("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":70000,"
+                                           "\"freqs\":[1000],\"amps\":[500],\"sampl_rate\":48000}",
+                                           "READ_SCALED_SIG", &config) == 0);
+    CHECK(config.numSamples_u32 == 70000U);         // 70000 & 0xFFFF would be 4464
+
+    CHECK(parse_and_validate_signal_config("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":65536,"
+                                           "\"freqs\":[1000],\"amps\":[500],\"sampl_rate\":48000}",
+                                           "READ_SCALED_SIG", &config) == 0);
+    CHECK(config.numSamples_u32 == 65536U);
+
+    app_host_output_clear();
+    CHECK(parse_and_validate_signal_config("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":5000000,"
+                                           "\"freqs\":[1000],\"amps\":[500],\"sampl_rate\":48000}",
+                                           "READ_SCALED_SIG", &config) == 0);
+    CHECK(config.numSamples_u32 == SIG_STREAM_MAX_LEN);
+    CHECK(strstr(app_host_output(NULL), "'len'=5000000 exceeds max=1048576") != NULL);
+}
+
+static void test_supported_lengths(void)
+{
+    const uint32_t n = get_num_supported_fft_lengths();
+
+    CHECK(n > 0U);
+    CHECK(get_supported_fft_length_at(n - 1U) == FFT_MAX_LEN);
+    CHECK(get_supported_fft_length_at(n) == 0U);
+    for (uint32_t i = 0U; i < n; ++i) {
+        FftReal_Instance_f32 S;
+        const uint32_t len = get_supported_fft_length_at(i);
+        CHECK(is_valid_fft_length(len));
+        CHECK_MSG(fft_real_init_f32(&S, len) == ARM_MATH_SUCCESS, "len %u", len);
+    }
+
+    /* rounding down, including requests that overflow 16 bit */
+    CHECK(get_supported_fft_length(8192U) == 8192U);
+    CHECK(get_supported_fft_length(8191U) == 4096U);
+    CHECK(get_supported_fft_length(65535U) == FFT_MAX_LEN);
+    CHECK(get_supported_fft_length(65536U) == FFT_MAX_LEN);
+    CHECK(get_supported_fft_length(70000U) == FFT_MAX_LEN);
+    CHECK(get_supported_fft_length(0xFFFFFFFFUL) == FFT_MAX_LEN);
+    CHECK(get_supported_fft_length(0U) == get_supported_fft_length_at(0U));
+
+    CHECK(!is_valid_fft_length(8192U + 65536U));   // would alias 8192 if truncated to 16 bit
+    CHECK(!is_valid_fft_length(16384U));
+    CHECK(!is_valid_fft_length(3000U));
+
+    FftReal_Instance_f32 S;
+    CHECK(fft_real_init_f32(&S, 16384U) == ARM_MATH_ARGUMENT_ERROR);
+}
+
+/* Packed reference spectrum (arm_rfft_fast_f32 layout) of fftIn by a direct DFT */
+static void reference_dft(uint32_t n)
+{
+    double *cosTab = malloc(n * sizeof(double));
+    double *sinTab = malloc(n * sizeof(double));
+    for (uint32_t i = 0U; i < n; ++i) {
+        cosTab[i] = cos((2.0 * M_PI * (double)i) / (double)n);
+        sinTab[i] = sin((2.0 * M_PI * (double)i) / (double)n);
+    }
+
+    for (uint32_t k = 0U; k <= (n / 2U); ++k) {
+        double re = 0.0, im = 0.0;
+        uint32_t idx = 0U;
+        for (uint32_t t = 0U; t < n; ++t) {
+            re += fftIn[t] * cosTab[idx];
+            im -= fftIn[t] * sinTab[idx];
+            idx = (idx + k) & (n - 1U);
+        }
+        if (k == 0U) {
+            fftRef[0] = (float32_t)re;
+        } else if (k == (n / 2U)) {
+            fftRef[1] = (float32_t)re;
+        } else {
+            fftRef[2U * k]      = (float32_t)re;
+            fftRef[2U * k + 1U] = (float32_t)im;
+        }
+    }
+    free(cosTab);
+    free(sinTab);
+}
+
+static void fill_input(uint32_t n, uint32_t seed)
+{
+    for (uint32_t i = 0U; i < n; ++i) {
+        seed = (seed * 1664525U) + 1013904223U;
+        fftIn[i] = ((float32_t)(seed >> 8) / 8388608.0f) - 1.0f;
+    }
+}
+
+/* Relative RMS error of every supported length against the DFT */
+static void test_fft_accuracy(void)
+{
+    for (uint32_t i = 0U; i < get_num_supported_fft_lengths(); ++i) {
+        const uint32_t n = get_supported_fft_length_at(i);
+        FftReal_Instance_f32 S;
+
+        fill_input(n, 0x1234U + n);
+        reference_dft(n);
+        CHECK(fft_real_init_f32(&S, n) == ARM_MATH_SUCCESS);
+        fft_real_f32(&S, fftIn, fftOut);       // destroys fftIn
+
+        double errSq = 0.0, refSq = 0.0;
+        for (uint32_t k = 0U; k < n; ++k) {
+            const double d = (double)fftOut[k] - (double)fftRef[k];
+            errSq += d * d;
+            refSq += (double)fftRef[k] * fftRef[k];
+        }
+        const double relErr = sqrt(errSq / refSq);
+        CHECK_MSG(relErr < 2e-6, "len %u: relative error %.3g", n, relErr);
+    }
+}
+
+/* 8192: a tone between the 4096 bins lands in its own bin with amplitude A*N/2 */
+static void test_fft_8192_resolution(void)
+{
+    const uint32_t n = 8192U;
+    const uint32_t bin = 1001U;         // odd: not a bin of the 4096-point transform
+    FftReal_Instance_f32 S;
+
+    for (uint32_t t = 0U; t < n; ++t) {
+        fftIn[t] = 0.5f * cosf((2.0f * PI * (float32_t)((bin * t) % n)) / (float32_t)n)
+                 + 0.25f;
+    }
+    CHECK(fft_real_init_f32(&S, n) == ARM_MATH_SUCCESS);
+    fft_real_f32(&S, fftIn, fftOut);
+
+    CHECK(fabsf(fftOut[0] - (0.25f * n)) < 0.05f);
+    CHECK(fabsf(fftOut[1]) < 0.05f);
+    float32_t peak = 0.0f;
+    uint32_t peakBin = 0U;
+    for (uint32_t k = 1U; k < (n / 2U); ++k) {
+        const float32_t mag = hypotf(fftOut[2U * k], fftOut[2U * k + 1U]);
+        if (mag > peak) {
+            peak = mag;
+            peakBin = k;
+        }
+        if (k != bin) {
+            CHECK_MSG(mag < 0.05f, "bin %u leaks %.4f", k, mag);
+        }
+    }
+    CHECK(peakBin == bin);
+    CHECK(fabsf(peak - (0.25f * n)) < 0.05f);
+}
+
+/* Bytes written per HAL transmit call (the HAL size is 16 bit) */
+static uint32_t txCalls_u32;
+static uint32_t txMaxChunk_u32;
+
+static void count_tx(PlatformUart_t port, const uint8_t *pData, uint32_t len)
+{
+    (void)pData;
+    if (port == PLATFORM_UART_DEBUG) {
+        txCalls_u32++;
+        if (len > txMaxChunk_u32) {
+            txMaxChunk_u32 = len;
+        }
+    }
+}
+
+/* Next CRLF-terminated line starting at *pPos; the position moves past it */
+static const char *next_line(const char *out, uint32_t outLen, uint32_t *pPos, uint32_t *pLineLen)
+{
+    const char *start = out + *pPos;
+    const char *end = strstr(start, "\r\n");
+    if (end == NULL) {
+        return NULL;
+    }
+    *pLineLen = (uint32_t)(end - start);
+    *pPos = (uint32_t)(end - out) + 2U;
+    return (*pPos <= outLen) ? start : NULL;
+}
+
+static void test_streamed_binary(void)
+{
+    const uint32_t total = 70000U;      // 8 full blocks of MAX_SIG_LEN and one of 4464
+
+    app_host_init();
+    app_host_output_clear();
+    txCalls_u32 = 0U;
+    txMaxChunk_u32 = 0U;
+    hal_fake_uart_set_tx_hook(count_tx);
+
+    CHECK(app_host_command("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":70000,\"freqs\":[1000],"
+                           "\"amps\":[500],\"sampl_rate\":48000,\"data_type\":0,\"transfer\":1}"));
+    hal_fake_uart_set_tx_hook(NULL);
+
+    uint32_t outLen = 0U;
+    const char *out = app_host_output(&outLen);
+    const char *hdr = strstr(out, "{\"cmd\":\"READ_SCALED_SIG\",\"status\":\"OK\"");
+    CHECK(hdr != NULL);
+    if (hdr == NULL) {
+        return;
+    }
+    uint32_t pos = (uint32_t)(hdr - out), lineLen = 0U;
+    const char *line = next_line(out, outLen, &pos, &lineLen);
+    CHECK(line != NULL);
+    CHECK(strstr(line, "\"len\":70000,\"block\":8192,") != NULL);
+
+    /* total * 4 bytes of float32 follow the header, then the trailer */
+    const uint32_t payloadLen = total * sizeof(float32_t);
+    CHECK(outLen >= (pos + payloadLen));
+    if (outLen < (pos + payloadLen)) {
+        return;
+    }
+    const uint8_t *payload = (const uint8_t *)out + pos;
+
+    char expected[96];
+    snprintf(expected, sizeof(expected), "{\"cmd\":\"READ_SCALED_SIG\",\"status\":\"DONE\",\"args\":{\"len\":70000,\"crc\":%lu}}\r\n",
+             (unsigned long)calculate_crc32(payload, payloadLen));
+    CHECK(strncmp(out + pos + payloadLen, expected, strlen(expected)) == 0);
+
+    /* the samples are the signal in V/V, one continuous tone across the block seams */
+    const float32_t *pSamples = (const float32_t *)(const void *)payload;
+    float32_t maxAbs = 0.0f;
+    for (uint32_t i = 0U; i < total; ++i) {
+        float32_t d = fabsf(pSamples[i] - (1650.0f / 3300.0f));
+        maxAbs = (d > maxAbs) ? d : maxAbs;
+    }
+    CHECK(maxAbs < ((500.0f + 20.0f) / 3300.0f));
+    CHECK(maxAbs > ((500.0f - 20.0f) / 3300.0f));
+    for (uint32_t seam = MAX_SIG_LEN; seam < total; seam += MAX_SIG_LEN) {
+        const float32_t step = fabsf(pSamples[seam] - pSamples[seam - 1U]);
+        CHECK_MSG(step < ((2.0f * PI * 1000.0f / 48000.0f * 500.0f) + 20.0f) / 3300.0f,
+                  "seam %u jumps %.4f", seam, step);
+    }
+
+    /* no single HAL transmit exceeds the 16-bit size */
+    CHECK(txMaxChunk_u32 <= 0xFFFFU);
+    CHECK(txCalls_u32 > (payloadLen / 0xFFFFU));
+}
+
+static void test_streamed_ascii(void)
+{
+    app_host_init();
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_SCALED_SIG\",\"num_tones\":1,\"len\":9000,\"freqs\":[1000],"
+                           "\"amps\":[500],\"sampl_rate\":48000,\"data_type\":0,\"transfer\":0}"));
+
+    const char *out = app_host_output(NULL);
+    CHECK(strstr(out, "\"len\":9000,\"block\":8192,") != NULL);
+
+    /* two payload lines, 8192 + 808 values */
+    uint32_t lines = 0U, values = 0U;
+    for (const char *p = strstr(out, "{\"data\":{\"SIG1\":["); p != NULL; p = strstr(p + 1, "{\"data\":{\"SIG1\":[")) {
+        const char *end = strstr(p, "]}}");
+        CHECK(end != NULL);
+        if (end == NULL) {
+            break;
+        }
+        lines++;
+        values++;
+        for (const char *c = p; c < end; ++c) {
+            values += (*c == ',') ? 1U : 0U;
+        }
+    }
+    CHECK(lines == 2U);
+    CHECK(values == 9000U);
+    CHECK(strstr(out, "{\"cmd\":\"READ_SCALED_SIG\",\"status\":\"DONE\",\"args\":{\"len\":9000,\"crc\":") != NULL);
+}
+
+/* Chained crc32_update() over uneven chunks equals one CRC over everything */
+static void test_crc_chaining(void)
+{
+    static uint8_t data[100000];
+    for (uint32_t i = 0U; i < sizeof(data); ++i) {
+        data[i] = (uint8_t)((i * 131U) ^ (i >> 7));
+    }
+
+    CHECK(calculate_crc32((const uint8_t *)"123456789", 9U) == 0xCBF43926UL);
+
+    const uint32_t whole = calculate_crc32(data, sizeof(data));
+    uint32_t crc = 0U, pos = 0U, chunk = 1U;
+    while (pos < sizeof(data)) {
+        const uint32_t n = ((sizeof(data) - pos) < chunk) ? (uint32_t)(sizeof(data) - pos) : chunk;
+        crc = crc32_update(crc, &data[pos], n);
+        pos += n;
+        chunk = (chunk * 3U) + 1U;
+    }
+    CHECK(crc == whole);
+    CHECK(crc32_update(whole, data, 0U) == whole);
+}
+
+int main(void)
+{
+    test_parse_long_len();
+    test_supported_lengths();
+    test_fft_accuracy();
+    test_fft_8192_resolution();
+    test_crc_chaining();
+    test_streamed_binary();
+    test_streamed_ascii();
+    return TEST_DONE();
+}
@@ -0,0 +1,252 @@
+/*
+ * test_stream.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Continuous spectrum stream: the pacer and view reduction (spectrum_stream.c)
+ *      with explicit times, then START_STREAM/STOP_STREAM (stream_handle.c) over a
+ *      fake UART whose wire is slower than the configured baud rate: sequence numbers,
+ *      drop accounting, back-pressure, and the payload CRCs of both views.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "hal_fake.h"
+#include "crc_soft.h"
+#include "spectrum_stream.h"
+#include "stream_handle.h"
+
+#define SLOW_BAUD   115200U     /* real throughput of the link, the UART is configured for 921600 */
+
+/* Value of "key": in a header line, or -1 */
+static long header_field(const char *line, const char *key)
+{
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *field = strstr(line, pattern);
+    return (field != NULL) ? strtol(field + strlen(pattern), NULL, 10) : -1;
+}
+
+static void run_stream_ms(uint32_t ms)
+{
+    for (uint32_t t = 0U; t < ms; ++t) {
+        stream_task();
+        hal_fake_tick_advance(1U);
+    }
+}
+
+/* --- spectrum_stream.c --- */
+
+static void test_pacer(void)
+{
+    SpecStreamPacer_t p;
+    uint32_t seq;
+
+    spec_stream_pacer_init(&p, 100U, 1000U, SLOW_BAUD);
+    CHECK(p.bytesPerMsQ8_u32 == 2949U);                 // 11.52 bytes/ms
+    CHECK(spec_stream_frame_budget(&p) == 863U);        // 75 % of 1152 bytes
+
+    CHECK(spec_stream_pacer_due(&p, 1000U, &seq) && (seq == 0U));
+    CHECK(!spec_stream_pacer_due(&p, 1099U, &seq));
+    CHECK(spec_stream_pacer_due(&p, 1100U, &seq) && (seq == 1U));
+    CHECK(p.dropped_u32 == 0U);
+    CHECK(spec_stream_pacer_due(&p, 1450U, &seq) && (seq == 4U));
+    CHECK(p.dropped_u32 == 2U);                         // slots 2 and 3
+    spec_stream_pacer_drop(&p);
+    CHECK(p.dropped_u32 == 3U);
+    CHECK(!spec_stream_pacer_due(&p, 1499U, &seq));
+
+    // Short frames carry no rate information, longer ones move the estimate by 1/4
+    spec_stream_pacer_sent(&p, 500U, 1U, SPEC_VIEW_FULL);
+    CHECK(p.bytesPerMsQ8_u32 == 2949U);
+    spec_stream_pacer_sent(&p, 1000U, 50U, SPEC_VIEW_DECIM);
+    CHECK(p.bytesPerMsQ8_u32 == (2949U + ((5120U - 2949U) >> 2U)));
+    spec_stream_pacer_sent(&p, 0U, 1000U, SPEC_VIEW_DELTA);
+    CHECK(p.bytesPerMsQ8_u32 > 0U);                     // never 0, the budget stays usable
+    CHECK((p.sent_u32 == 3U) && (p.reduced_u32 == 2U));
+
+    // The slot grid survives the wrap of the millisecond counter
+    spec_stream_pacer_init(&p, 10U, UINT32_MAX - 5U, SLOW_BAUD);
+    CHECK(spec_stream_pacer_due(&p, UINT32_MAX - 5U, &seq) && (seq == 0U));
+    CHECK(spec_stream_pacer_due(&p, 24U, &seq) && (seq == 3U));
+    CHECK(p.dropped_u32 == 2U);
+}
+
+static void test_views(void)
+{
+    // 512 bins at 863 bytes: ASCII needs /16, binary /4; nothing fits -> max decimation
+    CHECK(spec_stream_select_decim(512U, 863U, DATA_TYPE_FLOAT32, TRANSFER_ASCII) == 16U);
+    CHECK(spec_stream_select_decim(512U, 863U, DATA_TYPE_FLOAT32, TRANSFER_BINARY) == 4U);
+    CHECK(spec_stream_select_decim(512U, 100000U, DATA_TYPE_FLOAT32, TRANSFER_BINARY) == 1U);
+    CHECK(spec_stream_select_decim(512U, 100U, DATA_TYPE_FLOAT32, TRANSFER_BINARY) == SPEC_STREAM_MAX_DECIM);
+    CHECK(spec_stream_delta_capacity(SPEC_STREAM_HEADER_BYTES, DATA_TYPE_FLOAT32, TRANSFER_BINARY) == 0U);
+    CHECK(spec_stream_delta_capacity(SPEC_STREAM_HEADER_BYTES + 60U, DATA_TYPE_FLOAT32, TRANSFER_BINARY) == 10U);
+
+    // Max-hold in place, the last group shorter
+    float32_t bins[10] = { 1.0f, 5.0f, 2.0f, 0.0f, 7.0f, 1.0f, 1.0f, 1.0f, 3.0f, 9.0f };
+    CHECK(spec_stream_decimate_max(bins, bins, 10U, 4U) == 3U);
+    CHECK((bins[0] == 5.0f) && (bins[1] == 7.0f) && (bins[2] == 9.0f));
+
+    // Changed bins against the reference, capacity overflow signalled
+    const float32_t ref[6] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+    const float32_t mag[6] = { 0.5f, 3.0f, 2.0f, 1.0f, 4.0f, 5.2f };
+    uint16_t idx[6];
+    float32_t val[6];
+    CHECK(spec_stream_changed_bins(mag, ref, 6U, 1.0f, idx, val, 6U) == 2U);
+    CHECK((idx[0] == 1U) && (val[0] == 3.0f) && (idx[1] == 3U) && (val[1] == 1.0f));
+    CHECK(spec_stream_changed_bins(mag, ref, 6U, 0.1f, idx, val, 3U) == 4U);
+}
+
+/* --- START_STREAM over a rate-limited link --- */
+
+static void test_rate_limited_link(void)
+{
+    app_host_init();
+    hal_fake_tick_set_auto(0U);
+    hal_fake_uart_set_wire(true);
+    hal_fake_uart_set_wire_baud(SLOW_BAUD);
+
+    // The first frame is sized for 921600 baud and outlasts several slots on the slow wire
+    CHECK(app_host_command("{\"cmd\":\"START_STREAM\",\"num_tones\":1,\"len\":1024,\"freqs\":[1000],\"amps\":[1000],"
+                           "\"sampl_rate\":32000,\"data_type\":0,\"transfer\":0,\"filt_type\":0,\"sig_source\":0,\"fps\":10}"));
+    run_stream_ms(5000U);
+    CHECK(app_host_command("{\"cmd\":\"STOP_STREAM\"}"));
+    hal_fake_uart_set_wire(false);
+
+    const char *out = app_host_output(NULL);
+    CHECK(strstr(out, "<RESP:START_STREAM|OK|{\"len\":1024,\"bins\":512,\"fps\":10,") != NULL);
+
+    uint32_t frames = 0U, reduced = 0U, tailGood = 0U;
+    long lastSeq = -1, lastDropped = 0;
+    const char *line = strstr(out, "{\"cmd\":\"STREAM_FFT\"");
+    while (line != NULL) {
+        const char *next = strstr(line + 1, "{\"cmd\":\"STREAM_FFT\"");
+        const long seq     = header_field(line, "seq");
+        const long dropped = header_field(line, "dropped");
+        const long view    = header_field(line, "view");
+
+        CHECK_MSG(seq > lastSeq, "frame %u seq %ld after %ld", frames, seq, lastSeq);
+        CHECK_MSG(dropped == (seq - (long)frames), "frame %u seq %ld dropped %ld", frames, seq, dropped);
+
+        // Once adapted, the frames fit the period of the real link and no slot is missed
+        const uint32_t bytes = (uint32_t)((next != NULL) ? (next - line) : (long)strlen(line));
+        if ((view == SPEC_VIEW_DECIM) && (seq == (lastSeq + 1)) && (bytes <= ((SLOW_BAUD / 10U) / 10U))) {
+            tailGood++;
+        } else {
+            tailGood = 0U;
+        }
+        reduced += (view != SPEC_VIEW_FULL) ? 1U : 0U;
+        lastSeq = seq;
+        lastDropped = dropped;
+        frames++;
+        line = next;
+    }
+
+    CHECK(frames > 10U);
+    CHECK(lastDropped > 0);                  // the oversized first frame cost slots
+    CHECK(tailGood >= 20U);                  // then back-pressure kept up with the link
+    char expected[160];
+    snprintf(expected, sizeof(expected), "<RESP:STOP_STREAM|OK|{\"last_seq\":%ld,\"sent\":%u,"
+             "\"dropped\":%ld,\"reduced\":%u,", lastSeq, frames, lastDropped, reduced);
+    CHECK_MSG(strstr(out, expected) != NULL, "%s", expected);
+    CHECK((uint32_t)(lastSeq + 1) == (frames + (uint32_t)lastDropped));
+
+    CHECK(app_host_command("{\"cmd\":\"STOP_STREAM\"}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:STOP_STREAM|FAIL|{\"error\":\"not_streaming\"}>") != NULL);
+}
+
+/* Binary frames: the CRC covers the payload of both views, the delta view rebuilds the spectrum */
+static void test_binary_crc(void)
+{
+    static float32_t hostSpectrum[512];
+    uint32_t len, pos = 0U, full = 0U, delta = 0U, sinceKey = 0U, maxSinceKey = 0U;
+
+    app_host_init();
+    hal_fake_tick_set_auto(0U);
+    CHECK(app_host_command("{\"cmd\":\"START_STREAM\",\"num_tones\":2,\"len\":1024,\"freqs\":[1000,3000],\"amps\":[1000,500],"
+                           "\"sampl_rate\":32000,\"data_type\":0,\"transfer\":1,\"filt_type\":0,\"sig_source\":0,"
+                           "\"fps\":20,\"view\":1,\"thr_mv\":1,\"keyframe\":4}"));
+    run_stream_ms(1000U);
+    handle_stop_stream(NULL);
+
+    const uint8_t *out = hal_fake_uart_tx(PLATFORM_UART_DEBUG, &len);
+    const char *first = strstr((const char *)out, "{\"cmd\":\"STREAM_FFT\"");     // the text before is all ASCII
+    CHECK(first != NULL);
+    pos = (uint32_t)(first - (const char *)out);
+
+    while ((pos < len) && (strncmp((const char *)&out[pos], "{\"cmd\":\"STREAM_FFT\"", 19) == 0)) {
+        char header[256];
+        const char *eol = strstr((const char *)&out[pos], "\r\n");
+        const uint32_t headerLen = (uint32_t)(eol - (const char *)&out[pos]);
+        CHECK(headerLen < sizeof(header));
+        memcpy(header, &out[pos], headerLen);
+        header[headerLen] = '\0';
+        pos += headerLen + 2U;
+
+        const long view = header_field(header, "view");
+        const uint32_t n = (uint32_t)header_field(header, "len");
+        const uint32_t payloadLen = (view == SPEC_VIEW_DELTA) ? (n * 6U) : (n * 4U);
+        CHECK((pos + payloadLen) <= len);
+        CHECK_MSG((uint32_t)header_field(header, "crc") == calculate_crc32(&out[pos], payloadLen), "%s", header);
+
+        if (view == SPEC_VIEW_FULL) {
+            CHECK(n == 512U);
+            memcpy(hostSpectrum, &out[pos], payloadLen);
+            full++;
+            sinceKey = 0U;
+        } else {
+            CHECK(view == SPEC_VIEW_DELTA);
+            CHECK(full > 0U);                       // a delta always refers to a full frame
+            for (uint32_t i = 0U; i < n; ++i) {
+                uint16_t idx;
+                memcpy(&idx, &out[pos + (2U * i)], sizeof(idx));
+                CHECK(idx < 512U);
+                memcpy(&hostSpectrum[idx], &out[pos + (2U * n) + (4U * i)], sizeof(float32_t));
+            }
+            delta++;
+            sinceKey++;
+            maxSinceKey = (sinceKey > maxSinceKey) ? sinceKey : maxSinceKey;
+        }
+        pos += payloadLen;
+    }
+    CHECK(strncmp((const char *)&out[pos], "<RESP:STOP_STREAM|OK|", 21) == 0);
+    CHECK((full > 0U) && (delta > 0U));
+    CHECK(maxSinceKey == 4U);                       // a key frame after every 4 deltas
+
+    // The rebuilt spectrum shows both tones at bins 32 and 96 (the scaling reads 2 * amp)
+    CHECK((hostSpectrum[32] > 1900.0f) && (hostSpectrum[32] < 2100.0f));
+    CHECK((hostSpectrum[96] > 950.0f) && (hostSpectrum[96] < 1050.0f));
+    CHECK(hostSpectrum[300] < 10.0f);
+}
+
+/* ASCII frames carry no CRC, in the full view as in the delta view */
+static void test_ascii_no_crc(void)
+{
+    app_host_init();
+    hal_fake_tick_set_auto(0U);
+    CHECK(app_host_command("{\"cmd\":\"START_STREAM\",\"num_tones\":1,\"len\":256,\"freqs\":[1000],\"amps\":[1000],"
+                           "\"sampl_rate\":32000,\"data_type\":0,\"transfer\":0,\"filt_type\":0,\"sig_source\":0,"
+                           "\"fps\":20,\"view\":1,\"thr_mv\":1,\"keyframe\":2}"));
+    run_stream_ms(500U);
+    handle_stop_stream(NULL);
+
+    const char *out = app_host_output(NULL);
+    CHECK(strstr(out, "\"view\":0,") != NULL);
+    CHECK(strstr(out, "\"view\":2,") != NULL);
+    CHECK(strstr(out, "\"crc\":") == NULL);
+}
+
+int main(void)
+{
+    test_pacer();
+    test_views();
+    test_rate_limited_link();
+    test_binary_crc();
+    test_ascii_no_crc();
+    return TEST_DONE();
+}
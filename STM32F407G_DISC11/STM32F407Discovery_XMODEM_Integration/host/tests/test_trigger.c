@@ -0,0 +1,293 @@
+/*
+ * test_trigger.c
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: roman
+ *
+ *  Description:
+ *      Trigger engine (trigger.c): the SWAR scan against a sample-by-sample reference
+ *      (random levels, lengths and alignments), windows on synthetic signals with known
+ *      trigger positions for every mode and block size, hold-off and re-arm, a random
+ *      stream against a reference of the whole capture, and READ_TRIG on the generator.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_check.h"
+#include "app_host.h"
+#include "trigger.h"
+
+#define SQ_LOW      1000U
+#define SQ_HIGH     3000U
+#define SQ_PERIOD   100U        /* low for 50 samples, then high for 50 */
+#define STREAM_LEN  4096U
+
+static uint16_t signalBuf[STREAM_LEN];
+static uint16_t ring[STREAM_LEN];
+static uint16_t window[STREAM_LEN];
+
+static uint32_t rngState = 12345U;
+
+static uint32_t rnd(uint32_t n)
+{
+    rngState ^= rngState << 13U;
+    rngState ^= rngState >> 17U;
+    rngState ^= rngState << 5U;
+    return rngState % n;
+}
+
+static bool ref_pred(const TrigConfig_t *pCfg, uint16_t s)
+{
+    switch (pCfg->mode) {
+        case TRIG_FALLING: return s < pCfg->level_u16;
+        case TRIG_WINDOW:  return (s < pCfg->level_u16) || (s > pCfg->levelHigh_u16);
+        default:           return s >= pCfg->level_u16;
+    }
+}
+
+/* trig_find() one sample at a time */
+static int32_t ref_find(const TrigConfig_t *pCfg, uint16_t prev, bool hasPrev, const uint16_t *pBlock, uint32_t len)
+{
+    const bool edge = (pCfg->mode != TRIG_LEVEL);
+    bool prevPred = edge && (!hasPrev || ref_pred(pCfg, prev));
+
+    for (uint32_t i = 0U; i < len; ++i) {
+        const bool p = ref_pred(pCfg, pBlock[i]);
+        if (p && !prevPred) {
+            return (int32_t)i;
+        }
+        prevPred = edge && p;
+    }
+    return -1;
+}
+
+/* First trigger of a whole stream: not before the hold-off, not before the history is full */
+static int32_t ref_stream_trigger(const TrigConfig_t *pCfg, const uint16_t *pSig, uint32_t len)
+{
+    const uint32_t t0 = (pCfg->holdoff_u32 > pCfg->preTrig_u32) ? pCfg->holdoff_u32 : pCfg->preTrig_u32;
+    if (t0 >= len) {
+        return -1;
+    }
+    const int32_t hit = ref_find(pCfg, (t0 > 0U) ? pSig[t0 - 1U] : 0U, t0 > 0U, &pSig[t0], len - t0);
+    return (hit < 0) ? -1 : (int32_t)(t0 + (uint32_t)hit);
+}
+
+/* Feed pSig in blocks of blockLen until DONE; returns the state */
+static TrigState_t feed(TrigEngine_t *pEng, const uint16_t *pSig, uint32_t len, uint32_t blockLen)
+{
+    for (uint32_t pos = 0U; (pos < len) && (pEng->state != TRIG_STATE_DONE); pos += blockLen) {
+        trig_process_block(pEng, &pSig[pos], ((len - pos) < blockLen) ? (len - pos) : blockLen);
+    }
+    return pEng->state;
+}
+
+static void make_square(void)
+{
+    for (uint32_t i = 0U; i < STREAM_LEN; ++i) {
+        signalBuf[i] = ((i % SQ_PERIOD) < (SQ_PERIOD / 2U)) ? SQ_LOW : SQ_HIGH;
+    }
+}
+
+/* The scan matches the reference for any level, length, predecessor and alignment */
+static void test_find_fuzz(void)
+{
+    static const uint16_t edgeLevels[] = { 0U, 1U, 2047U, 2048U, 4095U, 4096U, 0x7FFEU, 0x7FFFU };
+    uint16_t buf[80];
+    uint32_t mismatches = 0U;
+
+    for (uint32_t it = 0U; it < 500000U; ++it) {
+        TrigConfig_t cfg = { 0 };
+        cfg.mode = (TrigMode_t)rnd(TRIG_MODE_MAX);
+        cfg.level_u16 = (rnd(8U) == 0U) ? edgeLevels[rnd(8U)] : (uint16_t)rnd(4096U);
+        cfg.levelHigh_u16 = (rnd(8U) == 0U) ? 0x7FFFU : (uint16_t)(cfg.level_u16 + rnd(4097U - (cfg.level_u16 & 0xFFFU)));
+
+        const uint32_t offset = rnd(2U);                // odd start: unaligned words
+        const uint32_t len = rnd(67U);
+        const uint32_t span = (rnd(4U) == 0U) ? 0x8000U : 4096U;
+        for (uint32_t i = 0U; i < len; ++i) {
+            buf[offset + i] = (uint16_t)rnd(span);
+        }
+        const uint16_t prev = (uint16_t)rnd(4096U);
+        const bool hasPrev = (rnd(2U) != 0U);
+
+        const int32_t got  = trig_find(&cfg, prev, hasPrev, &buf[offset], len);
+        const int32_t want = ref_find(&cfg, prev, hasPrev, &buf[offset], len);
+        if (got != want) {
+            CHECK_MSG(mismatches > 4U, "mode %u level %u hi %u len %u: %d, want %d",
+                      cfg.mode, cfg.level_u16, cfg.levelHigh_u16, len, got, want);
+            mismatches++;
+        }
+    }
+    CHECK_MSG(mismatches == 0U, "%u mismatches", mismatches);
+}
+
+/* Square wave: rising edges at 50 + k * 100, falling at k * 100 (k >= 1) */
+static void test_known_positions(void)
+{
+    static const uint32_t blockLens[] = { 1U, 2U, 3U, 64U, 333U, STREAM_LEN };
+    static const struct {
+        TrigConfig_t cfg;
+        uint32_t     trigIdx;
+    } cases[] = {
+        { { TRIG_RISING,  2000U, 4095U,   0U, 10U,   0U },  50U },
+        { { TRIG_RISING,  2000U, 4095U, 120U, 80U,   0U }, 150U },    // the edge at 50 has no full history
+        { { TRIG_RISING,  2000U, 4095U,  10U, 10U, 260U }, 350U },    // hold-off
+        { { TRIG_FALLING, 2000U, 4095U,   0U,  1U,   0U }, 100U },
+        { { TRIG_FALLING, 2000U, 4095U,  99U, 50U, 101U }, 200U },
+        { { TRIG_LEVEL,   3000U, 4095U,   0U,  5U,   0U },  50U },
+        { { TRIG_LEVEL,   3000U, 4095U,  60U,  5U,   0U },  60U },    // level: already above when allowed
+        { { TRIG_WINDOW,   900U, 1100U,  20U, 30U,   0U },  50U },    // leaves the window upwards
+        { { TRIG_WINDOW,  2900U, 3100U,  70U, 30U,   0U }, 100U },    // starts outside: first sample that leaves
+    };
+
+    make_square();
+    for (uint32_t c = 0U; c < (sizeof(cases) / sizeof(cases[0])); ++c) {
+        for (uint32_t b = 0U; b < (sizeof(blockLens) / sizeof(blockLens[0])); ++b) {
+            TrigEngine_t eng;
+            const TrigConfig_t *pCfg = &cases[c].cfg;
+            CHECK(trig_init(&eng, pCfg, ring, STREAM_LEN, window));
+            CHECK_MSG(feed(&eng, signalBuf, STREAM_LEN, blockLens[b]) == TRIG_STATE_DONE, "case %u block %u", c, blockLens[b]);
+            CHECK_MSG(eng.trigIdx_u32 == cases[c].trigIdx, "case %u block %u: %u", c, blockLens[b], eng.trigIdx_u32);
+            CHECK(eng.outLen_u32 == (pCfg->preTrig_u32 + pCfg->postTrig_u32));
+            CHECK_MSG(memcmp(window, &signalBuf[cases[c].trigIdx - pCfg->preTrig_u32], eng.outLen_u32 * sizeof(uint16_t)) == 0,
+                      "case %u block %u window", c, blockLens[b]);
+        }
+    }
+}
+
+/* Re-arm: the hold-off counts from the previous trigger, the history starts over */
+static void test_rearm(void)
+{
+    const TrigConfig_t cfg = { TRIG_RISING, 2000U, 4095U, 30U, 40U, 150U };
+    TrigEngine_t eng;
+    uint32_t pos = 0U;
+
+    make_square();
+    CHECK(trig_init(&eng, &cfg, ring, 64U, window));
+    const uint32_t expected[] = { 150U, 350U, 550U, 750U };    // 150 + 150 = 300 -> 350, ...
+    for (uint32_t k = 0U; k < (sizeof(expected) / sizeof(expected[0])); ++k) {
+        while ((eng.state != TRIG_STATE_DONE) && (pos < STREAM_LEN)) {
+            trig_process_block(&eng, &signalBuf[pos], 16U);
+            pos += 16U;
+        }
+        CHECK_MSG((eng.state == TRIG_STATE_DONE) && (eng.trigIdx_u32 == expected[k]), "trigger %u at %u", k, eng.trigIdx_u32);
+        CHECK(memcmp(window, &signalBuf[expected[k] - 30U], 70U * sizeof(uint16_t)) == 0);
+        trig_rearm(&eng);
+    }
+
+    // Done swallows further samples without changing the window
+    CHECK(trig_init(&eng, &cfg, ring, 64U, window));
+    CHECK(feed(&eng, signalBuf, STREAM_LEN, 64U) == TRIG_STATE_DONE);
+    const uint32_t idx = eng.sampleIdx_u32;
+    CHECK(trig_process_block(&eng, signalBuf, 64U) == TRIG_STATE_DONE);
+    CHECK((eng.sampleIdx_u32 == (idx + 64U)) && (eng.trigIdx_u32 == 150U));
+
+    // Invalid configurations
+    TrigConfig_t bad = cfg;
+    bad.postTrig_u32 = 0U;
+    CHECK(!trig_init(&eng, &bad, ring, 64U, window));
+    bad = cfg;
+    bad.preTrig_u32 = 65U;
+    CHECK(!trig_init(&eng, &bad, ring, 64U, window));
+    bad = cfg;
+    bad.mode = TRIG_WINDOW;
+    bad.levelHigh_u16 = 1999U;
+    CHECK(!trig_init(&eng, &bad, ring, 64U, window));
+    bad = cfg;
+    bad.mode = TRIG_MODE_MAX;
+    CHECK(!trig_init(&eng, &bad, ring, 64U, window));
+}
+
+/* Random walk in random blocks against the reference of the whole stream */
+static void test_stream_fuzz(void)
+{
+    uint32_t triggered = 0U;
+
+    for (uint32_t it = 0U; it < 3000U; ++it) {
+        int32_t v = (int32_t)rnd(4096U);
+        for (uint32_t i = 0U; i < STREAM_LEN; ++i) {
+            v += (int32_t)rnd(201U) - 100;
+            v = (v < 0) ? 0 : ((v > 4095) ? 4095 : v);
+            signalBuf[i] = (uint16_t)v;
+        }
+
+        TrigConfig_t cfg = { 0 };
+        cfg.mode          = (TrigMode_t)rnd(TRIG_MODE_MAX);
+        cfg.level_u16     = (uint16_t)rnd(4096U);
+        cfg.levelHigh_u16 = (uint16_t)(cfg.level_u16 + rnd(4096U - cfg.level_u16));
+        cfg.preTrig_u32   = rnd(600U);
+        cfg.postTrig_u32  = 1U + rnd(600U);
+        cfg.holdoff_u32   = rnd(1000U);
+        const uint32_t ringCap = cfg.preTrig_u32 + rnd(100U);
+
+        TrigEngine_t eng;
+        CHECK(trig_init(&eng, &cfg, ring, ringCap, window));
+        uint32_t pos = 0U;
+        while ((pos < STREAM_LEN) && (eng.state != TRIG_STATE_DONE)) {
+            const uint32_t n = 1U + rnd(300U);
+            trig_process_block(&eng, &signalBuf[pos], ((STREAM_LEN - pos) < n) ? (STREAM_LEN - pos) : n);
+            pos += n;
+        }
+
+        const int32_t want = ref_stream_trigger(&cfg, signalBuf, STREAM_LEN);
+        const bool complete = (want >= 0) && (((uint32_t)want + cfg.postTrig_u32) <= STREAM_LEN);
+        CHECK_MSG((eng.state == TRIG_STATE_DONE) == complete, "it %u state %u want %d", it, eng.state, want);
+        if (complete && (eng.state == TRIG_STATE_DONE)) {
+            CHECK_MSG(eng.trigIdx_u32 == (uint32_t)want, "it %u: %u, want %d", it, eng.trigIdx_u32, want);
+            CHECK(memcmp(window, &signalBuf[(uint32_t)want - cfg.preTrig_u32],
+                         (cfg.preTrig_u32 + cfg.postTrig_u32) * sizeof(uint16_t)) == 0);
+            triggered++;
+        }
+    }
+    CHECK(triggered > 1000U);
+}
+
+/* READ_TRIG on the generator: the window is centred on a rising crossing */
+static void test_read_trig(void)
+{
+    app_host_init();
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_TRIG\",\"num_tones\":1,\"len\":1024,\"freqs\":[1000],\"amps\":[1000],"
+                           "\"sampl_rate\":32000,\"data_type\":1,\"transfer\":0,\"filt_type\":0,\"sig_source\":0,"
+                           "\"trig_mode\":0,\"level\":2600,\"pre\":256,\"post\":512}"));
+    const char *out = app_host_output(NULL);
+    const char *resp = strstr(out, "<RESP:READ_TRIG|OK|{\"trig_idx\":");
+    CHECK(resp != NULL);
+    if (resp == NULL) {
+        return;
+    }
+    const uint32_t trigIdx = (uint32_t)strtoul(resp + strlen("<RESP:READ_TRIG|OK|{\"trig_idx\":"), NULL, 10);
+    CHECK((trigIdx >= 256U) && (trigIdx < (256U + 32U)));     // first crossing with a full history, period 32
+
+    const char *data = strstr(out, "{\"data\":{\"SIG1\":[");
+    CHECK(data != NULL);
+    if (data == NULL) {
+        return;
+    }
+    char *p = (char *)data + strlen("{\"data\":{\"SIG1\":[");
+    uint32_t n = 0U;
+    while ((n < 768U) && (*p != ']')) {
+        window[n++] = (uint16_t)strtoul(p, &p, 10);
+        p += (*p == ',') ? 1 : 0;
+    }
+    CHECK(n == 768U);
+    CHECK((window[255] < 2600U) && (window[256] >= 2600U));
+    CHECK((window[256 + 32] >= 2600U) && (window[255 + 32] < 2600U));     // one period later
+
+    app_host_output_clear();
+    CHECK(app_host_command("{\"cmd\":\"READ_TRIG\",\"num_tones\":1,\"len\":1024,\"freqs\":[1000],\"amps\":[1000],"
+                           "\"sampl_rate\":32000,\"data_type\":1,\"transfer\":0,\"filt_type\":0,\"sig_source\":0,"
+                           "\"trig_mode\":0,\"level\":4000,\"pre\":16,\"post\":16,\"timeout_ms\":20}"));
+    CHECK(strstr(app_host_output(NULL), "<RESP:READ_TRIG|FAIL|{\"error\":\"no_trigger\",\"scanned\":") != NULL);
+}
+
+int main(void)
+{
+    test_find_fuzz();
+    test_known_positions();
+    test_rearm();
+    test_stream_fuzz();
+    test_read_trig();
+    return TEST_DONE();
+}